@@ -75,6 +75,48 @@ BENCHMARK_DEFINE_F(LoggingBenchmark, TPCCish)(benchmark::State &state) {
   state.SetItemsProcessed(state.iterations() * num_txns_ - abort_count);
 }
 
+/**
+ * Run the TPCC-ish workload with the log file written with direct I/O.
+ */
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(LoggingBenchmark, TPCCishDirectIO)(benchmark::State &state) {
+  uint64_t abort_count = 0;
+  const uint32_t txn_length = 5;
+  const std::vector<double> insert_update_select_ratio = {0.1, 0.4, 0.5};
+  // NOLINTNEXTLINE
+  for (auto _ : state) {
+    unlink(terrier::BenchmarkConfig::logfile_path.data());
+    log_manager_ = new storage::LogManager(terrier::BenchmarkConfig::logfile_path.data(), num_log_buffers_,
+                                           log_serialization_interval_, log_persist_interval_, log_persist_threshold_,
+                                           common::ManagedPointer(&buffer_pool_),
+                                           common::ManagedPointer<common::DedicatedThreadRegistry>(&thread_registry_));
+    log_manager_->SetDirectIO(true);
+    log_manager_->Start();
+    LargeDataTableBenchmarkObject tested(attr_sizes_, initial_table_size_, txn_length, insert_update_select_ratio,
+                                         &block_store_, &buffer_pool_, &generator_, true, log_manager_);
+    // log all of the Inserts from table creation
+    log_manager_->ForceFlush();
+
+    gc_ = new storage::GarbageCollector(common::ManagedPointer(tested.GetTimestampManager()), DISABLED,
+                                        common::ManagedPointer(tested.GetTxnManager()), DISABLED);
+    gc_thread_ = new storage::GarbageCollectorThread(common::ManagedPointer(gc_), gc_period_, nullptr);
+    const auto result = tested.SimulateOltp(num_txns_, BenchmarkConfig::num_threads);
+    abort_count += result.first;
+    uint64_t elapsed_ms;
+    {
+      common::ScopedTimer<std::chrono::milliseconds> timer(&elapsed_ms);
+      log_manager_->ForceFlush();
+    }
+    state.SetIterationTime(static_cast<double>(result.second + elapsed_ms) / 1000.0);
+    log_manager_->PersistAndStop();
+    delete log_manager_;
+    delete gc_thread_;
+    delete gc_;
+    unlink(terrier::BenchmarkConfig::logfile_path.data());
+  }
+  state.SetItemsProcessed(state.iterations() * num_txns_ - abort_count);
+}
+
 /**
  * Run a high number of statements with lots of updates to try to trigger aborts.
  */
@@ -248,6 +290,10 @@ BENCHMARK_REGISTER_F(LoggingBenchmark, TPCCish)
     ->Unit(benchmark::kMillisecond)
     ->UseManualTime()
     ->MinTime(3);
+BENCHMARK_REGISTER_F(LoggingBenchmark, TPCCishDirectIO)
+    ->Unit(benchmark::kMillisecond)
+    ->UseManualTime()
+    ->MinTime(3);
 BENCHMARK_REGISTER_F(LoggingBenchmark, HighAbortRate)
     ->Unit(benchmark::kMillisecond)
     ->UseManualTime()
@@ -24,7 +24,8 @@ class RecoveryBenchmark : public benchmark::Fixture {
   std::default_random_engine generator_;
 
   /**
-   * Runs the recovery benchmark with the provided config
+   * Runs the recovery benchmark with the provided config. The number of replay threads is the first argument of the
+   * benchmark, and whether index builds are deferred the second one.
    * @param state benchmark state
    * @param config config to use for test object
    */
@@ -73,6 +74,8 @@ class RecoveryBenchmark : public benchmark::Fixture {
       storage::RecoveryManager recovery_manager(
           common::ManagedPointer<storage::AbstractLogProvider>(&log_provider), recovery_catalog, recovery_txn_manager,
           recovery_deferred_action_manager, recovery_thread_registry, recovery_block_store);
+      recovery_manager.SetNumReplayThreads(static_cast<uint32_t>(state->range(0)));
+      recovery_manager.SetDeferIndexBuilds(state->range(1) != 0);
 
       uint64_t elapsed_ms;
       {
@@ -129,7 +132,8 @@ BENCHMARK_DEFINE_F(RecoveryBenchmark, HighStress)(benchmark::State &state) {
 
 /**
  * Similar to high-stress workload, blast a narrow table with inserts (1 statements per txn, 100% inserts), but also
- * recovery indexes built on the table
+ * recovery indexes built on the table. Indexes are either maintained during replay, which serializes the replay of the
+ * table, or rebuilt at the end of recovery.
  */
 // NOLINTNEXTLINE
 BENCHMARK_DEFINE_F(RecoveryBenchmark, IndexRecovery)(benchmark::State &state) {
@@ -225,6 +229,8 @@ BENCHMARK_DEFINE_F(RecoveryBenchmark, IndexRecovery)(benchmark::State &state) {
     storage::RecoveryManager recovery_manager(common::ManagedPointer<storage::AbstractLogProvider>(&log_provider),
                                               recovery_catalog, recovery_txn_manager, recovery_deferred_action_manager,
                                               recovery_thread_registry, recovery_block_store);
+    recovery_manager.SetNumReplayThreads(static_cast<uint32_t>(state.range(0)));
+    recovery_manager.SetDeferIndexBuilds(state.range(1) != 0);
 
     uint64_t elapsed_ms;
     {
@@ -241,19 +247,31 @@ BENCHMARK_DEFINE_F(RecoveryBenchmark, IndexRecovery)(benchmark::State &state) {
 // ----------------------------------------------------------------------------
 // BENCHMARK REGISTRATION
 // ----------------------------------------------------------------------------
+/**
+ * Replays with 1 to 8 threads, with index builds deferred or not, so that replay throughput can be compared across them
+ */
+static void ReplayArguments(benchmark::internal::Benchmark *b) {
+  for (const int64_t defer_index_builds : {0, 1}) {
+    for (const int64_t num_replay_threads : {1, 2, 4, 8}) b->Args({num_replay_threads, defer_index_builds});
+  }
+}
+
 // clang-format off
 BENCHMARK_REGISTER_F(RecoveryBenchmark, ReadWriteWorkload)
     ->Unit(benchmark::kMillisecond)
     ->UseManualTime()
-    ->MinTime(10);
+    ->MinTime(10)
+    ->Apply(ReplayArguments);
 BENCHMARK_REGISTER_F(RecoveryBenchmark, HighStress)
     ->Unit(benchmark::kMillisecond)
     ->UseManualTime()
-    ->MinTime(10);
+    ->MinTime(10)
+    ->Apply(ReplayArguments);
 BENCHMARK_REGISTER_F(RecoveryBenchmark, IndexRecovery)
     ->Unit(benchmark::kMillisecond)
     ->UseManualTime()
-    ->MinTime(4);
+    ->MinTime(4)
+    ->Apply(ReplayArguments);
 // clang-format on
 
 }  // namespace terrier
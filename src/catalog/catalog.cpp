@@ -29,6 +29,8 @@ Catalog::Catalog(const common::ManagedPointer<transaction::TransactionManager> t
       garbage_collector_(garbage_collector),
       next_oid_(1) {
   databases_ = new storage::SqlTable(catalog_block_store_, postgres::Builder::GetDatabaseTableSchema());
+  // Indexed below, which the block compactor does not maintain
+  databases_->DisallowCompaction();
   databases_oid_index_ = postgres::Builder::BuildUniqueIndex(postgres::Builder::GetDatabaseOidIndexSchema(),
                                                              postgres::DATABASE_OID_INDEX_OID);
   databases_name_index_ = postgres::Builder::BuildUniqueIndex(postgres::Builder::GetDatabaseNameIndexSchema(),
@@ -837,16 +837,21 @@ bool DatabaseCatalog::DeleteTable(const common::ManagedPointer<transaction::Tran
 
   // Everything succeeded from an MVCC standpoint, register deferred action for the GC with txn manager. See base
   // function comment.
-  txn->RegisterCommitAction([=](transaction::DeferredActionManager *deferred_action_manager) {
-    deferred_action_manager->RegisterDeferredAction([=]() {
-      deferred_action_manager->RegisterDeferredAction([=]() {
-        // Defer an action upon commit to delete the table. Delete table will need a double deferral because there could
-        // be transactions not yet unlinked by the GC that depend on the table
-        delete schema_ptr;
-        delete table_ptr;
+  txn->RegisterCommitAction(
+      [=, garbage_collector{garbage_collector_}](transaction::DeferredActionManager *deferred_action_manager) {
+        deferred_action_manager->RegisterDeferredAction([=]() {
+          // The compactor and access observer hold raw pointers into the table's blocks, so they have to let go of
+          // them before the second deferral frees the table
+          if (garbage_collector != nullptr)
+            garbage_collector->UnregisterTableForCompaction(common::ManagedPointer<const storage::SqlTable>(table_ptr));
+          deferred_action_manager->RegisterDeferredAction([=]() {
+            // Defer an action upon commit to delete the table. Delete table will need a double deferral because there
+            // could be transactions not yet unlinked by the GC that depend on the table
+            delete schema_ptr;
+            delete table_ptr;
+          });
+        });
       });
-    });
-  });
 
   delete[] buffer;
   return true;
@@ -914,9 +919,14 @@ bool DatabaseCatalog::SetTablePointer(const common::ManagedPointer<transaction::
                  "should already have the lock.");
   // We need to defer the deletion because their may be subsequent undo records into this table that need to be GCed
   // before we can safely delete this.
-  txn->RegisterAbortAction([=](transaction::DeferredActionManager *deferred_action_manager) {
-    deferred_action_manager->RegisterDeferredAction([=]() { delete table_ptr; });
-  });
+  txn->RegisterAbortAction(
+      [=, garbage_collector{garbage_collector_}](transaction::DeferredActionManager *deferred_action_manager) {
+        deferred_action_manager->RegisterDeferredAction([=]() {
+          if (garbage_collector != nullptr)
+            garbage_collector->UnregisterTableForCompaction(common::ManagedPointer(table_ptr));
+          deferred_action_manager->RegisterDeferredAction([=]() { delete table_ptr; });
+        });
+      });
   return SetClassPointer(txn, table, table_ptr, postgres::REL_PTR_COL_OID);
 }
 
@@ -1006,6 +1016,10 @@ index_oid_t DatabaseCatalog::CreateIndex(const common::ManagedPointer<transactio
                                          namespace_oid_t ns, const std::string &name, table_oid_t table,
                                          const IndexSchema &schema) {
   if (!TryLock(txn)) return INVALID_INDEX_OID;
+  // The block compactor moves tuples without maintaining indexes, so it has to leave the table alone from now on. This
+  // is not undone if the transaction aborts.
+  const auto table_ptr = GetTable(txn, table);
+  if (table_ptr != nullptr) table_ptr->DisallowCompaction();
   const index_oid_t index_oid = static_cast<index_oid_t>(next_oid_++);
   return CreateIndexEntry(txn, ns, table, index_oid, name, schema) ? index_oid : INVALID_INDEX_OID;
 }
@@ -1410,9 +1424,10 @@ void DatabaseCatalog::TearDown(const common::ManagedPointer<transaction::Transac
     }
   }
 
-  auto dbc_nuke = [=, garbage_collector{garbage_collector_}, tables{std::move(tables)}, indexes{std::move(indexes)},
+  auto dbc_nuke = [=, garbage_collector{garbage_collector_}, indexes{std::move(indexes)},
                    table_schemas{std::move(table_schemas)}, index_schemas{std::move(index_schemas)},
                    expressions{std::move(expressions)}, func_contexts{std::move(func_contexts)}]() {
+    // Tables were already unregistered from compaction in an earlier deferral
     for (auto table : tables) delete table;
 
     for (auto index : indexes) {
@@ -1433,8 +1448,15 @@ void DatabaseCatalog::TearDown(const common::ManagedPointer<transaction::Transac
 
   // No new transactions can see these object but there may be deferred index
   // and other operation.  Therefore, we need to defer the deallocation on delete
-  txn->RegisterCommitAction([=](transaction::DeferredActionManager *deferred_action_manager) {
-    deferred_action_manager->RegisterDeferredAction(dbc_nuke);
+  txn->RegisterCommitAction([=, garbage_collector{garbage_collector_}, tables{std::move(tables)}](
+                                transaction::DeferredActionManager *deferred_action_manager) {
+    deferred_action_manager->RegisterDeferredAction([=]() {
+      if (garbage_collector != nullptr) {
+        for (const storage::SqlTable *const table : tables)
+          garbage_collector->UnregisterTableForCompaction(common::ManagedPointer(table));
+      }
+      deferred_action_manager->RegisterDeferredAction(dbc_nuke);
+    });
   });
 
   delete[] buffer;
@@ -80,6 +80,10 @@ DatabaseCatalog *Builder::CreateDatabaseCatalog(
   dbc->constraints_ = new storage::SqlTable(block_store, Builder::GetConstraintTableSchema());
   dbc->languages_ = new storage::SqlTable(block_store, Builder::GetLanguageTableSchema());
   dbc->procs_ = new storage::SqlTable(block_store, Builder::GetProcTableSchema());
+  // The catalog tables are all indexed, which the block compactor does not maintain
+  for (const storage::SqlTable *const table : {dbc->namespaces_, dbc->classes_, dbc->indexes_, dbc->columns_,
+                                               dbc->types_, dbc->constraints_, dbc->languages_, dbc->procs_})
+    table->DisallowCompaction();
 
   // Indexes on pg_namespace
   dbc->namespaces_oid_index_ =
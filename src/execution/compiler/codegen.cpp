@@ -706,6 +706,12 @@ ast::Expr *CodeGen::FilterManagerInit(ast::Expr *filter_manager, ast::Expr *exec
   return call;
 }
 
+ast::Expr *CodeGen::FilterManagerInit(ast::Expr *filter_manager, ast::Expr *exec_ctx, ast::Expr *opaque_ctx) {
+  ast::Expr *call = CallBuiltin(ast::Builtin::FilterManagerInit, {filter_manager, exec_ctx, opaque_ctx});
+  call->SetType(ast::BuiltinType::Get(context_, ast::BuiltinType::Nil));
+  return call;
+}
+
 ast::Expr *CodeGen::FilterManagerFree(ast::Expr *filter_manager) {
   ast::Expr *call = CallBuiltin(ast::Builtin::FilterManagerFree, {filter_manager});
   call->SetType(ast::BuiltinType::Get(context_, ast::BuiltinType::Nil));
@@ -817,6 +823,52 @@ ast::Expr *CodeGen::JoinHashTableBuildParallel(ast::Expr *join_hash_table, ast::
   return call;
 }
 
+ast::Expr *CodeGen::JoinHashTableBuildBloomFilter(ast::Expr *join_hash_table) {
+  ast::Expr *call = CallBuiltin(ast::Builtin::JoinHashTableBuildBloomFilter, {join_hash_table});
+  call->SetType(ast::BuiltinType::Get(context_, ast::BuiltinType::Nil));
+  return call;
+}
+
+ast::Expr *CodeGen::JoinHashTableFilterProbe(ast::Expr *join_hash_table, ast::Expr *vector_proj, ast::Expr *tid_list,
+                                             ast::Identifier key_cols) {
+  ast::Expr *call = CallBuiltin(ast::Builtin::JoinHashTableFilterProbe,
+                                {join_hash_table, vector_proj, tid_list, MakeExpr(key_cols)});
+  call->SetType(ast::BuiltinType::Get(context_, ast::BuiltinType::Nil));
+  return call;
+}
+
+ast::Expr *CodeGen::JoinHashTableEnableSpilling(ast::Expr *join_hash_table, ast::Identifier probe_row_type_name) {
+  ast::Expr *call =
+      CallBuiltin(ast::Builtin::JoinHashTableEnableSpilling, {join_hash_table, SizeOf(probe_row_type_name)});
+  call->SetType(ast::BuiltinType::Get(context_, ast::BuiltinType::Nil));
+  return call;
+}
+
+ast::Expr *CodeGen::JoinHashTableIsResident(ast::Expr *join_hash_table, ast::Expr *hash_val) {
+  ast::Expr *call = CallBuiltin(ast::Builtin::JoinHashTableIsResident, {join_hash_table, hash_val});
+  call->SetType(ast::BuiltinType::Get(context_, ast::BuiltinType::Bool));
+  return call;
+}
+
+ast::Expr *CodeGen::JoinHashTableSpillProbeTuple(ast::Expr *join_hash_table, ast::Expr *hash_val,
+                                                 ast::Expr *probe_row) {
+  ast::Expr *call = CallBuiltin(ast::Builtin::JoinHashTableSpillProbeTuple, {join_hash_table, hash_val, probe_row});
+  call->SetType(ast::BuiltinType::Get(context_, ast::BuiltinType::Nil));
+  return call;
+}
+
+ast::Expr *CodeGen::JoinHashTableNextPartition(ast::Expr *join_hash_table) {
+  ast::Expr *call = CallBuiltin(ast::Builtin::JoinHashTableNextPartition, {join_hash_table});
+  call->SetType(ast::BuiltinType::Get(context_, ast::BuiltinType::Bool));
+  return call;
+}
+
+ast::Expr *CodeGen::JoinHashTableReadProbeTuple(ast::Expr *join_hash_table, ast::Expr *probe_row) {
+  ast::Expr *call = CallBuiltin(ast::Builtin::JoinHashTableReadProbeTuple, {join_hash_table, probe_row});
+  call->SetType(ast::BuiltinType::Get(context_, ast::BuiltinType::Bool));
+  return call;
+}
+
 ast::Expr *CodeGen::JoinHashTableLookup(ast::Expr *join_hash_table, ast::Expr *entry_iter, ast::Expr *hash_val) {
   ast::Expr *call = CallBuiltin(ast::Builtin::JoinHashTableLookup, {join_hash_table, entry_iter, hash_val});
   call->SetType(ast::BuiltinType::Get(context_, ast::BuiltinType::Nil));
@@ -852,6 +904,12 @@ ast::Expr *CodeGen::AggHashTableInit(ast::Expr *agg_ht, ast::Expr *exec_ctx, ast
   return call;
 }
 
+ast::Expr *CodeGen::AggHashTableEnableSpilling(ast::Expr *agg_ht) {
+  ast::Expr *call = CallBuiltin(ast::Builtin::AggHashTableEnableSpilling, {agg_ht});
+  call->SetType(ast::BuiltinType::Get(context_, ast::BuiltinType::Nil));
+  return call;
+}
+
 ast::Expr *CodeGen::AggHashTableLookup(ast::Expr *agg_ht, ast::Expr *hash_val, ast::Identifier key_check,
                                        ast::Expr *input, ast::Identifier agg_payload_type) {
   ast::Expr *call = CallBuiltin(ast::Builtin::AggHashTableLookup, {agg_ht, hash_val, MakeExpr(key_check), input});
@@ -994,6 +1052,12 @@ ast::Expr *CodeGen::SorterInit(ast::Expr *sorter, ast::Expr *mem_pool, ast::Iden
   return call;
 }
 
+ast::Expr *CodeGen::SorterEnableSpilling(ast::Expr *sorter, ast::Expr *exec_ctx) {
+  ast::Expr *call = CallBuiltin(ast::Builtin::SorterEnableSpilling, {sorter, exec_ctx});
+  call->SetType(ast::BuiltinType::Get(context_, ast::BuiltinType::Nil));
+  return call;
+}
+
 ast::Expr *CodeGen::SorterInsert(ast::Expr *sorter, ast::Identifier sort_row_type_name) {
   // @sorterInsert(sorter)
   ast::Expr *call = CallBuiltin(ast::Builtin::SorterInsert, {sorter});
@@ -6,6 +6,7 @@
 #include "execution/compiler/if.h"
 #include "execution/compiler/loop.h"
 #include "execution/compiler/work_context.h"
+#include "execution/exec/execution_settings.h"
 #include "planner/plannodes/aggregate_plan_node.h"
 
 namespace terrier::execution::compiler {
@@ -57,9 +58,12 @@ HashAggregationTranslator::HashAggregationTranslator(const planner::AggregatePla
   ast::Expr *agg_ht_type = codegen->BuiltinType(ast::BuiltinType::AggregationHashTable);
   global_agg_ht_ = compilation_context->GetQueryState()->DeclareStateEntry(codegen, "aggHashTable", agg_ht_type);
 
-  // In parallel mode, declare a local hash table, too.
+  // In parallel mode, declare a local hash table, too. Only partitioned tables,
+  // built in parallel, spill their overflow partitions, once they outgrow the
+  // execution_operator_memory_budget setting.
   if (build_pipeline_.IsParallel()) {
     local_agg_ht_ = build_pipeline_.DeclarePipelineStateEntry("aggHashTable", agg_ht_type);
+    spill_enabled_ = compilation_context->GetExecutionSettings().GetOperatorMemoryBudget() != 0;
   }
 }
 
@@ -239,6 +243,9 @@ void HashAggregationTranslator::DefineHelperFunctions(util::RegionVector<ast::Fu
 
 void HashAggregationTranslator::InitializeAggregationHashTable(FunctionBuilder *function, ast::Expr *agg_ht) const {
   function->Append(GetCodeGen()->AggHashTableInit(agg_ht, GetExecutionContext(), GetMemoryPool(), agg_payload_type_));
+  if (spill_enabled_) {
+    function->Append(GetCodeGen()->AggHashTableEnableSpilling(agg_ht));
+  }
 }
 
 void HashAggregationTranslator::TearDownAggregationHashTable(FunctionBuilder *function, ast::Expr *agg_ht) const {
@@ -1,17 +1,25 @@
 #include "execution/compiler/operator/hash_join_translator.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "execution/ast/type.h"
 #include "execution/compiler/compilation_context.h"
 #include "execution/compiler/function_builder.h"
 #include "execution/compiler/if.h"
 #include "execution/compiler/loop.h"
+#include "execution/compiler/operator/seq_scan_translator.h"
 #include "execution/compiler/work_context.h"
+#include "execution/exec/execution_settings.h"
+#include "parser/expression/column_value_expression.h"
+#include "parser/expression/derived_value_expression.h"
 #include "planner/plannodes/hash_join_plan_node.h"
 
 namespace terrier::execution::compiler {
 
 namespace {
 const char *build_row_attr_prefix = "attr";
+const char *probe_row_attr_prefix = "probeAttr";
 }  // namespace
 
 HashJoinTranslator::HashJoinTranslator(const planner::HashJoinPlanNode &plan, CompilationContext *compilation_context,
@@ -20,6 +28,8 @@ HashJoinTranslator::HashJoinTranslator(const planner::HashJoinPlanNode &plan, Co
       build_row_var_(GetCodeGen()->MakeFreshIdentifier("buildRow")),
       build_row_type_(GetCodeGen()->MakeFreshIdentifier("BuildRow")),
       build_mark_(GetCodeGen()->MakeFreshIdentifier("buildMark")),
+      probe_row_var_(GetCodeGen()->MakeFreshIdentifier("probeRow")),
+      probe_row_type_(GetCodeGen()->MakeFreshIdentifier("ProbeRow")),
       left_pipeline_(this, Pipeline::Parallelism::Parallel) {
   TERRIER_ASSERT(!plan.GetLeftHashKeys().empty(), "Hash-join must have join keys from left input");
   TERRIER_ASSERT(!plan.GetRightHashKeys().empty(), "Hash-join must have join keys from right input");
@@ -47,6 +57,92 @@ HashJoinTranslator::HashJoinTranslator(const planner::HashJoinPlanNode &plan, Co
   if (left_pipeline_.IsParallel()) {
     local_join_ht_ = left_pipeline_.DeclarePipelineStateEntry("joinHashTable", join_ht_type);
   }
+
+  // Probe tuples of spilled partitions are written out and pushed through the rest of the probe
+  // pipeline later, from their probe row alone. Thus, a join cannot spill below a nested loop join in
+  // the same pipeline, which also refers to the tuples of its outer loop. Probe tuples of partitions
+  // without build tuples are dropped, so joins that output probe tuples without a match cannot spill.
+  // Neither can joins that mark build tuples, whose marks would be lost along with their partition.
+  const bool below_nested_loop_join = std::any_of(pipeline->Begin(), pipeline->End(), [](auto op) {
+    return op->GetPlan().GetPlanNodeType() == planner::PlanNodeType::NESTLOOP;
+  });
+  switch (plan.GetLogicalJoinType()) {
+    case planner::LogicalJoinType::INNER:
+    case planner::LogicalJoinType::RIGHT_SEMI:
+      spill_enabled_ =
+          !below_nested_loop_join && compilation_context->GetExecutionSettings().GetOperatorMemoryBudget() != 0;
+      break;
+    default:
+      break;
+  }
+
+  PushDownBloomFilter();
+}
+
+void HashJoinTranslator::PushDownBloomFilter() {
+  if (!GetCompilationContext()->GetExecutionSettings().GetIsBloomFilterPushdownEnabled()) {
+    return;
+  }
+
+  const auto &join_plan = GetPlanAs<planner::HashJoinPlanNode>();
+
+  // Probe tuples without a join partner must not produce any output.
+  switch (join_plan.GetLogicalJoinType()) {
+    case planner::LogicalJoinType::INNER:
+    case planner::LogicalJoinType::SEMI:
+    case planner::LogicalJoinType::LEFT_SEMI:
+    case planner::LogicalJoinType::RIGHT_SEMI:
+      break;
+    default:
+      return;
+  }
+
+  // The scan hashes the raw column values, which only match the hashes of the build keys if both sides are of the
+  // same kind. Decimals are excluded, since their hashes do not take the seed into account.
+  auto key_kind = [](type::TypeId type) {
+    switch (type) {
+      case type::TypeId::TINYINT:
+      case type::TypeId::SMALLINT:
+      case type::TypeId::INTEGER:
+      case type::TypeId::BIGINT:
+        return type::TypeId::BIGINT;
+      case type::TypeId::DATE:
+      case type::TypeId::VARCHAR:
+        return type;
+      default:
+        return type::TypeId::INVALID;
+    }
+  };
+
+  const planner::AbstractPlanNode *scan = nullptr;
+  std::vector<catalog::col_oid_t> key_col_oids;
+  for (uint32_t key_idx = 0; key_idx < join_plan.GetRightHashKeys().size(); key_idx++) {
+    // Follow the probe key down the probe sides of the joins below to the scan that produces it.
+    const planner::AbstractPlanNode *node = &join_plan;
+    auto key = join_plan.GetRightHashKeys()[key_idx];
+    while (key->GetExpressionType() == parser::ExpressionType::VALUE_TUPLE) {
+      auto derived_key = key.CastManagedPointerTo<parser::DerivedValueExpression>();
+      if (node->GetPlanNodeType() != planner::PlanNodeType::HASHJOIN || derived_key->GetTupleIdx() != 1) {
+        return;
+      }
+      node = node->GetChild(1);
+      key = node->GetOutputSchema()->GetColumn(derived_key->GetValueIdx()).GetExpr();
+    }
+
+    if (node->GetPlanNodeType() != planner::PlanNodeType::SEQSCAN ||
+        key->GetExpressionType() != parser::ExpressionType::COLUMN_VALUE || (scan != nullptr && scan != node)) {
+      return;
+    }
+    const auto left_kind = key_kind(join_plan.GetLeftHashKeys()[key_idx]->GetReturnValueType());
+    if (left_kind == type::TypeId::INVALID || left_kind != key_kind(key->GetReturnValueType())) {
+      return;
+    }
+    scan = node;
+    key_col_oids.push_back(key.CastManagedPointerTo<parser::ColumnValueExpression>()->GetColumnOid());
+  }
+
+  auto *scan_translator = static_cast<SeqScanTranslator *>(GetCompilationContext()->LookupTranslator(*scan));
+  build_bloom_filter_ = scan_translator->AddBloomFilter(global_join_ht_, key_col_oids);
 }
 
 void HashJoinTranslator::DefineHelperStructs(util::RegionVector<ast::StructDecl *> *decls) {
@@ -59,10 +155,22 @@ void HashJoinTranslator::DefineHelperStructs(util::RegionVector<ast::StructDecl
   ast::StructDecl *struct_decl = codegen->DeclareStruct(build_row_type_, std::move(fields));
   struct_decl_ = struct_decl;
   decls->push_back(struct_decl);
+
+  if (spill_enabled_) {
+    auto probe_fields = codegen->MakeEmptyFieldList();
+    GetAllChildOutputFields(1, probe_row_attr_prefix, &probe_fields);
+    decls->push_back(codegen->DeclareStruct(probe_row_type_, std::move(probe_fields)));
+  }
 }
 
+bool HashJoinTranslator::IsSpilledProbe(const WorkContext *ctx) const { return ctx->SourceOp() == this; }
+
 void HashJoinTranslator::InitializeJoinHashTable(FunctionBuilder *function, ast::Expr *jht_ptr) const {
-  function->Append(GetCodeGen()->JoinHashTableInit(jht_ptr, GetExecutionContext(), GetMemoryPool(), build_row_type_));
+  auto *codegen = GetCodeGen();
+  function->Append(codegen->JoinHashTableInit(jht_ptr, GetExecutionContext(), GetMemoryPool(), build_row_type_));
+  if (spill_enabled_) {
+    function->Append(codegen->JoinHashTableEnableSpilling(jht_ptr, probe_row_type_));
+  }
 }
 
 void HashJoinTranslator::TearDownJoinHashTable(FunctionBuilder *function, ast::Expr *jht_ptr) const {
@@ -158,6 +266,45 @@ void HashJoinTranslator::ProbeJoinHashTable(WorkContext *ctx, FunctionBuilder *f
   auto entry_iter = codegen->MakeExpr(iter_name);
   auto hash_val = HashKeys(ctx, function, GetPlanAs<planner::HashJoinPlanNode>().GetRightHashKeys());
 
+  if (spill_enabled_ && !IsSpilledProbe(ctx)) {
+    // Tuples whose partition is not in memory are written out, to be probed once it is.
+    If resident_check(function, codegen->JoinHashTableIsResident(global_join_ht_.GetPtr(codegen), hash_val));
+    ProbeEntries(ctx, function, entry_iter, hash_val);
+    resident_check.Else();
+    SpillProbeRow(ctx, function, hash_val);
+    resident_check.EndIf();
+  } else {
+    ProbeEntries(ctx, function, entry_iter, hash_val);
+  }
+}
+
+void HashJoinTranslator::SpillProbeRow(WorkContext *ctx, FunctionBuilder *function, ast::Expr *hash_val) const {
+  auto *codegen = GetCodeGen();
+
+  // var probeRow: ProbeRow
+  function->Append(codegen->DeclareVarNoInit(probe_row_var_, codegen->MakeExpr(probe_row_type_)));
+  const auto child_schema = GetPlan().GetChild(1)->GetOutputSchema();
+  for (uint32_t attr_idx = 0; attr_idx < child_schema->GetColumns().size(); attr_idx++) {
+    ast::Expr *lhs = GetProbeRowAttribute(attr_idx);
+    ast::Expr *rhs = GetChildOutput(ctx, 1, attr_idx);
+    function->Append(codegen->Assign(lhs, rhs));
+  }
+
+  // @joinHTSpillProbeTuple(jht, hashVal, &probeRow)
+  ast::Expr *probe_row = codegen->AddressOf(codegen->MakeExpr(probe_row_var_));
+  function->Append(codegen->JoinHashTableSpillProbeTuple(global_join_ht_.GetPtr(codegen), hash_val, probe_row));
+}
+
+ast::Expr *HashJoinTranslator::GetProbeRowAttribute(uint32_t attr_idx) const {
+  auto *codegen = GetCodeGen();
+  auto attr_name = codegen->MakeIdentifier(probe_row_attr_prefix + std::to_string(attr_idx));
+  return codegen->AccessStructMember(codegen->MakeExpr(probe_row_var_), attr_name);
+}
+
+void HashJoinTranslator::ProbeEntries(WorkContext *ctx, FunctionBuilder *function, ast::Expr *entry_iter,
+                                      ast::Expr *hash_val) const {
+  auto *codegen = GetCodeGen();
+
   // Probe matches.
   const auto &join_plan = GetPlanAs<planner::HashJoinPlanNode>();
   auto lookup_call =
@@ -272,16 +419,49 @@ void HashJoinTranslator::FinishPipelineWork(const Pipeline &pipeline, FunctionBu
     } else {
       function->Append(codegen->JoinHashTableBuild(jht));
     }
+    if (build_bloom_filter_) {
+      function->Append(codegen->JoinHashTableBuildBloomFilter(jht));
+    }
   }
 }
 
+bool HashJoinTranslator::HasDeferredPipelineWork(const Pipeline &pipeline) const {
+  return spill_enabled_ && IsRightPipeline(pipeline);
+}
+
+void HashJoinTranslator::PerformDeferredPipelineWork(WorkContext *ctx, FunctionBuilder *function) const {
+  auto *codegen = GetCodeGen();
+  auto jht = global_join_ht_.GetPtr(codegen);
+
+  // var probeRow: ProbeRow
+  function->Append(codegen->DeclareVarNoInit(probe_row_var_, codegen->MakeExpr(probe_row_type_)));
+
+  // for (@joinHTNextPartition(jht)) {
+  //   for (@joinHTReadProbeTuple(jht, &probeRow)) { ... }
+  // }
+  Loop partition_loop(function, codegen->JoinHashTableNextPartition(jht));
+  {
+    ast::Expr *probe_row = codegen->AddressOf(codegen->MakeExpr(probe_row_var_));
+    Loop probe_loop(function, codegen->JoinHashTableReadProbeTuple(jht, probe_row));
+    {
+      ProbeJoinHashTable(ctx, function);
+    }
+    probe_loop.EndLoop();
+  }
+  partition_loop.EndLoop();
+}
+
 ast::Expr *HashJoinTranslator::GetChildOutput(WorkContext *context, uint32_t child_idx, uint32_t attr_idx) const {
   // If the request is in the probe pipeline and for an attribute in the left
-  // child, we read it from the probe/materialized build row. Otherwise, we
-  // propagate to the appropriate child.
+  // child, we read it from the probe/materialized build row. Probe tuples
+  // read back from disk provide the attributes of the right child from their
+  // probe row. Otherwise, we propagate to the appropriate child.
   if (IsRightPipeline(context->GetPipeline()) && child_idx == 0) {
     return GetBuildRowAttribute(GetCodeGen()->MakeExpr(build_row_var_), attr_idx);
   }
+  if (IsRightPipeline(context->GetPipeline()) && child_idx == 1 && IsSpilledProbe(context)) {
+    return GetProbeRowAttribute(attr_idx);
+  }
   return OperatorTranslator::GetChildOutput(context, child_idx, attr_idx);
 }
 
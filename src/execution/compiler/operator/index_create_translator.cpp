@@ -48,6 +48,9 @@ void IndexCreateTranslator::PerformPipelineWork(WorkContext *context, FunctionBu
   // Close TVI, if need be.
   function->Append(codegen_->TableIterClose(codegen_->MakeExpr(tvi_var_)));
 
+  // Load all keys into the index at once.
+  BulkLoadIndex(function);
+
   FreeInserter(function);
 }
 
@@ -168,11 +171,16 @@ void IndexCreateTranslator::IndexInsert(WorkContext *ctx, FunctionBuilder *funct
     function->Append(codegen_->MakeStmt(set_key_call));
   }
 
-  // if (!@IndexInsertWithSlot(&inserter, &slot_var_, unique)) { Abort(); }
-  auto *index_insert_call = codegen_->CallBuiltin(
-      ast::Builtin::IndexInsertWithSlot,
-      {codegen_->AddressOf(inserter_), codegen_->AddressOf(slot_var_), codegen_->ConstBool(index_schema.Unique())});
-  auto *cond = codegen_->UnaryOp(parsing::Token::Type::BANG, index_insert_call);
+  // @indexBulkLoadAdd(&inserter, &slot_var_)
+  auto *bulk_load_add_call = codegen_->CallBuiltin(ast::Builtin::IndexBulkLoadAdd,
+                                                   {codegen_->AddressOf(inserter_), codegen_->AddressOf(slot_var_)});
+  function->Append(codegen_->MakeStmt(bulk_load_add_call));
+}
+
+void IndexCreateTranslator::BulkLoadIndex(FunctionBuilder *function) const {
+  // if (!@indexBulkLoadFinish(&inserter)) { Abort(); }
+  auto *bulk_load_call = codegen_->CallBuiltin(ast::Builtin::IndexBulkLoadFinish, {codegen_->AddressOf(inserter_)});
+  auto *cond = codegen_->UnaryOp(parsing::Token::Type::BANG, bulk_load_call);
   If success(function, cond);
   { function->Append(codegen_->AbortTxn(GetExecutionContext())); }
   success.EndIf();
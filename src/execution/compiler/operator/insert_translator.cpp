@@ -52,6 +52,12 @@ void InsertTranslator::PerformPipelineWork(WorkContext *context, FunctionBuilder
   // var insert_pr : *ProjectedRow
   DeclareInsertPR(function);
 
+  if (GetPlanAs<planner::InsertPlanNode>().GetBulkInsertCount() > 1) {
+    GenBatchInsert(context, function);
+    GenInserterFree(function);
+    return;
+  }
+
   for (uint32_t idx = 0; idx < GetPlanAs<planner::InsertPlanNode>().GetBulkInsertCount(); idx++) {
     // var insert_pr = @getTablePR(&inserter)
     GetInsertPR(function);
@@ -70,6 +76,31 @@ void InsertTranslator::PerformPipelineWork(WorkContext *context, FunctionBuilder
   GenInserterFree(function);
 }
 
+void InsertTranslator::GenBatchInsert(WorkContext *context, FunctionBuilder *function) const {
+  const auto &plan = GetPlanAs<planner::InsertPlanNode>();
+  const auto &index_oids = GetCodeGen()->GetCatalogAccessor()->GetIndexOids(plan.GetTableOid());
+  for (uint32_t idx = 0; idx < plan.GetBulkInsertCount(); idx++) {
+    // var insert_pr = @getTablePRForBatch(&inserter)
+    auto *get_pr_call =
+        GetCodeGen()->CallBuiltin(ast::Builtin::GetTablePRForBatch, {GetCodeGen()->AddressOf(inserter_)});
+    function->Append(GetCodeGen()->Assign(GetCodeGen()->MakeExpr(insert_pr_), get_pr_call));
+    // For each attribute, @prSet(insert_pr, ...)
+    GenSetTablePR(function, context, idx);
+    for (const auto &index_oid : index_oids) {
+      // var insert_index_pr = @getIndexPRForBatch(&inserter, oid)
+      GenSetIndexPR(context, function, index_oid, ast::Builtin::GetIndexPRForBatch);
+    }
+  }
+
+  // if (!@tableInsertBatch(&inserter)) { Abort(); }
+  auto *insert_call = GetCodeGen()->CallBuiltin(ast::Builtin::TableInsertBatch, {GetCodeGen()->AddressOf(inserter_)});
+  auto *cond = GetCodeGen()->UnaryOp(parsing::Token::Type::BANG, insert_call);
+  If success(function, cond);
+  { function->Append(GetCodeGen()->AbortTxn(GetExecutionContext())); }
+  success.EndIf();
+  function->Append(GetCodeGen()->ExecCtxAddRowsAffected(GetExecutionContext(), plan.GetBulkInsertCount()));
+}
+
 void InsertTranslator::DeclareInserter(terrier::execution::compiler::FunctionBuilder *builder) const {
   // var col_oids: [num_cols]uint32
   // col_oids[i] = ...
@@ -156,10 +187,26 @@ void InsertTranslator::GenTableInsert(FunctionBuilder *builder) const {
 void InsertTranslator::GenIndexInsert(WorkContext *context, FunctionBuilder *builder,
                                       const catalog::index_oid_t &index_oid) const {
   // var insert_index_pr = @getIndexPR(&inserter, oid)
+  // For each key attribute, @prSet(insert_index_pr, ...)
+  GenSetIndexPR(context, builder, index_oid, ast::Builtin::GetIndexPR);
+
+  // if (!@indexInsert(&inserter)) { Abort(); }
+  const auto &index_schema = GetCodeGen()->GetCatalogAccessor()->GetIndexSchema(index_oid);
+  const auto &builtin = index_schema.Unique() ? ast::Builtin::IndexInsertUnique : ast::Builtin::IndexInsert;
+  auto *index_insert_call = GetCodeGen()->CallBuiltin(builtin, {GetCodeGen()->AddressOf(inserter_)});
+  auto *cond = GetCodeGen()->UnaryOp(parsing::Token::Type::BANG, index_insert_call);
+  If success(builder, cond);
+  { builder->Append(GetCodeGen()->AbortTxn(GetExecutionContext())); }
+  success.EndIf();
+}
+
+void InsertTranslator::GenSetIndexPR(WorkContext *context, FunctionBuilder *builder,
+                                     const catalog::index_oid_t &index_oid, ast::Builtin get_index_pr) const {
+  // var insert_index_pr = @getIndexPR(&inserter, oid)
   const auto &insert_index_pr = GetCodeGen()->MakeFreshIdentifier("insert_index_pr");
   std::vector<ast::Expr *> pr_call_args{GetCodeGen()->AddressOf(inserter_),
                                         GetCodeGen()->Const32(index_oid.UnderlyingValue())};
-  auto *get_index_pr_call = GetCodeGen()->CallBuiltin(ast::Builtin::GetIndexPR, pr_call_args);
+  auto *get_index_pr_call = GetCodeGen()->CallBuiltin(get_index_pr, pr_call_args);
   builder->Append(GetCodeGen()->DeclareVar(insert_index_pr, nullptr, get_index_pr_call));
 
   const auto &index = GetCodeGen()->GetCatalogAccessor()->GetIndex(index_oid);
@@ -176,14 +223,6 @@ void InsertTranslator::GenIndexInsert(WorkContext *context, FunctionBuilder *bui
     auto *set_key_call = GetCodeGen()->PRSet(index_pr_expr, attr_type, nullable, attr_offset, col_expr, false);
     builder->Append(GetCodeGen()->MakeStmt(set_key_call));
   }
-
-  // if (!@indexInsert(&inserter)) { Abort(); }
-  const auto &builtin = index_schema.Unique() ? ast::Builtin::IndexInsertUnique : ast::Builtin::IndexInsert;
-  auto *index_insert_call = GetCodeGen()->CallBuiltin(builtin, {GetCodeGen()->AddressOf(inserter_)});
-  auto *cond = GetCodeGen()->UnaryOp(parsing::Token::Type::BANG, index_insert_call);
-  If success(builder, cond);
-  { builder->Append(GetCodeGen()->AbortTxn(GetExecutionContext())); }
-  success.EndIf();
 }
 
 std::vector<catalog::col_oid_t> InsertTranslator::AllColOids(const catalog::Schema &table_schema) {
@@ -1,5 +1,9 @@
 #include "execution/compiler/operator/seq_scan_translator.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include "catalog/catalog_accessor.h"
 #include "common/error/exception.h"
 #include "execution/compiler/codegen.h"
@@ -40,6 +44,28 @@ bool SeqScanTranslator::HasPredicate() const {
   return GetPlanAs<planner::SeqScanPlanNode>().GetScanPredicate() != nullptr;
 }
 
+bool SeqScanTranslator::HasFilterManager() const { return HasPredicate() || !bloom_filters_.empty(); }
+
+bool SeqScanTranslator::AddBloomFilter(const StateDescriptor::Entry &join_ht,
+                                       const std::vector<catalog::col_oid_t> &key_col_oids) {
+  std::vector<uint32_t> key_cols;
+  for (const auto key_col_oid : key_col_oids) {
+    const auto iter = std::find(col_oids_.begin(), col_oids_.end(), key_col_oid);
+    if (iter == col_oids_.end()) {
+      return false;
+    }
+    key_cols.push_back(static_cast<uint32_t>(iter - col_oids_.begin()));
+  }
+
+  // Without a predicate, the filter manager exists only for the bloom filters.
+  if (!HasFilterManager()) {
+    ast::Expr *fm_type = GetCodeGen()->BuiltinType(ast::BuiltinType::FilterManager);
+    local_filter_manager_ = GetPipeline()->DeclarePipelineStateEntry("filterManager", fm_type);
+  }
+  bloom_filters_.push_back(BloomFilterProbe{join_ht, std::move(key_cols)});
+  return true;
+}
+
 catalog::table_oid_t SeqScanTranslator::GetTableOid() const {
   return GetPlanAs<planner::SeqScanPlanNode>().GetTableOid();
 }
@@ -111,13 +137,7 @@ void SeqScanTranslator::GenerateFilterClauseFunctions(util::RegionVector<ast::Fu
   // Signature: (execCtx: *ExecutionContext, vp: *VectorProjection, tids: *TupleIdList, ctx: *uint8) -> nil
   auto *codegen = GetCodeGen();
   auto fn_name = codegen->MakeFreshIdentifier(GetPipeline()->CreatePipelineFunctionName("FilterClause"));
-  util::RegionVector<ast::FieldDecl *> params = codegen->MakeFieldList({
-      codegen->MakeField(codegen->MakeIdentifier("execCtx"), codegen->PointerType(ast::BuiltinType::ExecutionContext)),
-      codegen->MakeField(codegen->MakeIdentifier("vp"), codegen->PointerType(ast::BuiltinType::VectorProjection)),
-      codegen->MakeField(codegen->MakeIdentifier("tids"), codegen->PointerType(ast::BuiltinType::TupleIdList)),
-      codegen->MakeField(codegen->MakeIdentifier("context"), codegen->PointerType(ast::BuiltinType::Uint8)),
-  });
-  FunctionBuilder builder(codegen, fn_name, std::move(params), codegen->Nil());
+  FunctionBuilder builder(codegen, fn_name, MakeFilterTermParams(), codegen->Nil());
   {
     ast::Expr *exec_ctx = builder.GetParameterByPosition(0);
     ast::Expr *vector_proj = builder.GetParameterByPosition(1);
@@ -193,6 +213,47 @@ void SeqScanTranslator::GenerateFilterClauseFunctions(util::RegionVector<ast::Fu
   decls->push_back(builder.Finish());
 }
 
+util::RegionVector<ast::FieldDecl *> SeqScanTranslator::MakeFilterTermParams() const {
+  auto *codegen = GetCodeGen();
+  return codegen->MakeFieldList({
+      codegen->MakeField(codegen->MakeIdentifier("execCtx"), codegen->PointerType(ast::BuiltinType::ExecutionContext)),
+      codegen->MakeField(codegen->MakeIdentifier("vp"), codegen->PointerType(ast::BuiltinType::VectorProjection)),
+      codegen->MakeField(codegen->MakeIdentifier("tids"), codegen->PointerType(ast::BuiltinType::TupleIdList)),
+      codegen->MakeField(codegen->MakeIdentifier("context"), codegen->PointerType(ast::BuiltinType::Uint8)),
+  });
+}
+
+ast::Identifier SeqScanTranslator::GenerateBloomFilterTerm(util::RegionVector<ast::FunctionDecl *> *decls,
+                                                           const BloomFilterProbe &bloom_filter) {
+  auto *codegen = GetCodeGen();
+  auto fn_name = codegen->MakeFreshIdentifier(GetPipeline()->CreatePipelineFunctionName("BloomFilter"));
+  FunctionBuilder builder(codegen, fn_name, MakeFilterTermParams(), codegen->Nil());
+  {
+    // The filter manager hands the query state to its filters as their context.
+    // var queryState = @ptrCast(*QueryState, context)
+    auto *query_state = GetCompilationContext()->GetQueryState();
+    ast::Identifier query_state_var = GetCompilationContext()->QueryParams()[0]->Name();
+    ast::Expr *query_state_ptr = codegen->PtrCast(query_state->GetTypeName(), builder.GetParameterByPosition(3));
+    builder.Append(codegen->DeclareVarWithInit(query_state_var, query_state_ptr));
+
+    // var keyCols: [num_keys]uint32
+    ast::Identifier key_cols = codegen->MakeFreshIdentifier("keyCols");
+    const auto &key_col_indexes = bloom_filter.key_cols_;
+    ast::Expr *arr_type = codegen->ArrayType(key_col_indexes.size(), ast::BuiltinType::Kind::Uint32);
+    builder.Append(codegen->DeclareVarNoInit(key_cols, arr_type));
+    for (uint32_t i = 0; i < key_col_indexes.size(); i++) {
+      builder.Append(codegen->Assign(codegen->ArrayAccess(key_cols, i), codegen->Const32(key_col_indexes[i])));
+    }
+
+    // @joinHTFilterProbe(&queryState.joinHashTable, vp, tids, keyCols)
+    builder.Append(codegen->JoinHashTableFilterProbe(bloom_filter.join_ht_.GetPtr(codegen),
+                                                     builder.GetParameterByPosition(1),
+                                                     builder.GetParameterByPosition(2), key_cols));
+  }
+  decls->push_back(builder.Finish());
+  return fn_name;
+}
+
 void SeqScanTranslator::DefineHelperFunctions(util::RegionVector<ast::FunctionDecl *> *decls) {
   if (HasPredicate()) {
     std::vector<ast::Identifier> curr_clause;
@@ -200,6 +261,20 @@ void SeqScanTranslator::DefineHelperFunctions(util::RegionVector<ast::FunctionDe
     GenerateFilterClauseFunctions(decls, root_expr, &curr_clause, false);
     filters_.emplace_back(std::move(curr_clause));
   }
+
+  // A tuple passing any clause of the predicate must also pass all bloom filters.
+  if (!bloom_filters_.empty()) {
+    std::vector<ast::Identifier> bloom_filter_terms;
+    for (const auto &bloom_filter : bloom_filters_) {
+      bloom_filter_terms.push_back(GenerateBloomFilterTerm(decls, bloom_filter));
+    }
+    if (filters_.empty()) {
+      filters_.emplace_back();
+    }
+    for (auto &clause : filters_) {
+      clause.insert(clause.end(), bloom_filter_terms.begin(), bloom_filter_terms.end());
+    }
+  }
 }
 
 void SeqScanTranslator::ScanVPI(WorkContext *ctx, FunctionBuilder *function, ast::Expr *vpi) const {
@@ -219,7 +294,7 @@ void SeqScanTranslator::ScanVPI(WorkContext *ctx, FunctionBuilder *function, ast
     vpi_loop.EndLoop();
   };
   // TODO(Amadou): What if the predicate doesn't filter out anything?
-  gen_vpi_loop(HasPredicate());
+  gen_vpi_loop(HasFilterManager());
 }
 
 void SeqScanTranslator::ScanTable(WorkContext *ctx, FunctionBuilder *function) const {
@@ -231,8 +306,8 @@ void SeqScanTranslator::ScanTable(WorkContext *ctx, FunctionBuilder *function) c
     auto vpi = codegen->MakeExpr(vpi_var_);
     function->Append(codegen->DeclareVarWithInit(vpi_var_, codegen->TableIterGetVPI(codegen->MakeExpr(tvi_var_))));
 
-    // if (predicate)
-    if (HasPredicate()) {
+    // if (predicate or bloom filters)
+    if (HasFilterManager()) {
       auto filter_manager = local_filter_manager_.GetPtr(codegen);
       function->Append(codegen->FilterManagerRunFilters(filter_manager, vpi, GetExecutionContext()));
     }
@@ -245,9 +320,15 @@ void SeqScanTranslator::ScanTable(WorkContext *ctx, FunctionBuilder *function) c
 }
 
 void SeqScanTranslator::InitializePipelineState(const Pipeline &pipeline, FunctionBuilder *function) const {
-  if (HasPredicate()) {
+  if (HasFilterManager()) {
     auto *codegen = GetCodeGen();
-    function->Append(codegen->FilterManagerInit(local_filter_manager_.GetPtr(codegen), GetExecutionContext()));
+    auto filter_manager = local_filter_manager_.GetPtr(codegen);
+    if (bloom_filters_.empty()) {
+      function->Append(codegen->FilterManagerInit(filter_manager, GetExecutionContext()));
+    } else {
+      // Bloom filter terms find their join hash tables through the query state.
+      function->Append(codegen->FilterManagerInit(filter_manager, GetExecutionContext(), GetQueryStatePtr()));
+    }
     for (const auto &clause : filters_) {
       function->Append(codegen->FilterManagerInsert(local_filter_manager_.GetPtr(codegen), clause));
     }
@@ -255,7 +336,7 @@ void SeqScanTranslator::InitializePipelineState(const Pipeline &pipeline, Functi
 }
 
 void SeqScanTranslator::TearDownPipelineState(const Pipeline &pipeline, FunctionBuilder *function) const {
-  if (HasPredicate()) {
+  if (HasFilterManager()) {
     auto filter_manager = local_filter_manager_.GetPtr(GetCodeGen());
     function->Append(GetCodeGen()->FilterManagerFree(filter_manager));
   }
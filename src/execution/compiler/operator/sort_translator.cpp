@@ -7,6 +7,7 @@
 #include "execution/compiler/if.h"
 #include "execution/compiler/loop.h"
 #include "execution/compiler/work_context.h"
+#include "execution/exec/execution_settings.h"
 #include "planner/plannodes/order_by_plan_node.h"
 
 namespace terrier::execution::compiler {
@@ -52,6 +53,10 @@ SortTranslator::SortTranslator(const planner::OrderByPlanNode &plan, Compilation
   if (build_pipeline_.IsParallel()) {
     local_sorter_ = build_pipeline_.DeclarePipelineStateEntry("sorter", sorter_type);
   }
+
+  // Top-K sorts only keep K tuples around, so only full sorts spill, once they
+  // outgrow the execution_operator_memory_budget setting.
+  spill_enabled_ = !plan.HasLimit() && compilation_context->GetExecutionSettings().GetOperatorMemoryBudget() != 0;
 }
 
 void SortTranslator::DefineHelperStructs(util::RegionVector<ast::StructDecl *> *decls) {
@@ -108,6 +113,9 @@ void SortTranslator::DefineHelperFunctions(util::RegionVector<ast::FunctionDecl
 void SortTranslator::InitializeSorter(FunctionBuilder *function, ast::Expr *sorter_ptr) const {
   ast::Expr *mem_pool = GetMemoryPool();
   function->Append(GetCodeGen()->SorterInit(sorter_ptr, mem_pool, compare_func_, sort_row_type_));
+  if (spill_enabled_) {
+    function->Append(GetCodeGen()->SorterEnableSpilling(sorter_ptr, GetExecutionContext()));
+  }
 }
 
 void SortTranslator::TearDownSorter(FunctionBuilder *function, ast::Expr *sorter_ptr) const {
@@ -225,6 +225,20 @@ ast::FunctionDecl *Pipeline::GeneratePipelineWorkFunction() const {
   return builder.Finish();
 }
 
+bool Pipeline::HasDeferredWork() const {
+  return std::any_of(steps_.begin(), steps_.end(), [this](auto op) { return op->HasDeferredPipelineWork(*this); });
+}
+
+void Pipeline::PerformDeferredWork(FunctionBuilder *function) const {
+  // From the source on, so that tuples held back by one operator can still be held back by the ones after it.
+  for (auto iter = Begin(), end = End(); iter != end; ++iter) {
+    if ((*iter)->HasDeferredPipelineWork(*this)) {
+      WorkContext context(compilation_context_, *this, iter);
+      (*iter)->PerformDeferredPipelineWork(&context, function);
+    }
+  }
+}
+
 ast::FunctionDecl *Pipeline::GenerateRunPipelineFunction(query_id_t query_id) const {
   bool started_tracker = false;
   auto name = codegen_->MakeIdentifier(CreatePipelineFunctionName("Run"));
@@ -242,6 +256,16 @@ ast::FunctionDecl *Pipeline::GenerateRunPipelineFunction(query_id_t query_id) co
     if (IsParallel()) {
       // TODO(wz2): When can track parallel work, insert trackers
       driver_->LaunchWork(&builder, GetWorkFunctionName());
+
+      if (HasDeferredWork()) {
+        // The held back tuples are pushed through by this thread, in its own thread state.
+        // var pipelineState = @tlsGetCurrentThreadState(...)
+        auto exec_ctx = compilation_context_->GetExecutionContextPtrFromQueryState();
+        auto tls = codegen_->ExecCtxGetTLS(exec_ctx);
+        auto state = codegen_->TLSAccessCurrentThreadState(tls, state_.GetTypeName());
+        builder.Append(codegen_->DeclareVarWithInit(state_var_, state));
+        PerformDeferredWork(&builder);
+      }
     } else {
       auto exec_ctx = compilation_context_->GetExecutionContextPtrFromQueryState();
       auto tls = codegen_->ExecCtxGetTLS(exec_ctx);
@@ -255,6 +279,7 @@ ast::FunctionDecl *Pipeline::GenerateRunPipelineFunction(query_id_t query_id) co
 
       builder.Append(
           codegen_->Call(GetWorkFunctionName(), {builder.GetParameterByPosition(0), codegen_->MakeExpr(state_var_)}));
+      PerformDeferredWork(&builder);
     }
 
     // Let the operators perform some completion work in this pipeline.
@@ -7,9 +7,14 @@
 namespace terrier::execution::compiler {
 
 WorkContext::WorkContext(CompilationContext *compilation_context, const Pipeline &pipeline)
+    : WorkContext(compilation_context, pipeline, pipeline.Begin()) {}
+
+WorkContext::WorkContext(CompilationContext *compilation_context, const Pipeline &pipeline,
+                         Pipeline::StepIterator source)
     : compilation_context_(compilation_context),
       pipeline_(pipeline),
-      pipeline_iter_(pipeline_.Begin()),
+      pipeline_begin_(source),
+      pipeline_iter_(source),
       pipeline_end_(pipeline_.End()),
       cache_enabled_(true) {}
 
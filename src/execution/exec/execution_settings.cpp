@@ -0,0 +1,13 @@
+#include "execution/exec/execution_settings.h"
+
+#include "settings/settings_manager.h"
+
+namespace terrier::execution::exec {
+
+void ExecutionSettings::UpdateFromSettingsManager(common::ManagedPointer<settings::SettingsManager> settings) {
+  operator_memory_budget_ =
+      static_cast<uint64_t>(settings->GetInt64(settings::Param::execution_operator_memory_budget));
+  is_bloom_filter_pushdown_enabled_ = settings->GetBool(settings::Param::execution_bloom_filter_pushdown);
+}
+
+}  // namespace terrier::execution::exec
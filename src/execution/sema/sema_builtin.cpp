@@ -306,6 +306,13 @@ void Sema::CheckBuiltinAggHashTableCall(ast::CallExpr *call, ast::Builtin builti
       call->SetType(GetBuiltinType(ast::BuiltinType::Nil));
       break;
     }
+    case ast::Builtin::AggHashTableEnableSpilling: {
+      if (!CheckArgCount(call, 1)) {
+        return;
+      }
+      call->SetType(GetBuiltinType(ast::BuiltinType::Nil));
+      break;
+    }
     case ast::Builtin::AggHashTableInsert: {
       if (!CheckArgCountAtLeast(call, 2)) {
         return;
@@ -730,6 +737,9 @@ void Sema::CheckBuiltinJoinHashTableBuild(ast::CallExpr *call, ast::Builtin buil
       }
       break;
     }
+    case ast::Builtin::JoinHashTableBuildBloomFilter: {
+      break;
+    }
     default: {
       UNREACHABLE("Impossible join hash table build call");
     }
@@ -739,6 +749,126 @@ void Sema::CheckBuiltinJoinHashTableBuild(ast::CallExpr *call, ast::Builtin buil
   call->SetType(GetBuiltinType(ast::BuiltinType::Nil));
 }
 
+void Sema::CheckBuiltinJoinHashTableFilterProbe(ast::CallExpr *call) {
+  if (!CheckArgCount(call, 4)) {
+    return;
+  }
+
+  const auto &args = call->Arguments();
+
+  // First argument must be a pointer to a JoinHashTable
+  const auto jht_kind = ast::BuiltinType::JoinHashTable;
+  if (!IsPointerToSpecificBuiltin(args[0]->GetType(), jht_kind)) {
+    ReportIncorrectCallArg(call, 0, GetBuiltinType(jht_kind)->PointerTo());
+    return;
+  }
+
+  // Second argument is the batch of probe tuples
+  const auto vector_proj_kind = ast::BuiltinType::VectorProjection;
+  if (!IsPointerToSpecificBuiltin(args[1]->GetType(), vector_proj_kind)) {
+    ReportIncorrectCallArg(call, 1, GetBuiltinType(vector_proj_kind)->PointerTo());
+    return;
+  }
+
+  // Third argument is the list of tuples to filter
+  const auto tid_list_kind = ast::BuiltinType::TupleIdList;
+  if (!IsPointerToSpecificBuiltin(args[2]->GetType(), tid_list_kind)) {
+    ReportIncorrectCallArg(call, 2, GetBuiltinType(tid_list_kind)->PointerTo());
+    return;
+  }
+
+  // Fourth argument is an array of the key columns
+  if (auto array_type = args[3]->GetType()->SafeAs<ast::ArrayType>();
+      array_type == nullptr || !array_type->HasKnownLength()) {
+    ReportIncorrectCallArg(call, 3, "array with known length");
+    return;
+  }
+
+  // This call returns nothing
+  call->SetType(GetBuiltinType(ast::BuiltinType::Nil));
+}
+
+void Sema::CheckBuiltinJoinHashTableSpill(ast::CallExpr *call, ast::Builtin builtin) {
+  if (!CheckArgCountAtLeast(call, 1)) {
+    return;
+  }
+
+  const auto &args = call->Arguments();
+
+  // First argument must be a pointer to a JoinHashTable
+  const auto jht_kind = ast::BuiltinType::JoinHashTable;
+  if (!IsPointerToSpecificBuiltin(args[0]->GetType(), jht_kind)) {
+    ReportIncorrectCallArg(call, 0, GetBuiltinType(jht_kind)->PointerTo());
+    return;
+  }
+
+  switch (builtin) {
+    case ast::Builtin::JoinHashTableEnableSpilling: {
+      if (!CheckArgCount(call, 2)) {
+        return;
+      }
+      // Second argument is the 32-bit size of the probe tuples
+      if (!args[1]->GetType()->IsSpecificBuiltin(ast::BuiltinType::Uint32)) {
+        ReportIncorrectCallArg(call, 1, GetBuiltinType(ast::BuiltinType::Uint32));
+        return;
+      }
+      call->SetType(GetBuiltinType(ast::BuiltinType::Nil));
+      break;
+    }
+    case ast::Builtin::JoinHashTableIsResident: {
+      if (!CheckArgCount(call, 2)) {
+        return;
+      }
+      // Second argument is a 64-bit unsigned hash value
+      if (!args[1]->GetType()->IsSpecificBuiltin(ast::BuiltinType::Uint64)) {
+        ReportIncorrectCallArg(call, 1, GetBuiltinType(ast::BuiltinType::Uint64));
+        return;
+      }
+      call->SetType(GetBuiltinType(ast::BuiltinType::Bool));
+      break;
+    }
+    case ast::Builtin::JoinHashTableSpillProbeTuple: {
+      if (!CheckArgCount(call, 3)) {
+        return;
+      }
+      // Second argument is a 64-bit unsigned hash value
+      if (!args[1]->GetType()->IsSpecificBuiltin(ast::BuiltinType::Uint64)) {
+        ReportIncorrectCallArg(call, 1, GetBuiltinType(ast::BuiltinType::Uint64));
+        return;
+      }
+      // Third argument is a pointer to the probe tuple
+      if (!args[2]->GetType()->IsPointerType()) {
+        ReportIncorrectCallArg(call, 2, "pointer to probe tuple");
+        return;
+      }
+      call->SetType(GetBuiltinType(ast::BuiltinType::Nil));
+      break;
+    }
+    case ast::Builtin::JoinHashTableNextPartition: {
+      if (!CheckArgCount(call, 1)) {
+        return;
+      }
+      call->SetType(GetBuiltinType(ast::BuiltinType::Bool));
+      break;
+    }
+    case ast::Builtin::JoinHashTableReadProbeTuple: {
+      if (!CheckArgCount(call, 2)) {
+        return;
+      }
+      // Second argument is a pointer to where the probe tuple is read into
+      if (!args[1]->GetType()->IsPointerType()) {
+        ReportIncorrectCallArg(call, 1, "pointer to probe tuple");
+        return;
+      }
+      call->SetType(GetBuiltinType(ast::BuiltinType::Bool));
+      break;
+    }
+    default: {
+      UNREACHABLE("Impossible join hash table spilling call");
+    }
+  }
+}
+
 void Sema::CheckBuiltinJoinHashTableLookup(ast::CallExpr *call) {
   if (!CheckArgCount(call, 3)) {
     return;
@@ -1350,7 +1480,7 @@ void Sema::CheckBuiltinFilterManagerCall(ast::CallExpr *const call, const ast::B
   const auto exec_ctx_kind = ast::BuiltinType::ExecutionContext;
   switch (builtin) {
     case ast::Builtin::FilterManagerInit: {
-      if (!CheckArgCount(call, 2)) {
+      if (!CheckArgCountBetween(call, 2, 3)) {
         return;
       }
       // The second argument must be a pointer to the execution context.
@@ -1358,6 +1488,11 @@ void Sema::CheckBuiltinFilterManagerCall(ast::CallExpr *const call, const ast::B
         ReportIncorrectCallArg(call, 1, GetBuiltinType(exec_ctx_kind)->PointerTo());
         return;
       }
+      // The optional third argument is the opaque context passed to each filter.
+      if (call->NumArgs() == 3 && !call->Arguments()[2]->GetType()->IsPointerType()) {
+        ReportIncorrectCallArg(call, 2, GetBuiltinType(ast::BuiltinType::Uint8)->PointerTo());
+        return;
+      }
       call->SetType(GetBuiltinType(ast::BuiltinType::Nil));
       break;
     }
@@ -1791,6 +1926,31 @@ void Sema::CheckBuiltinSorterInit(ast::CallExpr *call) {
   call->SetType(GetBuiltinType(ast::BuiltinType::Nil));
 }
 
+void Sema::CheckBuiltinSorterEnableSpilling(ast::CallExpr *call) {
+  if (!CheckArgCount(call, 2)) {
+    return;
+  }
+
+  const auto &args = call->Arguments();
+
+  // First argument must be a pointer to a Sorter
+  const auto sorter_kind = ast::BuiltinType::Sorter;
+  if (!IsPointerToSpecificBuiltin(args[0]->GetType(), sorter_kind)) {
+    ReportIncorrectCallArg(call, 0, GetBuiltinType(sorter_kind)->PointerTo());
+    return;
+  }
+
+  // Second argument must be a pointer to the ExecutionContext, whose settings hold the memory budget
+  const auto exec_ctx_kind = ast::BuiltinType::ExecutionContext;
+  if (!IsPointerToSpecificBuiltin(args[1]->GetType(), exec_ctx_kind)) {
+    ReportIncorrectCallArg(call, 1, GetBuiltinType(exec_ctx_kind)->PointerTo());
+    return;
+  }
+
+  // This call returns nothing
+  call->SetType(GetBuiltinType(ast::BuiltinType::Nil));
+}
+
 void Sema::CheckBuiltinSorterInsert(ast::CallExpr *call, ast::Builtin builtin) {
   if (!CheckArgCountAtLeast(call, 1)) {
     return;
@@ -2308,7 +2468,8 @@ void Sema::CheckBuiltinStorageInterfaceCall(ast::CallExpr *call, ast::Builtin bu
       call->SetType(GetBuiltinType(ast::BuiltinType::Nil));
       break;
     }
-    case ast::Builtin::GetTablePR: {
+    case ast::Builtin::GetTablePR:
+    case ast::Builtin::GetTablePRForBatch: {
       if (!CheckArgCount(call, 1)) {
         return;
       }
@@ -2352,7 +2513,8 @@ void Sema::CheckBuiltinStorageInterfaceCall(ast::CallExpr *call, ast::Builtin bu
       call->SetType(GetBuiltinType(ast::BuiltinType::Bool));
       break;
     }
-    case ast::Builtin::GetIndexPR: {
+    case ast::Builtin::GetIndexPR:
+    case ast::Builtin::GetIndexPRForBatch: {
       if (!CheckArgCount(call, 2)) {
         return;
       }
@@ -2372,7 +2534,9 @@ void Sema::CheckBuiltinStorageInterfaceCall(ast::CallExpr *call, ast::Builtin bu
       call->SetType(GetBuiltinType(ast::BuiltinType::Bool));
       break;
     }
-    case ast::Builtin::IndexInsertUnique: {
+    case ast::Builtin::IndexInsertUnique:
+    case ast::Builtin::TableInsertBatch:
+    case ast::Builtin::IndexBulkLoadFinish: {
       if (!CheckArgCount(call, 1)) {
         return;
       }
@@ -2397,7 +2561,8 @@ void Sema::CheckBuiltinStorageInterfaceCall(ast::CallExpr *call, ast::Builtin bu
       call->SetType(GetBuiltinType(ast::BuiltinType::Bool));
       break;
     }
-    case ast::Builtin::IndexDelete: {
+    case ast::Builtin::IndexDelete:
+    case ast::Builtin::IndexBulkLoadAdd: {
       if (!CheckArgCount(call, 2)) {
         return;
       }
@@ -2998,6 +3163,7 @@ void Sema::CheckBuiltinCall(ast::CallExpr *call) {
       break;
     }
     case ast::Builtin::AggHashTableInit:
+    case ast::Builtin::AggHashTableEnableSpilling:
     case ast::Builtin::AggHashTableInsert:
     case ast::Builtin::AggHashTableLinkEntry:
     case ast::Builtin::AggHashTableLookup:
@@ -3041,10 +3207,23 @@ void Sema::CheckBuiltinCall(ast::CallExpr *call) {
       break;
     }
     case ast::Builtin::JoinHashTableBuild:
-    case ast::Builtin::JoinHashTableBuildParallel: {
+    case ast::Builtin::JoinHashTableBuildParallel:
+    case ast::Builtin::JoinHashTableBuildBloomFilter: {
       CheckBuiltinJoinHashTableBuild(call, builtin);
       break;
     }
+    case ast::Builtin::JoinHashTableFilterProbe: {
+      CheckBuiltinJoinHashTableFilterProbe(call);
+      break;
+    }
+    case ast::Builtin::JoinHashTableEnableSpilling:
+    case ast::Builtin::JoinHashTableIsResident:
+    case ast::Builtin::JoinHashTableSpillProbeTuple:
+    case ast::Builtin::JoinHashTableNextPartition:
+    case ast::Builtin::JoinHashTableReadProbeTuple: {
+      CheckBuiltinJoinHashTableSpill(call, builtin);
+      break;
+    }
     case ast::Builtin::JoinHashTableLookup: {
       CheckBuiltinJoinHashTableLookup(call);
       break;
@@ -3062,6 +3241,10 @@ void Sema::CheckBuiltinCall(ast::CallExpr *call) {
       CheckBuiltinSorterInit(call);
       break;
     }
+    case ast::Builtin::SorterEnableSpilling: {
+      CheckBuiltinSorterEnableSpilling(call);
+      break;
+    }
     case ast::Builtin::SorterInsert:
     case ast::Builtin::SorterInsertTopK:
     case ast::Builtin::SorterInsertTopKFinish: {
@@ -3182,6 +3365,11 @@ void Sema::CheckBuiltinCall(ast::CallExpr *call) {
     case ast::Builtin::IndexInsertUnique:
     case ast::Builtin::IndexInsertWithSlot:
     case ast::Builtin::IndexDelete:
+    case ast::Builtin::GetTablePRForBatch:
+    case ast::Builtin::GetIndexPRForBatch:
+    case ast::Builtin::TableInsertBatch:
+    case ast::Builtin::IndexBulkLoadAdd:
+    case ast::Builtin::IndexBulkLoadFinish:
     case ast::Builtin::StorageInterfaceFree: {
       CheckBuiltinStorageInterfaceCall(call, builtin);
       break;
@@ -3,6 +3,8 @@
 #include <tbb/parallel_for_each.h>
 
 #include <algorithm>
+#include <iterator>
+#include <limits>
 #include <memory>
 #include <numeric>
 #include <utility>
@@ -25,6 +27,18 @@
 
 namespace terrier::execution::sql {
 
+namespace {
+
+// The number of leading hash bits that select an overflow partition.
+constexpr uint32_t NUM_PARTITION_BITS = 9;
+static_assert(AggregationHashTable::DEFAULT_NUM_PARTITIONS == (1u << NUM_PARTITION_BITS));
+
+// The number of hash bits that select a spill partition, at each level of partitioning.
+constexpr uint32_t NUM_SPILL_PARTITION_BITS = 4;
+static_assert(AggregationHashTable::NUM_SPILL_PARTITIONS == (1u << NUM_SPILL_PARTITION_BITS));
+
+}  // namespace
+
 class AggregationHashTable::HashToGroupIdMap {
   // Marker indicating an empty slot in the hash table
   static constexpr const uint16_t EMPTY = std::numeric_limits<uint16_t>::max();
@@ -163,7 +177,9 @@ AggregationHashTable::AggregationHashTable(const exec::ExecutionSettings &exec_s
       partition_tails_(nullptr),
       partition_estimates_(nullptr),
       partition_tables_(nullptr),
-      partition_shift_bits_(util::BitUtil::CountLeadingZeros(uint64_t(DEFAULT_NUM_PARTITIONS) - 1)) {
+      partition_shift_bits_(util::BitUtil::CountLeadingZeros(uint64_t(DEFAULT_NUM_PARTITIONS) - 1)),
+      spill_threshold_(std::numeric_limits<uint64_t>::max()),
+      spilled_(false) {
   hash_table_.SetSize(initial_size, memory->GetTracker());
   max_fill_ = std::llround(hash_table_.GetCapacity() * hash_table_.GetLoadFactor());
 
@@ -293,7 +309,161 @@ void AggregationHashTable::FlushToOverflowPartitions() {
   stats_.num_flushes_++;
 }
 
+void AggregationHashTable::SpillIfNeeded() {
+  // If the aggregates take up the whole memory budget, write them all out to
+  // make room.
+  if (NeedsToSpill()) {
+    FlushToOverflowPartitions();
+    SpillOverflowPartitions();
+  }
+}
+
+void AggregationHashTable::EnableSpilling(const uint64_t memory_budget) {
+  TERRIER_ASSERT(entries_.empty(), "Spilling must be enabled before aggregates are inserted");
+  spill_threshold_ = memory_budget == 0 ? std::numeric_limits<uint64_t>::max()
+                                        : std::max<uint64_t>(memory_budget / entries_.ElementSize(), 1);
+}
+
+void AggregationHashTable::SpillOverflowPartitions() {
+  TERRIER_ASSERT(hash_table_.IsEmpty(), "Aggregates must be flushed to the overflow partitions before spilling");
+
+  // The partial aggregates are written out as they are, to the spill partition
+  // picked by the leading bits of their hash. The overflow partition of each is
+  // found again from its hash value when read back.
+  const uint32_t spill_shift = NUM_PARTITION_BITS - NUM_SPILL_PARTITION_BITS;
+  for (uint32_t part_idx = 0; part_idx < DEFAULT_NUM_PARTITIONS; part_idx++) {
+    if (partition_heads_[part_idx] == nullptr) {
+      continue;
+    }
+    auto &files = spill_files_[part_idx >> spill_shift];
+    if (files.empty()) {
+      files.emplace_back(std::make_unique<SpillFile>());
+    }
+    for (const HashTableEntry *entry = partition_heads_[part_idx]; entry != nullptr; entry = entry->next_) {
+      files.front()->Write(entry, entries_.ElementSize());
+    }
+    partition_heads_[part_idx] = partition_tails_[part_idx] = nullptr;
+  }
+
+  // Every entry was in an overflow partition, so all of them can go.
+  ReleaseEntries();
+  spilled_ = true;
+
+  // Update stats
+  stats_.num_spills_++;
+}
+
+void AggregationHashTable::ReleaseEntries() {
+  // ChunkedVector::clear() keeps its chunks around for reuse. Replace the
+  // vector to give them back to the memory pool.
+  entries_ = util::ChunkedVector<MemoryPoolAllocator<byte>>(entries_.ElementSize(), MemoryPoolAllocator<byte>(memory_));
+}
+
+void AggregationHashTable::ReleasePartitions(const uint32_t begin, const uint32_t end) {
+  for (uint32_t part_idx = begin; part_idx < end; part_idx++) {
+    if (partition_tables_[part_idx] != nullptr) {
+      partition_tables_[part_idx]->~AggregationHashTable();
+      memory_->Deallocate(partition_tables_[part_idx], sizeof(AggregationHashTable));
+      partition_tables_[part_idx] = nullptr;
+    }
+    partition_heads_[part_idx] = partition_tails_[part_idx] = nullptr;
+  }
+  // Keep the chunks to load the next spill partition into.
+  entries_.clear();
+}
+
+template <typename F>
+void AggregationHashTable::ProcessSpilledPartition(SpillPartition *files, const uint64_t hash_prefix,
+                                                   const uint32_t num_hash_bits, F &f) {
+  const std::size_t entry_size = entries_.ElementSize();
+  uint64_t num_entries = 0;
+  for (const auto &file : *files) {
+    num_entries += file->GetSize() / entry_size;
+  }
+  if (num_entries == 0) {
+    return;
+  }
+
+  // If the partition does not fit in the budget, split it on the next bits of
+  // the hash and process each part on its own. Partial aggregates of the same
+  // group share a hash value, so they always end up in the same part.
+  if (num_entries > spill_threshold_ && num_hash_bits + NUM_SPILL_PARTITION_BITS <= sizeof(hash_t) * 8) {
+    const uint32_t shift = sizeof(hash_t) * 8 - num_hash_bits - NUM_SPILL_PARTITION_BITS;
+    std::array<SpillPartition, NUM_SPILL_PARTITIONS> parts;
+    auto entry_buffer = std::make_unique<byte[]>(entry_size);
+    auto *entry = reinterpret_cast<HashTableEntry *>(entry_buffer.get());
+    for (const auto &file : *files) {
+      file->Rewind();
+      while (file->Read(entry, entry_size)) {
+        auto &part = parts[(entry->hash_ >> shift) & (NUM_SPILL_PARTITIONS - 1)];
+        if (part.empty()) {
+          part.emplace_back(std::make_unique<SpillFile>());
+        }
+        part.front()->Write(entry, entry_size);
+      }
+    }
+    files->clear();
+    stats_.num_spills_++;
+
+    for (uint32_t part_idx = 0; part_idx < NUM_SPILL_PARTITIONS; part_idx++) {
+      ProcessSpilledPartition(&parts[part_idx], (hash_prefix << NUM_SPILL_PARTITION_BITS) | part_idx,
+                              num_hash_bits + NUM_SPILL_PARTITION_BITS, f);
+    }
+    return;
+  }
+
+  // Read the partition back and link its entries into their overflow partitions.
+  for (const auto &file : *files) {
+    file->Rewind();
+    while (true) {
+      auto *entry = reinterpret_cast<HashTableEntry *>(entries_.Append());
+      if (!file->Read(entry, entry_size)) {
+        entries_.pop_back();
+        break;
+      }
+      const uint64_t partition_idx = (entry->hash_ >> partition_shift_bits_);
+      entry->next_ = partition_heads_[partition_idx];
+      partition_heads_[partition_idx] = entry;
+      if (partition_tails_[partition_idx] == nullptr) {
+        partition_tails_[partition_idx] = entry;
+      }
+    }
+  }
+  files->clear();
+
+  // The overflow partitions the spill partition covers. Past the partition
+  // bits, it is a part of a single overflow partition.
+  uint32_t begin, end;
+  if (num_hash_bits <= NUM_PARTITION_BITS) {
+    begin = hash_prefix << (NUM_PARTITION_BITS - num_hash_bits);
+    end = begin + (1u << (NUM_PARTITION_BITS - num_hash_bits));
+  } else {
+    begin = hash_prefix >> (num_hash_bits - NUM_PARTITION_BITS);
+    end = begin + 1;
+  }
+  f(begin, end);
+  ReleasePartitions(begin, end);
+}
+
+template <typename F>
+void AggregationHashTable::ForEachPartitionRange(F &&f) {
+  if (!IsSpilled()) {
+    f(0, DEFAULT_NUM_PARTITIONS);
+    return;
+  }
+
+  // Only one spill partition is in memory at a time. Their files are removed
+  // as they are read, so the partitions can only be scanned once.
+  for (uint32_t spill_idx = 0; spill_idx < NUM_SPILL_PARTITIONS; spill_idx++) {
+    ProcessSpilledPartition(&spill_files_[spill_idx], spill_idx, NUM_SPILL_PARTITION_BITS, f);
+  }
+  ReleaseEntries();
+}
+
 byte *AggregationHashTable::AllocInputTuplePartitioned(hash_t hash) {
+  // Spill before allocating. The caller only initializes the new aggregate after
+  // this returns, so it must not be written out by this call.
+  SpillIfNeeded();
   byte *ret = AllocInputTuple(hash);
   if (NeedsToFlushToOverflowPartitions()) {
     FlushToOverflowPartitions();
@@ -495,6 +665,11 @@ void AggregationHashTable::ProcessBatch(VectorProjectionIterator *input_batch, c
     return;
   }
 
+  // Spill before processing the batch, while no aggregate is being updated.
+  if (partitioned_aggregation) {
+    SpillIfNeeded();
+  }
+
   // Initialize the batch state if need be. Note: this is only performed once.
   if (UNLIKELY(batch_state_ == nullptr)) {
     batch_state_ = memory_->MakeObject<BatchProcessState>(
@@ -552,6 +727,21 @@ void AggregationHashTable::TransferMemoryAndPartitions(
   std::vector<AggregationHashTable *> tl_agg_ht;
   thread_states->CollectThreadLocalStateElementsAs(&tl_agg_ht, agg_ht_offset);
 
+  // If any thread-local table spilled, or they would not fit in memory
+  // together, spill them all.
+  if (spill_threshold_ != std::numeric_limits<uint64_t>::max()) {
+    uint64_t num_entries = entries_.size();
+    bool any_spilled = IsSpilled();
+    for (const auto *table : tl_agg_ht) {
+      num_entries += table->entries_.size();
+      any_spilled = any_spilled || table->IsSpilled();
+    }
+    if (any_spilled || num_entries >= spill_threshold_) {
+      TransferSpilledPartitions(tl_agg_ht);
+      return;
+    }
+  }
+
   for (auto *table : tl_agg_ht) {
     // Flush each table to ensure their hash tables are empty and their overflow
     // partitions contain all partial aggregates
@@ -580,6 +770,38 @@ void AggregationHashTable::TransferMemoryAndPartitions(
   }
 }
 
+void AggregationHashTable::TransferSpilledPartitions(const std::vector<AggregationHashTable *> &tl_agg_ht) {
+  util::Timer<std::milli> timer;
+  timer.Start();
+
+  // Each thread-local table writes out all of its partial aggregates to its
+  // own files.
+  tbb::parallel_for_each(tl_agg_ht, [](auto *table) {
+    TERRIER_ASSERT(table->owned_entries_.empty(),
+                   "A thread-local aggregation table should not have any owned "
+                   "entries themselves. Nested/recursive aggregations not supported.");
+    table->FlushToOverflowPartitions();
+    table->SpillOverflowPartitions();
+  });
+  SpillOverflowPartitions();
+
+  // Now, take over their files and merge their unique-count estimates.
+  for (auto *table : tl_agg_ht) {
+    for (uint32_t spill_idx = 0; spill_idx < NUM_SPILL_PARTITIONS; spill_idx++) {
+      auto &files = table->spill_files_[spill_idx];
+      std::move(files.begin(), files.end(), std::back_inserter(spill_files_[spill_idx]));
+      files.clear();
+    }
+    for (uint32_t part_idx = 0; part_idx < DEFAULT_NUM_PARTITIONS; part_idx++) {
+      partition_estimates_[part_idx]->Merge(table->partition_estimates_[part_idx]);
+    }
+  }
+
+  timer.Stop();
+  EXECUTION_LOG_TRACE("Spilled and transferred {} thread-local tables in {:.2f} ms", tl_agg_ht.size(),
+                      timer.GetElapsed());
+}
+
 AggregationHashTable *AggregationHashTable::GetOrBuildTableOverPartition(void *query_state,
                                                                          const uint32_t partition_idx) {
   TERRIER_ASSERT(partition_idx < DEFAULT_NUM_PARTITIONS, "Out-of-bounds partition access");
@@ -593,8 +815,12 @@ AggregationHashTable *AggregationHashTable::GetOrBuildTableOverPartition(void *q
     return partition_tables_[partition_idx];
   }
 
-  // Create it
+  // Create it. A spilled partition may only be partly loaded, and it can not
+  // hold more groups than the entries that are.
   auto estimated_size = partition_estimates_[partition_idx]->Estimate();
+  if (IsSpilled()) {
+    estimated_size = std::min<uint64_t>(estimated_size, entries_.size());
+  }
   auto *agg_table = new (memory_->AllocateAligned(sizeof(AggregationHashTable), alignof(AggregationHashTable), false))
       AggregationHashTable(exec_settings_, memory_, payload_size_, estimated_size);
 
@@ -621,15 +847,17 @@ void AggregationHashTable::ExecutePartitionedScan(void *query_state, Aggregation
                  "No overflow partitions allocated, or no merging function allocated. Did you call "
                  "TransferMemoryAndPartitions() before issuing the partitioned scan?");
 
-  // Determine the non-empty overflow partitions.
-  for (uint32_t part_idx = 0; part_idx < DEFAULT_NUM_PARTITIONS; part_idx++) {
-    if (partition_heads_[part_idx] != nullptr) {
-      // Get or build the table on the partition.
-      auto agg_table_partition = GetOrBuildTableOverPartition(query_state, part_idx);
-      // Scan the partition.
-      scan_fn(query_state, nullptr, agg_table_partition);
+  ForEachPartitionRange([&](const uint32_t begin, const uint32_t end) {
+    // Determine the non-empty overflow partitions.
+    for (uint32_t part_idx = begin; part_idx < end; part_idx++) {
+      if (partition_heads_[part_idx] != nullptr) {
+        // Get or build the table on the partition.
+        auto agg_table_partition = GetOrBuildTableOverPartition(query_state, part_idx);
+        // Scan the partition.
+        scan_fn(query_state, nullptr, agg_table_partition);
+      }
     }
-  }
+  });
 }
 
 void AggregationHashTable::ExecuteParallelPartitionedScan(void *query_state, ThreadStateContainer *thread_states,
@@ -640,47 +868,55 @@ void AggregationHashTable::ExecuteParallelPartitionedScan(void *query_state, Thr
   // the contents of that partition into the new hash table. We use the HLL
   // estimates to size the hash table before construction so as to minimize the
   // growth factor. Each aggregation hash table partition will be built and
-  // scanned in parallel.
+  // scanned in parallel. Spilled partitions are built and scanned one range
+  // of partitions at a time.
 
   TERRIER_ASSERT(partition_heads_ != nullptr && merge_partition_fn_ != nullptr,
                  "No overflow partitions allocated, or no merging function allocated. Did you call "
                  "TransferMemoryAndPartitions() before issuing the partitioned scan?");
 
-  // Determine the non-empty overflow partitions
-  std::vector<uint32_t> nonempty_parts;
-  nonempty_parts.reserve(DEFAULT_NUM_PARTITIONS);
-  for (uint32_t i = 0; i < DEFAULT_NUM_PARTITIONS; i++) {
-    if (partition_heads_[i] != nullptr) {
-      nonempty_parts.push_back(i);
-    }
-  }
-
   util::Timer<std::milli> timer;
   timer.Start();
 
-  tbb::parallel_for_each(nonempty_parts, [&](const uint32_t part_idx) {
-    // Build a hash table over the given partition
-    auto agg_table_partition = GetOrBuildTableOverPartition(query_state, part_idx);
+  uint64_t num_tables = 0, tuple_count = 0;
+  ForEachPartitionRange([&](const uint32_t begin, const uint32_t end) {
+    // Determine the non-empty overflow partitions
+    std::vector<uint32_t> nonempty_parts;
+    nonempty_parts.reserve(end - begin);
+    for (uint32_t i = begin; i < end; i++) {
+      if (partition_heads_[i] != nullptr) {
+        nonempty_parts.push_back(i);
+      }
+    }
+
+    tbb::parallel_for_each(nonempty_parts, [&](const uint32_t part_idx) {
+      // Build a hash table over the given partition
+      auto agg_table_partition = GetOrBuildTableOverPartition(query_state, part_idx);
+
+      // Get a handle to the thread-local state of the executing thread
+      auto thread_state = thread_states->AccessCurrentThreadState();
 
-    // Get a handle to the thread-local state of the executing thread
-    auto thread_state = thread_states->AccessCurrentThreadState();
+      // Scan the partition
+      scan_fn(query_state, thread_state, agg_table_partition);
+    });
 
-    // Scan the partition
-    scan_fn(query_state, thread_state, agg_table_partition);
+    num_tables += nonempty_parts.size();
+    tuple_count += std::accumulate(
+        nonempty_parts.begin(), nonempty_parts.end(), uint64_t{0},
+        [&](const auto curr, const auto idx) { return curr + partition_tables_[idx]->GetTupleCount(); });
   });
 
   timer.Stop();
 
-  const uint64_t tuple_count =
-      std::accumulate(nonempty_parts.begin(), nonempty_parts.end(), uint64_t{0},
-                      [&](const auto curr, const auto idx) { return curr + partition_tables_[idx]->GetTupleCount(); });
-
   double tps = (tuple_count / timer.GetElapsed()) / 1000.0;
-  EXECUTION_LOG_TRACE("Built and scanned {} tables totalling {} tuples in {:.2f} ms ({:.2f} mtps)",
-                      nonempty_parts.size(), tuple_count, timer.GetElapsed(), tps);
+  EXECUTION_LOG_TRACE("Built and scanned {} tables totalling {} tuples in {:.2f} ms ({:.2f} mtps)", num_tables,
+                      tuple_count, timer.GetElapsed(), tps);
 }
 
 void AggregationHashTable::BuildAllPartitions(void *query_state) {
+  if (IsSpilled()) {
+    throw EXECUTION_EXCEPTION("Spilled aggregation hash tables can only be scanned, not built.");
+  }
   TERRIER_ASSERT(partition_tables_ == nullptr, "Should not have built aggregation hash tables already");
   partition_tables_ = memory_->AllocateArray<AggregationHashTable *>(DEFAULT_NUM_PARTITIONS, true);
 
@@ -699,6 +935,10 @@ void AggregationHashTable::BuildAllPartitions(void *query_state) {
 }
 
 void AggregationHashTable::Repartition() {
+  if (IsSpilled()) {
+    throw EXECUTION_EXCEPTION("Spilled aggregation hash tables can only be scanned, not repartitioned.");
+  }
+
   // Find all non-empty partitions.
   std::vector<AggregationHashTable *> nonempty_tables;
   nonempty_tables.reserve(DEFAULT_NUM_PARTITIONS);
@@ -730,6 +970,10 @@ void AggregationHashTable::Repartition() {
 
 void AggregationHashTable::MergePartitions(AggregationHashTable *target, void *query_state,
                                            AggregationHashTable::MergePartitionFn merge_func) {
+  if (IsSpilled() || target->IsSpilled()) {
+    throw EXECUTION_EXCEPTION("Spilled aggregation hash tables can only be scanned, not merged.");
+  }
+
   if (target->partition_tables_ == nullptr) {
     target->partition_tables_ = memory_->AllocateArray<AggregationHashTable *>(DEFAULT_NUM_PARTITIONS, true);
   }
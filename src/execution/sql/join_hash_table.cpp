@@ -4,13 +4,18 @@
 #include <tbb/parallel_for_each.h>
 
 #include <algorithm>
+#include <iterator>
 #include <limits>
+#include <memory>
 #include <utility>
 #include <vector>
 
 #include "execution/sql/memory_pool.h"
+#include "execution/sql/static_vector.h"
 #include "execution/sql/thread_state_container.h"
+#include "execution/sql/tuple_id_list.h"
 #include "execution/sql/vector.h"
+#include "execution/sql/vector_projection.h"
 #include "execution/sql/vector_operations/unary_operation_executor.h"
 #include "execution/util/cpu_info.h"
 #include "execution/util/memory.h"
@@ -20,16 +25,44 @@
 
 namespace terrier::execution::sql {
 
+namespace {
+
+// Spilled tuples are partitioned on hash bits above those that hash table directories are indexed
+// with, and below those that chaining hash tables tag their entries with.
+constexpr uint32_t SPILL_HASH_SHIFT = 32;
+constexpr uint32_t SPILL_PARTITION_BITS = 4;
+static_assert(JoinHashTable::NUM_SPILL_PARTITIONS == 1u << SPILL_PARTITION_BITS);
+
+// The number of hash bits tuples are partitioned on, over all levels of partitioning.
+constexpr uint32_t SPILL_DIRECTORY_BITS = SPILL_PARTITION_BITS * JoinHashTable::MAX_SPILL_LEVELS;
+
+// Marks the partitions without build tuples in the partition directory.
+constexpr uint32_t NO_PARTITION = std::numeric_limits<uint32_t>::max();
+
+// The partition at the given level of partitioning that a tuple with the given hash value goes to.
+uint32_t SpillPartitionIndex(const hash_t hash, const uint32_t level) {
+  return (hash >> (SPILL_HASH_SHIFT + level * SPILL_PARTITION_BITS)) & (JoinHashTable::NUM_SPILL_PARTITIONS - 1);
+}
+
+// The slot in the partition directory of a tuple with the given hash value.
+uint32_t SpillDirectoryIndex(const hash_t hash) {
+  return (hash >> SPILL_HASH_SHIFT) & ((1u << SPILL_DIRECTORY_BITS) - 1);
+}
+
+}  // namespace
+
 JoinHashTable::JoinHashTable(const exec::ExecutionSettings &exec_settings, MemoryPool *memory, uint32_t tuple_size,
                              bool use_concise_ht)
     : exec_settings_(exec_settings),
+      memory_(memory),
       entries_(HashTableEntry::ComputeEntrySize(tuple_size), MemoryPoolAllocator<byte>(memory)),
       owned_(memory),
       concise_hash_table_(0),
       hll_estimator_(libcount::HLL::Create(DEFAULT_HLL_PRECISION)),
       built_(false),
       use_concise_ht_(use_concise_ht),
-      tracker_(memory->GetTracker()) {}
+      tracker_(memory->GetTracker()),
+      spill_threshold_(std::numeric_limits<uint64_t>::max()) {}
 
 // Needed because we forward-declared HLL from libcount
 JoinHashTable::~JoinHashTable() = default;
@@ -38,6 +71,15 @@ byte *JoinHashTable::AllocInputTuple(const hash_t hash) {
   // Add to unique_count estimation
   hll_estimator_->Update(hash);
 
+  // If the buffered tuples take up the whole memory budget, write them out to make room.
+  if (UNLIKELY(entries_.size() >= spill_threshold_)) {
+    if (!spilled_) {
+      spill_partitions_ = MakeSpillPartitions(nullptr);
+      spilled_ = true;
+    }
+    SpillEntries(&entries_, &spill_partitions_);
+  }
+
   // Allocate space for a new tuple
   auto *entry = reinterpret_cast<HashTableEntry *>(entries_.Append());
   entry->hash_ = hash;
@@ -494,8 +536,10 @@ void JoinHashTable::Build() {
   util::Timer<> timer;
   timer.Start();
 
-  // Build
-  if (UsingConciseHashTable()) {
+  // Build. Spilled partitions are built one at a time as they are probed, see NextPartition().
+  if (IsSpilled()) {
+    FinishSpilling();
+  } else if (UsingConciseHashTable()) {
     BuildConciseHashTable();
   } else {
     BuildChainingHashTable();
@@ -508,7 +552,224 @@ void JoinHashTable::Build() {
   built_ = true;
 }
 
-// TODO(pmenon): Vectorized bloom filter pre-filtering.
+void JoinHashTable::BuildBloomFilter() {
+  TERRIER_ASSERT(!HasBloomFilter(), "Bloom filter has already been built");
+
+  if (IsSpilled()) {
+    uint64_t num_tuples = 0;
+    for (const auto &partition : spill_partitions_) {
+      num_tuples += partition.num_tuples_;
+    }
+    bloom_filter_.Init(memory_, static_cast<uint32_t>(std::max<uint64_t>(num_tuples, 1)));
+
+    // The resident partition is in memory. The others are read back for their hash values, one tuple at a time.
+    for (const byte *entry : entries_) {
+      bloom_filter_.Add(reinterpret_cast<const HashTableEntry *>(entry)->hash_);
+    }
+    std::vector<byte> buffer(entries_.ElementSize());
+    auto *entry = reinterpret_cast<const HashTableEntry *>(buffer.data());
+    for (uint64_t idx = resident_partition_ + 1; idx < spill_partitions_.size(); idx++) {
+      for (const auto &file : spill_partitions_[idx].files_) {
+        file->Rewind();
+        while (file->Read(buffer.data(), buffer.size())) {
+          bloom_filter_.Add(entry->hash_);
+        }
+      }
+    }
+
+    EXECUTION_LOG_DEBUG("JHT: {}", bloom_filter_.DebugString());
+    return;
+  }
+
+  // The filter needs at least one block, even if there is nothing to add.
+  bloom_filter_.Init(memory_, static_cast<uint32_t>(std::max<uint64_t>(GetTupleCount(), 1)));
+
+  // After a parallel merge, the tuples live in the thread-local entries this table took ownership of.
+  for (const byte *entry : entries_) {
+    bloom_filter_.Add(reinterpret_cast<const HashTableEntry *>(entry)->hash_);
+  }
+  for (const auto &entries : owned_) {
+    for (const byte *entry : entries) {
+      bloom_filter_.Add(reinterpret_cast<const HashTableEntry *>(entry)->hash_);
+    }
+  }
+
+  EXECUTION_LOG_DEBUG("JHT: {}", bloom_filter_.DebugString());
+}
+
+void JoinHashTable::FilterProbeBatch(VectorProjection *input, const std::vector<uint32_t> &key_cols,
+                                     TupleIdList *tid_list) const {
+  TERRIER_ASSERT(HasBloomFilter(), "Bloom filter must be built before probe tuples are filtered with it");
+
+  // Only hash the tuples that are still alive.
+  input->SetFilteredSelections(*tid_list);
+  StaticVector<hash_t> hashes;
+  input->Hash(key_cols, &hashes);
+
+  const auto *RESTRICT raw_hashes = reinterpret_cast<const hash_t *>(hashes.GetData());
+  tid_list->Filter([&](const uint64_t i) { return bloom_filter_.Contains(raw_hashes[i]); });
+}
+
+void JoinHashTable::EnableSpilling(const uint64_t memory_budget, const uint32_t probe_tuple_size) {
+  TERRIER_ASSERT(!UsingConciseHashTable(), "Spilling concise hash tables is not supported");
+  TERRIER_ASSERT(entries_.empty(), "Spilling must be enabled before tuples are inserted");
+  memory_budget_ = memory_budget;
+  probe_tuple_size_ = probe_tuple_size;
+  spill_threshold_ = memory_budget == 0 ? std::numeric_limits<uint64_t>::max()
+                                        : std::max<uint64_t>(memory_budget / entries_.ElementSize(), 1);
+}
+
+SpillFile *JoinHashTable::SpillPartition::GetWriteFile() {
+  if (files_.empty()) {
+    files_.emplace_back(std::make_unique<SpillFile>());
+  }
+  return files_.front().get();
+}
+
+uint64_t JoinHashTable::SpillPartition::GetSize() const {
+  uint64_t size = 0;
+  for (const auto &file : files_) {
+    size += file->GetSize();
+  }
+  return size;
+}
+
+std::vector<JoinHashTable::SpillPartition> JoinHashTable::MakeSpillPartitions(const SpillPartition *parent) {
+  const uint32_t level = parent == nullptr ? 0 : parent->level_ + 1;
+  const uint32_t shift = SPILL_HASH_SHIFT + level * SPILL_PARTITION_BITS;
+  std::vector<SpillPartition> partitions(NUM_SPILL_PARTITIONS);
+  for (uint32_t idx = 0; idx < NUM_SPILL_PARTITIONS; idx++) {
+    partitions[idx].bits_ = (parent == nullptr ? 0 : parent->bits_) | (hash_t{idx} << shift);
+    partitions[idx].mask_ = (parent == nullptr ? 0 : parent->mask_) | (hash_t{NUM_SPILL_PARTITIONS - 1} << shift);
+    partitions[idx].level_ = level;
+  }
+  return partitions;
+}
+
+void JoinHashTable::SpillEntries(util::ChunkedVector<MemoryPoolAllocator<byte>> *entries,
+                                 std::vector<SpillPartition> *partitions) const {
+  const uint32_t level = partitions->front().level_;
+  for (const byte *raw_entry : *entries) {
+    const auto *entry = reinterpret_cast<const HashTableEntry *>(raw_entry);
+    SpillPartition &partition = (*partitions)[SpillPartitionIndex(entry->hash_, level)];
+    partition.GetWriteFile()->Write(entry, entries->ElementSize());
+    partition.num_tuples_++;
+  }
+  entries->clear();
+}
+
+bool JoinHashTable::ReadSpilledEntry(SpillFile *file) {
+  if (!file->Read(entries_.Append(), entries_.ElementSize())) {
+    entries_.pop_back();
+    return false;
+  }
+  return true;
+}
+
+void JoinHashTable::LoadSpillPartition(const SpillPartition &partition) {
+  entries_.clear();
+  for (const auto &file : partition.files_) {
+    file->Rewind();
+    while (ReadSpilledEntry(file.get())) {
+    }
+  }
+}
+
+void JoinHashTable::FinishSpilling() {
+  SpillEntries(&entries_, &spill_partitions_);
+
+  // Split the partitions that would not fit in memory on the next hash bits, until they do.
+  std::vector<SpillPartition> partitions = std::move(spill_partitions_);
+  spill_partitions_.clear();
+  while (!partitions.empty()) {
+    SpillPartition partition = std::move(partitions.back());
+    partitions.pop_back();
+    if (partition.num_tuples_ == 0) {
+      continue;
+    }
+    if (partition.GetSize() <= memory_budget_ || partition.level_ + 1 == MAX_SPILL_LEVELS) {
+      spill_partitions_.emplace_back(std::move(partition));
+      continue;
+    }
+
+    EXECUTION_LOG_DEBUG("JHT: Partition of {} tuples ({} bytes) at level {} exceeds memory budget, splitting",
+                        partition.num_tuples_, partition.GetSize(), partition.level_);
+    auto children = MakeSpillPartitions(&partition);
+    for (const auto &file : partition.files_) {
+      file->Rewind();
+      do {
+        if (entries_.size() >= spill_threshold_) {
+          SpillEntries(&entries_, &children);
+        }
+      } while (ReadSpilledEntry(file.get()));
+    }
+    SpillEntries(&entries_, &children);
+    std::move(children.begin(), children.end(), std::back_inserter(partitions));
+  }
+
+  EXECUTION_LOG_DEBUG("JHT: Spilled build tuples to {} partitions", spill_partitions_.size());
+
+  // Point every combination of partitioning hash bits at the partition that covers it.
+  partition_directory_.assign(1u << SPILL_DIRECTORY_BITS, NO_PARTITION);
+  for (uint32_t idx = 0; idx < spill_partitions_.size(); idx++) {
+    const SpillPartition &partition = spill_partitions_[idx];
+    const uint32_t num_bits = (partition.level_ + 1) * SPILL_PARTITION_BITS;
+    for (uint32_t high_bits = 0; high_bits < 1u << (SPILL_DIRECTORY_BITS - num_bits); high_bits++) {
+      partition_directory_[(high_bits << num_bits) | SpillDirectoryIndex(partition.bits_)] = idx;
+    }
+  }
+  probe_latches_ = std::vector<std::mutex>(spill_partitions_.size());
+
+  // The first partition is probed along with the probe input.
+  if (!spill_partitions_.empty()) {
+    MakeResident(0);
+  }
+}
+
+void JoinHashTable::MakeResident(const uint64_t partition_idx) {
+  SpillPartition &partition = spill_partitions_[partition_idx];
+  LoadSpillPartition(partition);
+  BuildChainingHashTable();
+  resident_partition_ = partition_idx;
+  resident_bits_ = partition.bits_;
+  resident_mask_ = partition.mask_;
+
+  // The build tuples are read back only once.
+  partition.files_.clear();
+  if (partition.probe_file_ != nullptr) {
+    partition.probe_file_->Rewind();
+  }
+}
+
+void JoinHashTable::SpillProbeTuple(const hash_t hash, const byte *tuple) {
+  TERRIER_ASSERT(IsSpilled() && !IsResident(hash), "Only probe tuples of partitions not in memory are spilled");
+  const uint32_t partition_idx = partition_directory_[SpillDirectoryIndex(hash)];
+  if (partition_idx == NO_PARTITION) {
+    return;
+  }
+  SpillPartition &partition = spill_partitions_[partition_idx];
+  std::lock_guard<std::mutex> latch(probe_latches_[partition_idx]);
+  if (partition.probe_file_ == nullptr) {
+    partition.probe_file_ = std::make_unique<SpillFile>();
+  }
+  partition.probe_file_->Write(tuple, probe_tuple_size_);
+}
+
+bool JoinHashTable::NextPartition() {
+  if (!IsSpilled() || resident_partition_ + 1 >= spill_partitions_.size()) {
+    return false;
+  }
+  // The probe tuples of the partition in memory have all been probed.
+  spill_partitions_[resident_partition_].probe_file_.reset();
+  MakeResident(resident_partition_ + 1);
+  return true;
+}
+
+bool JoinHashTable::ReadProbeTuple(byte *tuple) {
+  const auto &probe_file = spill_partitions_[resident_partition_].probe_file_;
+  return probe_file != nullptr && probe_file->Read(tuple, probe_tuple_size_);
+}
+
 // TODO(pmenon): Implement prefetching.
 
 void JoinHashTable::LookupBatchInChainingHashTable(const Vector &hashes, Vector *results) const {
@@ -557,6 +818,20 @@ void JoinHashTable::MergeParallel(const ThreadStateContainer *thread_state_conta
     hll_estimator_->Merge(jht->hll_estimator_.get());
   }
 
+  // If the thread-local tables spilled, or would not fit in memory together, spill them all.
+  if (spill_threshold_ != std::numeric_limits<uint64_t>::max()) {
+    uint64_t num_buffered = entries_.size();
+    bool any_spilled = false;
+    for (const auto *jht : tl_join_tables) {
+      num_buffered += jht->entries_.size();
+      any_spilled = any_spilled || jht->IsSpilled();
+    }
+    if (any_spilled || num_buffered > spill_threshold_) {
+      MergeSpilled(tl_join_tables);
+      return;
+    }
+  }
+
   // Size the global hash table
   uint64_t num_elem_estimate = hll_estimator_->Estimate();
   chaining_hash_table_.SetSize(num_elem_estimate, tracker_);
@@ -589,4 +864,39 @@ void JoinHashTable::MergeParallel(const ThreadStateContainer *thread_state_conta
                       chaining_hash_table_.GetElementCount(), timer.GetElapsed(), tps);
 }
 
+void JoinHashTable::MergeSpilled(const std::vector<JoinHashTable *> &tl_join_tables) {
+  util::Timer<std::milli> timer;
+  timer.Start();
+
+  // Each thread-local table writes out what it still buffers to its own files.
+  tbb::parallel_for_each(tl_join_tables, [this](auto *source) {
+    if (!source->IsSpilled()) {
+      source->spill_partitions_ = MakeSpillPartitions(nullptr);
+      source->spilled_ = true;
+    }
+    SpillEntries(&source->entries_, &source->spill_partitions_);
+  });
+
+  // Take ownership of the files of all thread-local tables.
+  if (!IsSpilled()) {
+    spill_partitions_ = MakeSpillPartitions(nullptr);
+    spilled_ = true;
+  }
+  for (auto *source : tl_join_tables) {
+    for (uint32_t idx = 0; idx < NUM_SPILL_PARTITIONS; idx++) {
+      SpillPartition &partition = source->spill_partitions_[idx];
+      spill_partitions_[idx].num_tuples_ += partition.num_tuples_;
+      std::move(partition.files_.begin(), partition.files_.end(), std::back_inserter(spill_partitions_[idx].files_));
+      partition.files_.clear();
+      partition.num_tuples_ = 0;
+    }
+  }
+
+  FinishSpilling();
+
+  timer.Stop();
+  EXECUTION_LOG_TRACE("JHT: Spilled and merged {} JHTs into {} partitions. Time: {:.2f} ms", tl_join_tables.size(),
+                      spill_partitions_.size(), timer.GetElapsed());
+}
+
 }  // namespace terrier::execution::sql
@@ -5,10 +5,17 @@
 #include <tbb/task_scheduler_init.h>
 
 #include <algorithm>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <numeric>
 #include <queue>
 #include <utility>
 #include <vector>
 
+#include "common/constants.h"
 #include "execution/sql/thread_state_container.h"
 #include "execution/util/stage_timer.h"
 #include "ips4o/ips4o.hpp"
@@ -16,6 +23,116 @@
 
 namespace terrier::execution::sql {
 
+//===----------------------------------------------------------------------===//
+//
+// Sorted Run Merger
+//
+//===----------------------------------------------------------------------===//
+
+/**
+ * Merges sorted runs, spilled to disk or in memory, with a loser tree. Leaf i of the tree is run i, and each inner node
+ * holds the run that lost the match played there, the overall winner being kept in the root slot. Moving to the next
+ * row only replays the matches on the path from the winning run up to the root.
+ */
+class SortedRunMerger {
+ public:
+  SortedRunMerger(Sorter::ComparisonFunction cmp_fn, std::size_t tuple_size)
+      : cmp_fn_(cmp_fn), tuple_size_(tuple_size) {}
+
+  // Add a run spilled to disk. Its file is read from the start.
+  void AddRun(SpillFile *file) {
+    file->Rewind();
+    runs_.push_back(Run{file, nullptr, nullptr, nullptr, nullptr});
+  }
+
+  // Add a run in memory.
+  void AddRun(const byte *const *begin, const byte *const *end) {
+    if (begin != end) {
+      runs_.push_back(Run{nullptr, begin, end, nullptr, nullptr});
+    }
+  }
+
+  // Read the first row of each run and play the initial matches. Must be called once all runs are added.
+  void Start() {
+    const auto num_runs = static_cast<uint32_t>(runs_.size());
+    row_buffers_ = std::make_unique<byte[]>(num_runs * tuple_size_);
+    for (uint32_t i = 0; i < num_runs; i++) {
+      runs_[i].buffer_ = &row_buffers_[i * tuple_size_];
+      Advance(&runs_[i]);
+    }
+    tree_.resize(num_runs);
+    if (num_runs > 0) {
+      tree_[0] = Play(1);
+    }
+  }
+
+  bool HasNext() const { return !tree_.empty() && runs_[tree_[0]].row_ != nullptr; }
+
+  // The current smallest row. It stays valid until the next call to Next().
+  const byte *GetRow() const { return runs_[tree_[0]].row_; }
+
+  void Next() {
+    uint32_t winner = tree_[0];
+    Advance(&runs_[winner]);
+    for (std::size_t node = (winner + runs_.size()) / 2; node > 0; node /= 2) {
+      if (Beats(tree_[node], winner)) {
+        std::swap(tree_[node], winner);
+      }
+    }
+    tree_[0] = winner;
+  }
+
+ private:
+  struct Run {
+    // The file of a spilled run.
+    SpillFile *file_;
+    // The remaining rows of an in-memory run.
+    const byte *const *pos_;
+    const byte *const *end_;
+    // Where the current row of a spilled run is read into.
+    byte *buffer_;
+    // The current row, or NULL when the run is exhausted.
+    const byte *row_;
+  };
+
+  void Advance(Run *run) {
+    if (run->file_ != nullptr) {
+      run->row_ = run->file_->Read(run->buffer_, tuple_size_) ? run->buffer_ : nullptr;
+    } else {
+      run->row_ = run->pos_ != run->end_ ? *run->pos_++ : nullptr;
+    }
+  }
+
+  // Does the current row of run 'a' come before that of run 'b'? Exhausted runs lose, and ties go to the earlier run.
+  bool Beats(uint32_t a, uint32_t b) const {
+    if (runs_[a].row_ == nullptr || runs_[b].row_ == nullptr) {
+      return runs_[b].row_ == nullptr && (runs_[a].row_ != nullptr || a < b);
+    }
+    const int32_t cmp = cmp_fn_(runs_[a].row_, runs_[b].row_);
+    return cmp < 0 || (cmp == 0 && a < b);
+  }
+
+  // Play the matches of the subtree rooted at 'node', recording the losers, and return the winning run.
+  uint32_t Play(std::size_t node) {
+    if (node >= runs_.size()) {
+      return static_cast<uint32_t>(node - runs_.size());
+    }
+    uint32_t left = Play(2 * node), right = Play(2 * node + 1);
+    if (Beats(right, left)) {
+      std::swap(left, right);
+    }
+    tree_[node] = right;
+    return left;
+  }
+
+ private:
+  Sorter::ComparisonFunction cmp_fn_;
+  std::size_t tuple_size_;
+  std::vector<Run> runs_;
+  std::unique_ptr<byte[]> row_buffers_;
+  std::vector<uint32_t> tree_;
+};
+
 //===----------------------------------------------------------------------===//
 //
 // Sorter
@@ -28,17 +145,34 @@ Sorter::Sorter(MemoryPool *memory, ComparisonFunction cmp_fn, uint32_t tuple_siz
       owned_tuples_(memory),
       cmp_fn_(cmp_fn),
       tuples_(memory),
-      sorted_(false) {}
+      sorted_(false),
+      spill_tuple_storage_(tuple_size, MemoryPoolAllocator<byte>(memory)),
+      spill_tuples_(memory) {}
 
+// The run writer is declared last, so that its thread is joined before the runs it writes are destroyed
 Sorter::~Sorter() = default;
 
+void Sorter::EnableSpilling(const uint64_t memory_budget) {
+  TERRIER_ASSERT(IsEmpty(), "Spilling must be enabled before inserting tuples");
+  const uint64_t bytes_per_tuple = tuple_storage_.ElementSize() + sizeof(const byte *);
+  spill_threshold_ = std::max(memory_budget / 2 / bytes_per_tuple, uint64_t{1});
+}
+
 byte *Sorter::AllocInputTuple() {
+  if (tuples_.size() >= spill_threshold_) {
+    SpillRun();
+  }
   byte *ret = tuple_storage_.Append();
   tuples_.push_back(ret);
   return ret;
 }
 
-byte *Sorter::AllocInputTupleTopK(UNUSED_ATTRIBUTE uint64_t top_k) { return AllocInputTuple(); }
+byte *Sorter::AllocInputTupleTopK(UNUSED_ATTRIBUTE uint64_t top_k) {
+  // Top-K only keeps K tuples around, so it never spills
+  byte *ret = tuple_storage_.Append();
+  tuples_.push_back(ret);
+  return ret;
+}
 
 void Sorter::AllocInputTupleTopKFinish(const uint64_t top_k) {
   // If the number of buffered tuples is less than top_k, we're done.
@@ -103,12 +237,140 @@ void Sorter::HeapSiftDown() {
   tuples_[idx] = top;
 }
 
+void Sorter::SpillRun() {
+  if (tuples_.empty()) {
+    return;
+  }
+
+  const auto compare = [this](const byte *left, const byte *right) { return cmp_fn_(left, right) < 0; };
+  ips4o::sort(tuples_.begin(), tuples_.end(), compare);
+
+  // The previous run must be out before its memory is reused for this one
+  FinishPendingWrite();
+  std::swap(tuple_storage_, spill_tuple_storage_);
+  tuples_.swap(spill_tuples_);
+  tuple_storage_.clear();
+  tuples_.clear();
+
+  // The file is created here, so that failing to create it is reported right away
+  auto *file = spilled_runs_.emplace_back(std::make_unique<SpillFile>()).get();
+  spilled_run_levels_.push_back(0);
+  num_spilled_tuples_ += spill_tuples_.size();
+
+  // Runs are merged level by level, so that each tuple is only rewritten once per level. Once there are
+  // MAX_MERGE_FAN_IN runs of the newest level, they are merged into one run of the next level, which may in turn
+  // complete that level. The writer does these merges after writing out the new run.
+  for (uint32_t level = 0; spilled_runs_.size() >= MAX_MERGE_FAN_IN; level++) {
+    const auto first = spilled_runs_.end() - MAX_MERGE_FAN_IN;
+    const auto first_level = spilled_run_levels_.end() - MAX_MERGE_FAN_IN;
+    if (std::any_of(first_level, spilled_run_levels_.end(),
+                    [level](const uint32_t run_level) { return run_level != level; })) {
+      break;
+    }
+    std::vector<std::unique_ptr<SpillFile>> runs(std::make_move_iterator(first),
+                                                 std::make_move_iterator(spilled_runs_.end()));
+    spilled_runs_.erase(first, spilled_runs_.end());
+    spilled_run_levels_.erase(first_level, spilled_run_levels_.end());
+    auto *merged_run = spilled_runs_.emplace_back(std::make_unique<SpillFile>()).get();
+    spilled_run_levels_.push_back(level + 1);
+    pending_merges_.emplace_back(std::move(runs), merged_run);
+  }
+
+  if (!run_writer_started_) {
+    run_writer_.Startup();
+    run_writer_started_ = true;
+  }
+  run_writer_.SubmitTask([this, file, tuple_size = spill_tuple_storage_.ElementSize()] {
+    try {
+      for (const byte *tuple : spill_tuples_) {
+        file->Write(tuple, tuple_size);
+      }
+      file->Rewind();
+      for (const auto &[runs, merged_run] : pending_merges_) {
+        MergeRuns(runs, merged_run, tuple_size);
+      }
+      pending_merges_.clear();
+    } catch (...) {
+      write_error_ = std::current_exception();
+    }
+  });
+
+  EXECUTION_LOG_DEBUG("Spilled run of {} tuples, {} tuples spilled in total", spill_tuples_.size(),
+                      num_spilled_tuples_);
+}
+
+void Sorter::FinishPendingWrite() {
+  run_writer_.WaitUntilAllFinished();
+
+  // Rethrow any error raised while writing
+  if (write_error_ != nullptr) {
+    std::rethrow_exception(std::exchange(write_error_, nullptr));
+  }
+}
+
+void Sorter::MergeRuns(const std::vector<std::unique_ptr<SpillFile>> &runs, SpillFile *merged_run,
+                       const std::size_t tuple_size) const {
+  SortedRunMerger merger(cmp_fn_, tuple_size);
+  for (const auto &run : runs) {
+    merger.AddRun(run.get());
+  }
+  merger.Start();
+  for (; merger.HasNext(); merger.Next()) {
+    merged_run->Write(merger.GetRow(), tuple_size);
+  }
+  merged_run->Rewind();
+}
+
+void Sorter::MergeSpilledRuns() {
+  // Runs of different levels, or taken over from thread-local sorters, may exceed the fan-in together. Merge just
+  // enough of the lowest-level, i.e. smallest, runs into one so that they, and the in-memory run, no longer do.
+  const std::size_t tuple_size = tuple_storage_.ElementSize();
+  while (spilled_runs_.size() + 1 > MAX_MERGE_FAN_IN) {
+    const std::size_t num_merged = std::min<std::size_t>(spilled_runs_.size() + 2 - MAX_MERGE_FAN_IN, MAX_MERGE_FAN_IN);
+    std::vector<std::size_t> order(spilled_runs_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [this](std::size_t l, std::size_t r) { return spilled_run_levels_[l] < spilled_run_levels_[r]; });
+
+    std::vector<std::unique_ptr<SpillFile>> runs;
+    uint32_t level = 0;
+    for (std::size_t i = 0; i < num_merged; i++) {
+      runs.push_back(std::move(spilled_runs_[order[i]]));
+      level = std::max(level, spilled_run_levels_[order[i]] + 1);
+    }
+
+    // Compact the remaining runs, keeping their order
+    std::size_t num_kept = 0;
+    for (std::size_t i = 0; i < spilled_runs_.size(); i++) {
+      if (spilled_runs_[i] != nullptr) {
+        spilled_runs_[num_kept] = std::move(spilled_runs_[i]);
+        spilled_run_levels_[num_kept++] = spilled_run_levels_[i];
+      }
+    }
+    spilled_runs_.resize(num_kept);
+    spilled_run_levels_.resize(num_kept);
+
+    MergeRuns(runs, spilled_runs_.emplace_back(std::make_unique<SpillFile>()).get(), tuple_size);
+    spilled_run_levels_.push_back(level);
+  }
+}
+
 void Sorter::Sort() {
   // Exit if the input tuples have already been sorted
   if (IsSorted()) {
     return;
   }
 
+  // If runs were spilled, the buffered tuples become the last run. Runs are merged when iterated.
+  if (IsSpilled()) {
+    const auto compare = [this](const byte *left, const byte *right) { return cmp_fn_(left, right) < 0; };
+    ips4o::sort(tuples_.begin(), tuples_.end(), compare);
+    FinishPendingWrite();
+    MergeSpilledRuns();
+    sorted_ = true;
+    return;
+  }
+
   // Exit if there are no input tuples
   if (tuples_.empty()) {
     return;
@@ -167,6 +429,13 @@ void Sorter::SortParallel(const ThreadStateContainer *thread_state_container, co
       std::accumulate(tl_sorters.begin(), tl_sorters.end(), uint64_t(0),
                       [](const auto partial, const auto *sorter) { return partial + sorter->GetTupleCount(); });
 
+  // If any thread-local sorter spilled, or all their tuples don't fit in this one, do an external sort.
+  if (num_tuples > spill_threshold_ ||
+      std::any_of(tl_sorters.begin(), tl_sorters.end(), [](const Sorter *sorter) { return sorter->IsSpilled(); })) {
+    SortParallelSpilled(tl_sorters);
+    return;
+  }
+
   // If the total number of tuples across **ALL** thread-local sorter instances is less than
   // kMinTuplesForParallelSort, we execute a single-threaded sort. Parallel sorting fewer than this
   // threshold is slower due to the overhead of statistics collection and spawning sort and merge
@@ -361,8 +630,35 @@ void Sorter::SortParallel(const ThreadStateContainer *thread_state_container, co
   }
 }
 
+void Sorter::SortParallelSpilled(const std::vector<Sorter *> &tl_sorters) {
+  EXECUTION_LOG_DEBUG("Issuing parallel external sort of {} sorters", tl_sorters.size());
+
+  // Each thread-local sorter spills what it still buffers as its last run
+  tbb::task_scheduler_init sched;
+  tbb::parallel_for_each(tl_sorters, [](Sorter *sorter) {
+    sorter->SpillRun();
+    sorter->FinishPendingWrite();
+  });
+
+  // Take over all runs
+  for (auto *tl_sorter : tl_sorters) {
+    std::move(tl_sorter->spilled_runs_.begin(), tl_sorter->spilled_runs_.end(), std::back_inserter(spilled_runs_));
+    spilled_run_levels_.insert(spilled_run_levels_.end(), tl_sorter->spilled_run_levels_.begin(),
+                               tl_sorter->spilled_run_levels_.end());
+    num_spilled_tuples_ += tl_sorter->num_spilled_tuples_;
+    tl_sorter->spilled_runs_.clear();
+    tl_sorter->spilled_run_levels_.clear();
+    tl_sorter->num_spilled_tuples_ = 0;
+  }
+
+  Sort();
+}
+
 void Sorter::SortTopKParallel(const ThreadStateContainer *thread_state_container, const uint32_t sorter_offset,
                               const uint64_t top_k) {
+  // The thread-local sorters hold at most K tuples each, so they are merged in memory
+  spill_threshold_ = std::numeric_limits<uint64_t>::max();
+
   // Parallel sort
   SortParallel(thread_state_container, sorter_offset);
 
@@ -378,14 +674,56 @@ void Sorter::SortTopKParallel(const ThreadStateContainer *thread_state_container
 //
 //===----------------------------------------------------------------------===//
 
-SorterIterator::SorterIterator(const Sorter &sorter) : iter_(sorter.tuples_.begin()), end_(sorter.tuples_.end()) {}
+SorterIterator::SorterIterator(const Sorter &sorter)
+    : iter_(sorter.tuples_.data()), end_(sorter.tuples_.data() + sorter.tuples_.size()) {
+  if (!sorter.IsSpilled()) {
+    return;
+  }
+
+  TERRIER_ASSERT(sorter.IsSorted(), "A spilled sorter must be sorted before it is iterated");
+  tuple_size_ = sorter.tuple_storage_.ElementSize();
+  merger_ = std::make_unique<SortedRunMerger>(sorter.cmp_fn_, tuple_size_);
+  for (const auto &run : sorter.spilled_runs_) {
+    merger_->AddRun(run.get());
+  }
+  merger_->AddRun(iter_, end_);
+  merger_->Start();
+  num_unmerged_ = sorter.GetTupleCount();
+
+  constexpr uint32_t batch_size = common::Constants::K_DEFAULT_VECTOR_SIZE;
+  batch_storage_ = std::make_unique<byte[]>(2 * batch_size * tuple_size_);
+  batch_rows_.resize(2 * batch_size);
+  for (uint32_t i = 0; i < batch_rows_.size(); i++) {
+    batch_rows_[i] = &batch_storage_[i * tuple_size_];
+  }
+  MergeBatch();
+}
+
+SorterIterator::~SorterIterator() = default;
+
+void SorterIterator::MergeBatch() {
+  // Fill the batch that wasn't filled last, so that the rows of the last batch stay valid
+  constexpr uint32_t batch_size = common::Constants::K_DEFAULT_VECTOR_SIZE;
+  const uint32_t batch_start = batch_idx_ * batch_size;
+  uint32_t num_rows = 0;
+  for (; num_rows < batch_size && merger_->HasNext(); num_rows++, merger_->Next()) {
+    std::memcpy(&batch_storage_[(batch_start + num_rows) * tuple_size_], merger_->GetRow(), tuple_size_);
+  }
+  batch_idx_ ^= 1u;
+  num_unmerged_ -= num_rows;
+  iter_ = &batch_rows_[batch_start];
+  end_ = iter_ + num_rows;
+}
 
 void SorterIterator::AdvanceBy(uint64_t n) {
-  if (n > NumRemaining()) {
-    iter_ = end_;
-    return;
+  while (n > 0 && HasNext()) {
+    const auto num_skipped = std::min<uint64_t>(n, std::distance(iter_, end_));
+    iter_ += num_skipped;
+    n -= num_skipped;
+    if (iter_ == end_ && num_unmerged_ > 0) {
+      MergeBatch();
+    }
   }
-  iter_ += n;
 }
 
 }  // namespace terrier::execution::sql
@@ -0,0 +1,81 @@
+#include "execution/sql/spill_file.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/error/exception.h"
+#include "spdlog/fmt/fmt.h"
+
+namespace terrier::execution::sql {
+
+SpillFile::SpillFile() : buffer_(std::make_unique<std::byte[]>(BUFFER_SIZE)) {
+  file_.CreateTemp(true);
+  if (!file_.IsOpen()) {
+    throw EXECUTION_EXCEPTION(
+        fmt::format("Failed to create spill file: {}.", util::File::ErrorToString(file_.GetErrorIndicator())));
+  }
+}
+
+SpillFile::~SpillFile() = default;
+
+void SpillFile::Write(const void *data, std::size_t size) {
+  TERRIER_ASSERT(!reading_, "Spill file cannot be written to after it has been rewound");
+  const auto *input = reinterpret_cast<const std::byte *>(data);
+  size_ += size;
+  while (size > 0) {
+    if (buffer_pos_ == BUFFER_SIZE) {
+      FlushBuffer();
+    }
+    const auto num_bytes = std::min<std::size_t>(size, BUFFER_SIZE - buffer_pos_);
+    std::memcpy(buffer_.get() + buffer_pos_, input, num_bytes);
+    buffer_pos_ += num_bytes;
+    input += num_bytes;
+    size -= num_bytes;
+  }
+}
+
+void SpillFile::FlushBuffer() {
+  if (buffer_pos_ > 0 && file_.WriteFull(buffer_.get(), buffer_pos_) != static_cast<int32_t>(buffer_pos_)) {
+    throw EXECUTION_EXCEPTION(fmt::format("Failed to write {} bytes to spill file.", buffer_pos_));
+  }
+  buffer_pos_ = 0;
+}
+
+void SpillFile::Rewind() {
+  if (!reading_) {
+    FlushBuffer();
+    reading_ = true;
+  }
+  if (file_.Seek(util::File::Whence::FROM_BEGIN, 0) != 0) {
+    throw EXECUTION_EXCEPTION("Failed to rewind spill file.");
+  }
+  buffer_pos_ = buffer_end_ = 0;
+}
+
+bool SpillFile::FillBuffer() {
+  const int32_t num_read = file_.ReadFull(buffer_.get(), BUFFER_SIZE);
+  if (num_read < 0) {
+    throw EXECUTION_EXCEPTION("Failed to read from spill file.");
+  }
+  buffer_pos_ = 0;
+  buffer_end_ = static_cast<uint32_t>(num_read);
+  return num_read > 0;
+}
+
+bool SpillFile::Read(void *data, std::size_t size) {
+  TERRIER_ASSERT(reading_, "Spill file must be rewound before it is read");
+  auto *output = reinterpret_cast<std::byte *>(data);
+  for (std::size_t num_copied = 0; num_copied < size;) {
+    if (buffer_pos_ == buffer_end_ && !FillBuffer()) {
+      if (num_copied == 0) return false;
+      throw EXECUTION_EXCEPTION("Spill file ended in the middle of a read.");
+    }
+    const auto num_bytes = std::min<std::size_t>(size - num_copied, buffer_end_ - buffer_pos_);
+    std::memcpy(output + num_copied, buffer_.get() + buffer_pos_, num_bytes);
+    buffer_pos_ += num_bytes;
+    num_copied += num_bytes;
+  }
+  return true;
+}
+
+}  // namespace terrier::execution::sql
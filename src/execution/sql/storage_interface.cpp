@@ -1,9 +1,11 @@
 #include "execution/sql/storage_interface.h"
 
 #include <algorithm>
+#include <cstring>
 #include <vector>
 
 #include "catalog/catalog_accessor.h"
+#include "common/math_util.h"
 #include "execution/exec/execution_context.h"
 #include "execution/util/execution_common.h"
 #include "storage/index/index.h"
@@ -35,6 +37,7 @@ StorageInterface::StorageInterface(exec::ExecutionContext *exec_ctx, catalog::ta
 
 StorageInterface::~StorageInterface() {
   if (need_indexes_) exec_ctx_->GetMemoryPool()->Deallocate(index_pr_buffer_, max_pr_size_);
+  FreeBatch();
 }
 
 storage::ProjectedRow *StorageInterface::GetTablePR() {
@@ -55,6 +58,66 @@ storage::ProjectedRow *StorageInterface::GetIndexPR(catalog::index_oid_t index_o
   return index_pr_;
 }
 
+storage::ProjectedRow *StorageInterface::GetTablePRForBatch() {
+  batch_table_prs_.push_back(AllocateBatchPR(pri_));
+  return batch_table_prs_.back();
+}
+
+storage::ProjectedRow *StorageInterface::GetIndexPRForBatch(catalog::index_oid_t index_oid) {
+  auto index = exec_ctx_->GetAccessor()->GetIndex(index_oid);
+  auto entry = std::find_if(batch_index_prs_.begin(), batch_index_prs_.end(),
+                            [&](const BatchIndexPRs &index_prs) { return index_prs.index_ == index; });
+  if (entry == batch_index_prs_.end()) {
+    const bool unique = exec_ctx_->GetAccessor()->GetIndexSchema(index_oid).Unique();
+    entry = batch_index_prs_.insert(batch_index_prs_.end(), BatchIndexPRs{index, unique, {}});
+  }
+  TERRIER_ASSERT(entry->prs_.size() + 1 == batch_table_prs_.size(), "Keys must follow the tuple they belong to");
+  entry->prs_.push_back(AllocateBatchPR(index->GetProjectedRowInitializer()));
+  return entry->prs_.back();
+}
+
+bool StorageInterface::TableInsertBatch() {
+  auto txn = exec_ctx_->GetTxn();
+  const auto num_tuples = static_cast<uint32_t>(batch_table_prs_.size());
+  std::vector<storage::RedoRecord *> redos(num_tuples);
+  std::vector<storage::TupleSlot> slots(num_tuples);
+  // Only as many records as fit into a redo buffer segment are staged at a time, and they must be inserted before the
+  // next ones are staged
+  for (uint32_t inserted = 0; inserted < num_tuples;) {
+    const uint32_t staged = txn->StageWrites(exec_ctx_->DBOid(), table_oid_, &batch_table_prs_[inserted],
+                                             num_tuples - inserted, &redos[inserted]);
+    table_->InsertBatch(txn, &redos[inserted], staged, &slots[inserted]);
+    inserted += staged;
+  }
+
+  bool result = true;
+  for (const auto &index_prs : batch_index_prs_) {
+    TERRIER_ASSERT(index_prs.prs_.size() == num_tuples, "Every tuple needs a key in every index");
+    if (!index_prs.unique_) {
+      index_prs.index_->InsertBatch(txn, index_prs.prs_.data(), slots.data(), num_tuples);
+    } else if (!index_prs.index_->InsertUniqueBatch(txn, index_prs.prs_.data(), slots.data(), num_tuples)) {
+      result = false;
+      break;
+    }
+  }
+  FreeBatch();
+  return result;
+}
+
+storage::ProjectedRow *StorageInterface::AllocateBatchPR(const storage::ProjectedRowInitializer &initializer) {
+  const uint32_t size = initializer.ProjectedRowSize();
+  void *buffer = exec_ctx_->GetMemoryPool()->AllocateAligned(size, alignof(uint64_t), false);
+  batch_buffers_.emplace_back(buffer, size);
+  return initializer.InitializeRow(buffer);
+}
+
+void StorageInterface::FreeBatch() {
+  for (const auto &buffer : batch_buffers_) exec_ctx_->GetMemoryPool()->Deallocate(buffer.first, buffer.second);
+  batch_buffers_.clear();
+  batch_table_prs_.clear();
+  batch_index_prs_.clear();
+}
+
 storage::TupleSlot StorageInterface::TableInsert() { return table_->Insert(exec_ctx_->GetTxn(), table_redo_); }
 
 bool StorageInterface::TableDelete(storage::TupleSlot table_tuple_slot) {
@@ -91,4 +154,28 @@ bool StorageInterface::IndexInsertWithTuple(storage::TupleSlot table_tuple_slot,
   return curr_index_->Insert(exec_ctx_->GetTxn(), *index_pr_, table_tuple_slot);
 }
 
+void StorageInterface::IndexBulkLoadAdd(storage::TupleSlot table_tuple_slot) {
+  TERRIER_ASSERT(need_indexes_, "Index PR not allocated!");
+  const uint32_t pr_size = curr_index_->GetProjectedRowInitializer().ProjectedRowSize();
+  const uint64_t offset = bulk_load_keys_.size();
+  bulk_load_keys_.resize(offset + common::MathUtil::AlignTo(pr_size, sizeof(uint64_t)) / sizeof(uint64_t));
+  std::memcpy(&bulk_load_keys_[offset], index_pr_, pr_size);
+  bulk_load_slots_.push_back(table_tuple_slot);
+}
+
+bool StorageInterface::IndexBulkLoadFinish() {
+  TERRIER_ASSERT(need_indexes_, "Index PR not allocated!");
+  // The keys only get their final addresses once all of them are set aside
+  const uint64_t pr_words =
+      common::MathUtil::AlignTo(curr_index_->GetProjectedRowInitializer().ProjectedRowSize(), sizeof(uint64_t)) /
+      sizeof(uint64_t);
+  std::vector<const storage::ProjectedRow *> keys(bulk_load_slots_.size());
+  for (uint64_t i = 0; i < keys.size(); i++)
+    keys[i] = reinterpret_cast<const storage::ProjectedRow *>(&bulk_load_keys_[i * pr_words]);
+  const bool result = curr_index_->BulkLoad(exec_ctx_->GetTxn(), keys.data(), bulk_load_slots_.data(), keys.size());
+  bulk_load_keys_ = std::vector<uint64_t>();
+  bulk_load_slots_ = std::vector<storage::TupleSlot>();
+  return result;
+}
+
 }  // namespace terrier::execution::sql
@@ -20,7 +20,7 @@ TableVectorIterator::TableVectorIterator(exec::ExecutionContext *exec_ctx, uint3
                                          uint32_t num_oids)
     : exec_ctx_(exec_ctx), table_oid_(table_oid), col_oids_(col_oids, col_oids + num_oids) {}
 
-TableVectorIterator::~TableVectorIterator() = default;
+TableVectorIterator::~TableVectorIterator() { ReleaseInPlaceBlock(); }
 
 bool TableVectorIterator::Init() { return Init(0, storage::DataTable::GetMaxBlocks()); }
 
@@ -68,18 +68,31 @@ bool TableVectorIterator::Advance() {
     return false;
   }
 
+  // The previous projection is no longer in use, so any block it referenced can be released.
+  ReleaseInPlaceBlock();
+
   // If the iterator is out of data, then we are done.
   if (*iter_ == table_->end() || (**iter_).GetBlock() == nullptr) {
     return false;
   }
 
-  // Otherwise, scan the table to set the vector projection.
-  table_->Scan(exec_ctx_->GetTxn(), iter_.get(), &vector_projection_);
+  // Otherwise, set the vector projection. Frozen blocks are read in place, everything else is scanned transactionally.
+  in_place_block_ = table_->ScanFrozenInPlace(iter_.get(), &vector_projection_);
+  if (in_place_block_ == nullptr) {
+    table_->Scan(exec_ctx_->GetTxn(), iter_.get(), &vector_projection_);
+  }
   vector_projection_iterator_.SetVectorProjection(&vector_projection_);
 
   return true;
 }
 
+void TableVectorIterator::ReleaseInPlaceBlock() {
+  if (in_place_block_ != nullptr) {
+    in_place_block_->controller_.ReleaseInPlaceRead(&vector_projection_);
+    in_place_block_ = nullptr;
+  }
+}
+
 namespace {
 
 class ScanTask {
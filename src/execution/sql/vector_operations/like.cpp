@@ -1,3 +1,5 @@
+#include <type_traits>
+
 #include "common/error/exception.h"
 #include "common/macros.h"
 #include "execution/sql/operators/like_operators.h"
@@ -9,6 +11,16 @@ namespace terrier::execution::sql {
 
 namespace {
 
+// Number of bytes at the start of the pattern that have to match literally, i.e., before any wildcard or escape
+uint32_t LiteralPrefixLength(const storage::VarlenEntry &pattern) {
+  const auto *chars = reinterpret_cast<const char *>(pattern.Content());
+  uint32_t length = 0;
+  while (length < pattern.Size() && chars[length] != '%' && chars[length] != '_' && chars[length] != DEFAULT_ESCAPE) {
+    length++;
+  }
+  return length;
+}
+
 template <typename Op>
 void TemplatedLikeOperationVectorConstant(const Vector &a, const Vector &b, TupleIdList *tid_list) {
   if (b.IsNull(0)) {
@@ -22,8 +34,19 @@ void TemplatedLikeOperationVectorConstant(const Vector &a, const Vector &b, Tupl
   // Remove NULL entries from the left input
   tid_list->GetMutableBits()->Difference(a.GetNullMask());
 
-  // Lift-off
-  tid_list->Filter([&](const uint64_t i) { return Op{}(a_data[i], b_data[0]); });
+  // Strings that do not start with the literal prefix of the pattern cannot match it. Most of them are told apart by
+  // the prefix stored in their entry, without following their content pointer.
+  const storage::VarlenEntry &pattern = b_data[0];
+  const uint32_t literal_length = LiteralPrefixLength(pattern);
+  if (literal_length == 0) {
+    tid_list->Filter([&](const uint64_t i) { return Op{}(a_data[i], pattern); });
+    return;
+  }
+  constexpr bool negated = std::is_same_v<Op, NotLike>;
+  tid_list->Filter([&](const uint64_t i) {
+    if (!a_data[i].StartsWith(pattern.Content(), literal_length)) return negated;
+    return Op{}(a_data[i], pattern);
+  });
 }
 
 template <typename Op>
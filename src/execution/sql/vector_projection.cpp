@@ -1,5 +1,6 @@
 #include "execution/sql/vector_projection.h"
 
+#include <cstring>
 #include <memory>
 #include <numeric>
 #include <string>
@@ -98,6 +99,40 @@ void VectorProjection::Reset(uint64_t num_tuples) {
   owned_tid_list_.Resize(num_tuples);
   owned_tid_list_.AddAll();
 
+  ResetColumns(num_tuples);
+}
+
+void VectorProjection::PrepareForScan() {
+  const uint64_t capacity = GetTupleCapacity();
+  filter_ = nullptr;
+  owned_tid_list_.Resize(capacity);
+  owned_tid_list_.Clear();
+  // Child vectors may still reference a block from an earlier in-place scan, so point them back at our own buffer
+  ResetColumns(capacity);
+}
+
+void VectorProjection::FinishScan(uint64_t num_tuples) {
+  // The scan marked every visible row in the owned TID list, so we keep it as is and only drop the unfilled tail.
+  owned_tid_list_.Resize(num_tuples);
+  ResetColumns(num_tuples);
+  RefreshFilteredTupleIdList();
+}
+
+void VectorProjection::Materialize() {
+  if (owned_buffer_ == nullptr) return;
+
+  byte *ptr = owned_buffer_.get();
+  for (const auto &col : columns_) {
+    const std::size_t type_size = GetTypeIdSize(col->GetTypeId());
+    if (col->data_ != ptr) {
+      std::memcpy(ptr, col->data_, type_size * col->num_elements_);
+      col->data_ = ptr;
+    }
+    ptr += type_size * common::Constants::K_DEFAULT_VECTOR_SIZE;
+  }
+}
+
+void VectorProjection::ResetColumns(uint64_t num_tuples) {
   // If the projection is an owning projection, we need to reset each child
   // vector to point to its designated chunk of the internal buffer. If the
   // projection is a referencing projection, just notify each child vector of
@@ -308,6 +308,11 @@ void BytecodeEmitter::EmitFilterManagerInsertFilter(LocalVar filter_manager, Fun
   EmitAll(Bytecode::FilterManagerInsertFilter, filter_manager, func);
 }
 
+void BytecodeEmitter::EmitJoinHashTableFilterProbe(LocalVar join_hash_table, LocalVar input_batch, LocalVar tid_list,
+                                                   uint32_t num_keys, LocalVar key_cols) {
+  EmitAll(Bytecode::JoinHashTableFilterProbe, join_hash_table, input_batch, tid_list, num_keys, key_cols);
+}
+
 void BytecodeEmitter::EmitAggHashTableLookup(LocalVar dest, LocalVar agg_ht, LocalVar hash, FunctionId key_eq_fn,
                                              LocalVar arg) {
   TERRIER_ASSERT(Bytecodes::NumOperands(Bytecode::AggregationHashTableLookup) == 5,
@@ -895,7 +895,17 @@ void BytecodeGenerator::VisitBuiltinFilterManagerCall(ast::CallExpr *call, ast::
   switch (builtin) {
     case ast::Builtin::FilterManagerInit: {
       LocalVar exec_ctx = VisitExpressionForRValue(call->Arguments()[1]);
-      GetEmitter()->Emit(Bytecode::FilterManagerInit, filter_manager, exec_ctx);
+      LocalVar opaque_ctx;
+      if (call->NumArgs() == 3) {
+        opaque_ctx = VisitExpressionForRValue(call->Arguments()[2]);
+      } else {
+        // Without a context, the filters receive a null pointer.
+        ast::Context *ctx = call->GetType()->GetContext();
+        opaque_ctx = GetCurrentFunction()->NewLocal(ast::BuiltinType::Get(ctx, ast::BuiltinType::Uint8)->PointerTo());
+        GetEmitter()->EmitAssignImm8(opaque_ctx, 0);
+        opaque_ctx = opaque_ctx.ValueOf();
+      }
+      GetEmitter()->Emit(Bytecode::FilterManagerInit, filter_manager, exec_ctx, opaque_ctx);
       break;
     }
     case ast::Builtin::FilterManagerInsertFilter: {
@@ -990,6 +1000,11 @@ void BytecodeGenerator::VisitBuiltinAggHashTableCall(ast::CallExpr *call, ast::B
       GetEmitter()->Emit(Bytecode::AggregationHashTableInit, agg_ht, exec_ctx, memory, entry_size);
       break;
     }
+    case ast::Builtin::AggHashTableEnableSpilling: {
+      LocalVar agg_ht = VisitExpressionForRValue(call->Arguments()[0]);
+      GetEmitter()->Emit(Bytecode::AggregationHashTableEnableSpilling, agg_ht);
+      break;
+    }
     case ast::Builtin::AggHashTableInsert: {
       LocalVar dest = GetExecutionResult()->GetOrCreateDestination(call->GetType());
       LocalVar agg_ht = VisitExpressionForRValue(call->Arguments()[0]);
@@ -1351,6 +1366,49 @@ void BytecodeGenerator::VisitBuiltinJoinHashTableCall(ast::CallExpr *call, ast::
       GetEmitter()->Emit(Bytecode::JoinHashTableBuildParallel, join_hash_table, tls, jht_offset);
       break;
     }
+    case ast::Builtin::JoinHashTableBuildBloomFilter: {
+      GetEmitter()->Emit(Bytecode::JoinHashTableBuildBloomFilter, join_hash_table);
+      break;
+    }
+    case ast::Builtin::JoinHashTableFilterProbe: {
+      LocalVar input_batch = VisitExpressionForRValue(call->Arguments()[1]);
+      LocalVar tid_list = VisitExpressionForRValue(call->Arguments()[2]);
+      uint32_t num_keys = call->Arguments()[3]->GetType()->As<ast::ArrayType>()->GetLength();
+      LocalVar key_cols = VisitExpressionForLValue(call->Arguments()[3]);
+      GetEmitter()->EmitJoinHashTableFilterProbe(join_hash_table, input_batch, tid_list, num_keys, key_cols);
+      break;
+    }
+    case ast::Builtin::JoinHashTableEnableSpilling: {
+      LocalVar probe_tuple_size = VisitExpressionForRValue(call->Arguments()[1]);
+      GetEmitter()->Emit(Bytecode::JoinHashTableEnableSpilling, join_hash_table, probe_tuple_size);
+      break;
+    }
+    case ast::Builtin::JoinHashTableIsResident: {
+      LocalVar dest = GetExecutionResult()->GetOrCreateDestination(call->GetType());
+      LocalVar hash = VisitExpressionForRValue(call->Arguments()[1]);
+      GetEmitter()->Emit(Bytecode::JoinHashTableIsResident, dest, join_hash_table, hash);
+      GetExecutionResult()->SetDestination(dest.ValueOf());
+      break;
+    }
+    case ast::Builtin::JoinHashTableSpillProbeTuple: {
+      LocalVar hash = VisitExpressionForRValue(call->Arguments()[1]);
+      LocalVar probe_tuple = VisitExpressionForRValue(call->Arguments()[2]);
+      GetEmitter()->Emit(Bytecode::JoinHashTableSpillProbeTuple, join_hash_table, hash, probe_tuple);
+      break;
+    }
+    case ast::Builtin::JoinHashTableNextPartition: {
+      LocalVar dest = GetExecutionResult()->GetOrCreateDestination(call->GetType());
+      GetEmitter()->Emit(Bytecode::JoinHashTableNextPartition, dest, join_hash_table);
+      GetExecutionResult()->SetDestination(dest.ValueOf());
+      break;
+    }
+    case ast::Builtin::JoinHashTableReadProbeTuple: {
+      LocalVar dest = GetExecutionResult()->GetOrCreateDestination(call->GetType());
+      LocalVar probe_tuple = VisitExpressionForRValue(call->Arguments()[1]);
+      GetEmitter()->Emit(Bytecode::JoinHashTableReadProbeTuple, dest, join_hash_table, probe_tuple);
+      GetExecutionResult()->SetDestination(dest.ValueOf());
+      break;
+    }
     case ast::Builtin::JoinHashTableLookup: {
       LocalVar ht_entry_iter = VisitExpressionForRValue(call->Arguments()[1]);
       LocalVar hash = VisitExpressionForRValue(call->Arguments()[2]);
@@ -1401,6 +1459,12 @@ void BytecodeGenerator::VisitBuiltinSorterCall(ast::CallExpr *call, ast::Builtin
       GetEmitter()->EmitSorterInit(Bytecode::SorterInit, sorter, memory, LookupFuncIdByName(cmp_func_name), entry_size);
       break;
     }
+    case ast::Builtin::SorterEnableSpilling: {
+      LocalVar sorter = VisitExpressionForRValue(call->Arguments()[0]);
+      LocalVar exec_ctx = VisitExpressionForRValue(call->Arguments()[1]);
+      GetEmitter()->Emit(Bytecode::SorterEnableSpilling, sorter, exec_ctx);
+      break;
+    }
     case ast::Builtin::SorterInsert: {
       LocalVar dest = GetExecutionResult()->GetOrCreateDestination(call->GetType());
       LocalVar sorter = VisitExpressionForRValue(call->Arguments()[0]);
@@ -2143,6 +2207,35 @@ void BytecodeGenerator::VisitBuiltinStorageInterfaceCall(ast::CallExpr *call, as
       GetEmitter()->Emit(Bytecode::StorageInterfaceIndexDelete, storage_interface, tuple_slot);
       break;
     }
+    case ast::Builtin::GetTablePRForBatch: {
+      LocalVar pr = GetExecutionResult()->GetOrCreateDestination(call->GetType());
+      GetEmitter()->Emit(Bytecode::StorageInterfaceGetTablePRForBatch, pr, storage_interface);
+      break;
+    }
+    case ast::Builtin::GetIndexPRForBatch: {
+      LocalVar pr = GetExecutionResult()->GetOrCreateDestination(call->GetType());
+      auto index_oid = VisitExpressionForRValue(call->Arguments()[1]);
+      GetEmitter()->EmitStorageInterfaceGetIndexPR(Bytecode::StorageInterfaceGetIndexPRForBatch, pr, storage_interface,
+                                                   index_oid);
+      break;
+    }
+    case ast::Builtin::TableInsertBatch: {
+      LocalVar cond = GetExecutionResult()->GetOrCreateDestination(ast::BuiltinType::Get(ctx, ast::BuiltinType::Bool));
+      GetEmitter()->Emit(Bytecode::StorageInterfaceTableInsertBatch, cond, storage_interface);
+      GetExecutionResult()->SetDestination(cond.ValueOf());
+      break;
+    }
+    case ast::Builtin::IndexBulkLoadAdd: {
+      LocalVar tuple_slot = VisitExpressionForRValue(call->Arguments()[1]);
+      GetEmitter()->Emit(Bytecode::StorageInterfaceIndexBulkLoadAdd, storage_interface, tuple_slot);
+      break;
+    }
+    case ast::Builtin::IndexBulkLoadFinish: {
+      LocalVar cond = GetExecutionResult()->GetOrCreateDestination(ast::BuiltinType::Get(ctx, ast::BuiltinType::Bool));
+      GetEmitter()->Emit(Bytecode::StorageInterfaceIndexBulkLoadFinish, cond, storage_interface);
+      GetExecutionResult()->SetDestination(cond.ValueOf());
+      break;
+    }
 
     case ast::Builtin::StorageInterfaceFree: {
       GetEmitter()->Emit(Bytecode::StorageInterfaceFree, storage_interface);
@@ -2492,6 +2585,7 @@ void BytecodeGenerator::VisitBuiltinCallExpr(ast::CallExpr *call) {
       break;
     }
     case ast::Builtin::AggHashTableInit:
+    case ast::Builtin::AggHashTableEnableSpilling:
     case ast::Builtin::AggHashTableInsert:
     case ast::Builtin::AggHashTableLinkEntry:
     case ast::Builtin::AggHashTableLookup:
@@ -2530,6 +2624,13 @@ void BytecodeGenerator::VisitBuiltinCallExpr(ast::CallExpr *call) {
     case ast::Builtin::JoinHashTableInsert:
     case ast::Builtin::JoinHashTableBuild:
     case ast::Builtin::JoinHashTableBuildParallel:
+    case ast::Builtin::JoinHashTableBuildBloomFilter:
+    case ast::Builtin::JoinHashTableFilterProbe:
+    case ast::Builtin::JoinHashTableEnableSpilling:
+    case ast::Builtin::JoinHashTableIsResident:
+    case ast::Builtin::JoinHashTableSpillProbeTuple:
+    case ast::Builtin::JoinHashTableNextPartition:
+    case ast::Builtin::JoinHashTableReadProbeTuple:
     case ast::Builtin::JoinHashTableLookup:
     case ast::Builtin::JoinHashTableFree: {
       VisitBuiltinJoinHashTableCall(call, builtin);
@@ -2541,6 +2642,7 @@ void BytecodeGenerator::VisitBuiltinCallExpr(ast::CallExpr *call) {
       break;
     }
     case ast::Builtin::SorterInit:
+    case ast::Builtin::SorterEnableSpilling:
     case ast::Builtin::SorterInsert:
     case ast::Builtin::SorterInsertTopK:
     case ast::Builtin::SorterInsertTopKFinish:
@@ -2672,6 +2774,11 @@ void BytecodeGenerator::VisitBuiltinCallExpr(ast::CallExpr *call) {
     case ast::Builtin::IndexInsertUnique:
     case ast::Builtin::IndexInsertWithSlot:
     case ast::Builtin::IndexDelete:
+    case ast::Builtin::GetTablePRForBatch:
+    case ast::Builtin::GetIndexPRForBatch:
+    case ast::Builtin::TableInsertBatch:
+    case ast::Builtin::IndexBulkLoadAdd:
+    case ast::Builtin::IndexBulkLoadFinish:
     case ast::Builtin::StorageInterfaceFree: {
       VisitBuiltinStorageInterfaceCall(call, builtin);
       break;
@@ -2,6 +2,7 @@
 
 #include "catalog/catalog_defs.h"
 #include "execution/exec/execution_context.h"
+#include "execution/exec/execution_settings.h"
 #include "execution/sql/index_iterator.h"
 #include "execution/sql/storage_interface.h"
 #include "execution/sql/vector_projection_iterator.h"
@@ -45,8 +46,8 @@ void OpVPIFree(terrier::execution::sql::VectorProjectionIterator *vpi) { vpi->~V
 // ---------------------------------------------------------
 
 void OpFilterManagerInit(terrier::execution::sql::FilterManager *filter_manager,
-                         const terrier::execution::exec::ExecutionSettings &exec_settings) {
-  new (filter_manager) terrier::execution::sql::FilterManager(exec_settings);
+                         const terrier::execution::exec::ExecutionSettings &exec_settings, void *opaque_context) {
+  new (filter_manager) terrier::execution::sql::FilterManager(exec_settings, true, opaque_context);
 }
 
 void OpFilterManagerStartNewClause(terrier::execution::sql::FilterManager *filter_manager) {
@@ -84,6 +85,26 @@ void OpJoinHashTableBuildParallel(terrier::execution::sql::JoinHashTable *join_h
   join_hash_table->MergeParallel(thread_state_container, jht_offset);
 }
 
+void OpJoinHashTableBuildBloomFilter(terrier::execution::sql::JoinHashTable *join_hash_table) {
+  join_hash_table->BuildBloomFilter();
+}
+
+void OpJoinHashTableFilterProbe(const terrier::execution::sql::JoinHashTable *join_hash_table,
+                                terrier::execution::sql::VectorProjection *input_batch,
+                                terrier::execution::sql::TupleIdList *tid_list, uint32_t num_keys,
+                                const uint32_t *key_cols) {
+  join_hash_table->FilterProbeBatch(input_batch, std::vector<uint32_t>(key_cols, key_cols + num_keys), tid_list);
+}
+
+void OpJoinHashTableEnableSpilling(terrier::execution::sql::JoinHashTable *join_hash_table,
+                                   const uint32_t probe_tuple_size) {
+  join_hash_table->EnableSpilling(join_hash_table->GetExecutionSettings().GetOperatorMemoryBudget(), probe_tuple_size);
+}
+
+void OpJoinHashTableNextPartition(bool *result, terrier::execution::sql::JoinHashTable *join_hash_table) {
+  *result = join_hash_table->NextPartition();
+}
+
 void OpJoinHashTableFree(terrier::execution::sql::JoinHashTable *join_hash_table) { join_hash_table->~JoinHashTable(); }
 
 // ---------------------------------------------------------
@@ -97,6 +118,10 @@ void OpAggregationHashTableInit(terrier::execution::sql::AggregationHashTable *c
       terrier::execution::sql::AggregationHashTable(exec_ctx->GetExecutionSettings(), memory, payload_size);
 }
 
+void OpAggregationHashTableEnableSpilling(terrier::execution::sql::AggregationHashTable *const agg_hash_table) {
+  agg_hash_table->EnableSpilling(agg_hash_table->GetExecutionSettings().GetOperatorMemoryBudget());
+}
+
 void OpAggregationHashTableFree(terrier::execution::sql::AggregationHashTable *const agg_hash_table) {
   agg_hash_table->~AggregationHashTable();
 }
@@ -134,6 +159,11 @@ void OpSorterInit(terrier::execution::sql::Sorter *const sorter, terrier::execut
   new (sorter) terrier::execution::sql::Sorter(memory, cmp_fn, tuple_size);
 }
 
+void OpSorterEnableSpilling(terrier::execution::sql::Sorter *const sorter,
+                            terrier::execution::exec::ExecutionContext *const exec_ctx) {
+  sorter->EnableSpilling(exec_ctx->GetExecutionSettings().GetOperatorMemoryBudget());
+}
+
 void OpSorterSort(terrier::execution::sql::Sorter *sorter) { sorter->Sort(); }
 
 void OpSorterSortParallel(terrier::execution::sql::Sorter *sorter,
@@ -223,6 +253,30 @@ void OpStorageInterfaceIndexDelete(terrier::execution::sql::StorageInterface *st
   storage_interface->IndexDelete(*tuple_slot);
 }
 
+void OpStorageInterfaceGetTablePRForBatch(terrier::storage::ProjectedRow **pr_result,
+                                          terrier::execution::sql::StorageInterface *storage_interface) {
+  *pr_result = storage_interface->GetTablePRForBatch();
+}
+
+void OpStorageInterfaceGetIndexPRForBatch(terrier::storage::ProjectedRow **pr_result,
+                                          terrier::execution::sql::StorageInterface *storage_interface,
+                                          uint32_t index_oid) {
+  *pr_result = storage_interface->GetIndexPRForBatch(terrier::catalog::index_oid_t(index_oid));
+}
+
+void OpStorageInterfaceTableInsertBatch(bool *result, terrier::execution::sql::StorageInterface *storage_interface) {
+  *result = storage_interface->TableInsertBatch();
+}
+
+void OpStorageInterfaceIndexBulkLoadAdd(terrier::execution::sql::StorageInterface *storage_interface,
+                                        terrier::storage::TupleSlot *tuple_slot) {
+  storage_interface->IndexBulkLoadAdd(*tuple_slot);
+}
+
+void OpStorageInterfaceIndexBulkLoadFinish(bool *result, terrier::execution::sql::StorageInterface *storage_interface) {
+  *result = storage_interface->IndexBulkLoadFinish();
+}
+
 void OpStorageInterfaceFree(terrier::execution::sql::StorageInterface *storage_interface) {
   storage_interface->~StorageInterface();
 }
@@ -792,7 +792,8 @@ void VM::Interpret(const uint8_t *ip, Frame *frame) {  // NOLINT
   OP(FilterManagerInit) : {
     auto *filter_manager = frame->LocalAt<sql::FilterManager *>(READ_LOCAL_ID());
     auto *exec_context = frame->LocalAt<exec::ExecutionContext *>(READ_LOCAL_ID());
-    OpFilterManagerInit(filter_manager, exec_context->GetExecutionSettings());
+    auto *opaque_context = frame->LocalAt<void *>(READ_LOCAL_ID());
+    OpFilterManagerInit(filter_manager, exec_context->GetExecutionSettings(), opaque_context);
     DISPATCH_NEXT();
   }
 
@@ -1115,6 +1116,12 @@ void VM::Interpret(const uint8_t *ip, Frame *frame) {  // NOLINT
     DISPATCH_NEXT();
   }
 
+  OP(AggregationHashTableEnableSpilling) : {
+    auto *agg_hash_table = frame->LocalAt<sql::AggregationHashTable *>(READ_LOCAL_ID());
+    OpAggregationHashTableEnableSpilling(agg_hash_table);
+    DISPATCH_NEXT();
+  }
+
   OP(AggregationHashTableAllocTuple) : {
     auto *result = frame->LocalAt<byte **>(READ_LOCAL_ID());
     auto *agg_hash_table = frame->LocalAt<sql::AggregationHashTable *>(READ_LOCAL_ID());
@@ -1467,6 +1474,60 @@ void VM::Interpret(const uint8_t *ip, Frame *frame) {  // NOLINT
     DISPATCH_NEXT();
   }
 
+  OP(JoinHashTableBuildBloomFilter) : {
+    auto *join_hash_table = frame->LocalAt<sql::JoinHashTable *>(READ_LOCAL_ID());
+    OpJoinHashTableBuildBloomFilter(join_hash_table);
+    DISPATCH_NEXT();
+  }
+
+  OP(JoinHashTableFilterProbe) : {
+    auto *join_hash_table = frame->LocalAt<sql::JoinHashTable *>(READ_LOCAL_ID());
+    auto *input_batch = frame->LocalAt<sql::VectorProjection *>(READ_LOCAL_ID());
+    auto *tid_list = frame->LocalAt<sql::TupleIdList *>(READ_LOCAL_ID());
+    auto num_keys = READ_UIMM4();
+    auto key_cols = frame->LocalAt<uint32_t *>(READ_LOCAL_ID());
+    OpJoinHashTableFilterProbe(join_hash_table, input_batch, tid_list, num_keys, key_cols);
+    DISPATCH_NEXT();
+  }
+
+  OP(JoinHashTableEnableSpilling) : {
+    auto *join_hash_table = frame->LocalAt<sql::JoinHashTable *>(READ_LOCAL_ID());
+    auto probe_tuple_size = frame->LocalAt<uint32_t>(READ_LOCAL_ID());
+    OpJoinHashTableEnableSpilling(join_hash_table, probe_tuple_size);
+    DISPATCH_NEXT();
+  }
+
+  OP(JoinHashTableIsResident) : {
+    auto *result = frame->LocalAt<bool *>(READ_LOCAL_ID());
+    auto *join_hash_table = frame->LocalAt<sql::JoinHashTable *>(READ_LOCAL_ID());
+    auto hash_val = frame->LocalAt<hash_t>(READ_LOCAL_ID());
+    OpJoinHashTableIsResident(result, join_hash_table, hash_val);
+    DISPATCH_NEXT();
+  }
+
+  OP(JoinHashTableSpillProbeTuple) : {
+    auto *join_hash_table = frame->LocalAt<sql::JoinHashTable *>(READ_LOCAL_ID());
+    auto hash_val = frame->LocalAt<hash_t>(READ_LOCAL_ID());
+    auto *probe_tuple = frame->LocalAt<const byte *>(READ_LOCAL_ID());
+    OpJoinHashTableSpillProbeTuple(join_hash_table, hash_val, probe_tuple);
+    DISPATCH_NEXT();
+  }
+
+  OP(JoinHashTableNextPartition) : {
+    auto *result = frame->LocalAt<bool *>(READ_LOCAL_ID());
+    auto *join_hash_table = frame->LocalAt<sql::JoinHashTable *>(READ_LOCAL_ID());
+    OpJoinHashTableNextPartition(result, join_hash_table);
+    DISPATCH_NEXT();
+  }
+
+  OP(JoinHashTableReadProbeTuple) : {
+    auto *result = frame->LocalAt<bool *>(READ_LOCAL_ID());
+    auto *join_hash_table = frame->LocalAt<sql::JoinHashTable *>(READ_LOCAL_ID());
+    auto *probe_tuple = frame->LocalAt<byte *>(READ_LOCAL_ID());
+    OpJoinHashTableReadProbeTuple(result, join_hash_table, probe_tuple);
+    DISPATCH_NEXT();
+  }
+
   OP(JoinHashTableLookup) : {
     auto *join_hash_table = frame->LocalAt<sql::JoinHashTable *>(READ_LOCAL_ID());
     auto *ht_entry_iter = frame->LocalAt<sql::HashTableEntryIterator *>(READ_LOCAL_ID());
@@ -1510,6 +1571,13 @@ void VM::Interpret(const uint8_t *ip, Frame *frame) {  // NOLINT
     DISPATCH_NEXT();
   }
 
+  OP(SorterEnableSpilling) : {
+    auto *sorter = frame->LocalAt<sql::Sorter *>(READ_LOCAL_ID());
+    auto *exec_ctx = frame->LocalAt<exec::ExecutionContext *>(READ_LOCAL_ID());
+    OpSorterEnableSpilling(sorter, exec_ctx);
+    DISPATCH_NEXT();
+  }
+
   OP(SorterAllocTuple) : {
     auto *result = frame->LocalAt<byte **>(READ_LOCAL_ID());
     auto *sorter = frame->LocalAt<sql::Sorter *>(READ_LOCAL_ID());
@@ -1931,6 +1999,44 @@ void VM::Interpret(const uint8_t *ip, Frame *frame) {  // NOLINT
     DISPATCH_NEXT();
   }
 
+  OP(StorageInterfaceGetTablePRForBatch) : {
+    auto *pr_result = frame->LocalAt<storage::ProjectedRow **>(READ_LOCAL_ID());
+    auto *storage_interface = frame->LocalAt<sql::StorageInterface *>(READ_LOCAL_ID());
+
+    OpStorageInterfaceGetTablePRForBatch(pr_result, storage_interface);
+    DISPATCH_NEXT();
+  }
+
+  OP(StorageInterfaceGetIndexPRForBatch) : {
+    auto *pr_result = frame->LocalAt<storage::ProjectedRow **>(READ_LOCAL_ID());
+    auto *storage_interface = frame->LocalAt<sql::StorageInterface *>(READ_LOCAL_ID());
+    auto index_oid = frame->LocalAt<uint32_t>(READ_LOCAL_ID());
+
+    OpStorageInterfaceGetIndexPRForBatch(pr_result, storage_interface, index_oid);
+    DISPATCH_NEXT();
+  }
+
+  OP(StorageInterfaceTableInsertBatch) : {
+    auto *result = frame->LocalAt<bool *>(READ_LOCAL_ID());
+    auto *storage_interface = frame->LocalAt<sql::StorageInterface *>(READ_LOCAL_ID());
+    OpStorageInterfaceTableInsertBatch(result, storage_interface);
+    DISPATCH_NEXT();
+  }
+
+  OP(StorageInterfaceIndexBulkLoadAdd) : {
+    auto *storage_interface = frame->LocalAt<sql::StorageInterface *>(READ_LOCAL_ID());
+    auto *tuple_slot = frame->LocalAt<storage::TupleSlot *>(READ_LOCAL_ID());
+    OpStorageInterfaceIndexBulkLoadAdd(storage_interface, tuple_slot);
+    DISPATCH_NEXT();
+  }
+
+  OP(StorageInterfaceIndexBulkLoadFinish) : {
+    auto *result = frame->LocalAt<bool *>(READ_LOCAL_ID());
+    auto *storage_interface = frame->LocalAt<sql::StorageInterface *>(READ_LOCAL_ID());
+    OpStorageInterfaceIndexBulkLoadFinish(result, storage_interface);
+    DISPATCH_NEXT();
+  }
+
   OP(StorageInterfaceFree) : {
     auto *storage_interface = frame->LocalAt<sql::StorageInterface *>(READ_LOCAL_ID());
     OpStorageInterfaceFree(storage_interface);
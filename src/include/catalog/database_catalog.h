@@ -25,6 +25,7 @@ class TransactionContext;
 }
 
 namespace terrier::storage {
+class CheckpointManager;
 class GarbageCollector;
 class RecoveryManager;
 class SqlTable;
@@ -543,6 +544,7 @@ class DatabaseCatalog {
   friend class Catalog;
   friend class postgres::Builder;
   friend class storage::RecoveryManager;
+  friend class storage::CheckpointManager;
 
   /**
    * Internal function to DatabaseCatalog to disallow concurrent DDL changes. This also disallows older txns to enact
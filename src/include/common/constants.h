@@ -27,6 +27,16 @@ struct Constants {
    */
   static const uint32_t LOG_BUFFER_SIZE = (1 << 12);
 
+  /**
+   * The alignment of memory, file offsets and sizes of log writes when the log file is opened for direct I/O
+   */
+  static const uint32_t LOG_DIRECT_IO_ALIGNMENT = (1 << 12);
+
+  /**
+   * The amount of disk space the log manager reserves ahead of the end of the log file when writing with direct I/O
+   */
+  static const uint32_t LOG_PREALLOCATION_SIZE = (1 << 26);
+
   /**
    * The cache line size in bytes
    */
@@ -103,5 +113,17 @@ struct Constants {
    * Flag indicating if parallel execution is supported.
    */
   static constexpr const bool IS_PARALLEL_EXECUTION_ENABLED = true;
+
+  /**
+   * The number of bytes an operator may buffer before it spills to disk, for operators that can, unless the
+   * execution_operator_memory_budget setting says otherwise. Zero means that operators never spill.
+   */
+  static constexpr const uint64_t OPERATOR_MEMORY_BUDGET = 0;
+
+  /**
+   * Flag indicating if hash joins push the bloom filters of their hash tables down into probe-side scans, unless the
+   * execution_bloom_filter_pushdown setting says otherwise.
+   */
+  static constexpr const bool IS_BLOOM_FILTER_PUSHDOWN_ENABLED = true;
 };
 }  // namespace terrier::common
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>  // NOLINT
+
+#include "common/macros.h"
+
+namespace terrier::common {
+
+/**
+ * An append-only vector that supports concurrent appends and latch-free reads.
+ *
+ * Elements live in a fixed number of segments that double in size, so an element never moves once written and a
+ * reader never needs to synchronize with a concurrent reallocation. An append reserves an index, writes the element,
+ * and then publishes it by advancing the size. Publication is strictly in index order, so every index below Size() is
+ * guaranteed to hold a fully written element.
+ *
+ * Appends are expected to be rare relative to reads (e.g. one per storage block), so an append waiting on a
+ * concurrent append of a smaller index to publish first is an acceptable cost.
+ *
+ * @tparam T type of element in the vector. Elements are copied in and out, so this should be a small trivially
+ *           copyable type such as a pointer.
+ */
+template <typename T>
+class ConcurrentAppendOnlyVector {
+ public:
+  /**
+   * Constructs an empty vector. No memory is allocated until the first append.
+   */
+  ConcurrentAppendOnlyVector() {
+    for (auto &segment : segments_) segment.store(nullptr, std::memory_order_relaxed);
+  }
+
+  /**
+   * Destructs the vector, freeing all segments. Elements are not destructed.
+   */
+  ~ConcurrentAppendOnlyVector() {
+    for (auto &segment : segments_) delete[] segment.load(std::memory_order_relaxed);
+  }
+
+  DISALLOW_COPY_AND_MOVE(ConcurrentAppendOnlyVector)
+
+  /**
+   * Appends an element to the end of the vector. Safe to call concurrently with other appends and with reads.
+   * @param item element to be added
+   * @return the index at which the element was added
+   */
+  uint32_t PushBack(const T &item) {
+    const uint32_t index = reserved_.fetch_add(1, std::memory_order_relaxed);
+    TERRIER_ASSERT(index < MaxSize(), "ConcurrentAppendOnlyVector is full.");
+    const uint32_t segment = SegmentOf(index);
+    GetOrAllocateSegment(segment)[index - SegmentStart(segment)] = item;
+    // Wait for every smaller index to be published before publishing ours, so that everything below Size() is valid.
+    uint32_t expected = index;
+    while (!size_.compare_exchange_weak(expected, index + 1, std::memory_order_release, std::memory_order_relaxed)) {
+      expected = index;
+      std::this_thread::yield();
+    }
+    return index;
+  }
+
+  /**
+   * @return number of elements published. Every index below this is safe to read.
+   */
+  uint32_t Size() const { return size_.load(std::memory_order_acquire); }
+
+  /**
+   * @return true if no element has been published yet
+   */
+  bool Empty() const { return Size() == 0; }
+
+  /**
+   * Returns the element at the given index. The index must be below a value of Size() observed by the caller.
+   * @param index position of an element in the vector.
+   * @return the element at the specified position.
+   */
+  const T &operator[](uint32_t index) const {
+    TERRIER_ASSERT(index < Size(), "Index out of bounds.");
+    const uint32_t segment = SegmentOf(index);
+    return segments_[segment].load(std::memory_order_relaxed)[index - SegmentStart(segment)];
+  }
+
+  /**
+   * @return the maximum number of elements this vector can hold
+   */
+  static constexpr uint32_t MaxSize() { return SegmentStart(NUM_SEGMENTS); }
+
+ private:
+  // The first segment holds 2^FIRST_SEGMENT_BITS elements and every following segment is twice as big as the last.
+  static constexpr uint32_t FIRST_SEGMENT_BITS = 6;
+  static constexpr uint32_t NUM_SEGMENTS = 32 - FIRST_SEGMENT_BITS;
+
+  // Index of the first element in the given segment
+  static constexpr uint32_t SegmentStart(uint32_t segment) {
+    return static_cast<uint32_t>(((uint64_t{1} << segment) - 1) << FIRST_SEGMENT_BITS);
+  }
+
+  static uint32_t SegmentOf(uint32_t index) {
+    // Segment k covers [(2^k - 1) * 2^b, (2^(k+1) - 1) * 2^b), so k = floor(log2(index / 2^b + 1))
+    const uint32_t biased = (index >> FIRST_SEGMENT_BITS) + 1;
+    return 31 - static_cast<uint32_t>(__builtin_clz(biased));
+  }
+
+  T *GetOrAllocateSegment(uint32_t segment) {
+    T *result = segments_[segment].load(std::memory_order_acquire);
+    if (result != nullptr) return result;
+    auto *allocated = new T[SegmentStart(segment + 1) - SegmentStart(segment)];
+    // Someone else might have beaten us to it, in which case we use theirs.
+    if (segments_[segment].compare_exchange_strong(result, allocated, std::memory_order_acq_rel)) return allocated;
+    delete[] allocated;
+    return result;
+  }
+
+  std::array<std::atomic<T *>, NUM_SEGMENTS> segments_;
+  std::atomic<uint32_t> reserved_{0};
+  std::atomic<uint32_t> size_{0};
+};
+}  // namespace terrier::common
@@ -1,12 +1,23 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <queue>
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 #include "common/allocator.h"
+#include "common/constants.h"
+#include "common/macros.h"
 #include "common/spin_latch.h"
 #include "common/strong_typedef.h"
 
+namespace terrier {
+class ObjectPoolTests_ThreadExitTest_Test;
+}  // namespace terrier
+
 namespace terrier::common {
 // TODO(Yangjun): this class should be moved somewhere else.
 /**
@@ -50,6 +61,22 @@ class AllocatorFailureException : public std::exception {
  *
  * This prevents liberal calls to malloc and new in the code and makes tracking
  * our memory performance easier.
+ *
+ * Reusable objects are cached in small per-thread magazines in front of the pool's shared queue, so that threads mostly
+ * get and release objects without touching the shared queue or its latch. A thread gets its own magazine the first
+ * time it uses the pool, however many threads there are. An empty magazine is refilled from the shared queue, and a
+ * full one hands half of its objects back, in batches. Objects in magazines count towards both the size limit and the
+ * reuse limit like any other object the pool holds.
+ *
+ * The magazines are shared between the pool and the threads, which find theirs through a thread_local table. That way
+ * SetReuseLimit can drain them, and a thread that runs out of new objects at the size limit can take cached objects
+ * from other magazines. When a thread exits, it hands the objects in its magazines back to the shared queue of each
+ * pool that is still around, and the pool lets go of the empty magazine the next time a thread gets one. If the pool
+ * goes first, it frees the objects in every magazine, and the thread is left with an empty one. A magazine has a latch
+ * for the rare times another thread drains it, which its own thread almost always finds uncontended.
+ *
+ * The magazine size trades contention on the shared queue for memory: up to that many objects can sit unused in the
+ * magazine of every thread. Pools of large objects, like the BlockStore, should keep it small.
  * @tparam T the type of objects in the pool.
  * @tparam The allocator to use when constructing and destructing a new object.
  *         In most cases it can be left out and the default allocator will
@@ -68,9 +95,37 @@ class ObjectPool {
    *
    * @param size_limit the maximum number of objects the object pool controls
    * @param reuse_limit the maximum number of reusable objects
+   * @param magazine_size the maximum number of reusable objects each thread caches for itself, at least 1
    */
-  ObjectPool(uint64_t size_limit, uint64_t reuse_limit)
-      : size_limit_(size_limit), reuse_limit_(reuse_limit), current_size_(0) {}
+  ObjectPool(uint64_t size_limit, uint64_t reuse_limit, uint32_t magazine_size = DEFAULT_MAGAZINE_SIZE)
+      : id_(NextPoolId()),
+        magazine_size_(magazine_size),
+        batch_size_(std::max<uint32_t>(magazine_size / 2, 1)),
+        size_limit_(size_limit),
+        reuse_limit_(reuse_limit),
+        current_size_(0) {
+    TERRIER_ASSERT(magazine_size_ > 0, "Magazines must have room for at least one object");
+  }
+
+  /**
+   * Initializes a new object pool that gets its objects from the given allocator.
+   *
+   * @param size_limit the maximum number of objects the object pool controls
+   * @param reuse_limit the maximum number of reusable objects
+   * @param alloc the allocator to construct and destruct objects with
+   * @param magazine_size the maximum number of reusable objects each thread caches for itself, at least 1
+   */
+  ObjectPool(uint64_t size_limit, uint64_t reuse_limit, Allocator alloc,
+             uint32_t magazine_size = DEFAULT_MAGAZINE_SIZE)
+      : id_(NextPoolId()),
+        magazine_size_(magazine_size),
+        batch_size_(std::max<uint32_t>(magazine_size / 2, 1)),
+        alloc_(std::move(alloc)),
+        size_limit_(size_limit),
+        reuse_limit_(reuse_limit),
+        current_size_(0) {
+    TERRIER_ASSERT(magazine_size_ > 0, "Magazines must have room for at least one object");
+  }
 
   /**
    * Destructs the memory pool. Frees any memory it holds.
@@ -79,6 +134,13 @@ class ObjectPool {
    * not explicitly released via a Release call.
    */
   ~ObjectPool() {
+    // Threads that are still around are left with empty magazines, which they let go of when they exit
+    for (auto &magazine : magazines_) {
+      SpinLatch::ScopedSpinLatch guard(&magazine->latch_);
+      for (T *obj : magazine->objects_) alloc_.Delete(obj);
+      magazine->objects_.clear();
+      magazine->pool_ = nullptr;
+    }
     T *result = nullptr;
     while (!reuse_queue_.empty()) {
       result = reuse_queue_.front();
@@ -94,20 +156,15 @@ class ObjectPool {
    * @return pointer to memory that can hold T
    */
   T *Get() {
-    SpinLatch::ScopedSpinLatch guard(&latch_);
-    if (reuse_queue_.empty() && current_size_ >= size_limit_) throw NoMoreObjectException(size_limit_);
     T *result = nullptr;
-    if (reuse_queue_.empty()) {
-      result = alloc_.New();  // result could be null because the allocator may not find enough memory space
-      if (result != nullptr) current_size_++;
-    } else {
-      result = reuse_queue_.front();
-      reuse_queue_.pop();
-      alloc_.Reuse(result);
+    {
+      Magazine &magazine = MagazineForThread();
+      SpinLatch::ScopedSpinLatch guard(&magazine.latch_);
+      if (magazine.objects_.empty()) Refill(&magazine);
+      if (!magazine.objects_.empty()) result = TakeFrom(&magazine);
     }
-    // If result is nullptr. The call to alloc_.New() failed (i.e. can't allocate more memory from the system).
-    if (result == nullptr) throw AllocatorFailureException();
-    TERRIER_ASSERT(current_size_ <= size_limit_, "Object pool has exceeded its size limit.");
+    if (result == nullptr) return GetSlow();
+    alloc_.Reuse(result);
     return result;
   }
 
@@ -147,13 +204,22 @@ class ObjectPool {
    * @param new_reuse_limit
    */
   void SetReuseLimit(uint64_t new_reuse_limit) {
+    // Bring every cached object back to the shared queue first, so that they can be freed from there
+    {
+      SpinLatch::ScopedSpinLatch magazines_guard(&magazines_latch_);
+      for (auto &magazine : magazines_) {
+        SpinLatch::ScopedSpinLatch magazine_guard(&magazine->latch_);
+        Return(magazine.get(), static_cast<uint32_t>(magazine->objects_.size()));
+      }
+    }
     SpinLatch::ScopedSpinLatch guard(&latch_);
     reuse_limit_ = new_reuse_limit;
     T *obj = nullptr;
-    while (reuse_queue_.size() > reuse_limit_) {
+    while (num_reusable_.load() > reuse_limit_.load() && !reuse_queue_.empty()) {
       obj = reuse_queue_.front();
       alloc_.Delete(obj);
       reuse_queue_.pop();
+      num_reusable_--;
       current_size_--;
     }
   }
@@ -167,13 +233,17 @@ class ObjectPool {
    */
   void Release(T *obj) {
     TERRIER_ASSERT(obj != nullptr, "releasing a null pointer");
-    SpinLatch::ScopedSpinLatch guard(&latch_);
-    if (reuse_queue_.size() >= reuse_limit_) {
+    if (num_reusable_.fetch_add(1) >= reuse_limit_.load()) {
+      num_reusable_--;
+      SpinLatch::ScopedSpinLatch guard(&latch_);
       alloc_.Delete(obj);
       current_size_--;
-    } else {
-      reuse_queue_.push(obj);
+      return;
     }
+    Magazine &magazine = MagazineForThread();
+    SpinLatch::ScopedSpinLatch guard(&magazine.latch_);
+    if (magazine.objects_.size() == magazine_size_) Return(&magazine, batch_size_);
+    magazine.objects_.push_back(obj);
   }
 
   /**
@@ -181,16 +251,169 @@ class ObjectPool {
    */
   uint64_t GetSizeLimit() const { return size_limit_; }
 
+  /**
+   * @return the allocator objects of the pool are constructed and destructed with
+   */
+  const Allocator &GetAllocator() const { return alloc_; }
+
+  /** Maximum number of objects cached in a magazine, unless configured otherwise */
+  static constexpr uint32_t DEFAULT_MAGAZINE_SIZE = 32;
+
  private:
+  friend class terrier::ObjectPoolTests_ThreadExitTest_Test;
+
+  // A magazine is aligned to its own cache line so that latching one does not slow down threads using its neighbours.
+  struct alignas(Constants::CACHELINE_SIZE) Magazine {
+    explicit Magazine(ObjectPool *const pool) : pool_(pool) {}
+    SpinLatch latch_;
+    std::vector<T *> objects_;
+    // Pool the magazine belongs to, or nullptr once either the pool or the thread is gone. Latched.
+    ObjectPool *pool_;
+    // Whether the thread is gone, so that the pool can let go of the magazine
+    std::atomic<bool> retired_{false};
+  };
+
+  // A thread's magazines, which it hands back to their pools when it exits
+  struct ThreadMagazines {
+    ~ThreadMagazines() {
+      for (auto &entry : magazines_) {
+        Magazine *const magazine = entry.second.get();
+        SpinLatch::ScopedSpinLatch guard(&magazine->latch_);
+        // The pool waits for the latch to free the magazine's objects, so it is still around if it has not done so
+        if (magazine->pool_ == nullptr) continue;
+        magazine->pool_->Return(magazine, static_cast<uint32_t>(magazine->objects_.size()));
+        magazine->pool_ = nullptr;
+        magazine->retired_ = true;
+      }
+    }
+
+    // Forgets the magazines of pools that are gone
+    void ForgetDestroyedPools() {
+      for (auto it = magazines_.begin(); it != magazines_.end();) {
+        bool destroyed;
+        {
+          SpinLatch::ScopedSpinLatch guard(&it->second->latch_);
+          destroyed = it->second->pool_ == nullptr;
+        }
+        it = destroyed ? magazines_.erase(it) : std::next(it);
+      }
+    }
+
+    // Magazines by the id of their pool
+    std::unordered_map<uint64_t, std::shared_ptr<Magazine>> magazines_;
+  };
+
+  // Pools are told apart by ids that are never reused, so that a thread never mistakes a pool for an earlier one that
+  // was destroyed at the same address
+  static uint64_t NextPoolId() {
+    static std::atomic<uint64_t> next_pool_id{1};
+    return next_pool_id++;
+  }
+
+  // Returns the calling thread's magazine, which is created the first time the thread uses the pool
+  Magazine &MagazineForThread() {
+    // Threads mostly stick to a single pool of a type, so the last one used is checked first. A thread keeps an entry
+    // for every pool of this type it uses that is still around, which is never more than a handful.
+    thread_local uint64_t last_pool_id = 0;
+    thread_local Magazine *last_magazine = nullptr;
+    if (last_pool_id == id_) return *last_magazine;
+    thread_local ThreadMagazines thread_magazines;
+    auto it = thread_magazines.magazines_.find(id_);
+    if (it == thread_magazines.magazines_.end()) {
+      thread_magazines.ForgetDestroyedPools();
+      it = thread_magazines.magazines_.emplace(id_, std::make_shared<Magazine>(this)).first;
+      SpinLatch::ScopedSpinLatch guard(&magazines_latch_);
+      // The magazines of threads that exited since are empty, so this is a good time to let go of them
+      const auto retired = [](const std::shared_ptr<Magazine> &magazine) { return magazine->retired_.load(); };
+      magazines_.erase(std::remove_if(magazines_.begin(), magazines_.end(), retired), magazines_.end());
+      magazines_.push_back(it->second);
+    }
+    last_pool_id = id_;
+    last_magazine = it->second.get();
+    return *last_magazine;
+  }
+
+  // Takes a reusable object out of a latched magazine that is not empty
+  T *TakeFrom(Magazine *const magazine) {
+    T *const result = magazine->objects_.back();
+    magazine->objects_.pop_back();
+    num_reusable_--;
+    return result;
+  }
+
+  // Moves a batch of reusable objects from the shared queue to a latched magazine
+  void Refill(Magazine *const magazine) {
+    SpinLatch::ScopedSpinLatch guard(&latch_);
+    while (magazine->objects_.size() < batch_size_ && !reuse_queue_.empty()) {
+      magazine->objects_.push_back(reuse_queue_.front());
+      reuse_queue_.pop();
+    }
+  }
+
+  // Moves the given number of objects from a latched magazine to the shared queue
+  void Return(Magazine *const magazine, const uint32_t num_objects) {
+    SpinLatch::ScopedSpinLatch guard(&latch_);
+    for (uint32_t i = 0; i < num_objects; i++) {
+      reuse_queue_.push(magazine->objects_.back());
+      magazine->objects_.pop_back();
+    }
+  }
+
+  // Gets an object when the thread's magazine and the shared queue had nothing to reuse
+  T *GetSlow() {
+    {
+      SpinLatch::ScopedSpinLatch guard(&latch_);
+      T *result = nullptr;
+      if (!reuse_queue_.empty()) {
+        // Released since we last looked
+        result = reuse_queue_.front();
+        reuse_queue_.pop();
+        num_reusable_--;
+        alloc_.Reuse(result);
+        return result;
+      }
+      if (current_size_ < size_limit_) {
+        result = alloc_.New();  // result could be null because the allocator may not find enough memory space
+        // If result is nullptr. The call to alloc_.New() failed (i.e. can't allocate more memory from the system).
+        if (result == nullptr) throw AllocatorFailureException();
+        current_size_++;
+        TERRIER_ASSERT(current_size_ <= size_limit_, "Object pool has exceeded its size limit.");
+        return result;
+      }
+    }
+    // We cannot allocate any more, but other threads may still have objects to reuse in their magazines. Latch one
+    // magazine at a time, as threads refilling their magazine take the shared latch while holding theirs.
+    SpinLatch::ScopedSpinLatch magazines_guard(&magazines_latch_);
+    for (auto &magazine : magazines_) {
+      SpinLatch::ScopedSpinLatch guard(&magazine->latch_);
+      if (!magazine->objects_.empty()) {
+        T *const result = TakeFrom(magazine.get());
+        alloc_.Reuse(result);
+        return result;
+      }
+    }
+    throw NoMoreObjectException(size_limit_);
+  }
+
+  const uint64_t id_;
+  const uint32_t magazine_size_;
+  // Number of objects moved between a magazine and the shared queue at a time
+  const uint32_t batch_size_;
   Allocator alloc_;
   SpinLatch latch_;
   // TODO(yangjuns): We don't need to reuse objects in a FIFO pattern. We could potentially pass a second template
   // parameter to define the backing container for the std::queue. That way we can measure each backing container.
   std::queue<T *> reuse_queue_;
-  uint64_t size_limit_;   // the maximum number of objects a object pool can have
-  uint64_t reuse_limit_;  // the maximum number of reusable objects in reuse_queue
+  // Magazines of all threads that have used the pool. Latched to add or go through them, never by the fast paths.
+  std::vector<std::shared_ptr<Magazine>> magazines_;
+  SpinLatch magazines_latch_;
+  uint64_t size_limit_;                // the maximum number of objects a object pool can have
+  std::atomic<uint64_t> reuse_limit_;  // the maximum number of reusable objects in reuse_queue and the magazines
   // current_size_ represents the number of objects the object pool has allocated,
-  // including objects that have been given out to callers and those reside in reuse_queue
+  // including objects that have been given out to callers and those reside in reuse_queue or the magazines
   uint64_t current_size_;
+  // Number of reusable objects in reuse_queue and the magazines. Releases check it against reuse_limit_ without
+  // latching anything.
+  std::atomic<uint64_t> num_reusable_{0};
 };
 }  // namespace terrier::common
@@ -129,6 +129,7 @@ namespace terrier::execution::ast {
                                                                         \
   /* Aggregations */                                                    \
   F(AggHashTableInit, aggHTInit)                                        \
+  F(AggHashTableEnableSpilling, aggHTEnableSpilling)                    \
   F(AggHashTableInsert, aggHTInsert)                                    \
   F(AggHashTableLinkEntry, aggHTLink)                                   \
   F(AggHashTableLookup, aggHTLookup)                                    \
@@ -157,6 +158,13 @@ namespace terrier::execution::ast {
   F(JoinHashTableInsert, joinHTInsert)                                  \
   F(JoinHashTableBuild, joinHTBuild)                                    \
   F(JoinHashTableBuildParallel, joinHTBuildParallel)                    \
+  F(JoinHashTableBuildBloomFilter, joinHTBuildBloomFilter)              \
+  F(JoinHashTableFilterProbe, joinHTFilterProbe)                        \
+  F(JoinHashTableEnableSpilling, joinHTEnableSpilling)                  \
+  F(JoinHashTableIsResident, joinHTIsResident)                          \
+  F(JoinHashTableSpillProbeTuple, joinHTSpillProbeTuple)                \
+  F(JoinHashTableNextPartition, joinHTNextPartition)                    \
+  F(JoinHashTableReadProbeTuple, joinHTReadProbeTuple)                  \
   F(JoinHashTableLookup, joinHTLookup)                                  \
   F(JoinHashTableFree, joinHTFree)                                      \
                                                                         \
@@ -166,6 +174,7 @@ namespace terrier::execution::ast {
                                                                         \
   /* Sorting */                                                         \
   F(SorterInit, sorterInit)                                             \
+  F(SorterEnableSpilling, sorterEnableSpilling)                         \
   F(SorterInsert, sorterInsert)                                         \
   F(SorterInsertTopK, sorterInsertTopK)                                 \
   F(SorterInsertTopKFinish, sorterInsertTopKFinish)                     \
@@ -257,6 +266,11 @@ namespace terrier::execution::ast {
   F(IndexInsertUnique, indexInsertUnique)                               \
   F(IndexInsertWithSlot, indexInsertWithSlot)                           \
   F(IndexDelete, indexDelete)                                           \
+  F(GetTablePRForBatch, getTablePRForBatch)                             \
+  F(GetIndexPRForBatch, getIndexPRForBatch)                             \
+  F(TableInsertBatch, tableInsertBatch)                                 \
+  F(IndexBulkLoadAdd, indexBulkLoadAdd)                                 \
+  F(IndexBulkLoadFinish, indexBulkLoadFinish)                           \
   F(StorageInterfaceFree, storageInterfaceFree)                         \
   /* Trig */                                                            \
   F(ACos, acos)                                                         \
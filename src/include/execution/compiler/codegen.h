@@ -720,6 +720,15 @@ class CodeGen {
    */
   [[nodiscard]] ast::Expr *FilterManagerInit(ast::Expr *filter_manager, ast::Expr *exec_ctx);
 
+  /**
+   * Call \@filterManagerInit(). Initialize the provided filter manager instance, whose filters receive the provided
+   * opaque context.
+   * @param filter_manager The filter manager pointer.
+   * @param exec_ctx The execution context variable.
+   * @param opaque_ctx The pointer passed to all filters.
+   */
+  [[nodiscard]] ast::Expr *FilterManagerInit(ast::Expr *filter_manager, ast::Expr *exec_ctx, ast::Expr *opaque_ctx);
+
   /**
    * Call \@filterManagerFree(). Destroy and clean up the provided filter manager instance.
    * @param filter_manager The filter manager pointer.
@@ -865,6 +874,69 @@ class CodeGen {
   [[nodiscard]] ast::Expr *JoinHashTableBuildParallel(ast::Expr *join_hash_table, ast::Expr *thread_state_container,
                                                       ast::Expr *offset);
 
+  /**
+   * Call \@joinHTBuildBloomFilter(). Builds a bloom filter over the hashes of all tuples in the provided join hash
+   * table, expected to be a *JoinHashTable. Called once the table has been built.
+   * @param join_hash_table The pointer to the join hash table.
+   * @return The call.
+   */
+  [[nodiscard]] ast::Expr *JoinHashTableBuildBloomFilter(ast::Expr *join_hash_table);
+
+  /**
+   * Call \@joinHTFilterProbe(). Removes the tuples from the provided TID list whose keys cannot find a join partner
+   * in the join hash table, according to its bloom filter.
+   * @param join_hash_table The pointer to the join hash table.
+   * @param vector_proj The vector projection of probe tuples.
+   * @param tid_list The TID list of probe tuples to filter.
+   * @param key_cols The name of the array holding the indexes of the key columns in the vector projection.
+   * @return The call.
+   */
+  [[nodiscard]] ast::Expr *JoinHashTableFilterProbe(ast::Expr *join_hash_table, ast::Expr *vector_proj,
+                                                    ast::Expr *tid_list, ast::Identifier key_cols);
+
+  /**
+   * Call \@joinHTEnableSpilling(). Allows the provided join hash table to spill build tuples to disk once they take up
+   * the operator memory budget in the execution settings.
+   * @param join_hash_table The pointer to the join hash table.
+   * @param probe_row_type_name The name of the probe-row type written out by \@joinHTSpillProbeTuple().
+   * @return The call.
+   */
+  [[nodiscard]] ast::Expr *JoinHashTableEnableSpilling(ast::Expr *join_hash_table, ast::Identifier probe_row_type_name);
+
+  /**
+   * Call \@joinHTIsResident(). Checks whether probe tuples with the provided hash value can be probed now, as their
+   * partition of the join hash table is in memory.
+   * @param join_hash_table The pointer to the join hash table.
+   * @param hash_val The hash value of the probe key.
+   * @return The call.
+   */
+  [[nodiscard]] ast::Expr *JoinHashTableIsResident(ast::Expr *join_hash_table, ast::Expr *hash_val);
+
+  /**
+   * Call \@joinHTSpillProbeTuple(). Writes out a probe row whose partition of the join hash table is not in memory.
+   * @param join_hash_table The pointer to the join hash table.
+   * @param hash_val The hash value of the probe key.
+   * @param probe_row The pointer to the probe row.
+   * @return The call.
+   */
+  [[nodiscard]] ast::Expr *JoinHashTableSpillProbeTuple(ast::Expr *join_hash_table, ast::Expr *hash_val,
+                                                        ast::Expr *probe_row);
+
+  /**
+   * Call \@joinHTNextPartition(). Loads the next spilled partition of the provided join hash table.
+   * @param join_hash_table The pointer to the join hash table.
+   * @return The call, which is true if a partition was loaded.
+   */
+  [[nodiscard]] ast::Expr *JoinHashTableNextPartition(ast::Expr *join_hash_table);
+
+  /**
+   * Call \@joinHTReadProbeTuple(). Reads back the next probe row written out for the loaded partition.
+   * @param join_hash_table The pointer to the join hash table.
+   * @param probe_row The pointer to the probe row to read into.
+   * @return The call, which is true if a row was read.
+   */
+  [[nodiscard]] ast::Expr *JoinHashTableReadProbeTuple(ast::Expr *join_hash_table, ast::Expr *probe_row);
+
   /**
    * Call \@joinHTLookup(). Performs a single lookup into the hash table with a tuple with the
    * provided hash value. The provided iterator will provide tuples in the hash table that match the
@@ -917,6 +989,14 @@ class CodeGen {
   [[nodiscard]] ast::Expr *AggHashTableInit(ast::Expr *agg_ht, ast::Expr *exec_ctx, ast::Expr *mem_pool,
                                             ast::Identifier agg_payload_type);
 
+  /**
+   * Call \@aggHTEnableSpilling(). Allows the provided partitioned aggregation hash table to spill its overflow
+   * partitions to disk once they take up the operator memory budget in the execution settings.
+   * @param agg_ht A pointer to the aggregation hash table.
+   * @return The call.
+   */
+  [[nodiscard]] ast::Expr *AggHashTableEnableSpilling(ast::Expr *agg_ht);
+
   /**
    * Call \@aggHTLookup(). Performs a single key lookup in an aggregation hash table. The hash value
    * is provided, as is a key check function to resolve hash collisions. The result of the lookup
@@ -1109,6 +1189,15 @@ class CodeGen {
   [[nodiscard]] ast::Expr *SorterInit(ast::Expr *sorter, ast::Expr *mem_pool, ast::Identifier cmp_func_name,
                                       ast::Identifier sort_row_type_name);
 
+  /**
+   * Call \@sorterEnableSpilling(). Allows the provided sorter to write sorted runs to disk once its
+   * tuples take up the operator memory budget in the execution settings of the execution context.
+   * @param sorter The sorter instance.
+   * @param exec_ctx The execution context.
+   * @return The call.
+   */
+  [[nodiscard]] ast::Expr *SorterEnableSpilling(ast::Expr *sorter, ast::Expr *exec_ctx);
+
   /**
    * Call \@sorterInsert(). Prepare an insert into the provided sorter whose type is the given type.
    * @param sorter The sorter instance.
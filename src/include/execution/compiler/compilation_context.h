@@ -85,6 +85,11 @@ class CompilationContext {
    */
   StateDescriptor *GetQueryState() { return &query_state_; }
 
+  /**
+   * @return The execution settings the query is compiled with.
+   */
+  const exec::ExecutionSettings &GetExecutionSettings() const { return query_->GetExecutionSettings(); }
+
   /**
    * @return The translator for the given relational plan node; null if the provided plan node does
    *         not have a translator registered in this context.
@@ -85,6 +85,11 @@ class ExecutableQuery {
      */
     bool IsCompiled() const { return module_ != nullptr; }
 
+    /**
+     * @return The module containing the compiled code of this fragment.
+     */
+    const vm::Module *GetModule() const { return module_.get(); }
+
    private:
     // The functions that must be run (in the provided order) to execute this
     // query fragment.
@@ -142,6 +147,9 @@ class ExecutableQuery {
    */
   ast::Context *GetContext() { return ast_context_.get(); }
 
+  /** @return The compiled query fragments, in the order they are executed. Setup must have been called! */
+  const std::vector<std::unique_ptr<Fragment>> &GetFragments() const { return fragments_; }
+
   /** @return The execution settings used for this query. */
   const exec::ExecutionSettings &GetExecutionSettings() const { return exec_settings_; }
 
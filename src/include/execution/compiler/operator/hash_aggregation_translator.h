@@ -182,6 +182,9 @@ class HashAggregationTranslator : public OperatorTranslator, public PipelineDriv
   StateDescriptor::Entry global_agg_ht_;
   StateDescriptor::Entry local_agg_ht_;
 
+  // Whether the aggregation hash tables may spill to disk once they take up the operator memory budget.
+  bool spill_enabled_{false};
+
   // For minirunners
   ast::StructDecl *struct_decl_;
 };
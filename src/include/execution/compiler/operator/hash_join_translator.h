@@ -86,6 +86,22 @@ class HashJoinTranslator : public OperatorTranslator {
    */
   void FinishPipelineWork(const Pipeline &pipeline, FunctionBuilder *function) const override;
 
+  /**
+   * If the join hash table may spill to disk, the probe pipeline writes out the probe tuples of
+   * partitions that are not in memory.
+   * @param pipeline The current pipeline.
+   * @return True if this is the probe pipeline and the join hash table may spill; false otherwise.
+   */
+  bool HasDeferredPipelineWork(const Pipeline &pipeline) const override;
+
+  /**
+   * Load the spilled partitions of the join hash table one at a time, and probe each with the probe
+   * tuples written out for it, pushing the matches through the rest of the probe pipeline.
+   * @param ctx The context of the work.
+   * @param function The pipeline generating function.
+   */
+  void PerformDeferredPipelineWork(WorkContext *ctx, FunctionBuilder *function) const override;
+
   /**
    * @return The value (vector) of the attribute at the given index (@em attr_idx) produced by the
    *         child at the given index (@em child_idx).
@@ -108,6 +124,9 @@ class HashJoinTranslator : public OperatorTranslator {
   // Is the given pipeline this join's right pipeline?
   bool IsRightPipeline(const Pipeline &pipeline) const { return GetPipeline() == &pipeline; }
 
+  // Does the work in the given context probe with tuples read back from disk? Their work starts at this join.
+  bool IsSpilledProbe(const WorkContext *ctx) const;
+
   // Initialize the given join hash table instance, provided as a *JHT.
   void InitializeJoinHashTable(FunctionBuilder *function, ast::Expr *jht_ptr) const;
 
@@ -117,6 +136,9 @@ class HashJoinTranslator : public OperatorTranslator {
   // Access an attribute at the given index in the provided build row.
   ast::Expr *GetBuildRowAttribute(ast::Expr *build_row, uint32_t attr_idx) const;
 
+  // Access an attribute at the given index in the probe row.
+  ast::Expr *GetProbeRowAttribute(uint32_t attr_idx) const;
+
   // Evaluate the provided hash keys in the provided context and return the
   // results in the provided results output vector.
   ast::Expr *HashKeys(WorkContext *ctx, FunctionBuilder *function,
@@ -131,12 +153,21 @@ class HashJoinTranslator : public OperatorTranslator {
   // Probe the join hash table with the input tuple(s).
   void ProbeJoinHashTable(WorkContext *ctx, FunctionBuilder *function) const;
 
+  // Write out the input tuple as a probe row, as its partition of the join hash table is not in memory.
+  void SpillProbeRow(WorkContext *ctx, FunctionBuilder *function, ast::Expr *hash_val) const;
+
+  // Iterate the build tuples matching the provided hash value.
+  void ProbeEntries(WorkContext *ctx, FunctionBuilder *function, ast::Expr *entry_iter, ast::Expr *hash_val) const;
+
   // Check the right mark.
   void CheckRightMark(WorkContext *ctx, FunctionBuilder *function, ast::Identifier right_mark) const;
 
   // Check the join predicate.
   void CheckJoinPredicate(WorkContext *ctx, FunctionBuilder *function) const;
 
+  // Hand the bloom filter of the join hash table to the scan producing the probe keys, if there is one.
+  void PushDownBloomFilter();
+
   /** @return The struct that was declared, used for the minirunner. */
   ast::StructDecl *GetStructDecl() const { return struct_decl_; }
 
@@ -147,6 +178,9 @@ class HashJoinTranslator : public OperatorTranslator {
   ast::Identifier build_row_type_;
   // For mark-based joins.
   ast::Identifier build_mark_;
+  // The name of the probe row written out when the join hash table spills, and its type.
+  ast::Identifier probe_row_var_;
+  ast::Identifier probe_row_type_;
 
   // The left build-side pipeline.
   Pipeline left_pipeline_;
@@ -156,6 +190,13 @@ class HashJoinTranslator : public OperatorTranslator {
   StateDescriptor::Entry global_join_ht_;
   StateDescriptor::Entry local_join_ht_;
 
+  // Whether a probe-side scan filters its tuples through the bloom filter of
+  // the join hash table, which then has to be built along with the table.
+  bool build_bloom_filter_{false};
+
+  // Whether the join hash table may spill to disk once it takes up the operator memory budget.
+  bool spill_enabled_{false};
+
   // Struct declaration for minirunner.
   ast::StructDecl *struct_decl_;
 };
@@ -78,6 +78,8 @@ class IndexCreateTranslator : public OperatorTranslator, public PipelineDriver {
   // Generate a scan over the VPI.
   void ScanVPI(WorkContext *ctx, FunctionBuilder *function, ast::Expr *vpi) const;
   void IndexInsert(WorkContext *ctx, FunctionBuilder *function) const;
+  // Load the keys gathered by the scan into the index.
+  void BulkLoadIndex(FunctionBuilder *function) const;
 
   void FreeInserter(FunctionBuilder *function) const;
 
@@ -2,6 +2,7 @@
 
 #include <vector>
 
+#include "execution/ast/builtins.h"
 #include "execution/ast/identifier.h"
 #include "execution/compiler/operator/operator_translator.h"
 #include "execution/compiler/pipeline_driver.h"
@@ -95,6 +96,13 @@ class InsertTranslator : public OperatorTranslator, public PipelineDriver {
   // Insert into an index of this table.
   void GenIndexInsert(WorkContext *context, FunctionBuilder *builder, const catalog::index_oid_t &index_oid) const;
 
+  // Gets a projected row of the index from the given builtin, and fills in the key from the insert PR.
+  void GenSetIndexPR(WorkContext *context, FunctionBuilder *builder, const catalog::index_oid_t &index_oid,
+                     ast::Builtin get_index_pr) const;
+
+  // Insert all rows of a multi-row insert in one batch, into the table first and then into each index.
+  void GenBatchInsert(WorkContext *context, FunctionBuilder *function) const;
+
   // Gets all the column oids in a schema.
   static std::vector<catalog::col_oid_t> AllColOids(const catalog::Schema &table_schema);
 
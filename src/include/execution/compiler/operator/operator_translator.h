@@ -163,6 +163,22 @@ class OperatorTranslator : public ColumnValueProvider {
    */
   virtual void PerformPipelineWork(WorkContext *context, FunctionBuilder *function) const = 0;
 
+  /**
+   * @return True if this operator holds back some of the tuples flowing through the given pipeline, to
+   *         push them through the rest of the pipeline in PerformDeferredPipelineWork(); false otherwise.
+   */
+  virtual bool HasDeferredPipelineWork(const Pipeline &pipeline) const { return false; }
+
+  /**
+   * Push the tuples held back during the main work of a pipeline through the rest of the pipeline. This
+   * is called once the main work is done, before any operator finishes its work in the pipeline. For
+   * example, a hash join whose build side has spilled to disk writes out the probe tuples of partitions
+   * that are not in memory, and probes them here one partition at a time.
+   * @param context The context of the work, which starts at this operator.
+   * @param function The pipeline generating function.
+   */
+  virtual void PerformDeferredPipelineWork(WorkContext *context, FunctionBuilder *function) const {}
+
   /**
    * Perform any work required <b>after</b> the main pipeline work. This is executed by one thread.
    * @param pipeline The pipeline whose post-work logic is being generated.
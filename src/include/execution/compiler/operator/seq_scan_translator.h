@@ -89,10 +89,31 @@ class SeqScanTranslator : public OperatorTranslator, public PipelineDriver {
   /** @return The expression representing the current VPI. */
   ast::Expr *GetVPI() const;
 
+  /**
+   * Filter the scanned tuples through the bloom filter of a join hash table probed with them further up the pipeline,
+   * so that tuples that cannot find a join partner are dropped before they are materialized. Must be called before
+   * helper functions are defined.
+   * @param join_ht The query state entry of the join hash table. Its bloom filter must be built before the scan runs.
+   * @param key_col_oids The OIDs of the columns making up the join key, in the order the join hashes them.
+   * @return True if the filter was added; false if the scan does not read all of the key columns.
+   */
+  bool AddBloomFilter(const StateDescriptor::Entry &join_ht, const std::vector<catalog::col_oid_t> &key_col_oids);
+
  private:
+  // A join hash table whose bloom filter the scanned tuples are filtered through.
+  struct BloomFilterProbe {
+    // Where the join hash table exists.
+    StateDescriptor::Entry join_ht_;
+    // The indexes of the join key columns in the scanned vector projections.
+    std::vector<uint32_t> key_cols_;
+  };
+
   // Does the scan have a predicate?
   bool HasPredicate() const;
 
+  // Does the scan run a filter manager, either for its predicate or for bloom filters?
+  bool HasFilterManager() const;
+
   // Get the OID of the table being scanned.
   catalog::table_oid_t GetTableOid() const;
 
@@ -108,6 +129,13 @@ class SeqScanTranslator : public OperatorTranslator, public PipelineDriver {
                                      common::ManagedPointer<parser::AbstractExpression> predicate,
                                      std::vector<ast::Identifier> *curr_clause, bool seen_conjunction);
 
+  // Generate a filter term probing the bloom filter of a join hash table, returning its name.
+  ast::Identifier GenerateBloomFilterTerm(util::RegionVector<ast::FunctionDecl *> *decls,
+                                          const BloomFilterProbe &bloom_filter);
+
+  // The parameters of all filter terms.
+  util::RegionVector<ast::FieldDecl *> MakeFilterTermParams() const;
+
   // Perform a table scan using the provided table vector iterator pointer.
   void ScanTable(WorkContext *ctx, FunctionBuilder *function) const;
 
@@ -138,9 +166,12 @@ class SeqScanTranslator : public OperatorTranslator, public PipelineDriver {
   StateDescriptor::Entry local_filter_manager_;
 
   // The list of filter manager clauses. Populated during helper function
-  // definition, but only if there's a predicate.
+  // definition, but only if there's a predicate or a bloom filter.
   std::vector<std::vector<ast::Identifier>> filters_;
 
+  // The bloom filters of the join hash tables probed with the scanned tuples.
+  std::vector<BloomFilterProbe> bloom_filters_;
+
   // The version of col_oids that we use for translation. See MakeInputOids for justification.
   std::vector<catalog::col_oid_t> col_oids_;
 };
@@ -151,6 +151,9 @@ class SortTranslator : public OperatorTranslator, public PipelineDriver {
   StateDescriptor::Entry global_sorter_;
   StateDescriptor::Entry local_sorter_;
 
+  // Whether the sorters may write sorted runs to disk once they take up the operator memory budget.
+  bool spill_enabled_{false};
+
   enum class CurrentRow { Child, Lhs, Rhs };
   CurrentRow current_row_;
 
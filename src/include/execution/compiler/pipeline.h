@@ -199,6 +199,12 @@ class Pipeline {
   // Generate the main pipeline logic.
   ast::FunctionDecl *GenerateRunPipelineFunction(query_id_t query_id) const;
 
+  // Does any operator hold back tuples to push through the rest of the pipeline after the main work?
+  bool HasDeferredWork() const;
+
+  // Let the operators that held back tuples push them through the rest of the pipeline.
+  void PerformDeferredWork(FunctionBuilder *function) const;
+
   // Generate pipeline tear-down logic.
   ast::FunctionDecl *GenerateTearDownPipelineFunction() const;
 
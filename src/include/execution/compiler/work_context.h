@@ -36,6 +36,15 @@ class WorkContext {
    */
   WorkContext(CompilationContext *compilation_context, const Pipeline &pipeline);
 
+  /**
+   * Create a new context whose data flows along the provided pipeline, starting at the provided step
+   * rather than at the source of the pipeline.
+   * @param compilation_context The compilation context.
+   * @param pipeline The pipeline.
+   * @param source The step of the pipeline the data starts flowing from.
+   */
+  WorkContext(CompilationContext *compilation_context, const Pipeline &pipeline, Pipeline::StepIterator source);
+
   /**
    * Derive the value of the given expression.
    * @param expr The expression.
@@ -60,6 +69,11 @@ class WorkContext {
    */
   OperatorTranslator *CurrentOp() const { return *pipeline_iter_; }
 
+  /**
+   * @return The operator the data flowing through this context started from.
+   */
+  OperatorTranslator *SourceOp() const { return *pipeline_begin_; }
+
   /**
    * @return The pipeline the consumption occurs in.
    */
@@ -92,8 +106,8 @@ class WorkContext {
 
   // Cache of expression results.
   std::unordered_map<CacheKey_t, ast::Expr *, HashKey> cache_;
-  // The current pipeline step and last pipeline step.
-  Pipeline::StepIterator pipeline_iter_, pipeline_end_;
+  // The first pipeline step, the current pipeline step, and last pipeline step.
+  Pipeline::StepIterator pipeline_begin_, pipeline_iter_, pipeline_end_;
   // Whether to cache translated expressions
   bool cache_enabled_;
 };
@@ -1,8 +1,13 @@
 #pragma once
 
 #include "common/constants.h"
+#include "common/managed_pointer.h"
 #include "execution/util/execution_common.h"
 
+namespace terrier::settings {
+class SettingsManager;
+}  // namespace terrier::settings
+
 namespace terrier::runner {
 class MiniRunners;
 }  // namespace terrier::runner
@@ -10,10 +15,16 @@ class MiniRunners;
 namespace terrier::execution::exec {
 /**
  * ExecutionSettings stores settings that are passed down from the upper layers.
- * TODO(WAN): Hook this up to the settings manager. Since everything is currently hardcoded, it can wait.
+ * TODO(WAN): Hook the rest of this up to the settings manager. Most of it is still hardcoded.
  */
 class EXPORT ExecutionSettings {
  public:
+  /**
+   * Update the settings that are backed by the settings manager to their current values.
+   * @param settings The settings manager to read the values from.
+   */
+  void UpdateFromSettingsManager(common::ManagedPointer<settings::SettingsManager> settings);
+
   /** @return The vector active element threshold past which full auto-vectorization is done on vectors. */
   constexpr double GetSelectOptThreshold() const { return select_opt_threshold_; }
 
@@ -33,12 +44,20 @@ class EXPORT ExecutionSettings {
   /** @return True if parallel query execution is enabled. */
   constexpr bool GetIsParallelQueryExecutionEnabled() const { return is_parallel_execution_enabled_; }
 
+  /** @return The number of bytes an operator that can spill to disk may buffer before it does; zero for no limit. */
+  constexpr uint64_t GetOperatorMemoryBudget() const { return operator_memory_budget_; }
+
+  /** @return True if hash joins filter the tuples of probe-side scans through the bloom filters of their tables. */
+  constexpr bool GetIsBloomFilterPushdownEnabled() const { return is_bloom_filter_pushdown_enabled_; }
+
  private:
   double select_opt_threshold_{common::Constants::SELECT_OPT_THRESHOLD};
   double arithmetic_full_compute_opt_threshold_{common::Constants::ARITHMETIC_FULL_COMPUTE_THRESHOLD};
   float min_bit_density_threshold_for_avx_index_decode_{common::Constants::BIT_DENSITY_THRESHOLD_FOR_AVX_INDEX_DECODE};
   float adaptive_predicate_order_sampling_frequency_{common::Constants::ADAPTIVE_PRED_ORDER_SAMPLE_FREQ};
   bool is_parallel_execution_enabled_{common::Constants::IS_PARALLEL_EXECUTION_ENABLED};
+  uint64_t operator_memory_budget_{common::Constants::OPERATOR_MEMORY_BUDGET};
+  bool is_bloom_filter_pushdown_enabled_{common::Constants::IS_BLOOM_FILTER_PUSHDOWN_ENABLED};
 
   // MiniRunners needs to set query_identifier and pipeline_operating_units_.
   friend class terrier::runner::MiniRunners;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <functional>
 #include <memory>
 #include <utility>
@@ -9,6 +10,7 @@
 #include "common/managed_pointer.h"
 #include "execution/sql/chaining_hash_table.h"
 #include "execution/sql/memory_pool.h"
+#include "execution/sql/spill_file.h"
 #include "execution/sql/vector.h"
 #include "execution/sql/vector_projection.h"
 #include "execution/util/chunked_vector.h"
@@ -40,6 +42,14 @@ class AHTOverflowPartitionIterator;
 
 /**
  * The hash table used when performing aggregations.
+ *
+ * In partitioned mode, aggregates are periodically flushed from the hash table into overflow
+ * partitions, which are merged into one table per partition when scanned. A partitioned table can be
+ * given a memory budget through AggregationHashTable::EnableSpilling(). Once its flushed aggregates
+ * take up the whole budget, the overflow partitions are written out to temporary files, one set of
+ * files per spill partition, picked by the leading bits of the hash. The partitioned scans then read
+ * back, merge and scan one spill partition at a time, releasing it before loading the next. A spill
+ * partition that does not fit in the budget is first split on the next bits of the hash, recursively.
  */
 class EXPORT AggregationHashTable {
  public:
@@ -55,6 +65,9 @@ class EXPORT AggregationHashTable {
   /** The default precision used to configure the HyperLogLog instances. Set to optimize accuracy and space manually. */
   static constexpr uint32_t DEFAULT_HLL_PRECISION = 10;
 
+  /** The number of spill partitions spilled aggregates are split into, at each level of partitioning. */
+  static constexpr uint32_t NUM_SPILL_PARTITIONS = 16;
+
   // -------------------------------------------------------
   // Callback functions to customize aggregations
   // -------------------------------------------------------
@@ -103,6 +116,8 @@ class EXPORT AggregationHashTable {
     uint64_t num_growths_ = 0;
     /** Number of times that the hash table has been flushed. */
     uint64_t num_flushes_ = 0;
+    /** Number of times that the overflow partitions have been spilled to disk. */
+    uint64_t num_spills_ = 0;
   };
 
   // -------------------------------------------------------
@@ -140,6 +155,15 @@ class EXPORT AggregationHashTable {
    */
   ~AggregationHashTable();
 
+  /**
+   * Allow this table to write its overflow partitions out to disk once its aggregates take up more
+   * than @em memory_budget bytes. Only tables built in partitioned mode ever spill. Must be called
+   * before any aggregate is inserted. The thread-local tables of a parallel aggregation must all have
+   * spilling enabled if the global table has.
+   * @param memory_budget The number of bytes of aggregates to keep in memory. Zero means no limit.
+   */
+  void EnableSpilling(uint64_t memory_budget);
+
   /**
    * Insert a new element with hash value @em hash into the aggregation table.
    * @param hash The hash value of the element to insert.
@@ -255,11 +279,19 @@ class EXPORT AggregationHashTable {
    */
   uint64_t GetTupleCount() const { return hash_table_.GetElementCount(); }
 
+  /**
+   * @return True if the overflow partitions have been written out to disk; false otherwise.
+   */
+  bool IsSpilled() const noexcept { return spilled_; }
+
   /**
    * @return A read-only view of this aggregation table's statistics.
    */
   const Stats *GetStatistics() const { return &stats_; }
 
+  /** @return The execution settings in use for this AggregationHashTable. */
+  const exec::ExecutionSettings &GetExecutionSettings() const { return exec_settings_; }
+
   // Specialized hash table mapping hash values to group IDs
   class HashToGroupIdMap;
 
@@ -318,6 +350,44 @@ class EXPORT AggregationHashTable {
   // table over a single partition.
   AggregationHashTable *GetOrBuildTableOverPartition(void *query_state, uint32_t partition_idx);
 
+  // Should we spill the overflow partitions to disk?
+  bool NeedsToSpill() const noexcept { return entries_.size() >= spill_threshold_; }
+
+  // Write all overflow partitions out to the spill files, and release their
+  // memory. The main hash table must have been flushed.
+  void SpillOverflowPartitions();
+
+  // Flush and spill all aggregates if they take up the whole memory budget.
+  // No aggregate may be in the middle of being initialized or updated.
+  void SpillIfNeeded();
+
+  // Spill the overflow partitions of all thread-local tables, and take over
+  // their spill files.
+  void TransferSpilledPartitions(const std::vector<AggregationHashTable *> &tl_agg_ht);
+
+  // Give the memory of all entries back to the memory pool.
+  void ReleaseEntries();
+
+  // Destroy the tables built over, and forget the entries of, the overflow
+  // partitions in the range [begin, end).
+  void ReleasePartitions(uint32_t begin, uint32_t end);
+
+  // The files holding the spilled aggregates of one spill partition.
+  using SpillPartition = std::vector<std::unique_ptr<SpillFile>>;
+
+  // Read the spill partition whose aggregates share the leading num_hash_bits
+  // bits hash_prefix of their hash back into memory, invoke the function on
+  // the overflow partitions it covers, and release them. If it does not fit in
+  // the memory budget, split it and process each part in turn instead.
+  template <typename F>
+  void ProcessSpilledPartition(SpillPartition *files, uint64_t hash_prefix, uint32_t num_hash_bits, F &f);
+
+  // Invoke the function on ranges of overflow partitions that together cover
+  // all partitions. If spilled, each range is read back before the call and
+  // released after it.
+  template <typename F>
+  void ForEachPartitionRange(F &&f);
+
  private:
   // A helper class containing various data structures used during batch processing.
   class BatchProcessState {
@@ -406,6 +476,18 @@ class EXPORT AggregationHashTable {
   // partition an entry is linked into.
   uint64_t partition_shift_bits_;
 
+  // -------------------------------------------------------
+  // Spilling
+  // -------------------------------------------------------
+
+  // The number of entries past which the overflow partitions are spilled.
+  uint64_t spill_threshold_;
+  // Have the overflow partitions been spilled?
+  bool spilled_;
+  // The files each spill partition is written to. The first file is written
+  // by this table, the others are taken over from thread-local tables.
+  std::array<SpillPartition, NUM_SPILL_PARTITIONS> spill_files_;
+
   // Runtime stats.
   Stats stats_;
 
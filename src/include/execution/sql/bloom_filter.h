@@ -95,6 +95,11 @@ class BloomFilter {
    */
   uint64_t GetTotalBitsSet() const;
 
+  /**
+   * @return True if the filter has been initialized with a size; false otherwise.
+   */
+  bool IsInitialized() const { return blocks_ != nullptr; }
+
   /**
    * @return True if the filter is empty; false otherwise.
    */
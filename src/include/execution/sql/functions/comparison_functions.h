@@ -238,17 +238,8 @@ class EXPORT ComparisonFunctions {
    */
   static int32_t Compare(const StringVal &v1, const StringVal &v2) {
     TERRIER_ASSERT(!v1.is_null_ && !v2.is_null_, "Both input strings must not be null");
-    const auto min_len = std::min(v1.GetLength(), v2.GetLength());
-    if (min_len == 0) {
-      if (v1.GetLength() == v2.GetLength()) {
-        return 0;
-      }
-      if (v1.GetLength() == 0) {
-        return -1;
-      }
-      return 1;
-    }
-    return RawStringCompare(v1.GetContent(), v1.GetLength(), v2.GetContent(), v2.GetLength(), min_len);
+    // Goes through the prefixes stored in the entries before following any content pointer
+    return storage::VarlenEntry::Compare(v1.val_, v2.val_);
   }
 };
 
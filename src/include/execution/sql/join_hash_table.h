@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>  // NOLINT
 #include <vector>
 
 #include "common/managed_pointer.h"
@@ -9,6 +10,7 @@
 #include "execution/sql/chaining_hash_table.h"
 #include "execution/sql/concise_hash_table.h"
 #include "execution/sql/memory_pool.h"
+#include "execution/sql/spill_file.h"
 #include "execution/util/chunked_vector.h"
 
 namespace libcount {
@@ -22,7 +24,9 @@ class ExecutionSettings;
 namespace terrier::execution::sql {
 
 class ThreadStateContainer;
+class TupleIdList;
 class Vector;
+class VectorProjection;
 
 /**
  * The main class used to for hash joins. JoinHashTables are bulk-loaded through calls to
@@ -44,6 +48,30 @@ class Vector;
  * In parallel mode, thread-local join hash tables are lazily built and merged in parallel into a
  * global join hash table through a call to JoinHashTable::MergeParallel(). After this call, the
  * global table takes ownership of all thread-local allocated memory and hash index.
+ *
+ * A join hash table can be given a memory budget through JoinHashTable::EnableSpilling(). Once its
+ * buffered build tuples take up the whole budget, they are hash-partitioned and written out to
+ * temporary files, as in a Grace hash join. Partitions that turn out larger than the budget are
+ * split again on further hash bits. Once built, the first partition is loaded and indexed. Probe
+ * tuples of that partition are probed right away; probe tuples of all other partitions are written
+ * out to the probe file of their partition. The remaining partitions are then loaded one at a time,
+ * and joined with the probe tuples read back from their probe file. Strings are spilled as they are
+ * stored in the tuples; their content is not owned by the table, and must outlive it as it always has:
+ *
+ * @code
+ * for (tuple in probe_table) {
+ *   if (jht.IsResident(hash)) {
+ *     // probe
+ *   } else {
+ *     jht.SpillProbeTuple(hash, &tuple);
+ *   }
+ * }
+ * while (jht.NextPartition()) {
+ *   while (jht.ReadProbeTuple(&tuple)) {
+ *     // probe
+ *   }
+ * }
+ * @endcode
  */
 class EXPORT JoinHashTable {
  public:
@@ -53,6 +81,12 @@ class EXPORT JoinHashTable {
   /** Minimum number of expected elements to merge before triggering a parallel merge. */
   static constexpr uint32_t DEFAULT_MIN_SIZE_FOR_PARALLEL_MERGE = 1024;
 
+  /** Number of partitions spilled build tuples are split into, at every level of partitioning. */
+  static constexpr uint32_t NUM_SPILL_PARTITIONS = 16;
+
+  /** Maximum number of times spilled build tuples are partitioned. Deeper partitions are loaded however large. */
+  static constexpr uint32_t MAX_SPILL_LEVELS = 3;
+
   /**
    * Construct a join hash table. All memory allocations are sourced from the injected @em memory,
    * and thus, are ephemeral.
@@ -116,6 +150,69 @@ class EXPORT JoinHashTable {
    */
   void MergeParallel(const ThreadStateContainer *thread_state_container, std::size_t jht_offset);
 
+  /**
+   * Build a bloom filter over the hash values of all tuples in this table, so that probe tuples can be checked against
+   * it before they are joined. Must be called once, after the table has been built or merged.
+   */
+  void BuildBloomFilter();
+
+  /**
+   * Remove the tuples in @em tid_list whose join keys surely have no match in this table, according to the bloom
+   * filter built by BuildBloomFilter(). The keys have to hash to the same values as the keys the table was built with.
+   * @param input The batch of probe tuples.
+   * @param key_cols The indexes of the columns in @em input that make up the join key, in the order they are hashed.
+   * @param[in,out] tid_list The tuples to check, from which tuples that cannot find a join partner are removed.
+   */
+  void FilterProbeBatch(VectorProjection *input, const std::vector<uint32_t> &key_cols, TupleIdList *tid_list) const;
+
+  /**
+   * Allow this table to write build tuples out to disk once they take up more than @em memory_budget
+   * bytes. Must be called before any tuple is inserted. The thread-local tables of a parallel build
+   * must all have spilling enabled if the global table has.
+   * @param memory_budget The number of bytes of build tuples to buffer. Zero means no limit.
+   * @param probe_tuple_size The size of the probe tuples written out by SpillProbeTuple().
+   */
+  void EnableSpilling(uint64_t memory_budget, uint32_t probe_tuple_size);
+
+  /**
+   * @return True if probe tuples with hash value @em hash can be probed now, as their partition is in
+   *         memory; false if they have to be written out through SpillProbeTuple().
+   */
+  bool IsResident(const hash_t hash) const noexcept { return (hash & resident_mask_) == resident_bits_; }
+
+  /**
+   * Write out a probe tuple whose partition is not in memory, to be read back through ReadProbeTuple()
+   * once its partition is loaded. Tuples of partitions without any build tuples are dropped, since they
+   * cannot find a join partner. This function is thread-safe.
+   * @param hash The hash value of the probe tuple.
+   * @param tuple The probe tuple, of the size given to EnableSpilling().
+   */
+  void SpillProbeTuple(hash_t hash, const byte *tuple);
+
+  /**
+   * Load the next spilled partition, to be probed with the probe tuples written out for it.
+   * @return True if a partition was loaded; false if all partitions have been probed, or if the table
+   *         has not spilled.
+   */
+  bool NextPartition();
+
+  /**
+   * Read back the next probe tuple written out for the partition loaded by NextPartition().
+   * @param[out] tuple Where the probe tuple is copied to, of the size given to EnableSpilling().
+   * @return True if a tuple was read; false if there are no more probe tuples for the partition.
+   */
+  bool ReadProbeTuple(byte *tuple);
+
+  /**
+   * @return True if build tuples have been written out to disk; false otherwise.
+   */
+  bool IsSpilled() const noexcept { return spilled_; }
+
+  /**
+   * @return The number of partitions the build tuples are split into; one if the table has not spilled.
+   */
+  uint64_t GetNumPartitions() const noexcept { return spilled_ ? spill_partitions_.size() : 1; }
+
   /**
    * @return The total number of bytes used to materialize tuples. This excludes space required for
    *         the join index.
@@ -141,9 +238,9 @@ class EXPORT JoinHashTable {
   const exec::ExecutionSettings &GetExecutionSettings() const { return exec_settings_; }
 
   /**
-   * @return True if this table uses an early filtering bloom filter; false otherwise.
+   * @return True if the bloom filter over the hashes of this table has been built; false otherwise.
    */
-  bool HasBloomFilter() const { return !bloom_filter_.IsEmpty(); }
+  bool HasBloomFilter() const { return bloom_filter_.IsInitialized(); }
 
   /**
    * @return The total number of elements in the table, including duplicates.
@@ -214,10 +311,54 @@ class EXPORT JoinHashTable {
   template <bool Concurrent>
   void MergeIncomplete(JoinHashTable *source);
 
+  // Spilled build tuples whose hash value has the partition's bits wherever its mask is set.
+  struct SpillPartition {
+    hash_t bits_;
+    hash_t mask_;
+    // How many times the build tuples were partitioned to end up in this partition, minus one.
+    uint32_t level_;
+    uint64_t num_tuples_{0};
+    // After a parallel merge, a partition has one file from each thread-local table that spilled.
+    std::vector<std::unique_ptr<SpillFile>> files_;
+    // The probe tuples written out until the partition is loaded.
+    std::unique_ptr<SpillFile> probe_file_;
+
+    // The file tuples are written to.
+    SpillFile *GetWriteFile();
+    // The number of bytes spilled to this partition, which is about how much memory it takes to load.
+    uint64_t GetSize() const;
+  };
+
+  // Create the partitions that tuples of the given partition are split into, or the first level of
+  // partitions if there is no parent.
+  static std::vector<SpillPartition> MakeSpillPartitions(const SpillPartition *parent);
+
+  // Write out all tuples buffered in the given entries to the partitions, which are of the same level.
+  void SpillEntries(util::ChunkedVector<MemoryPoolAllocator<byte>> *entries,
+                    std::vector<SpillPartition> *partitions) const;
+
+  // Merge the thread-local tables by spilling all their tuples.
+  void MergeSpilled(const std::vector<JoinHashTable *> &tl_join_tables);
+
+  // Write out all remaining buffered tuples and split the partitions that are too large.
+  void FinishSpilling();
+
+  // Read the next tuple in the file into the buffered entries. Returns false at the end of the file.
+  bool ReadSpilledEntry(SpillFile *file);
+
+  // Replace the buffered entries with the tuples of the given partition.
+  void LoadSpillPartition(const SpillPartition &partition);
+
+  // Load and index the partition at the given index, making its probe tuples resident.
+  void MakeResident(uint64_t partition_idx);
+
  private:
   // The execution context to run with.
   const exec::ExecutionSettings &exec_settings_;
 
+  // The memory pool the bloom filter is allocated from.
+  MemoryPool *memory_;
+
   // The vector where we store the build-side input.
   util::ChunkedVector<MemoryPoolAllocator<byte>> entries_;
 
@@ -248,6 +389,36 @@ class EXPORT JoinHashTable {
 
   // MemoryTracker
   common::ManagedPointer<MemoryTracker> tracker_;
+
+  // The number of bytes of build tuples to buffer before spilling; zero if spilling is disabled.
+  uint64_t memory_budget_{0};
+
+  // The number of buffered entries past which they are spilled.
+  uint64_t spill_threshold_;
+
+  // Have build tuples been spilled?
+  bool spilled_{false};
+
+  // While building, the first level of partitions. Once built, the partitions to probe, one at a time.
+  std::vector<SpillPartition> spill_partitions_;
+
+  // Maps the partitioning hash bits of a probe tuple to the index of its partition, or to NO_PARTITION if
+  // the partition has no build tuples.
+  std::vector<uint32_t> partition_directory_;
+
+  // Latches protecting the probe files of the partitions, one for each partition. These are held while a full buffer
+  // of a probe file is written out to disk, so threads that have to wait on them block rather than spin.
+  std::vector<std::mutex> probe_latches_;
+
+  // The size of the probe tuples that are written out.
+  uint32_t probe_tuple_size_{0};
+
+  // The index of the partition in memory.
+  uint64_t resident_partition_{0};
+
+  // The hash bits of the probe tuples that can be probed now, and the mask selecting them.
+  hash_t resident_bits_{0};
+  hash_t resident_mask_{0};
 };
 
 // ---------------------------------------------------------
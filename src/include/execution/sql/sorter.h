@@ -1,16 +1,22 @@
 #pragma once
 
+#include <exception>
 #include <iterator>
+#include <limits>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "catalog/schema.h"
 #include "common/macros.h"
+#include "common/worker_pool.h"
 #include "execution/sql/memory_pool.h"
+#include "execution/sql/spill_file.h"
 #include "execution/util/chunked_vector.h"
 
 namespace terrier::execution::sql {
 
+class SortedRunMerger;
 class ThreadStateContainer;
 class VectorProjection;
 class VectorProjectionIterator;
@@ -63,6 +69,15 @@ class VectorProjectionIterator;
  * thread-local Sorter, but <b>without calling</b> Sorter::Sort(). When all insertions are complete
  * across all threads, the primary thread uses Sorter::SortParallel() or Sorter::SortTopKParallel()
  * for parallel sort and parallel Top-K, respectively.
+ *
+ * A sorter can be given a memory budget through Sorter::EnableSpilling(), turning it into an
+ * external sort. Whenever the buffered tuples take up half of the budget, they are sorted into a
+ * run that is written out to a temporary file by the sorter's background writer thread, while the
+ * next run is filled with the other half. Runs are merged level by level: once there are
+ * MAX_MERGE_FAN_IN runs of the same level on disk, the writer merges them into one run of the next
+ * level. Sorting then only sorts the last, in-memory, run. A
+ * SorterIterator merges all runs with a loser tree as it goes, reading the run files a block at a
+ * time. Top-K sorts never spill.
  */
 class EXPORT Sorter {
  public:
@@ -76,6 +91,12 @@ class EXPORT Sorter {
   static constexpr uint64_t DEFAULT_MIN_TUPLES_FOR_PARALLEL_SORT = 10000;
 #endif
 
+  /**
+   * Maximum number of runs merged at once, including the in-memory run. Runs in excess of this are
+   * merged ahead of time.
+   */
+  static constexpr uint32_t MAX_MERGE_FAN_IN = 64;
+
   /**
    * The comparison function used to sort tuples in a Sorter.
    */
@@ -100,6 +121,14 @@ class EXPORT Sorter {
    */
   DISALLOW_COPY_AND_MOVE(Sorter);
 
+  /**
+   * Allow this sorter to write sorted runs of its tuples out to disk once they take up half of
+   * @em memory_budget bytes, the other half holding the run that is being written out. Must be
+   * called before any tuple is inserted.
+   * @param memory_budget The number of bytes the tuples of this sorter may take up in memory.
+   */
+  void EnableSpilling(uint64_t memory_budget);
+
   /**
    * Allocate room for a tuple in this sorter. It's the callers responsibility to fill in the
    * contents.
@@ -151,9 +180,9 @@ class EXPORT Sorter {
   void SortTopKParallel(const ThreadStateContainer *thread_state_container, uint32_t sorter_offset, uint64_t top_k);
 
   /**
-   * @return The number of tuples currently in this sorter.
+   * @return The number of tuples currently in this sorter, including those spilled to disk.
    */
-  uint64_t GetTupleCount() const noexcept { return tuples_.size(); }
+  uint64_t GetTupleCount() const noexcept { return tuples_.size() + num_spilled_tuples_; }
 
   /**
    * @return True if this sorter contains no tuples; false otherwise.
@@ -165,6 +194,11 @@ class EXPORT Sorter {
    */
   bool IsSorted() const noexcept { return sorted_; }
 
+  /**
+   * @return True if some of this sorter's tuples have been written out to disk; false otherwise.
+   */
+  bool IsSpilled() const noexcept { return !spilled_runs_.empty(); }
+
  private:
   // Build a max heap from the tuples currently stored in the sorter instance
   void BuildHeap();
@@ -173,6 +207,22 @@ class EXPORT Sorter {
   // property
   void HeapSiftDown();
 
+  // Sort the buffered tuples and start writing them out as a new run
+  void SpillRun();
+
+  // Wait for the run being written out, if any, to be complete
+  void FinishPendingWrite();
+
+  // Merge the given sorted runs into a single one
+  void MergeRuns(const std::vector<std::unique_ptr<SpillFile>> &runs, SpillFile *merged_run,
+                 std::size_t tuple_size) const;
+
+  // Merge spilled runs until they, with the in-memory run, are no more than MAX_MERGE_FAN_IN
+  void MergeSpilledRuns();
+
+  // Sort the thread-local sorters into spilled runs and take them over
+  void SortParallelSpilled(const std::vector<Sorter *> &tl_sorters);
+
  private:
   friend class SorterIterator;
   friend class SorterVectorIterator;
@@ -194,13 +244,42 @@ class EXPORT Sorter {
 
   // Flag indicating if the contents of the sorter have been sorted
   bool sorted_;
+
+  // The number of buffered tuples at which they are spilled as a run
+  uint64_t spill_threshold_{std::numeric_limits<uint64_t>::max()};
+
+  // The tuples of the run being written out, swapped with the buffered ones on each spill
+  decltype(tuple_storage_) spill_tuple_storage_;
+  MemPoolVector<const byte *> spill_tuples_;
+
+  // The sorted runs written out to disk, and the total number of tuples in them
+  std::vector<std::unique_ptr<SpillFile>> spilled_runs_;
+  uint64_t num_spilled_tuples_{0};
+
+  // The number of merges that went into each spilled run, in the same order
+  std::vector<uint32_t> spilled_run_levels_;
+
+  // The runs the writer merges after writing out the last run, in order, and the run each is merged into
+  std::vector<std::pair<std::vector<std::unique_ptr<SpillFile>>, SpillFile *>> pending_merges_;
+
+  // The error raised by the writer, if any, rethrown by the next wait for it
+  std::exception_ptr write_error_;
+
+  // The single thread writing out runs in the background, started with the first one. It must be
+  // declared last, so that it is joined before anything it writes out is destroyed.
+  bool run_writer_started_{false};
+  common::WorkerPool run_writer_{1, {}};
 };
 
 /**
  * An iterator over the elements in a sorter instance.
+ *
+ * If the sorter has spilled, the iterator merges its runs in batches of rows. A row is then only
+ * valid until the iterator has moved past the batch following it, i.e., for at least
+ * K_DEFAULT_VECTOR_SIZE more rows. Only one iterator may run over a spilled sorter at a time.
  */
 class SorterIterator {
-  using IteratorType = decltype(Sorter::tuples_)::const_iterator;
+  using IteratorType = const byte *const *;
 
  public:
   /**
@@ -209,6 +288,16 @@ class SorterIterator {
    */
   explicit SorterIterator(const Sorter &sorter);
 
+  /**
+   * This class cannot be copied or moved.
+   */
+  DISALLOW_COPY_AND_MOVE(SorterIterator);
+
+  /**
+   * Destructor.
+   */
+  ~SorterIterator();
+
   /**
    * @return True if the iterator has more data; false otherwise.
    */
@@ -217,7 +306,11 @@ class SorterIterator {
   /**
    * Advance the iterator by one tuple.
    */
-  void Next() { ++iter_; }
+  void Next() {
+    if (++iter_ == end_ && num_unmerged_ > 0) {
+      MergeBatch();
+    }
+  }
 
   /**
    * Advance the iterator by @em n rows. If there are fewer than @em n rows remaining in this
@@ -229,7 +322,7 @@ class SorterIterator {
   /**
    * @return The number of tuples remaining in the iterator.
    */
-  uint64_t NumRemaining() const { return std::distance(iter_, end_); }
+  uint64_t NumRemaining() const { return std::distance(iter_, end_) + num_unmerged_; }
 
   /**
    * @return A pointer to the current row. It assumed the called has checked the iterator is valid.
@@ -265,11 +358,24 @@ class SorterIterator {
     return *this;
   }
 
+ private:
+  // Merge the next batch of rows of a spilled sorter
+  void MergeBatch();
+
  private:
   // The current iterator position
   IteratorType iter_;
   // The ending iterator position
-  const IteratorType end_;
+  IteratorType end_;
+
+  // The merge of the sorter's runs, if it has spilled, and the number of rows it has yet to produce
+  std::unique_ptr<SortedRunMerger> merger_;
+  uint64_t num_unmerged_{0};
+  std::size_t tuple_size_{0};
+  // The rows of the last two merged batches, filled in turn
+  std::unique_ptr<byte[]> batch_storage_;
+  std::vector<const byte *> batch_rows_;
+  uint32_t batch_idx_{0};
 };
 
 /**
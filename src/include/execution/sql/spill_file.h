@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include "common/macros.h"
+#include "execution/util/execution_common.h"
+#include "execution/util/file.h"
+
+namespace terrier::execution::sql {
+
+/**
+ * A temporary file that operators write their data out to when it no longer fits in memory, to read it back later.
+ * Writes and reads go through a buffer, so that the file can be filled and read back a few bytes at a time. The file is
+ * removed from the file system as soon as it is created, and its space is reclaimed when the SpillFile is destroyed.
+ *
+ * A spill file is written first, then rewound and read back, as many times as needed:
+ *
+ * @code
+ * SpillFile file;
+ * for (tuple in input) {
+ *   file.Write(&tuple, sizeof(tuple));
+ * }
+ * file.Rewind();
+ * while (file.Read(&tuple, sizeof(tuple))) {
+ *   ...
+ * }
+ * @endcode
+ */
+class EXPORT SpillFile {
+ public:
+  /** Size of the buffer that writes and reads go through. */
+  static constexpr uint32_t BUFFER_SIZE = 64 * 1024;
+
+  /**
+   * Create a new, empty, temporary file.
+   * @throw ExecutionException If the file cannot be created.
+   */
+  SpillFile();
+
+  /**
+   * This class cannot be copied or moved.
+   */
+  DISALLOW_COPY_AND_MOVE(SpillFile);
+
+  /**
+   * Close and remove the file.
+   */
+  ~SpillFile();
+
+  /**
+   * Append @em size bytes of @em data to the file. The file must not have been rewound yet.
+   * @param data The data to write.
+   * @param size The number of bytes to write.
+   * @throw ExecutionException If the file cannot be written to.
+   */
+  void Write(const void *data, std::size_t size);
+
+  /**
+   * Finish writing, if the file is still being written, and position the file at its start for reading.
+   * @throw ExecutionException If the buffered data cannot be written out.
+   */
+  void Rewind();
+
+  /**
+   * Read the next @em size bytes of the file into @em data. The file must have been rewound.
+   * @param[out] data Where the read bytes are written to. Must be large enough to store @em size bytes.
+   * @param size The number of bytes to read.
+   * @return True if the bytes were read; false if the end of the file has been reached.
+   * @throw ExecutionException If the file cannot be read, or ends within the requested bytes.
+   */
+  bool Read(void *data, std::size_t size);
+
+  /**
+   * @return The total number of bytes written to the file.
+   */
+  uint64_t GetSize() const noexcept { return size_; }
+
+ private:
+  // Write out all buffered bytes.
+  void FlushBuffer();
+
+  // Read the next bytes of the file into the buffer. Returns false at the end of the file.
+  bool FillBuffer();
+
+ private:
+  // The temporary file.
+  util::File file_;
+  // The write or read buffer.
+  std::unique_ptr<std::byte[]> buffer_;
+  // The position of the next byte to write to or read from the buffer.
+  uint32_t buffer_pos_{0};
+  // The number of valid bytes in the buffer when reading.
+  uint32_t buffer_end_{0};
+  // The total number of bytes written.
+  uint64_t size_{0};
+  // Has the file been rewound for reading?
+  bool reading_{false};
+};
+
+}  // namespace terrier::execution::sql
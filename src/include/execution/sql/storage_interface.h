@@ -1,5 +1,6 @@
 #pragma once
 
+#include <utility>
 #include <vector>
 
 #include "catalog/catalog_defs.h"
@@ -77,6 +78,28 @@ class EXPORT StorageInterface {
    */
   storage::ProjectedRow *GetIndexPR(catalog::index_oid_t index_oid);
 
+  /**
+   * Hands out the table PR of the next tuple of a batch insert. Unlike GetTablePR, nothing is staged until the batch is
+   * inserted by TableInsertBatch, so the PRs of a batch all stay valid until then.
+   * @return The table PR of the next tuple in the batch.
+   */
+  storage::ProjectedRow *GetTablePRForBatch();
+
+  /**
+   * Hands out the PR for the key of the latest tuple of a batch insert in the given index. The keys are inserted into
+   * the index by TableInsertBatch, once the tuples have their slots.
+   * @param index_oid OID of the index to access.
+   * @return The index PR of the latest tuple in the batch.
+   */
+  storage::ProjectedRow *GetIndexPRForBatch(catalog::index_oid_t index_oid);
+
+  /**
+   * Inserts all tuples of the batch into the table, claiming consecutive slots where possible, and then inserts their
+   * keys into each index, in key order. The batch is empty afterwards.
+   * @return Whether insertion was successful, false if a unique index already had one of the keys.
+   */
+  bool TableInsertBatch();
+
   /**
    * Delete item from the current index.
    * @param table_tuple_slot slot corresponding to the item.
@@ -103,6 +126,19 @@ class EXPORT StorageInterface {
    */
   bool IndexInsertWithTuple(storage::TupleSlot table_tuple_slot, bool unique);
 
+  /**
+   * Sets aside the key in the current index PR, to be loaded into the current index by IndexBulkLoadFinish
+   * @param table_tuple_slot tuple slot the key belongs to
+   */
+  void IndexBulkLoadAdd(storage::TupleSlot table_tuple_slot);
+
+  /**
+   * Loads all keys set aside by IndexBulkLoadAdd into the current index at once, which must not be visible to any
+   * other txn yet, as in CREATE INDEX.
+   * @return Whether loading was successful, false if the index is unique and a key is repeated.
+   */
+  bool IndexBulkLoadFinish();
+
  protected:
   /**
    * Oid of the table being accessed.
@@ -154,6 +190,30 @@ class EXPORT StorageInterface {
    * Current index being accessed.
    */
   common::ManagedPointer<storage::index::Index> curr_index_{nullptr};
+
+ private:
+  // Keys of the tuples of a batch insert in one index
+  struct BatchIndexPRs {
+    common::ManagedPointer<storage::index::Index> index_;
+    bool unique_;
+    std::vector<storage::ProjectedRow *> prs_;
+  };
+
+  // PRs of the tuples of the batch insert that is being built, and their keys in each index
+  std::vector<storage::ProjectedRow *> batch_table_prs_;
+  std::vector<BatchIndexPRs> batch_index_prs_;
+  // Buffers handed out for the batch PRs, with their sizes, given back to the memory pool after the batch
+  std::vector<std::pair<void *, uint32_t>> batch_buffers_;
+
+  // Keys set aside for a bulk load, one index PR after another, each padded to a multiple of 8 bytes, and their slots
+  std::vector<uint64_t> bulk_load_keys_;
+  std::vector<storage::TupleSlot> bulk_load_slots_;
+
+  // Allocates a buffer for a batch PR and initializes the PR in it
+  storage::ProjectedRow *AllocateBatchPR(const storage::ProjectedRowInitializer &initializer);
+
+  // Gives all buffers of the batch back to the memory pool
+  void FreeBatch();
 };
 }  // namespace sql
 }  // namespace terrier::execution
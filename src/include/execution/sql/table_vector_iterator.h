@@ -125,6 +125,13 @@ class EXPORT TableVectorIterator {
 
   VectorProjection vector_projection_;
 
+  // The frozen block the current vector projection references in place, if any. We hold an in-place read on it until
+  // the iterator moves past the projection.
+  storage::RawBlock *in_place_block_ = nullptr;
+
+  // Release the in-place read on the block referenced by the current vector projection, if any.
+  void ReleaseInPlaceBlock();
+
   // An iterator over the currently active projection.
   VectorProjectionIterator vector_projection_iterator_;
 
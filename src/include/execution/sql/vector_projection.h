@@ -281,6 +281,13 @@ class EXPORT VectorProjection {
    */
   void Reset(uint64_t num_tuples);
 
+  /**
+   * Copy the data of child vectors that reference memory outside this projection, such as a block read in place, into
+   * their data chunk in this projection, so that the projection no longer changes when that memory does. The size,
+   * NULLs and filter of the projection are kept. Does nothing for projections that do not own any data.
+   */
+  void Materialize();
+
   /**
    * Packing (or compressing) a projection rearranges contained vector data by contiguously storing
    * only active vector elements, removing any filtered TID list.
@@ -379,8 +386,24 @@ class EXPORT VectorProjection {
   // Propagate the active TID list to child vectors, if necessary.
   void RefreshFilteredTupleIdList();
 
+  // Point every child vector at its chunk of the owned buffer, if any, and size it to num_tuples.
+  void ResetColumns(uint64_t num_tuples);
+
   friend class storage::DataTable;
 
+  /**
+   * Should only be used by storage::DataTable. Clears any filter and sizes the projection to its full capacity so that
+   * a scan can fill it, and empties the owned TID list so that the scan can mark the rows it fills as visible.
+   */
+  void PrepareForScan();
+
+  /**
+   * Should only be used by storage::DataTable. Sizes the projection to the number of rows filled by the scan, and
+   * makes only the rows marked in the owned TID list visible.
+   * @param num_tuples the number of rows filled by the scan
+   */
+  void FinishScan(uint64_t num_tuples);
+
   /**
    * Should only be used by storage::DataTable.
    * @param row_offset the row offset within the ProjectedColumns to look at
@@ -332,6 +332,10 @@ class BytecodeEmitter {
   /** Insert a filter flavor into the filter manager builder. */
   void EmitFilterManagerInsertFilter(LocalVar filter_manager, FunctionId func);
 
+  /** Filter a batch of probe tuples through the bloom filter of the given join hash table. */
+  void EmitJoinHashTableFilterProbe(LocalVar join_hash_table, LocalVar input_batch, LocalVar tid_list,
+                                    uint32_t num_keys, LocalVar key_cols);
+
   /** Lookup a single entry in the aggregation hash table. */
   void EmitAggHashTableLookup(LocalVar dest, LocalVar agg_ht, LocalVar hash, FunctionId key_eq_fn, LocalVar arg);
 
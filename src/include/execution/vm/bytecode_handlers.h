@@ -444,7 +444,7 @@ VM_OP_HOT void OpHashCombine(terrier::hash_t *hash_val, terrier::hash_t new_hash
 // ---------------------------------------------------------
 
 VM_OP void OpFilterManagerInit(terrier::execution::sql::FilterManager *filter_manager,
-                               const terrier::execution::exec::ExecutionSettings &exec_settings);
+                               const terrier::execution::exec::ExecutionSettings &exec_settings, void *opaque_context);
 
 VM_OP void OpFilterManagerStartNewClause(terrier::execution::sql::FilterManager *filter_manager);
 
@@ -741,6 +741,8 @@ VM_OP void OpAggregationHashTableInit(terrier::execution::sql::AggregationHashTa
                                       terrier::execution::exec::ExecutionContext *exec_ctx,
                                       terrier::execution::sql::MemoryPool *memory, uint32_t payload_size);
 
+VM_OP void OpAggregationHashTableEnableSpilling(terrier::execution::sql::AggregationHashTable *agg_hash_table);
+
 VM_OP_HOT void OpAggregationHashTableAllocTuple(terrier::byte **result,
                                                 terrier::execution::sql::AggregationHashTable *agg_hash_table,
                                                 const terrier::hash_t hash_val) {
@@ -1200,6 +1202,33 @@ VM_OP void OpJoinHashTableBuildParallel(terrier::execution::sql::JoinHashTable *
                                         terrier::execution::sql::ThreadStateContainer *thread_state_container,
                                         uint32_t jht_offset);
 
+VM_OP void OpJoinHashTableBuildBloomFilter(terrier::execution::sql::JoinHashTable *join_hash_table);
+
+VM_OP void OpJoinHashTableFilterProbe(const terrier::execution::sql::JoinHashTable *join_hash_table,
+                                      terrier::execution::sql::VectorProjection *input_batch,
+                                      terrier::execution::sql::TupleIdList *tid_list, uint32_t num_keys,
+                                      const uint32_t *key_cols);
+
+VM_OP void OpJoinHashTableEnableSpilling(terrier::execution::sql::JoinHashTable *join_hash_table,
+                                         uint32_t probe_tuple_size);
+
+VM_OP_HOT void OpJoinHashTableIsResident(bool *result, const terrier::execution::sql::JoinHashTable *join_hash_table,
+                                         const terrier::hash_t hash_val) {
+  *result = join_hash_table->IsResident(hash_val);
+}
+
+VM_OP_HOT void OpJoinHashTableSpillProbeTuple(terrier::execution::sql::JoinHashTable *join_hash_table,
+                                              const terrier::hash_t hash_val, const terrier::byte *probe_tuple) {
+  join_hash_table->SpillProbeTuple(hash_val, probe_tuple);
+}
+
+VM_OP void OpJoinHashTableNextPartition(bool *result, terrier::execution::sql::JoinHashTable *join_hash_table);
+
+VM_OP_HOT void OpJoinHashTableReadProbeTuple(bool *result, terrier::execution::sql::JoinHashTable *join_hash_table,
+                                             terrier::byte *probe_tuple) {
+  *result = join_hash_table->ReadProbeTuple(probe_tuple);
+}
+
 VM_OP_HOT void OpJoinHashTableLookup(terrier::execution::sql::JoinHashTable *join_hash_table,
                                      terrier::execution::sql::HashTableEntryIterator *ht_entry_iter,
                                      const terrier::hash_t hash_val) {
@@ -1225,6 +1254,9 @@ VM_OP_HOT void OpHashTableEntryIteratorGetRow(const terrier::byte **row,
 VM_OP void OpSorterInit(terrier::execution::sql::Sorter *sorter, terrier::execution::sql::MemoryPool *memory,
                         terrier::execution::sql::Sorter::ComparisonFunction cmp_fn, uint32_t tuple_size);
 
+VM_OP void OpSorterEnableSpilling(terrier::execution::sql::Sorter *sorter,
+                                  terrier::execution::exec::ExecutionContext *exec_ctx);
+
 VM_OP_HOT void OpSorterAllocTuple(terrier::byte **result, terrier::execution::sql::Sorter *sorter) {
   *result = sorter->AllocInputTuple();
 }
@@ -1855,6 +1887,22 @@ VM_OP void OpStorageInterfaceIndexInsertWithSlot(bool *result,
 VM_OP void OpStorageInterfaceIndexDelete(terrier::execution::sql::StorageInterface *storage_interface,
                                          terrier::storage::TupleSlot *tuple_slot);
 
+VM_OP void OpStorageInterfaceGetTablePRForBatch(terrier::storage::ProjectedRow **pr_result,
+                                                terrier::execution::sql::StorageInterface *storage_interface);
+
+VM_OP void OpStorageInterfaceGetIndexPRForBatch(terrier::storage::ProjectedRow **pr_result,
+                                                terrier::execution::sql::StorageInterface *storage_interface,
+                                                uint32_t index_oid);
+
+VM_OP void OpStorageInterfaceTableInsertBatch(bool *result,
+                                              terrier::execution::sql::StorageInterface *storage_interface);
+
+VM_OP void OpStorageInterfaceIndexBulkLoadAdd(terrier::execution::sql::StorageInterface *storage_interface,
+                                              terrier::storage::TupleSlot *tuple_slot);
+
+VM_OP void OpStorageInterfaceIndexBulkLoadFinish(bool *result,
+                                                 terrier::execution::sql::StorageInterface *storage_interface);
+
 VM_OP void OpStorageInterfaceFree(terrier::execution::sql::StorageInterface *storage_interface);
 
 // ---------------------------------
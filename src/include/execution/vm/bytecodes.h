@@ -186,7 +186,7 @@ namespace terrier::execution::vm {
   F(VPISetStringNull, OperandType::Local, OperandType::Local, OperandType::UImm4)                                     \
                                                                                                                       \
   /* Filter Manager */                                                                                                \
-  F(FilterManagerInit, OperandType::Local, OperandType::Local)                                                        \
+  F(FilterManagerInit, OperandType::Local, OperandType::Local, OperandType::Local)                                    \
   F(FilterManagerStartNewClause, OperandType::Local)                                                                  \
   F(FilterManagerInsertFilter, OperandType::Local, OperandType::FunctionId)                                           \
   F(FilterManagerRunFilters, OperandType::Local, OperandType::Local, OperandType::Local)                              \
@@ -320,6 +320,7 @@ namespace terrier::execution::vm {
                                                                                                                       \
   /* Aggregation Hash Table */                                                                                        \
   F(AggregationHashTableInit, OperandType::Local, OperandType::Local, OperandType::Local, OperandType::Local)         \
+  F(AggregationHashTableEnableSpilling, OperandType::Local)                                                           \
   F(AggregationHashTableAllocTuple, OperandType::Local, OperandType::Local, OperandType::Local)                       \
   F(AggregationHashTableAllocTuplePartitioned, OperandType::Local, OperandType::Local, OperandType::Local)            \
   F(AggregationHashTableLinkHashTableEntry, OperandType::Local, OperandType::Local)                                   \
@@ -436,6 +437,14 @@ namespace terrier::execution::vm {
   F(JoinHashTableAllocTuple, OperandType::Local, OperandType::Local, OperandType::Local)                              \
   F(JoinHashTableBuild, OperandType::Local)                                                                           \
   F(JoinHashTableBuildParallel, OperandType::Local, OperandType::Local, OperandType::Local)                           \
+  F(JoinHashTableBuildBloomFilter, OperandType::Local)                                                                \
+  F(JoinHashTableFilterProbe, OperandType::Local, OperandType::Local, OperandType::Local, OperandType::UImm4,         \
+    OperandType::Local)                                                                                               \
+  F(JoinHashTableEnableSpilling, OperandType::Local, OperandType::Local)                                              \
+  F(JoinHashTableIsResident, OperandType::Local, OperandType::Local, OperandType::Local)                              \
+  F(JoinHashTableSpillProbeTuple, OperandType::Local, OperandType::Local, OperandType::Local)                         \
+  F(JoinHashTableNextPartition, OperandType::Local, OperandType::Local)                                               \
+  F(JoinHashTableReadProbeTuple, OperandType::Local, OperandType::Local, OperandType::Local)                          \
   F(JoinHashTableLookup, OperandType::Local, OperandType::Local, OperandType::Local)                                  \
   F(JoinHashTableFree, OperandType::Local)                                                                            \
   F(HashTableEntryIteratorHasNext, OperandType::Local, OperandType::Local)                                            \
@@ -443,6 +452,7 @@ namespace terrier::execution::vm {
                                                                                                                       \
   /* Sorting */                                                                                                       \
   F(SorterInit, OperandType::Local, OperandType::Local, OperandType::FunctionId, OperandType::Local)                  \
+  F(SorterEnableSpilling, OperandType::Local, OperandType::Local)                                                     \
   F(SorterAllocTuple, OperandType::Local, OperandType::Local)                                                         \
   F(SorterAllocTupleTopK, OperandType::Local, OperandType::Local, OperandType::Local)                                 \
   F(SorterAllocTupleTopKFinish, OperandType::Local, OperandType::Local)                                               \
@@ -542,6 +552,11 @@ namespace terrier::execution::vm {
   F(StorageInterfaceIndexInsertWithSlot, OperandType::Local, OperandType::Local, OperandType::Local,                  \
     OperandType::Local)                                                                                               \
   F(StorageInterfaceIndexDelete, OperandType::Local, OperandType::Local)                                              \
+  F(StorageInterfaceGetTablePRForBatch, OperandType::Local, OperandType::Local)                                       \
+  F(StorageInterfaceGetIndexPRForBatch, OperandType::Local, OperandType::Local, OperandType::Local)                   \
+  F(StorageInterfaceTableInsertBatch, OperandType::Local, OperandType::Local)                                         \
+  F(StorageInterfaceIndexBulkLoadAdd, OperandType::Local, OperandType::Local)                                         \
+  F(StorageInterfaceIndexBulkLoadFinish, OperandType::Local, OperandType::Local)                                      \
   F(StorageInterfaceFree, OperandType::Local)                                                                         \
                                                                                                                       \
   /* Trig functions */                                                                                                \
@@ -9,13 +9,23 @@
 #include "common/action_context.h"
 #include "common/managed_pointer.h"
 #include "metrics/metrics_thread.h"
+#include "network/itp/itp_command_factory.h"
+#include "network/itp/itp_protocol_interpreter.h"
 #include "network/postgres/postgres_command_factory.h"
 #include "network/postgres/postgres_protocol_interpreter.h"
 #include "network/terrier_server.h"
 #include "optimizer/statistics/stats_storage.h"
 #include "settings/settings_manager.h"
 #include "settings/settings_param.h"
+#include "storage/access_observer.h"
+#include "storage/block_compactor.h"
+#include "storage/block_compactor_thread.h"
 #include "storage/garbage_collector_thread.h"
+#include "storage/recovery/checkpoint_manager.h"
+#include "storage/recovery/checkpoint_thread.h"
+#include "storage/recovery/recovery_manager.h"
+#include "storage/recovery/replication_log_provider.h"
+#include "storage/write_ahead_log/log_shipper.h"
 #include "transaction/deferred_action_manager.h"
 #include "transaction/transaction_manager.h"
 
@@ -109,7 +119,7 @@ class DBMain {
   };
 
   /**
-   * BlockStore and GarbageCollector
+   * BlockStore, GarbageCollector, and BlockCompactor
    */
   class StorageLayer {
    public:
@@ -117,19 +127,36 @@ class DBMain {
      * @param txn_layer arguments to the GarbageCollector
      * @param block_store_size_limit argument to the BlockStore
      * @param block_store_reuse_limit argument to the BlockStore
+     * @param block_store_huge_page_size argument to the BlockStore's BlockAllocator
+     * @param block_store_numa_aware argument to the BlockStore's BlockAllocator
      * @param use_gc enable GarbageCollector
+     * @param gc_num_threads number of threads the GarbageCollector unlinks transactions with
+     * @param use_compaction enable BlockCompactor and attach an AccessObserver to the GarbageCollector
+     * @param compaction_cold_threshold argument to the AccessObserver
      * @param log_manager needed for safe destruction of StorageLayer
      */
     StorageLayer(const common::ManagedPointer<TransactionLayer> txn_layer, const uint64_t block_store_size_limit,
-                 const uint64_t block_store_reuse_limit, const bool use_gc,
+                 const uint64_t block_store_reuse_limit, const uint32_t block_store_huge_page_size,
+                 const bool block_store_numa_aware, const bool use_gc, const uint32_t gc_num_threads,
+                 const bool use_compaction, const uint64_t compaction_cold_threshold,
                  const common::ManagedPointer<storage::LogManager> log_manager)
         : deferred_action_manager_(txn_layer->GetDeferredActionManager()), log_manager_(log_manager) {
-      if (use_gc)
-        garbage_collector_ = std::make_unique<storage::GarbageCollector>(txn_layer->GetTimestampManager(),
-                                                                         txn_layer->GetDeferredActionManager(),
-                                                                         txn_layer->GetTransactionManager(), DISABLED);
+      if (use_compaction) {
+        block_compactor_ = std::make_unique<storage::BlockCompactor>();
+        access_observer_ = std::make_unique<storage::AccessObserver>(block_compactor_.get(), compaction_cold_threshold);
+      }
+
+      if (use_gc) {
+        garbage_collector_ = std::make_unique<storage::GarbageCollector>(
+            txn_layer->GetTimestampManager(), txn_layer->GetDeferredActionManager(), txn_layer->GetTransactionManager(),
+            access_observer_.get());
+        garbage_collector_->SetNumWorkers(gc_num_threads);
+      }
 
-      block_store_ = std::make_unique<storage::BlockStore>(block_store_size_limit, block_store_reuse_limit);
+      block_store_ = std::make_unique<storage::BlockStore>(
+          block_store_size_limit, block_store_reuse_limit,
+          storage::BlockAllocator(block_store_huge_page_size, block_store_numa_aware),
+          storage::BLOCK_STORE_MAGAZINE_SIZE);
     }
 
     ~StorageLayer() {
@@ -155,9 +182,19 @@ class DBMain {
      */
     common::ManagedPointer<storage::BlockStore> GetBlockStore() const { return common::ManagedPointer(block_store_); }
 
+    /**
+     * @return ManagedPointer to the component, can be nullptr if disabled
+     */
+    common::ManagedPointer<storage::BlockCompactor> GetBlockCompactor() const {
+      return common::ManagedPointer(block_compactor_);
+    }
+
    private:
-    // Order currently does not matter in this layer
+    // The GarbageCollector reports to the AccessObserver, which feeds the BlockCompactor, so those two need to outlive
+    // it. Otherwise order does not matter in this layer.
     std::unique_ptr<storage::BlockStore> block_store_;
+    std::unique_ptr<storage::BlockCompactor> block_compactor_;
+    std::unique_ptr<storage::AccessObserver> access_observer_;
     std::unique_ptr<storage::GarbageCollector> garbage_collector_;
 
     // External dependencies for this layer
@@ -255,6 +292,70 @@ class DBMain {
     std::unique_ptr<network::TerrierServer> server_;
   };
 
+  /**
+   * Makes this system a replica of a primary that ships its log here (@see LogShipper). The log arrives over the ITP
+   * protocol on its own server, and a RecoveryManager replays it as it arrives until the primary stops replication. The
+   * replica serves reads through snapshot transactions in the meantime, which see the primary's transactions once they
+   * have been replayed. A transaction is replayed once the primary commits another transaction that started after it
+   * (or once replication stops), so an idle primary can leave the replica behind by its last few transactions.
+   */
+  class ReplicationLayer {
+   public:
+    /**
+     * Starts receiving and replaying the log
+     * @param thread_registry argument to the TerrierServer and RecoveryManager
+     * @param txn_layer arguments to the RecoveryManager
+     * @param storage_layer arguments to the RecoveryManager
+     * @param catalog catalog to replay the log into, which must not have any databases yet
+     * @param port port to receive the log on
+     */
+    ReplicationLayer(common::ManagedPointer<common::DedicatedThreadRegistry> thread_registry,
+                     common::ManagedPointer<TransactionLayer> txn_layer,
+                     common::ManagedPointer<StorageLayer> storage_layer,
+                     common::ManagedPointer<catalog::Catalog> catalog, uint16_t port);
+
+    /**
+     * Stops replication, after replaying what has been received so far
+     */
+    ~ReplicationLayer();
+
+    /**
+     * Blocks until the primary stops replication and everything it shipped has been replayed
+     */
+    void WaitForReplicationToFinish();
+
+    /**
+     * @return ManagedPointer to the component
+     */
+    common::ManagedPointer<storage::ReplicationLogProvider> GetLogProvider() const {
+      return common::ManagedPointer(log_provider_);
+    }
+
+    /**
+     * @return ManagedPointer to the component
+     */
+    common::ManagedPointer<storage::RecoveryManager> GetRecoveryManager() const {
+      return common::ManagedPointer(recovery_manager_);
+    }
+
+    /**
+     * @return ManagedPointer to the component
+     */
+    common::ManagedPointer<network::TerrierServer> GetServer() const { return common::ManagedPointer(server_); }
+
+   private:
+    // Order matters here for destruction order
+    std::unique_ptr<storage::ReplicationLogProvider> log_provider_;
+    std::unique_ptr<storage::RecoveryManager> recovery_manager_;
+    // Only carries replication messages, so it needs none of the components that queries do
+    std::unique_ptr<trafficcop::TrafficCop> traffic_cop_;
+    std::unique_ptr<network::ConnectionHandleFactory> connection_handle_factory_;
+    std::unique_ptr<network::ITPCommandFactory> command_factory_;
+    std::unique_ptr<network::ProtocolInterpreter::Provider> provider_;
+    std::unique_ptr<network::TerrierServer> server_;
+    bool finished_ = false;
+  };
+
   /**
    * Currently doesn't hold any objects. The constructor and destructor are just used to orchestrate the setup and
    * teardown for TPL.
@@ -281,6 +382,7 @@ class DBMain {
 
       std::unique_ptr<settings::SettingsManager> settings_manager =
           use_settings_manager_ ? BootstrapSettingsManager(common::ManagedPointer(db_main)) : DISABLED;
+      ValidateConfiguration();
 
       std::unique_ptr<metrics::MetricsManager> metrics_manager = DISABLED;
       if (use_metrics_) metrics_manager = BootstrapMetricsManager();
@@ -294,18 +396,28 @@ class DBMain {
       }
 
       std::unique_ptr<common::DedicatedThreadRegistry> thread_registry = DISABLED;
-      if (use_thread_registry_ || use_logging_ || use_network_)
+      if (use_thread_registry_ || use_logging_ || use_network_ || use_replica_)
         thread_registry = std::make_unique<common::DedicatedThreadRegistry>(common::ManagedPointer(metrics_manager));
 
       auto buffer_segment_pool =
           std::make_unique<storage::RecordBufferSegmentPool>(record_buffer_segment_size_, record_buffer_segment_reuse_);
 
+      std::unique_ptr<storage::LogShipper> log_shipper = DISABLED;
       std::unique_ptr<storage::LogManager> log_manager = DISABLED;
       if (use_logging_) {
         log_manager = std::make_unique<storage::LogManager>(
             wal_file_path_, wal_num_buffers_, std::chrono::microseconds{wal_serialization_interval_},
             std::chrono::microseconds{wal_persist_interval_}, wal_persist_threshold_,
             common::ManagedPointer(buffer_segment_pool), common::ManagedPointer(thread_registry));
+        log_manager->SetGroupCommit(std::chrono::microseconds{wal_group_commit_latency_}, wal_group_commit_size_);
+        log_manager->SetNumStreams(wal_num_streams_);
+        log_manager->SetDirectIO(wal_direct_io_);
+        log_manager->SetSegmentSize(wal_segment_size_);
+        if (!replication_replicas_.empty()) {
+          log_shipper =
+              std::make_unique<storage::LogShipper>(storage::LogShipper::ParseAddresses(replication_replicas_));
+          log_manager->SetLogShipper(common::ManagedPointer(log_shipper));
+        }
         log_manager->Start();
       }
 
@@ -314,7 +426,9 @@ class DBMain {
 
       auto storage_layer =
           std::make_unique<StorageLayer>(common::ManagedPointer(txn_layer), block_store_size_, block_store_reuse_,
-                                         use_gc_, common::ManagedPointer(log_manager));
+                                         block_store_huge_page_size_, block_store_numa_aware_, use_gc_,
+                                         gc_num_threads_, use_compaction_, compaction_cold_threshold_,
+                                         common::ManagedPointer(log_manager));
 
       std::unique_ptr<CatalogLayer> catalog_layer = DISABLED;
       if (use_catalog_) {
@@ -333,6 +447,27 @@ class DBMain {
                                                                       common::ManagedPointer(metrics_manager));
       }
 
+      std::unique_ptr<storage::BlockCompactorThread> compaction_thread = DISABLED;
+      if (use_compaction_) {
+        TERRIER_ASSERT(storage_layer->GetBlockCompactor() != DISABLED, "BlockCompactorThread needs BlockCompactor.");
+        compaction_thread = std::make_unique<storage::BlockCompactorThread>(
+            storage_layer->GetBlockCompactor(), txn_layer->GetDeferredActionManager(),
+            txn_layer->GetTransactionManager(), std::chrono::microseconds{compaction_interval_},
+            common::ManagedPointer(metrics_manager));
+      }
+
+      std::unique_ptr<storage::CheckpointManager> checkpoint_manager = DISABLED;
+      std::unique_ptr<storage::CheckpointThread> checkpoint_thread = DISABLED;
+      if (use_checkpointing_) {
+        TERRIER_ASSERT(use_catalog_ && catalog_layer->GetCatalog() != DISABLED, "CheckpointManager needs the Catalog.");
+        checkpoint_manager = std::make_unique<storage::CheckpointManager>(
+            checkpoint_file_path_, catalog_layer->GetCatalog(), txn_layer->GetTransactionManager(),
+            txn_layer->GetTimestampManager(), common::ManagedPointer(log_manager));
+        checkpoint_thread = std::make_unique<storage::CheckpointThread>(common::ManagedPointer(checkpoint_manager),
+                                                                        std::chrono::milliseconds{checkpoint_interval_},
+                                                                        common::ManagedPointer(metrics_manager));
+      }
+
       std::unique_ptr<optimizer::StatsStorage> stats_storage = DISABLED;
       if (use_stats_storage_) {
         stats_storage = std::make_unique<optimizer::StatsStorage>();
@@ -363,20 +498,33 @@ class DBMain {
                                            network_port_, connection_thread_count_);
       }
 
+      std::unique_ptr<ReplicationLayer> replication_layer = DISABLED;
+      if (use_replica_) {
+        TERRIER_ASSERT(use_catalog_ && catalog_layer->GetCatalog() != DISABLED, "ReplicationLayer needs the Catalog.");
+        replication_layer = std::make_unique<ReplicationLayer>(
+            common::ManagedPointer(thread_registry), common::ManagedPointer(txn_layer),
+            common::ManagedPointer(storage_layer), catalog_layer->GetCatalog(), replication_port_);
+      }
+
       db_main->settings_manager_ = std::move(settings_manager);
       db_main->metrics_manager_ = std::move(metrics_manager);
       db_main->metrics_thread_ = std::move(metrics_thread);
       db_main->thread_registry_ = std::move(thread_registry);
       db_main->buffer_segment_pool_ = std::move(buffer_segment_pool);
+      db_main->log_shipper_ = std::move(log_shipper);
       db_main->log_manager_ = std::move(log_manager);
       db_main->txn_layer_ = std::move(txn_layer);
       db_main->storage_layer_ = std::move(storage_layer);
       db_main->catalog_layer_ = std::move(catalog_layer);
       db_main->gc_thread_ = std::move(gc_thread);
+      db_main->compaction_thread_ = std::move(compaction_thread);
+      db_main->checkpoint_manager_ = std::move(checkpoint_manager);
+      db_main->checkpoint_thread_ = std::move(checkpoint_thread);
       db_main->stats_storage_ = std::move(stats_storage);
       db_main->execution_layer_ = std::move(execution_layer);
       db_main->traffic_cop_ = std::move(traffic_cop);
       db_main->network_layer_ = std::move(network_layer);
+      db_main->replication_layer_ = std::move(replication_layer);
 
       return db_main;
     }
@@ -480,6 +628,51 @@ class DBMain {
       return *this;
     }
 
+    /**
+     * @param value LogManager argument
+     * @return self reference for chaining
+     */
+    Builder &SetWalNumStreams(const uint32_t value) {
+      wal_num_streams_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value LogManager argument
+     * @return self reference for chaining
+     */
+    Builder &SetWalGroupCommitLatency(const uint64_t value) {
+      wal_group_commit_latency_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value LogManager argument
+     * @return self reference for chaining
+     */
+    Builder &SetWalGroupCommitSize(const uint64_t value) {
+      wal_group_commit_size_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value LogManager argument
+     * @return self reference for chaining
+     */
+    Builder &SetWalDirectIO(const bool value) {
+      wal_direct_io_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value LogManager argument
+     * @return self reference for chaining
+     */
+    Builder &SetWalSegmentSize(const uint64_t value) {
+      wal_segment_size_ = value;
+      return *this;
+    }
+
     /**
      * @param value use component
      * @return self reference for chaining
@@ -516,6 +709,69 @@ class DBMain {
       return *this;
     }
 
+    /**
+     * @param value GarbageCollector argument
+     * @return self reference for chaining
+     */
+    Builder &SetGCNumThreads(const uint32_t value) {
+      gc_num_threads_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value use component
+     * @return self reference for chaining
+     */
+    Builder &SetUseCompaction(const bool value) {
+      use_compaction_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value BlockCompactorThread argument
+     * @return self reference for chaining
+     */
+    Builder &SetCompactionInterval(const int32_t value) {
+      compaction_interval_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value AccessObserver argument
+     * @return self reference for chaining
+     */
+    Builder &SetCompactionColdThreshold(const uint64_t value) {
+      compaction_cold_threshold_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value use component
+     * @return self reference for chaining
+     */
+    Builder &SetUseCheckpointing(const bool value) {
+      use_checkpointing_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value CheckpointManager argument
+     * @return self reference for chaining
+     */
+    Builder &SetCheckpointFilePath(const std::string &value) {
+      checkpoint_file_path_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value CheckpointThread argument
+     * @return self reference for chaining
+     */
+    Builder &SetCheckpointInterval(const int32_t value) {
+      checkpoint_interval_ = value;
+      return *this;
+    }
+
     /**
      * @param value use component
      * @return self reference for chaining
@@ -552,6 +808,33 @@ class DBMain {
       return *this;
     }
 
+    /**
+     * @param value LogShipper argument, comma separated host:port addresses of replicas
+     * @return self reference for chaining
+     */
+    Builder &SetReplicationReplicas(const std::string &value) {
+      replication_replicas_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value use component
+     * @return self reference for chaining
+     */
+    Builder &SetUseReplica(const bool value) {
+      use_replica_ = value;
+      return *this;
+    }
+
+    /**
+     * @param port ReplicationLayer argument
+     * @return self reference for chaining
+     */
+    Builder &SetReplicationPort(const uint16_t port) {
+      replication_port_ = port;
+      return *this;
+    }
+
     /**
      * @param value RecordBufferSegmentPool argument
      * @return self reference for chaining
@@ -588,6 +871,24 @@ class DBMain {
       return *this;
     }
 
+    /**
+     * @param value BlockStore argument, size in MB of the huge pages blocks are carved out of (0 for none)
+     * @return self reference for chaining
+     */
+    Builder &SetBlockStoreHugePageSize(const uint32_t value) {
+      block_store_huge_page_size_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value BlockStore argument
+     * @return self reference for chaining
+     */
+    Builder &SetBlockStoreNumaAware(const bool value) {
+      block_store_numa_aware_ = value;
+      return *this;
+    }
+
     /**
      * @param value TrafficCop argument
      * @return self reference for chaining
@@ -639,6 +940,7 @@ class DBMain {
     bool metrics_transaction_ = false;
     bool metrics_logging_ = false;
     bool metrics_gc_ = false;
+    bool metrics_compaction_ = false;
     bool metrics_bind_command_ = false;
     bool metrics_execute_command_ = false;
     uint64_t record_buffer_segment_size_ = 1e5;
@@ -648,14 +950,28 @@ class DBMain {
     int32_t wal_serialization_interval_ = 100;
     int32_t wal_persist_interval_ = 100;
     uint64_t wal_persist_threshold_ = static_cast<uint64_t>(1 << 20);
+    uint32_t wal_num_streams_ = 1;
+    int32_t wal_group_commit_latency_ = 0;
+    uint64_t wal_group_commit_size_ = storage::LogManager::DEFAULT_GROUP_COMMIT_SIZE;
+    bool wal_direct_io_ = false;
+    uint64_t wal_segment_size_ = 0;
     bool use_logging_ = false;
     bool use_gc_ = false;
     bool use_catalog_ = false;
     bool create_default_database_ = true;
     uint64_t block_store_size_ = 1e5;
     uint64_t block_store_reuse_ = 1e3;
+    uint32_t block_store_huge_page_size_ = 0;
+    bool block_store_numa_aware_ = false;
     int32_t gc_interval_ = 1000;
+    uint32_t gc_num_threads_ = 1;
     bool use_gc_thread_ = false;
+    bool use_compaction_ = false;
+    int32_t compaction_interval_ = 10000;
+    uint64_t compaction_cold_threshold_ = 10;
+    bool use_checkpointing_ = false;
+    std::string checkpoint_file_path_ = "checkpoint";
+    int32_t checkpoint_interval_ = 60000;
     bool use_stats_storage_ = false;
     bool use_execution_ = false;
     bool use_traffic_cop_ = false;
@@ -665,6 +981,9 @@ class DBMain {
     uint16_t network_port_ = 15721;
     uint16_t connection_thread_count_ = 4;
     bool use_network_ = false;
+    std::string replication_replicas_;
+    bool use_replica_ = false;
+    uint16_t replication_port_ = 15445;
 
     /**
      * Instantiates the SettingsManager and reads all of the settings to override the Builder's settings.
@@ -681,6 +1000,9 @@ class DBMain {
           static_cast<uint64_t>(settings_manager->GetInt(settings::Param::record_buffer_segment_reuse));
       block_store_size_ = static_cast<uint64_t>(settings_manager->GetInt(settings::Param::block_store_size));
       block_store_reuse_ = static_cast<uint64_t>(settings_manager->GetInt(settings::Param::block_store_reuse));
+      block_store_huge_page_size_ =
+          static_cast<uint32_t>(settings_manager->GetInt(settings::Param::block_store_huge_page_size));
+      block_store_numa_aware_ = settings_manager->GetBool(settings::Param::block_store_numa_aware);
 
       use_logging_ = settings_manager->GetBool(settings::Param::wal_enable);
       if (use_logging_) {
@@ -690,11 +1012,33 @@ class DBMain {
         wal_persist_interval_ = settings_manager->GetInt(settings::Param::wal_persist_interval);
         wal_persist_threshold_ =
             static_cast<uint64_t>(settings_manager->GetInt64(settings::Param::wal_persist_threshold));
+        wal_num_streams_ = static_cast<uint32_t>(settings_manager->GetInt(settings::Param::wal_num_streams));
+        wal_group_commit_latency_ = settings_manager->GetInt(settings::Param::wal_group_commit_latency);
+        wal_group_commit_size_ =
+            static_cast<uint64_t>(settings_manager->GetInt(settings::Param::wal_group_commit_size));
+        wal_direct_io_ = settings_manager->GetBool(settings::Param::wal_direct_io);
+        wal_segment_size_ = static_cast<uint64_t>(settings_manager->GetInt64(settings::Param::wal_segment_size));
+        replication_replicas_ = settings_manager->GetString(settings::Param::replication_replicas);
       }
 
+      use_replica_ = settings_manager->GetBool(settings::Param::replication_replica_enable);
+      // There is no setting for the default database, and a replica gets all of its databases from the primary
+      if (use_replica_) create_default_database_ = false;
+      replication_port_ = static_cast<uint16_t>(settings_manager->GetInt(settings::Param::replication_port));
+
       use_metrics_ = use_metrics_thread_ = settings_manager->GetBool(settings::Param::metrics);
 
       gc_interval_ = settings_manager->GetInt(settings::Param::gc_interval);
+      gc_num_threads_ = static_cast<uint32_t>(settings_manager->GetInt(settings::Param::gc_num_threads));
+
+      use_compaction_ = settings_manager->GetBool(settings::Param::compaction_enable);
+      compaction_interval_ = settings_manager->GetInt(settings::Param::compaction_interval);
+      compaction_cold_threshold_ =
+          static_cast<uint64_t>(settings_manager->GetInt(settings::Param::compaction_cold_threshold));
+
+      use_checkpointing_ = settings_manager->GetBool(settings::Param::checkpoint_enable);
+      checkpoint_file_path_ = settings_manager->GetString(settings::Param::checkpoint_file_path);
+      checkpoint_interval_ = settings_manager->GetInt(settings::Param::checkpoint_interval);
 
       network_port_ = static_cast<uint16_t>(settings_manager->GetInt(settings::Param::port));
       connection_thread_count_ =
@@ -710,12 +1054,35 @@ class DBMain {
       metrics_transaction_ = settings_manager->GetBool(settings::Param::metrics_transaction);
       metrics_logging_ = settings_manager->GetBool(settings::Param::metrics_logging);
       metrics_gc_ = settings_manager->GetBool(settings::Param::metrics_gc);
+      metrics_compaction_ = settings_manager->GetBool(settings::Param::metrics_compaction);
       metrics_bind_command_ = settings_manager->GetBool(settings::Param::metrics_bind_command);
       metrics_execute_command_ = settings_manager->GetBool(settings::Param::metrics_execute_command);
 
       return settings_manager;
     }
 
+    /**
+     * Rejects combinations of components that cannot work together. Settings come from the command line, so these are
+     * user errors rather than bugs.
+     */
+    void ValidateConfiguration() const {
+      if (use_compaction_ && !use_gc_)
+        throw SETTINGS_EXCEPTION("Compaction needs garbage collection to observe cold blocks.",
+                                 common::ErrorCode::ERRCODE_INVALID_PARAMETER_VALUE);
+      if (use_compaction_ && use_logging_)
+        throw SETTINGS_EXCEPTION("Compaction does not log the tuples it moves, so it cannot be used with the WAL.",
+                                 common::ErrorCode::ERRCODE_INVALID_PARAMETER_VALUE);
+      if (use_logging_ && !replication_replicas_.empty() && wal_num_streams_ > 1)
+        throw SETTINGS_EXCEPTION("Only a single WAL stream can be shipped to replicas.",
+                                 common::ErrorCode::ERRCODE_INVALID_PARAMETER_VALUE);
+      if (use_replica_ && create_default_database_)
+        throw SETTINGS_EXCEPTION("A replica gets all of its databases from the primary.",
+                                 common::ErrorCode::ERRCODE_INVALID_PARAMETER_VALUE);
+      if (use_replica_ && use_logging_)
+        throw SETTINGS_EXCEPTION("A replica does not write a WAL of its own.",
+                                 common::ErrorCode::ERRCODE_INVALID_PARAMETER_VALUE);
+    }
+
     /**
      * Instantiate the MetricsManager and enable metrics for components arrocding to the Builder's settings.
      * @return
@@ -726,6 +1093,7 @@ class DBMain {
       if (metrics_transaction_) metrics_manager->EnableMetric(metrics::MetricsComponent::TRANSACTION, 0);
       if (metrics_logging_) metrics_manager->EnableMetric(metrics::MetricsComponent::LOGGING, 0);
       if (metrics_gc_) metrics_manager->EnableMetric(metrics::MetricsComponent::GARBAGECOLLECTION, 0);
+      if (metrics_compaction_) metrics_manager->EnableMetric(metrics::MetricsComponent::COMPACTION, 0);
       if (metrics_bind_command_) metrics_manager->EnableMetric(metrics::MetricsComponent::BIND_COMMAND, 0);
       if (metrics_execute_command_) metrics_manager->EnableMetric(metrics::MetricsComponent::EXECUTE_COMMAND, 0);
 
@@ -773,6 +1141,11 @@ class DBMain {
    */
   common::ManagedPointer<storage::LogManager> GetLogManager() const { return common::ManagedPointer(log_manager_); }
 
+  /**
+   * @return ManagedPointer to the component, can be nullptr if disabled
+   */
+  common::ManagedPointer<storage::LogShipper> GetLogShipper() const { return common::ManagedPointer(log_shipper_); }
+
   /**
    * @return ManagedPointer to the component
    */
@@ -795,6 +1168,27 @@ class DBMain {
     return common::ManagedPointer(gc_thread_);
   }
 
+  /**
+   * @return ManagedPointer to the component, can be nullptr if disabled
+   */
+  common::ManagedPointer<storage::BlockCompactorThread> GetBlockCompactorThread() const {
+    return common::ManagedPointer(compaction_thread_);
+  }
+
+  /**
+   * @return ManagedPointer to the component, can be nullptr if disabled
+   */
+  common::ManagedPointer<storage::CheckpointManager> GetCheckpointManager() const {
+    return common::ManagedPointer(checkpoint_manager_);
+  }
+
+  /**
+   * @return ManagedPointer to the component, can be nullptr if disabled
+   */
+  common::ManagedPointer<storage::CheckpointThread> GetCheckpointThread() const {
+    return common::ManagedPointer(checkpoint_thread_);
+  }
+
   /**
    * @return ManagedPointer to the component, can be nullptr if disabled
    */
@@ -812,6 +1206,13 @@ class DBMain {
    */
   common::ManagedPointer<NetworkLayer> GetNetworkLayer() const { return common::ManagedPointer(network_layer_); }
 
+  /**
+   * @return ManagedPointer to the component, can be nullptr if disabled
+   */
+  common::ManagedPointer<ReplicationLayer> GetReplicationLayer() const {
+    return common::ManagedPointer(replication_layer_);
+  }
+
   /**
    * @return ManagedPointer to the component, can be nullptr if disabled
    */
@@ -824,16 +1225,23 @@ class DBMain {
   std::unique_ptr<metrics::MetricsThread> metrics_thread_;
   std::unique_ptr<common::DedicatedThreadRegistry> thread_registry_;
   std::unique_ptr<storage::RecordBufferSegmentPool> buffer_segment_pool_;
+  std::unique_ptr<storage::LogShipper> log_shipper_;  // stops replication once the LogManager has shipped everything
   std::unique_ptr<storage::LogManager> log_manager_;
   std::unique_ptr<TransactionLayer> txn_layer_;
   std::unique_ptr<StorageLayer> storage_layer_;
   std::unique_ptr<CatalogLayer> catalog_layer_;
   std::unique_ptr<storage::GarbageCollectorThread>
       gc_thread_;  // thread needs to die before manual invocations of GC in CatalogLayer and others
+  std::unique_ptr<storage::BlockCompactorThread>
+      compaction_thread_;  // thread needs to die before the GC thread, which may still enqueue blocks for it
+  std::unique_ptr<storage::CheckpointManager> checkpoint_manager_;
+  std::unique_ptr<storage::CheckpointThread>
+      checkpoint_thread_;  // thread needs to die before the manager it takes checkpoints with
   std::unique_ptr<optimizer::StatsStorage> stats_storage_;
   std::unique_ptr<ExecutionLayer> execution_layer_;
   std::unique_ptr<trafficcop::TrafficCop> traffic_cop_;
   std::unique_ptr<NetworkLayer> network_layer_;
+  std::unique_ptr<ReplicationLayer> replication_layer_;
 };
 
 }  // namespace terrier
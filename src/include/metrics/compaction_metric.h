@@ -0,0 +1,105 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>  //NOLINT
+#include <fstream>
+#include <list>
+#include <utility>
+#include <vector>
+
+#include "catalog/catalog_defs.h"
+#include "common/resource_tracker.h"
+#include "metrics/abstract_metric.h"
+#include "metrics/metrics_util.h"
+
+namespace terrier::metrics {
+
+/**
+ * Raw data object for holding stats collected for the block compactor
+ */
+class CompactionMetricRawData : public AbstractRawData {
+ public:
+  void Aggregate(AbstractRawData *const other) override {
+    auto other_db_metric = dynamic_cast<CompactionMetricRawData *>(other);
+    if (!other_db_metric->compaction_data_.empty()) {
+      compaction_data_.splice(compaction_data_.cend(), other_db_metric->compaction_data_);
+    }
+  }
+
+  /**
+   * @return the type of the metric this object is holding the data for
+   */
+  MetricsComponent GetMetricType() const override { return MetricsComponent::COMPACTION; }
+
+  /**
+   * Writes the data out to ofstreams
+   * @param outfiles vector of ofstreams to write to that have been opened by the MetricsManager
+   */
+  void ToCSV(std::vector<std::ofstream> *const outfiles) final {
+    TERRIER_ASSERT(outfiles->size() == FILES.size(), "Number of files passed to metric is wrong.");
+    TERRIER_ASSERT(std::count_if(outfiles->cbegin(), outfiles->cend(),
+                                 [](const std::ofstream &outfile) { return !outfile.is_open(); }) == 0,
+                   "Not all files are open.");
+
+    auto &outfile = (*outfiles)[0];
+
+    for (const auto &data : compaction_data_) {
+      outfile << data.blocks_frozen_ << ", " << data.tuples_moved_ << ", " << data.varlen_bytes_gathered_ << ", "
+              << data.interval_ << ", ";
+      data.resource_metrics_.ToCSV(outfile);
+      outfile << std::endl;
+    }
+    compaction_data_.clear();
+  }
+
+  /**
+   * Files to use for writing to CSV.
+   */
+  static constexpr std::array<std::string_view, 1> FILES = {"./compaction.csv"};
+  /**
+   * Columns to use for writing to CSV.
+   * Note: This includes the columns for the input feature, but not the output (resource counters)
+   */
+  static constexpr std::array<std::string_view, 1> FEATURE_COLUMNS = {
+      "blocks_frozen, tuples_moved, varlen_bytes_gathered, interval"};
+
+ private:
+  friend class CompactionMetric;
+
+  void RecordCompactionData(uint64_t blocks_frozen, uint64_t tuples_moved, uint64_t varlen_bytes_gathered,
+                            uint64_t interval, const common::ResourceTracker::Metrics &resource_metrics) {
+    compaction_data_.emplace_back(blocks_frozen, tuples_moved, varlen_bytes_gathered, interval, resource_metrics);
+  }
+
+  struct CompactionData {
+    CompactionData(uint64_t blocks_frozen, uint64_t tuples_moved, uint64_t varlen_bytes_gathered, uint64_t interval,
+                   const common::ResourceTracker::Metrics &resource_metrics)
+        : blocks_frozen_(blocks_frozen),
+          tuples_moved_(tuples_moved),
+          varlen_bytes_gathered_(varlen_bytes_gathered),
+          interval_(interval),
+          resource_metrics_(resource_metrics) {}
+    const uint64_t blocks_frozen_;
+    const uint64_t tuples_moved_;
+    const uint64_t varlen_bytes_gathered_;
+    const uint64_t interval_;
+    const common::ResourceTracker::Metrics resource_metrics_;
+  };
+
+  std::list<CompactionData> compaction_data_;
+};
+
+/**
+ * Metrics for the block compactor: blocks frozen, tuples moved to close gaps, and varlen bytes gathered into Arrow
+ * buffers on every compaction pass
+ */
+class CompactionMetric : public AbstractMetric<CompactionMetricRawData> {
+ private:
+  friend class MetricsStore;
+
+  void RecordCompactionData(uint64_t blocks_frozen, uint64_t tuples_moved, uint64_t varlen_bytes_gathered,
+                            uint64_t interval, const common::ResourceTracker::Metrics &resource_metrics) {
+    GetRawData()->RecordCompactionData(blocks_frozen, tuples_moved, varlen_bytes_gathered, interval, resource_metrics);
+  }
+};
+}  // namespace terrier::metrics
@@ -55,7 +55,8 @@ class LoggingMetricRawData : public AbstractRawData {
       serializer_outfile << std::endl;
     }
     for (const auto &data : consumer_data_) {
-      consumer_outfile << data.num_bytes_ << ", " << data.num_buffers_ << ", " << data.interval_ << ", ";
+      consumer_outfile << data.num_bytes_ << ", " << data.num_buffers_ << ", " << data.num_commits_ << ", "
+                       << data.fsync_latency_ << ", " << data.interval_ << ", ";
       data.resource_metrics_.ToCSV(consumer_outfile);
       consumer_outfile << std::endl;
     }
@@ -72,8 +73,8 @@ class LoggingMetricRawData : public AbstractRawData {
    * Columns to use for writing to CSV.
    * Note: This includes the columns for the input feature, but not the output (resource counters)
    */
-  static constexpr std::array<std::string_view, 2> FEATURE_COLUMNS = {"num_bytes, num_records, num_txns, interval",
-                                                                      "num_bytes, num_buffers, interval"};
+  static constexpr std::array<std::string_view, 2> FEATURE_COLUMNS = {
+      "num_bytes, num_records, num_txns, interval", "num_bytes, num_buffers, num_commits, fsync_latency, interval"};
 
  private:
   friend class LoggingMetric;
@@ -84,9 +85,10 @@ class LoggingMetricRawData : public AbstractRawData {
     serializer_data_.emplace_back(num_bytes, num_records, num_txns, interval, resource_metrics);
   }
 
-  void RecordConsumerData(const uint64_t num_bytes, const uint64_t num_buffers, const uint64_t interval,
+  void RecordConsumerData(const uint64_t num_bytes, const uint64_t num_buffers, const uint64_t num_commits,
+                          const uint64_t fsync_latency, const uint64_t interval,
                           const common::ResourceTracker::Metrics &resource_metrics) {
-    consumer_data_.emplace_back(num_bytes, num_buffers, interval, resource_metrics);
+    consumer_data_.emplace_back(num_bytes, num_buffers, num_commits, fsync_latency, interval, resource_metrics);
   }
 
   struct SerializerData {
@@ -105,11 +107,21 @@ class LoggingMetricRawData : public AbstractRawData {
   };
 
   struct ConsumerData {
-    ConsumerData(const uint64_t num_bytes, const uint64_t num_buffers, const uint64_t interval,
+    ConsumerData(const uint64_t num_bytes, const uint64_t num_buffers, const uint64_t num_commits,
+                 const uint64_t fsync_latency, const uint64_t interval,
                  const common::ResourceTracker::Metrics &resource_metrics)
-        : num_bytes_(num_bytes), num_buffers_(num_buffers), interval_(interval), resource_metrics_(resource_metrics) {}
+        : num_bytes_(num_bytes),
+          num_buffers_(num_buffers),
+          num_commits_(num_commits),
+          fsync_latency_(fsync_latency),
+          interval_(interval),
+          resource_metrics_(resource_metrics) {}
     const uint64_t num_bytes_;
     const uint64_t num_buffers_;
+    // Number of commits made durable by one persist, i.e. the size of the commit group
+    const uint64_t num_commits_;
+    // Time (us) spent waiting on the persist
+    const uint64_t fsync_latency_;
     const uint64_t interval_;
     const common::ResourceTracker::Metrics resource_metrics_;
   };
@@ -130,9 +142,10 @@ class LoggingMetric : public AbstractMetric<LoggingMetricRawData> {
                             const uint64_t interval, const common::ResourceTracker::Metrics &resource_metrics) {
     GetRawData()->RecordSerializerData(num_bytes, num_records, num_txns, interval, resource_metrics);
   }
-  void RecordConsumerData(const uint64_t num_bytes, const uint64_t num_buffers, const uint64_t interval,
+  void RecordConsumerData(const uint64_t num_bytes, const uint64_t num_buffers, const uint64_t num_commits,
+                          const uint64_t fsync_latency, const uint64_t interval,
                           const common::ResourceTracker::Metrics &resource_metrics) {
-    GetRawData()->RecordConsumerData(num_bytes, num_buffers, interval, resource_metrics);
+    GetRawData()->RecordConsumerData(num_bytes, num_buffers, num_commits, fsync_latency, interval, resource_metrics);
   }
 };
 }  // namespace terrier::metrics
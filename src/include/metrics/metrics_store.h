@@ -13,6 +13,7 @@
 #include "metrics/abstract_metric.h"
 #include "metrics/abstract_raw_data.h"
 #include "metrics/bind_command_metric.h"
+#include "metrics/compaction_metric.h"
 #include "metrics/execute_command_metric.h"
 #include "metrics/execution_metric.h"
 #include "metrics/garbage_collection_metric.h"
@@ -57,17 +58,20 @@ class MetricsStore {
    * Record metrics from the LogConsumerTask
    * @param num_bytes first entry of metrics datapoint
    * @param num_records second entry of metrics datapoint
-   * @param interval third entry of metrics datapoint
-   * @param resource_metrics third entry of metrics datapoint
+   * @param num_commits third entry of metrics datapoint
+   * @param fsync_latency fourth entry of metrics datapoint
+   * @param interval fifth entry of metrics datapoint
+   * @param resource_metrics sixth entry of metrics datapoint
    */
-  void RecordConsumerData(const uint64_t num_bytes, const uint64_t num_records, const uint64_t interval,
+  void RecordConsumerData(const uint64_t num_bytes, const uint64_t num_records, const uint64_t num_commits,
+                          const uint64_t fsync_latency, const uint64_t interval,
                           const common::ResourceTracker::Metrics &resource_metrics) {
     if (!ComponentEnabled(MetricsComponent::LOGGING))
       METRICS_LOG_WARN(
           "RecordConsumerData() called without logging metrics enabled. Was it recently disabled and the component is "
           "just lagging?");
     TERRIER_ASSERT(logging_metric_ != nullptr, "LoggingMetric not allocated. Check MetricsStore constructor.");
-    logging_metric_->RecordConsumerData(num_bytes, num_records, interval, resource_metrics);
+    logging_metric_->RecordConsumerData(num_bytes, num_records, num_commits, fsync_latency, interval, resource_metrics);
   }
 
   /**
@@ -91,6 +95,47 @@ class MetricsStore {
                              resource_metrics);
   }
 
+  /**
+   * Record metrics from one of the GC's unlink workers
+   * @param worker_id first entry of metrics datapoint
+   * @param num_workers second entry of metrics datapoint
+   * @param txns_unlinked third entry of metrics datapoint
+   * @param buffer_unlinked fourth entry of metrics datapoint
+   * @param slots_truncated fifth entry of metrics datapoint
+   * @param interval sixth entry of metrics datapoint
+   * @param resource_metrics seventh entry of metrics datapoint
+   */
+  void RecordGCWorkerData(uint32_t worker_id, uint32_t num_workers, uint64_t txns_unlinked, uint64_t buffer_unlinked,
+                          uint64_t slots_truncated, uint64_t interval,
+                          const common::ResourceTracker::Metrics &resource_metrics) {
+    if (!ComponentEnabled(MetricsComponent::GARBAGECOLLECTION))
+      METRICS_LOG_WARN(
+          "RecordGCWorkerData() called without GC metrics enabled. Was it recently disabled and the component is just "
+          "lagging?");
+    TERRIER_ASSERT(gc_metric_ != nullptr, "GarbageCollectionMetric not allocated. Check MetricsStore constructor.");
+    gc_metric_->RecordGCWorkerData(worker_id, num_workers, txns_unlinked, buffer_unlinked, slots_truncated, interval,
+                                   resource_metrics);
+  }
+
+  /**
+   * Record metrics from the BlockCompactor
+   * @param blocks_frozen first entry of metrics datapoint
+   * @param tuples_moved second entry of metrics datapoint
+   * @param varlen_bytes_gathered third entry of metrics datapoint
+   * @param interval fourth entry of metrics datapoint
+   * @param resource_metrics fifth entry of metrics datapoint
+   */
+  void RecordCompactionData(uint64_t blocks_frozen, uint64_t tuples_moved, uint64_t varlen_bytes_gathered,
+                            uint64_t interval, const common::ResourceTracker::Metrics &resource_metrics) {
+    if (!ComponentEnabled(MetricsComponent::COMPACTION))
+      METRICS_LOG_WARN(
+          "RecordCompactionData() called without compaction metrics enabled. Was it recently disabled and the "
+          "component is just lagging?");
+    TERRIER_ASSERT(compaction_metric_ != nullptr, "CompactionMetric not allocated. Check MetricsStore constructor.");
+    compaction_metric_->RecordCompactionData(blocks_frozen, tuples_moved, varlen_bytes_gathered, interval,
+                                             resource_metrics);
+  }
+
   /**
    * Record metrics for transaction manager when beginning transaction
    * @param resource_metrics first entry of txn datapoint
@@ -221,6 +266,7 @@ class MetricsStore {
   std::unique_ptr<PipelineMetric> pipeline_metric_;
   std::unique_ptr<BindCommandMetric> bind_command_metric_;
   std::unique_ptr<ExecuteCommandMetric> execute_command_metric_;
+  std::unique_ptr<CompactionMetric> compaction_metric_;
 
   const std::bitset<NUM_COMPONENTS> &enabled_metrics_;
   const std::array<uint32_t, NUM_COMPONENTS> &sample_interval_;
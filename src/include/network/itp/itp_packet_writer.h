@@ -26,8 +26,11 @@ class ITPPacketWriter : public PacketWriter {
    * This begins the creation of the Replication command. After this is called , we can append further
    * bytes to the packet and call EndReplicationCommand when we want to finish the current command.
    * @param message_id message id
+   * @param data_size number of bytes of replication data that will be appended to the command
    */
-  void BeginReplicationCommand(uint64_t message_id) { BeginPacket(NetworkMessageType::ITP_REPLICATION_COMMAND); }
+  void BeginReplicationCommand(uint64_t message_id, uint64_t data_size) {
+    BeginPacket(NetworkMessageType::ITP_REPLICATION_COMMAND).AppendValue(message_id).AppendValue(data_size);
+  }
 
   /**
    * End the Replication command
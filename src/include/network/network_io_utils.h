@@ -1,5 +1,6 @@
 #pragma once
 #include <arpa/inet.h>
+#include <sys/socket.h>
 #include <unistd.h>
 
 #include <algorithm>
@@ -323,12 +324,18 @@ class ReadBuffer : public Buffer {
 class WriteBuffer : public Buffer {
  public:
   /**
-   * Write as many bytes as possible using Posix write to fd
-   * @param fd File descriptor to write out to
-   * @return return value of Posix write
+   * Write as many bytes as possible using Posix send to fd. A peer that closed the connection shows up as EPIPE,
+   * without raising SIGPIPE.
+   * @param fd Socket to write out to
+   * @return return value of Posix send
    */
   int WriteOutTo(int fd) {
-    ssize_t bytes_written = write(fd, &buf_[offset_], size_ - offset_);
+#ifdef MSG_NOSIGNAL
+    ssize_t bytes_written = send(fd, &buf_[offset_], size_ - offset_, MSG_NOSIGNAL);
+#else
+    // Sockets that must not raise SIGPIPE set SO_NOSIGPIPE instead
+    ssize_t bytes_written = send(fd, &buf_[offset_], size_ - offset_, 0);
+#endif
     if (bytes_written > 0) offset_ += bytes_written;
     return static_cast<int>(bytes_written);
   }
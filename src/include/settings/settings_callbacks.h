@@ -108,6 +108,16 @@ class Callbacks {
   static void MetricsGC(void *old_value, void *new_value, DBMain *db_main,
                         common::ManagedPointer<common::ActionContext> action_context);
 
+  /**
+   * Enable or disable metrics collection for BlockCompactor component
+   * @param old_value old settings value
+   * @param new_value new settings value
+   * @param db_main pointer to db_main
+   * @param action_context pointer to the action context for this settings change
+   */
+  static void MetricsCompaction(void *old_value, void *new_value, DBMain *db_main,
+                                common::ManagedPointer<common::ActionContext> action_context);
+
   /**
    * Enable or disable metrics collection for Execution component
    * @param old_value old settings value
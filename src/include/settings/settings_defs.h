@@ -66,6 +66,28 @@ SETTING_int(
     terrier::settings::Callbacks::BlockStoreReuseLimit
 )
 
+// BlockStore huge pages
+SETTING_int(
+    block_store_huge_page_size,
+    "Size in MB of the huge pages that storage blocks are carved out of, either 2 or 1024. 0 allocates blocks on the "
+    "heap. Other values are rejected. (default: 0)",
+    0,
+    0,
+    1024,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// BlockStore NUMA placement
+SETTING_bool(
+    block_store_numa_aware,
+    "Whether storage blocks carved out of huge pages are placed on the NUMA node of the thread that allocates them "
+    "(default: false)",
+    false,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
 // Garbage collector thread interval
 SETTING_int(
     gc_interval,
@@ -77,6 +99,80 @@ SETTING_int(
     terrier::settings::Callbacks::NoOp
 )
 
+// Number of garbage collector threads
+SETTING_int(
+    gc_num_threads,
+    "Number of threads that unlink the versions of completed transactions on each GC invocation (default: 1)",
+    1,
+    1,
+    64,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Background block compaction
+SETTING_bool(
+    compaction_enable,
+    "Whether cold blocks are compacted and frozen into Arrow format in the background. Tuple movement does not "
+    "maintain indexes or the WAL yet, so tables with indexes are left alone and this cannot be combined with "
+    "wal_enable. Needs garbage collection. (default: false)",
+    false,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Block compactor thread interval
+SETTING_int(
+    compaction_interval,
+    "Block compactor thread interval (us) (default: 10000)",
+    10000,
+    1,
+    1000000,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Number of GC invocations without a write before a full block is considered cold
+SETTING_int(
+    compaction_cold_threshold,
+    "Number of GC invocations without a write before a full block is sent to the compactor (default: 10)",
+    10,
+    1,
+    1000000,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Checkpoints
+SETTING_bool(
+    checkpoint_enable,
+    "Whether checkpoints are taken in the background, so that recovery only replays the log written after the last "
+    "one (default: false)",
+    false,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Path that the numbers of checkpoint files are appended to
+SETTING_string(
+    checkpoint_file_path,
+    "The path that the numbers of checkpoint files are appended to (default: checkpoint)",
+    "checkpoint",
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Checkpoint thread interval
+SETTING_int(
+    checkpoint_interval,
+    "Checkpoint thread interval (ms) (default: 60000)",
+    60000,
+    1,
+    86400000,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
 // Write ahead logging
 SETTING_bool(
     wal_enable,
@@ -98,7 +194,7 @@ SETTING_string(
 // Number of buffers log manager can use to buffer logs
 SETTING_int64(
     wal_num_buffers,
-    "The number of buffers the log manager uses to buffer logs to hand off to log consumer(s) (default: 100)",
+    "The number of buffers each log stream uses to buffer logs to hand off to log consumer(s) (default: 100)",
     100,
     2,
     10000,
@@ -143,6 +239,27 @@ SETTING_bool(
     terrier::settings::Callbacks::NoOp
 )
 
+// Operator memory budget
+SETTING_int64(
+    execution_operator_memory_budget,
+    "Number of bytes a hash join, hash aggregation or sort may buffer before it spills to disk, 0 never spills "
+    "(default: 0)",
+    0,
+    0,
+    (1LL << 40) /* 1TB */,
+    true,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Bloom filter pushdown
+SETTING_bool(
+    execution_bloom_filter_pushdown,
+    "Whether hash joins filter probe-side scans through the bloom filters of their hash tables (default: true)",
+    true,
+    true,
+    terrier::settings::Callbacks::NoOp
+)
+
 // Log file persisting threshold
 SETTING_int64(
     wal_persist_threshold,
@@ -154,6 +271,91 @@ SETTING_int64(
     terrier::settings::Callbacks::NoOp
 )
 
+// Number of log streams, each with its own serializer thread and log file
+SETTING_int(
+    wal_num_streams,
+    "The number of log streams, each serializing logs on its own thread into its own log file (default: 1)",
+    1,
+    1,
+    64,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Target commit latency for group commit
+SETTING_int(
+    wal_group_commit_latency,
+    "Target latency (us) of a commit waiting for the log file to be persisted, 0 disables group commit (default: 0)",
+    0,
+    0,
+    100000,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Number of waiting commits that triggers a persist for group commit
+SETTING_int(
+    wal_group_commit_size,
+    "Number of commits waiting for the log file to be persisted that triggers a persist under group commit "
+    "(default: 64)",
+    64,
+    1,
+    100000,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Size of log segments
+SETTING_int64(
+    wal_segment_size,
+    "Size (bytes) of the segments each log stream's log is cut into, 0 writes the log into a single file (default: 0)",
+    0,
+    0,
+    (1LL << 34) /* 16GB */,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Whether log files are written with direct I/O
+SETTING_bool(
+    wal_direct_io,
+    "Whether log files are written with direct I/O, bypassing the page cache. Log files written with and without "
+    "direct I/O cannot be appended to each other. (default: false)",
+    false,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Replicas to ship the WAL to
+SETTING_string(
+    replication_replicas,
+    "Comma separated host:port addresses of the replicas to ship the WAL to, which must be running before the primary "
+    "starts. Requires a single WAL stream. (default: none)",
+    "",
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Whether to run as a replica
+SETTING_bool(
+    replication_replica_enable,
+    "Run as a replica that replays the WAL shipped from a primary (default: false)",
+    false,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Port a replica receives the WAL on
+SETTING_int(
+    replication_port,
+    "The port a replica receives the WAL from its primary on (default: 15445)",
+    15445,
+    1024,
+    65535,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
 SETTING_int(
     extra_float_digits,
     "Sets the number of digits displayed for floating-point values. (default : 1)",
@@ -196,6 +398,14 @@ SETTING_bool(
     terrier::settings::Callbacks::MetricsGC
 )
 
+SETTING_bool(
+    metrics_compaction,
+    "Metrics collection for the BlockCompactor component (default: false).",
+    false,
+    true,
+    terrier::settings::Callbacks::MetricsCompaction
+)
+
 SETTING_bool(
     metrics_execution,
     "Metrics collection for the Execution component (default: false).",
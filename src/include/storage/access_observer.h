@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <unordered_map>
 
 namespace terrier::storage {
@@ -33,8 +34,10 @@ class AccessObserver {
   /**
    * Constructs a new AccessObserver that will send its observations to the given block compactor
    * @param compactor the compactor to use after identifying a cold block
+   * @param cold_data_epoch_threshold number of GC invocations without a write before a full block is considered cold
    */
-  explicit AccessObserver(BlockCompactor *compactor) : compactor_(compactor) {}
+  explicit AccessObserver(BlockCompactor *compactor, uint64_t cold_data_epoch_threshold = COLD_DATA_EPOCH_THRESHOLD)
+      : cold_data_epoch_threshold_(cold_data_epoch_threshold), compactor_(compactor) {}
 
   /**
    * Signals to the AccessObserver that a new GC run has begun. This is useful as a measurement of time to the
@@ -50,8 +53,16 @@ class AccessObserver {
    */
   void ObserveWrite(RawBlock *block);
 
+  /**
+   * Forgets about the blocks of tables that may no longer be compacted (@see DataTable::DisallowCompaction), and has
+   * the compactor do the same, so that neither holds on to them once they are freed. Writes to those blocks are not
+   * observed anymore either.
+   */
+  void ForgetUncompactableBlocks();
+
  private:
   uint64_t gc_epoch_ = 0;  // estimate time using the number of times GC has run
+  const uint64_t cold_data_epoch_threshold_;
   // Here RawBlock * should suffice as a unique identifier of the block. Although a block can be
   // reused, that process should only be triggered through compaction, which happens only if the
   // reference to said block is identified as cold and leaves the table.
@@ -1,13 +1,19 @@
 #pragma once
 
 #include <emmintrin.h>
+#include <algorithm>
 #include <atomic>
 #include <cstring>
 #include <utility>
+#include <vector>
 
 #include "common/macros.h"
 #include "common/strong_typedef.h"
 
+namespace terrier::execution::sql {
+class VectorProjection;
+}  // namespace terrier::execution::sql
+
 namespace terrier::storage {
 
 /**
@@ -46,6 +52,11 @@ enum class BlockState : uint32_t {
  * transactional updates share the lock amongst themselves but have to wait for all in-place readers to finish when
  * grabbing the lock. Arrow readers will never wait on the lock as they are given low priority, and will revert to
  * reading transactionally if the block is not frozen.
+ *
+ * An in-place read must be released by the thread that acquired it. A thread that writes to a block it is itself
+ * reading in place only waits for the other readers, since it would otherwise wait for itself forever. Before it does,
+ * it must copy the buffers it reads the block through out of the block (@see ForEachOwnInPlaceReader), so that its
+ * own writes do not change what it has already read.
  */
 class BlockAccessController {
   // We do some reinterpret_casting between uint64_t and the std::pair below, so we want to assert the object size.
@@ -64,9 +75,11 @@ class BlockAccessController {
    * Checks whether the block is safe for in-place reads. If the result returns true, the lock is successfully acquired
    * and will need to be explicitly dropped via invocation of ReleaseRead. Otherwise, the block cannot be accessed
    * in-place and the reader should try the transactional path and make a snapshot of the block.
+   * @param reader the buffer that references the block, if any, which is copied out of the block should the calling
+   *               thread write to it before releasing the read
    * @return whether reading in-place is allowed for this block.
    */
-  bool TryAcquireInPlaceRead() {
+  bool TryAcquireInPlaceRead(execution::sql::VectorProjection *const reader = nullptr) {
     // TODO(Tianyu): This probably does not scale well. But our assumed workload is that readers will not be contending
     // for access in a tight loop, so maybe it's fine.
     while (true) {
@@ -75,21 +88,45 @@ class BlockAccessController {
       // Can only read in-place if a block is not being updated
       if (curr_state.first != BlockState::FROZEN) return false;
       // Increment reader count while holding the rest constant
-      if (UpdateAtomically(curr_state, {curr_state.first, curr_state.second + 1})) return true;  // NOLINT
+      if (UpdateAtomically(curr_state, {curr_state.first, curr_state.second + 1})) {  // NOLINT
+        ThreadInPlaceReads().emplace_back(this, reader);
+        return true;
+      }
     }
   }
 
   /**
    * Releases the read lock acquired by an in-place reader on the block
+   * @param reader the buffer the read was acquired for
    */
-  void ReleaseInPlaceRead() {
+  void ReleaseInPlaceRead(execution::sql::VectorProjection *const reader = nullptr) {
     TERRIER_ASSERT(GetReaderCount()->load() > 0, "Attempting to release read lock when there is none");
+    auto &thread_reads = ThreadInPlaceReads();
+    const auto it = std::find(thread_reads.begin(), thread_reads.end(), InPlaceRead(this, reader));
+    TERRIER_ASSERT(it != thread_reads.end(), "In-place reads must be released by the thread that acquired them");
+    if (it != thread_reads.end()) {
+      *it = thread_reads.back();
+      thread_reads.pop_back();
+    }
     // Increment reader count while holding the rest constant
     GetReaderCount()->fetch_sub(1);
   }
 
   /**
-   * blocks until all in-place readers have left to be able to perform in-place modifications.
+   * Applies the given function to every buffer that the calling thread reads this block in place through. A writer
+   * calls this before modifying the block, so that it can copy those buffers out of the block first.
+   * @tparam F type of the function, taking an execution::sql::VectorProjection *
+   * @param f the function to apply
+   */
+  template <typename F>
+  void ForEachOwnInPlaceReader(const F &f) const {
+    for (const auto &read : ThreadInPlaceReads())
+      if (read.first == this && read.second != nullptr) f(read.second);
+  }
+
+  /**
+   * blocks until all in-place readers have left to be able to perform in-place modifications. In-place reads held by
+   * the calling thread itself are not waited for.
    */
   void WaitUntilHot() {
     while (true) {
@@ -104,10 +141,14 @@ class BlockAccessController {
         case BlockState::FROZEN:
           GetBlockState()->store(BlockState::HOT);
           // intentional fall through
-        case BlockState::HOT:
+        case BlockState::HOT: {
           // Although the block is already hot, we may need to wait for any straggling readers to finish
-          while (GetReaderCount()->load() != 0) _mm_pause();
+          const auto &thread_reads = ThreadInPlaceReads();
+          const auto own_reads = static_cast<uint32_t>(std::count_if(
+              thread_reads.begin(), thread_reads.end(), [this](const auto &read) { return read.first == this; }));
+          while (GetReaderCount()->load() > own_reads) _mm_pause();
           break;
+        }
         default:
           throw std::runtime_error("unexpected control flow");
       }
@@ -130,6 +171,14 @@ class BlockAccessController {
     return reinterpret_cast<std::atomic<uint32_t> *>(reinterpret_cast<uint32_t *>(bytes_) + 1);
   }
 
+  // The blocks the calling thread currently reads in place and the buffers it reads them through, once per in-place
+  // read it holds
+  using InPlaceRead = std::pair<const BlockAccessController *, execution::sql::VectorProjection *>;
+  static std::vector<InPlaceRead> &ThreadInPlaceReads() {
+    static thread_local std::vector<InPlaceRead> thread_reads;
+    return thread_reads;
+  }
+
   std::pair<BlockState, uint32_t> AtomicallyLoadMembers() {
     uint64_t curr_value = reinterpret_cast<std::atomic<uint64_t> *>(bytes_)->load();
     const auto *const curr_state = reinterpret_cast<const std::pair<BlockState, uint32_t> *const>(&curr_value);
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "common/constants.h"
+#include "common/macros.h"
+#include "common/spin_latch.h"
+#include "storage/storage_defs.h"
+
+namespace terrier::storage {
+
+/**
+ * Carves RawBlocks out of large arenas of memory backed by huge pages, so that scans over many blocks take far fewer
+ * TLB misses than with blocks allocated on the heap.
+ *
+ * Each arena is placed on a single NUMA node, and every node keeps its own free list of blocks. When NUMA aware, blocks
+ * are handed out from the free list of the node of the thread that asks for them, mapping another arena on that node
+ * when it runs out, so that a thread filling up a table mostly writes to local memory. Only if no arena can be mapped
+ * does a block come from another node's free list. Arenas are pre-faulted
+ * when they are mapped, so that page faults are taken once per arena instead of on the first insert into every block.
+ *
+ * If the system has no huge pages of the requested size reserved (see /proc/sys/vm/nr_hugepages), arenas are mapped
+ * with regular pages instead, and transparent huge pages are requested for them. Deleted blocks go back to the free
+ * list of their node, and arenas are only unmapped when the BlockArenas is destroyed, so the memory held never shrinks.
+ */
+class BlockArenas {
+ public:
+  /**
+   * Largest number of NUMA nodes arenas can be placed on. Blocks of threads on other nodes are placed on node 0.
+   */
+  static constexpr uint32_t MAX_NODES = 64;
+
+  /**
+   * Size of an arena mapped with 2 MB pages. Arenas mapped with 1 GB pages are a single page.
+   */
+  static constexpr uint64_t MIN_ARENA_SIZE = 64 * common::Constants::MB;
+
+  /**
+   * @param huge_page_size size of the huge pages in MB, either 2 or 1024
+   * @param numa_aware whether blocks are placed on the NUMA node of the thread that asks for them
+   * @throw std::runtime_error if the huge page size is not supported
+   */
+  BlockArenas(uint32_t huge_page_size, bool numa_aware);
+
+  /**
+   * Unmaps all arenas. All blocks must have been deleted by now.
+   */
+  ~BlockArenas();
+
+  DISALLOW_COPY_AND_MOVE(BlockArenas);
+
+  /**
+   * Hands out a block from the calling thread's node, mapping a new arena if the node has no free blocks left.
+   * @return the block, or nullptr if a new arena could not be mapped and no node has a free block left
+   */
+  RawBlock *New();
+
+  /**
+   * Returns a block to the free list of its node
+   * @param block block to return, which must have been handed out by this BlockArenas
+   */
+  void Delete(RawBlock *block);
+
+  /**
+   * @return number of blocks handed out and not yet deleted on each NUMA node, indexed by node id
+   */
+  std::vector<uint64_t> BlocksPerNode() const;
+
+  /**
+   * @return number of arenas mapped so far
+   */
+  uint64_t NumArenas() const {
+    common::SpinLatch::ScopedSpinLatch guard(&arenas_latch_);
+    return arenas_.size();
+  }
+
+  /**
+   * @return the NUMA node of the cpu the calling thread runs on, or 0 if it is not known
+   */
+  static uint32_t CurrentNode();
+
+  /**
+   * @return number of NUMA nodes the system may have, at most MAX_NODES
+   */
+  static uint32_t NumSystemNodes();
+
+ private:
+  struct Arena {
+    // Start of the mapping, which may lie before the first block
+    void *mapping_;
+    uint64_t mapping_size_;
+    uint32_t node_;
+  };
+
+  // Nodes are latched with a mutex rather than a spin latch, as mapping an arena takes a while
+  struct alignas(common::Constants::CACHELINE_SIZE) Node {
+    std::mutex latch_;
+    // Memory for blocks that are not handed out, in the order they are handed out from the back
+    std::vector<byte *> free_blocks_;
+    std::atomic<uint64_t> blocks_in_use_{0};
+  };
+
+  uint64_t page_size_;
+  uint64_t arena_size_;
+  bool numa_aware_;
+  std::vector<Node> nodes_;
+  // Arenas by the address of their first block, to find the node a deleted block belongs to
+  mutable common::SpinLatch arenas_latch_;
+  std::map<uintptr_t, Arena> arenas_;
+  // Only warn once about falling back to regular pages
+  std::atomic<bool> warned_no_huge_pages_{false};
+
+  // Takes a block off the node's free list, mapping a new arena on the node first if the list is empty and map_arena is
+  // set. Returns nullptr if there is no block to take.
+  byte *TakeFreeBlock(uint32_t node_id, bool map_arena);
+
+  // Maps a new arena on the node and adds its blocks to the node's free list. Must be called with the node latched.
+  bool MapArena(uint32_t node_id, Node *node);
+
+  // Maps memory of arena_size_ aligned to page_size_, returning the mapping and the aligned start within it
+  void *MapMemory(void **mapping, uint64_t *mapping_size);
+
+  // Node of the arena the block was carved out of
+  uint32_t NodeOf(RawBlock *block) const;
+};
+
+}  // namespace terrier::storage
@@ -1,8 +1,10 @@
 #pragma once
+#include <mutex>  // NOLINT
 #include <queue>
 #include <unordered_map>
 #include <utility>
 #include <vector>
+#include "common/spin_latch.h"
 #include "storage/arrow_block_metadata.h"
 #include "storage/data_table.h"
 #include "storage/storage_defs.h"
@@ -44,6 +46,7 @@ class BlockCompactor {
     transaction::TransactionContext *txn_;
     DataTable *table_;
     std::unordered_map<RawBlock *, std::vector<uint32_t>> blocks_to_compact_;
+    uint32_t tuples_moved_ = 0;
     ProjectedRowInitializer all_cols_initializer_;
     ProjectedRow *read_buffer_;
   };
@@ -63,7 +66,23 @@ class BlockCompactor {
    * Adds a block associated with a data table to the compaction to be processed in the future.
    * @param block the block that needs to be processed by the compactor
    */
-  FAKED_IN_TEST void PutInQueue(RawBlock *block) { compaction_queue_.push(block); }
+  FAKED_IN_TEST void PutInQueue(RawBlock *block) {
+    common::SpinLatch::ScopedSpinLatch guard(&queue_latch_);
+    compaction_queue_.push(block);
+  }
+
+  /**
+   * Drops the blocks of tables that may no longer be compacted (@see DataTable::DisallowCompaction) from the queue and
+   * from the cooling blocks waiting to be frozen, so that the compactor does not hold on to them once they are freed.
+   * Waits for a compaction pass in progress to finish first.
+   */
+  void DropUncompactableBlocks();
+
+  /**
+   * Set the compaction interval for metrics collection
+   * @param compaction_interval interval to set (in us)
+   */
+  void SetCompactionInterval(uint64_t compaction_interval) { compaction_interval_ = compaction_interval; }
 
  private:
   bool EliminateGaps(CompactionGroup *cg);
@@ -73,13 +92,14 @@ class BlockCompactor {
   // Move a tuple and updated associated information in their respective blocks
   bool MoveTuple(CompactionGroup *cg, TupleSlot from, TupleSlot to);
 
-  void GatherVarlens(std::vector<const byte *> *loose_ptrs, RawBlock *block, DataTable *table);
+  // Returns the number of varlen bytes written into Arrow buffers
+  uint64_t GatherVarlens(std::vector<const byte *> *loose_ptrs, RawBlock *block, DataTable *table);
 
-  void CopyToArrowVarlen(std::vector<const byte *> *loose_ptrs, ArrowBlockMetadata *metadata, col_id_t col_id,
-                         common::RawConcurrentBitmap *column_bitmap, ArrowColumnInfo *col, VarlenEntry *values);
+  uint32_t CopyToArrowVarlen(std::vector<const byte *> *loose_ptrs, ArrowBlockMetadata *metadata, col_id_t col_id,
+                             common::RawConcurrentBitmap *column_bitmap, ArrowColumnInfo *col, VarlenEntry *values);
 
-  void BuildDictionary(std::vector<const byte *> *loose_ptrs, ArrowBlockMetadata *metadata, col_id_t col_id,
-                       common::RawConcurrentBitmap *column_bitmap, ArrowColumnInfo *col, VarlenEntry *values);
+  uint32_t BuildDictionary(std::vector<const byte *> *loose_ptrs, ArrowBlockMetadata *metadata, col_id_t col_id,
+                           common::RawConcurrentBitmap *column_bitmap, ArrowColumnInfo *col, VarlenEntry *values);
 
   void ComputeFilled(const BlockLayout &layout, std::vector<uint32_t> *filled, const std::vector<uint32_t> &empty) {
     // Reconstruct the list of filled slots
@@ -94,6 +114,14 @@ class BlockCompactor {
     }
   }
 
+  // Blocks are enqueued from the GC thread (through the access observer) and drained by the compaction thread
+  common::SpinLatch queue_latch_;
   std::queue<RawBlock *> compaction_queue_;
+  // Held for the whole of a compaction pass, so that blocks can be dropped from the compactor in between passes
+  std::mutex pass_latch_;
+  // Cooling blocks that still had versions or gaps at the last pass, to be checked again at the next one. Protected
+  // by pass_latch_.
+  std::vector<RawBlock *> cooling_blocks_;
+  uint64_t compaction_interval_{0};
 };
 }  // namespace terrier::storage
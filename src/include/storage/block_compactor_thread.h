@@ -0,0 +1,101 @@
+#pragma once
+
+#include <chrono>  //NOLINT
+#include <thread>  //NOLINT
+
+#include "common/managed_pointer.h"
+#include "storage/block_compactor.h"
+
+namespace terrier::metrics {
+class MetricsManager;
+}
+
+namespace terrier::transaction {
+class DeferredActionManager;
+class TransactionManager;
+}  // namespace terrier::transaction
+
+namespace terrier::storage {
+
+/**
+ * Class for spinning off a thread that drains the block compactor's queue at a fixed interval. Blocks end up in the
+ * queue when the AccessObserver attached to the garbage collector decides they have gone cold, so this thread is only
+ * useful alongside a running GC.
+ */
+class BlockCompactorThread {
+ public:
+  /**
+   * @param compactor pointer to the block compactor whose queue is processed on this thread
+   * @param deferred_action_manager deferred action manager used by the compactor to clean up stale varlens
+   * @param txn_manager transaction manager used by the compactor to move tuples transactionally
+   * @param compaction_period sleep time between compaction invocations
+   * @param metrics_manager Metrics Manager
+   */
+  BlockCompactorThread(common::ManagedPointer<BlockCompactor> compactor,
+                       common::ManagedPointer<transaction::DeferredActionManager> deferred_action_manager,
+                       common::ManagedPointer<transaction::TransactionManager> txn_manager,
+                       std::chrono::microseconds compaction_period,
+                       common::ManagedPointer<metrics::MetricsManager> metrics_manager);
+
+  ~BlockCompactorThread() { StopCompaction(); }
+
+  /**
+   * Kill the compaction thread. Blocks left in the queue stay in whatever state they were in and are picked up again
+   * if the thread is restarted.
+   */
+  void StopCompaction() {
+    TERRIER_ASSERT(run_compaction_, "Compaction should already be running.");
+    run_compaction_ = false;
+    compaction_thread_.join();
+  }
+
+  /**
+   * Spawn the compaction thread if it has been previously stopped.
+   */
+  void StartCompaction() {
+    TERRIER_ASSERT(!run_compaction_, "Compaction should not already be running.");
+    run_compaction_ = true;
+    compaction_paused_ = false;
+    compaction_thread_ = std::thread([this] { CompactionThreadLoop(); });
+  }
+
+  /**
+   * Pause compaction, typically for use in tests when the state of tables need to be fixed.
+   */
+  void PauseCompaction() {
+    TERRIER_ASSERT(!compaction_paused_, "Compaction should not already be paused.");
+    compaction_paused_ = true;
+  }
+
+  /**
+   * Resume compaction after being paused.
+   */
+  void ResumeCompaction() {
+    TERRIER_ASSERT(compaction_paused_, "Compaction should already be paused.");
+    compaction_paused_ = false;
+  }
+
+  /**
+   * @return the underlying block compactor
+   */
+  common::ManagedPointer<BlockCompactor> GetBlockCompactor() { return compactor_; }
+
+ private:
+  const common::ManagedPointer<BlockCompactor> compactor_;
+  const common::ManagedPointer<transaction::DeferredActionManager> deferred_action_manager_;
+  const common::ManagedPointer<transaction::TransactionManager> txn_manager_;
+  const common::ManagedPointer<metrics::MetricsManager> metrics_manager_;
+  volatile bool run_compaction_;
+  volatile bool compaction_paused_;
+  std::chrono::microseconds compaction_period_;
+  std::thread compaction_thread_;
+
+  void CompactionThreadLoop() {
+    while (run_compaction_) {
+      std::this_thread::sleep_for(compaction_period_);
+      if (!compaction_paused_) compactor_->ProcessCompactionQueue(deferred_action_manager_.Get(), txn_manager_.Get());
+    }
+  }
+};
+
+}  // namespace terrier::storage
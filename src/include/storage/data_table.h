@@ -5,6 +5,8 @@
 #include <unordered_map>
 #include <vector>
 
+#include "common/container/concurrent_append_only_vector.h"
+#include "common/container/concurrent_queue.h"
 #include "common/managed_pointer.h"
 #include "storage/projected_columns.h"
 #include "storage/storage_defs.h"
@@ -93,12 +95,9 @@ class DataTable {
     /** An invalid TupleSlot. */
     static TupleSlot InvalidTupleSlot() { return TupleSlot(nullptr, 0); }
 
-    /**
-     * @warning MUST BE CALLED ONLY WHEN CALLER HOLDS LOCK TO THE LIST OF RAW BLOCKS IN THE DATA TABLE
-     */
     SlotIterator(const DataTable *table, uint32_t block_index, int32_t num_advances, uint32_t offset_in_block)
         : table_(table), block_index_(block_index), num_advances_(num_advances) {
-      current_slot_ = {block_index >= table_->blocks_.size() ? nullptr : table->blocks_[block_index], offset_in_block};
+      current_slot_ = {block_index >= table_->blocks_.Size() ? nullptr : table->blocks_[block_index], offset_in_block};
       TERRIER_ASSERT((current_slot_.GetBlock() == nullptr && current_slot_.GetOffset() == 0) ||
                          current_slot_.GetBlock() != nullptr,
                      "Offset should be 0 when block is nullptr.");
@@ -175,11 +174,27 @@ class DataTable {
   void Scan(common::ManagedPointer<transaction::TransactionContext> txn, SlotIterator *start_pos,
             execution::sql::VectorProjection *out_buffer) const;
 
+  /**
+   * Reads the tuples of a frozen block in place, starting from the given iterator, without materializing them. If the
+   * iterator points into a block that is frozen and an in-place read on it can be acquired, the columns of the output
+   * buffer are made to reference up to as many of the block's column buffers as fit. Since frozen blocks are compacted
+   * and have no live versions, every tuple up to the block's record count is visible. Varlen columns reference the
+   * VarlenEntry column of the block, which the compactor has already pointed at the block's gathered or dictionary
+   * Arrow buffers, so no varlen is copied either. The given iterator is advanced past the tuples read.
+   *
+   * @param start_pos iterator to the starting location for the sequential scan
+   * @param out_buffer output buffer. It is always cleared of old values when a block is read in place.
+   * @return the block being read in place, on which the caller must call controller_.ReleaseInPlaceRead(out_buffer)
+   *         once it is done with the output buffer, or nullptr if the block is not frozen and the caller should use
+   *         Scan instead. Should the calling thread write to the block before then, the output buffer is first copied
+   *         out of the block.
+   */
+  RawBlock *ScanFrozenInPlace(SlotIterator *start_pos, execution::sql::VectorProjection *out_buffer) const;
+
   /**
    * @return the first tuple slot contained in the data table
    */
   SlotIterator begin() const {  // NOLINT for STL name compatibility
-    common::SpinLatch::ScopedSpinLatch guard(&blocks_latch_);
     return {this, 0, SlotIterator::ADVANCE_TO_THE_END, 0};
   }
 
@@ -226,6 +241,19 @@ class DataTable {
    */
   TupleSlot Insert(common::ManagedPointer<transaction::TransactionContext> txn, const ProjectedRow &redo);
 
+  /**
+   * Inserts a batch of tuples, as given in the redos. Rather than looking for a free slot for every tuple, consecutive
+   * slots are claimed in one step from a block with room for them, so that the tuples of a batch mostly end up next to
+   * each other. The slots allocated for the tuples are written to results, in the order of the redos.
+   *
+   * @param txn the calling transaction
+   * @param redos after-images of the inserted tuples. Should not reference col_id 0
+   * @param num_tuples number of tuples to insert
+   * @param[out] results array of at least num_tuples slots to write the allocated slots to
+   */
+  void InsertBatch(common::ManagedPointer<transaction::TransactionContext> txn, const ProjectedRow *const *redos,
+                   uint32_t num_tuples, TupleSlot *results);
+
   /**
    * Deletes the given TupleSlot, this will call StageDelete on the provided txn to generate the RedoRecord for delete.
    * The rest of the behavior follows Update's behavior.
@@ -243,7 +271,7 @@ class DataTable {
   /**
    * @return Number of blocks in the data table.
    */
-  uint32_t GetNumBlocks() const { return blocks_.size(); }
+  uint32_t GetNumBlocks() const { return blocks_.Size(); }
 
   /** @return Maximum number of blocks in the data table. */
   static uint32_t GetMaxBlocks() { return std::numeric_limits<uint32_t>::max(); }
@@ -251,7 +279,7 @@ class DataTable {
   /**
    * @return a coarse estimation on the number of tuples in this table
    */
-  uint64_t GetNumTuple() const { return GetBlockLayout().NumSlots() * blocks_.size(); }
+  uint64_t GetNumTuple() const { return GetBlockLayout().NumSlots() * blocks_.Size(); }
 
   /**
    * @return Approximate heap usage of the table
@@ -259,9 +287,21 @@ class DataTable {
   size_t EstimateHeapUsage() const {
     // This is a back-of-the-envelope calculation that could be innacurate. It does not account for the delta chain
     // elements that are actually owned by TransactionContext
-    return blocks_.size() * common::Constants::BLOCK_SIZE;
+    return blocks_.Size() * common::Constants::BLOCK_SIZE;
   }
 
+  /**
+   * Keeps the block compactor from moving tuples of this table or freezing its blocks from now on. Tuple movement does
+   * not maintain indexes, so this is called once the table has any, and on DROP TABLE before the table is freed.
+   * Blocks that are already frozen stay frozen.
+   */
+  void DisallowCompaction() { compactable_.store(false); }
+
+  /**
+   * @return whether the block compactor may move tuples of this table and freeze its blocks
+   */
+  bool IsCompactable() const { return compactable_.load(); }
+
  private:
   // The ArrowSerializer needs access to its blocks.
   friend class ArrowSerializer;
@@ -283,17 +323,24 @@ class DataTable {
   const layout_version_t layout_version_;
   const TupleAccessStrategy accessor_;
 
-  // TODO(Tianyu): For now, on insertion, we simply sequentially go through a block and allocate a
-  // new one when the current one is full. Needless to say, we will need to revisit this when extending GC to handle
-  // deleted tuples and recycle slots
-  std::vector<RawBlock *> blocks_;
-  // latch used to protect block list
-  mutable common::SpinLatch blocks_latch_;
-  // latch used to protect insertion_head_
-  mutable common::SpinLatch header_latch_;
+  // On insertion, we first try to reuse a slot freed up by a delete, and otherwise sequentially go through a block and
+  // allocate a new one when the current one is full.
+  // Blocks are only ever appended, so scans and inserts can read the list without latching.
+  // Fully empty blocks are refilled through free_slots_ rather than given back to the block store, as removing them
+  // from the list would need to wait out every scan that could still be holding on to them.
+  common::ConcurrentAppendOnlyVector<RawBlock *> blocks_;
+  // Slots of deleted tuples that no running transaction or index can reach anymore. Inserts take from here before
+  // appending to the end of the table.
+  common::ConcurrentQueue<TupleSlot> free_slots_;
+  // Index of the first block that may still have free slots. Inserts spread over the blocks from here to the end of
+  // the list, up to NUM_INSERTION_HEADS of them, so concurrent inserters do not all fight over the same block.
   std::atomic<uint32_t> insertion_head_;
-  // Check if we need to advance the insertion_head_
-  // This function uses header_latch_ to ensure correctness
+  static constexpr uint32_t NUM_INSERTION_HEADS = 8;
+  // Number of free slots an insert looks at before giving up and appending instead, so that slots in blocks that are
+  // not hot, which are kept on the queue until they are, do not hold up inserts.
+  static constexpr uint32_t MAX_FREE_SLOT_PROBES = 8;
+  std::atomic<bool> compactable_{true};
+  // Advance insertion_head_ past the given block, which was found to be full, if it is still the head.
   void CheckMoveHead(uint32_t block_index);
 
   // A templatized version for select, so that we can use the same code for both row and column access.
@@ -302,14 +349,42 @@ class DataTable {
   bool SelectIntoBuffer(common::ManagedPointer<transaction::TransactionContext> txn, TupleSlot slot,
                         RowType *out_buffer) const;
 
+  // Copies as many slots as possible starting from the iterator, up to the end of its block, straight out of the
+  // block's columns into the output buffer starting at row filled, if the block's version synopsis says no slot in it
+  // has a version chain. Visibility is decided by the allocation and logical delete bitmaps alone. Advances the
+  // iterator past the copied slots and returns how many were copied, or 0 if the caller needs to fall back to
+  // SelectIntoBuffer.
+  uint32_t ScanRangeInPlace(SlotIterator *start_pos, execution::sql::VectorProjection *out_buffer,
+                            uint32_t filled) const;
+
+  // Claims up to max_slots consecutive empty slots in a single block, appending a new block if none of the blocks from
+  // the insertion head on has room left. Returns the number of slots claimed, which is at least 1.
+  uint32_t AllocateSlots(uint32_t max_slots, TupleSlot *slots);
+
   void InsertInto(common::ManagedPointer<transaction::TransactionContext> txn, const ProjectedRow &redo,
                   TupleSlot dest);
+
+  // Inserts into a slot taken from free_slots_, if one can be claimed without waiting. Returns false if the caller
+  // needs to fall back to allocating a new slot.
+  bool InsertIntoFreeSlot(common::ManagedPointer<transaction::TransactionContext> txn, const ProjectedRow &redo,
+                          TupleSlot *dest);
+
+  // Hands the slot of a deleted tuple, or of a rolled back insert, back to the table for a later insert to reuse. The
+  // The GC calls this in a deferred action it registers once it has unlinked the transaction that freed the slot, by
+  // which point the indexes no longer point to the slot either. The slot of a deleted tuple stays allocated until
+  // then, so that neither an insert nor the compactor can take it, and its varlens are not collected from whatever is
+  // inserted next. It is deallocated here.
+  void RecycleSlot(const TupleSlot slot, const bool deallocate) {
+    if (deallocate) accessor_.Deallocate(slot);
+    free_slots_.Enqueue(slot);
+  }
+
   // Atomically read out the version pointer value.
   UndoRecord *AtomicallyReadVersionPtr(TupleSlot slot, const TupleAccessStrategy &accessor) const;
 
-  // Atomically write the version pointer value. Should only be used by Insert where there is guaranteed to be no
-  // contention
-  void AtomicallyWriteVersionPtr(TupleSlot slot, const TupleAccessStrategy &accessor, UndoRecord *desired);
+  // Atomically write the version pointer value, returning the previous one. Should only be used by Insert where there
+  // is guaranteed to be no contention
+  UndoRecord *AtomicallyWriteVersionPtr(TupleSlot slot, const TupleAccessStrategy &accessor, UndoRecord *desired);
 
   // Checks for Snapshot Isolation conflicts, used by Update
   bool HasConflict(const transaction::TransactionContext &txn, UndoRecord *version_ptr) const;
@@ -325,8 +400,24 @@ class DataTable {
   bool Visible(TupleSlot slot, const TupleAccessStrategy &accessor) const;
 
   // Compares and swaps the version pointer to be the undo record, only if its value is equal to the expected one.
+  // Const, as it only changes the contents of the block, so that readers can prune version chains.
   bool CompareAndSwapVersionPtr(TupleSlot slot, const TupleAccessStrategy &accessor, UndoRecord *expected,
-                                UndoRecord *desired);
+                                UndoRecord *desired) const;
+
+  // Returns true if no transaction running alongside the given one can see the version before the undo record, so that
+  // the record and everything after it in its version chain can be unlinked.
+  static bool Prunable(const transaction::TransactionContext &txn, const UndoRecord *undo);
+
+  // Unlinks the undo record found in the version chain of the slot, and every record after it, if the given
+  // transaction knows that nobody can see them anymore. The record follows newer in the chain, or is its head if newer
+  // is nullptr. Like the GC's truncation, this only ever sets pointers to nullptr, so that it is safe alongside the GC
+  // and other pruners, and leaves reclaiming the records to the GC.
+  void PruneVersionChain(const transaction::TransactionContext &txn, TupleSlot slot, UndoRecord *newer,
+                         UndoRecord *undo) const;
+
+  // Copies the buffers through which the calling thread reads the block in place out of the block, before the thread
+  // writes to it, so that the thread does not see its own writes change what it has already read.
+  static void MaterializeOwnInPlaceReads(RawBlock *block);
 
   // Allocates a new block to be used as insertion head.
   RawBlock *NewBlock();
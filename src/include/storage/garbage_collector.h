@@ -4,8 +4,11 @@
 #include <tuple>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
+#include "common/resource_tracker.h"
 #include "common/shared_latch.h"
+#include "common/worker_pool.h"
 #include "storage/storage_defs.h"
 #include "transaction/transaction_defs.h"
 
@@ -20,6 +23,7 @@ namespace terrier::storage {
 
 class AccessObserver;
 class DataTable;
+class SqlTable;
 class UndoRecord;
 
 namespace index {
@@ -31,6 +35,13 @@ class Index;
  * Based on the contents of this queue, it unlinks the UndoRecords from their version chains when no running
  * transactions can view those versions anymore. It then stores those transactions to attempt to deallocate on the next
  * iteration if no running transactions can still hold references to them.
+ *
+ * Transactions are unlinked on the thread that invokes the GC by default. With several workers, the transactions that
+ * are safe to unlink on an invocation are handed to a pool of threads instead. The invoking thread deals out the
+ * version chains of their undo records by the blocks they are in, and each worker truncates the version chains in its
+ * share of the blocks, so that every version chain is still truncated by a single thread. Each worker also reclaims the
+ * varlens of its share of the transactions. Small batches of transactions are unlinked on the
+ * invoking thread, as handing them off would cost more than it saves.
  */
 class GarbageCollector {
  public:
@@ -79,6 +90,15 @@ class GarbageCollector {
    */
   void UnregisterIndexForGC(common::ManagedPointer<index::Index> index);
 
+  /**
+   * Keeps the block compactor away from a table that is being dropped, and makes the access observer and the compactor
+   * forget about its blocks. This must run on the thread that performs garbage collection, which is where deferred
+   * actions run, and in an earlier deferred action than the one that frees the table, so that a compaction
+   * transaction that started before this call is unlinked by then.
+   * @param table the table being dropped
+   */
+  void UnregisterTableForCompaction(common::ManagedPointer<const SqlTable> table);
+
   /**
    * Set the GC interval for metrics collection
    * TODO(lma): this need to be called in the settings callback after we add the ability to change the GC interval
@@ -86,7 +106,29 @@ class GarbageCollector {
    */
   void SetGCInterval(uint64_t gc_interval) { gc_interval_ = gc_interval; }
 
+  /**
+   * Set the number of threads that unlink transactions. Must not be called concurrently with garbage collection.
+   * @param num_workers number of threads, 1 to unlink on the thread that invokes the GC
+   */
+  void SetNumWorkers(uint32_t num_workers);
+
+  /**
+   * @return number of threads that unlink transactions
+   */
+  uint32_t NumWorkers() const { return num_workers_; }
+
  private:
+  // What a worker did while unlinking transactions on one GC invocation
+  struct UnlinkWork {
+    uint32_t txns_processed_ = 0;
+    uint32_t buffer_processed_ = 0;
+    uint32_t slots_truncated_ = 0;
+    common::ResourceTracker::Metrics resource_metrics_;
+  };
+
+  // Minimum number of transactions a worker gets on an invocation, below which we use fewer workers
+  static constexpr uint32_t MIN_TXNS_PER_WORKER = 32;
+
   /**
    * Process the deallocate queue
    * @return number of txns (not UndoRecords) processed for debugging/testing
@@ -95,19 +137,58 @@ class GarbageCollector {
 
   /**
    * Process the unlink queue
+   * @param oldest_txn start time of the oldest running transaction
+   * @param track_resources true to measure the resources used by every worker
    * @return a tuple
    *   first element - number of txns processed
    *   second element - number UndoRecords processed
    *   first element - number of read-only txns processed
    */
-  std::tuple<uint32_t, uint32_t, uint32_t> ProcessUnlinkQueue(transaction::timestamp_t oldest_txn);
+  std::tuple<uint32_t, uint32_t, uint32_t> ProcessUnlinkQueue(transaction::timestamp_t oldest_txn,
+                                                              bool track_resources);
 
   /**
    * Process deferred actions
    */
   void ProcessDeferredActions(transaction::timestamp_t oldest_txn);
 
-  void ReclaimSlotIfDeleted(UndoRecord *undo_record) const;
+  /**
+   * Unlinks the given transactions, on the workers if there are enough of them, and fills unlink_work_
+   * @param txns transactions that are safe to unlink
+   * @param oldest_txn start time of the oldest running transaction
+   * @param track_resources true to measure the resources used by every worker
+   */
+  void UnlinkTransactions(const std::vector<transaction::TransactionContext *> &txns,
+                          transaction::timestamp_t oldest_txn, bool track_resources);
+
+  /**
+   * Does one worker's share of unlinking the given transactions, truncating the version chains dealt out to it in
+   * unlink_slots_
+   * @param txns transactions that are safe to unlink
+   * @param oldest_txn start time of the oldest running transaction
+   * @param partition the worker's share
+   * @param num_partitions number of shares the work is split into
+   * @param work where to record what the worker did
+   */
+  void UnlinkPartition(const std::vector<transaction::TransactionContext *> &txns, transaction::timestamp_t oldest_txn,
+                       uint32_t partition, uint32_t num_partitions, UnlinkWork *work) const;
+
+  /**
+   * @param slot a tuple slot
+   * @param num_partitions number of shares the work is split into
+   * @return the share of the work that truncates the version chain of the slot. All slots of a block are in the same
+   * share, so that a worker keeps to its own blocks.
+   */
+  static uint32_t PartitionOf(const TupleSlot slot, const uint32_t num_partitions) {
+    return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(slot.GetBlock()) / common::Constants::BLOCK_SIZE %
+                                 num_partitions);
+  }
+
+  /**
+   * Hands the slots that an unlinked transaction freed back to their tables, once the indexes no longer point to them
+   * @param txn a transaction that was just unlinked
+   */
+  void RecycleSlots(transaction::TransactionContext *txn) const;
 
   void ReclaimBufferIfVarlen(transaction::TransactionContext *txn, UndoRecord *undo_record) const;
 
@@ -130,6 +211,14 @@ class GarbageCollector {
   common::SharedLatch indexes_latch_;
 
   uint64_t gc_interval_{0};
+
+  // Threads that unlink transactions when there is more than one worker
+  uint32_t num_workers_ = 1;
+  common::WorkerPool unlink_pool_{1, {}};
+  // What each worker did on the last invocation that unlinked transactions
+  std::vector<UnlinkWork> unlink_work_;
+  // Version chains each worker truncates on the current invocation
+  std::vector<std::vector<std::pair<DataTable *, TupleSlot>>> unlink_slots_;
 };
 
 }  // namespace terrier::storage
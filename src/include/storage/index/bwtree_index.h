@@ -42,6 +42,10 @@ class BwTreeIndex final : public Index {
       std::hash<KeyType>, std::equal_to<TupleSlot>, std::hash<TupleSlot>>>
       bwtree_;
 
+  // Builds the keys of the given tuples, paired with their locations, sorted by key
+  std::vector<std::pair<KeyType, TupleSlot>> SortedEntries(const ProjectedRow *const *tuples,
+                                                           const TupleSlot *locations, uint32_t num_tuples) const;
+
  public:
   IndexType Type() const final { return IndexType::BWTREE; }
 
@@ -55,6 +59,26 @@ class BwTreeIndex final : public Index {
   bool InsertUnique(common::ManagedPointer<transaction::TransactionContext> txn, const ProjectedRow &tuple,
                     TupleSlot location) final;
 
+  /**
+   * Sorts the keys before inserting them, so that consecutive inserts mostly go down the same path of the tree and land
+   * in leaves that are already cached. A single abort action removes the whole batch.
+   */
+  void InsertBatch(common::ManagedPointer<transaction::TransactionContext> txn, const ProjectedRow *const *tuples,
+                   const TupleSlot *locations, uint32_t num_tuples) final;
+
+  /**
+   * Sorts the keys before inserting them, like InsertBatch.
+   */
+  bool InsertUniqueBatch(common::ManagedPointer<transaction::TransactionContext> txn,
+                         const ProjectedRow *const *tuples, const TupleSlot *locations, uint32_t num_tuples) final;
+
+  /**
+   * Builds the keys on all cores, sorts them and then builds the tree bottom-up, one full node after another, instead
+   * of inserting the keys one at a time. Falls back to inserting one at a time if the tree is not empty.
+   */
+  bool BulkLoad(common::ManagedPointer<transaction::TransactionContext> txn, const ProjectedRow *const *tuples,
+                const TupleSlot *locations, uint64_t num_tuples) final;
+
   void Delete(common::ManagedPointer<transaction::TransactionContext> txn, const ProjectedRow &tuple,
               TupleSlot location) final;
 
@@ -65,6 +65,13 @@ class HashIndex final : public Index {
   bool InsertUnique(common::ManagedPointer<transaction::TransactionContext> txn, const ProjectedRow &tuple,
                     TupleSlot location) final;
 
+  /**
+   * Makes room for all keys up front, so that the table is not rehashed over and over as it grows, and then inserts
+   * the keys on all cores. Falls back to inserting one at a time if the index is not empty.
+   */
+  bool BulkLoad(common::ManagedPointer<transaction::TransactionContext> txn, const ProjectedRow *const *tuples,
+                const TupleSlot *locations, uint64_t num_tuples) final;
+
   void Delete(common::ManagedPointer<transaction::TransactionContext> txn, const ProjectedRow &tuple,
               TupleSlot location) final;
 
@@ -93,6 +93,63 @@ class Index {
   virtual bool InsertUnique(common::ManagedPointer<transaction::TransactionContext> txn, const ProjectedRow &tuple,
                             TupleSlot location) = 0;
 
+  /**
+   * Inserts a batch of key-value pairs into the index, used for non-unique key indexes. By default the keys are
+   * inserted one at a time, indexes that can take advantage of having many keys at once override this.
+   * @param txn txn context for the calling txn, used to register abort actions
+   * @param tuples keys
+   * @param locations values, in the order of the keys
+   * @param num_tuples number of key-value pairs to insert
+   */
+  virtual void InsertBatch(const common::ManagedPointer<transaction::TransactionContext> txn,
+                           const ProjectedRow *const *const tuples, const TupleSlot *const locations,
+                           const uint32_t num_tuples) {
+    for (uint32_t i = 0; i < num_tuples; i++) Insert(txn, *tuples[i], locations[i]);
+  }
+
+  /**
+   * Inserts a batch of key-value pairs only if any matching keys have TupleSlots that don't conflict with the calling
+   * txn. Stops at the first key that cannot be inserted, in which case the txn must abort, as with InsertUnique.
+   * @param txn txn context for the calling txn, used for visibility and write-write, and to register abort actions
+   * @param tuples keys
+   * @param locations values, in the order of the keys
+   * @param num_tuples number of key-value pairs to insert
+   * @return true if all values were inserted, false otherwise
+   */
+  virtual bool InsertUniqueBatch(const common::ManagedPointer<transaction::TransactionContext> txn,
+                                 const ProjectedRow *const *const tuples, const TupleSlot *const locations,
+                                 const uint32_t num_tuples) {
+    for (uint32_t i = 0; i < num_tuples; i++) {
+      if (!InsertUnique(txn, *tuples[i], locations[i])) return false;
+    }
+    return true;
+  }
+
+  /**
+   * Fills an index that was just created with the key-value pairs of all tuples visible to the calling txn, as done by
+   * CREATE INDEX. The index must not be visible to any other txn yet. Implementations need not be able to undo the
+   * load, as the whole index is dropped if the calling txn aborts. By default the keys are inserted one at a time.
+   * @param txn txn context for the calling txn, used for visibility and write-write
+   * @param tuples keys
+   * @param locations values, in the order of the keys
+   * @param num_tuples number of key-value pairs to load
+   * @return true if all values were loaded, false if a key of a unique index is repeated, in which case the txn must
+   * abort
+   */
+  virtual bool BulkLoad(const common::ManagedPointer<transaction::TransactionContext> txn,
+                        const ProjectedRow *const *const tuples, const TupleSlot *const locations,
+                        const uint64_t num_tuples) {
+    const bool unique = metadata_.GetSchema().Unique();
+    for (uint64_t i = 0; i < num_tuples; i++) {
+      if (!unique) {
+        Insert(txn, *tuples[i], locations[i]);
+      } else if (!InsertUnique(txn, *tuples[i], locations[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   /**
    * Doesn't immediately call delete on the index. Registers a commit action in the txn that will eventually register a
    * deferred action for the GC to safely call delete on the index when no more transactions need to access the key.
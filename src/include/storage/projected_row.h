@@ -269,6 +269,7 @@ class ProjectedRowInitializer {
   friend class execution::sql::StorageInterface;  // access to the PRI default constructor
   friend class WriteAheadLoggingTests;
   friend class AbstractLogProvider;
+  friend class CheckpointLogProvider;
 
   /**
    * Constructs a ProjectedRowInitializer. Calculates the size of this ProjectedRow, including all members, values,
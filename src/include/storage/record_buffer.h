@@ -341,6 +341,17 @@ class RedoBuffer {
    */
   byte *NewEntry(uint32_t size);
 
+  /**
+   * Reserve up to the given number of redo records of the same size, laid out back to back in the same segment. At
+   * least one record is always reserved, and as many more as fit into the segment the first one lands in. The returned
+   * pointer is guaranteed to be valid until NewEntry or NewEntries is called again, or the buffer is flushed.
+   * @param size the size of each redo record to allocate
+   * @param max_entries the largest number of records to reserve, which must be at least 1
+   * @param[out] num_entries the number of records reserved
+   * @return the first of the reserved records, the i-th one starts size * i bytes after it
+   */
+  byte *NewEntries(uint32_t size, uint32_t max_entries, uint32_t *num_entries);
+
   /**
    * Flush all contents of the redo buffer to be logged out, effectively closing this redo buffer. No further entries
    * can be written to this redo buffer after the function returns.
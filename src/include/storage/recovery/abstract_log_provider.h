@@ -17,13 +17,15 @@ namespace terrier::storage {
  */
 class AbstractLogProvider {
  public:
+  virtual ~AbstractLogProvider() = default;
+
   /**
    * Provide next available log record
    * @warning Can be a blocking call if provider is waiting to receive more logs
    * @return next log record along with vector of varlen entry pointers. nullptr log record if no more logs will be
    * provided.
    */
-  std::pair<LogRecord *, std::vector<byte *>> GetNextRecord() {
+  virtual std::pair<LogRecord *, std::vector<byte *>> GetNextRecord() {
     return HasMoreRecords() ? ReadNextRecord() : std::make_pair(nullptr, std::vector<byte *>());
   }
 
@@ -46,6 +48,13 @@ class AbstractLogProvider {
    */
   virtual bool Read(void *dest, uint32_t size) = 0;
 
+  /**
+   * Skip over padding in the log, which starts with a zero record size. Only logs written with direct I/O contain
+   * padding (@see BufferedLogWriter), so providers of other logs can leave this as is.
+   * @return true if provider has more records to provide after the padding. false otherwise
+   */
+  virtual bool SkipPadding() { throw std::runtime_error("Unexpected padding in log"); }
+
  private:
   // TODO(Gus): Support a more fail-safe way than just throwing an exception
   /**
@@ -61,10 +70,11 @@ class AbstractLogProvider {
     return result;
   }
 
+ protected:
   /**
    * Reads in the next log record from the log provider
    * @warning If the serialization format of logs ever changes, this function will need to be updated.
-   * @return next log record, along with vector of varlen entry pointers
+   * @return next log record, along with vector of varlen entry pointers. nullptr log record if the log ends in padding
    */
   std::pair<LogRecord *, std::vector<byte *>> ReadNextRecord();
 };
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "storage/recovery/abstract_log_provider.h"
+#include "storage/recovery/checkpoint_manager.h"
+#include "storage/write_ahead_log/log_io.h"
+
+namespace terrier::storage {
+
+/**
+ * @brief Log provider for checkpoints
+ * Provides the contents of a checkpoint (@see CheckpointManager) to the recovery manager as if it had been logged, so
+ * that it is recovered the same way as the log is, catalog tables included. Every batch of tuples in the checkpoint is
+ * provided as inserts with the tuple slots they had when the checkpoint was taken, followed by a commit. Tables and
+ * indexes are created by updating the pointer column of their pg_class entries, like when they were first created.
+ *
+ * All records carry the timestamp of the checkpoint, and their commits have no older active transaction, so the
+ * recovery manager replays each of them as soon as it sees it.
+ */
+class CheckpointLogProvider : public AbstractLogProvider {
+ public:
+  /**
+   * @param checkpoint_file_path path to the checkpoint file to read
+   */
+  explicit CheckpointLogProvider(const std::string &checkpoint_file_path);
+
+  /**
+   * Provide the next record of the checkpoint
+   * @return next log record along with vector of varlen entry pointers. nullptr log record if the checkpoint has been
+   * read in full
+   */
+  std::pair<LogRecord *, std::vector<byte *>> GetNextRecord() override;
+
+  /**
+   * @return start timestamp of the transaction that took the checkpoint. Transactions that committed before it are
+   * already in the checkpoint.
+   */
+  transaction::timestamp_t CheckpointTimestamp() const { return timestamp_; }
+
+ private:
+  std::unique_ptr<BufferedLogReader> reader_;
+  transaction::timestamp_t timestamp_;
+  // Records of the last section or batch read that have not been handed out yet
+  std::deque<std::pair<LogRecord *, std::vector<byte *>>> pending_records_;
+  bool reached_end_ = false;
+
+  // Table whose tuples are being read
+  bool in_table_ = false;
+  catalog::db_oid_t table_db_oid_;
+  catalog::table_oid_t table_oid_;
+  // Attribute sizes (with the varlen bit) of the table's columns in the order they are written
+  std::vector<uint16_t> table_attr_sizes_;
+  // Index in the records' ProjectedRows of each of the table's columns in the order they are written
+  std::vector<uint16_t> table_pr_indexes_;
+  ProjectedRowInitializer table_initializer_;
+
+  /**
+   * @return true if the checkpoint has records left to provide
+   */
+  bool HasMoreRecords() override { return !pending_records_.empty() || !reached_end_; }
+
+  /**
+   * Read data from the checkpoint file into the destination provided
+   * @param dest pointer to location to read into
+   * @param size number of bytes to read
+   * @return true if we read the given number of bytes
+   */
+  bool Read(void *dest, uint32_t size) override { return reader_->Read(dest, size); }
+
+  // Reads exactly the given number of bytes, or throws if the checkpoint is truncated
+  void ReadFully(void *dest, uint32_t size);
+
+  template <class T>
+  T ReadCheckpointValue() {
+    T result;
+    ReadFully(&result, sizeof(T));
+    return result;
+  }
+
+  // Reads the next section, or the next batch of the table being read, into the pending records
+  void ReadNext();
+
+  // Reads the columns of a table, after which its batches follow
+  void ReadTableHeader();
+
+  // Reads a batch of tuples of the table being read
+  void ReadTableBatch();
+
+  // Reads the tables and indexes of a database that need to be created
+  void ReadClassObjects();
+
+  // Adds a commit of everything read so far to the pending records
+  void AddCommit();
+};
+
+}  // namespace terrier::storage
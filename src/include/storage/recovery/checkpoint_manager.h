@@ -0,0 +1,162 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "catalog/catalog_defs.h"
+#include "common/managed_pointer.h"
+#include "storage/projected_columns.h"
+#include "storage/storage_defs.h"
+#include "transaction/transaction_defs.h"
+
+namespace terrier::catalog {
+class Catalog;
+}  // namespace terrier::catalog
+
+namespace terrier::transaction {
+class TimestampManager;
+class TransactionContext;
+class TransactionManager;
+}  // namespace terrier::transaction
+
+namespace terrier::storage {
+class BufferedLogWriter;
+class LogManager;
+class SqlTable;
+
+/**
+ * Header at the start of every checkpoint file
+ */
+struct CheckpointHeader {
+  /**
+   * Identifies a file as a checkpoint
+   */
+  static constexpr uint64_t MAGIC = 0x544E494F504B4843;  // "CHKPOINT"
+
+  /**
+   * Always MAGIC for a checkpoint file
+   */
+  uint64_t magic_ = MAGIC;
+  /**
+   * Start timestamp of the transaction that took the checkpoint. The checkpoint contains exactly what transactions
+   * that committed before this timestamp have done.
+   */
+  transaction::timestamp_t timestamp_ = transaction::INITIAL_TXN_TIMESTAMP;
+};
+
+/**
+ * Kind of a section of a checkpoint file, which is written in front of it
+ */
+enum class CheckpointSection : uint8_t {
+  /**
+   * Contents of a table, followed by the database oid, table oid, number of columns, and the column ids and attribute
+   * sizes (with the varlen bit) of all columns. The tuples of the table follow in batches, each starting with the
+   * number of tuples in it and their tuple slots, followed by each column in turn as a null bitmap and the non-null
+   * values. Varlen values are written as their size followed by their content. A batch of zero tuples ends the table.
+   */
+  TABLE = 1,
+  /**
+   * Tables and indexes of a database whose objects need to be created, followed by the database oid, the column id of
+   * the pointer column of pg_class, the number of objects, and the tuple slots of their pg_class entries
+   */
+  CLASS_OBJECTS,
+  /**
+   * End of the checkpoint
+   */
+  END
+};
+
+/**
+ * Takes checkpoints of the whole database system, so that recovery only has to replay the log written after the last
+ * checkpoint instead of all of it.
+ *
+ * A checkpoint is a consistent snapshot of every SqlTable, the catalog tables included, as seen by a read-only
+ * transaction. The snapshot is fuzzy in that it does not stop anyone from working while it is taken: because of MVCC,
+ * the checkpoint contains exactly what transactions that committed before the checkpointing transaction began have
+ * done. Tables are written a block at a time, column by column, as they come out of a scan into ProjectedColumns.
+ * Every tuple is written with the tuple slot it had when the checkpoint was taken, so that log records written after
+ * the checkpoint that update or delete it can be matched to it during recovery (@see CheckpointLogProvider).
+ *
+ * Checkpoints are numbered in the order they are taken, and each is written to a temporary file that is only renamed to
+ * its final name once it is complete and persistent, so an incomplete checkpoint is never mistaken for one. Once a new
+ * checkpoint is in place, older ones are deleted, and so are the log segments that are no longer needed to recover
+ * from it (@see LogManager::DiscardSegments).
+ *
+ * Like the log itself, a checkpoint is only meaningful along with the log written by the same run of the system, as
+ * timestamps start over when the system is restarted.
+ */
+class CheckpointManager {
+ public:
+  /**
+   * @param checkpoint_file_path path that the numbers of checkpoint files are appended to
+   * @param catalog catalog whose databases are checkpointed
+   * @param txn_manager transaction manager to take checkpoints with
+   * @param timestamp_manager timestamp manager of the transaction manager
+   * @param log_manager log manager whose segments are discarded after a checkpoint, or nullptr if logging is disabled
+   */
+  CheckpointManager(std::string checkpoint_file_path, common::ManagedPointer<catalog::Catalog> catalog,
+                    common::ManagedPointer<transaction::TransactionManager> txn_manager,
+                    common::ManagedPointer<transaction::TimestampManager> timestamp_manager,
+                    common::ManagedPointer<LogManager> log_manager);
+
+  /**
+   * Takes a checkpoint, and deletes older checkpoints and log segments that are no longer needed
+   * @return path of the checkpoint file
+   */
+  std::string TakeCheckpoint();
+
+  /**
+   * @param checkpoint_file_path path that the numbers of checkpoint files are appended to
+   * @param checkpoint_id number of a checkpoint
+   * @return path of the given checkpoint
+   */
+  static std::string CheckpointFilePath(const std::string &checkpoint_file_path, const uint64_t checkpoint_id) {
+    return checkpoint_file_path + "." + std::to_string(checkpoint_id);
+  }
+
+  /**
+   * @param checkpoint_file_path path that the numbers of checkpoint files are appended to
+   * @return numbers of the checkpoints that exist on disk, in ascending order
+   */
+  static std::vector<uint64_t> ListCheckpoints(const std::string &checkpoint_file_path);
+
+  /**
+   * @param checkpoint_file_path path that the numbers of checkpoint files are appended to
+   * @return path of the most recent checkpoint on disk, or an empty string if there is none
+   */
+  static std::string LatestCheckpointFilePath(const std::string &checkpoint_file_path);
+
+ private:
+  static constexpr const char *TEMP_SUFFIX = ".tmp";
+
+  const std::string checkpoint_file_path_;
+  const common::ManagedPointer<catalog::Catalog> catalog_;
+  const common::ManagedPointer<transaction::TransactionManager> txn_manager_;
+  const common::ManagedPointer<transaction::TimestampManager> timestamp_manager_;
+  const common::ManagedPointer<LogManager> log_manager_;
+
+  // Writes the databases visible to the transaction to the checkpoint
+  void WriteCheckpoint(BufferedLogWriter *out, transaction::TransactionContext *txn);
+
+  // Writes one database visible to the transaction to the checkpoint
+  void WriteDatabase(BufferedLogWriter *out, transaction::TransactionContext *txn, catalog::db_oid_t db_oid);
+
+  /**
+   * Writes the contents of a table visible to the transaction to the checkpoint
+   * @param out writer of the checkpoint file
+   * @param txn transaction taking the checkpoint
+   * @param db_oid database of the table
+   * @param table_oid oid of the table
+   * @param table the table
+   * @param inspect if not null, called on every batch of tuples before it is written, which it may modify
+   */
+  static void WriteTable(BufferedLogWriter *out, transaction::TransactionContext *txn, catalog::db_oid_t db_oid,
+                         catalog::table_oid_t table_oid, const SqlTable &table,
+                         const std::function<void(ProjectedColumns *)> &inspect = nullptr);
+
+  // Index of the given column in the batch
+  static uint16_t ColumnIndex(ProjectedColumns *columns, col_id_t col_id);
+};
+
+}  // namespace terrier::storage
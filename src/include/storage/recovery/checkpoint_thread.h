@@ -0,0 +1,101 @@
+#pragma once
+
+#include <chrono>              //NOLINT
+#include <condition_variable>  //NOLINT
+#include <mutex>               //NOLINT
+#include <thread>              //NOLINT
+
+#include "common/managed_pointer.h"
+#include "storage/recovery/checkpoint_manager.h"
+
+namespace terrier::metrics {
+class MetricsManager;
+}
+
+namespace terrier::storage {
+
+/**
+ * Class for spinning off a thread that takes checkpoints at a fixed interval. Checkpoints are usually far apart, so
+ * the thread waits on a condition variable rather than sleeping, so that stopping it does not have to wait out the
+ * interval.
+ */
+class CheckpointThread {
+ public:
+  /**
+   * @param checkpoint_manager pointer to the checkpoint manager that takes checkpoints on this thread
+   * @param checkpoint_period time between checkpoints
+   * @param metrics_manager Metrics Manager
+   */
+  CheckpointThread(common::ManagedPointer<CheckpointManager> checkpoint_manager,
+                   std::chrono::milliseconds checkpoint_period,
+                   common::ManagedPointer<metrics::MetricsManager> metrics_manager);
+
+  ~CheckpointThread() { StopCheckpointing(); }
+
+  /**
+   * Kill the checkpoint thread. A checkpoint that is being taken is finished first.
+   */
+  void StopCheckpointing() {
+    TERRIER_ASSERT(run_checkpointing_, "Checkpointing should already be running.");
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      run_checkpointing_ = false;
+    }
+    cv_.notify_all();
+    checkpoint_thread_.join();
+  }
+
+  /**
+   * Spawn the checkpoint thread if it has been previously stopped.
+   */
+  void StartCheckpointing() {
+    TERRIER_ASSERT(!run_checkpointing_, "Checkpointing should not already be running.");
+    run_checkpointing_ = true;
+    checkpointing_paused_ = false;
+    checkpoint_thread_ = std::thread([this] { CheckpointThreadLoop(); });
+  }
+
+  /**
+   * Pause checkpointing, typically for use in tests when the files on disk need to be fixed.
+   */
+  void PauseCheckpointing() {
+    TERRIER_ASSERT(!checkpointing_paused_, "Checkpointing should not already be paused.");
+    checkpointing_paused_ = true;
+  }
+
+  /**
+   * Resume checkpointing after being paused.
+   */
+  void ResumeCheckpointing() {
+    TERRIER_ASSERT(checkpointing_paused_, "Checkpointing should already be paused.");
+    checkpointing_paused_ = false;
+  }
+
+  /**
+   * @return the underlying checkpoint manager
+   */
+  common::ManagedPointer<CheckpointManager> GetCheckpointManager() { return checkpoint_manager_; }
+
+ private:
+  const common::ManagedPointer<CheckpointManager> checkpoint_manager_;
+  const common::ManagedPointer<metrics::MetricsManager> metrics_manager_;
+  bool run_checkpointing_;
+  volatile bool checkpointing_paused_;
+  std::chrono::milliseconds checkpoint_period_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::thread checkpoint_thread_;
+
+  void CheckpointThreadLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (run_checkpointing_) {
+      if (cv_.wait_for(lock, checkpoint_period_, [this] { return !run_checkpointing_; })) break;
+      if (checkpointing_paused_) continue;
+      lock.unlock();
+      checkpoint_manager_->TakeCheckpoint();
+      lock.lock();
+    }
+  }
+};
+
+}  // namespace terrier::storage
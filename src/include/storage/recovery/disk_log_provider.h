@@ -1,8 +1,13 @@
 #pragma once
 
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
+
 #include "storage/recovery/abstract_log_provider.h"
 #include "storage/write_ahead_log/log_io.h"
+#include "storage/write_ahead_log/log_manager.h"
 
 namespace terrier::storage {
 
@@ -10,30 +15,93 @@ namespace terrier::storage {
  * @brief Log provider for logs stored on disk
  * Provides logs to the recovery manager from logs persisted on disk. The log file is read in using the
  * BufferedLogReader.
+ *
+ * If the logs were written by several log streams (@see LogManager), the provider reads all of the stream files and
+ * merges them into a single log. Records of a transaction all live in one stream, so they are handed out as they are
+ * read, but commit records are held back until they are the oldest (by commit timestamp) commit at the head of any
+ * stream. Transactions are thus recovered in commit order, as they would have been from a single log file.
+ *
+ * If a stream's log was cut into segments, the provider reads all of the stream's segments that are left on disk in
+ * order, skipping over their headers. A log file written before the log manager was switched to segments is read
+ * first.
+ *
+ * Log files that the log manager rotated out of the way on a restart (@see LogManager::RotateEarlierRun) are read
+ * before the current ones, one run after another. Streams are only merged within a run, since commit timestamps
+ * restart with the system.
  */
 class DiskLogProvider : public AbstractLogProvider {
  public:
   /**
    * @param log_file_path path to log file to read logs from
+   * @param num_streams number of log streams the logs were written with
    */
-  explicit DiskLogProvider(const std::string &log_file_path) : in_(BufferedLogReader(log_file_path.c_str())) {}
+  explicit DiskLogProvider(const std::string &log_file_path, const uint32_t num_streams = 1);
+
+  /**
+   * Provide the next log record of the merged log streams
+   * @return next log record along with vector of varlen entry pointers. nullptr log record if all streams are exhausted
+   */
+  std::pair<LogRecord *, std::vector<byte *>> GetNextRecord() override;
 
  private:
-  // Buffered log file reader
-  storage::BufferedLogReader in_;
+  // Log files of a stream, and the reader of the one being read
+  struct StreamReader {
+    // The stream's log file if there is one, followed by all of its segment files in order
+    std::vector<std::string> files_;
+    // Whether files_ starts with a log file that is not a segment
+    bool has_unsegmented_file_ = false;
+    // Next file to read after the current one
+    size_t next_file_ = 0;
+    std::unique_ptr<BufferedLogReader> reader_;
+  };
+
+  // Log file paths of the runs still to be read after the current one, along with their number of streams
+  std::vector<std::pair<std::string, uint32_t>> runs_;
+  size_t next_run_ = 0;
+  // Streams of the run being read
+  std::vector<StreamReader> streams_;
+  // Stream that the next record is read from
+  uint32_t current_stream_ = 0;
+  // Commit record read from each stream that has not been handed out yet, or nullptr if there is none
+  std::vector<std::pair<LogRecord *, std::vector<byte *>>> pending_commits_;
 
   /**
-   * @return true if log file contains more records, false otherwise
+   * Moves on to reading the next run
    */
-  bool HasMoreRecords() override { return in_.HasMore(); }
+  void OpenNextRun();
 
   /**
-   * Read data from the log file into the destination provided
+   * @return next log record of the merged log streams of the current run, nullptr log record if they are exhausted
+   */
+  std::pair<LogRecord *, std::vector<byte *>> GetNextRecordOfRun();
+
+  /**
+   * @return true if the current log file contains more records, false otherwise
+   */
+  bool HasMoreRecords() override;
+
+  /**
+   * Read data from the current log file into the destination provided
    * @param dest pointer to location to read into
    * @param size number of bytes to read
    * @return true if we read the given number of bytes
    */
-  bool Read(void *dest, uint32_t size) override { return in_.Read(dest, size); }
+  bool Read(void *dest, uint32_t size) override { return streams_[current_stream_].reader_->Read(dest, size); }
+
+  /**
+   * Skip over padding in the current log file
+   * @return true if the current stream contains more records after the padding, false otherwise
+   */
+  bool SkipPadding() override {
+    streams_[current_stream_].reader_->SkipPadding();
+    return HasMoreRecords();
+  }
+
+  /**
+   * Moves on to reading the next log file of a stream
+   * @param stream stream to move on in
+   */
+  static void OpenNextFile(StreamReader *stream);
 };
 
 }  // namespace terrier::storage
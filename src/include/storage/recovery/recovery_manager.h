@@ -18,7 +18,10 @@
 #include "catalog/postgres/pg_namespace.h"
 #include "catalog/postgres/pg_type.h"
 #include "common/dedicated_thread_owner.h"
+#include "common/spin_latch.h"
+#include "common/worker_pool.h"
 #include "storage/recovery/abstract_log_provider.h"
+#include "storage/recovery/checkpoint_log_provider.h"
 #include "storage/sql_table.h"
 
 namespace terrier {
@@ -34,6 +37,15 @@ namespace terrier::storage {
 /**
  * Recovery Manager
  * TODO(Gus): Add more documentation when API is finalized
+ *
+ * Committed transactions are replayed serially by default. With several replay threads, transactions that only change
+ * user tables are gathered into batches instead, and the transactions of a batch are split into groups that touch
+ * disjoint sets of tuples (or of tables, if indexes are maintained during replay, as unique keys can move between
+ * tuples). The transactions of a group are replayed in order on one thread, and different groups are replayed
+ * concurrently. Transactions that change the catalog are replayed on their own, after everything that came before them.
+ *
+ * Maintenance of the indexes on user tables can also be deferred to the end of recovery, when every index on a table
+ * that was inserted into is rebuilt from the recovered table in one go.
  */
 class RecoveryManager : public common::DedicatedThreadOwner {
   /**
@@ -69,15 +81,19 @@ class RecoveryManager : public common::DedicatedThreadOwner {
    * @param deferred_action_manager manager to use for deferred deletes
    * @param thread_registry thread registry to register tasks
    * @param store block store used for SQLTable creation during recovery
+   * @param checkpoint_provider provider of the checkpoint to recover from before replaying the log, or nullptr to
+   * replay the log alone. Only the transactions in the log that committed after the checkpoint was taken are replayed.
    */
   explicit RecoveryManager(const common::ManagedPointer<AbstractLogProvider> log_provider,
                            const common::ManagedPointer<catalog::Catalog> catalog,
                            const common::ManagedPointer<transaction::TransactionManager> txn_manager,
                            const common::ManagedPointer<transaction::DeferredActionManager> deferred_action_manager,
                            const common::ManagedPointer<terrier::common::DedicatedThreadRegistry> thread_registry,
-                           const common::ManagedPointer<BlockStore> store)
+                           const common::ManagedPointer<BlockStore> store,
+                           const common::ManagedPointer<CheckpointLogProvider> checkpoint_provider = nullptr)
       : DedicatedThreadOwner(thread_registry),
         log_provider_(log_provider),
+        checkpoint_provider_(checkpoint_provider),
         catalog_(catalog),
         txn_manager_(txn_manager),
         deferred_action_manager_(deferred_action_manager),
@@ -94,6 +110,27 @@ class RecoveryManager : public common::DedicatedThreadOwner {
     catalog_table_schemas_[catalog::postgres::TYPE_TABLE_OID] = catalog::postgres::Builder::GetTypeTableSchema();
   }
 
+  /**
+   * Replays transactions on several threads. Must be called before recovery starts.
+   * @param num_threads number of threads to replay with, 1 to replay serially
+   */
+  void SetNumReplayThreads(const uint32_t num_threads) {
+    TERRIER_ASSERT(recovery_task_ == nullptr, "Replay threads must be configured before recovery starts");
+    TERRIER_ASSERT(num_threads > 0, "There must be at least one replay thread");
+    num_replay_threads_ = num_threads;
+    replay_pool_.SetNumWorkers(num_threads);
+  }
+
+  /**
+   * Defers maintenance of the indexes on user tables to the end of recovery, when they are rebuilt in bulk. Must be
+   * called before recovery starts.
+   * @param defer_index_builds true to rebuild indexes at the end of recovery, false to maintain them during replay
+   */
+  void SetDeferIndexBuilds(const bool defer_index_builds) {
+    TERRIER_ASSERT(recovery_task_ == nullptr, "Index builds must be configured before recovery starts");
+    defer_index_builds_ = defer_index_builds;
+  }
+
   /**
    * Starts a background recovery task. Recovery will fully recover until the log provider stops providing logs.
    */
@@ -106,12 +143,24 @@ class RecoveryManager : public common::DedicatedThreadOwner {
 
  private:
   FRIEND_TEST(RecoveryTests, DoubleRecoveryTest);
+  FRIEND_TEST(RecoveryTests, RestartCommitCrashRecoverTest);
   friend class RecoveryTests;
+  friend class ReplicationTests;
   friend class terrier::RecoveryBenchmark;
 
   // Log provider for reading in logs
   const common::ManagedPointer<AbstractLogProvider> log_provider_;
 
+  // Checkpoint provider for reading in the checkpoint to start recovery from, if there is one
+  const common::ManagedPointer<CheckpointLogProvider> checkpoint_provider_;
+
+  // Start timestamp of the transaction that took the checkpoint. Transactions in the log that committed before it are
+  // already in the checkpoint. Without a checkpoint, no transaction did.
+  transaction::timestamp_t checkpoint_timestamp_ = transaction::INITIAL_TXN_TIMESTAMP;
+
+  // Newest timestamp in the checkpoint and the log. The system's time is moved past it once recovery is done.
+  transaction::timestamp_t newest_timestamp_ = transaction::INITIAL_TXN_TIMESTAMP;
+
   // Catalog to fetch table pointers
   const common::ManagedPointer<catalog::Catalog> catalog_;
 
@@ -130,6 +179,23 @@ class RecoveryManager : public common::DedicatedThreadOwner {
   // TODO(Gus): This map may get huge, benchmark whether this becomes a problem and if we need a more sophisticated data
   // structure
   std::unordered_map<TupleSlot, TupleSlot> tuple_slot_map_;
+  // Protects tuple_slot_map_ and deferred_index_tables_ while transactions are replayed concurrently
+  common::SpinLatch tuple_slot_map_latch_;
+
+  // Number of threads to replay transactions with
+  uint32_t num_replay_threads_ = 1;
+  // Threads that replay batches of transactions, and rebuild deferred indexes
+  common::WorkerPool replay_pool_{1, {}};
+  // Maximum number of transactions gathered into a batch before it is replayed
+  static constexpr uint32_t REPLAY_BATCH_SIZE = 1024;
+  // Committed transactions that only change user tables and have not been replayed yet, in order, with their changes
+  std::vector<std::pair<transaction::timestamp_t, std::vector<std::pair<LogRecord *, std::vector<byte *>>>>>
+      replay_batch_;
+
+  // Whether the indexes on user tables are rebuilt at the end of recovery instead of maintained during replay
+  bool defer_index_builds_ = false;
+  // User tables that were inserted into while index maintenance was deferred
+  std::set<std::pair<catalog::db_oid_t, catalog::table_oid_t>> deferred_index_tables_;
 
   // Used during recovery from log. Stores deferred transactions in sorted sorted order to be able to execute them in
   // serial order. Transactions are defered when there is an older active transaction at the time it committed. Even
@@ -153,29 +219,91 @@ class RecoveryManager : public common::DedicatedThreadOwner {
   uint32_t recovered_txns_;
 
   /**
-   * Recovers the databases using the provided log provider
-   * @return number of committed transactions replayed
+   * Recovers the databases using the provided checkpoint and log providers
    */
-  void Recover() { RecoverFromLogs(); }
+  void Recover();
+
+  /**
+   * Recovers the databases from the checkpoint.
+   */
+  void RecoverFromCheckpoint() {
+    checkpoint_timestamp_ = checkpoint_provider_->CheckpointTimestamp();
+    Replay(checkpoint_provider_.CastManagedPointerTo<AbstractLogProvider>());
+  }
 
   /**
    * Recovers the databases from the logs.
-   * @note this is a separate method so in the future, we can also have a RecoverFromCheckpoint method
    */
-  void RecoverFromLogs();
+  void RecoverFromLogs() { Replay(log_provider_); }
+
+  /**
+   * Replays the records of a provider until it no longer gives us any
+   * @param provider provider to replay
+   */
+  void Replay(common::ManagedPointer<AbstractLogProvider> provider);
 
   /**
-   * @brief Replay a committed transaction corresponding to txn_id.
+   * @brief Replay a committed transaction corresponding to txn_id. With several replay threads, a transaction that only
+   * changes user tables is added to the current batch instead.
    * @param txn_id start timestamp for committed transaction
    */
   void ProcessCommittedTransaction(transaction::timestamp_t txn_id);
 
+  /**
+   * Replays the changes of a committed transaction in a new transaction
+   * @param buffered_changes changes of the transaction, which are deleted once the replay is done
+   */
+  void ReplayTransaction(std::vector<std::pair<LogRecord *, std::vector<byte *>>> *buffered_changes);
+
+  /**
+   * Replays the current batch of transactions on the replay threads, and waits for it to finish
+   */
+  void ReplayBatch();
+
+  /**
+   * Rebuilds the indexes on the user tables that were inserted into while index maintenance was deferred
+   */
+  void RebuildDeferredIndexes();
+
+  /**
+   * Inserts every visible tuple of a table into all of the table's indexes
+   * @param db_oid database oid for table
+   * @param table_oid indexed table
+   */
+  void RebuildIndexesOnTable(catalog::db_oid_t db_oid, catalog::table_oid_t table_oid);
+
+  /**
+   * @param table_oid oid of a table
+   * @return true if the table is a catalog table
+   */
+  static bool IsCatalogTable(const catalog::table_oid_t table_oid) {
+    return table_oid.UnderlyingValue() < catalog::START_OID;
+  }
+
+  /**
+   * @param table_oid oid of a table
+   * @return true if changes to the table update its indexes right away
+   */
+  bool MaintainsIndexes(const catalog::table_oid_t table_oid) const {
+    return !defer_index_builds_ || IsCatalogTable(table_oid);
+  }
+
   /**
    * Defers log records deletes with the transaction manager
    * @param txn_id txn_id for txn who's records to delete
    * @param delete_varlens true if we should delete varlens allocated for txn
    */
-  void DeferRecordDeletes(transaction::timestamp_t txn_id, bool delete_varlens);
+  void DeferRecordDeletes(transaction::timestamp_t txn_id, bool delete_varlens) {
+    DeferRecordDeletes(std::move(buffered_changes_map_[txn_id]), delete_varlens);
+  }
+
+  /**
+   * Defers log records deletes with the transaction manager
+   * @param buffered_changes records to delete
+   * @param delete_varlens true if we should delete varlens allocated for the records
+   */
+  void DeferRecordDeletes(std::vector<std::pair<LogRecord *, std::vector<byte *>>> &&buffered_changes,
+                          bool delete_varlens);
 
   /**
    * Replay any transaction who's txn start time is less than upper_bound. If upper_bound == transaction::NO_ACTIVE_TXN,
@@ -191,6 +319,7 @@ class RecoveryManager : public common::DedicatedThreadOwner {
    * @return new tuple slot
    */
   TupleSlot GetTupleSlotMapping(TupleSlot slot) {
+    common::SpinLatch::ScopedSpinLatch guard(&tuple_slot_map_latch_);
     TERRIER_ASSERT(tuple_slot_map_.find(slot) != tuple_slot_map_.end(), "No tuple slot mapping exists");
     return tuple_slot_map_[slot];
   }
@@ -199,12 +328,15 @@ class RecoveryManager : public common::DedicatedThreadOwner {
    * Wrapper over GetDatabaseCatalog method that asserts the database exists
    * @param txn txn for catalog lookup
    * @param database oid for database we want
+   * @param lock true to take the DDL lock of the database. Changes to user tables are replayed without it, so that
+   * they can be replayed concurrently.
    * @return pointer to database catalog
    */
   common::ManagedPointer<catalog::DatabaseCatalog> GetDatabaseCatalog(transaction::TransactionContext *txn,
-                                                                      catalog::db_oid_t db_oid) {
+                                                                      catalog::db_oid_t db_oid, bool lock = true) {
     auto db_catalog_ptr = catalog_->GetDatabaseCatalog(common::ManagedPointer(txn), db_oid);
     TERRIER_ASSERT(db_catalog_ptr != nullptr, "No catalog for given database oid");
+    if (!lock) return db_catalog_ptr;
     auto result UNUSED_ATTRIBUTE = db_catalog_ptr->TryLock(common::ManagedPointer(txn));
     TERRIER_ASSERT(result, "There should not be concurrent DDL changes during recovery.");
     return db_catalog_ptr;
@@ -235,6 +367,20 @@ class RecoveryManager : public common::DedicatedThreadOwner {
                             catalog::table_oid_t table_oid, common::ManagedPointer<storage::SqlTable> table_ptr,
                             const TupleSlot &tuple_slot, ProjectedRow *table_pr, bool insert);
 
+  /**
+   * Inserts or deletes a tuple slot from the given indexes on a table
+   * @param txn transaction to update the indexes with
+   * @param index_objects indexes to update, along with their schemas
+   * @param pr_map projection map of the table PR
+   * @param tuple_slot tuple slot to insert or delete
+   * @param table_pr PR with values for every column of the table
+   * @param insert true if we should insert into indexes, false for delete
+   */
+  static void UpdateIndexes(
+      transaction::TransactionContext *txn,
+      const std::vector<std::pair<common::ManagedPointer<index::Index>, const catalog::IndexSchema &>> &index_objects,
+      const ProjectionMap &pr_map, const TupleSlot &tuple_slot, const ProjectedRow *table_pr, bool insert);
+
   /**
    * NYS = Not yet supported
    * Returns whether a delete or redo record is a special case catalog record. The special cases we consider are:
@@ -255,15 +401,16 @@ class RecoveryManager : public common::DedicatedThreadOwner {
 
     if (record->RecordType() == LogRecordType::REDO) {
       auto *redo_record = record->GetUnderlyingRecordBodyAs<RedoRecord>();
-      if (IsInsertRecord(redo_record)) {
-        // Case 1
-        return redo_record->GetTableOid() == catalog::postgres::DATABASE_TABLE_OID ||
-               redo_record->GetTableOid() == catalog::postgres::PRO_TABLE_OID;
-      }
-
-      // Case 2
-      return redo_record->GetTableOid() == catalog::postgres::CLASS_TABLE_OID ||
-             redo_record->GetTableOid() == catalog::postgres::PRO_TABLE_OID;
+      // Case 7 and 8
+      if (redo_record->GetTableOid() == catalog::postgres::PRO_TABLE_OID) return true;
+      // Checked first, so that the tuple slot map is only looked at for catalog records, which are never replayed
+      // concurrently with anything else
+      if (redo_record->GetTableOid() != catalog::postgres::DATABASE_TABLE_OID &&
+          redo_record->GetTableOid() != catalog::postgres::CLASS_TABLE_OID)
+        return false;
+
+      // Case 1 is an insert, case 2 is an update
+      return IsInsertRecord(redo_record) == (redo_record->GetTableOid() == catalog::postgres::DATABASE_TABLE_OID);
     }
 
     // Case 3, 4, 5, and 6
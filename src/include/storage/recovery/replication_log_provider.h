@@ -1,19 +1,69 @@
 #pragma once
 
+#include <condition_variable>  // NOLINT
+#include <deque>
 #include <memory>
+#include <mutex>  // NOLINT
+
+#include "network/network_io_utils.h"
 #include "storage/recovery/abstract_log_provider.h"
 
 namespace terrier::storage {
 
 /**
- * TODO(Tianlei/Gus): Replace this file with Gus's version
+ * @brief Log provider for logs shipped from a primary
+ * On a replica, the log the primary writes is shipped over the network (@see LogShipper) in numbered messages, which
+ * the traffic cop hands to this provider as they arrive. The provider feeds them to a recovery manager that keeps
+ * running for as long as replication does, so that the replica stays close behind the primary. Reads block until enough
+ * of the log has arrived, and the log only ends once replication is stopped.
+ *
+ * Messages the provider has already seen are ignored, as the primary resends the message it was sending when it loses
+ * its connection to the replica. A missing message means that part of the log was lost, and the rest of the log is
+ * meaningless without it, so replication ends there.
  */
-class ReplicationLogProvider {
+class ReplicationLogProvider final : public AbstractLogProvider {
  public:
   /**
-   * Passes the content of the buffer to traffic cop
-   * @param buffer content to pass to traffic cop
+   * Hands the provider the logs of a replication message. Safe to call while the recovery manager is reading.
+   * @param message_id id of the message. The primary numbers its messages from zero.
+   * @param buffer logs of the message
+   */
+  void HandBufferToReplication(uint64_t message_id, std::unique_ptr<network::ReadBuffer> buffer);
+
+  /**
+   * Ends replication. Logs that were handed over before are still provided, after which the log ends.
+   */
+  void EndReplication();
+
+  /**
+   * @return id of the next message the provider expects, which is the number of messages it has received so far
+   */
+  uint64_t NextMessageId() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return next_message_id_;
+  }
+
+ private:
+  std::mutex mutex_;
+  // Signaled when logs arrive or replication ends
+  std::condition_variable cv_;
+  // Logs that have arrived but have not been read yet, in order
+  std::deque<std::unique_ptr<network::ReadBuffer>> buffers_;
+  uint64_t next_message_id_ = 0;
+  bool ended_ = false;
+
+  /**
+   * Blocks until logs arrive or replication ends
+   * @return true if there are logs left to read
+   */
+  bool HasMoreRecords() override;
+
+  /**
+   * Read the given number of bytes of the log, blocking until they arrive
+   * @param dest pointer to location to read into
+   * @param size number of bytes to read
+   * @return true if we read the given number of bytes, false if replication ended before they arrived
    */
-  virtual void HandBufferToReplication(std::unique_ptr<network::ReadBuffer> buffer);
+  bool Read(void *dest, uint32_t size) override;
 };
 }  // namespace terrier::storage
@@ -118,6 +118,32 @@ class SqlTable {
     return slot;
   }
 
+  /**
+   * Inserts a batch of tuples, as given in the redos, and writes the slots allocated for them to results. The redos
+   * must be the records returned by the latest call to StageWrites in order for the operations to be logged. The
+   * tuples are placed in consecutive slots where possible.
+   *
+   * @param txn the calling transaction
+   * @param redos after-images of the inserted tuples, as staged by StageWrites
+   * @param num_tuples number of tuples to insert
+   * @param[out] results array of at least num_tuples slots to write the inserted tuples' slots to
+   */
+  void InsertBatch(const common::ManagedPointer<transaction::TransactionContext> txn, RedoRecord *const *const redos,
+                   const uint32_t num_tuples, TupleSlot *const results) const {
+    TERRIER_ASSERT(num_tuples > 0, "Must insert at least one tuple.");
+    TERRIER_ASSERT(redos[num_tuples - 1] == reinterpret_cast<LogRecord *>(txn->redo_buffer_.LastRecord())
+                                                ->LogRecord::GetUnderlyingRecordBodyAs<RedoRecord>(),
+                   "These RedoRecords are not the most recent entries in the txn's RedoBuffer. Was StageWrites called "
+                   "immediately before?");
+    std::vector<const ProjectedRow *> deltas(num_tuples);
+    for (uint32_t i = 0; i < num_tuples; i++) {
+      TERRIER_ASSERT(redos[i]->GetTupleSlot() == TupleSlot(nullptr, 0), "TupleSlot was set in this RedoRecord.");
+      deltas[i] = redos[i]->Delta();
+    }
+    table_.data_table_->InsertBatch(txn, deltas.data(), num_tuples, results);
+    for (uint32_t i = 0; i < num_tuples; i++) redos[i]->SetTupleSlot(results[i]);
+  }
+
   /**
    * Deletes the given TupleSlot. StageDelete must have been called as well in order for the operation to be logged.
    * @param txn the calling transaction
@@ -175,6 +201,19 @@ class SqlTable {
     return table_.data_table_->Scan(txn, start_pos, out_buffer);
   }
 
+  /**
+   * Reads the tuples of a frozen block in place, starting from the given iterator, without materializing them.
+   * @see DataTable::ScanFrozenInPlace
+   *
+   * @param start_pos Iterator to the starting location for the sequential scan.
+   * @param out_buffer Output buffer whose columns will reference the block.
+   * @return the block being read in place, which the caller must release, or nullptr if the caller should use Scan.
+   */
+  RawBlock *ScanFrozenInPlace(DataTable::SlotIterator *const start_pos,
+                              execution::sql::VectorProjection *const out_buffer) const {
+    return table_.data_table_->ScanFrozenInPlace(start_pos, out_buffer);
+  }
+
   /**
    * @return the first tuple slot contained in the underlying DataTable
    */
@@ -241,11 +280,19 @@ class SqlTable {
    */
   size_t EstimateHeapUsage() const { return table_.data_table_->EstimateHeapUsage(); }
 
+  /**
+   * Keeps the block compactor away from this table from now on
+   * @see DataTable::DisallowCompaction
+   */
+  void DisallowCompaction() const { table_.data_table_->DisallowCompaction(); }
+
  private:
-  friend class RecoveryManager;  // Needs access to OID and ID mappings
+  friend class RecoveryManager;    // Needs access to OID and ID mappings
+  friend class CheckpointManager;  // Needs access to OID and ID mappings, and the layout
   friend class terrier::RandomSqlTableTransaction;
   friend class terrier::LargeSqlTableTestObject;
   friend class RecoveryTests;
+  friend class ReplicationTests;
 
   /*
    * Internals are exposed to the execution::sql::VectorProjection class so that we do not need to do a full recompile
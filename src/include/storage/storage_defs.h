@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <memory>
 #include <ostream>
 #include <string>
 #include <string_view>  // NOLINT
@@ -19,6 +20,7 @@
 #include "storage/block_access_controller.h"
 #include "transaction/transaction_defs.h"
 #include "type/type_id.h"
+#include "util/portable_endian.h"
 
 namespace terrier::storage {
 
@@ -72,8 +74,8 @@ class alignas(common::Constants::BLOCK_SIZE) RawBlock {
   layout_version_t layout_version_;
   /**
    * The insert head tells us where the next insertion should take place. Notice that this counter is never
-   * decreased as slot recycling does not happen on the fly with insertions. A background compaction process
-   * scans through blocks and free up slots.
+   * decreased. Slots freed up by deletes behind the insert head are instead handed back to the DataTable by the GC,
+   * and a background compaction process scans through blocks and closes the gaps in cold ones.
    * Since the block size is less then (1<<20) the uppper 12 bits of insert_head_ is free. We use the first bit (1<<31)
    * to indicate if the block is insertable.
    * If the first bit is 0, the block is insertable, otherwise one txn is inserting to this block
@@ -85,11 +87,20 @@ class alignas(common::Constants::BLOCK_SIZE) RawBlock {
    */
   BlockAccessController controller_;
 
+  /**
+   * Version synopsis of this block. The lower 32 bits count the slots in the block that currently have a non-null
+   * version pointer, and the upper 32 bits are an epoch bumped every time a slot goes from having no version chain to
+   * having one. A reader that observes a count of zero, and the same synopsis before and after reading a range of the
+   * block, knows that everything it read is visible as-is to every running transaction without traversing any
+   * version chain. Writers maintain this when they install a version chain, and the GC when it truncates one.
+   */
+  std::atomic<uint64_t> version_synopsis_;
+
   /**
    * Contents of the raw block.
    */
   byte content_[common::Constants::BLOCK_SIZE - sizeof(uintptr_t) - sizeof(uint16_t) - sizeof(layout_version_t) -
-                sizeof(uint32_t) - sizeof(BlockAccessController)];
+                sizeof(uint32_t) - sizeof(BlockAccessController) - sizeof(uint64_t)];
   // A Block needs to always be aligned to 1 MB, so we can get free bytes to
   // store offsets within a block in one 8-byte word
 
@@ -99,6 +110,30 @@ class alignas(common::Constants::BLOCK_SIZE) RawBlock {
    * @return the offset which tells us where the next insertion should take place
    */
   uint32_t GetInsertHead() { return INT32_MAX & insert_head_.load(); }
+
+  /**
+   * Record that a slot in this block that had no version chain now has one. This must be called before the slot is
+   * modified in place, so that concurrent in-place readers of the block can detect the change.
+   */
+  void InstallVersionChain() { version_synopsis_.fetch_add(VERSION_SYNOPSIS_EPOCH + 1); }
+
+  /**
+   * Record that the version chain of a slot in this block has been truncated to nothing. This must be called after the
+   * version pointer of the slot has been set to nullptr.
+   */
+  void TruncateVersionChain() {
+    TERRIER_ASSERT(!NoVersionChains(version_synopsis_.load()), "Truncating a version chain the block does not have");
+    version_synopsis_.fetch_sub(1);
+  }
+
+  /**
+   * @param synopsis a value read from version_synopsis_
+   * @return true if no slot in the block had a version chain at the time the synopsis was read
+   */
+  static bool NoVersionChains(const uint64_t synopsis) { return static_cast<uint32_t>(synopsis) == 0; }
+
+ private:
+  static constexpr uint64_t VERSION_SYNOPSIS_EPOCH = static_cast<uint64_t>(1) << 32;
 };
 
 /**
@@ -169,16 +204,48 @@ class TupleSlot {
   uintptr_t bytes_;
 };
 
+class BlockArenas;
+
 /**
- * Allocator that allocates a block
+ * Allocator that allocates a block. By default blocks are allocated on the heap, but the allocator can also carve them
+ * out of arenas backed by huge pages, see BlockArenas.
  */
 class BlockAllocator {
  public:
+  /**
+   * Creates an allocator that allocates blocks on the heap.
+   */
+  BlockAllocator();
+
+  /**
+   * Creates an allocator that carves blocks out of arenas backed by huge pages.
+   * @param huge_page_size size of the huge pages in MB, either 2 or 1024. 0 allocates blocks on the heap instead.
+   * @param numa_aware whether blocks are placed on the NUMA node of the thread that asks for them
+   * @throw std::runtime_error if the huge page size is not supported
+   */
+  BlockAllocator(uint32_t huge_page_size, bool numa_aware);
+
+  /**
+   * Unmaps the arenas, if any. All blocks must have been deleted by now.
+   */
+  ~BlockAllocator();
+
+  /**
+   * @param other allocator to take the arenas of
+   */
+  BlockAllocator(BlockAllocator &&other) noexcept;
+
+  /**
+   * @param other allocator to take the arenas of
+   * @return self reference
+   */
+  BlockAllocator &operator=(BlockAllocator &&other) noexcept;
+
   /**
    * Allocates a new object by calling its constructor.
    * @return a pointer to the allocated object.
    */
-  RawBlock *New() { return new RawBlock(); }
+  RawBlock *New();
 
   /**
    * Reuse a reused chunk of memory to be handed out again
@@ -191,7 +258,17 @@ class BlockAllocator {
    * Deletes the object by calling its destructor.
    * @param ptr a pointer to the object to be deleted.
    */
-  void Delete(RawBlock *const ptr) { delete ptr; }
+  void Delete(RawBlock *ptr);
+
+  /**
+   * @return number of blocks allocated and not yet deleted on each NUMA node, indexed by node id. Empty if blocks are
+   * allocated on the heap.
+   */
+  std::vector<uint64_t> BlocksPerNode() const;
+
+ private:
+  // nullptr if blocks are allocated on the heap
+  std::unique_ptr<BlockArenas> arenas_;
 };
 
 /** ColumnMapInfo maps between col_oids in Schema and useful information that we need about a Column in SqlTable. */
@@ -208,6 +285,11 @@ struct ColumnMapInfo {
  * malloc.
  */
 using BlockStore = common::ObjectPool<RawBlock, BlockAllocator>;
+/**
+ * Number of free blocks each thread caches in front of the BlockStore. Blocks are large, so every thread that ever
+ * allocates or frees one keeps no more than a couple of them around (@see common::ObjectPool).
+ */
+constexpr uint32_t BLOCK_STORE_MAGAZINE_SIZE = 2;
 /**
  * Used by SqlTable to map between col_oids in Schema and useful necessary information.
  */
@@ -468,9 +550,33 @@ class VarlenEntry {
    * @return The appropriate signed value indicating comparison order.
    */
   static int32_t Compare(const VarlenEntry &left, const VarlenEntry &right) {
+    // Most strings are ordered by their prefixes alone, which we compare without following the content pointers. The
+    // prefix of a string shorter than PrefixSize() is padded with zeros, which still orders it correctly.
+    const uint32_t left_prefix = left.PrefixOrder();
+    const uint32_t right_prefix = right.PrefixOrder();
+    if (left_prefix != right_prefix) return left_prefix < right_prefix ? -1 : 1;
     const auto min_len = std::min(left.Size(), right.Size());
-    const auto result = std::memcmp(left.Content(), right.Content(), min_len);
-    return result != 0 ? result : left.Size() - right.Size();
+    if (min_len > PrefixSize()) {
+      const auto result =
+          std::memcmp(left.Content() + PrefixSize(), right.Content() + PrefixSize(), min_len - PrefixSize());
+      if (result != 0) return result;
+    }
+    return static_cast<int32_t>(left.Size() - right.Size());
+  }
+
+  /**
+   * Checks whether this string starts with the given bytes, only following the content pointer if the prefix stored in
+   * the entry matches. This is meant for matching many strings against the same short literal, e.g. a LIKE 'abc%'.
+   * @param bytes the bytes to look for
+   * @param size number of bytes to look for
+   * @return true if the first size bytes of this string are the given bytes
+   */
+  bool StartsWith(const byte *const bytes, const uint32_t size) const {
+    if (size > Size()) return false;
+    const uint32_t prefix_size = std::min(size, PrefixSize());
+    if (std::memcmp(prefix_, bytes, prefix_size) != 0) return false;
+    if (size <= PrefixSize()) return true;
+    return std::memcmp(Content() + PrefixSize(), bytes + PrefixSize(), size - PrefixSize()) == 0;
   }
 
   /**
@@ -504,6 +610,13 @@ class VarlenEntry {
   bool operator>=(const VarlenEntry &that) const { return Compare(*this, that) >= 0; }
 
  private:
+  // The prefix as an integer that orders the same way as the prefix bytes do
+  uint32_t PrefixOrder() const {
+    uint32_t prefix;
+    std::memcpy(&prefix, prefix_, sizeof(uint32_t));
+    return be32toh(prefix);
+  }
+
   int32_t size_;                   // buffer reclaimable => sign bit is 0 or size <= InlineThreshold
   byte prefix_[sizeof(uint32_t)];  // Explicit padding so that we can use these bits for inlined values or prefix
   const byte *content_;            // pointer to content of the varlen entry if not inlined
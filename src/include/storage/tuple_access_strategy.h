@@ -45,7 +45,7 @@ class TupleAccessStrategy {
   /*
    * Block Header layout:
    * -----------------------------------------------------------------------------------------------------------------
-   * | data_table *(64) | padding (16) | layout_version (16) | insert_head (32) |        control_block (64)          |
+   * | data_table *(64) | padding (16) | layout_version (16) | insert_head (32) | control_block (64) | synopsis (64) |
    * -----------------------------------------------------------------------------------------------------------------
    * | ArrowBlockMetadata | attr_offsets[num_col] (32) | bitmap for slots (64-bit aligned) | data (64-bit aligned)   |
    * -----------------------------------------------------------------------------------------------------------------
@@ -213,6 +213,16 @@ class TupleAccessStrategy {
     reinterpret_cast<Block *>(slot.GetBlock())->SlotAllocationBitmap(layout_)->Flip(slot.GetOffset(), false);
   }
 
+  /**
+   * Allocates the given slot if it is currently deallocated. This is used to hand slots reclaimed by the GC to new
+   * inserts. Unlike Reallocate, the slot may already have been taken by someone else, in which case this fails.
+   * @param slot the tuple slot to allocate
+   * @return true if the slot was deallocated and is now allocated, false otherwise
+   */
+  bool AllocateSlot(const TupleSlot slot) const {
+    return reinterpret_cast<Block *>(slot.GetBlock())->SlotAllocationBitmap(layout_)->Flip(slot.GetOffset(), false);
+  }
+
   /**
    * Allocates a slot for a new tuple, writing to the given reference.
    * @param block block to allocate a slot in.
@@ -221,6 +231,16 @@ class TupleAccessStrategy {
    */
   bool Allocate(RawBlock *block, TupleSlot *slot) const;
 
+  /**
+   * Allocates consecutive slots for new tuples at the insertion head of the block, as many as are asked for or as are
+   * left in the block, whichever is fewer. Like Allocate, the block must be marked busy by the caller.
+   * @param block block to allocate slots in.
+   * @param max_slots largest number of slots to allocate.
+   * @param[out] slots array of at least max_slots slots to write the allocated slots to, in order.
+   * @return number of slots allocated, 0 if the block is full.
+   */
+  uint32_t AllocateRange(RawBlock *block, uint32_t max_slots, TupleSlot *slots) const;
+
   /**
    * @param block the block to access
    * @return pointer to the allocation bitmap of the block
@@ -236,8 +256,8 @@ class TupleAccessStrategy {
   void Deallocate(const TupleSlot slot) const {
     TERRIER_ASSERT(Allocated(slot), "Can only deallocate slots that are allocated");
     reinterpret_cast<Block *>(slot.GetBlock())->SlotAllocationBitmap(layout_)->Flip(slot.GetOffset(), true);
-    // TODO(Tianyu): Make explicit that this operation does not reset the insertion head, and the block
-    // is still considered "full" and will not be inserted into.
+    // Note that this operation does not reset the insertion head. The slot is instead handed back to its DataTable,
+    // which deallocates it and reuses it through AllocateSlot.
   }
 
   /**
@@ -1,17 +1,25 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
 #include <condition_variable>  // NOLINT
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "common/container/concurrent_blocking_queue.h"
 #include "common/container/concurrent_queue.h"
 #include "common/dedicated_thread_task.h"
+#include "common/managed_pointer.h"
 #include "storage/storage_defs.h"
 #include "storage/write_ahead_log/log_io.h"
+#include "storage/write_ahead_log/log_shipper.h"
 
 namespace terrier::storage {
 
+class LogManager;
+
 /**
  * A DiskLogConsumerTask is responsible for writing serialized log records out to disk by processing buffers in the log
  * manager's filled buffer queue
@@ -22,21 +30,45 @@ class DiskLogConsumerTask : public common::DedicatedThreadTask {
    * Constructs a new DiskLogConsumerTask
    * @param persist_interval Interval time for when to persist log file
    * @param persist_threshold threshold of data written since the last persist to trigger another persist
+   * @param group_commit_latency target latency of a commit in group commit mode, zero to disable group commit
+   * @param group_commit_size number of commits waiting on a persist that triggers a persist in group commit mode
+   * @param log_file_path path of the log file of the log stream, which segment file names are derived from
+   * @param segment_size size of the log segments to cut the log into, zero to write the log into a single file
+   * @param first_segment_id id of the segment the buffers are currently writing to, ignored if segment_size is zero
+   * @param direct_io whether the log is written with direct I/O
    * @param buffers pointer to list of all buffers used by log manager, used to persist log file
    * @param empty_buffer_queue pointer to queue to push empty buffers to
    * @param filled_buffer_queue pointer to queue to pop filled buffers from
+   * @param log_shipper ships the log to replicas once it is persisted, nullptr if there are none
+   * @param log_manager log manager to hand persisted commits to, so that it can acknowledge them once every log stream
+   *                    has persisted all commits before them. nullptr to acknowledge commits as soon as they are
+   *                    persisted, which is only correct with a single log stream.
+   * @param stream_id id of the log stream this task writes out
    */
   explicit DiskLogConsumerTask(const std::chrono::microseconds persist_interval, uint64_t persist_threshold,
-                               std::vector<BufferedLogWriter> *buffers,
+                               const std::chrono::microseconds group_commit_latency, uint64_t group_commit_size,
+                               std::string log_file_path, uint64_t segment_size, uint64_t first_segment_id,
+                               bool direct_io, std::vector<BufferedLogWriter> *buffers,
                                common::ConcurrentBlockingQueue<BufferedLogWriter *> *empty_buffer_queue,
-                               common::ConcurrentQueue<storage::SerializedLogs> *filled_buffer_queue)
+                               common::ConcurrentQueue<storage::SerializedLogs> *filled_buffer_queue,
+                               common::ManagedPointer<LogShipper> log_shipper,
+                               common::ManagedPointer<LogManager> log_manager, uint32_t stream_id)
       : run_task_(false),
         persist_interval_(persist_interval),
         persist_threshold_(persist_threshold),
         current_data_written_(0),
+        group_commit_latency_(group_commit_latency),
+        group_commit_size_(group_commit_size),
+        log_file_path_(std::move(log_file_path)),
+        segment_size_(segment_size),
+        direct_io_(direct_io),
+        current_segment_id_(first_segment_id),
         buffers_(buffers),
         empty_buffer_queue_(empty_buffer_queue),
-        filled_buffer_queue_(filled_buffer_queue) {}
+        filled_buffer_queue_(filled_buffer_queue),
+        log_shipper_(log_shipper),
+        log_manager_(log_manager),
+        stream_id_(stream_id) {}
 
   /**
    * Runs main disk log writer loop. Called by thread registry upon initialization of thread
@@ -61,6 +93,33 @@ class DiskLogConsumerTask : public common::DedicatedThreadTask {
   uint64_t persist_threshold_;
   // Amount of data written since last persist
   uint64_t current_data_written_;
+  // Number of buffers written since the last persist, used for metrics
+  uint64_t current_buffers_written_ = 0;
+
+  // In group commit mode, the log file is persisted once enough commits are waiting on it, or once the oldest waiting
+  // commit would otherwise miss its target latency, instead of every persist interval. The persist threshold still
+  // applies. The target latency covers the persist itself, so we start the persist early by however long persists have
+  // been taking lately.
+  const std::chrono::microseconds group_commit_latency_;
+  const uint64_t group_commit_size_;
+  // When the oldest commit not yet persisted was handed to us
+  std::chrono::high_resolution_clock::time_point oldest_waiting_commit_;
+  // Moving average of how long a persist takes
+  std::chrono::microseconds persist_latency_estimate_{0};
+
+  // With a segment size set, the log is cut into segment files of about that size. We only move on to the next segment
+  // right after a persist, and only if the data written so far ends at the end of a record, so that a segment only ever
+  // holds whole records and everything in it is persistent once it is sealed.
+  const std::string log_file_path_;
+  const uint64_t segment_size_;
+  const bool direct_io_;
+  // Segment currently being written to. Read by the LogManager to tell which segments are done.
+  std::atomic<uint64_t> current_segment_id_;
+  // Amount of data written to the current segment, and the range of its records
+  uint64_t current_segment_size_ = 0;
+  LogRange current_segment_range_;
+  // Whether the data written so far ends at the end of a record
+  bool at_record_boundary_ = true;
 
   // This stores a reference to all the buffers the log manager has created. Used for persisting
   std::vector<BufferedLogWriter> *buffers_;
@@ -68,9 +127,16 @@ class DiskLogConsumerTask : public common::DedicatedThreadTask {
   common::ConcurrentBlockingQueue<BufferedLogWriter *> *empty_buffer_queue_;
   // The queue containing filled buffers. Task should dequeue filled buffers from this queue to flush
   common::ConcurrentQueue<SerializedLogs> *filled_buffer_queue_;
+  // Ships what we persist to replicas, if there are any
+  const common::ManagedPointer<LogShipper> log_shipper_;
+  // Log written to the log file since the last persist, which the shipper gets once it is persisted
+  std::vector<char> unshipped_log_;
+  // Acknowledges the commits we persist once the other log streams have caught up, if there are any
+  const common::ManagedPointer<LogManager> log_manager_;
+  const uint32_t stream_id_;
 
   // Flag used by the serializer thread to signal the disk log consumer task thread to persist the data on disk
-  volatile bool do_persist_;
+  volatile bool do_persist_ = false;
 
   // Synchronisation primitives to synchronise persisting buffers to disk
   std::mutex persist_lock_;
@@ -93,8 +159,32 @@ class DiskLogConsumerTask : public common::DedicatedThreadTask {
   /*
    * Persists the log file on disk by calling fsync, as well as calling callbacks for all committed transactions that
    * were persisted
-   * @return number of buffers persisted, used for metrics
+   * @param persist_latency pointer to write how long the persist took (us), used for metrics
+   * @return number of commits persisted, used for metrics
+   */
+  uint64_t PersistLogFile(uint64_t *persist_latency);
+
+  /**
+   * Starts writing to a new log segment, and seals the current one. Must only be called right after a persist.
+   */
+  void RotateSegment();
+
+  /**
+   * Seals the current log segment, recording the range of its records in its header
+   */
+  void SealSegment();
+
+  /**
+   * @return true if group commit is enabled
+   */
+  bool GroupCommitEnabled() const { return group_commit_latency_.count() > 0; }
+
+  /**
+   * @return point in time by which we need to start persisting for the oldest waiting commit to meet its target latency
    */
-  uint64_t PersistLogFile();
+  std::chrono::high_resolution_clock::time_point GroupCommitDeadline() const {
+    return oldest_waiting_commit_ + std::max(group_commit_latency_ - persist_latency_estimate_,
+                                             std::chrono::microseconds::zero());
+  }
 };
 }  // namespace terrier::storage
@@ -5,6 +5,7 @@
 #include <sys/types.h>
 #include <sys/uio.h>
 #include <unistd.h>
+#include <algorithm>
 #include <cerrno>
 #include <cstring>
 #include <string>
@@ -73,12 +74,167 @@ struct PosixIoWrappers {
    * @throws runtime_error if the underlying posix call failed
    */
   static void WriteFully(int fd, const void *buf, size_t nbyte);
+
+  /**
+   * Wrapper around the posix writev call, where a single function call will always write all of the given buffers out.
+   * (unlike posix writev, which can write arbitrarily many bytes less than the given amount)
+   * @param fd posix fildes arg
+   * @param iovs posix iov arg. Contents are modified to keep track of what is left to write.
+   * @throws runtime_error if the underlying posix call failed
+   */
+  static void WriteVFully(int fd, std::vector<iovec> *iovs);
+
+  /**
+   * Wrapper around posix open call that asks for direct I/O, falling back to regular I/O on file systems that do not
+   * support it
+   * @param path posix path arg
+   * @param oflag posix oflag arg, without O_DIRECT
+   * @param mode posix mode arg
+   * @throws runtime_error if the underlying posix call failed
+   * @return a non-negative interger that is the file descriptor if the opened file.
+   */
+  static int OpenDirect(const char *path, int oflag, mode_t mode);
+
+  /**
+   * Call fsync on the directory containing the given file, so that the creation or removal of the file is persistent
+   * @param path path of a file
+   * @throws runtime_error if the underlying posix call failed
+   */
+  static void SyncParentDirectory(const std::string &path);
+
+  /**
+   * Lists the files that are named like the given path followed by a number, e.g. "wal.log.segment.3" for the path
+   * "wal.log.segment."
+   * @param path_prefix path that the files start with
+   * @throws runtime_error if the directory of the files cannot be read
+   * @return numbers of the files that exist, in ascending order
+   */
+  static std::vector<uint64_t> ListNumberedFiles(const std::string &path_prefix);
+};
+
+/**
+ * Summary of the log records in a stretch of the log: the range of commit timestamps of the transactions that
+ * committed in it, and the newest transaction that has any record in it. Used to tell whether a log segment is still
+ * needed by recovery.
+ */
+struct LogRange {
+  /**
+   * Smallest commit timestamp of a commit record in the range, or INVALID_TXN_TIMESTAMP if there is none
+   */
+  transaction::timestamp_t min_commit_ = transaction::INVALID_TXN_TIMESTAMP;
+  /**
+   * Largest commit timestamp of a commit record in the range, or INVALID_TXN_TIMESTAMP if there is none
+   */
+  transaction::timestamp_t max_commit_ = transaction::INVALID_TXN_TIMESTAMP;
+  /**
+   * Largest start timestamp of a transaction with a record in the range, or INVALID_TXN_TIMESTAMP if there is none
+   */
+  transaction::timestamp_t max_txn_begin_ = transaction::INVALID_TXN_TIMESTAMP;
+
+  /**
+   * Adds a record to the range
+   * @param txn_begin start timestamp of the transaction that wrote the record
+   */
+  void AddRecord(const transaction::timestamp_t txn_begin) { max_txn_begin_ = Max(max_txn_begin_, txn_begin); }
+
+  /**
+   * Adds a commit record to the range
+   * @param txn_begin start timestamp of the transaction that committed
+   * @param commit_time commit timestamp of the transaction
+   */
+  void AddCommit(const transaction::timestamp_t txn_begin, const transaction::timestamp_t commit_time) {
+    AddRecord(txn_begin);
+    min_commit_ = Min(min_commit_, commit_time);
+    max_commit_ = Max(max_commit_, commit_time);
+  }
+
+  /**
+   * Adds all records of another range to this one
+   * @param other range to add
+   */
+  void Merge(const LogRange &other) {
+    min_commit_ = Min(min_commit_, other.min_commit_);
+    max_commit_ = Max(max_commit_, other.max_commit_);
+    max_txn_begin_ = Max(max_txn_begin_, other.max_txn_begin_);
+  }
+
+ private:
+  // INVALID_TXN_TIMESTAMP stands for no timestamp, so it needs to be special cased
+  static transaction::timestamp_t Min(const transaction::timestamp_t a, const transaction::timestamp_t b) {
+    if (a == transaction::INVALID_TXN_TIMESTAMP) return b;
+    if (b == transaction::INVALID_TXN_TIMESTAMP) return a;
+    return std::min(a, b);
+  }
+
+  static transaction::timestamp_t Max(const transaction::timestamp_t a, const transaction::timestamp_t b) {
+    if (a == transaction::INVALID_TXN_TIMESTAMP) return b;
+    if (b == transaction::INVALID_TXN_TIMESTAMP) return a;
+    return std::max(a, b);
+  }
+};
+
+/**
+ * Header at the start of every log segment file. A segment is created with an unsealed header, and the header is
+ * rewritten with the range of the segment's records when the log moves on to the next segment. A segment whose header
+ * is not sealed is either still being written, or was being written when the system went down.
+ *
+ * On disk, the header takes up a whole block of LOG_DIRECT_IO_ALIGNMENT bytes, so that the records after it are aligned
+ * for direct I/O.
+ */
+struct LogSegmentHeader {
+  /**
+   * Size of the header on disk
+   */
+  static constexpr uint32_t SIZE_ON_DISK = common::Constants::LOG_DIRECT_IO_ALIGNMENT;
+  /**
+   * Identifies a file as a log segment
+   */
+  static constexpr uint64_t MAGIC = 0x4745534C41575254;  // "TRWALSEG"
+
+  /**
+   * Must be MAGIC
+   */
+  uint64_t magic_ = MAGIC;
+  /**
+   * Position of the segment in the log
+   */
+  uint64_t segment_id_ = 0;
+  /**
+   * Whether the segment is complete and range_ is filled in
+   */
+  bool sealed_ = false;
+  /**
+   * Range of the records in the segment, only valid once the segment is sealed
+   */
+  LogRange range_;
+
+  /**
+   * Writes the header at the start of a segment file, creating the file if it does not exist, and persists it
+   * @param log_file_path path of the segment file
+   * @param direct_io whether the segment file is written with direct I/O
+   * @throws runtime_error if the underlying posix calls failed
+   */
+  void Write(const std::string &log_file_path, bool direct_io) const;
+
+  /**
+   * Reads the header of a segment file
+   * @param log_file_path path of the segment file
+   * @param[out] header header read
+   * @return true if the file starts with a well formed header, false otherwise
+   */
+  static bool Read(const std::string &log_file_path, LogSegmentHeader *header);
 };
 // TODO(Tianyu):  we need control over when and what to flush as the log manager. Thus, we need to write our
 // own wrapper around lower level I/O functions. I could be wrong, and in that case we should
 // revert to using STL.
 /**
  * Handles buffered writes to the write ahead log, and provides control over flushing.
+ *
+ * In direct I/O mode, the log file is opened with O_DIRECT so that writes bypass the page cache, and is persisted with
+ * fdatasync. Direct I/O requires every write to be aligned, so a buffer that is flushed before it is full is padded
+ * with zeros up to the next aligned offset. Padding always has room for at least a zero record size, which is how
+ * readers tell it apart from records (@see BufferedLogReader::SkipPadding). Disk space for the log file is reserved
+ * ahead of its end with fallocate, so appends do not have to allocate blocks on the persist path.
  */
 class BufferedLogWriter {
   // TODO(Tianyu): Checksum
@@ -88,15 +244,47 @@ class BufferedLogWriter {
    *
    * @param log_file_path path to the the log file to write to. New entries are appended to the end of the file if the
    * file already exists; otherwise, a file is created.
+   * @param direct_io whether to write to the log file with direct I/O. All writers of a log file must agree on this.
    */
-  explicit BufferedLogWriter(const char *log_file_path)
-      : out_(PosixIoWrappers::Open(log_file_path, O_WRONLY | O_APPEND | O_CREAT, S_IRUSR | S_IWUSR)) {}
+  explicit BufferedLogWriter(const char *log_file_path, const bool direct_io = false)
+      : out_(OpenLogFile(log_file_path, direct_io)), direct_io_(direct_io) {}
 
   /**
    * Must call before object is destructed
    */
   void Close() { PosixIoWrappers::Close(out_); }
 
+  /**
+   * Closes the current log file and switches to appending to the given one. Must not be called concurrently with a
+   * flush or persist of this writer.
+   * @param log_file_path path to the the log file to write to from now on
+   */
+  void Reopen(const char *log_file_path) {
+    Close();
+    out_ = OpenLogFile(log_file_path, direct_io_);
+    preallocated_end_ = 0;
+  }
+
+  /**
+   * @return range of the log records serialized into the buffer since it was last flushed. Records that span several
+   *         buffers are only accounted for in the one they start in.
+   */
+  LogRange *Range() { return &range_; }
+
+  /**
+   * Marks whether the buffer ends at the end of a log record, rather than in the middle of one that continues in the
+   * next buffer
+   * @param ends_at_record_boundary whether the buffer ends at the end of a log record
+   */
+  void SetEndsAtRecordBoundary(const bool ends_at_record_boundary) {
+    ends_at_record_boundary_ = ends_at_record_boundary;
+  }
+
+  /**
+   * @return whether the buffer ends at the end of a log record. A log may only be cut into segments at such a buffer.
+   */
+  bool EndsAtRecordBoundary() const { return ends_at_record_boundary_; }
+
   /**
    * Write to the log file the given amount of bytes from the given location in memory, but buffer the write so the
    * update is only written out when the BufferedLogWriter is persisted. Note that this function writes to the buffer
@@ -119,37 +307,63 @@ class BufferedLogWriter {
   }
 
   /**
-   * Call fsync to make sure that all writes are consistent.
+   * Call fsync (or fdatasync in direct I/O mode) to make sure that all writes are consistent.
    */
   void Persist() {
+    if (direct_io_) {
+      if (fdatasync(out_) == -1) throw std::runtime_error("fdatasync failed with errno " + std::to_string(errno));
+      return;
+    }
     if (fsync(out_) == -1) throw std::runtime_error("fsync failed with errno " + std::to_string(errno));
   }
 
   /**
    * Flush any buffered writes.
-   * @return amount of data flushed
+   * @return amount of data flushed, not counting padding
    */
   uint64_t FlushBuffer() {
-    auto size = buffer_size_;
-    WriteUnsynced(buffer_, buffer_size_);
-    buffer_size_ = 0;
-    return size;
+    BufferedLogWriter *self = this;
+    return FlushBuffers(&self, 1);
   }
 
+  /**
+   * Flush the buffered writes of several writers to the log file they share with a single vectored write, so that all
+   * of them are in flight at once instead of one after another.
+   * @param writers writers to flush, in the order their contents should appear in the log file
+   * @param num_writers number of writers to flush
+   * @return amount of data flushed, not counting padding
+   */
+  static uint64_t FlushBuffers(BufferedLogWriter *const *writers, size_t num_writers);
+
   /**
    * @return if the buffer is full
    */
   bool IsBufferFull() { return buffer_size_ == common::Constants::LOG_BUFFER_SIZE; }
 
+  /**
+   * @return the buffered writes, not counting padding. They stay valid after a flush, until the next write.
+   */
+  iovec BufferedData() { return {buffer_, buffer_size_}; }
+
  private:
   int out_;  // fd of the output files
-  char buffer_[common::Constants::LOG_BUFFER_SIZE];
+  bool direct_io_;
+  // Aligned so that it can be handed to the kernel as is in direct I/O mode
+  alignas(common::Constants::LOG_DIRECT_IO_ALIGNMENT) char buffer_[common::Constants::LOG_BUFFER_SIZE];
 
   uint32_t buffer_size_ = 0;
+  // End of the disk space reserved for the log file through this writer, only used in direct I/O mode
+  uint64_t preallocated_end_ = 0;
+  // Summary of the buffered records, reset on flush
+  LogRange range_;
+  bool ends_at_record_boundary_ = false;
 
   bool CanBuffer(uint32_t size) { return common::Constants::LOG_BUFFER_SIZE - buffer_size_ >= size; }
 
-  void WriteUnsynced(const void *data, uint32_t size) { PosixIoWrappers::WriteFully(out_, data, size); }
+  static int OpenLogFile(const char *log_file_path, bool direct_io);
+
+  // Reserves disk space past the end of the log file if we are about to run out
+  void Preallocate();
 };
 
 /**
@@ -175,7 +389,12 @@ class BufferedLogReader {
   /**
    * @return if there are contents left in the write ahead log
    */
-  bool HasMore() { return filled_size_ > read_head_ || in_ != -1; }
+  bool HasMore() {
+    // The file may have ended right at the end of the last buffer we read in, which we only find out by reading on.
+    // This is always the case for logs written with direct I/O.
+    if (filled_size_ == read_head_ && in_ != -1) RefillBuffer();
+    return filled_size_ > read_head_;
+  }
 
   /**
    * Read the specified number of bytes into the target location from the write ahead log. The method reads as many as
@@ -188,6 +407,13 @@ class BufferedLogReader {
    */
   bool Read(void *dest, uint32_t size);
 
+  /**
+   * Skip over the padding a BufferedLogWriter in direct I/O mode leaves between writes, i.e. everything up to the next
+   * aligned offset in the log file. Must be called right after reading the zero record size that starts the padding.
+   * @return whether the log has anything left after the padding
+   */
+  bool SkipPadding();
+
   /**
    * Read a value of the specified type from the log. An exception is thrown if the log file does not
    * have enough bytes left for a well formed value
@@ -205,12 +431,15 @@ class BufferedLogReader {
  private:
   int in_;  // or -1 if closed
   uint32_t read_head_ = 0, filled_size_ = 0;
+  // Offset in the log file of the next byte to read
+  uint64_t offset_ = 0;
   char buffer_[common::Constants::LOG_BUFFER_SIZE];
 
   void ReadFromBuffer(void *dest, uint32_t size) {
     TERRIER_ASSERT(read_head_ + size <= filled_size_, "Not enough bytes in buffer for the read");
     std::memcpy(dest, buffer_ + read_head_, size);
     read_head_ += size;
+    offset_ += size;
   }
 
   void RefillBuffer();
@@ -219,7 +448,14 @@ class BufferedLogReader {
 /**
  * Callback function and arguments to be called when record is persisted
  */
-using CommitCallback = std::pair<transaction::callback_fn, void *>;
+struct CommitCallback {
+  /** Function to call */
+  transaction::callback_fn fn_;
+  /** Argument to call the function with */
+  void *arg_;
+  /** Commit timestamp of the transaction waiting on the callback */
+  transaction::timestamp_t commit_time_;
+};
 
 /**
  * A BufferedLogWriter containing serialized logs, as well as all commit callbacks for transaction's whose commit are
@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <queue>
+#include <set>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -21,6 +22,7 @@ namespace terrier::storage {
 
 class LogSerializerTask;
 class DiskLogConsumerTask;
+class LogShipper;
 
 /**
  * A LogManager is responsible for serializing log records out and keeping track of whether changes from a transaction
@@ -34,18 +36,38 @@ class DiskLogConsumerTask;
  * case of the DiskLogConsumerTask, this means writing it to the log file.
  *      4. The DiskLogConsumer task will persist the log file when:
  *          a) Someone calls ForceFlush on the LogManager, or
- *          b) Periodically
+ *          b) Periodically, or in group commit mode, when enough commits are waiting or the oldest waiting commit is
+ * about to miss its target latency
  *          c) A sufficient amount of data has been written since the last persist
  *      5. When the persist is done, the `DiskLogConsumerTask` will call the commit callbacks for any CommitRecords that
  * were just persisted.
+ *
+ * To scale serialization past a single thread, the LogManager can run several log streams side by side. Each stream has
+ * its own LogSerializerTask, DiskLogConsumerTask, buffers and log file, and every transaction is assigned to one stream
+ * by its start timestamp, so all of its records land in the same file in order. Streams are not ordered with respect
+ * to each other; recovery merges them back together by commit timestamp (see DiskLogProvider). A commit is therefore
+ * only acknowledged once it and every commit before it, in any stream, is persisted. The LogManager tracks every commit
+ * from the moment it gets its timestamp until its stream persists it (see CheckOutCommitTimestamp), and invokes the
+ * callbacks of persisted commits once they are older than every commit it is still tracking.
+ *
+ * With a segment size set, each stream's log is cut into a sequence of segment files instead of growing a single file
+ * forever. Each segment starts with a header recording the range of commit timestamps in it (see LogSegmentHeader), so
+ * that segments whose contents are durable elsewhere (i.e. in a checkpoint) can be discarded with DiscardSegments, and
+ * recovery only has to replay the segments that are left.
+ *
+ * With a LogShipper set, the DiskLogConsumerTask also hands it the log to ship to replicas once it is persisted.
  */
 class LogManager : public common::DedicatedThreadOwner {
  public:
+  /** Number of waiting commits that triggers a persist under group commit, unless configured otherwise */
+  static constexpr uint64_t DEFAULT_GROUP_COMMIT_SIZE = 64;
+
   /**
    * Constructs a new LogManager, writing its logs out to the given file.
    *
    * @param log_file_path path to the desired log file location. If the log file does not exist, one will be created;
-   *                      otherwise, changes are appended to the end of the file.
+   *                      otherwise, changes are appended to the end of the file, unless the log is written by
+   *                      several streams (@see RotateEarlierRun).
    * @param num_buffers Number of buffers to use for buffering logs
    * @param serialization_interval Interval time between log serializations
    * @param persist_interval Interval time between log flushing
@@ -71,6 +93,7 @@ class LogManager : public common::DedicatedThreadOwner {
    *    1. Initialize buffers to pass serialized logs to log consumers
    *    2. Starts up DiskLogConsumerTask
    *    3. Starts up LogSerializerTask
+   * @throw std::runtime_error if a log shipper is set, but there are several log streams to ship
    */
   void Start();
 
@@ -82,6 +105,22 @@ class LogManager : public common::DedicatedThreadOwner {
    */
   void ForceFlush();
 
+  /**
+   * For testing only. Serializes and persists the logs of a single log stream, as ForceFlush does for all of them.
+   * @param stream_id id of the log stream to flush
+   */
+  void TestForceFlushStream(uint32_t stream_id);
+
+  /**
+   * Checks out the commit timestamp of a committing transaction. With several log streams, the commit is tracked from
+   * this point on until its stream persists it, so that no commit after it is acknowledged before then.
+   * @param txn_begin start timestamp of the committing transaction
+   * @param timestamp_manager timestamp manager to check the commit timestamp out from
+   * @return commit timestamp of the transaction
+   */
+  transaction::timestamp_t CheckOutCommitTimestamp(transaction::timestamp_t txn_begin,
+                                                   transaction::TimestampManager *timestamp_manager);
+
   /**
    * Persists all unpersisted logs and stops the log manager. Does what Start() does in reverse order:
    *    1. Stops LogSerializerTask
@@ -102,7 +141,7 @@ class LogManager : public common::DedicatedThreadOwner {
 
   /**
    * For testing only
-   * @return number of buffers used for logging
+   * @return number of buffers used for logging by each log stream
    */
   uint64_t TestGetNumBuffers() { return num_buffers_; }
 
@@ -110,15 +149,17 @@ class LogManager : public common::DedicatedThreadOwner {
    * Set the number of buffers used for buffering logs. The operation fails if the LogManager has already allocated more
    * buffers than the new size
    *
-   * @param new_num_buffers the new number of buffers the log manager can use
+   * @param new_num_buffers the new number of buffers each log stream can use
    * @return true if new_num_buffers is successfully set and false the operation fails
    */
   bool SetNumBuffers(uint64_t new_num_buffers) {
     if (new_num_buffers >= num_buffers_) {
       // Add in new buffers
-      for (size_t i = 0; i < new_num_buffers - num_buffers_; i++) {
-        buffers_.emplace_back(BufferedLogWriter(log_file_path_.c_str()));
-        empty_buffer_queue_.Enqueue(&buffers_[num_buffers_ + i]);
+      for (auto &stream : streams_) {
+        for (size_t i = 0; i < new_num_buffers - num_buffers_; i++) {
+          stream->buffers_.emplace_back(BufferedLogWriter(CurrentLogFilePath(*stream).c_str(), direct_io_));
+          stream->empty_buffer_queue_.Enqueue(&stream->buffers_[num_buffers_ + i]);
+        }
       }
       num_buffers_ = new_num_buffers;
       return true;
@@ -126,40 +167,251 @@ class LogManager : public common::DedicatedThreadOwner {
     return false;
   }
 
+  /**
+   * Sets the number of log streams, each with its own serializer thread and log file. Must be called before Start().
+   * @param num_streams number of log streams to run
+   */
+  void SetNumStreams(const uint32_t num_streams) {
+    TERRIER_ASSERT(!run_log_manager_, "Log streams must be configured before starting the LogManager");
+    TERRIER_ASSERT(num_streams > 0, "There must be at least one log stream");
+    num_streams_ = num_streams;
+  }
+
+  /**
+   * @return number of log streams
+   */
+  uint32_t NumStreams() const { return num_streams_; }
+
+  /**
+   * @param txn_begin start timestamp of a transaction
+   * @return id of the log stream in charge of the transaction's records
+   */
+  uint32_t StreamOf(const transaction::timestamp_t txn_begin) const {
+    if (num_streams_ == 1) return 0;
+    // Start timestamps are scrambled first, since transactions tend to take the same number of ticks and would
+    // otherwise pile up in a few streams.
+    constexpr uint64_t fibonacci_multiplier = 0x9E3779B97F4A7C15;
+    return static_cast<uint32_t>(((txn_begin.UnderlyingValue() * fibonacci_multiplier) >> 32) % num_streams_);
+  }
+
+  /**
+   * @param log_file_path path of the log file given to the LogManager
+   * @param stream id of a log stream
+   * @return path of the log file written by the given stream. The first stream writes to log_file_path itself, so a
+   *         LogManager with a single stream behaves exactly like one that knows nothing about streams.
+   */
+  static std::string StreamFilePath(const std::string &log_file_path, const uint32_t stream) {
+    return stream == 0 ? log_file_path : log_file_path + "." + std::to_string(stream);
+  }
+
+  /**
+   * @param stream_file_path path of the log file of a log stream
+   * @param segment_id id of a log segment
+   * @return path of the given segment of the stream's log
+   */
+  static std::string SegmentFilePath(const std::string &stream_file_path, const uint64_t segment_id) {
+    return stream_file_path + SEGMENT_SUFFIX + std::to_string(segment_id);
+  }
+
+  /**
+   * @param stream_file_path path of the log file of a log stream
+   * @return ids of the log segments of the stream that exist on disk, in ascending order
+   */
+  static std::vector<uint64_t> ListSegments(const std::string &stream_file_path);
+
+  /**
+   * @param log_file_path path of the log file given to the LogManager
+   * @param run id of a run of the log manager that was rotated out of the way
+   * @return path that takes the place of log_file_path for the log files of the given run. Its streams' files are
+   *         named after it as usual (@see StreamFilePath).
+   */
+  static std::string RunFilePath(const std::string &log_file_path, const uint64_t run) {
+    return log_file_path + RUN_SUFFIX + std::to_string(run);
+  }
+
+  /**
+   * @param log_file_path path of the log file given to the LogManager
+   * @return ids of the earlier runs whose log files were rotated out of the way, in ascending order
+   */
+  static std::vector<uint64_t> ListRotatedRuns(const std::string &log_file_path);
+
+  /**
+   * Cuts the log of every stream into segments of about the given size. Must be called before Start().
+   * @param segment_size size of a log segment in bytes, zero to write each stream's log into a single file
+   */
+  void SetSegmentSize(const uint64_t segment_size) {
+    TERRIER_ASSERT(!run_log_manager_, "Log segments must be configured before starting the LogManager");
+    segment_size_ = segment_size;
+  }
+
+  /**
+   * Deletes the log segments recovery no longer needs, given that everything done by transactions that started before
+   * the given timestamp is durable elsewhere, i.e. in a checkpoint. A segment is deleted if it is complete, and either
+   * all transactions with records in it started before the given timestamp, or it was written before the log manager
+   * was last started (and has thus been recovered already). For the same reason, the log files of earlier runs that
+   * were rotated out of the way (@see RotateEarlierRun) are deleted, and so are the streams' unsegmented log files
+   * once the log is cut into segments.
+   *
+   * @param oldest_needed_txn start timestamp of the oldest transaction whose records are still needed
+   * @return number of segments and other log files deleted
+   */
+  uint64_t DiscardSegments(transaction::timestamp_t oldest_needed_txn);
+
+  /**
+   * Switches the log manager to group commit: instead of persisting the log file periodically, the disk consumer
+   * persists it as soon as group_commit_size commits are waiting on it, or when the oldest of them is about to exceed
+   * group_commit_latency. Must be called before Start().
+   *
+   * @param group_commit_latency target latency of a commit, from reaching the disk consumer to being persisted. Zero
+   *                             disables group commit.
+   * @param group_commit_size number of waiting commits that triggers a persist right away
+   */
+  void SetGroupCommit(const std::chrono::microseconds group_commit_latency, const uint64_t group_commit_size) {
+    TERRIER_ASSERT(!run_log_manager_, "Group commit must be configured before starting the LogManager");
+    group_commit_latency_ = group_commit_latency;
+    group_commit_size_ = group_commit_size;
+  }
+
+  /**
+   * Switches the log manager to writing its log files with direct I/O, bypassing the page cache (@see
+   * BufferedLogWriter). Must be called before Start(), and must be the same for every run that appends to the same log
+   * files.
+   * @param direct_io whether to write log files with direct I/O
+   */
+  void SetDirectIO(const bool direct_io) {
+    TERRIER_ASSERT(!run_log_manager_, "Direct I/O must be configured before starting the LogManager");
+    direct_io_ = direct_io;
+  }
+
+  /**
+   * Ships the log to replicas as it is persisted (@see LogShipper). Must be called before Start(), and only works with
+   * a single log stream.
+   * @param log_shipper shipper connected to the replicas, nullptr to stop shipping
+   */
+  void SetLogShipper(const common::ManagedPointer<LogShipper> log_shipper) {
+    TERRIER_ASSERT(!run_log_manager_, "Log shipping must be configured before starting the LogManager");
+    log_shipper_ = log_shipper;
+  }
+
  private:
+  friend class DiskLogConsumerTask;
   // Flag to tell us when the log manager is running or during termination
   bool run_log_manager_;
 
   // System path for log file
   std::string log_file_path_;
 
-  // Number of buffers to use for buffering and serializing logs
+  // Number of buffers each log stream uses for buffering and serializing logs
   uint64_t num_buffers_;
 
-  // TODO(Tianyu): This can be changed later to be include things that are not necessarily backed by a disk
-  //  (e.g. logs can be streamed out to the network for remote replication)
   RecordBufferSegmentPool *buffer_pool_;
 
-  // This stores a reference to all the buffers the serializer or the log consumer threads use
-  std::vector<BufferedLogWriter> buffers_;
-  // The queue containing empty buffers which the serializer thread will use. We use a blocking queue because the
-  // serializer thread should block when requesting a new buffer until it receives an empty buffer
-  common::ConcurrentBlockingQueue<BufferedLogWriter *> empty_buffer_queue_;
-  // The queue containing filled buffers pending flush to the disk
-  common::ConcurrentQueue<SerializedLogs> filled_buffer_queue_;
+  /**
+   * A log stream serializes the logs of a subset of transactions into its own log file
+   */
+  struct LogStream {
+    explicit LogStream(std::string log_file_path) : log_file_path_(std::move(log_file_path)) {}
+
+    // System path for this stream's log file. With log segments, segment file names are derived from it.
+    const std::string log_file_path_;
+    // First segment written since the log manager was started
+    uint64_t first_segment_id_ = 0;
+    // This stores a reference to all the buffers the serializer or the log consumer threads use
+    std::vector<BufferedLogWriter> buffers_;
+    // The queue containing empty buffers which the serializer thread will use. We use a blocking queue because the
+    // serializer thread should block when requesting a new buffer until it receives an empty buffer
+    common::ConcurrentBlockingQueue<BufferedLogWriter *> empty_buffer_queue_;
+    // The queue containing filled buffers pending flush to the disk
+    common::ConcurrentQueue<SerializedLogs> filled_buffer_queue_;
+    // Log serializer task that processes buffers handed over by transactions and serializes them into consumer buffers
+    common::ManagedPointer<LogSerializerTask> log_serializer_task_ =
+        common::ManagedPointer<LogSerializerTask>(nullptr);
+    // The log consumer task which flushes filled buffers to the disk
+    common::ManagedPointer<DiskLogConsumerTask> disk_log_writer_task_ =
+        common::ManagedPointer<DiskLogConsumerTask>(nullptr);
+    // Commit timestamps of the transactions in this stream that have committed but are not persisted yet. Only tracked
+    // with several log streams.
+    std::set<transaction::timestamp_t> unpersisted_commits_;
+    common::SpinLatch commits_latch_;
+  };
+
+  // Number of log streams to run
+  uint32_t num_streams_ = 1;
+  // The log streams, only populated while the log manager is running
+  std::vector<std::unique_ptr<LogStream>> streams_;
+  // Callbacks of commits that are persisted, but wait for older commits in other streams to be persisted as well
+  std::vector<CommitCallback> persisted_commits_;
+  common::SpinLatch persisted_commits_latch_;
 
-  // Log serializer task that processes buffers handed over by transactions and serializes them into consumer buffers
-  common::ManagedPointer<LogSerializerTask> log_serializer_task_ = common::ManagedPointer<LogSerializerTask>(nullptr);
   // Interval used by log serialization task
   const std::chrono::microseconds serialization_interval_;
 
-  // The log consumer task which flushes filled buffers to the disk
-  common::ManagedPointer<DiskLogConsumerTask> disk_log_writer_task_ =
-      common::ManagedPointer<DiskLogConsumerTask>(nullptr);
   // Interval used by disk consumer task
   const std::chrono::microseconds persist_interval_;
   // Threshold used by disk consumer task
   uint64_t persist_threshold_;
+  // Group commit settings used by disk consumer task, disabled by default
+  std::chrono::microseconds group_commit_latency_{0};
+  uint64_t group_commit_size_ = DEFAULT_GROUP_COMMIT_SIZE;
+  // Whether log files are written with direct I/O
+  bool direct_io_ = false;
+  // Size of log segments, or zero if logs are not cut into segments
+  uint64_t segment_size_ = 0;
+  // Ships the log to replicas, if there are any
+  common::ManagedPointer<LogShipper> log_shipper_ = common::ManagedPointer<LogShipper>(nullptr);
+  // Separates the segment id from the stream's log file path in segment file names
+  static constexpr const char *SEGMENT_SUFFIX = ".segment.";
+  // Separates the run id from the log file path in the names of rotated log files
+  static constexpr const char *RUN_SUFFIX = ".run.";
+  // Whether this log manager was started before, and thus wrote the log files on disk itself
+  bool started_ = false;
+
+  /**
+   * Called on the first start, without log segments. Streams are merged by commit timestamp, which restarts with the
+   * system, so the log files of an earlier run cannot simply be appended to if either that run or this one writes
+   * several streams. They are renamed after the next free run id instead (@see RunFilePath), and recovery replays the
+   * rotated runs one after another before the current one. A single stream's log file keeps growing across runs.
+   */
+  void RotateEarlierRun();
+
+  /**
+   * Deletes the log files written before the log manager was last started that are not segments, i.e. those of rotated
+   * runs, and the unsegmented log files of the streams if the log is cut into segments.
+   * @return number of log files deleted
+   */
+  uint64_t DiscardEarlierRuns();
+
+  /**
+   * @param stream a running log stream
+   * @return path of the file the stream is currently writing to
+   */
+  std::string CurrentLogFilePath(const LogStream &stream) const;
+
+  /**
+   * @param buffer_segment a buffer of log records handed over by a transaction
+   * @return the log stream in charge of the transaction that wrote the buffer
+   */
+  LogStream *StreamFor(RecordBufferSegment *buffer_segment);
+
+  /**
+   * Called by a stream's DiskLogConsumerTask after it persists, with several log streams. Stops tracking the given
+   * commits, and invokes the callbacks of every persisted commit that is older than all commits still being tracked.
+   * @param stream_id id of the log stream that persisted the commits
+   * @param commits callbacks of the commits that were just persisted
+   */
+  void CommitsPersisted(uint32_t stream_id, const std::vector<CommitCallback> &commits);
+
+  /**
+   * Signals a stream's DiskLogConsumerTask to persist, without waiting for it
+   * @param stream a running log stream
+   */
+  void RequestPersist(LogStream *stream);
+
+  /**
+   * Waits until a persist requested with RequestPersist is done
+   * @param stream a running log stream
+   */
+  void AwaitPersist(LogStream *stream);
 
   /**
    * If the central registry wants to removes our thread used for the disk log consumer task, we only allow removal if
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstring>
+
 #include "storage/data_table.h"
 #include "storage/projected_row.h"
 #include "transaction/timestamp_manager.h"
@@ -155,6 +157,34 @@ class RedoRecord {
     return result;
   }
 
+  /**
+   * @return Size of the entire record of this type, in bytes, in memory, if the underlying Delta is a copy of the given
+   * projected row.
+   */
+  static uint32_t Size(const ProjectedRow &delta) {
+    return static_cast<uint32_t>(sizeof(LogRecord) + sizeof(RedoRecord) + delta.Size());
+  }
+
+  /**
+   * Initialize an entire LogRecord (header included) to have an underlying redo record, with a copy of the given
+   * projected row as its delta
+   * @param head pointer location to initialize, this is also the returned address (reinterpreted)
+   * @param txn_begin begin timestamp of the transaction that generated this log record
+   * @param db_oid database oid of this redo record
+   * @param table_oid table oid of this redo record
+   * @param delta the projected row to copy into the record
+   * @return pointer to the initialized log record, always equal in value to the given head
+   */
+  static LogRecord *Initialize(byte *const head, const transaction::timestamp_t txn_begin,
+                               const catalog::db_oid_t db_oid, const catalog::table_oid_t table_oid,
+                               const ProjectedRow &delta) {
+    LogRecord *result = PartialInitialize(head, Size(delta), txn_begin, db_oid, table_oid, TupleSlot(nullptr, 0));
+    // Projected rows only hold offsets into themselves, so a copy of the bytes is a valid row
+    std::memcpy(reinterpret_cast<void *>(result->GetUnderlyingRecordBodyAs<RedoRecord>()->Delta()), &delta,
+                delta.Size());
+    return result;
+  }
+
   /**
    * TODO(Tianyu): Remove this as we clean up serialization
    * Hacky back door for BufferedLogReader. Essentially, the current implementation dumps memory content straight out
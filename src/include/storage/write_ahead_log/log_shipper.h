@@ -0,0 +1,136 @@
+#pragma once
+
+#include <sys/uio.h>
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <queue>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/macros.h"
+#include "network/network_defs.h"
+#include "network/network_io_wrapper.h"
+
+namespace terrier::storage {
+
+/**
+ * Ships the log written by a primary to its replicas over the ITP protocol, where a ReplicationLogProvider hands it to
+ * a recovery manager that replays it as it arrives.
+ *
+ * The DiskLogConsumerTask hands the shipper what it wrote to the log file once that is persisted, so replicas receive
+ * the same bytes the log file holds, and never anything the primary could still lose in a crash. The shipper sends it
+ * out on a thread of its own, so that a slow replica does not hold up writing the log. It only pushes back once
+ * MAX_QUEUED_SIZE bytes are waiting to be sent. The log is cut into replication messages of at most MAX_MESSAGE_SIZE
+ * bytes, numbered in the order they are sent. If a replica cannot be reached, the message is resent once over a new
+ * connection (the replica ignores messages it already has). If that fails too, the replica is dropped, so that a broken
+ * replica never holds up the primary for long. A dropped replica is missing part of the log and has to be rebuilt from
+ * scratch.
+ *
+ * Replicas only receive the log written after the shipper was created, so they need to be attached to a primary that
+ * starts out empty, before its catalog is bootstrapped. Only a log manager with a single log stream can ship its log,
+ * as the replica replays the log in the order it arrives.
+ */
+class LogShipper {
+ public:
+  /**
+   * Largest amount of log in a single replication message
+   */
+  static constexpr uint64_t MAX_MESSAGE_SIZE = 1 << 20;
+  static_assert(MAX_MESSAGE_SIZE + 2 * sizeof(uint64_t) <= PACKET_LEN_LIMIT, "Replication messages must fit a packet");
+
+  /**
+   * Amount of log waiting to be shipped beyond which Enqueue blocks until the replicas catch up
+   */
+  static constexpr uint64_t MAX_QUEUED_SIZE = 64 * MAX_MESSAGE_SIZE;
+
+  /**
+   * Connects to the given replicas, and starts the thread shipping the log to them. Replicas that cannot be reached are
+   * left out with a warning.
+   * @param replica_addresses addresses of the replicas as "host:port"
+   * @throw std::runtime_error if an address is malformed
+   */
+  explicit LogShipper(const std::vector<std::string> &replica_addresses);
+
+  /**
+   * Stops replication if it has not been stopped already
+   */
+  ~LogShipper() { StopReplication(); }
+
+  DISALLOW_COPY_AND_MOVE(LogShipper);
+
+  /**
+   * @param replica_addresses comma separated list of "host:port" addresses, as given in the settings
+   * @return the addresses in the list
+   */
+  static std::vector<std::string> ParseAddresses(const std::string &replica_addresses);
+
+  /**
+   * Queues up a stretch of persisted log to be shipped to all replicas after everything queued before it. Blocks while
+   * more than MAX_QUEUED_SIZE bytes are waiting to be shipped. Must not be called concurrently with itself.
+   * @param logs the next stretch of the log, dropped if replication has been stopped
+   */
+  void Enqueue(std::vector<char> &&logs);
+
+  /**
+   * Ships everything queued so far, then tells all replicas that the log ends here and disconnects from them. Nothing
+   * is shipped afterwards.
+   */
+  void StopReplication();
+
+  /**
+   * @return id of the next replication message, which is the number of messages shipped so far
+   */
+  uint64_t NextMessageId() const { return next_message_id_.load(); }
+
+  /**
+   * @return number of replicas the log is shipped to
+   */
+  uint32_t NumReplicas() const { return static_cast<uint32_t>(replicas_.size()); }
+
+ private:
+  // How long we wait for a replica to take more of a message before giving up on the connection
+  static constexpr int SEND_TIMEOUT_MS = 10000;
+
+  struct Replica {
+    std::string address_;
+    std::unique_ptr<network::NetworkIoWrapper> io_;
+  };
+
+  // Only touched by the shipper thread once it is running
+  std::vector<Replica> replicas_;
+  std::atomic<uint64_t> next_message_id_{0};
+
+  // Log waiting to be shipped, and how many bytes of it there are, protected by queue_latch_
+  std::queue<std::vector<char>> queue_;
+  uint64_t queued_size_ = 0;
+  bool stopped_ = false;
+  std::mutex queue_latch_;
+  // Signals both that there is log to ship, and that there is room in the queue
+  std::condition_variable queue_cv_;
+  std::thread shipper_thread_;
+
+  // Ships the queued log until replication is stopped and the queue is drained
+  void ShipperLoop();
+
+  // Ships a stretch of the log to all replicas, blocking until they have it or are dropped
+  void Ship(const std::vector<char> &logs);
+
+  // Ships one message to every replica, dropping the ones that cannot be reached
+  void ShipMessage(const std::vector<iovec> &message, uint64_t message_size);
+
+  // Opens a connection to the address, or returns nullptr if it cannot be reached
+  static std::unique_ptr<network::NetworkIoWrapper> Connect(const std::string &address);
+
+  // Writes a replication message to the connection, returns false if it failed
+  static bool SendMessage(network::NetworkIoWrapper *io, uint64_t message_id, const std::vector<iovec> &message,
+                          uint64_t message_size);
+
+  // Writes everything queued on the connection, returns false if it failed
+  static bool Flush(network::NetworkIoWrapper *io);
+};
+
+}  // namespace terrier::storage
@@ -93,9 +93,15 @@ class TrafficCop {
 
   /**
    * Hands a buffer of logs to replication
+   * @param message_id id of the replication message the logs arrived in
    * @param buffer buffer containing logs
    */
-  void HandBufferToReplication(std::unique_ptr<network::ReadBuffer> buffer);
+  void HandBufferToReplication(uint64_t message_id, std::unique_ptr<network::ReadBuffer> buffer);
+
+  /**
+   * Tells replication that the primary will not send any more logs
+   */
+  void StopReplication();
 
   /**
    * Create a temporary namespace for a connection
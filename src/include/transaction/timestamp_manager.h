@@ -1,9 +1,14 @@
 #pragma once
 
 #include <algorithm>
-#include <unordered_set>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <set>
+#include <thread>  // NOLINT
 #include <vector>
 
+#include "common/constants.h"
 #include "common/spin_latch.h"
 #include "common/strong_typedef.h"
 #include "transaction/transaction_defs.h"
@@ -17,12 +22,18 @@ namespace terrier::transaction {
 class TransactionManager;
 /**
  * Generates timestamps, and keeps track of the lifetime of transactions (whether they have entered or left the system)
+ *
+ * The set of running transactions is split into shards by start timestamp, each with its own latch, so that
+ * transactions beginning and ending on different threads do not serialize on a single latch. A second, smaller set of
+ * latches, picked by thread, fences transactions that are in the middle of beginning against a concurrent computation
+ * of the oldest running transaction.
  */
 class TimestampManager {
  public:
   ~TimestampManager() {
-    TERRIER_ASSERT(curr_running_txns_.empty(),
-                   "Destroying the TimestampManager while txns are still running. That seems wrong.");
+    for (auto &shard UNUSED_ATTRIBUTE : running_txns_shards_)
+      TERRIER_ASSERT(shard.txns_.empty(),
+                     "Destroying the TimestampManager while txns are still running. That seems wrong.");
   }
 
   /**
@@ -35,13 +46,25 @@ class TimestampManager {
    */
   timestamp_t CurrentTime() const { return time_.load(); }
 
+  /**
+   * Moves the current time past the given timestamp, unless it is past it already, so that every timestamp handed out
+   * from now on is newer. Time starts over when the system restarts, so this is needed after recovery to keep new
+   * transactions ordered after the recovered ones.
+   * @param timestamp timestamp to move past
+   */
+  void AdvancePast(const timestamp_t timestamp) {
+    timestamp_t current = time_.load();
+    while (current <= timestamp && !time_.compare_exchange_weak(current, timestamp + 1)) {
+    }
+  }
+
   /**
    * Get the oldest transaction alive (by start timestamp given out by this timestamp manager at this time)
    * Because of concurrent operations, it is not guaranteed that upon return the txn is still alive. However,
    * it is guaranteed that the return timestamp is older than any transactions live.
-   * @warning If logging is enabled, txns are not removed from the txn set until they are serialized. Thus, the active
-   * txn set can grow greatly in size, making this call expensive. Consider using CachedOldestTransactionStartTime for
-   * better peformance at the cost of a more stale timestamp.
+   * @warning This takes every latch of the TimestampManager in turn, so it should only be called periodically (e.g. by
+   * the GC), and not on the critical path of transactions. Consider using CachedOldestTransactionStartTime for better
+   * peformance at the cost of a more stale timestamp.
    * @return timestamp that is older than any transactions alive
    */
   timestamp_t OldestTransactionStartTime();
@@ -57,29 +80,24 @@ class TimestampManager {
   timestamp_t CachedOldestTransactionStartTime();
 
  private:
-  // TransactionManager needs to be able to use the curr_running_txns_latch to guard more than just the
-  // duration of the following method calls --- things such as adding to the GC queue needs to be atomic
-  // along with removing a transaction from the table of active transactions. We need this for correctness
-  // in the deferred action framework when dropping tables.
   friend class TransactionManager;
   friend class storage::LogSerializerTask;
   timestamp_t BeginTransaction() {
-    timestamp_t start_time;
-    {
-      common::SpinLatch::ScopedSpinLatch running_guard(&curr_running_txns_latch_);
-      // There is a three-way race that needs to be prevented.  Specifically, we
-      // cannot allow both a transaction to commit and the GC to poll for the
-      // oldest running transaction in between this transaction acquiring its
-      // begin timestamp and getting inserted into the current running
-      // transactions list.  Using the current running transactions latch
-      // prevents the GC from polling and stops the race.  This allows us to
-      // replace acquiring a shared instance of the commit latch with a
-      // read-only spin-latch and move the allocation out of a critical section.
-      start_time = time_++;
-
-      const auto ret UNUSED_ATTRIBUTE = curr_running_txns_.emplace(start_time);
-      TERRIER_ASSERT(ret.second, "commit start time should be globally unique");
-    }  // Release latch on current running transactions
+    // There is a three-way race that needs to be prevented.  Specifically, we
+    // cannot allow both a transaction to commit and the GC to poll for the
+    // oldest running transaction in between this transaction acquiring its
+    // begin timestamp and getting inserted into the current running
+    // transactions list.  Holding our begin latch over both steps stops the
+    // race, as OldestTransactionStartTime waits on every begin latch after
+    // reading the current time and before looking at the running transactions.
+    static thread_local const uint32_t begin_latch_hint =
+        static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    common::SpinLatch::ScopedSpinLatch begin_guard(&begin_latches_[begin_latch_hint % NUM_BEGIN_LATCHES].latch_);
+    const timestamp_t start_time = time_++;
+    RunningTxnsShard &shard = ShardFor(start_time);
+    common::SpinLatch::ScopedSpinLatch running_guard(&shard.latch_);
+    const auto ret UNUSED_ATTRIBUTE = shard.txns_.emplace(start_time);
+    TERRIER_ASSERT(ret.second, "commit start time should be globally unique");
     return start_time;
   }
 
@@ -90,22 +108,39 @@ class TimestampManager {
   void RemoveTransaction(timestamp_t timestamp);
 
   /**
-   * Bulk remove a set of timestamps from the active txn set. Only grabs the curr_running_txns_latch_ once for all the
-   * timestamps.
+   * Bulk remove a set of timestamps from the active txn set. Only grabs the latch of each shard once for all the
+   * timestamps in it.
    * @param timestamps vector of timestamps to remove
    */
   void RemoveTransactions(const std::vector<timestamp_t> &timestamps);
 
-  // TODO(Tianyu): Timestamp generation needs to be more efficient (batches)
+  // Running transactions whose start timestamps fall into this shard, and the latch protecting them. Each shard is
+  // aligned to its own cache line so that latching one does not slow down threads working on its neighbours.
+  struct alignas(common::Constants::CACHELINE_SIZE) RunningTxnsShard {
+    // Ordered, so that the oldest transaction in the shard is always the first one
+    std::set<timestamp_t> txns_;
+    common::SpinLatch latch_;
+  };
+
+  struct alignas(common::Constants::CACHELINE_SIZE) BeginLatch {
+    common::SpinLatch latch_;
+  };
+
+  // Consecutive start timestamps land in different shards, so concurrent transactions spread evenly over them.
+  RunningTxnsShard &ShardFor(const timestamp_t timestamp) {
+    return running_txns_shards_[timestamp.UnderlyingValue() % NUM_RUNNING_TXNS_SHARDS];
+  }
+
+  static constexpr uint32_t NUM_RUNNING_TXNS_SHARDS = 64;
+  static constexpr uint32_t NUM_BEGIN_LATCHES = 64;
+
+  // Start timestamps have to be handed out in order with commit timestamps for snapshot isolation to hold, so they
+  // cannot be checked out in per-thread batches. A single atomic increment is all it takes anyway.
   // TODO(Tianyu): We don't handle timestamp wrap-arounds. I doubt this would be an issue any time soon.
   std::atomic<timestamp_t> time_{INITIAL_TXN_TIMESTAMP};
   // We cache the oldest txn start time
   std::atomic<timestamp_t> cached_oldest_txn_start_time_{INITIAL_TXN_TIMESTAMP};
-  // TODO(Matt): consider a different data structure if this becomes a measured bottleneck
-  // TODO(Gus): This data structure initially only held items in the order of # of workers. With the logging change, it
-  // can hold many more, since txns are only removed when serialized. We should consider if there is a possible better
-  // data structure
-  std::unordered_set<timestamp_t> curr_running_txns_;
-  mutable common::SpinLatch curr_running_txns_latch_;
+  std::array<RunningTxnsShard, NUM_RUNNING_TXNS_SHARDS> running_txns_shards_;
+  std::array<BeginLatch, NUM_BEGIN_LATCHES> begin_latches_;
 };
 }  // namespace terrier::transaction
@@ -82,6 +82,14 @@ class TransactionContext {
    */
   timestamp_t FinishTime() const { return finish_time_.load(); }
 
+  /**
+   * @return a timestamp older than every transaction that was running when this transaction began, and therefore older
+   * than every transaction running alongside it. Versions that were committed before this timestamp are not visible
+   * to any of them, so readers and writers of this transaction may unlink them from version chains. This is the
+   * TimestampManager's cached oldest start time when the transaction began, so it may be stale.
+   */
+  timestamp_t OldestTransactionStartTime() const { return oldest_txn_start_time_; }
+
   /**
    * Reserve space on this transaction's undo buffer for a record to log the update given
    * @param table pointer to the updated DataTable object
@@ -138,6 +146,36 @@ class TransactionContext {
     return log_record->GetUnderlyingRecordBodyAs<storage::RedoRecord>();
   }
 
+  /**
+   * Expose records holding copies of the given rows, to be inserted into the SqlTable, that will be logged out to disk.
+   * The records are staged in one step and laid out back to back, but only as many as fit into the current redo buffer
+   * segment are staged, so callers should call this again with the remaining rows once the staged ones are written.
+   * @param db_oid the database oid that these records change
+   * @param table_oid the table oid that these records change
+   * @param rows rows to copy into the records, which must all have the same size
+   * @param num_rows number of rows given, must be at least 1
+   * @param[out] records the staged records, in the order of the rows
+   * @return number of records staged, which is at least 1
+   * @warning All records returned by StageWrites become invalid together on the next call to StageWrite or StageWrites,
+   * just like a single record returned by StageWrite.
+   * @warning If you call StageWrites, the operations WILL be logged to disk. If you StageWrites anything that you
+   * didn't succeed in writing into the table or decide you don't want to use, the transaction MUST abort.
+   */
+  uint32_t StageWrites(const catalog::db_oid_t db_oid, const catalog::table_oid_t table_oid,
+                       const storage::ProjectedRow *const *const rows, const uint32_t num_rows,
+                       storage::RedoRecord **const records) {
+    const uint32_t size = storage::RedoRecord::Size(*rows[0]);
+    uint32_t num_staged;
+    byte *const head = redo_buffer_.NewEntries(size, num_rows, &num_staged);
+    for (uint32_t i = 0; i < num_staged; i++) {
+      TERRIER_ASSERT(rows[i]->Size() == rows[0]->Size(), "Rows staged together must have the same size");
+      auto *const log_record =
+          storage::RedoRecord::Initialize(head + i * size, start_time_, db_oid, table_oid, *rows[i]);
+      records[i] = log_record->GetUnderlyingRecordBodyAs<storage::RedoRecord>();
+    }
+    return num_staged;
+  }
+
   /**
    * Initialize a record that logs a delete, that will be logged out to disk
    * @param db_oid the database oid that this record changes
@@ -214,6 +252,9 @@ class TransactionContext {
   friend class storage::RecoveryTests;           // Needs access to redo buffer
   const timestamp_t start_time_;
   std::atomic<timestamp_t> finish_time_;
+  // Set by the TransactionManager when the transaction begins. Nothing is older than the initial value, so transactions
+  // constructed elsewhere never unlink versions.
+  timestamp_t oldest_txn_start_time_ = INITIAL_TXN_TIMESTAMP;
   storage::UndoBuffer undo_buffer_;
   storage::RedoBuffer redo_buffer_;
   // TODO(Tianyu): Maybe not so much of a good idea to do this. Make explicit queue in GC?
@@ -1,9 +1,13 @@
 #pragma once
 
+#include <array>
+#include <functional>
 #include <queue>
+#include <thread>  // NOLINT
 #include <unordered_set>
 #include <utility>
 
+#include "common/constants.h"
 #include "common/gate.h"
 #include "common/spin_latch.h"
 #include "common/strong_typedef.h"
@@ -73,6 +77,11 @@ class TransactionManager {
    */
   bool GCEnabled() const { return gc_enabled_; }
 
+  /**
+   * @return the timestamp manager that this transaction manager takes its timestamps from
+   */
+  common::ManagedPointer<TimestampManager> GetTimestampManager() const { return timestamp_manager_; }
+
   /**
    * Return a copy of the completed txns queue and empty the local version
    * @return copy of the completed txns for the GC to process
@@ -87,9 +96,19 @@ class TransactionManager {
   common::Gate txn_gate_;
 
   bool gc_enabled_ = false;
-  TransactionQueue completed_txns_;
+
+  // Completed transactions waiting for the GC, split up so that threads committing concurrently do not all line up on
+  // the same latch. The GC drains all of them at once.
+  struct alignas(common::Constants::CACHELINE_SIZE) CompletedTxnsQueue {
+    TransactionQueue txns_;
+    common::SpinLatch latch_;
+  };
+  static constexpr uint32_t NUM_COMPLETED_TXNS_QUEUES = 16;
+  std::array<CompletedTxnsQueue, NUM_COMPLETED_TXNS_QUEUES> completed_txns_;
   const common::ManagedPointer<storage::LogManager> log_manager_;
 
+  timestamp_t CheckOutCommitTimestamp(TransactionContext *txn);
+
   timestamp_t UpdatingCommitCriticalSection(TransactionContext *txn);
 
   void LogCommit(TransactionContext *txn, timestamp_t commit_time, transaction::callback_fn commit_callback,
@@ -97,6 +116,8 @@ class TransactionManager {
 
   void LogAbort(TransactionContext *txn);
 
+  void HandOffToGC(TransactionContext *txn);
+
   void Rollback(TransactionContext *txn, const storage::UndoRecord &record) const;
 
   void DeallocateColumnUpdateIfVarlen(TransactionContext *txn, storage::UndoRecord *undo,
@@ -31,6 +31,42 @@ void DBMain::ForceShutdown() {
 
 DBMain::~DBMain() { ForceShutdown(); }
 
+DBMain::ReplicationLayer::ReplicationLayer(
+    const common::ManagedPointer<common::DedicatedThreadRegistry> thread_registry,
+    const common::ManagedPointer<TransactionLayer> txn_layer, const common::ManagedPointer<StorageLayer> storage_layer,
+    const common::ManagedPointer<catalog::Catalog> catalog, const uint16_t port) {
+  log_provider_ = std::make_unique<storage::ReplicationLogProvider>();
+  recovery_manager_ = std::make_unique<storage::RecoveryManager>(
+      common::ManagedPointer<storage::AbstractLogProvider>(log_provider_.get()), catalog,
+      txn_layer->GetTransactionManager(), txn_layer->GetDeferredActionManager(), thread_registry,
+      storage_layer->GetBlockStore());
+  traffic_cop_ = std::make_unique<trafficcop::TrafficCop>(
+      txn_layer->GetTransactionManager(), catalog, common::ManagedPointer(log_provider_), DISABLED, DISABLED, 0, false,
+      execution::vm::ExecutionMode::Interpret);
+  connection_handle_factory_ = std::make_unique<network::ConnectionHandleFactory>(common::ManagedPointer(traffic_cop_));
+  command_factory_ = std::make_unique<network::ITPCommandFactory>();
+  provider_ = std::make_unique<network::ITPProtocolInterpreter::Provider>(common::ManagedPointer(command_factory_));
+  // The primary only ever opens one connection at a time
+  server_ = std::make_unique<network::TerrierServer>(common::ManagedPointer(provider_),
+                                                     common::ManagedPointer(connection_handle_factory_),
+                                                     thread_registry, port, 1);
+  server_->RunServer();
+  recovery_manager_->StartRecovery();
+}
+
+DBMain::ReplicationLayer::~ReplicationLayer() {
+  // Don't wait for a primary that may never stop replication
+  log_provider_->EndReplication();
+  WaitForReplicationToFinish();
+}
+
+void DBMain::ReplicationLayer::WaitForReplicationToFinish() {
+  if (finished_) return;
+  recovery_manager_->WaitForRecoveryToFinish();
+  if (server_->Running()) server_->StopServer();
+  finished_ = true;
+}
+
 DBMain::ExecutionLayer::ExecutionLayer() { execution::ExecutionUtil::InitTPL(); }
 
 DBMain::ExecutionLayer::~ExecutionLayer() { execution::ExecutionUtil::ShutdownTPL(); }
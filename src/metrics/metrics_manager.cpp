@@ -85,6 +85,11 @@ void MetricsManager::ResetMetric(const MetricsComponent component) const {
         metric->Swap();
         break;
       }
+      case MetricsComponent::COMPACTION: {
+        const auto &metric = metrics_store.second->compaction_metric_;
+        metric->Swap();
+        break;
+      }
     }
   }
 }
@@ -145,6 +150,10 @@ void MetricsManager::ToCSV() const {
           OpenFiles<ExecuteCommandMetricRawData>(&outfiles);
           break;
         }
+        case MetricsComponent::COMPACTION: {
+          OpenFiles<CompactionMetricRawData>(&outfiles);
+          break;
+        }
       }
       aggregated_metrics_[component]->ToCSV(&outfiles);
       for (auto &file : outfiles) {
@@ -18,6 +18,7 @@ MetricsStore::MetricsStore(const common::ManagedPointer<metrics::MetricsManager>
   pipeline_metric_ = std::make_unique<PipelineMetric>();
   bind_command_metric_ = std::make_unique<BindCommandMetric>();
   execute_command_metric_ = std::make_unique<ExecuteCommandMetric>();
+  compaction_metric_ = std::make_unique<CompactionMetric>();
 }
 
 std::array<std::unique_ptr<AbstractRawData>, NUM_COMPONENTS> MetricsStore::GetDataToAggregate() {
@@ -75,6 +76,13 @@ std::array<std::unique_ptr<AbstractRawData>, NUM_COMPONENTS> MetricsStore::GetDa
           result[component] = execute_command_metric_->Swap();
           break;
         }
+        case MetricsComponent::COMPACTION: {
+          TERRIER_ASSERT(
+              compaction_metric_ != nullptr,
+              "CompactionMetric cannot be a nullptr. Check the MetricsStore constructor that it was allocated.");
+          result[component] = compaction_metric_->Swap();
+          break;
+        }
       }
     }
   }
@@ -17,9 +17,20 @@ Transition ReplicationCommand::Exec(common::ManagedPointer<ProtocolInterpreter>
                                     common::ManagedPointer<ITPPacketWriter> out,
                                     common::ManagedPointer<trafficcop::TrafficCop> t_cop,
                                     common::ManagedPointer<ConnectionContext> connection) {
-  std::unique_ptr<ReadBuffer> buffer;
-  buffer->FillBufferFrom(in_, in_len_);
-  t_cop->HandBufferToReplication(std::move(buffer));
+  constexpr size_t header_size = 2 * sizeof(uint64_t);
+  if (in_len_ < header_size) {
+    NETWORK_LOG_ERROR("Replication command of {0} bytes is too short", in_len_);
+    return Transition::TERMINATE;
+  }
+  const auto message_id = in_.ReadValue<uint64_t>();
+  const auto data_size = in_.ReadValue<uint64_t>();
+  if (data_size != in_len_ - header_size) {
+    NETWORK_LOG_ERROR("Replication command of {0} bytes claims to carry {1} bytes of data", in_len_, data_size);
+    return Transition::TERMINATE;
+  }
+  auto buffer = std::make_unique<ReadBuffer>(data_size);
+  buffer->FillBufferFrom(in_, data_size);
+  t_cop->HandBufferToReplication(message_id, std::move(buffer));
   return Transition::PROCEED;
 }
 
@@ -27,7 +38,7 @@ Transition StopReplicationCommand::Exec(common::ManagedPointer<ProtocolInterpret
                                         common::ManagedPointer<ITPPacketWriter> out,
                                         common::ManagedPointer<trafficcop::TrafficCop> t_cop,
                                         common::ManagedPointer<ConnectionContext> connection) {
-  // TODO(Tianlei): modify this implementation for the complete ITP protocol
+  t_cop->StopReplication();
   return Transition::PROCEED;
 }
 
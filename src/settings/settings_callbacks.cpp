@@ -93,6 +93,17 @@ void Callbacks::MetricsGC(void *const old_value, void *const new_value, DBMain *
   action_context->SetState(common::ActionState::SUCCESS);
 }
 
+void Callbacks::MetricsCompaction(void *const old_value, void *const new_value, DBMain *const db_main,
+                                  common::ManagedPointer<common::ActionContext> action_context) {
+  action_context->SetState(common::ActionState::IN_PROGRESS);
+  bool new_status = *static_cast<bool *>(new_value);
+  if (new_status)
+    db_main->GetMetricsManager()->EnableMetric(metrics::MetricsComponent::COMPACTION, 0);
+  else
+    db_main->GetMetricsManager()->DisableMetric(metrics::MetricsComponent::COMPACTION);
+  action_context->SetState(common::ActionState::SUCCESS);
+}
+
 void Callbacks::MetricsExecution(void *const old_value, void *const new_value, DBMain *const db_main,
                                  common::ManagedPointer<common::ActionContext> action_context) {
   action_context->SetState(common::ActionState::IN_PROGRESS);
@@ -59,6 +59,15 @@ void SettingsManager::ValidateParams() {
 #include "settings/settings_common.h"  // NOLINT
 #include "settings/settings_defs.h"    // NOLINT
 #undef __SETTING_VALIDATE__            // NOLINT
+
+  // Huge pages only come in a few sizes, which a range cannot express
+  const auto &huge_page_size = param_map_.find(Param::block_store_huge_page_size)->second;
+  const auto huge_page_size_mb = huge_page_size.value_.Peek<int32_t>();
+  if (huge_page_size_mb != 0 && huge_page_size_mb != 2 && huge_page_size_mb != 1024) {
+    throw SETTINGS_EXCEPTION(fmt::format("{} is not a valid value for parameter \"{}\" (0, 2 or 1024)",
+                                         huge_page_size_mb, huge_page_size.name_),
+                             common::ErrorCode::ERRCODE_INVALID_PARAMETER_VALUE);
+  }
 }
 
 void SettingsManager::ValidateSetting(Param param, const parser::ConstantValueExpression &min_value,
@@ -5,7 +5,7 @@ namespace terrier::storage {
 void AccessObserver::ObserveGCInvocation() {
   gc_epoch_++;
   for (auto it = last_touched_.begin(), end = last_touched_.end(); it != end;) {
-    if (it->second + COLD_DATA_EPOCH_THRESHOLD < gc_epoch_) {
+    if (it->second + cold_data_epoch_threshold_ < gc_epoch_) {
       compactor_->PutInQueue(it->first);
       it = last_touched_.erase(it);
     } else {
@@ -17,7 +17,18 @@ void AccessObserver::ObserveGCInvocation() {
 void AccessObserver::ObserveWrite(RawBlock *block) {
   // The compactor is only concerned with blocks that are already full. We assume that partially empty blocks are
   // always hot.
-  if (block->GetInsertHead() == block->data_table_->GetBlockLayout().NumSlots()) last_touched_[block] = gc_epoch_;
+  if (block->GetInsertHead() == block->data_table_->GetBlockLayout().NumSlots() && block->data_table_->IsCompactable())
+    last_touched_[block] = gc_epoch_;
+}
+
+void AccessObserver::ForgetUncompactableBlocks() {
+  for (auto it = last_touched_.begin(), end = last_touched_.end(); it != end;) {
+    if (!it->first->data_table_->IsCompactable())
+      it = last_touched_.erase(it);
+    else
+      ++it;
+  }
+  compactor_->DropUncompactableBlocks();
 }
 
 }  // namespace terrier::storage
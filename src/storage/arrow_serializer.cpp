@@ -43,7 +43,7 @@ void ArrowSerializer::AssembleMetadataBuffer(std::ofstream &outfile, flatbuf::Me
 void ArrowSerializer::WriteSchemaMessage(std::ofstream &outfile, std::unordered_map<col_id_t, int64_t> *dictionary_ids,
                                          std::vector<type::TypeId> *col_types,
                                          flatbuffers::FlatBufferBuilder *flatbuf_builder) {
-  RawBlock *block = data_table_.blocks_.front();
+  RawBlock *block = data_table_.blocks_[0];
   const BlockLayout &layout = data_table_.accessor_.GetBlockLayout();
   ArrowBlockMetadata &metadata = data_table_.accessor_.GetArrowBlockMetadata(block);
   std::vector<flatbuffers::Offset<flatbuf::Field>> fields;
@@ -163,11 +163,10 @@ void ArrowSerializer::ExportTable(const std::string &file_name, std::vector<type
 
   const BlockLayout &layout = data_table_.accessor_.GetBlockLayout();
   auto column_ids = layout.AllColumns();
-  data_table_.blocks_latch_.Lock();
-  std::vector<RawBlock *> tmp_blocks = data_table_.blocks_;
-  data_table_.blocks_latch_.Unlock();
-
-  for (RawBlock *block : tmp_blocks) {
+  // Only export the blocks that exist when we start
+  const uint32_t num_blocks = data_table_.blocks_.Size();
+  for (uint32_t block_index = 0; block_index < num_blocks; block_index++) {
+    RawBlock *block = data_table_.blocks_[block_index];
     std::vector<flatbuf::FieldNode> field_nodes;
     std::vector<flatbuf::Buffer> buffers;
 
@@ -0,0 +1,193 @@
+#include "storage/block_arenas.h"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/math_util.h"
+#include "loggers/storage_logger.h"
+
+// Needed for some Darwin machine that don't have MAP_ANONYMOUS
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+namespace terrier::storage {
+
+namespace {
+// Pages are touched at this stride when pre-faulting, which covers regular pages in case huge pages are not granted
+constexpr uint64_t PREFAULT_STRIDE = 4 * common::Constants::KB;
+// MPOL_PREFERRED from numaif.h. We only ever prefer a node, so that a full node spills over instead of failing.
+constexpr int64_t NUMA_POLICY_PREFERRED = 1;
+}  // namespace
+
+BlockArenas::BlockArenas(const uint32_t huge_page_size, const bool numa_aware)
+    : page_size_(static_cast<uint64_t>(huge_page_size) * common::Constants::MB),
+      arena_size_(std::max(page_size_, MIN_ARENA_SIZE)),
+      numa_aware_(numa_aware),
+      nodes_(numa_aware ? NumSystemNodes() : 1) {
+  if (huge_page_size != 2 && huge_page_size != 1024)
+    throw std::runtime_error("Huge pages of " + std::to_string(huge_page_size) + " MB are not supported for blocks");
+}
+
+BlockArenas::~BlockArenas() {
+  for (auto &entry : arenas_) munmap(entry.second.mapping_, entry.second.mapping_size_);
+}
+
+RawBlock *BlockArenas::New() {
+  uint32_t node_id = numa_aware_ ? CurrentNode() : 0;
+  if (node_id >= nodes_.size()) node_id = 0;
+  byte *memory = TakeFreeBlock(node_id, true);
+  // If no more arenas can be mapped, a block on another node is still better than none at all
+  for (uint32_t other = 0; memory == nullptr && other < nodes_.size(); other++) {
+    if (other == node_id) continue;
+    memory = TakeFreeBlock(other, false);
+    if (memory != nullptr) node_id = other;
+  }
+  if (memory == nullptr) return nullptr;
+  nodes_[node_id].blocks_in_use_++;
+  return new (memory) RawBlock();
+}
+
+void BlockArenas::Delete(RawBlock *const block) {
+  Node &node = nodes_[NodeOf(block)];
+  block->~RawBlock();
+  node.blocks_in_use_--;
+  std::lock_guard<std::mutex> guard(node.latch_);
+  node.free_blocks_.push_back(reinterpret_cast<byte *>(block));
+}
+
+std::vector<uint64_t> BlockArenas::BlocksPerNode() const {
+  std::vector<uint64_t> result;
+  result.reserve(nodes_.size());
+  for (const auto &node : nodes_) result.push_back(node.blocks_in_use_.load());
+  return result;
+}
+
+uint32_t BlockArenas::CurrentNode() {
+#if defined(__linux__) && defined(SYS_getcpu)
+  uint32_t cpu, node;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) return node;
+#endif
+  return 0;
+}
+
+uint32_t BlockArenas::NumSystemNodes() {
+  // Holds the range of node ids the system may have, e.g. "0-3"
+  std::ifstream possible("/sys/devices/system/node/possible");
+  std::string nodes;
+  if (!(possible >> nodes)) return 1;
+  const auto last = nodes.find_last_of("-,");
+  try {
+    const auto max_node = std::stoul(last == std::string::npos ? nodes : nodes.substr(last + 1));
+    return static_cast<uint32_t>(std::min<uint64_t>(max_node + 1, MAX_NODES));
+  } catch (std::exception &e) {
+    return 1;
+  }
+}
+
+byte *BlockArenas::TakeFreeBlock(const uint32_t node_id, const bool map_arena) {
+  Node &node = nodes_[node_id];
+  std::lock_guard<std::mutex> guard(node.latch_);
+  if (node.free_blocks_.empty() && !(map_arena && MapArena(node_id, &node))) return nullptr;
+  byte *const memory = node.free_blocks_.back();
+  node.free_blocks_.pop_back();
+  return memory;
+}
+
+bool BlockArenas::MapArena(const uint32_t node_id, Node *const node) {
+  void *mapping;
+  uint64_t mapping_size;
+  auto *const start = static_cast<byte *>(MapMemory(&mapping, &mapping_size));
+  if (start == nullptr) return false;
+
+#if defined(__linux__) && defined(SYS_mbind)
+  // The arena has not been touched yet, so all of its pages are faulted in on the preferred node below
+  if (numa_aware_ && nodes_.size() > 1) {
+    uint64_t node_mask = 1UL << node_id;
+    if (syscall(SYS_mbind, start, arena_size_, NUMA_POLICY_PREFERRED, &node_mask, MAX_NODES + 1, 0) != 0)
+      STORAGE_LOG_DEBUG("Could not place block arena on NUMA node {}", node_id);
+  }
+#endif
+
+  // Fresh anonymous memory reads as zeros, so writing zeros only faults the pages in
+  for (uint64_t offset = 0; offset < arena_size_; offset += PREFAULT_STRIDE) {
+    reinterpret_cast<volatile byte *>(start)[offset] = byte{0};
+  }
+
+  {
+    common::SpinLatch::ScopedSpinLatch guard(&arenas_latch_);
+    arenas_.emplace(reinterpret_cast<uintptr_t>(start), Arena{mapping, mapping_size, node_id});
+  }
+  // Blocks are handed out from the back, so add them back to front to hand them out in address order
+  for (uint64_t offset = arena_size_; offset > 0; offset -= common::Constants::BLOCK_SIZE)
+    node->free_blocks_.push_back(start + offset - common::Constants::BLOCK_SIZE);
+  return true;
+}
+
+void *BlockArenas::MapMemory(void **const mapping, uint64_t *const mapping_size) {
+#if defined(__linux__) && defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+  // Huge page mappings are always aligned to the huge page size
+  const int page_size_log = page_size_ == common::Constants::GB ? 30 : 21;
+  void *const huge = mmap(nullptr, arena_size_, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (page_size_log << MAP_HUGE_SHIFT), -1, 0);
+  if (huge != MAP_FAILED) {
+    *mapping = huge;
+    *mapping_size = arena_size_;
+    return huge;
+  }
+#endif
+  if (!warned_no_huge_pages_.exchange(true))
+    STORAGE_LOG_WARN("No {} MB huge pages available for blocks, falling back to transparent huge pages",
+                     page_size_ / common::Constants::MB);
+
+  // Map an extra page so that the arena can start on a page boundary, which transparent huge pages need
+  *mapping_size = arena_size_ + page_size_;
+  *mapping = mmap(nullptr, *mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (*mapping == MAP_FAILED) return nullptr;
+  void *const start =
+      reinterpret_cast<void *>(common::MathUtil::AlignTo(reinterpret_cast<uintptr_t>(*mapping), page_size_));
+#if !defined(__APPLE__)
+  madvise(start, arena_size_, MADV_HUGEPAGE);
+#endif
+  return start;
+}
+
+uint32_t BlockArenas::NodeOf(RawBlock *const block) const {
+  common::SpinLatch::ScopedSpinLatch guard(&arenas_latch_);
+  auto arena = arenas_.upper_bound(reinterpret_cast<uintptr_t>(block));
+  TERRIER_ASSERT(arena != arenas_.begin(), "Block was not carved out of any arena");
+  return (--arena)->second.node_;
+}
+
+BlockAllocator::BlockAllocator() = default;
+
+BlockAllocator::BlockAllocator(const uint32_t huge_page_size, const bool numa_aware)
+    : arenas_(huge_page_size == 0 ? nullptr : std::make_unique<BlockArenas>(huge_page_size, numa_aware)) {}
+
+BlockAllocator::~BlockAllocator() = default;
+
+BlockAllocator::BlockAllocator(BlockAllocator &&other) noexcept = default;
+
+BlockAllocator &BlockAllocator::operator=(BlockAllocator &&other) noexcept = default;
+
+RawBlock *BlockAllocator::New() { return arenas_ == nullptr ? new RawBlock() : arenas_->New(); }
+
+void BlockAllocator::Delete(RawBlock *const ptr) {
+  if (arenas_ == nullptr)
+    delete ptr;
+  else
+    arenas_->Delete(ptr);
+}
+
+std::vector<uint64_t> BlockAllocator::BlocksPerNode() const {
+  return arenas_ == nullptr ? std::vector<uint64_t>() : arenas_->BlocksPerNode();
+}
+
+}  // namespace terrier::storage
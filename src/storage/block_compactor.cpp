@@ -6,6 +6,8 @@
 #include <utility>
 #include <vector>
 
+#include "common/thread_context.h"
+#include "metrics/metrics_store.h"
 #include "storage/sql_table.h"
 #include "transaction/deferred_action_manager.h"
 #include "transaction/transaction_util.h"
@@ -13,12 +15,34 @@
 namespace terrier::storage {
 void BlockCompactor::ProcessCompactionQueue(transaction::DeferredActionManager *deferred_action_manager,
                                             transaction::TransactionManager *txn_manager) {
-  std::queue<RawBlock *> to_process = std::move(compaction_queue_);
-  while (!to_process.empty()) {
+  const bool compaction_metrics_enabled =
+      common::thread_context.metrics_store_ != nullptr &&
+      common::thread_context.metrics_store_->ComponentToRecord(metrics::MetricsComponent::COMPACTION);
+  uint64_t blocks_frozen = 0, tuples_moved = 0, varlen_bytes_gathered = 0;
+
+  std::lock_guard<std::mutex> pass_guard(pass_latch_);
+  std::queue<RawBlock *> to_process;
+  {
+    common::SpinLatch::ScopedSpinLatch guard(&queue_latch_);
+    to_process.swap(compaction_queue_);
+  }
+  // Blocks that were not ready to freeze at the last pass are retried, unless a write has made them hot again, in
+  // which case the access observer hands them back to us once they are cold.
+  std::vector<RawBlock *> cooling_blocks;
+  cooling_blocks.swap(cooling_blocks_);
+  for (RawBlock *block : cooling_blocks)
+    if (block->controller_.GetBlockState()->load() == BlockState::COOLING) to_process.push(block);
+  for (; !to_process.empty(); to_process.pop()) {
     RawBlock *block = to_process.front();
+    // Tables with indexes, and tables being dropped, are left alone
+    if (!block->data_table_->IsCompactable()) continue;
     BlockAccessController &controller = block->controller_;
     switch (controller.GetBlockState()->load()) {
       case BlockState::HOT: {
+        // Keep inserts from reusing free slots in the block while we pick the gaps to fill, and until it is cooling,
+        // after which they leave it to us. If someone is already inserting into it, we will see the block again.
+        const TupleAccessStrategy &accessor = block->data_table_->accessor_;
+        if (!accessor.SetBlockBusyStatus(block)) break;
         // TODO(Tianyu): The policy about how to group blocks together into compaction group can be a lot
         // more sophisticated. Compacting more blocks together frees up more memory per compaction run,
         // but makes the compaction transaction larger, which can have performance impact on the rest
@@ -29,27 +53,39 @@ void BlockCompactor::ProcessCompactionQueue(transaction::DeferredActionManager *
         // frozen blocks. Although code can be reused for doing the compaction, some logic needs to be
         // written to enqueue these frozen blocks into the compaction queue.
         cg.blocks_to_compact_.emplace(block, std::vector<uint32_t>());
-        if (EliminateGaps(&cg)) {
+        // Check the table again, as it may have been given an index while we were moving its tuples
+        if (EliminateGaps(&cg) && cg.table_->IsCompactable()) {
           controller.GetBlockState()->store(BlockState::COOLING);
           // If no compaction was performed, we still need to shut out any potentially racey transactions that
           // are alive at the same time as us flipping the block status flag to cooling. However, we must manually
           // ask the GC to enqueue this block, because no access will be observed from the empty compaction transaction.
           if (cg.txn_->IsReadOnly())
-            deferred_action_manager->RegisterDeferredAction([this, block]() { PutInQueue(block); });
+            deferred_action_manager->RegisterDeferredAction([this, block]() {
+              // Deferred actions run in order, so the table is still there, but it may be on its way out
+              if (block->data_table_->IsCompactable()) PutInQueue(block);
+            });
           txn_manager->Commit(cg.txn_, transaction::TransactionUtil::EmptyCallback, nullptr);
+          tuples_moved += cg.tuples_moved_;
         } else {
           txn_manager->Abort(cg.txn_);
         }
+        accessor.ClearBlockBusyStatus(block);
         break;
       }
       case BlockState::COOLING: {
-        if (!CheckForVersionsAndGaps(block->data_table_->accessor_, block)) continue;
+        // If the block is not ready yet, it most likely still has versions that the GC has yet to prune. Nothing
+        // else may ever write to it, so check it again at the next pass rather than waiting to be handed it again.
+        if (!CheckForVersionsAndGaps(block->data_table_->accessor_, block)) {
+          cooling_blocks_.push_back(block);
+          break;
+        }
         // This is used to clean up any dangling pointers using a deferred action in GC.
         // We need this piece of memory to live on the heap, so its life time extends to
         // beyond this function call.
         auto *loose_ptrs = new std::vector<const byte *>;
-        GatherVarlens(loose_ptrs, block, block->data_table_);
+        varlen_bytes_gathered += GatherVarlens(loose_ptrs, block, block->data_table_);
         controller.GetBlockState()->store(BlockState::FROZEN);
+        blocks_frozen++;
         // When the old variable length values are no longer visible by running transactions, delete them.
         deferred_action_manager->RegisterDeferredAction([=]() {
           for (auto *loose_ptr : *loose_ptrs) delete[] loose_ptr;
@@ -64,8 +100,31 @@ void BlockCompactor::ProcessCompactionQueue(transaction::DeferredActionManager *
       default:
         throw std::runtime_error("unexpected control flow");
     }
-    to_process.pop();
   }
+
+  if ((blocks_frozen > 0 || tuples_moved > 0) && compaction_metrics_enabled) {
+    if (common::thread_context.resource_tracker_.IsRunning()) {
+      // Stop the resource tracker for this operating unit
+      common::thread_context.resource_tracker_.Stop();
+      auto &resource_metrics = common::thread_context.resource_tracker_.GetMetrics();
+      common::thread_context.metrics_store_->RecordCompactionData(blocks_frozen, tuples_moved, varlen_bytes_gathered,
+                                                                  compaction_interval_, resource_metrics);
+    }
+    common::thread_context.resource_tracker_.Start();
+  }
+}
+
+void BlockCompactor::DropUncompactableBlocks() {
+  std::lock_guard<std::mutex> pass_guard(pass_latch_);
+  const auto uncompactable = [](RawBlock *block) { return !block->data_table_->IsCompactable(); };
+  cooling_blocks_.erase(std::remove_if(cooling_blocks_.begin(), cooling_blocks_.end(), uncompactable),
+                        cooling_blocks_.end());
+
+  common::SpinLatch::ScopedSpinLatch guard(&queue_latch_);
+  std::queue<RawBlock *> compaction_queue;
+  for (; !compaction_queue_.empty(); compaction_queue_.pop())
+    if (!uncompactable(compaction_queue_.front())) compaction_queue.push(compaction_queue_.front());
+  compaction_queue_.swap(compaction_queue);
 }
 
 bool BlockCompactor::EliminateGaps(CompactionGroup *cg) {
@@ -130,6 +189,7 @@ bool BlockCompactor::EliminateGaps(CompactionGroup *cg) {
       if (taker == giver && filled_slot.GetOffset() < empty_slot.GetOffset()) break;
       // A failed move implies conflict
       if (!MoveTuple(cg, filled_slot, empty_slot)) return false;
+      cg->tuples_moved_++;
     }
   }
 
@@ -220,9 +280,9 @@ bool BlockCompactor::CheckForVersionsAndGaps(const TupleAccessStrategy &accessor
       return false;
     }
 
-    // Check that there are no versions alive
+    // Check that there are no versions alive, and no deleted tuples that have yet to be handed back to the table
     auto *record = version_ptrs[offset];
-    if (record != nullptr) {
+    if (record != nullptr || accessor.IsNull(TupleSlot(block, offset), VERSION_POINTER_COLUMN_ID)) {
       return false;
     }
   }
@@ -236,10 +296,11 @@ bool BlockCompactor::CheckForVersionsAndGaps(const TupleAccessStrategy &accessor
   return ret;
 }
 
-void BlockCompactor::GatherVarlens(std::vector<const byte *> *loose_ptrs, RawBlock *block, DataTable *table) {
+uint64_t BlockCompactor::GatherVarlens(std::vector<const byte *> *loose_ptrs, RawBlock *block, DataTable *table) {
   const TupleAccessStrategy &accessor = table->accessor_;
   const BlockLayout &layout = accessor.GetBlockLayout();
   ArrowBlockMetadata &metadata = accessor.GetArrowBlockMetadata(block);
+  uint64_t varlen_bytes_gathered = 0;
 
   for (col_id_t col_id : layout.AllColumns()) {
     common::RawConcurrentBitmap *column_bitmap = accessor.ColumnNullBitmap(block, col_id);
@@ -256,20 +317,21 @@ void BlockCompactor::GatherVarlens(std::vector<const byte *> *loose_ptrs, RawBlo
     auto *values = reinterpret_cast<VarlenEntry *>(accessor.ColumnStart(block, col_id));
     switch (col_info.Type()) {
       case ArrowColumnType::GATHERED_VARLEN:
-        CopyToArrowVarlen(loose_ptrs, &metadata, col_id, column_bitmap, &col_info, values);
+        varlen_bytes_gathered += CopyToArrowVarlen(loose_ptrs, &metadata, col_id, column_bitmap, &col_info, values);
         break;
       case ArrowColumnType::DICTIONARY_COMPRESSED:
-        BuildDictionary(loose_ptrs, &metadata, col_id, column_bitmap, &col_info, values);
+        varlen_bytes_gathered += BuildDictionary(loose_ptrs, &metadata, col_id, column_bitmap, &col_info, values);
         break;
       default:
         throw std::runtime_error("unexpected control flow");
     }
   }
+  return varlen_bytes_gathered;
 }
 
-void BlockCompactor::CopyToArrowVarlen(std::vector<const byte *> *loose_ptrs, ArrowBlockMetadata *metadata,
-                                       col_id_t col_id, common::RawConcurrentBitmap *column_bitmap,
-                                       ArrowColumnInfo *col, VarlenEntry *values) {
+uint32_t BlockCompactor::CopyToArrowVarlen(std::vector<const byte *> *loose_ptrs, ArrowBlockMetadata *metadata,
+                                           col_id_t col_id, common::RawConcurrentBitmap *column_bitmap,
+                                           ArrowColumnInfo *col, VarlenEntry *values) {
   uint32_t varlen_size = 0;
   // Read through every tuple and update null count and total varlen size
   metadata->NullCount(col_id) = 0;
@@ -306,11 +368,12 @@ void BlockCompactor::CopyToArrowVarlen(std::vector<const byte *> *loose_ptrs, Ar
   }
   new_col.Offsets()[metadata->NumRecords()] = new_col.ValuesLength();
   col->VarlenColumn() = std::move(new_col);
+  return varlen_size;
 }
 
-void BlockCompactor::BuildDictionary(std::vector<const byte *> *loose_ptrs, ArrowBlockMetadata *metadata,
-                                     col_id_t col_id, common::RawConcurrentBitmap *column_bitmap, ArrowColumnInfo *col,
-                                     VarlenEntry *values) {
+uint32_t BlockCompactor::BuildDictionary(std::vector<const byte *> *loose_ptrs, ArrowBlockMetadata *metadata,
+                                         col_id_t col_id, common::RawConcurrentBitmap *column_bitmap,
+                                         ArrowColumnInfo *col, VarlenEntry *values) {
   VarlenEntryMap<uint32_t> dictionary;
   // Read through every tuple and update null count and build the dictionary
   uint32_t varlen_size = 0;
@@ -364,6 +427,7 @@ void BlockCompactor::BuildDictionary(std::vector<const byte *> *loose_ptrs, Arro
       entry = VarlenEntry::Create(dictionary_word, entry.Size(), false);
   }
   *col = std::move(new_col_info);
+  return varlen_size;
 }
 
 }  // namespace terrier::storage
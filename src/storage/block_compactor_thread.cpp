@@ -0,0 +1,23 @@
+#include "storage/block_compactor_thread.h"
+#include "metrics/metrics_manager.h"
+
+namespace terrier::storage {
+BlockCompactorThread::BlockCompactorThread(
+    common::ManagedPointer<BlockCompactor> compactor,
+    common::ManagedPointer<transaction::DeferredActionManager> deferred_action_manager,
+    common::ManagedPointer<transaction::TransactionManager> txn_manager, std::chrono::microseconds compaction_period,
+    common::ManagedPointer<metrics::MetricsManager> metrics_manager)
+    : compactor_(compactor),
+      deferred_action_manager_(deferred_action_manager),
+      txn_manager_(txn_manager),
+      metrics_manager_(metrics_manager),
+      run_compaction_(true),
+      compaction_paused_(false),
+      compaction_period_(compaction_period),
+      compaction_thread_(std::thread([this] {
+        if (metrics_manager_ != DISABLED) metrics_manager_->RegisterThread();
+        compactor_->SetCompactionInterval(compaction_period_.count());
+        CompactionThreadLoop();
+      })) {}
+
+}  // namespace terrier::storage
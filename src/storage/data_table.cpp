@@ -1,6 +1,10 @@
 #include "storage/data_table.h"
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <list>
+#include <thread>  // NOLINT
 
 #include "common/allocator.h"
 #include "execution/sql/vector_projection.h"
@@ -21,17 +25,17 @@ DataTable::DataTable(const common::ManagedPointer<BlockStore> store, const Block
   if (block_store_ != nullptr) {
     RawBlock *new_block = NewBlock();
     // insert block
-    blocks_.push_back(new_block);
+    blocks_.PushBack(new_block);
   }
   insertion_head_ = 0;
 }
 
 DataTable::~DataTable() {
-  common::SpinLatch::ScopedSpinLatch guard(&blocks_latch_);
-  for (RawBlock *block : blocks_) {
+  for (uint32_t i = 0; i < blocks_.Size(); i++) {
+    RawBlock *block = blocks_[i];
     StorageUtil::DeallocateVarlens(block, accessor_);
-    for (col_id_t i : accessor_.GetBlockLayout().Varlens())
-      accessor_.GetArrowBlockMetadata(block).GetColumnInfo(accessor_.GetBlockLayout(), i).Deallocate();
+    for (col_id_t col_id : accessor_.GetBlockLayout().Varlens())
+      accessor_.GetArrowBlockMetadata(block).GetColumnInfo(accessor_.GetBlockLayout(), col_id).Deallocate();
     block_store_->Release(block);
   }
 }
@@ -62,19 +66,136 @@ void DataTable::Scan(const common::ManagedPointer<transaction::TransactionContex
 
 void DataTable::Scan(const common::ManagedPointer<transaction::TransactionContext> txn, SlotIterator *const start_pos,
                      execution::sql::VectorProjection *const out_buffer) const {
+  out_buffer->PrepareForScan();
+  execution::sql::TupleIdList *const selections = &out_buffer->owned_tid_list_;
   uint32_t filled = 0;
   while (filled < out_buffer->GetTupleCapacity() && *start_pos != end() &&
          **start_pos != SlotIterator::InvalidTupleSlot()) {
+    // Copy whole ranges of the block at a time when no slot in it needs a version chain traversal
+    const uint32_t num_copied = ScanRangeInPlace(start_pos, out_buffer, filled);
+    if (num_copied > 0) {
+      filled += num_copied;
+      continue;
+    }
+
     execution::sql::VectorProjection::RowView row = out_buffer->InterpretAsRow(filled);
     const TupleSlot slot = **start_pos;
     // Only fill the buffer with valid, visible tuples
     if (SelectIntoBuffer(txn, slot, &row)) {
       row.SetTupleSlot(slot);
+      selections->Add(filled);
       filled++;
     }
     ++(*start_pos);
   }
-  out_buffer->Reset(filled);
+  out_buffer->FinishScan(filled);
+}
+
+uint32_t DataTable::ScanRangeInPlace(SlotIterator *const start_pos, execution::sql::VectorProjection *const out_buffer,
+                                     const uint32_t filled) const {
+  const TupleSlot start_slot = **start_pos;
+  RawBlock *const block = start_slot.GetBlock();
+  const uint64_t synopsis = block->version_synopsis_.load();
+  if (!RawBlock::NoVersionChains(synopsis)) return 0;
+
+  // Stop at the end of the table if it is in this block, and never read past the insertion head, since nothing
+  // beyond it can be allocated.
+  const BlockLayout &layout = accessor_.GetBlockLayout();
+  const SlotIterator end_pos = end();
+  uint32_t range_end = std::min(layout.NumSlots(), block->GetInsertHead());
+  if (end_pos.current_slot_.GetBlock() == block) range_end = std::min(range_end, end_pos.current_slot_.GetOffset());
+  const uint32_t start_offset = start_slot.GetOffset();
+  if (range_end <= start_offset) return 0;
+  const auto num_slots =
+      static_cast<uint32_t>(std::min<uint64_t>(range_end - start_offset, out_buffer->GetTupleCapacity() - filled));
+
+  for (uint16_t i = 0; i < out_buffer->GetColumnCount(); i++) {
+    const col_id_t col_id = out_buffer->ColumnIds()[i];
+    TERRIER_ASSERT(col_id != VERSION_POINTER_COLUMN_ID, "Output buffer should not read the version pointer column.");
+    const uint8_t attr_size = layout.AttrSize(col_id);
+    execution::sql::Vector *const column = out_buffer->GetColumn(i);
+    TERRIER_ASSERT(execution::sql::GetTypeIdSize(column->GetTypeId()) == attr_size,
+                   "Vector element size should match the attribute size in storage.");
+    std::memcpy(column->GetData() + static_cast<uint64_t>(filled) * attr_size,
+                accessor_.ColumnStart(block, col_id) + static_cast<uint64_t>(start_offset) * attr_size,
+                static_cast<uint64_t>(num_slots) * attr_size);
+    // Storage bitmaps mark present values, while vector null masks mark null ones.
+    common::RawConcurrentBitmap *const null_bitmap = accessor_.ColumnNullBitmap(block, col_id);
+    execution::sql::Vector::NullMask *const null_mask = column->GetMutableNullMask();
+    for (uint32_t j = 0; j < num_slots; j++) null_mask->Set(filled + j, !null_bitmap->Test(start_offset + j));
+  }
+
+  // The allocation and logical delete bitmaps decide which of the copied slots are visible. This must be read before
+  // validating the synopsis again, as concurrent writers could otherwise change visibility after our check.
+  common::RawConcurrentBitmap *const allocation_bitmap = accessor_.AllocationBitmap(block);
+  common::RawConcurrentBitmap *const delete_bitmap = accessor_.ColumnNullBitmap(block, VERSION_POINTER_COLUMN_ID);
+  execution::sql::TupleIdList *const selections = &out_buffer->owned_tid_list_;
+  for (uint32_t j = 0; j < num_slots; j++) {
+    const uint32_t offset = start_offset + j;
+    selections->Enable(filled + j, allocation_bitmap->Test(offset) && delete_bitmap->Test(offset));
+    out_buffer->SetTupleSlot(TupleSlot(block, offset), filled + j);
+  }
+
+  // If any slot gained a version chain while we were reading, what we read may be a version that is not visible to
+  // us. Leave the range to the transactional path instead, which will overwrite what we copied. The fence keeps the
+  // plain reads above from being reordered past the second read of the synopsis.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (block->version_synopsis_.load(std::memory_order_relaxed) != synopsis) {
+    for (uint32_t j = 0; j < num_slots; j++) selections->Remove(filled + j);
+    return 0;
+  }
+
+  // Advance the iterator past the copied range, moving on to the next block if we reached the end of this one
+  if (start_offset + num_slots == layout.NumSlots()) {
+    start_pos->current_slot_ = {block, layout.NumSlots() - 1};
+    ++(*start_pos);
+  } else {
+    start_pos->current_slot_ = {block, start_offset + num_slots};
+  }
+  return num_slots;
+}
+
+RawBlock *DataTable::ScanFrozenInPlace(SlotIterator *const start_pos,
+                                       execution::sql::VectorProjection *const out_buffer) const {
+  const TupleSlot start_slot = **start_pos;
+  RawBlock *const block = start_slot.GetBlock();
+  if (block == nullptr || !block->controller_.TryAcquireInPlaceRead(out_buffer)) return nullptr;
+
+  // Frozen blocks are compacted, so all of their tuples are in the first NumRecords slots.
+  const BlockLayout &layout = accessor_.GetBlockLayout();
+  ArrowBlockMetadata &metadata = accessor_.GetArrowBlockMetadata(block);
+  const SlotIterator end_pos = end();
+  uint32_t range_end = metadata.NumRecords();
+  if (end_pos.current_slot_.GetBlock() == block) range_end = std::min(range_end, end_pos.current_slot_.GetOffset());
+  const uint32_t start_offset = start_slot.GetOffset();
+  const auto num_slots = static_cast<uint32_t>(
+      range_end > start_offset ? std::min<uint64_t>(range_end - start_offset, out_buffer->GetTupleCapacity()) : 0);
+
+  out_buffer->Reset(num_slots);
+  for (uint16_t i = 0; i < out_buffer->GetColumnCount(); i++) {
+    const col_id_t col_id = out_buffer->ColumnIds()[i];
+    const uint8_t attr_size = layout.AttrSize(col_id);
+    execution::sql::Vector *const column = out_buffer->GetColumn(i);
+    TERRIER_ASSERT(execution::sql::GetTypeIdSize(column->GetTypeId()) == attr_size,
+                   "Vector element size should match the attribute size in storage.");
+    column->Reference(accessor_.ColumnStart(block, col_id) + static_cast<uint64_t>(start_offset) * attr_size, nullptr,
+                      num_slots);
+    // The compactor counted nulls for every column, so most columns do not need their null mask filled in.
+    if (metadata.NullCount(col_id) == 0) continue;
+    common::RawConcurrentBitmap *const null_bitmap = accessor_.ColumnNullBitmap(block, col_id);
+    execution::sql::Vector::NullMask *const null_mask = column->GetMutableNullMask();
+    for (uint32_t j = 0; j < num_slots; j++) null_mask->Set(j, !null_bitmap->Test(start_offset + j));
+  }
+  for (uint32_t j = 0; j < num_slots; j++) out_buffer->SetTupleSlot(TupleSlot(block, start_offset + j), j);
+
+  // Move on to the next block once we have read every record in this one
+  if (start_offset + num_slots >= metadata.NumRecords()) {
+    start_pos->current_slot_ = {block, layout.NumSlots() - 1};
+    ++(*start_pos);
+  } else {
+    start_pos->current_slot_ = {block, start_offset + num_slots};
+  }
+  return block;
 }
 
 DataTable::SlotIterator &DataTable::SlotIterator::operator++() {
@@ -85,14 +206,10 @@ DataTable::SlotIterator &DataTable::SlotIterator::operator++() {
       ++block_index_;
       num_advances_ = num_advances_ == SlotIterator::ADVANCE_TO_THE_END ? num_advances_ : num_advances_ - 1;
       // Cannot dereference if the next block is end(), so just use nullptr to denote
-      {
-        // TODO(WAN): Lin, does this latch still need to be temporarily commented out for TPCH?
-        common::SpinLatch::ScopedSpinLatch guard(&table_->blocks_latch_);
-        if (block_index_ >= table_->blocks_.size()) {
-          current_slot_ = DataTable::SlotIterator::InvalidTupleSlot();
-        } else {
-          current_slot_ = {table_->blocks_[block_index_], 0};
-        }
+      if (block_index_ >= table_->blocks_.Size()) {
+        current_slot_ = DataTable::SlotIterator::InvalidTupleSlot();
+      } else {
+        current_slot_ = {table_->blocks_[block_index_], 0};
       }
     } else {
       // Done advancing, time to give up.
@@ -105,16 +222,13 @@ DataTable::SlotIterator &DataTable::SlotIterator::operator++() {
 }
 
 DataTable::SlotIterator DataTable::end() const {  // NOLINT for STL name compability
-  // TODO(Lin): We need to temporarily comment out this latch for the concurrent TPCH experiments. Should be replaced
-  //  with a real solution
-  common::SpinLatch::ScopedSpinLatch guard(&blocks_latch_);
   // TODO(Tianyu): Need to look in detail at how this interacts with compaction when that gets in.
 
   // The end iterator could either point to an unfilled slot in a block, or point to nothing if every block in the
   // table is full. In the case that it points to nothing, we will use the end of the blocks list and
   // 0 to denote that this is the case. This solution makes increment logic simple and natural.
-  uint32_t num_blocks = blocks_.size();
-  if (blocks_.empty()) return {this, num_blocks, SlotIterator::ADVANCE_TO_THE_END, 0};
+  uint32_t num_blocks = blocks_.Size();
+  if (num_blocks == 0) return {this, num_blocks, SlotIterator::ADVANCE_TO_THE_END, 0};
   uint32_t last_block_index = num_blocks - 1;
   uint32_t insert_head = blocks_[last_block_index]->GetInsertHead();
   // Last block is full, return the default end iterator that doesn't point to anything
@@ -128,8 +242,7 @@ DataTable::SlotIterator DataTable::GetBlockedSlotIterator(uint32_t start, uint32
   TERRIER_ASSERT(start <= end, "Start index should come before ending index.");
   TERRIER_ASSERT(static_cast<int32_t>(end - start - 1) >= 0, "Too many blocks or sign issue.");
 
-  common::SpinLatch::ScopedSpinLatch guard(&blocks_latch_);
-  TERRIER_ASSERT(start <= blocks_.size() && end <= blocks_.size(), "Indexes must be within bounds.");
+  TERRIER_ASSERT(start <= blocks_.Size() && end <= blocks_.Size(), "Indexes must be within bounds.");
   return {this, start, static_cast<int32_t>(end - start - 1), 0};
 }
 
@@ -139,6 +252,7 @@ bool DataTable::Update(const common::ManagedPointer<transaction::TransactionCont
                  "The input buffer cannot change the reserved columns, so it should have fewer attributes.");
   TERRIER_ASSERT(redo.NumColumns() > 0, "The input buffer should modify at least one attribute.");
   UndoRecord *const undo = txn->UndoRecordForUpdate(this, slot, redo);
+  MaterializeOwnInPlaceReads(slot.GetBlock());
   slot.GetBlock()->controller_.WaitUntilHot();
   UndoRecord *version_ptr;
   do {
@@ -157,9 +271,11 @@ bool DataTable::Update(const common::ManagedPointer<transaction::TransactionCont
     for (uint16_t i = 0; i < undo->Delta()->NumColumns(); i++)
       StorageUtil::CopyAttrIntoProjection(accessor_, slot, undo->Delta(), i);
 
-    // Update the next pointer of the new head of the version chain
-    undo->Next() = version_ptr;
+    // Update the next pointer of the new head of the version chain. If nobody can see the versions before the current
+    // head anymore, the chain is dropped in the same step.
+    undo->Next() = version_ptr != nullptr && Prunable(*txn, version_ptr) ? nullptr : version_ptr;
   } while (!CompareAndSwapVersionPtr(slot, accessor_, version_ptr, undo));
+  if (version_ptr == nullptr) slot.GetBlock()->InstallVersionChain();
 
   // Update in place with the new value.
   for (uint16_t i = 0; i < redo.NumColumns(); i++) {
@@ -175,19 +291,10 @@ bool DataTable::Update(const common::ManagedPointer<transaction::TransactionCont
 }
 
 void DataTable::CheckMoveHead(uint32_t block_index) {
-  // Assume block is full.
-  if (block_index == insertion_head_.load()) {
-    // If the header block is full, move the header to point to the next block.
-    insertion_head_++;
-  }
-
-  // If there are no more free blocks, create a new empty block and point the insertion_head to it.
-  if (insertion_head_.load() == blocks_.size()) {
-    RawBlock *new_block = NewBlock();
-    // Take the latch and insert the block. The insertion head will already have the right index.
-    common::SpinLatch::ScopedSpinLatch guard_block(&blocks_latch_);
-    blocks_.push_back(new_block);
-  }
+  // Assume block is full. If it is the header block, move the header to point to the next block. If that is past the
+  // end of the block list, the next insert will allocate a new block.
+  uint32_t expected = block_index;
+  insertion_head_.compare_exchange_strong(expected, block_index + 1);
 }
 
 TupleSlot DataTable::Insert(const common::ManagedPointer<transaction::TransactionContext> txn,
@@ -196,60 +303,115 @@ TupleSlot DataTable::Insert(const common::ManagedPointer<transaction::Transactio
                  "The input buffer never changes the version pointer column, so it should have  exactly 1 fewer "
                  "attribute than the DataTable's layout.");
 
+  TupleSlot result;
+  // Reuse the slot of a deleted tuple if there is one, so that tables with a lot of churn do not keep growing
+  if (InsertIntoFreeSlot(txn, redo, &result)) return result;
+
+  AllocateSlots(1, &result);
+  InsertInto(txn, redo, result);
+  return result;
+}
+
+void DataTable::InsertBatch(const common::ManagedPointer<transaction::TransactionContext> txn,
+                            const ProjectedRow *const *const redos, const uint32_t num_tuples,
+                            TupleSlot *const results) {
+  uint32_t inserted = 0;
+  // Like Insert, reuse the slots of deleted tuples first, one at a time as they are scattered over the table
+  while (inserted < num_tuples && InsertIntoFreeSlot(txn, *redos[inserted], &results[inserted])) inserted++;
+
+  while (inserted < num_tuples) {
+    const uint32_t allocated = AllocateSlots(num_tuples - inserted, results + inserted);
+    for (uint32_t i = inserted; i < inserted + allocated; i++) {
+      TERRIER_ASSERT(redos[i]->NumColumns() == accessor_.GetBlockLayout().NumColumns() - NUM_RESERVED_COLUMNS,
+                     "The input buffer never changes the version pointer column, so it should have  exactly 1 fewer "
+                     "attribute than the DataTable's layout.");
+      InsertInto(txn, *redos[i], results[i]);
+    }
+    inserted += allocated;
+  }
+}
+
+uint32_t DataTable::AllocateSlots(const uint32_t max_slots, TupleSlot *const slots) {
   // Insertion header points to the first block that has free tuple slots
-  // Once a txn arrives, it will start from the insertion header to find the first
-  // idle (no other txn is trying to get tuple slots in that block) and non-full block.
+  // Once a txn arrives, it will look through the blocks from the insertion header to the end of the table to find the
+  // first idle (no other txn is trying to get tuple slots in that block) and non-full block. Rather than all starting
+  // at the insertion header, each thread starts at one of the first few blocks from there (the insertion heads) and
+  // wraps around, so that concurrent inserters spread out over the partially filled blocks instead of all contending
+  // on the first one.
   // If no such block is found, the txn will create a new block.
   // Before the txn writes to the block, it will set block status to busy.
   // The first bit of block insert_head_ is used to indicate if the block is busy
   // If the first bit is 1, it indicates one txn is writing to the block.
+  static thread_local const uint32_t insertion_head_hint =
+      static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
 
-  TupleSlot result;
-  auto block_index = insertion_head_.load();
-  RawBlock *block;
-
-  while (true) {
-    // No free block left
-    if (block_index == blocks_.size()) {
-      RawBlock *new_block = NewBlock();
-      TERRIER_ASSERT(accessor_.SetBlockBusyStatus(new_block), "Status of new block should not be busy");
-      // No need to flip the busy status bit
-      accessor_.Allocate(new_block, &result);
-      // take latch
-      common::SpinLatch::ScopedSpinLatch guard(&blocks_latch_);
-      // insert block
-      blocks_.push_back(new_block);
-      block = new_block;
-      break;
-    }
-
-    {
-      common::SpinLatch::ScopedSpinLatch guard(&blocks_latch_);
-      block = blocks_[block_index];
-    }
+  const uint32_t head = insertion_head_.load();
+  const uint32_t num_blocks = blocks_.Size();
+  const uint32_t num_candidates = num_blocks > head ? num_blocks - head : 0;
+  const uint32_t start = num_candidates > 1 ? insertion_head_hint % std::min(num_candidates, NUM_INSERTION_HEADS) : 0;
 
+  for (uint32_t i = 0; i < num_candidates; i++) {
+    const uint32_t block_index = head + (start + i) % num_candidates;
+    RawBlock *block = blocks_[block_index];
     if (accessor_.SetBlockBusyStatus(block)) {
       // No one is inserting into this block
-      if (accessor_.Allocate(block, &result)) {
-        // The block is not full, succeed
-        break;
-      }
-      // Fail to insert into the block, flip back the status bit
+      const uint32_t allocated = accessor_.AllocateRange(block, max_slots, slots);
+      // Do not need to wait until finish inserting, can flip back the status bit once the thread gets the allocated
+      // tuple slots
       accessor_.ClearBlockBusyStatus(block);
+      // The block is not full, succeed
+      if (allocated > 0) return allocated;
       // if the full block is the insertion_header, move the insertion_header
       // Next insert txn will search from the new insertion_header
       CheckMoveHead(block_index);
     }
     // The block is full or the block is being inserted by other txn, try next block
-    ++block_index;
   }
 
-  // Do not need to wait unit finish inserting,
-  // can flip back the status bit once the thread gets the allocated tuple slot
-  accessor_.ClearBlockBusyStatus(block);
-  InsertInto(txn, redo, result);
+  // No free block left
+  RawBlock *new_block = NewBlock();
+  TERRIER_ASSERT(accessor_.SetBlockBusyStatus(new_block), "Status of new block should not be busy");
+  // No need to flip the busy status bit
+  const uint32_t allocated = accessor_.AllocateRange(new_block, max_slots, slots);
+  // insert block
+  blocks_.PushBack(new_block);
+  accessor_.ClearBlockBusyStatus(new_block);
+  return allocated;
+}
 
-  return result;
+bool DataTable::InsertIntoFreeSlot(const common::ManagedPointer<transaction::TransactionContext> txn,
+                                   const ProjectedRow &redo, TupleSlot *const dest) {
+  TupleSlot slot;
+  for (uint32_t probes = 0; probes < MAX_FREE_SLOT_PROBES && free_slots_.Dequeue(&slot); probes++) {
+    // A slot can be on the queue more than once, for example if the compactor filled it and its new tuple was deleted
+    // again. Entries are only queued once the slot is free for good, so if it is allocated now, another entry or the
+    // compactor has taken it since, and this one can be dropped.
+    if (accessor_.Allocated(slot)) continue;
+    RawBlock *const block = slot.GetBlock();
+    if (!accessor_.SetBlockBusyStatus(block)) {
+      // Someone else is inserting into or compacting this block. Rather than wait, leave the slot for a later insert.
+      free_slots_.Enqueue(slot);
+      return false;
+    }
+    if (block->controller_.GetBlockState()->load() != BlockState::HOT) {
+      // The block is being compacted or is frozen. The compactor may still fill the slot, in which case we drop it
+      // above, and otherwise it is reused once a write makes the block hot again.
+      accessor_.ClearBlockBusyStatus(block);
+      free_slots_.Enqueue(slot);
+      continue;
+    }
+    // The CAS on the allocation bit decides between us and any other entry for the same slot
+    if (accessor_.AllocateSlot(slot)) {
+      MaterializeOwnInPlaceReads(block);
+      // Keep the block busy until the version pointer is installed, so that the compactor cannot start on it before.
+      InsertInto(txn, redo, slot);
+      accessor_.ClearBlockBusyStatus(block);
+      *dest = slot;
+      return true;
+    }
+    accessor_.ClearBlockBusyStatus(block);
+  }
+  return false;
 }
 
 void DataTable::InsertInto(const common::ManagedPointer<transaction::TransactionContext> txn, const ProjectedRow &redo,
@@ -262,7 +424,8 @@ void DataTable::InsertInto(const common::ManagedPointer<transaction::Transaction
   UndoRecord *undo = txn->UndoRecordForInsert(this, dest);
   TERRIER_ASSERT(dest.GetBlock()->controller_.GetBlockState()->load() == BlockState::HOT,
                  "Should only be able to insert into hot blocks");
-  AtomicallyWriteVersionPtr(dest, accessor_, undo);
+  // A reused slot can still hold a version chain the GC has not truncated yet, which the synopsis already counts
+  if (AtomicallyWriteVersionPtr(dest, accessor_, undo) == nullptr) dest.GetBlock()->InstallVersionChain();
   // Set the logically deleted bit to present as the undo record is ready
   accessor_.AccessForceNotNull(dest, VERSION_POINTER_COLUMN_ID);
   // Update in place with the new value.
@@ -275,6 +438,7 @@ void DataTable::InsertInto(const common::ManagedPointer<transaction::Transaction
 
 bool DataTable::Delete(const common::ManagedPointer<transaction::TransactionContext> txn, const TupleSlot slot) {
   UndoRecord *const undo = txn->UndoRecordForDelete(this, slot);
+  MaterializeOwnInPlaceReads(slot.GetBlock());
   slot.GetBlock()->controller_.WaitUntilHot();
   UndoRecord *version_ptr;
   do {
@@ -288,9 +452,11 @@ bool DataTable::Delete(const common::ManagedPointer<transaction::TransactionCont
       return false;
     }
 
-    // Update the next pointer of the new head of the version chain
-    undo->Next() = version_ptr;
+    // Update the next pointer of the new head of the version chain. If nobody can see the versions before the current
+    // head anymore, the chain is dropped in the same step.
+    undo->Next() = version_ptr != nullptr && Prunable(*txn, version_ptr) ? nullptr : version_ptr;
   } while (!CompareAndSwapVersionPtr(slot, accessor_, version_ptr, undo));
+  if (version_ptr == nullptr) slot.GetBlock()->InstallVersionChain();
 
   // We have the write lock. Go ahead and flip the logically deleted bit to true
   accessor_.SetNull(slot, VERSION_POINTER_COLUMN_ID);
@@ -357,6 +523,7 @@ bool DataTable::SelectIntoBuffer(const common::ManagedPointer<transaction::Trans
   }
 
   // Apply deltas until we reconstruct a version safe for us to read
+  UndoRecord *newer = nullptr;
   while (version_ptr != nullptr &&
          transaction::TransactionUtil::NewerThan(version_ptr->Timestamp().load(), txn->StartTime())) {
     switch (version_ptr->Type()) {
@@ -373,9 +540,14 @@ bool DataTable::SelectIntoBuffer(const common::ManagedPointer<transaction::Trans
       default:
         throw std::runtime_error("unexpected delta record type");
     }
+    newer = version_ptr;
     version_ptr = version_ptr->Next();
   }
 
+  // The rest of the chain is older than our snapshot. If it is older than every running transaction as well, nobody
+  // will walk it again, so unlink it here rather than have later readers and the GC skip over it.
+  if (version_ptr != nullptr) PruneVersionChain(*txn, slot, newer, version_ptr);
+
   return visible;
 }
 
@@ -392,11 +564,11 @@ UndoRecord *DataTable::AtomicallyReadVersionPtr(const TupleSlot slot, const Tupl
   return reinterpret_cast<std::atomic<UndoRecord *> *>(ptr_location)->load();
 }
 
-void DataTable::AtomicallyWriteVersionPtr(const TupleSlot slot, const TupleAccessStrategy &accessor,
-                                          UndoRecord *const desired) {
+UndoRecord *DataTable::AtomicallyWriteVersionPtr(const TupleSlot slot, const TupleAccessStrategy &accessor,
+                                                 UndoRecord *const desired) {
   // Okay to ignore presence bit, because we use that for logical delete, not for validity of the version pointer value
   byte *ptr_location = accessor.AccessWithoutNullCheck(slot, VERSION_POINTER_COLUMN_ID);
-  reinterpret_cast<std::atomic<UndoRecord *> *>(ptr_location)->store(desired);
+  return reinterpret_cast<std::atomic<UndoRecord *> *>(ptr_location)->exchange(desired);
 }
 
 bool DataTable::Visible(const TupleSlot slot, const TupleAccessStrategy &accessor) const {
@@ -418,12 +590,33 @@ bool DataTable::HasConflict(const transaction::TransactionContext &txn, UndoReco
 }
 
 bool DataTable::CompareAndSwapVersionPtr(const TupleSlot slot, const TupleAccessStrategy &accessor,
-                                         UndoRecord *expected, UndoRecord *const desired) {
+                                         UndoRecord *expected, UndoRecord *const desired) const {
   // Okay to ignore presence bit, because we use that for logical delete, not for validity of the version pointer value
   byte *ptr_location = accessor.AccessWithoutNullCheck(slot, VERSION_POINTER_COLUMN_ID);
   return reinterpret_cast<std::atomic<UndoRecord *> *>(ptr_location)->compare_exchange_strong(expected, desired);
 }
 
+bool DataTable::Prunable(const transaction::TransactionContext &txn, const UndoRecord *const undo) {
+  // Uncommitted timestamps are newer than any start time, so records of running transactions are never pruned
+  return transaction::TransactionUtil::NewerThan(txn.OldestTransactionStartTime(), undo->Timestamp().load());
+}
+
+void DataTable::PruneVersionChain(const transaction::TransactionContext &txn, const TupleSlot slot,
+                                  UndoRecord *const newer, UndoRecord *const undo) const {
+  if (!Prunable(txn, undo)) return;
+  if (newer != nullptr) {
+    newer->Next().store(nullptr);
+    return;
+  }
+  // The record is the head, so the whole version chain goes. A concurrent writer may have installed a new head since we
+  // read it, in which case we leave the chain to the GC.
+  if (CompareAndSwapVersionPtr(slot, accessor_, undo, nullptr)) slot.GetBlock()->TruncateVersionChain();
+}
+
+void DataTable::MaterializeOwnInPlaceReads(RawBlock *const block) {
+  block->controller_.ForEachOwnInPlaceReader([](execution::sql::VectorProjection *reader) { reader->Materialize(); });
+}
+
 RawBlock *DataTable::NewBlock() {
   RawBlock *new_block = block_store_->Get();
   accessor_.InitializeRawBlock(this, new_block, layout_version_);
@@ -1,7 +1,9 @@
 #include "storage/garbage_collector.h"
 
+#include <algorithm>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "common/macros.h"
 #include "common/thread_context.h"
@@ -10,6 +12,7 @@
 #include "storage/access_observer.h"
 #include "storage/data_table.h"
 #include "storage/index/index.h"
+#include "storage/sql_table.h"
 #include "transaction/deferred_action_manager.h"
 #include "transaction/transaction_context.h"
 #include "transaction/transaction_defs.h"
@@ -31,6 +34,15 @@ GarbageCollector::GarbageCollector(
                  "The TransactionManager needs to be instantiated with gc_enabled true for GC to work!");
 }
 
+void GarbageCollector::SetNumWorkers(const uint32_t num_workers) {
+  TERRIER_ASSERT(num_workers > 0, "There must be at least one GC worker");
+  if (num_workers == num_workers_) return;
+  if (num_workers_ > 1) unlink_pool_.Shutdown();
+  num_workers_ = num_workers;
+  unlink_pool_.SetNumWorkers(num_workers);
+  if (num_workers_ > 1) unlink_pool_.Startup();
+}
+
 std::pair<uint32_t, uint32_t> GarbageCollector::PerformGarbageCollection() {
   const bool gc_metrics_enabled =
       common::thread_context.metrics_store_ != nullptr &&
@@ -42,7 +54,7 @@ std::pair<uint32_t, uint32_t> GarbageCollector::PerformGarbageCollection() {
   uint32_t txns_deallocated = ProcessDeallocateQueue(oldest_txn);
   STORAGE_LOG_TRACE("GarbageCollector::PerformGarbageCollection(): txns_deallocated: {}", txns_deallocated);
   uint32_t txns_unlinked, buffer_unlinked, readonly_unlinked;
-  std::tie(txns_unlinked, buffer_unlinked, readonly_unlinked) = ProcessUnlinkQueue(oldest_txn);
+  std::tie(txns_unlinked, buffer_unlinked, readonly_unlinked) = ProcessUnlinkQueue(oldest_txn, gc_metrics_enabled);
   STORAGE_LOG_TRACE("GarbageCollector::PerformGarbageCollection(): txns_unlinked: {}", txns_unlinked);
   if (txns_unlinked > 0) {
     // Only update this field if we actually unlinked anything, otherwise we're being too conservative about when it's
@@ -62,6 +74,15 @@ std::pair<uint32_t, uint32_t> GarbageCollector::PerformGarbageCollection() {
       common::thread_context.metrics_store_->RecordGCData(txns_deallocated, txns_unlinked, buffer_unlinked,
                                                           readonly_unlinked, gc_interval_, resource_metrics);
     }
+    // Work done on the invoking thread is already covered above
+    if (unlink_work_.size() > 1) {
+      for (uint32_t worker = 0; worker < unlink_work_.size(); worker++) {
+        const UnlinkWork &work = unlink_work_[worker];
+        common::thread_context.metrics_store_->RecordGCWorkerData(
+            worker, static_cast<uint32_t>(unlink_work_.size()), work.txns_processed_, work.buffer_processed_,
+            work.slots_truncated_, gc_interval_, work.resource_metrics_);
+      }
+    }
     common::thread_context.resource_tracker_.Start();
   }
 
@@ -85,7 +106,8 @@ uint32_t GarbageCollector::ProcessDeallocateQueue(transaction::timestamp_t oldes
   return txns_processed;
 }
 
-std::tuple<uint32_t, uint32_t, uint32_t> GarbageCollector::ProcessUnlinkQueue(transaction::timestamp_t oldest_txn) {
+std::tuple<uint32_t, uint32_t, uint32_t> GarbageCollector::ProcessUnlinkQueue(transaction::timestamp_t oldest_txn,
+                                                                              const bool track_resources) {
   transaction::TransactionContext *txn = nullptr;
 
   // Get the completed transactions from the TransactionManager
@@ -98,10 +120,8 @@ std::tuple<uint32_t, uint32_t, uint32_t> GarbageCollector::ProcessUnlinkQueue(tr
   uint32_t txns_processed = 0, buffer_processed = 0, readonly_processed = 0;
   // Certain transactions might not be yet safe to gc. Need to requeue them
   transaction::TransactionQueue requeue;
-  // It is sufficient to truncate each version chain once in a GC invocation because we only read the maximal safe
-  // timestamp once, and the version chain is sorted by timestamp. Here we keep a set of slots to truncate to avoid
-  // wasteful traversals of the version chain.
-  std::unordered_set<TupleSlot> visited_slots;
+  // Transactions that are safe to unlink on this invocation
+  std::vector<transaction::TransactionContext *> safe_txns;
 
   // Process every transaction in the unlink queue
   while (!txns_to_unlink_.empty()) {
@@ -115,24 +135,7 @@ std::tuple<uint32_t, uint32_t, uint32_t> GarbageCollector::ProcessUnlinkQueue(tr
       readonly_processed++;
     } else if (transaction::TransactionUtil::NewerThan(oldest_txn, txn->FinishTime())) {
       // Safe to garbage collect.
-      for (auto &undo_record : txn->undo_buffer_) {
-        // It is possible for the table field to be null, for aborted transaction's last conflicting record
-        DataTable *&table = undo_record.Table();
-        // Each version chain needs to be traversed and truncated at most once every GC period. Check
-        // if we have already visited this tuple slot; if not, proceed to prune the version chain.
-        if (table != nullptr && visited_slots.insert(undo_record.Slot()).second)
-          TruncateVersionChain(table, undo_record.Slot(), oldest_txn);
-        // Regardless of the version chain we will need to reclaim deleted slots and any dangling pointers to varlens,
-        // unless the transaction is aborted, and the record holds a version that is still visible.
-        if (!txn->Aborted()) {
-          ReclaimSlotIfDeleted(&undo_record);
-          ReclaimBufferIfVarlen(txn, &undo_record);
-        }
-        if (observer_ != nullptr) observer_->ObserveWrite(undo_record.Slot().GetBlock());
-        buffer_processed++;
-      }
-      txns_to_deallocate_.push_front(txn);
-      txns_processed++;
+      safe_txns.push_back(txn);
     } else {
       // This is a committed txn that is still visible, requeue for next GC run
       requeue.push_front(txn);
@@ -142,9 +145,126 @@ std::tuple<uint32_t, uint32_t, uint32_t> GarbageCollector::ProcessUnlinkQueue(tr
   // Requeue any txns that we were still visible to running transactions
   txns_to_unlink_ = transaction::TransactionQueue(std::move(requeue));
 
+  UnlinkTransactions(safe_txns, oldest_txn, track_resources);
+  for (const UnlinkWork &work : unlink_work_) {
+    txns_processed += work.txns_processed_;
+    buffer_processed += work.buffer_processed_;
+  }
+
+  for (auto *const unlinked : safe_txns) {
+    // The observer is not thread-safe, so it is only told about the writes once the workers are done
+    if (observer_ != nullptr) {
+      for (auto &undo_record : unlinked->undo_buffer_) observer_->ObserveWrite(undo_record.Slot().GetBlock());
+    }
+    RecycleSlots(unlinked);
+    txns_to_deallocate_.push_front(unlinked);
+  }
+
   return std::make_tuple(txns_processed, buffer_processed, readonly_processed);
 }
 
+void GarbageCollector::UnlinkTransactions(const std::vector<transaction::TransactionContext *> &txns,
+                                          const transaction::timestamp_t oldest_txn, const bool track_resources) {
+  unlink_work_.clear();
+  if (txns.empty()) return;
+
+  const auto num_partitions = std::max<uint32_t>(
+      1, std::min<uint32_t>(num_workers_, static_cast<uint32_t>(txns.size()) / MIN_TXNS_PER_WORKER));
+  unlink_work_.resize(num_partitions);
+
+  // Deal out the version chains to the shares of the blocks they are in in a single pass, so that no worker has to go
+  // through the records of the others. The lists keep their capacity from one invocation to the next.
+  unlink_slots_.resize(num_partitions);
+  for (auto &slots : unlink_slots_) slots.clear();
+  for (auto *const txn : txns) {
+    for (auto &undo_record : txn->undo_buffer_) {
+      // It is possible for the table field to be null, for aborted transaction's last conflicting record
+      DataTable *const table = undo_record.Table();
+      if (table != nullptr)
+        unlink_slots_[PartitionOf(undo_record.Slot(), num_partitions)].emplace_back(table, undo_record.Slot());
+    }
+  }
+
+  if (num_partitions == 1) {
+    UnlinkPartition(txns, oldest_txn, 0, 1, &unlink_work_[0]);
+    return;
+  }
+
+  for (uint32_t partition = 0; partition < num_partitions; partition++) {
+    unlink_pool_.SubmitTask([this, &txns, oldest_txn, partition, num_partitions, track_resources] {
+      UnlinkWork *const work = &unlink_work_[partition];
+      // Workers are not registered with the metrics manager, so the invoking thread records what they measured
+      if (track_resources) common::thread_context.resource_tracker_.Start();
+      UnlinkPartition(txns, oldest_txn, partition, num_partitions, work);
+      if (track_resources) {
+        common::thread_context.resource_tracker_.Stop();
+        work->resource_metrics_ = common::thread_context.resource_tracker_.GetMetrics();
+      }
+    });
+  }
+  unlink_pool_.WaitUntilAllFinished();
+}
+
+void GarbageCollector::UnlinkPartition(const std::vector<transaction::TransactionContext *> &txns,
+                                       const transaction::timestamp_t oldest_txn, const uint32_t partition,
+                                       const uint32_t num_partitions, UnlinkWork *const work) const {
+  // It is sufficient to truncate each version chain once in a GC invocation because we only read the maximal safe
+  // timestamp once, and the version chain is sorted by timestamp. Here we keep a set of slots to truncate to avoid
+  // wasteful traversals of the version chain.
+  std::unordered_set<TupleSlot> visited_slots;
+  for (const auto &[table, slot] : unlink_slots_[partition]) {
+    // Each version chain needs to be traversed and truncated at most once every GC period. Check if we have already
+    // visited this tuple slot; if not, proceed to prune the version chain.
+    if (visited_slots.insert(slot).second) {
+      TruncateVersionChain(table, slot, oldest_txn);
+      work->slots_truncated_++;
+    }
+  }
+
+  // Each worker takes a contiguous share of the transactions to reclaim from
+  const size_t begin = txns.size() * partition / num_partitions;
+  const size_t end = txns.size() * (partition + 1) / num_partitions;
+  for (size_t i = begin; i < end; i++) {
+    auto *const txn = txns[i];
+    for (auto &undo_record : txn->undo_buffer_) {
+      // Regardless of the version chain we will need to reclaim any dangling pointers to varlens, unless the
+      // transaction is aborted, and the record holds a version that is still visible. Deleted slots are deallocated
+      // when they are handed back to their table, once the indexes no longer point to them.
+      if (!txn->Aborted()) ReclaimBufferIfVarlen(txn, &undo_record);
+      work->buffer_processed_++;
+    }
+    work->txns_processed_++;
+  }
+}
+
+void GarbageCollector::RecycleSlots(transaction::TransactionContext *const txn) const {
+  // A committed transaction frees the slots it deleted from, an aborted one those it inserted into
+  const DeltaRecordType type = txn->Aborted() ? DeltaRecordType::INSERT : DeltaRecordType::DELETE;
+  std::vector<TupleSlot> *freed_slots = nullptr;
+  for (auto &record : txn->undo_buffer_) {
+    // A null table means the write failed and was never installed
+    if (record.Type() != type || record.Table() == nullptr) continue;
+    if (freed_slots == nullptr) freed_slots = new std::vector<TupleSlot>;
+    freed_slots->push_back(record.Slot());
+  }
+  if (freed_slots == nullptr) return;
+  // The transaction is unlinked, so no running transaction can see these slots anymore, and the varlens of the deleted
+  // tuples have been collected. The indexes may still point to the slots, though, until the deferred actions that
+  // remove their entries have run. Those were registered when the transaction finished, so a deferred action
+  // registered now runs after them, and before a table dropped after the transaction finished is freed two deferrals
+  // later.
+  const auto recycle = [=]() {
+    // Rolled back inserts are deallocated right away, deletes only now
+    const bool deallocate = type == DeltaRecordType::DELETE;
+    for (const TupleSlot slot : *freed_slots) slot.GetBlock()->data_table_->RecycleSlot(slot, deallocate);
+    delete freed_slots;
+  };
+  if (deferred_action_manager_ != DISABLED)
+    deferred_action_manager_->RegisterDeferredAction(recycle);
+  else
+    recycle();
+}
+
 void GarbageCollector::ProcessDeferredActions(transaction::timestamp_t oldest_txn) {
   if (deferred_action_manager_ != DISABLED) {
     // TODO(Tianyu): Eventually we will remove the GC and implement version chain pruning with deferred actions
@@ -164,15 +284,18 @@ void GarbageCollector::TruncateVersionChain(DataTable *const table, const TupleS
   // here. Instead of a blind update we will need to CAS and prune the entire version chain if the head of the version
   // chain can be GCed.
   if (transaction::TransactionUtil::NewerThan(oldest, version_ptr->Timestamp().load())) {
-    if (!table->CompareAndSwapVersionPtr(slot, accessor, version_ptr, nullptr))
+    if (table->CompareAndSwapVersionPtr(slot, accessor, version_ptr, nullptr))
+      slot.GetBlock()->TruncateVersionChain();
+    else
       // Keep retrying while there are conflicts, since we only invoke truncate once per GC period for every
       // version chain.
       TruncateVersionChain(table, slot, oldest);
     return;
   }
 
-  // a version chain is guaranteed to not change when not at the head (assuming single-threaded GC), so we are safe
-  // to traverse and update pointers without CAS
+  // a version chain is guaranteed to not change when not at the head (as only one GC worker truncates it), other than
+  // readers and writers cutting it short past versions nobody can see (@see DataTable::PruneVersionChain). They only
+  // ever store nullptr, so we are safe to traverse and update pointers without CAS
   UndoRecord *curr = version_ptr;
   UndoRecord *next;
   // Traverse until we find the earliest UndoRecord that can be unlinked.
@@ -194,10 +317,6 @@ void GarbageCollector::TruncateVersionChain(DataTable *const table, const TupleS
     TruncateVersionChain(table, slot, oldest);
 }
 
-void GarbageCollector::ReclaimSlotIfDeleted(UndoRecord *const undo_record) const {
-  if (undo_record->Type() == DeltaRecordType::DELETE) undo_record->Table()->accessor_.Deallocate(undo_record->Slot());
-}
-
 void GarbageCollector::ReclaimBufferIfVarlen(transaction::TransactionContext *const txn,
                                              UndoRecord *const undo_record) const {
   const TupleAccessStrategy &accessor = undo_record->Table()->accessor_;
@@ -245,6 +364,12 @@ void GarbageCollector::UnregisterIndexForGC(const common::ManagedPointer<index::
   indexes_.erase(index);
 }
 
+void GarbageCollector::UnregisterTableForCompaction(const common::ManagedPointer<const SqlTable> table) {
+  TERRIER_ASSERT(table != nullptr, "Table cannot be nullptr.");
+  table->DisallowCompaction();
+  if (observer_ != nullptr) observer_->ForgetUncompactableBlocks();
+}
+
 void GarbageCollector::ProcessIndexes() {
   common::SharedLatch::ScopedSharedLatch guard(&indexes_latch_);
   for (const auto &index : indexes_) index->PerformGarbageCollection();
@@ -1,6 +1,14 @@
 #include "storage/index/bwtree_index.h"
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include "bwtree/bwtree.h"
+#include "ips4o/ips4o.hpp"
 #include "storage/index/compact_ints_key.h"
 #include "storage/index/generic_key.h"
 #include "transaction/deferred_action_manager.h"
@@ -102,6 +110,119 @@ bool BwTreeIndex<KeyType>::InsertUnique(const common::ManagedPointer<transaction
   return result;
 }
 
+template <typename KeyType>
+void BwTreeIndex<KeyType>::InsertBatch(const common::ManagedPointer<transaction::TransactionContext> txn,
+                                       const ProjectedRow *const *const tuples, const TupleSlot *const locations,
+                                       const uint32_t num_tuples) {
+  TERRIER_ASSERT(!(metadata_.GetSchema().Unique()),
+                 "This Insert is designed for secondary indexes with no uniqueness constraints.");
+  const auto entries = SortedEntries(tuples, locations, num_tuples);
+  for (const auto &entry : entries) {
+    const bool UNUSED_ATTRIBUTE result = bwtree_->Insert(entry.first, entry.second, false);
+    TERRIER_ASSERT(
+        result,
+        "non-unique index shouldn't fail to insert. If it did, something went wrong deep inside the BwTree itself.");
+  }
+  // Register an abort action with the txn context in case of rollback
+  txn->RegisterAbortAction([=]() {
+    for (const auto &entry : entries) {
+      const bool UNUSED_ATTRIBUTE result = bwtree_->Delete(entry.first, entry.second);
+      TERRIER_ASSERT(result, "Delete on the index failed.");
+    }
+  });
+}
+
+template <typename KeyType>
+bool BwTreeIndex<KeyType>::InsertUniqueBatch(const common::ManagedPointer<transaction::TransactionContext> txn,
+                                             const ProjectedRow *const *const tuples,
+                                             const TupleSlot *const locations, const uint32_t num_tuples) {
+  TERRIER_ASSERT(metadata_.GetSchema().Unique(), "This Insert is designed for indexes with uniqueness constraints.");
+  auto entries = SortedEntries(tuples, locations, num_tuples);
+
+  // The predicate checks if any matching keys have write-write conflicts or are still visible to the calling txn.
+  auto predicate = [txn](const TupleSlot slot) -> bool {
+    const auto *const data_table = slot.GetBlock()->data_table_;
+    const auto has_conflict = data_table->HasConflict(*txn, slot);
+    const auto is_visible = data_table->IsVisible(*txn, slot);
+    return has_conflict || is_visible;
+  };
+
+  uint32_t inserted = 0;
+  for (; inserted < num_tuples; inserted++) {
+    bool predicate_satisfied = false;
+    const bool result =
+        bwtree_->ConditionalInsert(entries[inserted].first, entries[inserted].second, predicate, &predicate_satisfied);
+    TERRIER_ASSERT(predicate_satisfied != result, "If predicate is not satisfied then insertion should succeed.");
+    if (!result) break;
+  }
+  // Only the keys that made it in need to be removed again in case of rollback
+  entries.resize(inserted);
+  if (!entries.empty()) {
+    txn->RegisterAbortAction([=]() {
+      for (const auto &entry : entries) {
+        const bool UNUSED_ATTRIBUTE result = bwtree_->Delete(entry.first, entry.second);
+        TERRIER_ASSERT(result, "Delete on the index failed.");
+      }
+    });
+  }
+
+  if (inserted < num_tuples) {
+    // Same as InsertUnique, the txn must now abort for the GC to clean up the version chains in the DataTable
+    txn->SetMustAbort();
+    return false;
+  }
+  return true;
+}
+
+template <typename KeyType>
+bool BwTreeIndex<KeyType>::BulkLoad(const common::ManagedPointer<transaction::TransactionContext> txn,
+                                    const ProjectedRow *const *const tuples, const TupleSlot *const locations,
+                                    const uint64_t num_tuples) {
+  // Every key is built on its own, so building them is split up over all cores
+  std::vector<std::pair<KeyType, TupleSlot>> entries(num_tuples);
+  const auto num_key_cols = metadata_.GetSchema().GetColumns().size();
+  tbb::parallel_for(tbb::blocked_range<uint64_t>(0, num_tuples), [&](const tbb::blocked_range<uint64_t> &range) {
+    for (uint64_t i = range.begin(); i != range.end(); i++) {
+      entries[i].first.SetFromProjectedRow(*tuples[i], metadata_, num_key_cols);
+      entries[i].second = locations[i];
+    }
+  });
+  ips4o::sort(entries.begin(), entries.end(), [](const auto &lhs, const auto &rhs) {
+    return std::less<KeyType>()(lhs.first, rhs.first);  // NOLINT transparent functors can't figure out template
+  });
+
+  if (metadata_.GetSchema().Unique()) {
+    // All tuples are visible to the calling txn, so any repeated key violates the constraint. Same as InsertUnique,
+    // the txn must now abort.
+    const auto repeated = std::adjacent_find(entries.begin(), entries.end(), [](const auto &lhs, const auto &rhs) {
+      return std::equal_to<KeyType>()(lhs.first, rhs.first);  // NOLINT transparent functors can't figure out template
+    });
+    if (repeated != entries.end()) {
+      txn->SetMustAbort();
+      return false;
+    }
+  }
+
+  // Only an empty tree can be built bottom-up
+  if (bwtree_->BulkLoad(entries)) return true;
+  return Index::BulkLoad(txn, tuples, locations, num_tuples);
+}
+
+template <typename KeyType>
+std::vector<std::pair<KeyType, TupleSlot>> BwTreeIndex<KeyType>::SortedEntries(const ProjectedRow *const *const tuples,
+                                                                              const TupleSlot *const locations,
+                                                                              const uint32_t num_tuples) const {
+  std::vector<std::pair<KeyType, TupleSlot>> entries(num_tuples);
+  for (uint32_t i = 0; i < num_tuples; i++) {
+    entries[i].first.SetFromProjectedRow(*tuples[i], metadata_, metadata_.GetSchema().GetColumns().size());
+    entries[i].second = locations[i];
+  }
+  std::sort(entries.begin(), entries.end(), [](const auto &lhs, const auto &rhs) {
+    return std::less<KeyType>()(lhs.first, rhs.first);  // NOLINT transparent functors can't figure out template
+  });
+  return entries;
+}
+
 template <typename KeyType>
 void BwTreeIndex<KeyType>::Delete(const common::ManagedPointer<transaction::TransactionContext> txn,
                                   const ProjectedRow &tuple, const TupleSlot location) {
@@ -1,5 +1,10 @@
 #include "storage/index/hash_index.h"
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <atomic>
+
 #include "libcuckoo/cuckoohash_map.hh"
 #include "storage/index/generic_key.h"
 #include "storage/index/hash_key.h"
@@ -192,6 +197,48 @@ bool HashIndex<KeyType>::InsertUnique(const common::ManagedPointer<transaction::
 
   return overall_result;
 }
+template <typename KeyType>
+bool HashIndex<KeyType>::BulkLoad(const common::ManagedPointer<transaction::TransactionContext> txn,
+                                  const ProjectedRow *const *const tuples, const TupleSlot *const locations,
+                                  const uint64_t num_tuples) {
+  // The checks below assume that only the calling txn's tuples are in the index
+  if (hash_map_->size() != 0) return Index::BulkLoad(txn, tuples, locations, num_tuples);
+  hash_map_->reserve(num_tuples);
+
+  const bool unique = metadata_.GetSchema().Unique();
+  const auto num_key_cols = metadata_.GetSchema().GetColumns().size();
+  std::atomic<bool> repeated = false;
+  // The map takes concurrent inserts, so keys are inserted on all cores. No abort actions are registered, as the index
+  // is dropped if the txn aborts.
+  tbb::parallel_for(tbb::blocked_range<uint64_t>(0, num_tuples), [&](const tbb::blocked_range<uint64_t> &range) {
+    KeyType index_key;
+    for (uint64_t i = range.begin(); i != range.end() && !repeated.load(std::memory_order_relaxed); i++) {
+      index_key.SetFromProjectedRow(*tuples[i], metadata_, num_key_cols);
+      const TupleSlot location = locations[i];
+      auto key_found_fn = [&](ValueType &value) -> bool {
+        if (unique) {
+          // All tuples are visible to the calling txn, so any repeated key violates the constraint
+          repeated = true;
+        } else if (std::holds_alternative<TupleSlot>(value)) {
+          const auto existing_location = std::get<TupleSlot>(value);
+          value = ValueMap({{location}, {existing_location}}, 2);
+        } else {
+          std::get<ValueMap>(value).emplace(location);
+        }
+        return false;
+      };
+      hash_map_->uprase_fn(index_key, key_found_fn, location);
+    }
+  });
+
+  if (repeated) {
+    // Same as InsertUnique, the txn must now abort
+    txn->SetMustAbort();
+    return false;
+  }
+  return true;
+}
+
 template <typename KeyType>
 void HashIndex<KeyType>::Delete(const common::ManagedPointer<transaction::TransactionContext> txn,
                                 const ProjectedRow &tuple, const TupleSlot location) {
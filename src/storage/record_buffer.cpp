@@ -33,6 +33,19 @@ byte *RedoBuffer::NewEntry(const uint32_t size) {
   return last_record_;
 }
 
+byte *RedoBuffer::NewEntries(const uint32_t size, const uint32_t max_entries, uint32_t *const num_entries) {
+  TERRIER_ASSERT(max_entries > 0, "Must reserve at least one redo record");
+  byte *const first = NewEntry(size);
+  uint32_t reserved = 1;
+  // Reservations within a segment are contiguous, so the records follow the first one without gaps
+  while (reserved < max_entries && buffer_seg_->HasBytesLeft(size)) {
+    last_record_ = buffer_seg_->Reserve(size);
+    reserved++;
+  }
+  *num_entries = reserved;
+  return first;
+}
+
 void RedoBuffer::Finalize(bool flush_buffer) {
   if (buffer_seg_ == nullptr) return;  // If we never initialized a buffer (logging was disabled), we don't do anything
   if (log_manager_ != DISABLED && flush_buffer) {
@@ -12,6 +12,11 @@ std::pair<LogRecord *, std::vector<byte *>> AbstractLogProvider::ReadNextRecord(
   std::vector<byte *> varlen_contents;
   // Read in LogRecord header data
   auto size = ReadValue<uint32_t>();
+  // No record is empty, so a zero size starts padding
+  while (size == 0) {
+    if (!SkipPadding()) return {nullptr, varlen_contents};
+    size = ReadValue<uint32_t>();
+  }
   byte *buf = common::AllocationUtil::AllocateAligned(size);
   auto record_type = ReadValue<storage::LogRecordType>();
   auto txn_begin = ReadValue<transaction::timestamp_t>();
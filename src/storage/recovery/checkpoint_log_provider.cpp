@@ -0,0 +1,168 @@
+#include "storage/recovery/checkpoint_log_provider.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catalog/postgres/pg_class.h"
+
+namespace terrier::storage {
+
+CheckpointLogProvider::CheckpointLogProvider(const std::string &checkpoint_file_path)
+    : reader_(std::make_unique<BufferedLogReader>(checkpoint_file_path.c_str())) {
+  CheckpointHeader header;
+  header.magic_ = 0;
+  if (!Read(&header, sizeof(CheckpointHeader)) || header.magic_ != CheckpointHeader::MAGIC)
+    throw std::runtime_error("File " + checkpoint_file_path + " is not a checkpoint");
+  timestamp_ = header.timestamp_;
+}
+
+std::pair<LogRecord *, std::vector<byte *>> CheckpointLogProvider::GetNextRecord() {
+  while (pending_records_.empty() && !reached_end_) ReadNext();
+  if (pending_records_.empty()) return {nullptr, {}};
+  auto record = std::move(pending_records_.front());
+  pending_records_.pop_front();
+  return record;
+}
+
+void CheckpointLogProvider::ReadFully(void *const dest, const uint32_t size) {
+  if (!Read(dest, size)) throw std::runtime_error("Checkpoint ends unexpectedly, possible data corruption");
+}
+
+void CheckpointLogProvider::ReadNext() {
+  if (in_table_) {
+    ReadTableBatch();
+    return;
+  }
+  switch (ReadCheckpointValue<CheckpointSection>()) {
+    case (CheckpointSection::TABLE):
+      ReadTableHeader();
+      break;
+    case (CheckpointSection::CLASS_OBJECTS):
+      ReadClassObjects();
+      break;
+    case (CheckpointSection::END):
+      reached_end_ = true;
+      break;
+    default:
+      throw std::runtime_error("Unknown checkpoint section, possible data corruption");
+  }
+}
+
+void CheckpointLogProvider::ReadTableHeader() {
+  table_db_oid_ = ReadCheckpointValue<catalog::db_oid_t>();
+  table_oid_ = ReadCheckpointValue<catalog::table_oid_t>();
+  const auto num_cols = ReadCheckpointValue<uint16_t>();
+  if (num_cols > common::Constants::MAX_COL) {
+    throw std::runtime_error("Number of columns deserialized exceeds max columns. possible data corrution");
+  }
+
+  std::vector<col_id_t> col_ids;
+  std::vector<uint16_t> real_attr_sizes;
+  col_ids.reserve(num_cols);
+  table_attr_sizes_.clear();
+  for (uint16_t i = 0; i < num_cols; i++) {
+    col_ids.push_back(ReadCheckpointValue<col_id_t>());
+    table_attr_sizes_.push_back(ReadCheckpointValue<uint16_t>());
+    real_attr_sizes.push_back(AttrSizeBytes(table_attr_sizes_.back()));
+  }
+  table_initializer_ = ProjectedRowInitializer::Create(real_attr_sizes, col_ids);
+
+  // The initializer orders the columns by size, so we look up where each of them went
+  byte *const buffer = common::AllocationUtil::AllocateAligned(table_initializer_.ProjectedRowSize());
+  const ProjectedRow *const row = table_initializer_.InitializeRow(buffer);
+  table_pr_indexes_.clear();
+  for (const col_id_t col_id : col_ids) {
+    uint16_t pr_idx = 0;
+    while (row->ColumnIds()[pr_idx] != col_id) pr_idx++;
+    table_pr_indexes_.push_back(pr_idx);
+  }
+  delete[] buffer;
+  in_table_ = true;
+}
+
+void CheckpointLogProvider::ReadTableBatch() {
+  const auto num_tuples = ReadCheckpointValue<uint32_t>();
+  if (num_tuples == 0) {
+    in_table_ = false;
+    return;
+  }
+
+  std::vector<TupleSlot> slots(num_tuples);
+  ReadFully(slots.data(), static_cast<uint32_t>(num_tuples * sizeof(TupleSlot)));
+  std::vector<std::pair<LogRecord *, std::vector<byte *>>> records;
+  records.reserve(num_tuples);
+  for (const TupleSlot slot : slots) {
+    byte *const buf = common::AllocationUtil::AllocateAligned(RedoRecord::Size(table_initializer_));
+    LogRecord *const record = RedoRecord::Initialize(buf, timestamp_, table_db_oid_, table_oid_, table_initializer_);
+    record->GetUnderlyingRecordBodyAs<RedoRecord>()->SetTupleSlot(slot);
+    records.emplace_back(record, std::vector<byte *>());
+  }
+
+  const uint32_t bitmap_num_bytes = common::RawBitmap::SizeInBytes(num_tuples);
+  auto *const bitmap_buffer = new uint8_t[bitmap_num_bytes];
+  const auto *const nulls = reinterpret_cast<const common::RawBitmap *>(bitmap_buffer);
+  for (uint16_t col = 0; col < table_attr_sizes_.size(); col++) {
+    ReadFully(bitmap_buffer, bitmap_num_bytes);
+    const uint16_t pr_idx = table_pr_indexes_[col];
+    const bool is_varlen = table_attr_sizes_[col] == VARLEN_COLUMN;
+    for (uint32_t i = 0; i < num_tuples; i++) {
+      ProjectedRow *const delta = records[i].first->GetUnderlyingRecordBodyAs<RedoRecord>()->Delta();
+      // Recall that 0 means null
+      if (!nulls->Test(i)) {
+        delta->SetNull(pr_idx);
+        continue;
+      }
+      byte *const value = delta->AccessForceNotNull(pr_idx);
+      if (!is_varlen) {
+        ReadFully(value, table_attr_sizes_[col]);
+        continue;
+      }
+      const auto varlen_size = ReadCheckpointValue<uint32_t>();
+      if (varlen_size <= VarlenEntry::InlineThreshold()) {
+        byte content[VarlenEntry::InlineThreshold()];
+        ReadFully(content, varlen_size);
+        *reinterpret_cast<VarlenEntry *>(value) = VarlenEntry::CreateInline(content, varlen_size);
+      } else {
+        byte *const content = common::AllocationUtil::AllocateAligned(varlen_size);
+        ReadFully(content, varlen_size);
+        *reinterpret_cast<VarlenEntry *>(value) = VarlenEntry::Create(content, varlen_size, true);
+        records[i].second.push_back(content);
+      }
+    }
+  }
+  delete[] bitmap_buffer;
+
+  for (auto &record : records) pending_records_.emplace_back(std::move(record));
+  AddCommit();
+}
+
+void CheckpointLogProvider::ReadClassObjects() {
+  const auto db_oid = ReadCheckpointValue<catalog::db_oid_t>();
+  const auto ptr_col_id = ReadCheckpointValue<col_id_t>();
+  const auto num_objects = ReadCheckpointValue<uint32_t>();
+  // Recovery creates the object on any update of the pointer column, whatever the value
+  const ProjectedRowInitializer initializer =
+      ProjectedRowInitializer::Create(std::vector<uint16_t>{sizeof(uint64_t)}, std::vector<col_id_t>{ptr_col_id});
+  for (uint32_t i = 0; i < num_objects; i++) {
+    const auto slot = ReadCheckpointValue<TupleSlot>();
+    byte *const buf = common::AllocationUtil::AllocateAligned(RedoRecord::Size(initializer));
+    LogRecord *const record =
+        RedoRecord::Initialize(buf, timestamp_, db_oid, catalog::postgres::CLASS_TABLE_OID, initializer);
+    auto *const redo = record->GetUnderlyingRecordBodyAs<RedoRecord>();
+    redo->SetTupleSlot(slot);
+    *reinterpret_cast<uint64_t *>(redo->Delta()->AccessForceNotNull(0)) = 0;
+    pending_records_.emplace_back(record, std::vector<byte *>());
+  }
+  AddCommit();
+}
+
+void CheckpointLogProvider::AddCommit() {
+  byte *const buf = common::AllocationUtil::AllocateAligned(CommitRecord::Size());
+  // With no older active transaction, the recovery manager replays everything up to here right away
+  pending_records_.emplace_back(CommitRecord::Initialize(buf, timestamp_, timestamp_, nullptr, nullptr,
+                                                         transaction::INVALID_TXN_TIMESTAMP, false, nullptr, nullptr),
+                                std::vector<byte *>());
+}
+
+}  // namespace terrier::storage
@@ -0,0 +1,241 @@
+#include "storage/recovery/checkpoint_manager.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "catalog/database_catalog.h"
+#include "catalog/postgres/pg_attribute.h"
+#include "catalog/postgres/pg_class.h"
+#include "catalog/postgres/pg_constraint.h"
+#include "catalog/postgres/pg_database.h"
+#include "catalog/postgres/pg_index.h"
+#include "catalog/postgres/pg_language.h"
+#include "catalog/postgres/pg_namespace.h"
+#include "catalog/postgres/pg_proc.h"
+#include "catalog/postgres/pg_type.h"
+#include "storage/sql_table.h"
+#include "storage/write_ahead_log/log_io.h"
+#include "storage/write_ahead_log/log_manager.h"
+#include "transaction/timestamp_manager.h"
+#include "transaction/transaction_context.h"
+#include "transaction/transaction_manager.h"
+
+namespace terrier::storage {
+
+namespace {
+void WriteBytes(BufferedLogWriter *const out, const void *const data, const uint32_t size) {
+  uint32_t written = 0;
+  while (written < size) {
+    written += out->BufferWrite(reinterpret_cast<const byte *>(data) + written, size - written);
+    if (out->IsBufferFull()) out->FlushBuffer();
+  }
+}
+
+template <class T>
+void WriteValue(BufferedLogWriter *const out, const T &val) {
+  WriteBytes(out, &val, sizeof(T));
+}
+}  // namespace
+
+CheckpointManager::CheckpointManager(std::string checkpoint_file_path,
+                                     const common::ManagedPointer<catalog::Catalog> catalog,
+                                     const common::ManagedPointer<transaction::TransactionManager> txn_manager,
+                                     const common::ManagedPointer<transaction::TimestampManager> timestamp_manager,
+                                     const common::ManagedPointer<LogManager> log_manager)
+    : checkpoint_file_path_(std::move(checkpoint_file_path)),
+      catalog_(catalog),
+      txn_manager_(txn_manager),
+      timestamp_manager_(timestamp_manager),
+      log_manager_(log_manager) {}
+
+std::string CheckpointManager::TakeCheckpoint() {
+  // Every transaction that started before this has committed or aborted by the time the checkpointing transaction
+  // begins. What they did is thus either in the checkpoint or undone, and their log records are no longer needed.
+  const transaction::timestamp_t oldest_needed_txn = timestamp_manager_->OldestTransactionStartTime();
+  auto *const txn = txn_manager_->BeginTransaction();
+
+  const std::vector<uint64_t> old_checkpoints = ListCheckpoints(checkpoint_file_path_);
+  const uint64_t checkpoint_id = old_checkpoints.empty() ? 0 : old_checkpoints.back() + 1;
+  const std::string checkpoint_path = CheckpointFilePath(checkpoint_file_path_, checkpoint_id);
+  const std::string temp_path = checkpoint_path + TEMP_SUFFIX;
+  // Left behind by a checkpoint that never finished
+  if (unlink(temp_path.c_str()) == -1 && errno != ENOENT)
+    throw std::runtime_error("Failed to delete unfinished checkpoint with errno " + std::to_string(errno));
+
+  // The writer's buffer is too large for the stack
+  auto out = std::make_unique<BufferedLogWriter>(temp_path.c_str());
+  CheckpointHeader header;
+  header.timestamp_ = txn->StartTime();
+  WriteValue(out.get(), header);
+  WriteCheckpoint(out.get(), txn);
+  out->FlushBuffer();
+  out->Persist();
+  out->Close();
+  txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  if (rename(temp_path.c_str(), checkpoint_path.c_str()) == -1)
+    throw std::runtime_error("Failed to rename checkpoint with errno " + std::to_string(errno));
+  PosixIoWrappers::SyncParentDirectory(checkpoint_path);
+
+  // Recovery only ever needs the latest checkpoint
+  for (const uint64_t old_checkpoint_id : old_checkpoints) {
+    if (unlink(CheckpointFilePath(checkpoint_file_path_, old_checkpoint_id).c_str()) == -1)
+      throw std::runtime_error("Failed to delete checkpoint with errno " + std::to_string(errno));
+  }
+  if (!old_checkpoints.empty()) PosixIoWrappers::SyncParentDirectory(checkpoint_path);
+  if (log_manager_ != DISABLED) log_manager_->DiscardSegments(oldest_needed_txn);
+  return checkpoint_path;
+}
+
+std::vector<uint64_t> CheckpointManager::ListCheckpoints(const std::string &checkpoint_file_path) {
+  return PosixIoWrappers::ListNumberedFiles(checkpoint_file_path + ".");
+}
+
+std::string CheckpointManager::LatestCheckpointFilePath(const std::string &checkpoint_file_path) {
+  const std::vector<uint64_t> checkpoints = ListCheckpoints(checkpoint_file_path);
+  return checkpoints.empty() ? "" : CheckpointFilePath(checkpoint_file_path, checkpoints.back());
+}
+
+void CheckpointManager::WriteCheckpoint(BufferedLogWriter *const out, transaction::TransactionContext *const txn) {
+  // Databases are created from their pg_database entries during recovery, so pg_database comes first
+  std::vector<catalog::db_oid_t> db_oids;
+  const col_id_t datoid_col_id = catalog_->databases_->ColIdsForOids({catalog::postgres::DATOID_COL_OID})[0];
+  WriteTable(out, txn, catalog::INVALID_DATABASE_OID, catalog::postgres::DATABASE_TABLE_OID, *catalog_->databases_,
+             [&](ProjectedColumns *const columns) {
+               const uint16_t datoid_idx = ColumnIndex(columns, datoid_col_id);
+               for (uint32_t i = 0; i < columns->NumTuples(); i++) {
+                 db_oids.push_back(*reinterpret_cast<const catalog::db_oid_t *>(
+                     columns->InterpretAsRow(i).AccessWithNullCheck(datoid_idx)));
+               }
+             });
+
+  for (const catalog::db_oid_t db_oid : db_oids) WriteDatabase(out, txn, db_oid);
+  WriteValue(out, CheckpointSection::END);
+}
+
+void CheckpointManager::WriteDatabase(BufferedLogWriter *const out, transaction::TransactionContext *const txn,
+                                      const catalog::db_oid_t db_oid) {
+  const auto db_catalog = catalog_->GetDatabaseCatalog(common::ManagedPointer(txn), db_oid);
+  TERRIER_ASSERT(db_catalog != nullptr, "A database visible to the checkpoint must have a catalog");
+
+  // During recovery, tables and indexes are created from their pg_class entries once everything else they are made of
+  // is in the catalog. Until then, their entries look the way they do when an object is first created: the schema
+  // pointer is a null pointer, and the object pointer is null.
+  const std::vector<col_id_t> class_col_ids = db_catalog->classes_->ColIdsForOids(
+      {catalog::postgres::RELOID_COL_OID, catalog::postgres::RELKIND_COL_OID, catalog::postgres::REL_SCHEMA_COL_OID,
+       catalog::postgres::REL_PTR_COL_OID});
+  std::vector<TupleSlot> class_tables, class_indexes;
+  std::vector<std::pair<catalog::table_oid_t, const SqlTable *>> user_tables;
+
+  WriteTable(out, txn, db_oid, catalog::postgres::NAMESPACE_TABLE_OID, *db_catalog->namespaces_);
+  WriteTable(out, txn, db_oid, catalog::postgres::CLASS_TABLE_OID, *db_catalog->classes_,
+             [&](ProjectedColumns *const columns) {
+               const uint16_t reloid_idx = ColumnIndex(columns, class_col_ids[0]);
+               const uint16_t relkind_idx = ColumnIndex(columns, class_col_ids[1]);
+               const uint16_t schema_idx = ColumnIndex(columns, class_col_ids[2]);
+               const uint16_t ptr_idx = ColumnIndex(columns, class_col_ids[3]);
+               for (uint32_t i = 0; i < columns->NumTuples(); i++) {
+                 ProjectedColumns::RowView row = columns->InterpretAsRow(i);
+                 *reinterpret_cast<uint64_t *>(row.AccessForceNotNull(schema_idx)) = 0;
+                 const byte *const ptr = row.AccessWithNullCheck(ptr_idx);
+                 // The object has not been created yet
+                 if (ptr == nullptr) continue;
+                 const auto class_oid = *reinterpret_cast<const uint32_t *>(row.AccessWithNullCheck(reloid_idx));
+                 const auto class_kind =
+                     *reinterpret_cast<const catalog::postgres::ClassKind *>(row.AccessWithNullCheck(relkind_idx));
+                 if (class_kind == catalog::postgres::ClassKind::REGULAR_TABLE) {
+                   class_tables.push_back(columns->TupleSlots()[i]);
+                   // Catalog tables have been written already
+                   if (class_oid >= catalog::START_OID)
+                     user_tables.emplace_back(catalog::table_oid_t(class_oid),
+                                              *reinterpret_cast<const SqlTable *const *>(ptr));
+                 } else if (class_kind == catalog::postgres::ClassKind::INDEX) {
+                   class_indexes.push_back(columns->TupleSlots()[i]);
+                 }
+                 row.SetNull(ptr_idx);
+               }
+             });
+  WriteTable(out, txn, db_oid, catalog::postgres::COLUMN_TABLE_OID, *db_catalog->columns_);
+  WriteTable(out, txn, db_oid, catalog::postgres::INDEX_TABLE_OID, *db_catalog->indexes_);
+  WriteTable(out, txn, db_oid, catalog::postgres::TYPE_TABLE_OID, *db_catalog->types_);
+  WriteTable(out, txn, db_oid, catalog::postgres::CONSTRAINT_TABLE_OID, *db_catalog->constraints_);
+  WriteTable(out, txn, db_oid, catalog::postgres::LANGUAGE_TABLE_OID, *db_catalog->languages_);
+  WriteTable(out, txn, db_oid, catalog::postgres::PRO_TABLE_OID, *db_catalog->procs_);
+
+  WriteValue(out, CheckpointSection::CLASS_OBJECTS);
+  WriteValue(out, db_oid);
+  WriteValue(out, class_col_ids[3]);
+  WriteValue(out, static_cast<uint32_t>(class_tables.size() + class_indexes.size()));
+  WriteBytes(out, class_tables.data(), static_cast<uint32_t>(class_tables.size() * sizeof(TupleSlot)));
+  WriteBytes(out, class_indexes.data(), static_cast<uint32_t>(class_indexes.size() * sizeof(TupleSlot)));
+
+  // The tables are only dropped once no transaction can see them anymore, ours included
+  for (const auto &user_table : user_tables) WriteTable(out, txn, db_oid, user_table.first, *user_table.second);
+}
+
+void CheckpointManager::WriteTable(BufferedLogWriter *const out, transaction::TransactionContext *const txn,
+                                   const catalog::db_oid_t db_oid, const catalog::table_oid_t table_oid,
+                                   const SqlTable &table, const std::function<void(ProjectedColumns *)> &inspect) {
+  const BlockLayout &layout = table.table_.layout_;
+  std::vector<catalog::col_oid_t> col_oids;
+  col_oids.reserve(table.GetColumnMap().size());
+  for (const auto &column : table.GetColumnMap()) col_oids.push_back(column.first);
+  // A batch holds as many tuples as a block, so that the table is written about a block at a time
+  const ProjectedColumnsInitializer initializer = table.InitializerForProjectedColumns(col_oids, layout.NumSlots());
+  byte *const buffer = common::AllocationUtil::AllocateAligned(initializer.ProjectedColumnsSize());
+  ProjectedColumns *const columns = initializer.Initialize(buffer);
+  const uint16_t num_cols = columns->NumColumns();
+
+  WriteValue(out, CheckpointSection::TABLE);
+  WriteValue(out, db_oid);
+  WriteValue(out, table_oid);
+  WriteValue(out, num_cols);
+  for (uint16_t col_idx = 0; col_idx < num_cols; col_idx++) {
+    const col_id_t col_id = columns->ColumnIds()[col_idx];
+    WriteValue(out, col_id);
+    WriteValue(out, layout.IsVarlen(col_id) ? VARLEN_COLUMN : layout.AttrSize(col_id));
+  }
+
+  for (auto it = table.begin(); it != table.end();) {
+    table.Scan(common::ManagedPointer(txn), &it, columns);
+    const uint32_t num_tuples = columns->NumTuples();
+    if (num_tuples == 0) continue;
+    if (inspect != nullptr) inspect(columns);
+
+    WriteValue(out, num_tuples);
+    WriteBytes(out, columns->TupleSlots(), static_cast<uint32_t>(num_tuples * sizeof(TupleSlot)));
+    for (uint16_t col_idx = 0; col_idx < num_cols; col_idx++) {
+      const col_id_t col_id = columns->ColumnIds()[col_idx];
+      const common::RawBitmap *const nulls = columns->ColumnNullBitmap(col_idx);
+      WriteBytes(out, nulls, common::RawBitmap::SizeInBytes(num_tuples));
+      const uint16_t attr_size = layout.AttrSize(col_id);
+      const byte *const values = columns->ColumnStart(col_idx);
+      for (uint32_t i = 0; i < num_tuples; i++) {
+        // Recall that 0 means null
+        if (!nulls->Test(i)) continue;
+        if (layout.IsVarlen(col_id)) {
+          const auto *const varlen_entry = reinterpret_cast<const VarlenEntry *>(values + i * attr_size);
+          WriteValue(out, varlen_entry->Size());
+          WriteBytes(out, varlen_entry->Content(), varlen_entry->Size());
+        } else {
+          WriteBytes(out, values + i * attr_size, attr_size);
+        }
+      }
+    }
+  }
+  // An empty batch ends the table
+  WriteValue(out, uint32_t{0});
+  delete[] buffer;
+}
+
+uint16_t CheckpointManager::ColumnIndex(ProjectedColumns *const columns, const col_id_t col_id) {
+  for (uint16_t col_idx = 0; col_idx < columns->NumColumns(); col_idx++) {
+    if (columns->ColumnIds()[col_idx] == col_id) return col_idx;
+  }
+  throw std::runtime_error("Column is not in the projection");
+}
+
+}  // namespace terrier::storage
@@ -0,0 +1,18 @@
+#include "storage/recovery/checkpoint_thread.h"
+#include "metrics/metrics_manager.h"
+
+namespace terrier::storage {
+CheckpointThread::CheckpointThread(common::ManagedPointer<CheckpointManager> checkpoint_manager,
+                                   std::chrono::milliseconds checkpoint_period,
+                                   common::ManagedPointer<metrics::MetricsManager> metrics_manager)
+    : checkpoint_manager_(checkpoint_manager),
+      metrics_manager_(metrics_manager),
+      run_checkpointing_(true),
+      checkpointing_paused_(false),
+      checkpoint_period_(checkpoint_period),
+      checkpoint_thread_(std::thread([this] {
+        if (metrics_manager_ != DISABLED) metrics_manager_->RegisterThread();
+        CheckpointThreadLoop();
+      })) {}
+
+}  // namespace terrier::storage
@@ -0,0 +1,96 @@
+#include "storage/recovery/disk_log_provider.h"
+
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace terrier::storage {
+
+DiskLogProvider::DiskLogProvider(const std::string &log_file_path, const uint32_t num_streams) {
+  TERRIER_ASSERT(num_streams > 0, "There must be at least one log stream");
+  for (const uint64_t run : LogManager::ListRotatedRuns(log_file_path)) {
+    const std::string run_file_path = LogManager::RunFilePath(log_file_path, run);
+    uint32_t num_run_streams = 0;
+    while (access(LogManager::StreamFilePath(run_file_path, num_run_streams).c_str(), F_OK) == 0) num_run_streams++;
+    runs_.emplace_back(run_file_path, num_run_streams);
+  }
+  runs_.emplace_back(log_file_path, num_streams);
+  OpenNextRun();
+}
+
+void DiskLogProvider::OpenNextRun() {
+  const auto &[log_file_path, num_streams] = runs_[next_run_++];
+  streams_ = std::vector<StreamReader>(num_streams);
+  pending_commits_ = std::vector<std::pair<LogRecord *, std::vector<byte *>>>(num_streams, {nullptr, {}});
+  current_stream_ = 0;
+  for (uint32_t i = 0; i < num_streams; i++) {
+    auto &stream = streams_[i];
+    const std::string stream_file_path = LogManager::StreamFilePath(log_file_path, i);
+    const auto segments = LogManager::ListSegments(stream_file_path);
+    stream.has_unsegmented_file_ = segments.empty() || access(stream_file_path.c_str(), F_OK) == 0;
+    if (stream.has_unsegmented_file_) stream.files_.emplace_back(stream_file_path);
+    for (const uint64_t segment_id : segments)
+      stream.files_.emplace_back(LogManager::SegmentFilePath(stream_file_path, segment_id));
+    OpenNextFile(&stream);
+  }
+}
+
+bool DiskLogProvider::HasMoreRecords() {
+  auto &stream = streams_[current_stream_];
+  // Records never span segments, so we can move on to the next one once we are through with the current one
+  while (!stream.reader_->HasMore() && stream.next_file_ < stream.files_.size()) OpenNextFile(&stream);
+  return stream.reader_->HasMore();
+}
+
+void DiskLogProvider::OpenNextFile(StreamReader *const stream) {
+  const bool is_segment = stream->next_file_ > 0 || !stream->has_unsegmented_file_;
+  stream->reader_ = std::make_unique<BufferedLogReader>(stream->files_[stream->next_file_++].c_str());
+  if (!is_segment) return;
+  // A segment that is too short for a header was being created when the system went down, and has no records
+  char header_bytes[LogSegmentHeader::SIZE_ON_DISK];
+  if (!stream->reader_->Read(header_bytes, LogSegmentHeader::SIZE_ON_DISK)) return;
+  LogSegmentHeader header;
+  std::memcpy(&header, header_bytes, sizeof(LogSegmentHeader));
+  if (header.magic_ != LogSegmentHeader::MAGIC) throw std::runtime_error("Log segment has a corrupt header");
+}
+
+std::pair<LogRecord *, std::vector<byte *>> DiskLogProvider::GetNextRecord() {
+  auto record = GetNextRecordOfRun();
+  while (record.first == nullptr && next_run_ < runs_.size()) {
+    OpenNextRun();
+    record = GetNextRecordOfRun();
+  }
+  return record;
+}
+
+std::pair<LogRecord *, std::vector<byte *>> DiskLogProvider::GetNextRecordOfRun() {
+  // With a single stream there is nothing to merge
+  if (streams_.size() == 1) return AbstractLogProvider::GetNextRecord();
+
+  // Make sure every stream that still has records has its next commit record lined up. Anything else we come across on
+  // the way can be handed out right away.
+  for (current_stream_ = 0; current_stream_ < streams_.size(); current_stream_++) {
+    if (pending_commits_[current_stream_].first != nullptr || !HasMoreRecords()) continue;
+    auto record = ReadNextRecord();
+    // The stream ended in padding
+    if (record.first == nullptr) continue;
+    if (record.first->RecordType() != LogRecordType::COMMIT) return record;
+    pending_commits_[current_stream_] = std::move(record);
+  }
+
+  // Hand out the oldest of the lined up commits
+  auto oldest = pending_commits_.end();
+  for (auto it = pending_commits_.begin(); it != pending_commits_.end(); ++it) {
+    if (it->first == nullptr) continue;
+    if (oldest == pending_commits_.end() ||
+        it->first->GetUnderlyingRecordBodyAs<CommitRecord>()->CommitTime() <
+            oldest->first->GetUnderlyingRecordBodyAs<CommitRecord>()->CommitTime())
+      oldest = it;
+  }
+  // Every stream is exhausted
+  if (oldest == pending_commits_.end()) return {nullptr, std::vector<byte *>()};
+  return std::exchange(*oldest, {nullptr, std::vector<byte *>()});
+}
+
+}  // namespace terrier::storage
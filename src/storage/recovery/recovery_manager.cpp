@@ -1,6 +1,7 @@
 #include "storage/recovery/recovery_manager.h"
 
 #include <algorithm>
+#include <numeric>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -39,14 +40,26 @@ void RecoveryManager::WaitForRecoveryToFinish() {
   }
 }
 
-void RecoveryManager::RecoverFromLogs() {
+void RecoveryManager::Recover() {
+  replay_pool_.Startup();
+  if (checkpoint_provider_ != nullptr) RecoverFromCheckpoint();
+  RecoverFromLogs();
+  if (defer_index_builds_) RebuildDeferredIndexes();
+  replay_pool_.Shutdown();
+  // Time started over with the system, so transactions from now on could otherwise look older than the recovered ones
+  txn_manager_->GetTimestampManager()->AdvancePast(newest_timestamp_);
+}
+
+void RecoveryManager::Replay(const common::ManagedPointer<AbstractLogProvider> provider) {
   // Replay logs until the log provider no longer gives us logs
   while (true) {
-    auto pair = log_provider_->GetNextRecord();
+    auto pair = provider->GetNextRecord();
     auto *log_record = pair.first;
 
     // If we have exhausted all the logs, break from the loop
     if (log_record == nullptr) break;
+    // Checkpoint records carry the timestamp of the checkpoint
+    newest_timestamp_ = std::max(newest_timestamp_, log_record->TxnBegin());
 
     switch (log_record->RecordType()) {
       case (LogRecordType::ABORT): {
@@ -60,6 +73,15 @@ void RecoveryManager::RecoverFromLogs() {
       case (LogRecordType::COMMIT): {
         TERRIER_ASSERT(pair.second.empty(), "Commit records should not have any varlen pointers");
         auto *commit_record = log_record->GetUnderlyingRecordBodyAs<CommitRecord>();
+        newest_timestamp_ = std::max(newest_timestamp_, commit_record->CommitTime());
+
+        // The changes of transactions that committed before the checkpoint was taken are in the checkpoint already
+        if (commit_record->CommitTime() < checkpoint_timestamp_) {
+          DeferRecordDeletes(log_record->TxnBegin(), true);
+          buffered_changes_map_.erase(log_record->TxnBegin());
+          deferred_action_manager_->RegisterDeferredAction([=] { delete[] reinterpret_cast<byte *>(log_record); });
+          break;
+        }
 
         // We defer all transactions initially
         deferred_txns_.insert(log_record->TxnBegin());
@@ -81,6 +103,7 @@ void RecoveryManager::RecoverFromLogs() {
   }
   // Process all deferred txns
   ProcessDeferredTransactions(transaction::INVALID_TXN_TIMESTAMP);
+  ReplayBatch();
   TERRIER_ASSERT(deferred_txns_.empty(), "We should have no unprocessed deferred transactions at the end of recovery");
 
   // If we have unprocessed buffered changes, then these transactions were in-process at the time of system shutdown.
@@ -94,18 +117,39 @@ void RecoveryManager::RecoverFromLogs() {
 }
 
 void RecoveryManager::ProcessCommittedTransaction(terrier::transaction::timestamp_t txn_id) {
+  auto changes = std::move(buffered_changes_map_[txn_id]);
+  buffered_changes_map_.erase(txn_id);
+
+  // Transactions that change the catalog are replayed on their own, as the changes that follow them may depend on them
+  const bool changes_catalog = std::any_of(changes.cbegin(), changes.cend(), [](const auto &change) {
+    const LogRecord *record = change.first;
+    return IsCatalogTable(record->RecordType() == LogRecordType::REDO
+                              ? record->GetUnderlyingRecordBodyAs<RedoRecord>()->GetTableOid()
+                              : record->GetUnderlyingRecordBodyAs<DeleteRecord>()->GetTableOid());
+  });
+  if (num_replay_threads_ == 1 || changes_catalog) {
+    ReplayBatch();
+    ReplayTransaction(&changes);
+    return;
+  }
+
+  replay_batch_.emplace_back(txn_id, std::move(changes));
+  if (replay_batch_.size() == REPLAY_BATCH_SIZE) ReplayBatch();
+}
+
+void RecoveryManager::ReplayTransaction(std::vector<std::pair<LogRecord *, std::vector<byte *>>> *buffered_changes) {
   // Begin a txn to replay changes with.
   auto *txn = txn_manager_->BeginTransaction();
 
   // Apply all buffered changes. They should all succeed. After applying we can safely delete the record
-  for (uint32_t idx = 0; idx < buffered_changes_map_[txn_id].size(); idx++) {
-    auto *buffered_record = buffered_changes_map_[txn_id][idx].first;
+  for (uint32_t idx = 0; idx < buffered_changes->size(); idx++) {
+    auto *buffered_record = (*buffered_changes)[idx].first;
     TERRIER_ASSERT(
         buffered_record->RecordType() == LogRecordType::REDO || buffered_record->RecordType() == LogRecordType::DELETE,
         "Buffered record must be a redo or delete.");
 
     if (IsSpecialCaseCatalogRecord(buffered_record)) {
-      idx += ProcessSpecialCaseCatalogRecord(txn, &buffered_changes_map_[txn_id], idx);
+      idx += ProcessSpecialCaseCatalogRecord(txn, buffered_changes, idx);
     } else if (buffered_record->RecordType() == LogRecordType::REDO) {
       ReplayRedoRecord(txn, buffered_record);
     } else {
@@ -114,16 +158,118 @@ void RecoveryManager::ProcessCommittedTransaction(terrier::transaction::timestam
   }
 
   // Defer deletes of the log records
-  DeferRecordDeletes(txn_id, false);
-  buffered_changes_map_.erase(txn_id);
+  DeferRecordDeletes(std::move(*buffered_changes), false);
 
   // Commit the txn
   txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
 }
 
-void RecoveryManager::DeferRecordDeletes(terrier::transaction::timestamp_t txn_id, bool delete_varlens) {
+void RecoveryManager::ReplayBatch() {
+  if (replay_batch_.empty()) return;
+
+  // Transactions that touch the same tuple, or the same table if its indexes are maintained, go into the same group. A
+  // group is identified by the index of one of its transactions in the batch, found by following parent_ to the root.
+  std::vector<uint32_t> parent(replay_batch_.size());
+  std::iota(parent.begin(), parent.end(), 0);
+  const auto find = [&](uint32_t txn_idx) {
+    while (parent[txn_idx] != txn_idx) txn_idx = parent[txn_idx] = parent[parent[txn_idx]];
+    return txn_idx;
+  };
+  std::unordered_map<TupleSlot, uint32_t> slot_owners;
+  std::unordered_map<uint64_t, uint32_t> table_owners;
+  const auto claim = [&](auto *owners, const auto key, const uint32_t txn_idx) {
+    const auto it = owners->emplace(key, txn_idx).first;
+    const uint32_t root = find(it->second), txn_root = find(txn_idx);
+    // Point to the earlier transaction, so that the root of a group is its first transaction
+    if (root < txn_root) parent[txn_root] = root;
+    if (txn_root < root) parent[root] = txn_root;
+  };
+  for (uint32_t txn_idx = 0; txn_idx < replay_batch_.size(); txn_idx++) {
+    for (const auto &change : replay_batch_[txn_idx].second) {
+      const LogRecord *record = change.first;
+      catalog::db_oid_t db_oid;
+      catalog::table_oid_t table_oid;
+      TupleSlot slot;
+      if (record->RecordType() == LogRecordType::REDO) {
+        const auto *redo_record = record->GetUnderlyingRecordBodyAs<RedoRecord>();
+        db_oid = redo_record->GetDatabaseOid();
+        table_oid = redo_record->GetTableOid();
+        slot = redo_record->GetTupleSlot();
+      } else {
+        const auto *delete_record = record->GetUnderlyingRecordBodyAs<DeleteRecord>();
+        db_oid = delete_record->GetDatabaseOid();
+        table_oid = delete_record->GetTableOid();
+        slot = delete_record->GetTupleSlot();
+      }
+      if (MaintainsIndexes(table_oid)) {
+        claim(&table_owners, (static_cast<uint64_t>(db_oid.UnderlyingValue()) << 32) | table_oid.UnderlyingValue(),
+              txn_idx);
+      } else {
+        claim(&slot_owners, slot, txn_idx);
+      }
+    }
+  }
+
+  // Deal out whole groups to the replay threads, keeping the transactions of each in the order they committed
+  std::vector<std::vector<uint32_t>> bins(num_replay_threads_);
+  std::unordered_map<uint32_t, uint32_t> group_bins;
+  for (uint32_t txn_idx = 0; txn_idx < replay_batch_.size(); txn_idx++) {
+    const auto it = group_bins.emplace(find(txn_idx), static_cast<uint32_t>(group_bins.size() % bins.size())).first;
+    bins[it->second].push_back(txn_idx);
+  }
+  for (const auto &bin : bins) {
+    if (bin.empty()) continue;
+    replay_pool_.SubmitTask([this, &bin] {
+      for (const uint32_t txn_idx : bin) ReplayTransaction(&replay_batch_[txn_idx].second);
+    });
+  }
+  replay_pool_.WaitUntilAllFinished();
+  replay_batch_.clear();
+}
+
+void RecoveryManager::RebuildDeferredIndexes() {
+  for (const auto &table : deferred_index_tables_) {
+    replay_pool_.SubmitTask([this, table] { RebuildIndexesOnTable(table.first, table.second); });
+  }
+  replay_pool_.WaitUntilAllFinished();
+  deferred_index_tables_.clear();
+}
+
+void RecoveryManager::RebuildIndexesOnTable(const catalog::db_oid_t db_oid, const catalog::table_oid_t table_oid) {
+  auto *txn = txn_manager_->BeginTransaction();
+  // The table, or its database, may have been dropped later on in the log
+  auto db_catalog_ptr = catalog_->GetDatabaseCatalog(common::ManagedPointer(txn), db_oid);
+  auto table_ptr = db_catalog_ptr == nullptr ? nullptr : db_catalog_ptr->GetTable(common::ManagedPointer(txn), table_oid);
+  if (table_ptr == nullptr) {
+    txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+    return;
+  }
+  const auto index_objects = db_catalog_ptr->GetIndexes(common::ManagedPointer(txn), table_oid);
+
+  if (!index_objects.empty()) {
+    std::vector<catalog::col_oid_t> all_table_oids;
+    for (const auto &col : GetTableSchema(txn, db_catalog_ptr, table_oid).GetColumns()) {
+      all_table_oids.push_back(col.Oid());
+    }
+    auto initializer = table_ptr->InitializerForProjectedRow(all_table_oids);
+    auto pr_map = table_ptr->ProjectionMapForOids(all_table_oids);
+    auto *buffer = common::AllocationUtil::AllocateAligned(initializer.ProjectedRowSize());
+    auto *pr = initializer.InitializeRow(buffer);
+    for (auto it = table_ptr->begin(); it != table_ptr->end(); it++) {
+      // Skips tuples that were deleted later on in the log
+      if (table_ptr->Select(common::ManagedPointer(txn), *it, pr)) {
+        UpdateIndexes(txn, index_objects, pr_map, *it, pr, true /* insert */);
+      }
+    }
+    delete[] buffer;
+  }
+  txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+}
+
+void RecoveryManager::DeferRecordDeletes(std::vector<std::pair<LogRecord *, std::vector<byte *>>> &&buffered_changes,
+                                         bool delete_varlens) {
   // Capture the changes by value except for changes which we can move
-  deferred_action_manager_->RegisterDeferredAction([=, buffered_changes{std::move(buffered_changes_map_[txn_id])}]() {
+  deferred_action_manager_->RegisterDeferredAction([=, buffered_changes{std::move(buffered_changes)}]() {
     for (auto &buffered_pair : buffered_changes) {
       delete[] reinterpret_cast<byte *>(buffered_pair.first);
       if (delete_varlens) {
@@ -169,14 +315,24 @@ void RecoveryManager::ReplayRedoRecord(transaction::TransactionContext *txn, Log
                    "ProjectedRow of original and staged records must be identical");
     // Insert will always succeed
     auto new_tuple_slot = sql_table_ptr->Insert(common::ManagedPointer(txn), staged_record);
-    UpdateIndexesOnTable(txn, staged_record->GetDatabaseOid(), staged_record->GetTableOid(), sql_table_ptr,
-                         new_tuple_slot, staged_record->Delta(), true /* insert */);
+    if (MaintainsIndexes(staged_record->GetTableOid())) {
+      UpdateIndexesOnTable(txn, staged_record->GetDatabaseOid(), staged_record->GetTableOid(), sql_table_ptr,
+                           new_tuple_slot, staged_record->Delta(), true /* insert */);
+    }
     TERRIER_ASSERT(staged_record->GetTupleSlot() == new_tuple_slot,
                    "Insert should update redo record with new tuple slot");
     // Create a mapping of the old to new tuple. The new tuple slot should be used for future updates and deletes.
+    common::SpinLatch::ScopedSpinLatch guard(&tuple_slot_map_latch_);
     tuple_slot_map_[old_tuple_slot] = new_tuple_slot;
+    if (!MaintainsIndexes(staged_record->GetTableOid())) {
+      deferred_index_tables_.emplace(staged_record->GetDatabaseOid(), staged_record->GetTableOid());
+    }
   } else {
-    auto new_tuple_slot = tuple_slot_map_[redo_record->GetTupleSlot()];
+    TupleSlot new_tuple_slot;
+    {
+      common::SpinLatch::ScopedSpinLatch guard(&tuple_slot_map_latch_);
+      new_tuple_slot = tuple_slot_map_[redo_record->GetTupleSlot()];
+    }
     redo_record->SetTupleSlot(new_tuple_slot);
     // Stage the write. This way the recovery operation is logged if logging is enabled
     auto staged_record = txn->StageRecoveryWrite(record);
@@ -190,14 +346,24 @@ void RecoveryManager::ReplayDeleteRecord(transaction::TransactionContext *txn, L
   auto *delete_record = record->GetUnderlyingRecordBodyAs<DeleteRecord>();
   // Get tuple slot
   auto new_tuple_slot = GetTupleSlotMapping(delete_record->GetTupleSlot());
-  auto db_catalog_ptr = GetDatabaseCatalog(txn, delete_record->GetDatabaseOid());
-  auto sql_table_ptr = db_catalog_ptr->GetTable(common::ManagedPointer(txn), delete_record->GetTableOid());
-  const auto &schema = GetTableSchema(txn, db_catalog_ptr, delete_record->GetTableOid());
+  auto sql_table_ptr = GetSqlTable(txn, delete_record->GetDatabaseOid(), delete_record->GetTableOid());
 
   // Stage the delete. This way the recovery operation is logged if logging is enabled
   txn->StageDelete(delete_record->GetDatabaseOid(), delete_record->GetTableOid(), new_tuple_slot);
 
+  // Deferred indexes are rebuilt from what is left in the table, so there is nothing to delete from them
+  if (!MaintainsIndexes(delete_record->GetTableOid())) {
+    bool result UNUSED_ATTRIBUTE = sql_table_ptr->Delete(common::ManagedPointer(txn), new_tuple_slot);
+    TERRIER_ASSERT(result, "Buffered changes should always succeed during commit");
+    common::SpinLatch::ScopedSpinLatch guard(&tuple_slot_map_latch_);
+    tuple_slot_map_.erase(delete_record->GetTupleSlot());
+    return;
+  }
+
   // Fetch all the values so we can construct index keys after deleting from the sql table
+  auto db_catalog_ptr = GetDatabaseCatalog(txn, delete_record->GetDatabaseOid(),
+                                           IsCatalogTable(delete_record->GetTableOid()));
+  const auto &schema = GetTableSchema(txn, db_catalog_ptr, delete_record->GetTableOid());
   std::vector<catalog::col_oid_t> all_table_oids;
   for (const auto &col : schema.GetColumns()) {
     all_table_oids.push_back(col.Oid());
@@ -215,6 +381,7 @@ void RecoveryManager::ReplayDeleteRecord(transaction::TransactionContext *txn, L
   UpdateIndexesOnTable(txn, delete_record->GetDatabaseOid(), delete_record->GetTableOid(), sql_table_ptr,
                        new_tuple_slot, pr, false /* delete */);
   // We can delete the TupleSlot from the map
+  common::SpinLatch::ScopedSpinLatch guard(&tuple_slot_map_latch_);
   tuple_slot_map_.erase(delete_record->GetTupleSlot());
   delete[] buffer;
 }
@@ -223,7 +390,7 @@ void RecoveryManager::UpdateIndexesOnTable(transaction::TransactionContext *txn,
                                            catalog::table_oid_t table_oid,
                                            common::ManagedPointer<storage::SqlTable> table_ptr,
                                            const TupleSlot &tuple_slot, ProjectedRow *table_pr, const bool insert) {
-  auto db_catalog_ptr = GetDatabaseCatalog(txn, db_oid);
+  auto db_catalog_ptr = GetDatabaseCatalog(txn, db_oid, IsCatalogTable(table_oid));
 
   // Stores index objects and schemas
   std::vector<std::pair<common::ManagedPointer<index::Index>, const catalog::IndexSchema &>> index_objects;
@@ -318,14 +485,6 @@ void RecoveryManager::UpdateIndexesOnTable(transaction::TransactionContext *txn,
   // If there's no indexes on the table, we can return
   if (index_objects.empty()) return;
 
-  // Compute largest PR size we need for index PRs.
-  uint32_t max_index_key_pr_size = 0;
-  for (const auto &index_obj : index_objects) {
-    max_index_key_pr_size =
-        std::max(max_index_key_pr_size, index_obj.first->GetProjectedRowInitializer().ProjectedRowSize());
-  }
-  auto *index_buffer = common::AllocationUtil::AllocateAligned(max_index_key_pr_size);
-
   // Build a PR map for all columns in the table, as the table pr should have values for every column
   const auto &table_schema = GetTableSchema(txn, db_catalog_ptr, table_oid);
   std::vector<catalog::col_oid_t> all_table_oids;
@@ -335,6 +494,21 @@ void RecoveryManager::UpdateIndexesOnTable(transaction::TransactionContext *txn,
   auto pr_map = table_ptr->ProjectionMapForOids(all_table_oids);
   TERRIER_ASSERT(pr_map.size() == table_pr->NumColumns(), "Projected row should contain all attributes");
 
+  UpdateIndexes(txn, index_objects, pr_map, tuple_slot, table_pr, insert);
+}
+
+void RecoveryManager::UpdateIndexes(
+    transaction::TransactionContext *txn,
+    const std::vector<std::pair<common::ManagedPointer<index::Index>, const catalog::IndexSchema &>> &index_objects,
+    const ProjectionMap &pr_map, const TupleSlot &tuple_slot, const ProjectedRow *table_pr, const bool insert) {
+  // Compute largest PR size we need for index PRs.
+  uint32_t max_index_key_pr_size = 0;
+  for (const auto &index_obj : index_objects) {
+    max_index_key_pr_size =
+        std::max(max_index_key_pr_size, index_obj.first->GetProjectedRowInitializer().ProjectedRowSize());
+  }
+  auto *index_buffer = common::AllocationUtil::AllocateAligned(max_index_key_pr_size);
+
   // TODO(Gus): We are going to assume no indexes on expressions below. Having indexes on expressions would require to
   // evaluate expressions and that's a nightmare
   for (const auto &index_obj : index_objects) {
@@ -352,12 +526,12 @@ void RecoveryManager::UpdateIndexesOnTable(transaction::TransactionContext *txn,
       const auto &col = schema.GetColumn(col_idx);
       auto index_col_oid = col.Oid();
       const catalog::col_oid_t &table_col_oid = indexed_attributes[col_idx];
-      if (table_pr->IsNull(pr_map[table_col_oid])) {
+      if (table_pr->IsNull(pr_map.at(table_col_oid))) {
         index_pr->SetNull(index->GetKeyOidToOffsetMap().at(index_col_oid));
       } else {
         auto size = AttrSizeBytes(col.AttrSize());
         std::memcpy(index_pr->AccessForceNotNull(index->GetKeyOidToOffsetMap().at(index_col_oid)),
-                    table_pr->AccessWithNullCheck(pr_map[table_col_oid]), size);
+                    table_pr->AccessWithNullCheck(pr_map.at(table_col_oid)), size);
       }
     }
 
@@ -822,7 +996,7 @@ common::ManagedPointer<storage::SqlTable> RecoveryManager::GetSqlTable(transacti
     return common::ManagedPointer(catalog_->databases_);
   }
 
-  auto db_catalog_ptr = GetDatabaseCatalog(txn, db_oid);
+  auto db_catalog_ptr = GetDatabaseCatalog(txn, db_oid, IsCatalogTable(table_oid));
 
   common::ManagedPointer<storage::SqlTable> table_ptr = nullptr;
 
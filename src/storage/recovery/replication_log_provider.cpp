@@ -0,0 +1,59 @@
+#include "storage/recovery/replication_log_provider.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include "loggers/storage_logger.h"
+
+namespace terrier::storage {
+
+void ReplicationLogProvider::HandBufferToReplication(const uint64_t message_id,
+                                                     std::unique_ptr<network::ReadBuffer> buffer) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Resent after a reconnect, or arriving after replication ended
+    if (ended_ || message_id < next_message_id_) return;
+    if (message_id > next_message_id_) {
+      STORAGE_LOG_ERROR("Replication message {} is missing, ending replication", next_message_id_);
+      ended_ = true;
+    } else {
+      next_message_id_++;
+      if (buffer->HasMore()) buffers_.emplace_back(std::move(buffer));
+    }
+  }
+  cv_.notify_all();
+}
+
+void ReplicationLogProvider::EndReplication() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ended_ = true;
+  }
+  cv_.notify_all();
+}
+
+bool ReplicationLogProvider::HasMoreRecords() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [&] { return !buffers_.empty() || ended_; });
+  return !buffers_.empty();
+}
+
+bool ReplicationLogProvider::Read(void *const dest, uint32_t size) {
+  auto *out = reinterpret_cast<byte *>(dest);
+  std::unique_lock<std::mutex> lock(mutex_);
+  // A read may span several messages, as records are not aligned to them
+  while (size > 0) {
+    cv_.wait(lock, [&] { return !buffers_.empty() || ended_; });
+    if (buffers_.empty()) return false;
+    network::ReadBuffer &buffer = *buffers_.front();
+    const auto bytes = static_cast<uint32_t>(std::min<size_t>(size, buffer.BytesAvailable()));
+    buffer.ReadIntoView(bytes).Read(bytes, out);
+    out += bytes;
+    size -= bytes;
+    if (!buffer.HasMore()) buffers_.pop_front();
+  }
+  return true;
+}
+
+}  // namespace terrier::storage
@@ -1,9 +1,13 @@
 #include "storage/write_ahead_log/disk_log_consumer_task.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "common/resource_tracker.h"
 #include "common/scoped_timer.h"
 #include "common/thread_context.h"
 #include "metrics/metrics_store.h"
+#include "storage/write_ahead_log/log_manager.h"
 
 namespace terrier::storage {
 
@@ -24,39 +28,100 @@ void DiskLogConsumerTask::Terminate() {
 void DiskLogConsumerTask::WriteBuffersToLogFile() {
   // Persist all the filled buffers to the disk
   SerializedLogs logs;
+  std::vector<BufferedLogWriter *> filled_buffers;
   while (!filled_buffer_queue_->Empty()) {
-    // Dequeue filled buffers and flush them to disk, as well as storing commit callbacks
+    // Dequeue filled buffers, as well as storing commit callbacks
     filled_buffer_queue_->Dequeue(&logs);
     if (logs.first != nullptr) {
       // Need the nullptr check because read-only txns don't serialize any buffers, but generate callbacks to be invoked
-      current_data_written_ += logs.first->FlushBuffer();
+      filled_buffers.push_back(logs.first);
     }
+    // The first commit to arrive after a persist starts the clock on the next group
+    if (commit_callbacks_.empty() && !logs.second.empty())
+      oldest_waiting_commit_ = std::chrono::high_resolution_clock::now();
     commit_callbacks_.insert(commit_callbacks_.end(), logs.second.begin(), logs.second.end());
-    // Enqueue the flushed buffer to the empty buffer queue
-    if (logs.first != nullptr) {
-      // nullptr check for the same reason as above
-      empty_buffer_queue_->Enqueue(logs.first);
+  }
+  if (filled_buffers.empty()) return;
+
+  for (auto *const buffer : filled_buffers) current_segment_range_.Merge(*buffer->Range());
+  at_record_boundary_ = filled_buffers.back()->EndsAtRecordBoundary();
+
+  // Hold on to what to ship until it is persisted, as the buffers go back to the serializer right after the flush
+  if (log_shipper_ != nullptr) {
+    for (auto *const buffer : filled_buffers) {
+      const iovec data = buffer->BufferedData();
+      const auto *const begin = static_cast<const char *>(data.iov_base);
+      unshipped_log_.insert(unshipped_log_.end(), begin, begin + data.iov_len);
     }
   }
+
+  // Flush all the dequeued buffers to disk with a single write
+  const uint64_t data_written = BufferedLogWriter::FlushBuffers(filled_buffers.data(), filled_buffers.size());
+  current_data_written_ += data_written;
+  current_segment_size_ += data_written;
+  current_buffers_written_ += filled_buffers.size();
+  // Enqueue the flushed buffers to the empty buffer queue
+  for (auto *const buffer : filled_buffers) empty_buffer_queue_->Enqueue(buffer);
 }
 
-uint64_t DiskLogConsumerTask::PersistLogFile() {
+uint64_t DiskLogConsumerTask::PersistLogFile(uint64_t *const persist_latency) {
+  *persist_latency = 0;
   // buffers_ may be empty but we have callbacks to invoke due to read-only txns
   if (!buffers_->empty()) {
-    // Force the buffers to be written to disk. Because all buffers log to the same file, it suffices to call persist on
-    // any buffer.
-    buffers_->front().Persist();
+    {
+      common::ScopedTimer<std::chrono::microseconds> timer(persist_latency);
+      // Force the buffers to be written to disk. Because all buffers log to the same file, it suffices to call persist
+      // on any buffer.
+      buffers_->front().Persist();
+    }
+    // Weigh the latest persist by 1/8 so that a single slow persist does not throw off the group commit deadline
+    persist_latency_estimate_ = (7 * persist_latency_estimate_ + std::chrono::microseconds(*persist_latency)) / 8;
+  }
+  const auto num_commits = commit_callbacks_.size();
+  if (log_manager_ != nullptr) {
+    // With several log streams, a commit can only be acknowledged once the commits before it are persisted as well
+    log_manager_->CommitsPersisted(stream_id_, commit_callbacks_);
+  } else {
+    // Execute the callbacks for the transactions that have been persisted
+    for (auto &callback : commit_callbacks_) callback.fn_(callback.arg_);
   }
-  const auto num_buffers = commit_callbacks_.size();
-  // Execute the callbacks for the transactions that have been persisted
-  for (auto &callback : commit_callbacks_) callback.first(callback.second);
   commit_callbacks_.clear();
-  return num_buffers;
+  // Replicas only ever get log that the primary cannot lose anymore
+  if (log_shipper_ != nullptr) {
+    log_shipper_->Enqueue(std::move(unshipped_log_));
+    unshipped_log_.clear();
+  }
+  return num_commits;
+}
+
+void DiskLogConsumerTask::RotateSegment() {
+  const uint64_t next_segment_id = current_segment_id_ + 1;
+  const std::string next_segment_path = LogManager::SegmentFilePath(log_file_path_, next_segment_id);
+  // Start the next segment before sealing the current one, so that the log always ends in an unsealed segment
+  LogSegmentHeader header;
+  header.segment_id_ = next_segment_id;
+  header.Write(next_segment_path, direct_io_);
+  PosixIoWrappers::SyncParentDirectory(next_segment_path);
+  // Buffers held by the serializer are only written to by it, and never flushed by anyone but us, so it is safe to
+  // switch them over as well
+  for (auto &buffer : *buffers_) buffer.Reopen(next_segment_path.c_str());
+  SealSegment();
+  current_segment_id_ = next_segment_id;
+  current_segment_size_ = 0;
+  current_segment_range_ = LogRange();
+}
+
+void DiskLogConsumerTask::SealSegment() {
+  LogSegmentHeader header;
+  header.segment_id_ = current_segment_id_;
+  header.sealed_ = true;
+  header.range_ = current_segment_range_;
+  header.Write(LogManager::SegmentFilePath(log_file_path_, current_segment_id_), direct_io_);
 }
 
 void DiskLogConsumerTask::DiskLogConsumerTaskLoop() {
   // input for this operating unit
-  uint64_t num_bytes = 0, num_buffers = 0;
+  uint64_t num_bytes = 0, num_buffers = 0, num_commits = 0, persist_latency = 0;
 
   // Keeps track of how much data we've written to the log file since the last persist
   current_data_written_ = 0;
@@ -88,8 +153,15 @@ void DiskLogConsumerTask::DiskLogConsumerTaskLoop() {
       // 3) LogManager has shut down the task
       // 4) Our persist interval timed out
 
+      // In group commit mode, we also have to wake up in time to make the oldest waiting commit's deadline
+      auto wait = curr_sleep;
+      if (GroupCommitEnabled() && !commit_callbacks_.empty()) {
+        const auto until_deadline = std::chrono::duration_cast<std::chrono::microseconds>(
+            GroupCommitDeadline() - std::chrono::high_resolution_clock::now());
+        wait = std::max(std::min(wait, until_deadline), std::chrono::microseconds::zero());
+      }
       bool signaled = disk_log_writer_thread_cv_.wait_for(
-          lock, curr_sleep, [&] { return do_persist_ || !filled_buffer_queue_->Empty() || !run_task_; });
+          lock, wait, [&] { return do_persist_ || !filled_buffer_queue_->Empty() || !run_task_; });
       next_sleep = signaled ? persist_interval_ : curr_sleep * 2;
       next_sleep = std::min(next_sleep, max_sleep);
     }
@@ -102,33 +174,47 @@ void DiskLogConsumerTask::DiskLogConsumerTaskLoop() {
     // 2) We have written more data since the last persist than the threshold
     // 3) We are signaled to persist
     // 4) We are shutting down this task
-    bool timeout = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() -
-                                                                         last_persist) > curr_sleep;
+    // In group commit mode, 1) is replaced by
+    // 1a) Enough commits are waiting on the persist
+    // 1b) The oldest waiting commit would miss its target latency if we waited any longer
+    const auto now = std::chrono::high_resolution_clock::now();
+    bool timeout;
+    if (GroupCommitEnabled()) {
+      timeout = commit_callbacks_.size() >= group_commit_size_ ||
+                (!commit_callbacks_.empty() && now >= GroupCommitDeadline());
+    } else {
+      timeout = std::chrono::duration_cast<std::chrono::microseconds>(now - last_persist) > curr_sleep;
+    }
 
     if (timeout || current_data_written_ > persist_threshold_ || do_persist_ || !run_task_) {
       std::unique_lock<std::mutex> lock(persist_lock_);
-      num_buffers = PersistLogFile();
+      num_commits = PersistLogFile(&persist_latency);
+      if (segment_size_ > 0 && current_segment_size_ >= segment_size_ && at_record_boundary_) RotateSegment();
       num_bytes = current_data_written_;
+      num_buffers = current_buffers_written_;
       // Reset meta data
       last_persist = std::chrono::high_resolution_clock::now();
       current_data_written_ = 0;
+      current_buffers_written_ = 0;
       do_persist_ = false;
 
       // Signal anyone who forced a persist that the persist has finished
       persist_cv_.notify_all();
     }
 
-    if (logging_metrics_enabled && num_buffers > 0) {
+    if (logging_metrics_enabled && (num_buffers > 0 || num_commits > 0)) {
       // Stop the resource tracker for this operating unit
       common::thread_context.resource_tracker_.Stop();
       auto &resource_metrics = common::thread_context.resource_tracker_.GetMetrics();
-      common::thread_context.metrics_store_->RecordConsumerData(num_bytes, num_buffers, persist_interval_.count(),
-                                                                resource_metrics);
-      num_bytes = num_buffers = 0;
+      common::thread_context.metrics_store_->RecordConsumerData(num_bytes, num_buffers, num_commits, persist_latency,
+                                                                persist_interval_.count(), resource_metrics);
+      num_bytes = num_buffers = num_commits = persist_latency = 0;
     }
   } while (run_task_);
   // Be extra sure we processed everything
   WriteBuffersToLogFile();
-  PersistLogFile();
+  PersistLogFile(&persist_latency);
+  // The serializer has shut down before us, so the log ends at the end of a record and the segment is complete
+  if (segment_size_ > 0) SealSegment();
 }
 }  // namespace terrier::storage
@@ -1,5 +1,9 @@
 #include "storage/write_ahead_log/log_io.h"
+#include <dirent.h>
 #include <algorithm>
+#include <cctype>
+#include <climits>
+#include <limits>
 namespace terrier::storage {
 void PosixIoWrappers::Close(int fd) {
   while (true) {
@@ -38,6 +42,153 @@ void PosixIoWrappers::WriteFully(int fd, const void *buf, size_t nbyte) {
   }
 }
 
+void PosixIoWrappers::WriteVFully(int fd, std::vector<iovec> *iovs) {
+  size_t next = 0;
+  while (next < iovs->size()) {
+    const auto count = static_cast<int>(std::min<size_t>(iovs->size() - next, IOV_MAX));
+    ssize_t ret = writev(fd, iovs->data() + next, count);
+    if (ret == -1) {
+      if (errno == EINTR) continue;
+      throw std::runtime_error("Write to log file failed with errno " + std::to_string(errno));
+    }
+    // Skip over everything that was written, which can end in the middle of a buffer
+    auto written = static_cast<size_t>(ret);
+    while (next < iovs->size() && written >= (*iovs)[next].iov_len) written -= (*iovs)[next++].iov_len;
+    if (written > 0) {
+      (*iovs)[next].iov_base = reinterpret_cast<char *>((*iovs)[next].iov_base) + written;
+      (*iovs)[next].iov_len -= written;
+    }
+  }
+}
+
+int PosixIoWrappers::OpenDirect(const char *path, const int oflag, const mode_t mode) {
+  while (true) {
+    int ret = open(path, oflag | O_DIRECT, mode);
+    if (ret != -1) return ret;
+    if (errno == EINTR) continue;
+    if (errno != EINVAL) throw std::runtime_error("Failed to open file with errno " + std::to_string(errno));
+    // Some file systems (e.g. tmpfs) do not support direct I/O. Writes are still padded the same way, so the log
+    // file looks the same either way.
+    STORAGE_LOG_WARN("Log file {} does not support direct I/O, falling back to buffered I/O", path);
+    return Open(path, oflag, mode);
+  }
+}
+
+void PosixIoWrappers::SyncParentDirectory(const std::string &path) {
+  const auto slash = path.rfind('/');
+  const std::string directory = slash == std::string::npos ? "." : path.substr(0, slash + 1);
+  int fd = Open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+  if (fsync(fd) == -1) {
+    Close(fd);
+    throw std::runtime_error("fsync failed with errno " + std::to_string(errno));
+  }
+  Close(fd);
+}
+
+std::vector<uint64_t> PosixIoWrappers::ListNumberedFiles(const std::string &path_prefix) {
+  const auto slash = path_prefix.rfind('/');
+  const std::string directory = slash == std::string::npos ? "." : path_prefix.substr(0, slash + 1);
+  const std::string prefix = path_prefix.substr(slash + 1);
+  std::vector<uint64_t> numbers;
+  DIR *dir = opendir(directory.c_str());
+  if (dir == nullptr) throw std::runtime_error("Failed to open directory with errno " + std::to_string(errno));
+  while (const dirent *entry = readdir(dir)) {
+    const std::string name(entry->d_name);
+    if (name.size() <= prefix.size() || name.compare(0, prefix.size(), prefix) != 0) continue;
+    const std::string number = name.substr(prefix.size());
+    if (!std::all_of(number.begin(), number.end(), [](char c) { return std::isdigit(c); })) continue;
+    numbers.push_back(std::stoull(number));
+  }
+  closedir(dir);
+  std::sort(numbers.begin(), numbers.end());
+  return numbers;
+}
+
+void LogSegmentHeader::Write(const std::string &log_file_path, const bool direct_io) const {
+  // Aligned, so that it can be written with direct I/O
+  alignas(common::Constants::LOG_DIRECT_IO_ALIGNMENT) char block[SIZE_ON_DISK] = {};
+  static_assert(sizeof(LogSegmentHeader) <= SIZE_ON_DISK, "Log segment header must fit into its block");
+  std::memcpy(block, this, sizeof(LogSegmentHeader));
+  // Not opened for appending, so that we write over the old header of an existing segment
+  constexpr int oflag = O_WRONLY | O_CREAT;
+  int fd = direct_io ? PosixIoWrappers::OpenDirect(log_file_path.c_str(), oflag, S_IRUSR | S_IWUSR)
+                     : PosixIoWrappers::Open(log_file_path.c_str(), oflag, S_IRUSR | S_IWUSR);
+  PosixIoWrappers::WriteFully(fd, block, SIZE_ON_DISK);
+  if (fdatasync(fd) == -1) {
+    PosixIoWrappers::Close(fd);
+    throw std::runtime_error("fdatasync failed with errno " + std::to_string(errno));
+  }
+  PosixIoWrappers::Close(fd);
+}
+
+bool LogSegmentHeader::Read(const std::string &log_file_path, LogSegmentHeader *const header) {
+  char block[SIZE_ON_DISK];
+  int fd = PosixIoWrappers::Open(log_file_path.c_str(), O_RDONLY);
+  const uint32_t size = PosixIoWrappers::ReadFully(fd, block, SIZE_ON_DISK);
+  PosixIoWrappers::Close(fd);
+  if (size != SIZE_ON_DISK) return false;
+  std::memcpy(header, block, sizeof(LogSegmentHeader));
+  return header->magic_ == MAGIC;
+}
+
+int BufferedLogWriter::OpenLogFile(const char *log_file_path, const bool direct_io) {
+  constexpr int oflag = O_WRONLY | O_APPEND | O_CREAT;
+  return direct_io ? PosixIoWrappers::OpenDirect(log_file_path, oflag, S_IRUSR | S_IWUSR)
+                   : PosixIoWrappers::Open(log_file_path, oflag, S_IRUSR | S_IWUSR);
+}
+
+uint64_t BufferedLogWriter::FlushBuffers(BufferedLogWriter *const *writers, const size_t num_writers) {
+  if (num_writers == 0) return 0;
+  constexpr uint32_t alignment = common::Constants::LOG_DIRECT_IO_ALIGNMENT;
+  // Padding that does not fit into a buffer is taken from here
+  alignas(alignment) static const char zeros[alignment] = {};
+  static_assert(common::Constants::LOG_BUFFER_SIZE % alignment == 0, "A full log buffer must need no padding");
+
+  uint64_t size = 0;
+  std::vector<iovec> iovs;
+  iovs.reserve(2 * num_writers);
+  for (size_t i = 0; i < num_writers; i++) {
+    BufferedLogWriter *const writer = writers[i];
+    TERRIER_ASSERT(writer->direct_io_ == writers[0]->direct_io_, "All writers of a log file must use the same I/O");
+    writer->range_ = LogRange();
+    writer->ends_at_record_boundary_ = false;
+    if (writer->buffer_size_ == 0) continue;
+    size += writer->buffer_size_;
+    uint32_t padding = 0;
+    if (writer->direct_io_) {
+      padding = (alignment - writer->buffer_size_ % alignment) % alignment;
+      // The reader needs to be able to read a whole zero record size from the padding to recognize it
+      if (padding != 0 && padding < sizeof(uint32_t)) padding += alignment;
+    }
+    const uint32_t padding_in_buffer = std::min(padding, common::Constants::LOG_BUFFER_SIZE - writer->buffer_size_);
+    std::memset(writer->buffer_ + writer->buffer_size_, 0, padding_in_buffer);
+    iovs.push_back({writer->buffer_, writer->buffer_size_ + padding_in_buffer});
+    if (padding > padding_in_buffer) iovs.push_back({const_cast<char *>(zeros), padding - padding_in_buffer});
+    writer->buffer_size_ = 0;
+  }
+  if (iovs.empty()) return 0;
+
+  // All writers append to the same log file, so it does not matter which of their descriptors we write through
+  PosixIoWrappers::WriteVFully(writers[0]->out_, &iovs);
+  if (writers[0]->direct_io_) writers[0]->Preallocate();
+  return size;
+}
+
+void BufferedLogWriter::Preallocate() {
+  const off_t end = lseek(out_, 0, SEEK_END);
+  if (end == -1) throw std::runtime_error("lseek failed with errno " + std::to_string(errno));
+  // Reserve the next chunk when we are half way through the current one
+  if (static_cast<uint64_t>(end) + common::Constants::LOG_PREALLOCATION_SIZE / 2 <= preallocated_end_) return;
+  // Keep the file size as is, so that readers never see the reserved space as part of the log
+  if (fallocate(out_, FALLOC_FL_KEEP_SIZE, end, common::Constants::LOG_PREALLOCATION_SIZE) == -1) {
+    // This is only an optimization, so we give up on it rather than failing the write
+    STORAGE_LOG_WARN("Failed to preallocate log file with errno {}", errno);
+    preallocated_end_ = std::numeric_limits<uint64_t>::max();
+    return;
+  }
+  preallocated_end_ = static_cast<uint64_t>(end) + common::Constants::LOG_PREALLOCATION_SIZE;
+}
+
 bool BufferedLogReader::Read(void *dest, uint32_t size) {
   if (read_head_ + size <= filled_size_) {
     // bytes to read are already buffered.
@@ -56,6 +207,15 @@ bool BufferedLogReader::Read(void *dest, uint32_t size) {
   return true;
 }
 
+bool BufferedLogReader::SkipPadding() {
+  constexpr uint32_t alignment = common::Constants::LOG_DIRECT_IO_ALIGNMENT;
+  // The zero record size that started the padding has already been read, and the padding may have been extended
+  // through the next aligned offset if it could not fit a record size before it
+  uint32_t padding = static_cast<uint32_t>((alignment - offset_ % alignment) % alignment);
+  char discard[alignment];
+  return Read(discard, padding) && HasMore();
+}
+
 void BufferedLogReader::RefillBuffer() {
   TERRIER_ASSERT(read_head_ == filled_size_, "Refilling a buffer that is not fully read results in loss of data");
   if (in_ == -1) throw std::runtime_error("No more bytes left in the log file");
@@ -1,5 +1,12 @@
 #include "storage/write_ahead_log/log_manager.h"
 
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <vector>
+
 #include "common/dedicated_thread_registry.h"
 #include "storage/write_ahead_log/disk_log_consumer_task.h"
 #include "storage/write_ahead_log/log_serializer_task.h"
@@ -9,37 +16,123 @@ namespace terrier::storage {
 
 void LogManager::Start() {
   TERRIER_ASSERT(!run_log_manager_, "Can't call Start on already started LogManager");
-  // Initialize buffers for logging
-  for (size_t i = 0; i < num_buffers_; i++) {
-    buffers_.emplace_back(BufferedLogWriter(log_file_path_.c_str()));
-  }
-  for (size_t i = 0; i < num_buffers_; i++) {
-    empty_buffer_queue_.Enqueue(&buffers_[i]);
+  if (log_shipper_ != nullptr && num_streams_ > 1)
+    throw std::runtime_error("Only a single log stream can be shipped to replicas");
+  if (!started_ && segment_size_ == 0) RotateEarlierRun();
+  started_ = true;
+  for (uint32_t i = 0; i < num_streams_; i++) {
+    auto *stream = streams_.emplace_back(std::make_unique<LogStream>(StreamFilePath(log_file_path_, i))).get();
+    if (segment_size_ > 0) {
+      // Always start a new segment, so that segments written before a restart are never appended to
+      const auto segments = ListSegments(stream->log_file_path_);
+      stream->first_segment_id_ = segments.empty() ? 0 : segments.back() + 1;
+      const std::string segment_path = SegmentFilePath(stream->log_file_path_, stream->first_segment_id_);
+      LogSegmentHeader header;
+      header.segment_id_ = stream->first_segment_id_;
+      header.Write(segment_path, direct_io_);
+      PosixIoWrappers::SyncParentDirectory(segment_path);
+    }
+    // Initialize buffers for logging
+    const std::string log_file_path =
+        segment_size_ > 0 ? SegmentFilePath(stream->log_file_path_, stream->first_segment_id_) : stream->log_file_path_;
+    for (size_t j = 0; j < num_buffers_; j++) {
+      stream->buffers_.emplace_back(BufferedLogWriter(log_file_path.c_str(), direct_io_));
+    }
+    for (size_t j = 0; j < num_buffers_; j++) {
+      stream->empty_buffer_queue_.Enqueue(&stream->buffers_[j]);
+    }
   }
 
   run_log_manager_ = true;
 
-  // Register DiskLogConsumerTask
-  disk_log_writer_task_ = thread_registry_->RegisterDedicatedThread<DiskLogConsumerTask>(
-      this /* requester */, persist_interval_, persist_threshold_, &buffers_, &empty_buffer_queue_,
-      &filled_buffer_queue_);
+  // With a single stream, there are no other streams for a commit to wait on
+  const auto commit_tracker =
+      streams_.size() > 1 ? common::ManagedPointer<LogManager>(this) : common::ManagedPointer<LogManager>(nullptr);
+  for (uint32_t i = 0; i < streams_.size(); i++) {
+    auto &stream = streams_[i];
+    // Register DiskLogConsumerTask
+    stream->disk_log_writer_task_ = thread_registry_->RegisterDedicatedThread<DiskLogConsumerTask>(
+        this /* requester */, persist_interval_, persist_threshold_, group_commit_latency_, group_commit_size_,
+        stream->log_file_path_, segment_size_, stream->first_segment_id_, direct_io_, &stream->buffers_,
+        &stream->empty_buffer_queue_, &stream->filled_buffer_queue_, log_shipper_, commit_tracker, i);
 
-  // Register LogSerializerTask
-  log_serializer_task_ = thread_registry_->RegisterDedicatedThread<LogSerializerTask>(
-      this /* requester */, serialization_interval_, buffer_pool_, &empty_buffer_queue_, &filled_buffer_queue_,
-      &disk_log_writer_task_->disk_log_writer_thread_cv_);
+    // Register LogSerializerTask
+    stream->log_serializer_task_ = thread_registry_->RegisterDedicatedThread<LogSerializerTask>(
+        this /* requester */, serialization_interval_, buffer_pool_, &stream->empty_buffer_queue_,
+        &stream->filled_buffer_queue_, &stream->disk_log_writer_task_->disk_log_writer_thread_cv_);
+  }
 }
 
 void LogManager::ForceFlush() {
-  // Force the serializer task to serialize buffers
-  log_serializer_task_->Process();
-  // Signal the disk log consumer task thread to persist the buffers to disk
-  std::unique_lock<std::mutex> lock(disk_log_writer_task_->persist_lock_);
-  disk_log_writer_task_->do_persist_ = true;
-  disk_log_writer_task_->disk_log_writer_thread_cv_.notify_one();
+  // Force the serializer tasks to serialize buffers
+  for (auto &stream : streams_) stream->log_serializer_task_->Process();
+  // Signal the disk log consumer task threads to persist the buffers to disk. We signal all of them before waiting on
+  // any, so the streams persist in parallel.
+  for (auto &stream : streams_) RequestPersist(stream.get());
+  // Wait for the disk log consumer task threads to persist the logs
+  for (auto &stream : streams_) AwaitPersist(stream.get());
+}
 
-  // Wait for the disk log consumer task thread to persist the logs
-  disk_log_writer_task_->persist_cv_.wait(lock, [&] { return !disk_log_writer_task_->do_persist_; });
+void LogManager::TestForceFlushStream(const uint32_t stream_id) {
+  LogStream *const stream = streams_[stream_id].get();
+  stream->log_serializer_task_->Process();
+  RequestPersist(stream);
+  AwaitPersist(stream);
+}
+
+void LogManager::RequestPersist(LogStream *const stream) {
+  std::unique_lock<std::mutex> lock(stream->disk_log_writer_task_->persist_lock_);
+  stream->disk_log_writer_task_->do_persist_ = true;
+  stream->disk_log_writer_task_->disk_log_writer_thread_cv_.notify_one();
+}
+
+void LogManager::AwaitPersist(LogStream *const stream) {
+  auto *const task = stream->disk_log_writer_task_.Get();
+  std::unique_lock<std::mutex> lock(task->persist_lock_);
+  task->persist_cv_.wait(lock, [&] { return !task->do_persist_; });
+}
+
+transaction::timestamp_t LogManager::CheckOutCommitTimestamp(const transaction::timestamp_t txn_begin,
+                                                             transaction::TimestampManager *const timestamp_manager) {
+  if (streams_.size() <= 1) return timestamp_manager->CheckOutTimestamp();
+  // The timestamp is checked out under the stream's latch, so that anyone who looks at the stream's unpersisted commits
+  // after we have our timestamp sees it, and anyone who looked before can only be waiting on older commits than ours.
+  LogStream *const stream = streams_[StreamOf(txn_begin)].get();
+  common::SpinLatch::ScopedSpinLatch guard(&stream->commits_latch_);
+  const transaction::timestamp_t commit_time = timestamp_manager->CheckOutTimestamp();
+  stream->unpersisted_commits_.insert(commit_time);
+  return commit_time;
+}
+
+void LogManager::CommitsPersisted(const uint32_t stream_id, const std::vector<CommitCallback> &commits) {
+  if (commits.empty()) return;
+  LogStream *const stream = streams_[stream_id].get();
+  {
+    common::SpinLatch::ScopedSpinLatch guard(&stream->commits_latch_);
+    for (const auto &commit : commits) {
+      TERRIER_ASSERT(stream->unpersisted_commits_.count(commit.commit_time_) == 1,
+                     "Every commit in a stream should have checked out its timestamp from the log manager");
+      stream->unpersisted_commits_.erase(commit.commit_time_);
+    }
+  }
+
+  std::vector<CommitCallback> acknowledged;
+  {
+    common::SpinLatch::ScopedSpinLatch guard(&persisted_commits_latch_);
+    persisted_commits_.insert(persisted_commits_.end(), commits.begin(), commits.end());
+    // Every commit before the oldest one still unpersisted in any stream is now persisted
+    transaction::timestamp_t watermark(std::numeric_limits<uint64_t>::max());
+    for (auto &other : streams_) {
+      common::SpinLatch::ScopedSpinLatch stream_guard(&other->commits_latch_);
+      if (!other->unpersisted_commits_.empty()) watermark = std::min(watermark, *other->unpersisted_commits_.begin());
+    }
+    const auto waiting = std::partition(persisted_commits_.begin(), persisted_commits_.end(),
+                                        [=](const CommitCallback &commit) { return commit.commit_time_ < watermark; });
+    acknowledged.assign(persisted_commits_.begin(), waiting);
+    persisted_commits_.erase(persisted_commits_.begin(), waiting);
+  }
+  // Execute the callbacks for the transactions that are now durable, outside of the latch since they can take a while
+  for (auto &callback : acknowledged) callback.fn_(callback.arg_);
 }
 
 void LogManager::PersistAndStop() {
@@ -49,27 +142,110 @@ void LogManager::PersistAndStop() {
   // Signal all tasks to stop. The shutdown of the tasks will trigger any remaining logs to be serialized, writen to the
   // log file, and persisted. The order in which we shut down the tasks is important, we must first serialize, then
   // shutdown the disk consumer task (reverse order of Start())
-  auto result UNUSED_ATTRIBUTE =
-      thread_registry_->StopTask(this, log_serializer_task_.CastManagedPointerTo<common::DedicatedThreadTask>());
-  TERRIER_ASSERT(result, "LogSerializerTask should have been stopped");
+  for (auto &stream : streams_) {
+    auto result UNUSED_ATTRIBUTE = thread_registry_->StopTask(
+        this, stream->log_serializer_task_.CastManagedPointerTo<common::DedicatedThreadTask>());
+    TERRIER_ASSERT(result, "LogSerializerTask should have been stopped");
 
-  result = thread_registry_->StopTask(this, disk_log_writer_task_.CastManagedPointerTo<common::DedicatedThreadTask>());
-  TERRIER_ASSERT(result, "DiskLogConsumerTask should have been stopped");
-  TERRIER_ASSERT(filled_buffer_queue_.Empty(), "disk log consumer task should have processed all filled buffers\n");
+    result = thread_registry_->StopTask(
+        this, stream->disk_log_writer_task_.CastManagedPointerTo<common::DedicatedThreadTask>());
+    TERRIER_ASSERT(result, "DiskLogConsumerTask should have been stopped");
+    TERRIER_ASSERT(stream->filled_buffer_queue_.Empty(),
+                   "disk log consumer task should have processed all filled buffers\n");
 
-  // Close the buffers corresponding to the log file
-  for (auto buf : buffers_) {
-    buf.Close();
+    // Close the buffers corresponding to the log file
+    for (auto buf : stream->buffers_) {
+      buf.Close();
+    }
   }
-  // Clear buffer queues
-  empty_buffer_queue_.Clear();
-  filled_buffer_queue_.Clear();
-  buffers_.clear();
+  // Dropping the streams clears their buffer queues
+  streams_.clear();
+}
+
+void LogManager::RotateEarlierRun() {
+  uint32_t num_earlier_streams = 0;
+  while (access(StreamFilePath(log_file_path_, num_earlier_streams).c_str(), F_OK) == 0) num_earlier_streams++;
+  if (num_earlier_streams == 0 || (num_earlier_streams == 1 && num_streams_ == 1)) return;
+
+  const auto runs = ListRotatedRuns(log_file_path_);
+  const std::string run_file_path = RunFilePath(log_file_path_, runs.empty() ? 0 : runs.back() + 1);
+  for (uint32_t i = 0; i < num_earlier_streams; i++) {
+    if (rename(StreamFilePath(log_file_path_, i).c_str(), StreamFilePath(run_file_path, i).c_str()) == -1)
+      throw std::runtime_error("Failed to rotate log file with errno " + std::to_string(errno));
+  }
+  PosixIoWrappers::SyncParentDirectory(log_file_path_);
+}
+
+std::vector<uint64_t> LogManager::ListRotatedRuns(const std::string &log_file_path) {
+  return PosixIoWrappers::ListNumberedFiles(log_file_path + RUN_SUFFIX);
+}
+
+std::vector<uint64_t> LogManager::ListSegments(const std::string &stream_file_path) {
+  return PosixIoWrappers::ListNumberedFiles(stream_file_path + SEGMENT_SUFFIX);
+}
+
+uint64_t LogManager::DiscardSegments(const transaction::timestamp_t oldest_needed_txn) {
+  uint64_t num_discarded = DiscardEarlierRuns();
+  if (segment_size_ == 0) return num_discarded;
+  for (auto &stream : streams_) {
+    const uint64_t num_discarded_before = num_discarded;
+    const uint64_t current_segment_id = stream->disk_log_writer_task_->current_segment_id_;
+    for (const uint64_t segment_id : ListSegments(stream->log_file_path_)) {
+      // Segments are needed in order, so we stop at the first one that is
+      if (segment_id >= current_segment_id) break;
+      const std::string segment_path = SegmentFilePath(stream->log_file_path_, segment_id);
+      LogSegmentHeader header;
+      if (segment_id >= stream->first_segment_id_) {
+        if (!LogSegmentHeader::Read(segment_path, &header) || !header.sealed_) break;
+        const auto max_txn_begin = header.range_.max_txn_begin_;
+        if (max_txn_begin != transaction::INVALID_TXN_TIMESTAMP && max_txn_begin >= oldest_needed_txn) break;
+      }
+      if (unlink(segment_path.c_str()) == -1)
+        throw std::runtime_error("Failed to delete log segment with errno " + std::to_string(errno));
+      num_discarded++;
+    }
+    if (num_discarded > num_discarded_before) PosixIoWrappers::SyncParentDirectory(stream->log_file_path_);
+  }
+  return num_discarded;
+}
+
+uint64_t LogManager::DiscardEarlierRuns() {
+  std::vector<std::string> run_file_paths;
+  for (const uint64_t run : ListRotatedRuns(log_file_path_))
+    run_file_paths.emplace_back(RunFilePath(log_file_path_, run));
+  // With segments, the log files the streams are named after were written before the log manager switched to them
+  if (segment_size_ > 0) run_file_paths.emplace_back(log_file_path_);
+  uint64_t num_discarded = 0;
+  for (const auto &run_file_path : run_file_paths) {
+    uint32_t num_run_streams = 0;
+    while (access(StreamFilePath(run_file_path, num_run_streams).c_str(), F_OK) == 0) num_run_streams++;
+    // Last stream first, so that the files of a run are found the same way if we go down halfway through
+    for (uint32_t i = num_run_streams; i-- > 0;) {
+      if (unlink(StreamFilePath(run_file_path, i).c_str()) == -1)
+        throw std::runtime_error("Failed to delete log file with errno " + std::to_string(errno));
+    }
+    num_discarded += num_run_streams;
+  }
+  if (num_discarded > 0) PosixIoWrappers::SyncParentDirectory(log_file_path_);
+  return num_discarded;
+}
+
+std::string LogManager::CurrentLogFilePath(const LogStream &stream) const {
+  if (segment_size_ == 0) return stream.log_file_path_;
+  return SegmentFilePath(stream.log_file_path_, stream.disk_log_writer_task_->current_segment_id_);
 }
 
 void LogManager::AddBufferToFlushQueue(RecordBufferSegment *const buffer_segment) {
   TERRIER_ASSERT(run_log_manager_, "Must call Start on log manager before handing it buffers");
-  log_serializer_task_->AddBufferToFlushQueue(buffer_segment);
+  StreamFor(buffer_segment)->log_serializer_task_->AddBufferToFlushQueue(buffer_segment);
+}
+
+LogManager::LogStream *LogManager::StreamFor(RecordBufferSegment *const buffer_segment) {
+  if (streams_.size() == 1) return streams_.front().get();
+  // Buffers are only ever handed over with at least one record in them, and every record in a buffer comes from the
+  // same transaction
+  IterableBufferSegment<LogRecord> records(buffer_segment);
+  return streams_[StreamOf(records.begin()->TxnBegin())].get();
 }
 
 }  // namespace terrier::storage
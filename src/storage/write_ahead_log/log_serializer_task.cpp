@@ -107,7 +107,9 @@ std::tuple<uint64_t, uint64_t, uint64_t> LogSerializerTask::Process() {
       buffers_processed = true;
     }
 
-    // Mark the last buffer that was written to as full
+    // Mark the last buffer that was written to as full. Everything we took in has been serialized, so it ends at the
+    // end of a record.
+    if (filled_buffer_ != nullptr) filled_buffer_->SetEndsAtRecordBoundary(true);
     if (buffers_processed) HandFilledBufferToWriter();
 
     // Mark the last buffer that was written to as full
@@ -162,7 +164,8 @@ std::tuple<uint64_t, uint64_t, uint64_t> LogSerializerTask::SerializeBuffer(
         // necessary for the transaction's callback function to be invoked, but there is no need to serialize it, as
         // it corresponds to a transaction with nothing to redo.
         if (!commit_record->IsReadOnly()) num_bytes += SerializeRecord(record);
-        commits_in_buffer_.emplace_back(commit_record->CommitCallback(), commit_record->CommitCallbackArg());
+        commits_in_buffer_.push_back(
+            {commit_record->CommitCallback(), commit_record->CommitCallbackArg(), commit_record->CommitTime()});
         // Once serialization is done, we notify the txn manager to let GC know this txn is ready to clean up
         serialized_txns_[commit_record->TimestampManager()].push_back(record.TxnBegin());
         num_txns++;
@@ -190,6 +193,13 @@ std::tuple<uint64_t, uint64_t, uint64_t> LogSerializerTask::SerializeBuffer(
 
 uint64_t LogSerializerTask::SerializeRecord(const terrier::storage::LogRecord &record) {
   uint64_t num_bytes = 0;
+  // Keep track of which transactions the buffer has records of, which is recorded in the log segment headers
+  if (record.RecordType() == LogRecordType::COMMIT)
+    GetCurrentWriteBuffer()->Range()->AddCommit(record.TxnBegin(),
+                                                record.GetUnderlyingRecordBodyAs<CommitRecord>()->CommitTime());
+  else
+    GetCurrentWriteBuffer()->Range()->AddRecord(record.TxnBegin());
+
   // First, serialize out fields common across all LogRecordType's.
 
   // Note: This is the in-memory size of the log record itself, i.e. inclusive of padding and not considering the size
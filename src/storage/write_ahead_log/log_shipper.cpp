@@ -0,0 +1,177 @@
+#include "storage/write_ahead_log/log_shipper.h"
+
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/error/exception.h"
+#include "loggers/storage_logger.h"
+#include "network/itp/itp_packet_writer.h"
+
+namespace terrier::storage {
+
+LogShipper::LogShipper(const std::vector<std::string> &replica_addresses) {
+  for (const auto &address : replica_addresses) {
+    const auto colon = address.rfind(':');
+    if (colon == std::string::npos || colon == 0 || colon == address.size() - 1)
+      throw std::runtime_error("Replica address " + address + " is not of the form host:port");
+    auto io = Connect(address);
+    if (io == nullptr) {
+      STORAGE_LOG_WARN("Could not connect to replica {}, it will not receive the log", address);
+      continue;
+    }
+    replicas_.push_back({address, std::move(io)});
+  }
+  shipper_thread_ = std::thread([this] { ShipperLoop(); });
+}
+
+std::vector<std::string> LogShipper::ParseAddresses(const std::string &replica_addresses) {
+  std::vector<std::string> result;
+  std::stringstream stream(replica_addresses);
+  std::string address;
+  while (std::getline(stream, address, ',')) {
+    address.erase(std::remove_if(address.begin(), address.end(), ::isspace), address.end());
+    if (!address.empty()) result.push_back(address);
+  }
+  return result;
+}
+
+void LogShipper::Enqueue(std::vector<char> &&logs) {
+  if (logs.empty()) return;
+  std::unique_lock<std::mutex> lock(queue_latch_);
+  queue_cv_.wait(lock, [&] { return queued_size_ < MAX_QUEUED_SIZE || stopped_; });
+  if (stopped_) return;
+  queued_size_ += logs.size();
+  queue_.push(std::move(logs));
+  queue_cv_.notify_all();
+}
+
+void LogShipper::StopReplication() {
+  {
+    std::unique_lock<std::mutex> lock(queue_latch_);
+    stopped_ = true;
+  }
+  queue_cv_.notify_all();
+  // The shipper thread drains the queue before it exits, after which the replicas are ours to touch
+  if (shipper_thread_.joinable()) shipper_thread_.join();
+  for (auto &replica : replicas_) {
+    network::ITPPacketWriter writer(replica.io_->GetWriteQueue());
+    writer.StopReplicationCommand();
+    if (!Flush(replica.io_.get())) STORAGE_LOG_WARN("Could not tell replica {} to stop replication", replica.address_);
+    replica.io_->Close();
+  }
+  replicas_.clear();
+}
+
+void LogShipper::ShipperLoop() {
+  std::unique_lock<std::mutex> lock(queue_latch_);
+  while (true) {
+    queue_cv_.wait(lock, [&] { return !queue_.empty() || stopped_; });
+    if (queue_.empty()) return;
+    const std::vector<char> logs = std::move(queue_.front());
+    queue_.pop();
+    // Enqueue must not wait on the replicas
+    lock.unlock();
+    Ship(logs);
+    lock.lock();
+    queued_size_ -= logs.size();
+    queue_cv_.notify_all();
+  }
+}
+
+void LogShipper::Ship(const std::vector<char> &logs) {
+  if (replicas_.empty()) return;
+  for (uint64_t offset = 0; offset < logs.size(); offset += MAX_MESSAGE_SIZE) {
+    const uint64_t bytes = std::min(logs.size() - offset, MAX_MESSAGE_SIZE);
+    // The message is only read from, the const_cast is just to fit it into an iovec
+    ShipMessage({{const_cast<char *>(logs.data()) + offset, bytes}}, bytes);  // NOLINT
+  }
+}
+
+void LogShipper::ShipMessage(const std::vector<iovec> &message, const uint64_t message_size) {
+  const uint64_t message_id = next_message_id_++;
+  for (auto replica = replicas_.begin(); replica != replicas_.end();) {
+    if (SendMessage(replica->io_.get(), message_id, message, message_size)) {
+      ++replica;
+      continue;
+    }
+    // Try once more over a new connection. The replica ignores the message if it got it before the connection broke.
+    replica->io_->Close();
+    replica->io_ = Connect(replica->address_);
+    if (replica->io_ != nullptr && SendMessage(replica->io_.get(), message_id, message, message_size)) {
+      ++replica;
+      continue;
+    }
+    STORAGE_LOG_ERROR("Lost replica {}, it no longer receives the log", replica->address_);
+    if (replica->io_ != nullptr) replica->io_->Close();
+    replica = replicas_.erase(replica);
+  }
+}
+
+std::unique_ptr<network::NetworkIoWrapper> LogShipper::Connect(const std::string &address) {
+  const auto colon = address.rfind(':');
+  const std::string host = address.substr(0, colon);
+  const std::string port = address.substr(colon + 1);
+
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo *addresses;
+  if (getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses) != 0) return nullptr;
+  int fd = -1;
+  for (addrinfo *candidate = addresses; candidate != nullptr; candidate = candidate->ai_next) {
+    fd = socket(candidate->ai_family, candidate->ai_socktype, candidate->ai_protocol);
+    if (fd < 0) continue;
+    if (connect(fd, candidate->ai_addr, candidate->ai_addrlen) == 0) break;
+    close(fd);
+    fd = -1;
+  }
+  freeaddrinfo(addresses);
+  if (fd < 0) return nullptr;
+#ifdef SO_NOSIGPIPE
+  // A replica going away has to show up as EPIPE when writing to it, rather than as a signal that kills us. Where
+  // sends cannot say so themselves (@see WriteBuffer::WriteOutTo), the socket has to.
+  const int no_sigpipe = 1;
+  setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &no_sigpipe, sizeof(no_sigpipe));
+#endif
+  return std::make_unique<network::NetworkIoWrapper>(fd);
+}
+
+bool LogShipper::SendMessage(network::NetworkIoWrapper *const io, const uint64_t message_id,
+                             const std::vector<iovec> &message, const uint64_t message_size) {
+  network::ITPPacketWriter writer(io->GetWriteQueue());
+  writer.BeginReplicationCommand(message_id, message_size);
+  for (const auto &piece : message) writer.AppendRaw(piece.iov_base, piece.iov_len);
+  writer.EndReplicationCommand();
+  return Flush(io);
+}
+
+bool LogShipper::Flush(network::NetworkIoWrapper *const io) {
+  try {
+    while (true) {
+      switch (io->FlushAllWrites()) {
+        case network::Transition::PROCEED:
+          return true;
+        case network::Transition::NEED_WRITE: {
+          // The socket is non-blocking, so wait for the replica to catch up before writing the rest
+          pollfd poll_fd{io->GetSocketFd(), POLLOUT, 0};
+          if (poll(&poll_fd, 1, SEND_TIMEOUT_MS) <= 0) return false;
+          break;
+        }
+        default:
+          return false;
+      }
+    }
+  } catch (NetworkProcessException &e) {
+    return false;
+  }
+}
+
+}  // namespace terrier::storage
@@ -82,9 +82,14 @@ void TrafficCop::EndTransaction(const common::ManagedPointer<network::Connection
   connection_ctx->SetAccessor(nullptr);
 }
 
-void TrafficCop::HandBufferToReplication(std::unique_ptr<network::ReadBuffer> buffer) {
+void TrafficCop::HandBufferToReplication(const uint64_t message_id, std::unique_ptr<network::ReadBuffer> buffer) {
   TERRIER_ASSERT(replication_log_provider_ != DISABLED, "Should not be handing off logs if no log provider was given");
-  replication_log_provider_->HandBufferToReplication(std::move(buffer));
+  replication_log_provider_->HandBufferToReplication(message_id, std::move(buffer));
+}
+
+void TrafficCop::StopReplication() {
+  TERRIER_ASSERT(replication_log_provider_ != DISABLED, "Should not be stopping replication without a log provider");
+  replication_log_provider_->EndReplication();
 }
 
 void TrafficCop::ExecuteTransactionStatement(const common::ManagedPointer<network::ConnectionContext> connection_ctx,
@@ -358,6 +363,7 @@ TrafficCopResult TrafficCop::CodegenPhysicalPlan(
 
   // TODO(WAN): see #1047
   execution::exec::ExecutionSettings exec_settings{};
+  if (settings_manager_ != nullptr) exec_settings.UpdateFromSettingsManager(settings_manager_);
   auto exec_query = execution::compiler::CompilationContext::Compile(
       *physical_plan, exec_settings, connection_ctx->Accessor().Get(),
       execution::compiler::CompilationMode::Interleaved,
@@ -383,6 +389,7 @@ TrafficCopResult TrafficCop::RunExecutableQuery(const common::ManagedPointer<net
   execution::exec::OutputWriter writer(physical_plan->GetOutputSchema(), out, portal->ResultFormats());
 
   execution::exec::ExecutionSettings exec_settings{};
+  if (settings_manager_ != nullptr) exec_settings.UpdateFromSettingsManager(settings_manager_);
   auto exec_ctx = std::make_unique<execution::exec::ExecutionContext>(
       connection_ctx->GetDatabaseOid(), connection_ctx->Transaction(), writer, physical_plan->GetOutputSchema().Get(),
       connection_ctx->Accessor(), exec_settings);
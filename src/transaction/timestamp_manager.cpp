@@ -5,9 +5,17 @@
 namespace terrier::transaction {
 
 timestamp_t TimestampManager::OldestTransactionStartTime() {
-  common::SpinLatch::ScopedSpinLatch guard(&curr_running_txns_latch_);
-  const auto &oldest_txn = std::min_element(curr_running_txns_.cbegin(), curr_running_txns_.cend());
-  timestamp_t result = (oldest_txn != curr_running_txns_.end()) ? *oldest_txn : time_.load();
+  // Anything that begins after this point gets a start timestamp no smaller than this, so it is a safe fallback.
+  timestamp_t result = time_.load();
+  // Wait out every transaction that may have taken its start timestamp before we read the time but not yet made it
+  // into the running set. Once we have been through every begin latch, any such transaction is visible in a shard.
+  for (auto &begin_latch : begin_latches_) {
+    common::SpinLatch::ScopedSpinLatch guard(&begin_latch.latch_);
+  }
+  for (auto &shard : running_txns_shards_) {
+    common::SpinLatch::ScopedSpinLatch guard(&shard.latch_);
+    if (!shard.txns_.empty()) result = std::min(result, *shard.txns_.cbegin());
+  }
   cached_oldest_txn_start_time_.store(result);  // Cache the timestamp
   return result;
 }
@@ -15,16 +23,25 @@ timestamp_t TimestampManager::OldestTransactionStartTime() {
 timestamp_t TimestampManager::CachedOldestTransactionStartTime() { return cached_oldest_txn_start_time_.load(); }
 
 void TimestampManager::RemoveTransaction(timestamp_t timestamp) {
-  common::SpinLatch::ScopedSpinLatch guard(&curr_running_txns_latch_);
-  const size_t ret UNUSED_ATTRIBUTE = curr_running_txns_.erase(timestamp);
+  RunningTxnsShard &shard = ShardFor(timestamp);
+  common::SpinLatch::ScopedSpinLatch guard(&shard.latch_);
+  const size_t ret UNUSED_ATTRIBUTE = shard.txns_.erase(timestamp);
   TERRIER_ASSERT(ret == 1, "erased timestamp did not exist");
 }
 
 void TimestampManager::RemoveTransactions(const std::vector<terrier::transaction::timestamp_t> &timestamps) {
-  common::SpinLatch::ScopedSpinLatch guard(&curr_running_txns_latch_);
-  for (const auto &timestamp : timestamps) {
-    const size_t ret UNUSED_ATTRIBUTE = curr_running_txns_.erase(timestamp);
-    TERRIER_ASSERT(ret == 1, "erased timestamp did not exist");
+  // Group the timestamps by shard first, so we only take each latch once
+  std::array<std::vector<timestamp_t>, NUM_RUNNING_TXNS_SHARDS> by_shard;
+  for (const auto &timestamp : timestamps)
+    by_shard[timestamp.UnderlyingValue() % NUM_RUNNING_TXNS_SHARDS].push_back(timestamp);
+  for (uint32_t i = 0; i < NUM_RUNNING_TXNS_SHARDS; i++) {
+    if (by_shard[i].empty()) continue;
+    RunningTxnsShard &shard = running_txns_shards_[i];
+    common::SpinLatch::ScopedSpinLatch guard(&shard.latch_);
+    for (const auto &timestamp : by_shard[i]) {
+      const size_t ret UNUSED_ATTRIBUTE = shard.txns_.erase(timestamp);
+      TERRIER_ASSERT(ret == 1, "erased timestamp did not exist");
+    }
   }
 }
 
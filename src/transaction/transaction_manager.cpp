@@ -2,10 +2,14 @@
 
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "common/scoped_timer.h"
 #include "common/thread_context.h"
 #include "metrics/metrics_store.h"
+#include "storage/data_table.h"
+#include "storage/write_ahead_log/log_manager.h"
+#include "transaction/deferred_action_manager.h"
 
 namespace terrier::transaction {
 TransactionContext *TransactionManager::BeginTransaction() {
@@ -20,6 +24,8 @@ TransactionContext *TransactionManager::BeginTransaction() {
   if (txn_metrics_enabled) common::thread_context.resource_tracker_.Start();
   start_time = timestamp_manager_->BeginTransaction();
   result = new TransactionContext(start_time, start_time + INT64_MIN, buffer_pool_, log_manager_);
+  // Read after we are registered as running, so that it cannot be newer than our own start time
+  result->oldest_txn_start_time_ = timestamp_manager_->CachedOldestTransactionStartTime();
   // Ensure we do not return from this function if there are ongoing write commits
   txn_gate_.Traverse();
 
@@ -52,6 +58,14 @@ void TransactionManager::LogCommit(TransactionContext *const txn, const timestam
   txn->redo_buffer_.Finalize(true);
 }
 
+timestamp_t TransactionManager::CheckOutCommitTimestamp(TransactionContext *const txn) {
+  // The log manager has to know about the commit as soon as it has a timestamp, so that it does not acknowledge any
+  // later commits before this one is persisted
+  if (log_manager_ != DISABLED)
+    return log_manager_->CheckOutCommitTimestamp(txn->StartTime(), timestamp_manager_.Get());
+  return timestamp_manager_->CheckOutTimestamp();
+}
+
 timestamp_t TransactionManager::UpdatingCommitCriticalSection(TransactionContext *const txn) {
   // WARNING: This operation has to happen appear atomic to new transactions:
   // transaction 1        transaction 2
@@ -68,7 +82,7 @@ timestamp_t TransactionManager::UpdatingCommitCriticalSection(TransactionContext
   //  the correct version the second time, violating snapshot isolation.
   //  Make sure you solve this problem before you remove this gate for whatever reason.
   common::Gate::ScopedLock gate(&txn_gate_);
-  const timestamp_t commit_time = timestamp_manager_->CheckOutTimestamp();
+  const timestamp_t commit_time = CheckOutCommitTimestamp(txn);
 
   // flip all timestamps to be committed
   for (auto &it : txn->undo_buffer_) it.Timestamp().store(commit_time);
@@ -88,7 +102,7 @@ timestamp_t TransactionManager::Commit(TransactionContext *const txn, transactio
   TERRIER_ASSERT(!txn->must_abort_,
                  "This txn was marked that it must abort. Set a breakpoint at TransactionContext::MustAbort() to see a "
                  "stack trace for when this flag is getting tripped.");
-  result = txn->IsReadOnly() ? timestamp_manager_->CheckOutTimestamp() : UpdatingCommitCriticalSection(txn);
+  result = txn->IsReadOnly() ? CheckOutCommitTimestamp(txn) : UpdatingCommitCriticalSection(txn);
 
   txn->finish_time_.store(result);
 
@@ -111,11 +125,10 @@ timestamp_t TransactionManager::Commit(TransactionContext *const txn, transactio
 
   // We hand off txn to GC, however, it won't be GC'd until the LogManager marks it as serialized
   if (gc_enabled_) {
-    common::SpinLatch::ScopedSpinLatch guard(&timestamp_manager_->curr_running_txns_latch_);
     // It is not necessary to have to GC process read-only transactions, but it's probably faster to call free off
     // the critical path there anyway
     // Also note here that GC will figure out what varlen entries to GC, as opposed to in the abort case.
-    completed_txns_.push_front(txn);
+    HandOffToGC(txn);
   }
 
   if (txn_metrics_enabled) {
@@ -188,11 +201,10 @@ timestamp_t TransactionManager::Abort(TransactionContext *const txn) {
 
   // We hand off txn to GC, however, it won't be GC'd until the LogManager marks it as serialized
   if (gc_enabled_) {
-    common::SpinLatch::ScopedSpinLatch guard(&timestamp_manager_->curr_running_txns_latch_);
     // It is not necessary to have to GC process read-only transactions, but it's probably faster to call free off
     // the critical path there anyway
     // Also note here that GC will figure out what varlen entries to GC, as opposed to in the abort case.
-    completed_txns_.push_front(txn);
+    HandOffToGC(txn);
   }
 
   return abort_time;
@@ -232,9 +244,22 @@ void TransactionManager::GCLastUpdateOnAbort(TransactionContext *const txn) {
   }
 }
 
+void TransactionManager::HandOffToGC(TransactionContext *const txn) {
+  // Threads stick to one queue each, so committing threads rarely contend with each other here
+  static thread_local const uint32_t queue_hint =
+      static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+  CompletedTxnsQueue &queue = completed_txns_[queue_hint % NUM_COMPLETED_TXNS_QUEUES];
+  common::SpinLatch::ScopedSpinLatch guard(&queue.latch_);
+  queue.txns_.push_front(txn);
+}
+
 TransactionQueue TransactionManager::CompletedTransactionsForGC() {
-  common::SpinLatch::ScopedSpinLatch guard(&timestamp_manager_->curr_running_txns_latch_);
-  return std::move(completed_txns_);
+  TransactionQueue result;
+  for (auto &queue : completed_txns_) {
+    common::SpinLatch::ScopedSpinLatch guard(&queue.latch_);
+    result.splice_after(result.cbefore_begin(), std::move(queue.txns_));
+  }
+  return result;
 }
 
 void TransactionManager::Rollback(TransactionContext *txn, const storage::UndoRecord &record) const {
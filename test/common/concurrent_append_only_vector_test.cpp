@@ -0,0 +1,61 @@
+#include "common/container/concurrent_append_only_vector.h"
+
+#include <algorithm>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/worker_pool.h"
+#include "gtest/gtest.h"
+#include "test_util/multithread_test_util.h"
+
+namespace terrier {
+
+// Tests that elements appended from a single thread come back in order, including across segment boundaries
+// NOLINTNEXTLINE
+TEST(ConcurrentAppendOnlyVectorTests, SimpleCorrectnessTest) {
+  common::ConcurrentAppendOnlyVector<uint64_t> vector;
+  EXPECT_TRUE(vector.Empty());
+  const uint32_t num_elements = 10000;
+  for (uint32_t i = 0; i < num_elements; i++) {
+    EXPECT_EQ(i, vector.PushBack(i * 3));
+    EXPECT_EQ(i + 1, vector.Size());
+  }
+  for (uint32_t i = 0; i < num_elements; i++) EXPECT_EQ(i * 3, vector[i]);
+}
+
+// Tests that concurrent appends each get a unique index, and that every published element is visible to a concurrent
+// reader that only looks below the size it observed
+// NOLINTNEXTLINE
+TEST(ConcurrentAppendOnlyVectorTests, ConcurrentAppendTest) {
+  const uint32_t num_iterations = 10;
+  const uint32_t num_threads = MultiThreadTestUtil::HardwareConcurrency();
+  const uint32_t num_elements_per_thread = 10000;
+  common::WorkerPool thread_pool(num_threads, {});
+  for (uint32_t iteration = 0; iteration < num_iterations; iteration++) {
+    common::ConcurrentAppendOnlyVector<uint64_t> vector;
+    std::vector<std::vector<uint32_t>> indexes(num_threads);
+    auto workload = [&](uint32_t thread_id) {
+      for (uint32_t i = 0; i < num_elements_per_thread; i++) {
+        uint64_t value = static_cast<uint64_t>(thread_id) * num_elements_per_thread + i + 1;
+        indexes[thread_id].push_back(vector.PushBack(value));
+        // Every published element must be fully written
+        const uint32_t size = vector.Size();
+        EXPECT_NE(0, vector[size - 1]);
+      }
+    };
+    MultiThreadTestUtil::RunThreadsUntilFinish(&thread_pool, num_threads, workload);
+
+    ASSERT_EQ(num_threads * num_elements_per_thread, vector.Size());
+    std::vector<bool> seen(vector.Size(), false);
+    for (uint32_t thread_id = 0; thread_id < num_threads; thread_id++) {
+      for (uint32_t i = 0; i < num_elements_per_thread; i++) {
+        const uint32_t index = indexes[thread_id][i];
+        EXPECT_FALSE(seen[index]);
+        seen[index] = true;
+        EXPECT_EQ(static_cast<uint64_t>(thread_id) * num_elements_per_thread + i + 1, vector[index]);
+      }
+    }
+  }
+}
+
+}  // namespace terrier
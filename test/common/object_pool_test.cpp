@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <atomic>
+#include <memory>
 #include <thread>  // NOLINT
 #include <unordered_set>
 #include <vector>
@@ -68,6 +70,123 @@ TEST(ObjectPoolTests, ResetLimitTest) {
   }
 }
 
+// Objects released on different threads are cached in different magazines. Lowering the limits should still free
+// them, and a single thread should still get to reuse every one of them.
+// NOLINTNEXTLINE
+TEST(ObjectPoolTests, MagazineTest) {
+  const uint32_t repeat = 10;
+  const uint64_t size_limit = 100;
+  const uint32_t num_threads = 8;
+  for (uint32_t iteration = 0; iteration < repeat; ++iteration) {
+    common::ObjectPool<uint32_t> tested(size_limit, size_limit);
+    std::vector<uint32_t *> used_ptrs;
+    for (uint32_t i = 0; i < size_limit; ++i) used_ptrs.push_back(tested.Get());
+    EXPECT_THROW(tested.Get(), common::NoMoreObjectException);
+
+    std::vector<std::thread> threads;
+    for (uint32_t thread = 0; thread < num_threads; ++thread) {
+      threads.emplace_back([&, thread] {
+        for (uint32_t i = thread; i < size_limit; i += num_threads) tested.Release(used_ptrs[i]);
+      });
+    }
+    for (auto &thread : threads) thread.join();
+
+    // Half of the cached objects have to be freed for the size limit to go down
+    tested.SetReuseLimit(size_limit / 2);
+    EXPECT_TRUE(tested.SetSizeLimit(size_limit / 2));
+
+    std::unordered_set<uint32_t *> reused_ptrs;
+    for (uint32_t i = 0; i < size_limit / 2; ++i) {
+      uint32_t *ptr = tested.Get();
+      EXPECT_FALSE(std::find(used_ptrs.begin(), used_ptrs.end(), ptr) == used_ptrs.end());
+      EXPECT_TRUE(reused_ptrs.insert(ptr).second);
+    }
+    EXPECT_THROW(tested.Get(), common::NoMoreObjectException);
+
+    for (auto *ptr : reused_ptrs) tested.Release(ptr);
+  }
+}
+
+// Every thread gets a magazine of its own, however many threads share the pool. Objects cached by threads that have
+// since exited are still there to be reused by others.
+// NOLINTNEXTLINE
+TEST(ObjectPoolTests, ManyThreadsTest) {
+  const uint32_t num_threads = 64;
+  const uint32_t objects_per_thread = 4;
+  const uint64_t size_limit = num_threads * objects_per_thread;
+  common::ObjectPool<uint32_t> tested(size_limit, size_limit);
+
+  std::vector<std::thread> threads;
+  for (uint32_t thread = 0; thread < num_threads; ++thread) {
+    threads.emplace_back([&, thread] {
+      for (uint32_t round = 0; round < 100; ++round) {
+        std::vector<uint32_t *> ptrs;
+        for (uint32_t i = 0; i < objects_per_thread; ++i) {
+          ptrs.push_back(tested.Get());
+          *ptrs.back() = thread;
+        }
+        // Nobody else was handed our objects in the meantime
+        for (auto *ptr : ptrs) EXPECT_EQ(thread, *ptr);
+        for (auto *ptr : ptrs) tested.Release(ptr);
+      }
+    });
+  }
+  for (auto &thread : threads) thread.join();
+
+  // The objects cached in the magazines of the exited threads are handed out before any new ones
+  std::unordered_set<uint32_t *> ptrs;
+  for (uint64_t i = 0; i < size_limit; ++i) {
+    uint32_t *ptr = tested.Get();
+    EXPECT_TRUE(ptrs.insert(ptr).second);
+  }
+  EXPECT_THROW(tested.Get(), common::NoMoreObjectException);
+  for (auto *ptr : ptrs) tested.Release(ptr);
+}
+
+// A thread hands the objects it cached back to the pool when it exits, and the pool lets go of its magazine. A thread
+// that outlives a pool it used lets go of its magazine too.
+// NOLINTNEXTLINE
+TEST(ObjectPoolTests, ThreadExitTest) {
+  const uint32_t num_threads = 8;
+  const uint32_t magazine_size = 4;
+  const uint64_t size_limit = 100;
+  common::ObjectPool<uint32_t> tested(size_limit, size_limit, magazine_size);
+
+  for (uint32_t thread = 0; thread < num_threads; ++thread) {
+    std::thread([&] {
+      std::vector<uint32_t *> ptrs;
+      for (uint32_t i = 0; i < 10; ++i) ptrs.push_back(tested.Get());
+      for (auto *ptr : ptrs) tested.Release(ptr);
+      // No more than a magazine's worth of objects stays with the thread
+      EXPECT_EQ(tested.magazines_.back()->objects_.size(), magazine_size);
+    }).join();
+    // Everything the thread cached is back in the shared queue, and only its own magazine was left for the pool to let
+    // go of, as every thread before it had exited already
+    EXPECT_EQ(tested.reuse_queue_.size(), 10);
+    EXPECT_EQ(tested.magazines_.size(), 1);
+    EXPECT_TRUE(tested.magazines_.front()->retired_.load());
+  }
+
+  // A thread that outlives the pool is left with an empty magazine, which it forgets once it uses another pool
+  auto pool = std::make_unique<common::ObjectPool<uint32_t>>(size_limit, size_limit, magazine_size);
+  std::atomic<bool> pool_used = false, pool_destroyed = false;
+  std::thread survivor([&] {
+    pool->Release(pool->Get());
+    const auto magazine = pool->magazines_.front();
+    pool_used = true;
+    while (!pool_destroyed.load()) std::this_thread::yield();
+    // The pool freed the object the thread cached
+    EXPECT_TRUE(magazine->objects_.empty());
+    EXPECT_EQ(magazine->pool_, nullptr);
+    tested.Release(tested.Get());
+    EXPECT_EQ(magazine.use_count(), 1);
+  });
+  while (!pool_used.load()) std::this_thread::yield();
+  pool.reset();
+  pool_destroyed = true;
+  survivor.join();
+}
+
 class ObjectPoolTestType {
  public:
   ObjectPoolTestType *Use(uint32_t thread_id) {
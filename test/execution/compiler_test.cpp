@@ -67,6 +67,20 @@ class CompilerTest : public SqlBasedTest {
     return set_a == set_b;
   }
 
+  // Count the instances of the given bytecode in all functions of the compiled query.
+  static uint32_t CountBytecode(const ExecutableQuery &query, vm::Bytecode bytecode) {
+    uint32_t count = 0;
+    for (const auto &fragment : query.GetFragments()) {
+      const vm::BytecodeModule *module = fragment->GetModule()->GetBytecodeModule();
+      for (const auto &func : module->GetFunctionsInfo()) {
+        for (auto iter = module->GetBytecodeForFunction(func); !iter.Done(); iter.Advance()) {
+          if (iter.CurrentBytecode() == bytecode) count++;
+        }
+      }
+    }
+    return count;
+  }
+
   static constexpr vm::ExecutionMode MODE = vm::ExecutionMode::Interpret;
 };
 
@@ -1708,6 +1722,116 @@ TEST_F(CompilerTest, MultiWayHashJoinTest) {
   EXPECT_TRUE(CheckFeatureVectorEquality(feature_vec2, exp_vec2));
 }
 
+// NOLINTNEXTLINE
+TEST_F(CompilerTest, BloomFilterPushdownTest) {
+  // SELECT t1.colA, t1.colB, t2.colA, t2.colB FROM test_1 AS t1 INNER JOIN test_1 AS t2 ON t1.colA = t2.colA
+  // WHERE t1.colA < 500
+  // The probe-side scan has no predicate of its own, so all of its tuples go through the bloom filter of the join.
+  auto accessor = MakeAccessor();
+  ExpressionMaker expr_maker;
+  auto table_oid = accessor->GetTableOid(NSOid(), "test_1");
+  auto table_schema = accessor->GetSchema(table_oid);
+  auto cola_oid = table_schema.GetColumn("colA").Oid();
+  auto colb_oid = table_schema.GetColumn("colB").Oid();
+
+  // Build side, restricted to 500 tuples
+  std::unique_ptr<planner::AbstractPlanNode> seq_scan1;
+  OutputSchemaHelper seq_scan_out1{0, &expr_maker};
+  {
+    auto col1 = expr_maker.CVE(cola_oid, type::TypeId::INTEGER);
+    auto col2 = expr_maker.CVE(colb_oid, type::TypeId::INTEGER);
+    seq_scan_out1.AddOutput("col1", col1);
+    seq_scan_out1.AddOutput("col2", col2);
+    auto schema = seq_scan_out1.MakeSchema();
+    auto predicate = expr_maker.ComparisonLt(col1, expr_maker.Constant(500));
+    planner::SeqScanPlanNode::Builder builder;
+    seq_scan1 = builder.SetOutputSchema(std::move(schema))
+                    .SetColumnOids({cola_oid, colb_oid})
+                    .SetScanPredicate(predicate)
+                    .SetIsForUpdateFlag(false)
+                    .SetTableOid(table_oid)
+                    .Build();
+  }
+  // Probe side, the whole table
+  std::unique_ptr<planner::AbstractPlanNode> seq_scan2;
+  OutputSchemaHelper seq_scan_out2{1, &expr_maker};
+  {
+    auto col1 = expr_maker.CVE(cola_oid, type::TypeId::INTEGER);
+    auto col2 = expr_maker.CVE(colb_oid, type::TypeId::INTEGER);
+    seq_scan_out2.AddOutput("col1", col1);
+    seq_scan_out2.AddOutput("col2", col2);
+    auto schema = seq_scan_out2.MakeSchema();
+    planner::SeqScanPlanNode::Builder builder;
+    seq_scan2 = builder.SetOutputSchema(std::move(schema))
+                    .SetColumnOids({cola_oid, colb_oid})
+                    .SetIsForUpdateFlag(false)
+                    .SetTableOid(table_oid)
+                    .Build();
+  }
+  // Make hash join
+  std::unique_ptr<planner::AbstractPlanNode> hash_join;
+  OutputSchemaHelper hash_join_out{0, &expr_maker};
+  {
+    auto t1_col1 = seq_scan_out1.GetOutput("col1");
+    auto t1_col2 = seq_scan_out1.GetOutput("col2");
+    auto t2_col1 = seq_scan_out2.GetOutput("col1");
+    auto t2_col2 = seq_scan_out2.GetOutput("col2");
+    hash_join_out.AddOutput("t1.col1", t1_col1);
+    hash_join_out.AddOutput("t1.col2", t1_col2);
+    hash_join_out.AddOutput("t2.col1", t2_col1);
+    hash_join_out.AddOutput("t2.col2", t2_col2);
+    auto schema = hash_join_out.MakeSchema();
+    auto predicate = expr_maker.ComparisonEq(t1_col1, t2_col1);
+    planner::HashJoinPlanNode::Builder builder;
+    hash_join = builder.AddChild(std::move(seq_scan1))
+                    .AddChild(std::move(seq_scan2))
+                    .SetOutputSchema(std::move(schema))
+                    .AddLeftHashKey(t1_col1)
+                    .AddRightHashKey(t2_col1)
+                    .SetJoinType(planner::LogicalJoinType::INNER)
+                    .SetJoinPredicate(predicate)
+                    .Build();
+  }
+
+  // Every build tuple joins with itself, and nothing else
+  uint32_t num_output_rows{0};
+  uint32_t num_expected_rows{500};
+  std::vector<bool> seen(num_expected_rows, false);
+  RowChecker row_checker = [&num_output_rows, &seen, num_expected_rows](const std::vector<sql::Val *> &vals) {
+    auto t1_col1 = static_cast<sql::Integer *>(vals[0]);
+    auto t1_col2 = static_cast<sql::Integer *>(vals[1]);
+    auto t2_col1 = static_cast<sql::Integer *>(vals[2]);
+    auto t2_col2 = static_cast<sql::Integer *>(vals[3]);
+    ASSERT_FALSE(t1_col1->is_null_ || t1_col2->is_null_ || t2_col1->is_null_ || t2_col2->is_null_);
+    ASSERT_EQ(t1_col1->val_, t2_col1->val_);
+    ASSERT_EQ(t1_col2->val_, t2_col2->val_);
+    ASSERT_GE(t1_col1->val_, 0);
+    ASSERT_LT(t1_col1->val_, static_cast<int64_t>(num_expected_rows));
+    ASSERT_FALSE(seen[t1_col1->val_]);
+    seen[t1_col1->val_] = true;
+    num_output_rows++;
+  };
+  CorrectnessFn correctness_fn = [&num_output_rows, num_expected_rows]() {
+    ASSERT_EQ(num_output_rows, num_expected_rows);
+  };
+  GenericChecker checker(row_checker, correctness_fn);
+
+  OutputStore store{&checker, hash_join->GetOutputSchema().Get()};
+  MultiOutputCallback callback{std::vector<exec::OutputCallback>{store}};
+  auto exec_ctx = MakeExecCtx(std::move(callback), hash_join->GetOutputSchema().Get());
+  auto executable = execution::compiler::CompilationContext::Compile(*hash_join, exec_ctx->GetExecutionSettings(),
+                                                                     exec_ctx->GetAccessor());
+
+  // The join builds the bloom filter of its table, and the probe-side scan filters its tuples through it
+  ASSERT_TRUE(exec_ctx->GetExecutionSettings().GetIsBloomFilterPushdownEnabled());
+  EXPECT_EQ(1, CountBytecode(*executable, vm::Bytecode::JoinHashTableBuildBloomFilter));
+  EXPECT_EQ(1, CountBytecode(*executable, vm::Bytecode::JoinHashTableFilterProbe));
+
+  // Run & Check
+  executable->Run(common::ManagedPointer(exec_ctx), MODE);
+  checker.CheckCorrectness();
+}
+
 // NOLINTNEXTLINE
 TEST_F(CompilerTest, SimpleSortTest) {
   // SELECT col1, col2, col1 + col2 FROM test_1 WHERE col1 < 500 ORDER BY col2 ASC, col1 - col2 DESC
@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "catalog/schema.h"
+#include "common/error/exception.h"
 #include "common/hash_util.h"
 #include "execution/exec/execution_context.h"
 #include "execution/sql/aggregation_hash_table.h"
@@ -435,4 +436,123 @@ TEST_F(AggregationHashTableTest, ParallelAggregationTest) {
   EXPECT_EQ(num_aggs, query_state.row_count_.load(std::memory_order_seq_cst));
 }
 
+class AggregationHashTableSpillTest : public AggregationHashTableTest {
+ public:
+  // Each thread-local table holds at most a thousand aggregates before writing out its overflow partitions.
+  static constexpr uint64_t MEMORY_BUDGET = 1000 * HashTableEntry::ComputeEntrySize(sizeof(AggTuple));
+  // Each of the threads sees each of the keys the same number of times.
+  static constexpr uint32_t NUM_THREADS = 4, NUM_AGGS = 20000, NUM_INPUTS = 60000;
+
+  // The whole-query state.
+  struct QueryState {
+    std::atomic<uint32_t> row_count_;
+    std::atomic<uint32_t> wrong_count_;
+  };
+
+  // Build thread-local tables, and transfer their spilled aggregates to the main table.
+  void BuildSpilledTable(exec::ExecutionContext *exec_ctx, ThreadStateContainer *container,
+                         AggregationHashTable *main_table) {
+    // Thread-local container contains only an aggregation hash table.
+    container->Reset(
+        sizeof(AggregationHashTable),
+        // Init function.
+        [](void *ctx, void *aht) {
+          auto exec_ctx = reinterpret_cast<exec::ExecutionContext *>(ctx);
+          auto *agg_table = new (aht)
+              AggregationHashTable(exec_ctx->GetExecutionSettings(), exec_ctx->GetMemoryPool(), sizeof(AggTuple));
+          agg_table->EnableSpilling(MEMORY_BUDGET);
+        },
+        // Tear-down function.
+        [](void *ctx, void *aht) { std::destroy_at(reinterpret_cast<AggregationHashTable *>(aht)); }, exec_ctx);
+
+    LaunchParallel(NUM_THREADS, [&](auto tid) {
+      // The thread-local table.
+      auto agg_table = container->AccessCurrentThreadStateAs<AggregationHashTable>();
+
+      for (uint32_t idx = 0; idx < NUM_INPUTS; idx++) {
+        InputTuple input(idx % NUM_AGGS, 1);
+        auto *existing = reinterpret_cast<AggTuple *>(
+            agg_table->Lookup(input.Hash(), AggTupleKeyEq, reinterpret_cast<const void *>(&input)));
+        if (existing != nullptr) {
+          existing->Advance(input);
+        } else {
+          auto *new_agg = agg_table->AllocInputTuplePartitioned(input.Hash());
+          new (new_agg) AggTuple(input);
+        }
+      }
+    });
+
+    main_table->EnableSpilling(MEMORY_BUDGET);
+    main_table->TransferMemoryAndPartitions(
+        container, 0, [](void *ctx, AggregationHashTable *table, AHTOverflowPartitionIterator *iter) {
+          for (; iter->HasNext(); iter->Next()) {
+            auto *partial_agg = iter->GetRowAs<AggTuple>();
+            auto *existing = reinterpret_cast<AggTuple *>(table->Lookup(iter->GetRowHash(), AggAggKeyEq, partial_agg));
+            if (existing != nullptr) {
+              existing->Merge(*partial_agg);
+            } else {
+              table->Insert(iter->GetEntryForRow());
+            }
+          }
+        });
+
+    // Clear thread-local container to ensure nothing is left in thread-local memory
+    container->Clear();
+  }
+
+  // Count the aggregates of the scanned table, and those that did not merge all their partial aggregates.
+  static void ScanFn(void *query_state, void *thread_state, const AggregationHashTable *agg_table) {
+    auto *qs = reinterpret_cast<QueryState *>(query_state);
+    for (AHTIterator iter(*agg_table); iter.HasNext(); iter.Next()) {
+      auto *agg = reinterpret_cast<const AggTuple *>(iter.GetCurrentAggregateRow());
+      qs->row_count_++;
+      if (agg->count1_ != NUM_THREADS * NUM_INPUTS / NUM_AGGS) qs->wrong_count_++;
+    }
+  }
+};
+
+// NOLINTNEXTLINE
+TEST_F(AggregationHashTableSpillTest, ParallelScanTest) {
+  auto exec_ctx = MakeExecCtx();
+  tbb::task_scheduler_init sched;
+  MemoryPool memory(nullptr);
+  ThreadStateContainer container(&memory);
+
+  AggregationHashTable main_table(exec_ctx->GetExecutionSettings(), &memory, sizeof(AggTuple));
+  BuildSpilledTable(exec_ctx.get(), &container, &main_table);
+  EXPECT_TRUE(main_table.IsSpilled());
+
+  // Spilled tables can only be scanned.
+  EXPECT_THROW(main_table.Repartition(), ExecutionException);
+  EXPECT_THROW(main_table.BuildAllPartitions(nullptr), ExecutionException);
+
+  // Scan the main table and ensure all partial aggregates were merged.
+  QueryState query_state{0, 0};
+  main_table.ExecuteParallelPartitionedScan(&query_state, &container, ScanFn);
+  EXPECT_EQ(NUM_AGGS, query_state.row_count_.load(std::memory_order_seq_cst));
+  EXPECT_EQ(0u, query_state.wrong_count_.load(std::memory_order_seq_cst));
+
+  // The spill partitions held more than the budget, so they were split before they were read back.
+  EXPECT_GT(main_table.GetStatistics()->num_spills_, 1u);
+}
+
+// NOLINTNEXTLINE
+TEST_F(AggregationHashTableSpillTest, SerialScanTest) {
+  auto exec_ctx = MakeExecCtx();
+  tbb::task_scheduler_init sched;
+  MemoryPool memory(nullptr);
+  ThreadStateContainer container(&memory);
+
+  AggregationHashTable main_table(exec_ctx->GetExecutionSettings(), &memory, sizeof(AggTuple));
+  BuildSpilledTable(exec_ctx.get(), &container, &main_table);
+  EXPECT_TRUE(main_table.IsSpilled());
+
+  // Scan the main table and ensure all partial aggregates were merged.
+  QueryState query_state{0, 0};
+  main_table.ExecutePartitionedScan(&query_state, ScanFn);
+  EXPECT_EQ(NUM_AGGS, query_state.row_count_.load(std::memory_order_seq_cst));
+  EXPECT_EQ(0u, query_state.wrong_count_.load(std::memory_order_seq_cst));
+  EXPECT_GT(main_table.GetStatistics()->num_spills_, 1u);
+}
+
 }  // namespace terrier::execution::sql
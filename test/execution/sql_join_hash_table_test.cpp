@@ -1,12 +1,17 @@
 #include <tbb/tbb.h>
 
 #include <random>
+#include <string>
 #include <vector>
 
 #include "common/hash_util.h"
 #include "execution/exec/execution_settings.h"
 #include "execution/sql/join_hash_table.h"
 #include "execution/sql/thread_state_container.h"
+#include "execution/sql/tuple_id_list.h"
+#include "execution/sql/value.h"
+#include "execution/sql/vector_operations/vector_operations.h"
+#include "execution/sql/vector_projection.h"
 #include "execution/tpl_test.h"
 
 // TODO(WAN): can't FRIEND_TEST unless in the same namespace
@@ -19,6 +24,14 @@ struct Tuple {
   hash_t Hash() const { return common::HashUtil::Hash(a_); }
 };
 
+/// A tuple holding a string
+struct StringTuple {
+  uint64_t key_;
+  StringVal str_;
+
+  hash_t Hash() const { return common::HashUtil::Hash(key_); }
+};
+
 class JoinHashTableTest : public TplTest {
  public:
   JoinHashTableTest() : memory_(nullptr) {}
@@ -152,6 +165,40 @@ TEST_F(JoinHashTableTest, UniqueKeyConciseTableTest) { BuildAndProbeTest<true>(4
 // NOLINTNEXTLINE
 TEST_F(JoinHashTableTest, DuplicateKeyLookupConciseTableTest) { BuildAndProbeTest<true>(400, 5); }
 
+// Probe tuples are filtered through the bloom filter without losing any tuple that has a join partner
+// NOLINTNEXTLINE
+TEST_F(JoinHashTableTest, BloomFilterProbeTest) {
+  exec::ExecutionSettings exec_settings{};
+  const uint32_t num_build = 100;
+  const uint32_t num_probe = common::Constants::K_DEFAULT_VECTOR_SIZE;
+
+  // Only even keys are in the table
+  JoinHashTable join_hash_table(exec_settings, Memory(), sizeof(Tuple));
+  for (uint32_t i = 0; i < num_build; i++) {
+    auto tuple = Tuple{2 * i, 1, 2};
+    *reinterpret_cast<Tuple *>(join_hash_table.AllocInputTuple(tuple.Hash())) = tuple;
+  }
+  join_hash_table.Build();
+  EXPECT_FALSE(join_hash_table.HasBloomFilter());
+  join_hash_table.BuildBloomFilter();
+  EXPECT_TRUE(join_hash_table.HasBloomFilter());
+
+  // Probe with all keys in [0, num_probe)
+  VectorProjection vector_projection;
+  vector_projection.Initialize({TypeId::BigInt});
+  vector_projection.Reset(num_probe);
+  VectorOps::Generate(vector_projection.GetColumn(0), 0, 1);
+  TupleIdList tid_list(num_probe);
+  tid_list.AddAll();
+  join_hash_table.FilterProbeBatch(&vector_projection, {0}, &tid_list);
+
+  // No key in the table may be filtered out, and only a few false positives may remain
+  for (uint32_t i = 0; i < num_build; i++) {
+    EXPECT_TRUE(tid_list.Contains(2 * i));
+  }
+  EXPECT_LT(tid_list.GetTupleCount(), num_build + (num_probe - num_build) / 10);
+}
+
 // NOLINTNEXTLINE
 TEST_F(JoinHashTableTest, ParallelBuildTest) {
   exec::ExecutionSettings exec_settings{};
@@ -210,6 +257,167 @@ TEST_F(JoinHashTableTest, ParallelBuildTest) {
   }
 }
 
+// Build tuples that do not fit in the memory budget are spilled to partitions. Probe tuples of partitions that are not
+// in memory are spilled too, and probed once their partition is loaded
+// NOLINTNEXTLINE
+TEST_F(JoinHashTableTest, SpillTest) {
+  exec::ExecutionSettings exec_settings{};
+  const uint32_t num_tuples = 10000;
+  const uint32_t dup_scale_factor = 2;
+
+  // The strings are too long to be inlined, so spilled tuples point to them
+  std::vector<std::string> strings;
+  for (uint32_t i = 0; i < num_tuples; i++) {
+    strings.push_back("a string that does not fit in a varlen entry #" + std::to_string(i));
+  }
+
+  // Only a twentieth of the build tuples fit in memory, so the partitions are split once more
+  JoinHashTable join_hash_table(exec_settings, Memory(), sizeof(StringTuple));
+  join_hash_table.EnableSpilling(
+      num_tuples * dup_scale_factor / 20 * HashTableEntry::ComputeEntrySize(sizeof(StringTuple)), sizeof(uint64_t));
+  for (uint32_t rep = 0; rep < dup_scale_factor; rep++) {
+    for (uint32_t i = 0; i < num_tuples; i++) {
+      auto tuple = StringTuple{i, StringVal(strings[i].c_str(), strings[i].length())};
+      *reinterpret_cast<StringTuple *>(join_hash_table.AllocInputTuple(tuple.Hash())) = tuple;
+    }
+  }
+  join_hash_table.Build();
+  EXPECT_TRUE(join_hash_table.IsSpilled());
+  EXPECT_GT(join_hash_table.GetNumPartitions(), JoinHashTable::NUM_SPILL_PARTITIONS);
+
+  // The bloom filter covers the spilled tuples
+  join_hash_table.BuildBloomFilter();
+  for (uint32_t i = 0; i < num_tuples; i++) {
+    EXPECT_TRUE(join_hash_table.GetBloomFilter()->Contains(common::HashUtil::Hash(uint64_t{i})));
+  }
+
+  std::vector<uint32_t> counts(num_tuples, 0);
+  auto probe = [&](const uint64_t key) {
+    for (auto iter = join_hash_table.Lookup<false>(common::HashUtil::Hash(key)); iter.HasNext();) {
+      auto *matched = reinterpret_cast<const StringTuple *>(iter.GetMatchPayload());
+      if (matched->key_ == key) {
+        EXPECT_EQ(strings[key], matched->str_.StringView());
+        counts[key]++;
+      }
+    }
+  };
+
+  // Keys of the partition in memory are probed right away, the others are written out
+  uint64_t num_resident = 0;
+  for (uint64_t i = 0; i < num_tuples; i++) {
+    const hash_t hash = common::HashUtil::Hash(i);
+    if (join_hash_table.IsResident(hash)) {
+      num_resident++;
+      probe(i);
+    } else {
+      join_hash_table.SpillProbeTuple(hash, reinterpret_cast<const byte *>(&i));
+    }
+  }
+  EXPECT_GT(num_resident, 0);
+  EXPECT_LT(num_resident, num_tuples);
+
+  // Each spilled key is read back once, along with the partition it finds all of its matches in
+  uint64_t num_partitions = 1;
+  while (join_hash_table.NextPartition()) {
+    num_partitions++;
+    uint64_t key;
+    while (join_hash_table.ReadProbeTuple(reinterpret_cast<byte *>(&key))) {
+      EXPECT_TRUE(join_hash_table.IsResident(common::HashUtil::Hash(key)));
+      probe(key);
+    }
+  }
+  EXPECT_EQ(join_hash_table.GetNumPartitions(), num_partitions);
+  for (uint32_t i = 0; i < num_tuples; i++) {
+    EXPECT_EQ(dup_scale_factor, counts[i]) << "Key [" << i << "] found " << counts[i] << " matches";
+  }
+}
+
+// A table that does not exceed its memory budget is probed with all probe tuples right away
+// NOLINTNEXTLINE
+TEST_F(JoinHashTableTest, NoSpillTest) {
+  exec::ExecutionSettings exec_settings{};
+  const uint32_t num_tuples = 1000;
+
+  JoinHashTable join_hash_table(exec_settings, Memory(), sizeof(Tuple));
+  join_hash_table.EnableSpilling(num_tuples * HashTableEntry::ComputeEntrySize(sizeof(Tuple)), sizeof(Tuple));
+  PopulateJoinHashTable(&join_hash_table, num_tuples, 1);
+  join_hash_table.Build();
+  EXPECT_FALSE(join_hash_table.IsSpilled());
+  EXPECT_EQ(1u, join_hash_table.GetNumPartitions());
+
+  for (uint64_t i = 0; i < num_tuples; i++) {
+    EXPECT_TRUE(join_hash_table.IsResident(Tuple{i, 0, 0, 0}.Hash()));
+  }
+  EXPECT_FALSE(join_hash_table.NextPartition());
+}
+
+// Thread-local tables that spill on their own, or together exceed the memory budget, are merged into partitions
+// NOLINTNEXTLINE
+TEST_F(JoinHashTableTest, ParallelSpillTest) {
+  exec::ExecutionSettings exec_settings{};
+  tbb::task_scheduler_init sched;
+
+  const uint32_t num_tuples = 10000;
+  const uint32_t num_thread_local_tables = 4;
+  const uint64_t memory_budget = num_tuples / 4 * HashTableEntry::ComputeEntrySize(sizeof(Tuple));
+
+  MemoryPool memory(nullptr);
+  ThreadStateContainer container(&memory);
+
+  struct Context {
+    MemoryPool *memory_;
+    exec::ExecutionSettings *settings_;
+    uint64_t memory_budget_;
+  };
+
+  Context ctx{&memory, &exec_settings, memory_budget};
+
+  container.Reset(
+      sizeof(JoinHashTable),
+      [](auto *ctx, auto *s) {
+        auto context = reinterpret_cast<Context *>(ctx);
+        auto *jht = new (s) JoinHashTable(*context->settings_, context->memory_, sizeof(Tuple));
+        jht->EnableSpilling(context->memory_budget_, sizeof(uint64_t));
+      },
+      [](auto *ctx, auto *s) { reinterpret_cast<JoinHashTable *>(s)->~JoinHashTable(); }, &ctx);
+
+  LaunchParallel(num_thread_local_tables, [&](auto tid) {
+    auto *jht = container.AccessCurrentThreadStateAs<JoinHashTable>();
+    PopulateJoinHashTable(jht, num_tuples, 1);
+  });
+
+  JoinHashTable main_jht(exec_settings, &memory, sizeof(Tuple));
+  main_jht.EnableSpilling(memory_budget, sizeof(uint64_t));
+  main_jht.MergeParallel(&container, 0);
+  EXPECT_TRUE(main_jht.IsSpilled());
+
+  // Probe tuples are written out by several threads at once
+  LaunchParallel(num_thread_local_tables, [&](auto tid) {
+    for (uint64_t i = tid; i < num_tuples; i += num_thread_local_tables) {
+      const hash_t hash = Tuple{i, 1, 2, 3}.Hash();
+      if (!main_jht.IsResident(hash)) main_jht.SpillProbeTuple(hash, reinterpret_cast<const byte *>(&i));
+    }
+  });
+
+  // Each key was inserted once by every thread-local table
+  std::vector<uint32_t> counts(num_tuples, 0);
+  auto probe = [&](const uint64_t key) {
+    for (auto iter = main_jht.Lookup<false>(Tuple{key, 1, 2, 3}.Hash()); iter.HasNext();) {
+      if (reinterpret_cast<const Tuple *>(iter.GetMatchPayload())->a_ == key) counts[key]++;
+    }
+  };
+  for (uint64_t i = 0; i < num_tuples; i++) {
+    if (main_jht.IsResident(Tuple{i, 1, 2, 3}.Hash())) probe(i);
+  }
+  while (main_jht.NextPartition()) {
+    uint64_t key;
+    while (main_jht.ReadProbeTuple(reinterpret_cast<byte *>(&key))) probe(key);
+  }
+  for (uint32_t i = 0; i < num_tuples; i++) {
+    EXPECT_EQ(num_thread_local_tables, counts[i]);
+  }
+}
+
 #if 0
 // NOLINTNEXTLINE
 TEST_F(JoinHashTableTest, PerfTest) {
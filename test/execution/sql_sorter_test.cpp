@@ -7,6 +7,7 @@
 #include <random>
 #include <vector>
 
+#include "common/constants.h"
 #include "execution/sql/sorter.h"
 #include "execution/sql/thread_state_container.h"
 #include "execution/sql_test.h"
@@ -165,11 +166,12 @@ struct TestTuple {
 };
 
 // Generic function to perform a parallel sort. The input parameter indicates the sizes of each
-// thread-local sorter that will be created.
+// thread-local sorter that will be created. If a memory budget is given, all sorters may spill.
 //
 // The template argument controls the size of the tuple.
 template <uint32_t N>
-void TestParallelSort(exec::ExecutionContext *exec_ctx, const std::vector<uint32_t> &sorter_sizes) {
+void TestParallelSort(exec::ExecutionContext *exec_ctx, const std::vector<uint32_t> &sorter_sizes,
+                      const uint64_t memory_budget = 0) {
   tbb::task_scheduler_init sched;
 
   // Comparison function
@@ -197,6 +199,9 @@ void TestParallelSort(exec::ExecutionContext *exec_ctx, const std::vector<uint32
     std::mt19937 mt(r());
     std::this_thread::sleep_for(std::chrono::microseconds(r() % 1000));
     auto *sorter = container.AccessCurrentThreadStateAs<Sorter>();
+    if (memory_budget != 0) {
+      sorter->EnableSpilling(memory_budget);
+    }
     for (uint32_t i = 0; i < sorter_sizes[tid]; i++) {
       auto *elem = reinterpret_cast<TestTuple<N> *>(sorter->AllocInputTuple());
       elem->key_ = mt() % 3333;
@@ -205,6 +210,9 @@ void TestParallelSort(exec::ExecutionContext *exec_ctx, const std::vector<uint32
 
   // Main parallel sort
   Sorter main(exec_ctx->GetMemoryPool(), cmp_fn, sizeof(TestTuple<N>));
+  if (memory_budget != 0) {
+    main.EnableSpilling(memory_budget);
+  }
   main.SortParallel(&container, 0);
 
   uint32_t expected_total_size =
@@ -215,6 +223,7 @@ void TestParallelSort(exec::ExecutionContext *exec_ctx, const std::vector<uint32
 
   // Ensure sortedness
   const TestTuple<N> *prev = nullptr;
+  uint32_t num_rows = 0;
   for (SorterIterator iter(main); iter.HasNext(); iter.Next()) {
     auto *curr = iter.GetRowAs<TestTuple<N>>();
     EXPECT_TRUE(curr != nullptr);
@@ -222,7 +231,9 @@ void TestParallelSort(exec::ExecutionContext *exec_ctx, const std::vector<uint32
       EXPECT_LE(cmp_fn(prev, curr), 0);
     }
     prev = curr;
+    num_rows++;
   }
+  EXPECT_EQ(expected_total_size, num_rows);
 }
 
 // NOLINTNEXTLINE
@@ -260,4 +271,117 @@ TEST_F(SorterTest, UnbalancedParallelSortTest) {
   }
 }
 
+// NOLINTNEXTLINE
+TEST_F(SorterTest, SpilledSortTest) {
+  using Tuple = TestTuple<2>;
+  const auto cmp_fn = [](const void *left, const void *right) {
+    return reinterpret_cast<const Tuple *>(left)->Compare(*reinterpret_cast<const Tuple *>(right));
+  };
+
+  // Each run holds 100 tuples, so that there are more runs than can be merged at once.
+  const uint32_t num_tuples = 100 * (Sorter::MAX_MERGE_FAN_IN + 10) + 17;
+  const uint64_t memory_budget = 2 * 100 * (sizeof(Tuple) + sizeof(const byte *));
+
+  MemoryPool memory(nullptr);
+  Sorter sorter(&memory, cmp_fn, sizeof(Tuple));
+  sorter.EnableSpilling(memory_budget);
+
+  std::vector<uint32_t> reference;
+  for (uint32_t i = 0; i < num_tuples; i++) {
+    auto *tuple = reinterpret_cast<Tuple *>(sorter.AllocInputTuple());
+    tuple->key_ = generator_() % 5000;
+    tuple->data_[0] = i;
+    reference.push_back(tuple->key_);
+  }
+  std::sort(reference.begin(), reference.end());
+
+  sorter.Sort();
+  EXPECT_TRUE(sorter.IsSorted());
+  EXPECT_TRUE(sorter.IsSpilled());
+  EXPECT_EQ(num_tuples, sorter.GetTupleCount());
+
+  // The merged output must match, and rows must stay valid for a vector's worth of rows.
+  {
+    SorterIterator iter(sorter);
+    std::vector<const Tuple *> last_rows;
+    for (uint32_t i = 0; i < num_tuples; i++, iter.Next()) {
+      ASSERT_TRUE(iter.HasNext());
+      EXPECT_EQ(num_tuples - i, iter.NumRemaining());
+      EXPECT_EQ(reference[i], iter.GetRowAs<Tuple>()->key_);
+      last_rows.push_back(iter.GetRowAs<Tuple>());
+      if (last_rows.size() == common::Constants::K_DEFAULT_VECTOR_SIZE) {
+        for (uint32_t j = 0; j < last_rows.size(); j++) {
+          EXPECT_EQ(reference[i + 1 - last_rows.size() + j], last_rows[j]->key_);
+        }
+        last_rows.clear();
+      }
+    }
+    EXPECT_FALSE(iter.HasNext());
+  }
+
+  // The runs can be merged again, skipping rows across batches.
+  {
+    SorterIterator iter(sorter);
+    const uint32_t num_skipped = 3 * common::Constants::K_DEFAULT_VECTOR_SIZE + 5;
+    iter.AdvanceBy(num_skipped);
+    EXPECT_EQ(num_tuples - num_skipped, iter.NumRemaining());
+    EXPECT_EQ(reference[num_skipped], iter.GetRowAs<Tuple>()->key_);
+    iter.AdvanceBy(num_tuples);
+    EXPECT_FALSE(iter.HasNext());
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(SorterTest, SpilledSortMergeLevelsTest) {
+  using Tuple = TestTuple<2>;
+  const auto cmp_fn = [](const void *left, const void *right) {
+    return reinterpret_cast<const Tuple *>(left)->Compare(*reinterpret_cast<const Tuple *>(right));
+  };
+
+  // Each run holds 4 tuples. Enough runs are spilled to merge a run of the second level, and to leave full first
+  // and zeroth levels that, together, exceed the fan-in.
+  constexpr uint32_t fan_in = Sorter::MAX_MERGE_FAN_IN;
+  const uint32_t num_runs = fan_in * fan_in + (fan_in - 1) * fan_in + (fan_in - 1);
+  const uint32_t num_tuples = 4 * num_runs + 3;
+  const uint64_t memory_budget = 2 * 4 * (sizeof(Tuple) + sizeof(const byte *));
+
+  MemoryPool memory(nullptr);
+  Sorter sorter(&memory, cmp_fn, sizeof(Tuple));
+  sorter.EnableSpilling(memory_budget);
+
+  std::vector<uint32_t> reference;
+  for (uint32_t i = 0; i < num_tuples; i++) {
+    auto *tuple = reinterpret_cast<Tuple *>(sorter.AllocInputTuple());
+    tuple->key_ = generator_() % 50000;
+    tuple->data_[0] = i;
+    reference.push_back(tuple->key_);
+  }
+  std::sort(reference.begin(), reference.end());
+
+  sorter.Sort();
+  EXPECT_TRUE(sorter.IsSpilled());
+  EXPECT_EQ(num_tuples, sorter.GetTupleCount());
+
+  SorterIterator iter(sorter);
+  for (uint32_t i = 0; i < num_tuples; i++, iter.Next()) {
+    ASSERT_TRUE(iter.HasNext());
+    EXPECT_EQ(reference[i], iter.GetRowAs<Tuple>()->key_);
+  }
+  EXPECT_FALSE(iter.HasNext());
+}
+
+// NOLINTNEXTLINE
+TEST_F(SorterTest, ParallelSpilledSortTest) {
+  auto exec_ctx = MakeExecCtx();
+  // Room for 100 tuples per run
+  const uint64_t memory_budget = 2 * 100 * (sizeof(TestTuple<2>) + sizeof(const byte *));
+  // Thread-local sorters whose runs together exceed the merge fan-in, that spill on their own, that only spill
+  // together, and that fit in memory
+  TestParallelSort<2>(exec_ctx.get(), {5000, 5000}, memory_budget);
+  TestParallelSort<2>(exec_ctx.get(), {1000, 1000, 1000, 1000}, memory_budget);
+  TestParallelSort<2>(exec_ctx.get(), {0, 10, 5000, 100}, memory_budget);
+  TestParallelSort<2>(exec_ctx.get(), {60, 60, 60}, memory_budget);
+  TestParallelSort<2>(exec_ctx.get(), {10, 10}, memory_budget);
+}
+
 }  // namespace terrier::execution::sql::test
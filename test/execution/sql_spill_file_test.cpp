@@ -0,0 +1,65 @@
+#include <numeric>
+#include <vector>
+
+#include "common/error/exception.h"
+#include "execution/sql/spill_file.h"
+#include "execution/tpl_test.h"
+
+namespace terrier::execution::sql::test {
+
+class SpillFileTest : public TplTest {};
+
+// NOLINTNEXTLINE
+TEST_F(SpillFileTest, EmptyFile) {
+  SpillFile file;
+  EXPECT_EQ(0u, file.GetSize());
+
+  uint32_t val;
+  file.Rewind();
+  EXPECT_FALSE(file.Read(&val, sizeof(val)));
+}
+
+// NOLINTNEXTLINE
+TEST_F(SpillFileTest, WriteAndReadBack) {
+  // Enough values to fill the buffer a few times over
+  std::vector<uint64_t> vals(SpillFile::BUFFER_SIZE);
+  std::iota(vals.begin(), vals.end(), 0);
+
+  // Values are written one at a time and in blocks that cross the end of the buffer
+  SpillFile file;
+  file.Write(vals.data(), sizeof(uint64_t));
+  file.Write(vals.data() + 1, (vals.size() - 2) * sizeof(uint64_t));
+  file.Write(&vals.back(), sizeof(uint64_t));
+  EXPECT_EQ(vals.size() * sizeof(uint64_t), file.GetSize());
+
+  // The file can be read back any number of times
+  for (uint32_t run = 0; run < 2; run++) {
+    file.Rewind();
+    uint64_t val;
+    for (uint64_t i = 0; i < vals.size(); i++) {
+      ASSERT_TRUE(file.Read(&val, sizeof(val)));
+      EXPECT_EQ(i, val);
+    }
+    EXPECT_FALSE(file.Read(&val, sizeof(val)));
+  }
+
+  // All at once
+  std::vector<uint64_t> read_vals(vals.size());
+  file.Rewind();
+  ASSERT_TRUE(file.Read(read_vals.data(), read_vals.size() * sizeof(uint64_t)));
+  EXPECT_EQ(vals, read_vals);
+}
+
+// NOLINTNEXTLINE
+TEST_F(SpillFileTest, ReadPastEnd) {
+  const uint32_t val = 44;
+  SpillFile file;
+  file.Write(&val, sizeof(val));
+  file.Rewind();
+
+  // Only half of the requested bytes are in the file
+  uint64_t big_val;
+  EXPECT_THROW(file.Read(&big_val, sizeof(big_val)), ExecutionException);
+}
+
+}  // namespace terrier::execution::sql::test
@@ -2,10 +2,15 @@
 #include <memory>
 #include <vector>
 
+#include "catalog/catalog.h"
+#include "catalog/catalog_accessor.h"
 #include "catalog/catalog_defs.h"
 #include "execution/sql/table_vector_iterator.h"
 #include "execution/sql_test.h"
 #include "execution/util/timer.h"
+#include "storage/block_compactor.h"
+#include "storage/sql_table.h"
+#include "transaction/transaction_manager.h"
 
 namespace terrier::execution::sql::test {
 
@@ -168,4 +173,112 @@ TEST_F(TableVectorIteratorTest, ParallelScanTest) {
   EXPECT_EQ(sql::TEST1_SIZE, aggregate_tuple_count);
 }
 
+class TableVectorIteratorInPlaceTest : public TplTest {
+ public:
+  void SetUp() override {
+    TplTest::SetUp();
+    // The GC runs by hand, so that the test decides when the block can be frozen
+    db_main_ = terrier::DBMain::Builder().SetUseGC(true).SetUseCatalog(true).Build();
+    txn_manager_ = db_main_->GetTransactionLayer()->GetTransactionManager();
+    catalog_ = db_main_->GetCatalogLayer()->GetCatalog();
+  }
+
+ protected:
+  std::unique_ptr<DBMain> db_main_;
+  common::ManagedPointer<transaction::TransactionManager> txn_manager_;
+  common::ManagedPointer<catalog::Catalog> catalog_;
+};
+
+// This test freezes the block of a table and reads it in place through a TableVectorIterator. Before advancing, it
+// updates the tuples read from the same thread, as an UPDATE over a scan of its own table does. The values the iterator
+// has already read must not change.
+// NOLINTNEXTLINE
+TEST_F(TableVectorIteratorInPlaceTest, UpdateWhileReadingInPlaceTest) {
+  constexpr int32_t num_tuples = 100;
+  auto gc = db_main_->GetStorageLayer()->GetGarbageCollector();
+
+  // Create and fill a table of integers
+  auto *txn = txn_manager_->BeginTransaction();
+  const catalog::db_oid_t db_oid = catalog_->GetDatabaseOid(common::ManagedPointer(txn), catalog::DEFAULT_DATABASE);
+  auto accessor = catalog_->GetAccessor(common::ManagedPointer(txn), db_oid, DISABLED);
+  std::vector<catalog::Schema::Column> cols;
+  cols.emplace_back("col", type::TypeId::INTEGER, false, parser::ConstantValueExpression(type::TypeId::INTEGER));
+  const catalog::table_oid_t table_oid =
+      accessor->CreateTable(accessor->GetDefaultNamespace(), "frozen_table", catalog::Schema(cols));
+  ASSERT_NE(table_oid, catalog::INVALID_TABLE_OID);
+  const catalog::col_oid_t col_oid = accessor->GetSchema(table_oid).GetColumn("col").Oid();
+  auto *table = new storage::SqlTable(db_main_->GetStorageLayer()->GetBlockStore(), accessor->GetSchema(table_oid));
+  ASSERT_TRUE(accessor->SetTablePointer(table_oid, table));
+  const storage::ProjectedRowInitializer initializer = table->InitializerForProjectedRow({col_oid});
+  for (int32_t i = 0; i < num_tuples; i++) {
+    auto *redo = txn->StageWrite(db_oid, table_oid, initializer);
+    *reinterpret_cast<int32_t *>(redo->Delta()->AccessForceNotNull(0)) = i;
+    table->Insert(common::ManagedPointer(txn), redo);
+  }
+  txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  // Compact and gather the block, cleaning up the versions of each pass, until it is frozen
+  storage::RawBlock *block = table->begin()->GetBlock();
+  storage::BlockCompactor compactor;
+  gc->PerformGarbageCollection();
+  gc->PerformGarbageCollection();
+  compactor.PutInQueue(block);
+  compactor.ProcessCompactionQueue(db_main_->GetTransactionLayer()->GetDeferredActionManager().Get(),
+                                   txn_manager_.Get());  // compaction pass
+  gc->PerformGarbageCollection();
+  compactor.PutInQueue(block);
+  compactor.ProcessCompactionQueue(db_main_->GetTransactionLayer()->GetDeferredActionManager().Get(),
+                                   txn_manager_.Get());  // gathering pass
+  ASSERT_EQ(storage::BlockState::FROZEN, block->controller_.GetBlockState()->load());
+
+  txn = txn_manager_->BeginTransaction();
+  accessor = catalog_->GetAccessor(common::ManagedPointer(txn), db_oid, DISABLED);
+  exec::ExecutionSettings exec_settings;
+  exec::ExecutionContext exec_ctx(db_oid, common::ManagedPointer(txn), nullptr, nullptr,
+                                  common::ManagedPointer(accessor), exec_settings);
+  std::array<uint32_t, 1> col_oids{col_oid.UnderlyingValue()};
+  {
+    TableVectorIterator iter(&exec_ctx, table_oid.UnderlyingValue(), col_oids.data(),
+                             static_cast<uint32_t>(col_oids.size()));
+    iter.Init();
+    ASSERT_TRUE(iter.Advance());
+    VectorProjectionIterator *vpi = iter.GetVectorProjectionIterator();
+    const byte *data = vpi->GetVectorProjection()->GetColumn(0)->GetData();
+    ASSERT_TRUE(data > reinterpret_cast<byte *>(block) &&
+                data < reinterpret_cast<byte *>(block) + common::Constants::BLOCK_SIZE)
+        << "The frozen block should be read in place";
+
+    // Update every tuple read while the projection is still in use
+    std::vector<storage::TupleSlot> slots;
+    for (; vpi->HasNext(); vpi->Advance()) slots.push_back(vpi->GetCurrentSlot());
+    ASSERT_EQ(static_cast<size_t>(num_tuples), slots.size());
+    for (const storage::TupleSlot slot : slots) {
+      auto *redo = txn->StageWrite(db_oid, table_oid, initializer);
+      redo->SetTupleSlot(slot);
+      *reinterpret_cast<int32_t *>(redo->Delta()->AccessForceNotNull(0)) = -1;
+      EXPECT_TRUE(table->Update(common::ManagedPointer(txn), redo));
+    }
+
+    // The projection still has the values that were read, not the ones written since
+    vpi->Reset();
+    int32_t expected = 0;
+    for (; vpi->HasNext(); vpi->Advance()) {
+      const auto *val = vpi->GetValue<int32_t, false>(0, nullptr);
+      EXPECT_EQ(expected++, *val);
+    }
+    EXPECT_EQ(num_tuples, expected);
+    EXPECT_FALSE(iter.Advance());
+  }
+
+  // The writes themselves went to the table
+  auto *buffer = common::AllocationUtil::AllocateAligned(initializer.ProjectedRowSize());
+  for (auto it = table->begin(); it != table->end(); it++) {
+    storage::ProjectedRow *row = initializer.InitializeRow(buffer);
+    if (table->Select(common::ManagedPointer(txn), *it, row))
+      EXPECT_EQ(-1, *reinterpret_cast<int32_t *>(row->AccessWithNullCheck(0)));
+  }
+  delete[] buffer;
+  txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+}
+
 }  // namespace terrier::execution::sql::test
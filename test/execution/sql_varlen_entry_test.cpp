@@ -2,6 +2,8 @@
 #include <limits>
 #include <memory>
 #include <random>
+#include <string>
+#include <vector>
 
 #include "execution/sql/runtime_types.h"
 #include "execution/tpl_test.h"
@@ -91,4 +93,31 @@ TEST_F(VarlenEntryTest, Comparison) {
   }
 }
 
+// NOLINTNEXTLINE
+TEST_F(VarlenEntryTest, PrefixComparison) {
+  // Strings of up to 20 bytes over a tiny alphabet, including zero bytes, so that prefixes often tie and short strings
+  // are often prefixes of longer ones
+  std::default_random_engine gen(std::random_device{}());  // NOLINT
+  std::uniform_int_distribution<uint32_t> size_dist(0, 20);
+  std::uniform_int_distribution<uint8_t> char_dist(0, 2);
+  std::vector<std::string> strings;
+  for (uint32_t i = 0; i < 200; i++) {
+    std::string str(size_dist(gen), '\0');
+    for (auto &c : str) c = static_cast<char>(char_dist(gen) * 0x60);
+    strings.push_back(str);
+  }
+
+  const auto sign = [](int32_t value) { return (value > 0) - (value < 0); };
+  for (const auto &left : strings) {
+    const auto left_entry = storage::VarlenEntry::Create(left);
+    for (const auto &right : strings) {
+      const auto right_entry = storage::VarlenEntry::Create(right);
+      EXPECT_EQ(sign(left.compare(right)), sign(storage::VarlenEntry::Compare(left_entry, right_entry)));
+      EXPECT_EQ(left == right, left_entry == right_entry);
+      EXPECT_EQ(left.compare(0, right.size(), right) == 0 && left.size() >= right.size(),
+                left_entry.StartsWith(reinterpret_cast<const byte *>(right.data()), right.size()));
+    }
+  }
+}
+
 }  // namespace terrier::execution::sql::test
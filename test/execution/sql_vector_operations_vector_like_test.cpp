@@ -75,6 +75,50 @@ TEST_F(VectorLikeTest, LikeConstant) {
   EXPECT_EQ(0u, tid_list.GetTupleCount());
 }
 
+// NOLINTNEXTLINE
+TEST_F(VectorLikeTest, LikeConstantLiteralPrefix) {
+  exec::ExecutionSettings exec_settings{};
+  auto strings = MakeVarcharVector({"fi", "first", "fifteen characters", "first of the long strings", "fourth", "f"},
+                                   {false, false, false, false, false, false});
+  auto tid_list = TupleIdList(strings->GetSize());
+
+  // Literal prefix within the prefix stored in the entries
+  {
+    auto pattern = ConstantVector(GenericValue::CreateVarchar("fi%s"));
+    tid_list.AddAll();
+    VectorOps::SelectLike(exec_settings, *strings, pattern, &tid_list);
+    EXPECT_EQ(2u, tid_list.GetTupleCount());
+    EXPECT_EQ(2u, tid_list[0]);
+    EXPECT_EQ(3u, tid_list[1]);
+
+    tid_list.AddAll();
+    VectorOps::SelectNotLike(exec_settings, *strings, pattern, &tid_list);
+    EXPECT_EQ(4u, tid_list.GetTupleCount());
+  }
+
+  // Literal prefix longer than the prefix stored in the entries
+  {
+    auto pattern = ConstantVector(GenericValue::CreateVarchar("first_of%"));
+    tid_list.AddAll();
+    VectorOps::SelectLike(exec_settings, *strings, pattern, &tid_list);
+    EXPECT_EQ(1u, tid_list.GetTupleCount());
+    EXPECT_EQ(3u, tid_list[0]);
+
+    tid_list.AddAll();
+    VectorOps::SelectNotLike(exec_settings, *strings, pattern, &tid_list);
+    EXPECT_EQ(5u, tid_list.GetTupleCount());
+  }
+
+  // No wildcards at all
+  {
+    auto pattern = ConstantVector(GenericValue::CreateVarchar("first"));
+    tid_list.AddAll();
+    VectorOps::SelectLike(exec_settings, *strings, pattern, &tid_list);
+    EXPECT_EQ(1u, tid_list.GetTupleCount());
+    EXPECT_EQ(1u, tid_list[0]);
+  }
+}
+
 // NOLINTNEXTLINE
 TEST_F(VectorLikeTest, LikeVectorOfPatterns) {
   exec::ExecutionSettings exec_settings{};
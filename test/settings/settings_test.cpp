@@ -1,3 +1,5 @@
+#include <gflags/gflags.h>
+
 #include <memory>
 #include <string>
 #include <thread>  // NOLINT
@@ -10,6 +12,8 @@
 #include "settings/settings_manager.h"
 #include "test_util/test_harness.h"
 
+DECLARE_int32(block_store_huge_page_size);
+
 namespace terrier::settings {
 
 class SettingsTests : public TerrierTest {
@@ -112,6 +116,30 @@ TEST_F(SettingsTests, InvalidValueTest) {
   EXPECT_EQ(common::ActionState::FAILURE, action_context->GetState());
 }
 
+// Test that huge page sizes other than the ones blocks can be carved out of are rejected when the settings are loaded
+// NOLINTNEXTLINE
+TEST_F(SettingsTests, HugePageSizeTest) {
+  const auto original = FLAGS_block_store_huge_page_size;
+  for (const int32_t huge_page_size : {0, 2, 1024}) {
+    FLAGS_block_store_huge_page_size = huge_page_size;
+    std::unordered_map<Param, ParamInfo> param_map;
+    SettingsManager::ConstructParamMap(param_map);
+    EXPECT_NO_THROW(SettingsManager(common::ManagedPointer<DBMain>(nullptr), std::move(param_map)));
+  }
+  for (const int32_t huge_page_size : {1, 4, 512, 1023}) {
+    FLAGS_block_store_huge_page_size = huge_page_size;
+    std::unordered_map<Param, ParamInfo> param_map;
+    SettingsManager::ConstructParamMap(param_map);
+    try {
+      SettingsManager settings_manager(common::ManagedPointer<DBMain>(nullptr), std::move(param_map));
+      ADD_FAILURE() << "Huge page size " << huge_page_size << " was accepted";
+    } catch (SettingsException &e) {
+      EXPECT_EQ(e.code_, common::ErrorCode::ERRCODE_INVALID_PARAMETER_VALUE);
+    }
+  }
+  FLAGS_block_store_huge_page_size = original;
+}
+
 // NOLINTNEXTLINE
 TEST_F(SettingsTests, SetterCallbackTest) {
   // Invoke a setter callbacks to make sure that our callbacks get invoked correctly
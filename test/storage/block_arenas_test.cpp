@@ -0,0 +1,120 @@
+#include "storage/block_arenas.h"
+
+#include <cstring>
+#include <numeric>
+#include <thread>  // NOLINT
+#include <unordered_set>
+#include <vector>
+
+#include "test_util/multithread_test_util.h"
+#include "test_util/test_harness.h"
+
+namespace terrier::storage {
+
+struct BlockArenasTests : public TerrierTest {
+  static uint64_t TotalBlocks(const std::vector<uint64_t> &blocks_per_node) {
+    return std::accumulate(blocks_per_node.begin(), blocks_per_node.end(), static_cast<uint64_t>(0));
+  }
+};
+
+// Blocks carved out of arenas should be aligned, zeroed and distinct, and be counted on their node until deleted
+// NOLINTNEXTLINE
+TEST_F(BlockArenasTests, CarveBlocks) {
+  const uint64_t blocks_per_arena = BlockArenas::MIN_ARENA_SIZE / common::Constants::BLOCK_SIZE;
+  const uint64_t num_blocks = blocks_per_arena + blocks_per_arena / 2;
+  // Nothing is reused, so every released block goes back to the arenas
+  BlockStore block_store(num_blocks, 0, BlockAllocator(2, true));
+
+  std::vector<RawBlock *> blocks;
+  std::unordered_set<RawBlock *> distinct;
+  for (uint64_t i = 0; i < num_blocks; i++) {
+    RawBlock *block = block_store.Get();
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % common::Constants::BLOCK_SIZE, 0);
+    EXPECT_EQ(block->insert_head_.load(), 0);
+    EXPECT_EQ(block->version_synopsis_.load(), 0);
+    std::memset(block->content_, 0xFF, sizeof(block->content_));
+    blocks.push_back(block);
+    distinct.insert(block);
+  }
+  EXPECT_EQ(distinct.size(), num_blocks);
+  EXPECT_EQ(TotalBlocks(block_store.GetAllocator().BlocksPerNode()), num_blocks);
+
+  for (uint64_t i = 0; i < num_blocks / 2; i++) block_store.Release(blocks[i]);
+  EXPECT_EQ(TotalBlocks(block_store.GetAllocator().BlocksPerNode()), num_blocks - num_blocks / 2);
+
+  // Deleted blocks are handed out again, and cleared
+  for (uint64_t i = 0; i < num_blocks / 2; i++) {
+    blocks[i] = block_store.Get();
+    EXPECT_EQ(distinct.count(blocks[i]), 1);
+    EXPECT_EQ(blocks[i]->content_[0], byte{0});
+  }
+  EXPECT_EQ(TotalBlocks(block_store.GetAllocator().BlocksPerNode()), num_blocks);
+
+  for (auto *block : blocks) block_store.Release(block);
+  EXPECT_EQ(TotalBlocks(block_store.GetAllocator().BlocksPerNode()), 0);
+}
+
+// Threads allocating blocks concurrently should each get blocks of their own, counted on the node they ran on
+// NOLINTNEXTLINE
+TEST_F(BlockArenasTests, ConcurrentCarveBlocks) {
+  const uint32_t num_threads = MultiThreadTestUtil::HardwareConcurrency();
+  const uint32_t blocks_per_thread = 16;
+  BlockArenas arenas(2, true);
+  std::vector<std::vector<RawBlock *>> blocks(num_threads);
+
+  common::WorkerPool thread_pool(num_threads, {});
+  thread_pool.Startup();
+  MultiThreadTestUtil::RunThreadsUntilFinish(&thread_pool, num_threads, [&](uint32_t thread_id) {
+    for (uint32_t i = 0; i < blocks_per_thread; i++) {
+      RawBlock *block = arenas.New();
+      ASSERT_NE(block, nullptr);
+      block->insert_head_ = thread_id;
+      blocks[thread_id].push_back(block);
+    }
+  });
+
+  const auto blocks_per_node = arenas.BlocksPerNode();
+  EXPECT_EQ(blocks_per_node.size(), BlockArenas::NumSystemNodes());
+  EXPECT_EQ(TotalBlocks(blocks_per_node), num_threads * blocks_per_thread);
+  for (uint32_t thread_id = 0; thread_id < num_threads; thread_id++) {
+    for (auto *block : blocks[thread_id]) {
+      EXPECT_EQ(block->insert_head_.load(), thread_id);
+      arenas.Delete(block);
+    }
+  }
+  EXPECT_EQ(TotalBlocks(arenas.BlocksPerNode()), 0);
+}
+
+// Deleted blocks go back to the free list of their node, and are handed out again before any new arena is mapped. Not
+// NUMA aware, so that everything happens on one node even if the thread moves between nodes.
+// NOLINTNEXTLINE
+TEST_F(BlockArenasTests, ReuseFreeBlocks) {
+  const uint64_t blocks_per_arena = BlockArenas::MIN_ARENA_SIZE / common::Constants::BLOCK_SIZE;
+  BlockArenas arenas(2, false);
+  std::vector<RawBlock *> blocks;
+  for (uint64_t i = 0; i < blocks_per_arena; i++) blocks.push_back(arenas.New());
+  EXPECT_EQ(arenas.NumArenas(), 1);
+
+  const std::unordered_set<RawBlock *> deleted(blocks.begin(), blocks.begin() + blocks_per_arena / 2);
+  for (auto *block : deleted) arenas.Delete(block);
+  for (uint64_t i = 0; i < blocks_per_arena / 2; i++) {
+    blocks[i] = arenas.New();
+    EXPECT_EQ(deleted.count(blocks[i]), 1);
+  }
+  EXPECT_EQ(arenas.NumArenas(), 1);
+
+  for (auto *block : blocks) arenas.Delete(block);
+}
+
+// Only huge pages of 2 MB and 1 GB are supported, and blocks are allocated on the heap without them
+// NOLINTNEXTLINE
+TEST_F(BlockArenasTests, HugePageSize) {
+  EXPECT_THROW(BlockAllocator(4, false), std::runtime_error);
+  BlockAllocator heap(0, false);
+  EXPECT_TRUE(heap.BlocksPerNode().empty());
+  RawBlock *block = heap.New();
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % common::Constants::BLOCK_SIZE, 0);
+  heap.Delete(block);
+}
+
+}  // namespace terrier::storage
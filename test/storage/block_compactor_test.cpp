@@ -1,16 +1,23 @@
 #include "storage/block_compactor.h"
 
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <thread>  // NOLINT
 #include <unordered_map>
 #include <vector>
 
 #include "common/hash_util.h"
+#include "execution/sql/vector_projection.h"
+#include "main/db_main.h"
 #include "storage/block_access_controller.h"
 #include "storage/garbage_collector.h"
 #include "storage/storage_defs.h"
 #include "storage/tuple_access_strategy.h"
+#include "test_util/catalog_test_util.h"
 #include "test_util/storage_test_util.h"
 #include "test_util/test_harness.h"
 #include "transaction/deferred_action_manager.h"
+#include "transaction/transaction_util.h"
 
 #define EXPORT_TABLE_NAME "test_table.arrow"
 
@@ -387,4 +394,360 @@ TEST_F(BlockCompactorTest, DictionaryCompressionTest) {
   }
 }
 
+// This tests compacts and gathers a block of a table until it is frozen, and then scans it in place. It verifies that
+// the vector projection references the block's columns directly instead of copying them.
+// NOLINTNEXTLINE
+TEST_F(BlockCompactorTest, InPlaceScanTest) {
+  uint32_t repeat = 10;
+  for (uint32_t iteration = 0; iteration < repeat; iteration++) {
+    storage::BlockLayout layout = StorageTestUtil::RandomLayoutWithVarlens(100, &generator_);
+    storage::TupleAccessStrategy accessor(layout);
+    // This time we use the first block of the table, since we need to sequential scan it
+    storage::DataTable table(common::ManagedPointer<storage::BlockStore>(&block_store_), layout,
+                             storage::layout_version_t(0));
+    storage::RawBlock *block = table.begin()->GetBlock();
+
+    // Enable GC to cleanup transactions started by the block compactor
+    transaction::TimestampManager timestamp_manager;
+    transaction::DeferredActionManager deferred_action_manager{common::ManagedPointer(&timestamp_manager)};
+    transaction::TransactionManager txn_manager{common::ManagedPointer(&timestamp_manager),
+                                                common::ManagedPointer(&deferred_action_manager),
+                                                common::ManagedPointer(&buffer_pool_), true, DISABLED};
+    storage::GarbageCollector gc{common::ManagedPointer(&timestamp_manager),
+                                 common::ManagedPointer(&deferred_action_manager), common::ManagedPointer(&txn_manager),
+                                 DISABLED};
+
+    auto tuples = StorageTestUtil::PopulateBlockRandomly(&table, block, percent_empty_, &generator_);
+    auto num_tuples = tuples.size();
+
+    // Manually populate the block header's arrow metadata for test initialization
+    auto &arrow_metadata = accessor.GetArrowBlockMetadata(block);
+    for (storage::col_id_t col_id : layout.AllColumns()) {
+      if (layout.IsVarlen(col_id)) {
+        arrow_metadata.GetColumnInfo(layout, col_id).Type() = storage::ArrowColumnType::GATHERED_VARLEN;
+      } else {
+        arrow_metadata.GetColumnInfo(layout, col_id).Type() = storage::ArrowColumnType::FIXED_LENGTH;
+      }
+    }
+
+    storage::BlockCompactor compactor;
+    compactor.PutInQueue(block);
+    compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager);  // compaction pass
+
+    // Need to prune the version chain in order to make sure that the second pass succeeds
+    gc.PerformGarbageCollection();
+    compactor.PutInQueue(block);
+    compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager);  // gathering pass
+    EXPECT_EQ(storage::BlockState::FROZEN, block->controller_.GetBlockState()->load());
+
+    // Set up a vector projection over every column in the table
+    std::vector<storage::col_id_t> col_ids = StorageTestUtil::ProjectionListAllColumns(layout);
+    std::vector<execution::sql::TypeId> col_types;
+    for (const storage::col_id_t col_id : col_ids) {
+      switch (layout.AttrSize(col_id)) {
+        case 1:
+          col_types.push_back(execution::sql::TypeId::TinyInt);
+          break;
+        case 2:
+          col_types.push_back(execution::sql::TypeId::SmallInt);
+          break;
+        case 4:
+          col_types.push_back(execution::sql::TypeId::Integer);
+          break;
+        case 8:
+          col_types.push_back(execution::sql::TypeId::BigInt);
+          break;
+        default:
+          col_types.push_back(execution::sql::TypeId::Varchar);
+      }
+    }
+    execution::sql::VectorProjection vector_projection;
+    vector_projection.SetStorageColIds(col_ids);
+    vector_projection.Initialize(col_types);
+
+    // Every vector should point straight into the block, including the varlen entries that point to Arrow storage
+    uint32_t num_read = 0;
+    auto it = table.begin();
+    while (it->GetBlock() == block) {
+      storage::RawBlock *read_block = table.ScanFrozenInPlace(&it, &vector_projection);
+      ASSERT_EQ(block, read_block);
+      for (uint16_t i = 0; i < col_ids.size(); i++) {
+        const byte *expected = accessor.ColumnStart(block, col_ids[i]) + num_read * layout.AttrSize(col_ids[i]);
+        EXPECT_EQ(expected, vector_projection.GetColumn(i)->GetData());
+      }
+      num_read += vector_projection.GetSelectedTupleCount();
+      block->controller_.ReleaseInPlaceRead(&vector_projection);
+    }
+    EXPECT_EQ(num_tuples, num_read);
+
+    for (auto &entry : tuples) delete[] reinterpret_cast<byte *>(entry.second);  // reclaim memory used for bookkeeping
+
+    gc.PerformGarbageCollection();
+    gc.PerformGarbageCollection();  // Second call to deallocate.
+    // The table deallocates the gathered varlens of its own blocks
+  }
+}
+
+// This test checks that a cooling block that still has versions when the compactor first looks at it is frozen at a
+// later pass, without anyone putting it back into the queue.
+// NOLINTNEXTLINE
+TEST_F(BlockCompactorTest, RetryCoolingBlockTest) {
+  storage::BlockLayout layout = StorageTestUtil::RandomLayoutNoVarlen(100, &generator_);
+  storage::TupleAccessStrategy accessor(layout);
+  storage::DataTable table(common::ManagedPointer<storage::BlockStore>(&block_store_), layout,
+                           storage::layout_version_t(0));
+  storage::RawBlock *block = table.begin()->GetBlock();
+
+  transaction::TimestampManager timestamp_manager;
+  transaction::DeferredActionManager deferred_action_manager{common::ManagedPointer(&timestamp_manager)};
+  transaction::TransactionManager txn_manager{common::ManagedPointer(&timestamp_manager),
+                                              common::ManagedPointer(&deferred_action_manager),
+                                              common::ManagedPointer(&buffer_pool_), true, DISABLED};
+  storage::GarbageCollector gc{common::ManagedPointer(&timestamp_manager),
+                               common::ManagedPointer(&deferred_action_manager), common::ManagedPointer(&txn_manager),
+                               DISABLED};
+
+  // Leave gaps, so that the compaction pass writes to the block and does not ask for it to be requeued
+  auto tuples = StorageTestUtil::PopulateBlockRandomly(&table, block, 0.1, &generator_);
+  auto &arrow_metadata = accessor.GetArrowBlockMetadata(block);
+  for (storage::col_id_t col_id : layout.AllColumns())
+    arrow_metadata.GetColumnInfo(layout, col_id).Type() = storage::ArrowColumnType::FIXED_LENGTH;
+
+  storage::BlockCompactor compactor;
+  compactor.PutInQueue(block);
+  compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager);  // compaction pass
+  EXPECT_EQ(storage::BlockState::COOLING, block->controller_.GetBlockState()->load());
+
+  // The versions of the inserts are still around, so the block cannot be frozen yet
+  compactor.PutInQueue(block);
+  compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager);
+  EXPECT_EQ(storage::BlockState::COOLING, block->controller_.GetBlockState()->load());
+
+  // Once they are pruned, the next pass freezes the block on its own
+  gc.PerformGarbageCollection();
+  gc.PerformGarbageCollection();
+  compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager);
+  EXPECT_EQ(storage::BlockState::FROZEN, block->controller_.GetBlockState()->load());
+
+  for (auto &entry : tuples) delete[] reinterpret_cast<byte *>(entry.second);  // reclaim memory used for bookkeeping
+
+  gc.PerformGarbageCollection();
+  gc.PerformGarbageCollection();  // Second call to deallocate.
+}
+
+// This test checks that the compactor leaves the blocks of a table that may no longer be compacted, because it has
+// indexes, alone.
+// NOLINTNEXTLINE
+TEST_F(BlockCompactorTest, UncompactableTableTest) {
+  storage::BlockLayout layout = StorageTestUtil::RandomLayoutNoVarlen(100, &generator_);
+  storage::TupleAccessStrategy accessor(layout);
+  storage::DataTable table(common::ManagedPointer<storage::BlockStore>(&block_store_), layout,
+                           storage::layout_version_t(0));
+  storage::RawBlock *block = table.begin()->GetBlock();
+
+  transaction::TimestampManager timestamp_manager;
+  transaction::DeferredActionManager deferred_action_manager{common::ManagedPointer(&timestamp_manager)};
+  transaction::TransactionManager txn_manager{common::ManagedPointer(&timestamp_manager),
+                                              common::ManagedPointer(&deferred_action_manager),
+                                              common::ManagedPointer(&buffer_pool_), true, DISABLED};
+  storage::GarbageCollector gc{common::ManagedPointer(&timestamp_manager),
+                               common::ManagedPointer(&deferred_action_manager), common::ManagedPointer(&txn_manager),
+                               DISABLED};
+
+  auto tuples = StorageTestUtil::PopulateBlockRandomly(&table, block, 0.1, &generator_);
+  auto &arrow_metadata = accessor.GetArrowBlockMetadata(block);
+  for (storage::col_id_t col_id : layout.AllColumns())
+    arrow_metadata.GetColumnInfo(layout, col_id).Type() = storage::ArrowColumnType::FIXED_LENGTH;
+  gc.PerformGarbageCollection();
+  gc.PerformGarbageCollection();
+
+  // The block is neither compacted nor frozen, and every tuple stays where it was
+  table.DisallowCompaction();
+  storage::BlockCompactor compactor;
+  compactor.PutInQueue(block);
+  compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager);
+  compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager);
+  EXPECT_EQ(storage::BlockState::HOT, block->controller_.GetBlockState()->load());
+  for (auto &entry : tuples) EXPECT_TRUE(accessor.Allocated(entry.first));
+
+  for (auto &entry : tuples) delete[] reinterpret_cast<byte *>(entry.second);  // reclaim memory used for bookkeeping
+}
+
+// This test checks that the compactor can be made to forget about the blocks of a table that is being dropped, both
+// those queued and those cooling, so that it does not touch them once the table is freed.
+// NOLINTNEXTLINE
+TEST_F(BlockCompactorTest, DropUncompactableBlocksTest) {
+  storage::BlockLayout layout = StorageTestUtil::RandomLayoutNoVarlen(100, &generator_);
+  storage::TupleAccessStrategy accessor(layout);
+  auto *table = new storage::DataTable(common::ManagedPointer<storage::BlockStore>(&block_store_), layout,
+                                       storage::layout_version_t(0));
+  storage::RawBlock *block = table->begin()->GetBlock();
+
+  transaction::TimestampManager timestamp_manager;
+  transaction::DeferredActionManager deferred_action_manager{common::ManagedPointer(&timestamp_manager)};
+  transaction::TransactionManager txn_manager{common::ManagedPointer(&timestamp_manager),
+                                              common::ManagedPointer(&deferred_action_manager),
+                                              common::ManagedPointer(&buffer_pool_), true, DISABLED};
+  storage::GarbageCollector gc{common::ManagedPointer(&timestamp_manager),
+                               common::ManagedPointer(&deferred_action_manager), common::ManagedPointer(&txn_manager),
+                               DISABLED};
+
+  auto tuples = StorageTestUtil::PopulateBlockRandomly(table, block, 0.1, &generator_);
+  auto &arrow_metadata = accessor.GetArrowBlockMetadata(block);
+  for (storage::col_id_t col_id : layout.AllColumns())
+    arrow_metadata.GetColumnInfo(layout, col_id).Type() = storage::ArrowColumnType::FIXED_LENGTH;
+
+  // After the second pass the block is kept as a cooling block, because the versions of the inserts are still around.
+  // It is queued again on top of that.
+  storage::BlockCompactor compactor;
+  compactor.PutInQueue(block);
+  compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager);  // compaction pass
+  compactor.PutInQueue(block);
+  compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager);
+  EXPECT_EQ(storage::BlockState::COOLING, block->controller_.GetBlockState()->load());
+  compactor.PutInQueue(block);
+
+  // Drop the table as DROP TABLE does. The next pass must not touch the freed block, which the sanitizers would catch.
+  table->DisallowCompaction();
+  compactor.DropUncompactableBlocks();
+  for (auto &entry : tuples) delete[] reinterpret_cast<byte *>(entry.second);  // reclaim memory used for bookkeeping
+  gc.PerformGarbageCollection();
+  gc.PerformGarbageCollection();  // Second call to deallocate.
+  delete table;
+  compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager);
+}
+
+// Compaction does not work without garbage collection or together with the WAL, and asking for either is a
+// configuration error rather than something to assert on.
+// NOLINTNEXTLINE
+TEST_F(BlockCompactorTest, InvalidCompactionConfigurationTest) {
+  EXPECT_THROW(DBMain::Builder().SetUseCompaction(true).Build(), SettingsException);
+  EXPECT_THROW(DBMain::Builder().SetUseGC(true).SetUseLogging(true).SetUseCompaction(true).Build(), SettingsException);
+}
+
+// This test freezes a block, scans it in place, and then updates it from the same thread while the in-place read is
+// still held, as a query that updates the table it scans does. The update must not wait for its own thread's read, and
+// must not change what that read has already seen.
+// NOLINTNEXTLINE
+TEST_F(BlockCompactorTest, InPlaceScanThenUpdateTest) {
+  storage::BlockLayout layout = StorageTestUtil::RandomLayoutNoVarlen(100, &generator_);
+  storage::TupleAccessStrategy accessor(layout);
+  storage::DataTable table(common::ManagedPointer<storage::BlockStore>(&block_store_), layout,
+                           storage::layout_version_t(0));
+  storage::RawBlock *block = table.begin()->GetBlock();
+
+  transaction::TimestampManager timestamp_manager;
+  transaction::DeferredActionManager deferred_action_manager{common::ManagedPointer(&timestamp_manager)};
+  transaction::TransactionManager txn_manager{common::ManagedPointer(&timestamp_manager),
+                                              common::ManagedPointer(&deferred_action_manager),
+                                              common::ManagedPointer(&buffer_pool_), true, DISABLED};
+  storage::GarbageCollector gc{common::ManagedPointer(&timestamp_manager),
+                               common::ManagedPointer(&deferred_action_manager), common::ManagedPointer(&txn_manager),
+                               DISABLED};
+
+  auto tuples = StorageTestUtil::PopulateBlockRandomly(&table, block, percent_empty_, &generator_);
+  auto &arrow_metadata = accessor.GetArrowBlockMetadata(block);
+  for (storage::col_id_t col_id : layout.AllColumns())
+    arrow_metadata.GetColumnInfo(layout, col_id).Type() = storage::ArrowColumnType::FIXED_LENGTH;
+
+  storage::BlockCompactor compactor;
+  compactor.PutInQueue(block);
+  compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager);  // compaction pass
+  gc.PerformGarbageCollection();
+  compactor.PutInQueue(block);
+  compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager);  // gathering pass
+  ASSERT_EQ(storage::BlockState::FROZEN, block->controller_.GetBlockState()->load());
+
+  std::vector<storage::col_id_t> col_ids = StorageTestUtil::ProjectionListAllColumns(layout);
+  std::vector<execution::sql::TypeId> col_types;
+  for (const storage::col_id_t col_id : col_ids) {
+    switch (layout.AttrSize(col_id)) {
+      case 1:
+        col_types.push_back(execution::sql::TypeId::TinyInt);
+        break;
+      case 2:
+        col_types.push_back(execution::sql::TypeId::SmallInt);
+        break;
+      case 4:
+        col_types.push_back(execution::sql::TypeId::Integer);
+        break;
+      default:
+        col_types.push_back(execution::sql::TypeId::BigInt);
+    }
+  }
+  execution::sql::VectorProjection vector_projection;
+  vector_projection.SetStorageColIds(col_ids);
+  vector_projection.Initialize(col_types);
+
+  auto *txn = txn_manager.BeginTransaction();
+  auto it = table.begin();
+  ASSERT_EQ(block, table.ScanFrozenInPlace(&it, &vector_projection));
+
+  // Update the first scanned tuple to a different value while the block is still being read in place
+  const uint8_t attr_size = layout.AttrSize(col_ids[0]);
+  std::vector<byte> read_value(vector_projection.GetColumn(0)->GetData(),
+                               vector_projection.GetColumn(0)->GetData() + attr_size);
+  auto update_initializer = storage::ProjectedRowInitializer::Create(layout, {col_ids[0]});
+  auto *redo = txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, update_initializer);
+  byte *new_value = redo->Delta()->AccessForceNotNull(0);
+  for (uint8_t i = 0; i < attr_size; i++) new_value[i] = ~read_value[i];
+  const storage::TupleSlot slot = vector_projection.GetTupleSlot(0);
+  EXPECT_TRUE(table.Update(common::ManagedPointer(txn), slot, *redo->Delta()));
+  EXPECT_EQ(storage::BlockState::HOT, block->controller_.GetBlockState()->load());
+
+  // The block has the new value, but the projection was copied out of the block first and still has what it read
+  EXPECT_EQ(0, std::memcmp(new_value, accessor.AccessWithNullCheck(slot, col_ids[0]), attr_size));
+  EXPECT_NE(accessor.ColumnStart(block, col_ids[0]), vector_projection.GetColumn(0)->GetData());
+  EXPECT_EQ(0, std::memcmp(read_value.data(), vector_projection.GetColumn(0)->GetData(), attr_size));
+
+  block->controller_.ReleaseInPlaceRead(&vector_projection);
+  txn_manager.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  for (auto &entry : tuples) delete[] reinterpret_cast<byte *>(entry.second);  // reclaim memory used for bookkeeping
+
+  gc.PerformGarbageCollection();
+  gc.PerformGarbageCollection();  // Second call to deallocate.
+}
+
+// This test fills a block transactionally with the background GC and compaction threads running, and checks that the
+// block is eventually frozen without any manual invocation of the compactor.
+// NOLINTNEXTLINE
+TEST_F(BlockCompactorTest, BackgroundFreezeTest) {
+  auto db_main = DBMain::Builder()
+                     .SetUseGC(true)
+                     .SetUseGCThread(true)
+                     .SetUseCompaction(true)
+                     .SetCompactionInterval(1000)
+                     .SetCompactionColdThreshold(2)
+                     .Build();
+  auto txn_manager = db_main->GetTransactionLayer()->GetTransactionManager();
+
+  storage::BlockLayout layout = StorageTestUtil::RandomLayoutNoVarlen(100, &generator_);
+  storage::TupleAccessStrategy accessor(layout);
+  auto *table = new storage::DataTable(db_main->GetStorageLayer()->GetBlockStore(), layout,
+                                       storage::layout_version_t(0));
+  storage::RawBlock *block = table->begin()->GetBlock();
+  auto &arrow_metadata = accessor.GetArrowBlockMetadata(block);
+  for (storage::col_id_t col_id : layout.AllColumns())
+    arrow_metadata.GetColumnInfo(layout, col_id).Type() = storage::ArrowColumnType::FIXED_LENGTH;
+
+  // Only full blocks are considered for freezing
+  auto initializer =
+      storage::ProjectedRowInitializer::Create(layout, StorageTestUtil::ProjectionListAllColumns(layout));
+  auto *txn = txn_manager->BeginTransaction();
+  for (uint32_t i = 0; i < layout.NumSlots(); i++) {
+    auto *redo = txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, initializer);
+    StorageTestUtil::PopulateRandomRow(redo->Delta(), layout, 0.1, &generator_);
+    EXPECT_EQ(block, table->Insert(common::ManagedPointer(txn), *redo->Delta()).GetBlock());
+  }
+  txn_manager->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  for (uint32_t i = 0; i < 10000 && block->controller_.GetBlockState()->load() != storage::BlockState::FROZEN; i++)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  EXPECT_EQ(storage::BlockState::FROZEN, block->controller_.GetBlockState()->load());
+  EXPECT_EQ(layout.NumSlots(), arrow_metadata.NumRecords());
+
+  db_main->GetTransactionLayer()->GetDeferredActionManager()->RegisterDeferredAction([=]() { delete table; });
+}
+
 }  // namespace terrier
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstring>
 #include <functional>
 #include <limits>
@@ -1936,4 +1937,162 @@ TEST_F(BwTreeIndexTests, AbortDelete2) {
   txn_manager_->Commit(txn2, transaction::TransactionUtil::EmptyCallback, nullptr);
 }
 
+/**
+ * Inserts a batch of tuples in shuffled key order spanning many redo buffer segments, and their keys into both
+ * indexes in one batch each. The tuples should land in consecutive slots, every key should find its tuple, and a batch
+ * repeating a key should fail on the unique index and roll back all of its keys on abort.
+ */
+// NOLINTNEXTLINE
+TEST_F(BwTreeIndexTests, InsertBatch) {
+  const uint32_t num_inserts = 1000;
+  std::vector<int32_t> values(num_inserts);
+  for (uint32_t i = 0; i < num_inserts; i++) values[i] = static_cast<int32_t>(i);
+  std::shuffle(values.begin(), values.end(), generator_);
+
+  auto *const row_buffer = common::AllocationUtil::AllocateAligned(tuple_initializer_.ProjectedRowSize() * num_inserts);
+  auto *const batch_key_buffer = common::AllocationUtil::AllocateAligned(
+      default_index_->GetProjectedRowInitializer().ProjectedRowSize() * num_inserts);
+  std::vector<const ProjectedRow *> rows, keys;
+  for (uint32_t i = 0; i < num_inserts; i++) {
+    auto *const row = tuple_initializer_.InitializeRow(row_buffer + i * tuple_initializer_.ProjectedRowSize());
+    *reinterpret_cast<int32_t *>(row->AccessForceNotNull(0)) = values[i];
+    rows.push_back(row);
+    auto *const key = default_index_->GetProjectedRowInitializer().InitializeRow(
+        batch_key_buffer + i * default_index_->GetProjectedRowInitializer().ProjectedRowSize());
+    *reinterpret_cast<int32_t *>(key->AccessForceNotNull(0)) = values[i];
+    keys.push_back(key);
+  }
+
+  // Rows are staged as far as they fit into the current redo buffer segment, and inserted before staging the next ones
+  auto *txn0 = txn_manager_->BeginTransaction();
+  std::vector<RedoRecord *> redos(num_inserts);
+  std::vector<TupleSlot> slots(num_inserts);
+  for (uint32_t inserted = 0; inserted < num_inserts;) {
+    const uint32_t staged = txn0->StageWrites(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID,
+                                              &rows[inserted], num_inserts - inserted, &redos[inserted]);
+    EXPECT_GT(staged, 0);
+    sql_table_->InsertBatch(common::ManagedPointer(txn0), &redos[inserted], staged, &slots[inserted]);
+    for (uint32_t i = inserted; i < inserted + staged; i++) EXPECT_EQ(redos[i]->GetTupleSlot(), slots[i]);
+    inserted += staged;
+  }
+  for (uint32_t i = 1; i < num_inserts; i++) {
+    if (slots[i].GetBlock() == slots[i - 1].GetBlock())
+      EXPECT_EQ(slots[i].GetOffset(), slots[i - 1].GetOffset() + 1);
+  }
+
+  default_index_->InsertBatch(common::ManagedPointer(txn0), keys.data(), slots.data(), num_inserts);
+  EXPECT_TRUE(unique_index_->InsertUniqueBatch(common::ManagedPointer(txn0), keys.data(), slots.data(), num_inserts));
+  txn_manager_->Commit(txn0, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  auto *txn1 = txn_manager_->BeginTransaction();
+  std::vector<storage::TupleSlot> results;
+  auto *const scan_key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+  auto *const read_buffer = common::AllocationUtil::AllocateAligned(tuple_initializer_.ProjectedRowSize());
+  auto *const read_row = tuple_initializer_.InitializeRow(read_buffer);
+  for (uint32_t i = 0; i < num_inserts; i++) {
+    *reinterpret_cast<int32_t *>(scan_key_pr->AccessForceNotNull(0)) = values[i];
+    for (auto *const index : {default_index_, unique_index_}) {
+      index->ScanKey(*txn1, *scan_key_pr, &results);
+      EXPECT_EQ(results.size(), 1);
+      EXPECT_EQ(results[0], slots[i]);
+      results.clear();
+    }
+    EXPECT_TRUE(sql_table_->Select(common::ManagedPointer(txn1), slots[i], read_row));
+    EXPECT_EQ(*reinterpret_cast<int32_t *>(read_row->AccessForceNotNull(0)), values[i]);
+  }
+  txn_manager_->Commit(txn1, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  // A batch with a key that is already there fails, and the keys sorted before it are gone again after the abort
+  auto *txn2 = txn_manager_->BeginTransaction();
+  const int32_t new_value = -1;
+  auto *const new_key = unique_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+  *reinterpret_cast<int32_t *>(new_key->AccessForceNotNull(0)) = new_value;
+  const std::vector<const ProjectedRow *> conflicting_keys{new_key, keys[0]};
+  const std::vector<TupleSlot> conflicting_slots{slots[1], slots[0]};
+  EXPECT_FALSE(unique_index_->InsertUniqueBatch(common::ManagedPointer(txn2), conflicting_keys.data(),
+                                                conflicting_slots.data(), 2));
+  EXPECT_TRUE(txn2->MustAbort());
+  txn_manager_->Abort(txn2);
+
+  auto *txn3 = txn_manager_->BeginTransaction();
+  unique_index_->ScanKey(*txn3, *new_key, &results);
+  EXPECT_TRUE(results.empty());
+  txn_manager_->Commit(txn3, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  delete[] row_buffer;
+  delete[] batch_key_buffer;
+  delete[] read_buffer;
+}
+
+/**
+ * Bulk loads an empty index with every key twice, and checks that a unique index refuses to load repeated keys.
+ */
+// NOLINTNEXTLINE
+TEST_F(BwTreeIndexTests, BulkLoad) {
+  const uint32_t num_inserts = 100000;
+  std::vector<int32_t> values(num_inserts);
+  for (uint32_t i = 0; i < num_inserts; i++) values[i] = static_cast<int32_t>(i / 2);
+  std::shuffle(values.begin(), values.end(), generator_);
+
+  const uint32_t key_size = default_index_->GetProjectedRowInitializer().ProjectedRowSize();
+  auto *const bulk_key_buffer = common::AllocationUtil::AllocateAligned(key_size * num_inserts);
+  std::vector<const ProjectedRow *> keys;
+  std::vector<TupleSlot> slots;
+  auto *txn0 = txn_manager_->BeginTransaction();
+  for (uint32_t i = 0; i < num_inserts; i++) {
+    auto *const insert_redo =
+        txn0->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+    *reinterpret_cast<int32_t *>(insert_redo->Delta()->AccessForceNotNull(0)) = values[i];
+    slots.push_back(sql_table_->Insert(common::ManagedPointer(txn0), insert_redo));
+    auto *const key = default_index_->GetProjectedRowInitializer().InitializeRow(bulk_key_buffer + i * key_size);
+    *reinterpret_cast<int32_t *>(key->AccessForceNotNull(0)) = values[i];
+    keys.push_back(key);
+  }
+  EXPECT_TRUE(default_index_->BulkLoad(common::ManagedPointer(txn0), keys.data(), slots.data(), num_inserts));
+  txn_manager_->Commit(txn0, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  auto *txn1 = txn_manager_->BeginTransaction();
+  EXPECT_FALSE(unique_index_->BulkLoad(common::ManagedPointer(txn1), keys.data(), slots.data(), num_inserts));
+  EXPECT_TRUE(txn1->MustAbort());
+  txn_manager_->Abort(txn1);
+
+  // Without the repeated keys the unique index loads fine
+  std::vector<const ProjectedRow *> unique_keys;
+  std::vector<TupleSlot> unique_slots;
+  std::vector<bool> seen(num_inserts / 2, false);
+  for (uint32_t i = 0; i < num_inserts; i++) {
+    if (seen[values[i]]) continue;
+    seen[values[i]] = true;
+    unique_keys.push_back(keys[i]);
+    unique_slots.push_back(slots[i]);
+  }
+  auto *txn2 = txn_manager_->BeginTransaction();
+  EXPECT_TRUE(unique_index_->BulkLoad(common::ManagedPointer(txn2), unique_keys.data(), unique_slots.data(),
+                                      unique_keys.size()));
+  txn_manager_->Commit(txn2, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  auto *txn3 = txn_manager_->BeginTransaction();
+  std::vector<storage::TupleSlot> results;
+  auto *const low_key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+  auto *const high_key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_2_);
+  for (int32_t value = 0; value < static_cast<int32_t>(num_inserts / 2); value++) {
+    *reinterpret_cast<int32_t *>(low_key_pr->AccessForceNotNull(0)) = value;
+    default_index_->ScanKey(*txn3, *low_key_pr, &results);
+    EXPECT_EQ(results.size(), 2);
+    results.clear();
+    unique_index_->ScanKey(*txn3, *low_key_pr, &results);
+    EXPECT_EQ(results.size(), 1);
+    results.clear();
+  }
+
+  // Scans run over all leaves built by the bulk load
+  *reinterpret_cast<int32_t *>(low_key_pr->AccessForceNotNull(0)) = 0;
+  *reinterpret_cast<int32_t *>(high_key_pr->AccessForceNotNull(0)) = num_inserts / 2 - 1;
+  default_index_->ScanAscending(*txn3, storage::index::ScanType::Closed, 1, low_key_pr, high_key_pr, 0, &results);
+  EXPECT_EQ(results.size(), num_inserts);
+  txn_manager_->Commit(txn3, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  delete[] bulk_key_buffer;
+}
+
 }  // namespace terrier::storage::index
@@ -218,6 +218,49 @@ TEST_F(BwTreeTests, ReverseIterator) {
   delete tree;
 }
 
+/**
+ * Builds a tree bottom-up from sorted keys, some of them repeated, which should then look the same to lookups, scans,
+ * inserts and deletes as a tree the keys were inserted into one by one.
+ */
+// NOLINTNEXTLINE
+TEST_F(BwTreeTests, BulkLoad) {
+  auto *const tree = BwTreeTestUtil::GetEmptyTree();
+  const int64_t key_num = 1024 * 1024;
+
+  // Every key but the multiples of 3 is there twice, so that runs of equal keys fall on every leaf boundary sooner or
+  // later
+  std::vector<std::pair<int64_t, int64_t>> items;
+  for (int64_t key = 0; key < key_num; key++) {
+    items.emplace_back(key, key);
+    if (key % 3 != 0) items.emplace_back(key, -key);
+  }
+  EXPECT_TRUE(tree->BulkLoad(items));
+  EXPECT_FALSE(tree->BulkLoad(items));
+
+  int64_t num_items = 0;
+  for (auto it = tree->Begin(); !it.IsEnd(); it++) {
+    EXPECT_EQ(it->first, items[num_items].first);
+    num_items++;
+  }
+  EXPECT_EQ(num_items, items.size());
+
+  for (int64_t key = 0; key < key_num; key++) {
+    auto values = tree->GetValue(key);
+    EXPECT_EQ(values.size(), key % 3 == 0 ? 1 : 2);
+    EXPECT_EQ(values.count(key), 1);
+  }
+
+  // The tree keeps working as usual, splitting and merging the bulk loaded nodes
+  for (int64_t key = key_num; key < 2 * key_num; key++) EXPECT_TRUE(tree->Insert(key, key));
+  for (int64_t key = 0; key < key_num; key++) EXPECT_TRUE(tree->Delete(key, key));
+  for (int64_t key = 0; key < 2 * key_num; key++) {
+    auto values = tree->GetValue(key);
+    EXPECT_EQ(values.size(), key >= key_num || key % 3 == 0 ? key / key_num : 1);
+  }
+
+  delete tree;
+}
+
 /**
  * Adapted from https://github.com/wangziqi2013/BwTree/blob/master/test/random_pattern_test.cpp
  */
@@ -68,6 +68,29 @@ class RandomDataTableTestObject {
     return slot;
   }
 
+  // Generate num_tuples random inserts and insert them with a single DataTable::InsertBatch call using the given
+  // transaction context.
+  template <class Random>
+  std::vector<storage::TupleSlot> InsertRandomTuples(transaction::TransactionContext *txn, const uint32_t num_tuples,
+                                                     Random *generator) {
+    std::vector<storage::ProjectedRow *> redos;
+    for (uint32_t i = 0; i < num_tuples; i++) {
+      auto *redo_buffer = common::AllocationUtil::AllocateAligned(redo_initializer_.ProjectedRowSize());
+      loose_pointers_.push_back(redo_buffer);
+      storage::ProjectedRow *redo = redo_initializer_.InitializeRow(redo_buffer);
+      StorageTestUtil::PopulateRandomRow(redo, layout_, null_bias_, generator);
+      redos.push_back(redo);
+    }
+
+    std::vector<storage::TupleSlot> slots(num_tuples);
+    table_.InsertBatch(common::ManagedPointer(txn), redos.data(), num_tuples, slots.data());
+    for (uint32_t i = 0; i < num_tuples; i++) {
+      inserted_slots_.push_back(slots[i]);
+      tuple_versions_[slots[i]].emplace_back(txn->StartTime(), redos[i]);
+    }
+    return slots;
+  }
+
   // be sure to only update tuple incrementally (cannot go back in time)
   template <class Random>
   bool RandomlyUpdateTuple(const transaction::timestamp_t timestamp, const storage::TupleSlot slot, Random *generator,
@@ -376,4 +399,53 @@ TEST_F(DataTableTests, InsertNoWrap) {
     delete txn;
   }
 }
+
+// Inserts a batch of tuples that does not fit into the rest of a partially filled block, and checks that the batch
+// fills that block up with consecutive slots before moving on to a new block, and that every tuple reads back the same.
+// NOLINTNEXTLINE
+TEST_F(DataTableTests, InsertBatchAcrossBlocks) {
+  const uint32_t num_iterations = 10;
+  const uint16_t max_columns = 10;
+  for (uint32_t iteration = 0; iteration < num_iterations; ++iteration) {
+    RandomDataTableTestObject tested(&block_store_, max_columns, null_ratio_(generator_), &generator_);
+    const uint32_t num_slots = tested.Layout().NumSlots();
+    transaction::timestamp_t timestamp(0);
+    auto *txn =
+        new transaction::TransactionContext(timestamp, timestamp, common::ManagedPointer(&buffer_pool_), DISABLED);
+
+    // Partially fill the first block
+    const uint32_t num_before = std::uniform_int_distribution<uint32_t>(1, num_slots - 1)(generator_);
+    storage::RawBlock *first_block = nullptr;
+    for (uint32_t i = 0; i < num_before; i++) {
+      storage::RawBlock *inserted_block = tested.InsertRandomTuple(txn, &generator_, &buffer_pool_).GetBlock();
+      if (first_block == nullptr) first_block = inserted_block;
+      EXPECT_EQ(first_block, inserted_block);
+    }
+
+    // The batch takes the rest of the first block and spills over into a second one
+    const std::vector<storage::TupleSlot> slots = tested.InsertRandomTuples(txn, num_slots, &generator_);
+    ASSERT_EQ(num_slots, slots.size());
+    const uint32_t num_in_first_block = num_slots - num_before;
+    storage::RawBlock *second_block = slots[num_in_first_block].GetBlock();
+    EXPECT_NE(first_block, second_block);
+    for (uint32_t i = 0; i < num_slots; i++) {
+      if (i < num_in_first_block) {
+        EXPECT_EQ(first_block, slots[i].GetBlock());
+        EXPECT_EQ(num_before + i, slots[i].GetOffset());
+      } else {
+        EXPECT_EQ(second_block, slots[i].GetBlock());
+        EXPECT_EQ(i - num_in_first_block, slots[i].GetOffset());
+      }
+    }
+
+    EXPECT_EQ(num_before + num_slots, tested.InsertedTuples().size());
+    for (const auto &inserted_tuple : tested.InsertedTuples()) {
+      storage::ProjectedRow *stored =
+          tested.SelectIntoBuffer(inserted_tuple, transaction::timestamp_t(1), &buffer_pool_);
+      const storage::ProjectedRow *ref = tested.GetReferenceVersionedTuple(inserted_tuple, transaction::timestamp_t(1));
+      EXPECT_TRUE(StorageTestUtil::ProjectionListEqualShallow(tested.Layout(), stored, ref));
+    }
+    delete txn;
+  }
+}
 }  // namespace terrier
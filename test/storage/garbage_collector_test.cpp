@@ -1,11 +1,15 @@
 #include "storage/garbage_collector.h"
 
 #include <cstring>
+#include <iterator>
+#include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "common/object_pool.h"
+#include "execution/sql/vector_projection.h"
 #include "main/db_main.h"
 #include "storage/data_table.h"
 #include "storage/storage_util.h"
@@ -699,4 +703,381 @@ TEST_F(GarbageCollectorTests, InsertUpdate1) {
     EXPECT_EQ(std::make_pair(2U, 0U), gc->PerformGarbageCollection());
   }
 }
+
+// Insert tuples, and confirm that the block's version synopsis only allows in-place reads once the GC has truncated
+// every version chain in it. Scanning into a VectorProjection should produce the same tuples on both paths.
+// NOLINTNEXTLINE
+TEST_F(GarbageCollectorTests, VersionSynopsisScan) {
+  const uint32_t num_inserts = 10;
+  for (uint32_t iteration = 0; iteration < num_iterations_; ++iteration) {
+    auto db_main = DBMain::Builder().SetUseGC(true).Build();
+    auto txn_manager = db_main->GetTransactionLayer()->GetTransactionManager();
+    auto gc = db_main->GetStorageLayer()->GetGarbageCollector();
+
+    GarbageCollectorDataTableTestObject tested(db_main->GetStorageLayer()->GetBlockStore().Get(), max_columns_,
+                                               &generator_);
+
+    auto *txn0 = txn_manager->BeginTransaction();
+    std::vector<storage::ProjectedRow *> insert_tuples;
+    storage::TupleSlot slot;
+    for (uint32_t i = 0; i < num_inserts; i++) {
+      insert_tuples.push_back(tested.GenerateRandomTuple(&generator_));
+      slot = tested.table_.Insert(common::ManagedPointer(txn0), *insert_tuples.back());
+    }
+    txn_manager->Commit(txn0, transaction::TransactionUtil::EmptyCallback, nullptr);
+    storage::RawBlock *block = slot.GetBlock();
+    EXPECT_EQ(num_inserts, static_cast<uint32_t>(block->version_synopsis_.load()));
+
+    // Unlinking truncates every version chain, and the block can now be read in place
+    EXPECT_EQ(std::make_pair(0U, 1U), gc->PerformGarbageCollection());
+    EXPECT_TRUE(storage::RawBlock::NoVersionChains(block->version_synopsis_.load()));
+    EXPECT_EQ(std::make_pair(1U, 0U), gc->PerformGarbageCollection());
+
+    // Set up a vector projection over every column in the table
+    const storage::ProjectedRow &row = *insert_tuples[0];
+    std::vector<storage::col_id_t> col_ids(row.ColumnIds(), row.ColumnIds() + row.NumColumns());
+    std::vector<execution::sql::TypeId> col_types;
+    for (const storage::col_id_t col_id : col_ids) {
+      switch (tested.Layout().AttrSize(col_id)) {
+        case 1:
+          col_types.push_back(execution::sql::TypeId::TinyInt);
+          break;
+        case 2:
+          col_types.push_back(execution::sql::TypeId::SmallInt);
+          break;
+        case 4:
+          col_types.push_back(execution::sql::TypeId::Integer);
+          break;
+        default:
+          col_types.push_back(execution::sql::TypeId::BigInt);
+      }
+    }
+    execution::sql::VectorProjection vector_projection;
+    vector_projection.SetStorageColIds(col_ids);
+    vector_projection.Initialize(col_types);
+
+    auto check_scan = [&](transaction::TransactionContext *const txn) {
+      auto it = tested.table_.begin();
+      tested.table_.Scan(common::ManagedPointer(txn), &it, &vector_projection);
+      EXPECT_EQ(num_inserts, vector_projection.GetSelectedTupleCount());
+      for (uint32_t i = 0; i < num_inserts; i++) {
+        for (uint16_t j = 0; j < row.NumColumns(); j++) {
+          const uint8_t attr_size = tested.Layout().AttrSize(col_ids[j]);
+          const byte *value = vector_projection.GetColumn(j)->GetData() + i * attr_size;
+          EXPECT_EQ(0, std::memcmp(value, insert_tuples[i]->AccessWithNullCheck(j), attr_size));
+        }
+      }
+    };
+
+    auto *txn1 = txn_manager->BeginTransaction();
+    check_scan(txn1);
+
+    // A concurrent delete installs a version chain, so txn1 has to go through the version chain to still see the tuple
+    auto *txn2 = txn_manager->BeginTransaction();
+    EXPECT_TRUE(tested.table_.Delete(common::ManagedPointer(txn2), slot));
+    EXPECT_FALSE(storage::RawBlock::NoVersionChains(block->version_synopsis_.load()));
+    check_scan(txn1);
+
+    txn_manager->Abort(txn2);
+    txn_manager->Commit(txn1, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+    EXPECT_EQ(std::make_pair(0U, 2U), gc->PerformGarbageCollection());
+    EXPECT_EQ(std::make_pair(1U, 0U), gc->PerformGarbageCollection());
+    EXPECT_TRUE(storage::RawBlock::NoVersionChains(block->version_synopsis_.load()));
+  }
+}
+
+// Insert and delete a tuple over and over. Once the GC has processed a delete, the next insert should reuse its slot
+// instead of taking a new one.
+// NOLINTNEXTLINE
+TEST_F(GarbageCollectorTests, SlotReuse) {
+  const uint32_t num_rounds = 10;
+  for (uint32_t iteration = 0; iteration < num_iterations_; ++iteration) {
+    auto db_main = DBMain::Builder().SetUseGC(true).Build();
+    auto txn_manager = db_main->GetTransactionLayer()->GetTransactionManager();
+    auto gc = db_main->GetStorageLayer()->GetGarbageCollector();
+
+    GarbageCollectorDataTableTestObject tested(db_main->GetStorageLayer()->GetBlockStore().Get(), max_columns_,
+                                               &generator_);
+
+    auto *txn0 = txn_manager->BeginTransaction();
+    const storage::TupleSlot slot =
+        tested.table_.Insert(common::ManagedPointer(txn0), *tested.GenerateRandomTuple(&generator_));
+    txn_manager->Commit(txn0, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+    for (uint32_t round = 0; round < num_rounds; round++) {
+      auto *txn1 = txn_manager->BeginTransaction();
+      EXPECT_TRUE(tested.table_.Delete(common::ManagedPointer(txn1), slot));
+      txn_manager->Commit(txn1, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+      // The deferred action that deallocates the slot and hands it back to the table runs in the same pass as the
+      // unlinking of the delete
+      EXPECT_EQ(std::make_pair(0U, 2U), gc->PerformGarbageCollection());
+      EXPECT_EQ(std::make_pair(2U, 0U), gc->PerformGarbageCollection());
+
+      auto *txn2 = txn_manager->BeginTransaction();
+      storage::ProjectedRow *insert_tuple = tested.GenerateRandomTuple(&generator_);
+      const storage::TupleSlot reused = tested.table_.Insert(common::ManagedPointer(txn2), *insert_tuple);
+      EXPECT_EQ(slot, reused);
+      storage::ProjectedRow *select_tuple = tested.SelectIntoBuffer(txn2, reused);
+      EXPECT_TRUE(tested.select_result_);
+      EXPECT_TRUE(StorageTestUtil::ProjectionListEqualShallow(tested.Layout(), select_tuple, insert_tuple));
+      txn_manager->Commit(txn2, transaction::TransactionUtil::EmptyCallback, nullptr);
+    }
+    EXPECT_EQ(1U, tested.table_.GetNumBlocks());
+
+    EXPECT_EQ(std::make_pair(0U, 1U), gc->PerformGarbageCollection());
+    EXPECT_EQ(std::make_pair(1U, 0U), gc->PerformGarbageCollection());
+  }
+}
+
+// Delete a tuple with an out-of-line varlen and reuse its slot for a new one. The GC collects the varlens of the
+// deleted tuple when it unlinks the delete, which must happen before the slot is reused, or it would collect the new
+// tuple's varlens instead.
+// NOLINTNEXTLINE
+TEST_F(GarbageCollectorTests, SlotReuseKeepsVarlens) {
+  for (uint32_t iteration = 0; iteration < num_iterations_; ++iteration) {
+    auto db_main = DBMain::Builder().SetUseGC(true).Build();
+    auto txn_manager = db_main->GetTransactionLayer()->GetTransactionManager();
+    auto gc = db_main->GetStorageLayer()->GetGarbageCollector();
+
+    const storage::BlockLayout layout({8, storage::VARLEN_COLUMN});
+    const storage::col_id_t varlen_col(1);
+    storage::DataTable table(db_main->GetStorageLayer()->GetBlockStore(), layout, storage::layout_version_t(0));
+    const auto initializer = storage::ProjectedRowInitializer::Create(layout, {varlen_col});
+    byte *buffer = common::AllocationUtil::AllocateAligned(initializer.ProjectedRowSize());
+    const std::string old_value(64, 'o'), new_value(64, 'n');
+
+    auto *txn0 = txn_manager->BeginTransaction();
+    storage::ProjectedRow *row = initializer.InitializeRow(buffer);
+    *reinterpret_cast<storage::VarlenEntry *>(row->AccessForceNotNull(0)) =
+        storage::StorageUtil::CreateVarlen(old_value);
+    const storage::TupleSlot slot = table.Insert(common::ManagedPointer(txn0), *row);
+    txn_manager->Commit(txn0, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+    auto *txn1 = txn_manager->BeginTransaction();
+    EXPECT_TRUE(table.Delete(common::ManagedPointer(txn1), slot));
+    txn_manager->Commit(txn1, transaction::TransactionUtil::EmptyCallback, nullptr);
+    gc->PerformGarbageCollection();
+
+    auto *txn2 = txn_manager->BeginTransaction();
+    row = initializer.InitializeRow(buffer);
+    *reinterpret_cast<storage::VarlenEntry *>(row->AccessForceNotNull(0)) =
+        storage::StorageUtil::CreateVarlen(new_value);
+    EXPECT_EQ(slot, table.Insert(common::ManagedPointer(txn2), *row));
+    txn_manager->Commit(txn2, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+    // Deallocating the delete frees the old varlen, and must leave the new one alone
+    gc->PerformGarbageCollection();
+    gc->PerformGarbageCollection();
+
+    auto *txn3 = txn_manager->BeginTransaction();
+    row = initializer.InitializeRow(buffer);
+    EXPECT_TRUE(table.Select(common::ManagedPointer(txn3), slot, row));
+    const auto *varlen = reinterpret_cast<const storage::VarlenEntry *>(row->AccessWithNullCheck(0));
+    ASSERT_NE(nullptr, varlen);
+    EXPECT_EQ(new_value, varlen->StringView());
+    txn_manager->Commit(txn3, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+    delete[] buffer;
+  }
+}
+
+// Repeatedly delete every tuple in a table, and fill it back up once with an insert that aborts and once with one that
+// commits. Both deleted slots and the slots of rolled back inserts should be reused, so the table never grows.
+// NOLINTNEXTLINE
+TEST_F(GarbageCollectorTests, SlotReuseUnderChurn) {
+  const uint32_t num_tuples = 100;
+  const uint32_t num_rounds = 10;
+  for (uint32_t iteration = 0; iteration < num_iterations_; ++iteration) {
+    auto db_main = DBMain::Builder().SetUseGC(true).Build();
+    auto txn_manager = db_main->GetTransactionLayer()->GetTransactionManager();
+    auto gc = db_main->GetStorageLayer()->GetGarbageCollector();
+
+    GarbageCollectorDataTableTestObject tested(db_main->GetStorageLayer()->GetBlockStore().Get(), max_columns_,
+                                               &generator_);
+
+    std::unordered_set<storage::TupleSlot> table_slots;
+    std::vector<storage::TupleSlot> live_slots;
+    auto *txn0 = txn_manager->BeginTransaction();
+    for (uint32_t i = 0; i < num_tuples; i++) {
+      live_slots.push_back(
+          tested.table_.Insert(common::ManagedPointer(txn0), *tested.GenerateRandomTuple(&generator_)));
+      table_slots.insert(live_slots.back());
+    }
+    txn_manager->Commit(txn0, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+    for (uint32_t round = 0; round < num_rounds; round++) {
+      auto *delete_txn = txn_manager->BeginTransaction();
+      for (const storage::TupleSlot slot : live_slots)
+        EXPECT_TRUE(tested.table_.Delete(common::ManagedPointer(delete_txn), slot));
+      txn_manager->Commit(delete_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+      gc->PerformGarbageCollection();
+      gc->PerformGarbageCollection();
+
+      auto *abort_txn = txn_manager->BeginTransaction();
+      for (uint32_t i = 0; i < num_tuples; i++) {
+        const storage::TupleSlot slot =
+            tested.table_.Insert(common::ManagedPointer(abort_txn), *tested.GenerateRandomTuple(&generator_));
+        EXPECT_EQ(1, table_slots.count(slot));
+      }
+      txn_manager->Abort(abort_txn);
+      gc->PerformGarbageCollection();
+      gc->PerformGarbageCollection();
+
+      live_slots.clear();
+      auto *insert_txn = txn_manager->BeginTransaction();
+      for (uint32_t i = 0; i < num_tuples; i++) {
+        live_slots.push_back(
+            tested.table_.Insert(common::ManagedPointer(insert_txn), *tested.GenerateRandomTuple(&generator_)));
+        EXPECT_EQ(1, table_slots.count(live_slots.back()));
+      }
+      txn_manager->Commit(insert_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+      EXPECT_EQ(1U, tested.table_.GetNumBlocks());
+    }
+
+    gc->PerformGarbageCollection();
+    gc->PerformGarbageCollection();
+  }
+}
+
+// Update tuples in two tables from many transactions, and unlink them all on several GC workers in a single pass.
+// Every version chain should be truncated, and the tables should hold the latest versions.
+// NOLINTNEXTLINE
+TEST_F(GarbageCollectorTests, ParallelUnlink) {
+  const uint32_t num_tuples = 100;
+  const uint32_t num_updates = 256;
+  for (uint32_t iteration = 0; iteration < num_iterations_; ++iteration) {
+    auto db_main = DBMain::Builder().SetUseGC(true).SetGCNumThreads(4).Build();
+    auto txn_manager = db_main->GetTransactionLayer()->GetTransactionManager();
+    auto gc = db_main->GetStorageLayer()->GetGarbageCollector();
+    EXPECT_EQ(4U, gc->NumWorkers());
+
+    std::vector<std::unique_ptr<GarbageCollectorDataTableTestObject>> tables;
+    for (uint32_t i = 0; i < 2; i++)
+      tables.emplace_back(std::make_unique<GarbageCollectorDataTableTestObject>(
+          db_main->GetStorageLayer()->GetBlockStore().Get(), max_columns_, &generator_));
+
+    // The latest version of every tuple, keyed by table and slot
+    std::vector<std::unordered_map<storage::TupleSlot, storage::ProjectedRow *>> versions(tables.size());
+    auto *txn0 = txn_manager->BeginTransaction();
+    for (uint32_t i = 0; i < tables.size(); i++) {
+      for (uint32_t j = 0; j < num_tuples; j++) {
+        auto *insert_tuple = tables[i]->GenerateRandomTuple(&generator_);
+        versions[i][tables[i]->table_.Insert(common::ManagedPointer(txn0), *insert_tuple)] = insert_tuple;
+      }
+    }
+    txn_manager->Commit(txn0, transaction::TransactionUtil::EmptyCallback, nullptr);
+    EXPECT_EQ(std::make_pair(0U, 1U), gc->PerformGarbageCollection());
+    EXPECT_EQ(std::make_pair(1U, 0U), gc->PerformGarbageCollection());
+
+    std::uniform_int_distribution<uint32_t> table_dist(0, static_cast<uint32_t>(tables.size()) - 1);
+    for (uint32_t i = 0; i < num_updates; i++) {
+      const uint32_t table = table_dist(generator_);
+      auto version = versions[table].begin();
+      std::advance(version, std::uniform_int_distribution<uint32_t>(0, num_tuples - 1)(generator_));
+      auto *txn = txn_manager->BeginTransaction();
+      auto *update = tables[table]->GenerateRandomUpdate(&generator_);
+      EXPECT_TRUE(tables[table]->table_.Update(common::ManagedPointer(txn), version->first, *update));
+      version->second = tables[table]->GenerateVersionFromUpdate(*update, *version->second);
+      txn_manager->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+    }
+
+    // Enough transactions for every worker to get a share
+    EXPECT_EQ(std::make_pair(0U, num_updates), gc->PerformGarbageCollection());
+    for (uint32_t i = 0; i < tables.size(); i++) {
+      for (const auto &version : versions[i])
+        EXPECT_TRUE(storage::RawBlock::NoVersionChains(version.first.GetBlock()->version_synopsis_.load()));
+    }
+    EXPECT_EQ(std::make_pair(num_updates, 0U), gc->PerformGarbageCollection());
+
+    auto *txn1 = txn_manager->BeginTransaction();
+    for (uint32_t i = 0; i < tables.size(); i++) {
+      for (const auto &version : versions[i]) {
+        storage::ProjectedRow *select_tuple = tables[i]->SelectIntoBuffer(txn1, version.first);
+        EXPECT_TRUE(tables[i]->select_result_);
+        EXPECT_TRUE(StorageTestUtil::ProjectionListEqualShallow(tables[i]->Layout(), select_tuple, version.second));
+      }
+    }
+    txn_manager->Commit(txn1, transaction::TransactionUtil::EmptyCallback, nullptr);
+    EXPECT_EQ(std::make_pair(0U, 1U), gc->PerformGarbageCollection());
+  }
+}
+
+// Update a tuple, and read it from a transaction that began after the oldest running transaction was last looked up.
+// The reader should unlink the dead version chain on its own, writers should drop it when they install a new version,
+// and the GC should still process every transaction.
+// NOLINTNEXTLINE
+TEST_F(GarbageCollectorTests, PruneVersionChain) {
+  for (uint32_t iteration = 0; iteration < num_iterations_; ++iteration) {
+    auto db_main = DBMain::Builder().SetUseGC(true).Build();
+    auto txn_manager = db_main->GetTransactionLayer()->GetTransactionManager();
+    auto timestamp_manager = db_main->GetTransactionLayer()->GetTimestampManager();
+    auto gc = db_main->GetStorageLayer()->GetGarbageCollector();
+
+    GarbageCollectorDataTableTestObject tested(db_main->GetStorageLayer()->GetBlockStore().Get(), max_columns_,
+                                               &generator_);
+
+    auto *txn0 = txn_manager->BeginTransaction();
+    storage::ProjectedRow *version = tested.GenerateRandomTuple(&generator_);
+    const storage::TupleSlot slot = tested.table_.Insert(common::ManagedPointer(txn0), *version);
+    txn_manager->Commit(txn0, transaction::TransactionUtil::EmptyCallback, nullptr);
+    EXPECT_EQ(std::make_pair(0U, 1U), gc->PerformGarbageCollection());
+    EXPECT_EQ(std::make_pair(1U, 0U), gc->PerformGarbageCollection());
+    storage::RawBlock *block = slot.GetBlock();
+    EXPECT_TRUE(storage::RawBlock::NoVersionChains(block->version_synopsis_.load()));
+
+    auto update = [&](transaction::TransactionContext *const txn) {
+      auto *delta = tested.GenerateRandomUpdate(&generator_);
+      EXPECT_TRUE(tested.table_.Update(common::ManagedPointer(txn), slot, *delta));
+      return tested.GenerateVersionFromUpdate(*delta, *version);
+    };
+    auto check_select = [&](transaction::TransactionContext *const txn, storage::ProjectedRow *const expected) {
+      storage::ProjectedRow *select_tuple = tested.SelectIntoBuffer(txn, slot);
+      EXPECT_TRUE(tested.select_result_);
+      EXPECT_TRUE(StorageTestUtil::ProjectionListEqualShallow(tested.Layout(), select_tuple, expected));
+    };
+
+    auto *txn1 = txn_manager->BeginTransaction();
+    version = update(txn1);
+    txn_manager->Commit(txn1, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+    // The update committed after the oldest running transaction was last looked up, so it has to stay
+    auto *txn2 = txn_manager->BeginTransaction();
+    check_select(txn2, version);
+    txn_manager->Commit(txn2, transaction::TransactionUtil::EmptyCallback, nullptr);
+    EXPECT_FALSE(storage::RawBlock::NoVersionChains(block->version_synopsis_.load()));
+
+    // Once it is known that nobody can see the version before it, the next reader unlinks the whole chain
+    timestamp_manager->OldestTransactionStartTime();
+    auto *txn3 = txn_manager->BeginTransaction();
+    check_select(txn3, version);
+    txn_manager->Commit(txn3, transaction::TransactionUtil::EmptyCallback, nullptr);
+    EXPECT_TRUE(storage::RawBlock::NoVersionChains(block->version_synopsis_.load()));
+
+    auto *txn4 = txn_manager->BeginTransaction();
+    version = update(txn4);
+    txn_manager->Commit(txn4, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+    // The next writer drops the dead version, but a transaction that is running alongside it still reads its
+    // before-image
+    timestamp_manager->OldestTransactionStartTime();
+    auto *txn5 = txn_manager->BeginTransaction();
+    auto *txn6 = txn_manager->BeginTransaction();
+    storage::ProjectedRow *const old_version = version;
+    version = update(txn5);
+    txn_manager->Commit(txn5, transaction::TransactionUtil::EmptyCallback, nullptr);
+    check_select(txn6, old_version);
+    txn_manager->Commit(txn6, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+    auto *txn7 = txn_manager->BeginTransaction();
+    check_select(txn7, version);
+    txn_manager->Commit(txn7, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+    // The GC still unlinks and deallocates every transaction, read-only ones in a single pass
+    EXPECT_EQ(std::make_pair(0U, 7U), gc->PerformGarbageCollection());
+    EXPECT_EQ(std::make_pair(3U, 0U), gc->PerformGarbageCollection());
+    EXPECT_TRUE(storage::RawBlock::NoVersionChains(block->version_synopsis_.load()));
+  }
+}
 }  // namespace terrier
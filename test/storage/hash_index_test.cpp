@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstring>
 #include <functional>
 #include <limits>
@@ -26,10 +27,10 @@ namespace terrier::storage::index {
 class HashIndexTests : public TerrierTest {
  private:
   catalog::Schema table_schema_;
-  catalog::IndexSchema unique_schema_;
   catalog::IndexSchema default_schema_;
 
  public:
+  catalog::IndexSchema unique_schema_;
   std::default_random_engine generator_;
   const uint32_t num_threads_ = 4;
 
@@ -1640,4 +1641,87 @@ TEST_F(HashIndexTests, AbortDelete2) {
   txn_manager_->Commit(txn2, transaction::TransactionUtil::EmptyCallback, nullptr);
 }
 
+
+/**
+ * Bulk loads an empty index with every key twice, and checks that every key finds exactly its tuples, that a unique
+ * index refuses to load repeated keys, and that loading into an index that is no longer empty still checks them.
+ */
+// NOLINTNEXTLINE
+TEST_F(HashIndexTests, BulkLoad) {
+  const uint32_t num_inserts = 100000;
+  std::vector<int32_t> values(num_inserts);
+  for (uint32_t i = 0; i < num_inserts; i++) values[i] = static_cast<int32_t>(i / 2);
+  std::shuffle(values.begin(), values.end(), generator_);
+
+  const uint32_t key_size = default_index_->GetProjectedRowInitializer().ProjectedRowSize();
+  auto *const bulk_key_buffer = common::AllocationUtil::AllocateAligned(key_size * num_inserts);
+  std::vector<const ProjectedRow *> keys;
+  std::vector<TupleSlot> slots;
+  // Slots holding each key
+  std::vector<std::vector<TupleSlot>> expected(num_inserts / 2);
+  auto *txn0 = txn_manager_->BeginTransaction();
+  for (uint32_t i = 0; i < num_inserts; i++) {
+    auto *const insert_redo =
+        txn0->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+    *reinterpret_cast<int32_t *>(insert_redo->Delta()->AccessForceNotNull(0)) = values[i];
+    slots.push_back(sql_table_->Insert(common::ManagedPointer(txn0), insert_redo));
+    expected[values[i]].push_back(slots.back());
+    auto *const key = default_index_->GetProjectedRowInitializer().InitializeRow(bulk_key_buffer + i * key_size);
+    *reinterpret_cast<int32_t *>(key->AccessForceNotNull(0)) = values[i];
+    keys.push_back(key);
+  }
+  EXPECT_TRUE(default_index_->BulkLoad(common::ManagedPointer(txn0), keys.data(), slots.data(), num_inserts));
+  txn_manager_->Commit(txn0, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  auto *txn1 = txn_manager_->BeginTransaction();
+  EXPECT_FALSE(unique_index_->BulkLoad(common::ManagedPointer(txn1), keys.data(), slots.data(), num_inserts));
+  EXPECT_TRUE(txn1->MustAbort());
+  txn_manager_->Abort(txn1);
+
+  // Without the repeated keys the unique index loads fine. The keys of the aborted load are still in the index until
+  // the GC gets to them, so start from a fresh one.
+  delete unique_index_;
+  unique_index_ = IndexBuilder().SetKeySchema(unique_schema_).Build();
+  std::vector<const ProjectedRow *> unique_keys;
+  std::vector<TupleSlot> unique_slots;
+  std::vector<bool> seen(num_inserts / 2, false);
+  for (uint32_t i = 0; i < num_inserts; i++) {
+    if (seen[values[i]]) continue;
+    seen[values[i]] = true;
+    unique_keys.push_back(keys[i]);
+    unique_slots.push_back(slots[i]);
+  }
+  auto *txn2 = txn_manager_->BeginTransaction();
+  EXPECT_TRUE(unique_index_->BulkLoad(common::ManagedPointer(txn2), unique_keys.data(), unique_slots.data(),
+                                      unique_keys.size()));
+  txn_manager_->Commit(txn2, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  auto *txn3 = txn_manager_->BeginTransaction();
+  std::vector<storage::TupleSlot> results;
+  auto *const key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+  for (int32_t value = 0; value < static_cast<int32_t>(num_inserts / 2); value++) {
+    *reinterpret_cast<int32_t *>(key_pr->AccessForceNotNull(0)) = value;
+    default_index_->ScanKey(*txn3, *key_pr, &results);
+    EXPECT_EQ(results.size(), 2);
+    for (const auto &result : results)
+      EXPECT_NE(std::find(expected[value].begin(), expected[value].end(), result), expected[value].end());
+    results.clear();
+    unique_index_->ScanKey(*txn3, *key_pr, &results);
+    EXPECT_EQ(results.size(), 1);
+    if (!results.empty())
+      EXPECT_NE(std::find(expected[value].begin(), expected[value].end(), results[0]), expected[value].end());
+    results.clear();
+  }
+  txn_manager_->Commit(txn3, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  // The unique index is no longer empty, so loading more keys into it goes one key at a time, and still has to catch a
+  // key that is already there
+  auto *txn4 = txn_manager_->BeginTransaction();
+  EXPECT_FALSE(unique_index_->BulkLoad(common::ManagedPointer(txn4), unique_keys.data(), unique_slots.data(), 1));
+  EXPECT_TRUE(txn4->MustAbort());
+  txn_manager_->Abort(txn4);
+
+  delete[] bulk_key_buffer;
+}
+
 }  // namespace terrier::storage::index
@@ -1,4 +1,6 @@
+#include <fstream>
 #include <future>  // NOLINT
+#include <limits>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -9,6 +11,7 @@
 #include "gtest/gtest.h"
 #include "main/db_main.h"
 #include "storage/projected_row.h"
+#include "storage/recovery/disk_log_provider.h"
 #include "storage/sql_table.h"
 #include "storage/storage_defs.h"
 #include "storage/write_ahead_log/log_manager.h"
@@ -54,9 +57,15 @@ class WriteAheadLoggingTests : public TerrierTest {
 
   /**
    * @warning If the serialization format of logs ever changes, this function will need to be updated.
+   * @return the next record, or nullptr if the log ends in padding
    */
   storage::LogRecord *ReadNextRecord(storage::BufferedLogReader *in) {
     auto size = in->ReadValue<uint32_t>();
+    // Logs written with direct I/O contain padding, which starts with a zero size
+    while (size == 0) {
+      if (!in->SkipPadding()) return nullptr;
+      size = in->ReadValue<uint32_t>();
+    }
     byte *buf = common::AllocationUtil::AllocateAligned(size);
     auto record_type = in->ReadValue<storage::LogRecordType>();
     auto txn_begin = in->ReadValue<transaction::timestamp_t>();
@@ -417,6 +426,102 @@ TEST_F(WriteAheadLoggingTests, NoAbortRecordTest) {
   db_main_->GetTransactionLayer()->GetDeferredActionManager()->RegisterDeferredAction([=]() { delete sql_table; });
 }
 
+// This test inserts more tuples than fit into one redo buffer segment through StageWrites and SqlTable::InsertBatch,
+// and checks that each call stages as many records as fit back to back, and that every tuple is stored and logged out.
+// NOLINTNEXTLINE
+TEST_F(WriteAheadLoggingTests, BatchInsertAcrossRedoSegmentsTest) {
+  // Create SQLTable
+  auto col = catalog::Schema::Column("attribute", type::TypeId::INTEGER, false,
+                                     parser::ConstantValueExpression(type::TypeId::INTEGER));
+  StorageTestUtil::ForceOid(&(col), catalog::col_oid_t(0));
+  auto table_schema = catalog::Schema(std::vector<catalog::Schema::Column>({col}));
+  auto *const sql_table = new storage::SqlTable(store_, table_schema);
+  auto tuple_initializer = sql_table->InitializerForProjectedRow({catalog::col_oid_t(0)});
+
+  // Enough rows to fill several redo buffer segments
+  const uint32_t num_rows = 1000;
+  std::vector<byte *> row_buffers;
+  std::vector<storage::ProjectedRow *> rows;
+  for (uint32_t i = 0; i < num_rows; i++) {
+    row_buffers.push_back(common::AllocationUtil::AllocateAligned(tuple_initializer.ProjectedRowSize()));
+    rows.push_back(tuple_initializer.InitializeRow(row_buffers.back()));
+    *reinterpret_cast<int32_t *>(rows.back()->AccessForceNotNull(0)) = static_cast<int32_t>(i);
+  }
+  const uint32_t record_size = storage::RedoRecord::Size(*rows[0]);
+  ASSERT_LT(record_size * 2, common::Constants::BUFFER_SEGMENT_SIZE);
+  ASSERT_GT(record_size * num_rows, common::Constants::BUFFER_SEGMENT_SIZE);
+
+  auto *txn = txn_manager_->BeginTransaction();
+  std::vector<storage::RedoRecord *> records(num_rows);
+  std::vector<storage::TupleSlot> slots(num_rows);
+  uint32_t inserted = 0;
+  uint32_t num_batches = 0;
+  while (inserted < num_rows) {
+    const uint32_t staged = txn->StageWrites(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID,
+                                             rows.data() + inserted, num_rows - inserted, records.data());
+    ASSERT_GE(staged, 1);
+    ASSERT_LE(staged, num_rows - inserted);
+    // Records staged together lie back to back in one segment
+    for (uint32_t i = 1; i < staged; i++)
+      EXPECT_EQ(reinterpret_cast<byte *>(records[i - 1]) + record_size, reinterpret_cast<byte *>(records[i]));
+    sql_table->InsertBatch(common::ManagedPointer(txn), records.data(), staged, slots.data() + inserted);
+    for (uint32_t i = 0; i < staged; i++) EXPECT_EQ(slots[inserted + i], records[i]->GetTupleSlot());
+    inserted += staged;
+    num_batches++;
+  }
+  EXPECT_GT(num_batches, 1);
+  EXPECT_TRUE(GetRedoBuffer(txn).HasFlushed());
+  const transaction::timestamp_t txn_begin = txn->StartTime();
+  txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  // Every tuple reads back its value
+  std::unordered_map<storage::TupleSlot, int32_t> expected_values;
+  auto *read_txn = txn_manager_->BeginTransaction();
+  byte *select_buffer = common::AllocationUtil::AllocateAligned(tuple_initializer.ProjectedRowSize());
+  for (uint32_t i = 0; i < num_rows; i++) {
+    storage::ProjectedRow *select_row = tuple_initializer.InitializeRow(select_buffer);
+    EXPECT_TRUE(sql_table->Select(common::ManagedPointer(read_txn), slots[i], select_row));
+    EXPECT_EQ(static_cast<int32_t>(i), *reinterpret_cast<int32_t *>(select_row->AccessWithNullCheck(0)));
+    EXPECT_TRUE(expected_values.emplace(slots[i], static_cast<int32_t>(i)).second);
+  }
+  txn_manager_->Commit(read_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  delete[] select_buffer;
+  for (auto *row_buffer : row_buffers) delete[] row_buffer;
+
+  // Shut down log manager
+  log_manager_->PersistAndStop();
+
+  // Every tuple is logged out exactly once with its slot and value, followed by the commit
+  bool found_commit_record = false;
+  storage::BufferedLogReader in(LOG_FILE_NAME);
+  while (in.HasMore()) {
+    storage::LogRecord *log_record = ReadNextRecord(&in);
+    if (log_record == nullptr) break;
+    if (log_record->TxnBegin() == txn_begin) {
+      if (log_record->RecordType() == LogRecordType::COMMIT) {
+        EXPECT_TRUE(expected_values.empty());
+        found_commit_record = true;
+      } else {
+        EXPECT_EQ(LogRecordType::REDO, log_record->RecordType());
+        auto *redo = log_record->GetUnderlyingRecordBodyAs<storage::RedoRecord>();
+        auto it = expected_values.find(redo->GetTupleSlot());
+        EXPECT_NE(expected_values.end(), it);
+        if (it != expected_values.end()) {
+          EXPECT_EQ(it->second, *reinterpret_cast<int32_t *>(redo->Delta()->AccessWithNullCheck(0)));
+          expected_values.erase(it);
+        }
+      }
+    }
+    delete[] reinterpret_cast<byte *>(log_record);
+  }
+  EXPECT_TRUE(found_commit_record);
+  EXPECT_TRUE(expected_values.empty());
+
+  // the table can't be freed until after all GC on it is guaranteed to be done. The easy way to do that is to use a
+  // DeferredAction
+  db_main_->GetTransactionLayer()->GetDeferredActionManager()->RegisterDeferredAction([=]() { delete sql_table; });
+}
+
 // Verify that we invoke the callback even for read-only txns. This test checks a bug that was found when sending
 // BEGIN; COMMIT; across PSQL and noticing that COMMIT blocked forever with a real callback.
 TEST_F(WriteAheadLoggingTests, ReadOnlyCallbackTest) {
@@ -447,4 +552,302 @@ TEST_F(WriteAheadLoggingTests, ReadOnlyCallbackTest) {
   // DeferredAction
   db_main_->GetTransactionLayer()->GetDeferredActionManager()->RegisterDeferredAction([=]() { delete sql_table; });
 }
+
+// Verify that under group commit, commit callbacks are invoked once the log is persisted without anyone forcing a flush
+// NOLINTNEXTLINE
+TEST_F(WriteAheadLoggingTests, GroupCommitCallbackTest) {
+  // Restart the log manager in group commit mode
+  log_manager_->PersistAndStop();
+  log_manager_->SetGroupCommit(std::chrono::microseconds(1000), 4);
+  log_manager_->Start();
+
+  const uint32_t num_txns = 10;
+  std::vector<std::promise<bool>> promises(num_txns);
+  for (auto &promise : promises) {
+    auto *const txn = txn_manager_->BeginTransaction();
+    txn_manager_->Commit(txn, TestCommitCallback, &promise);
+  }
+
+  // Every commit either fills up a group or hits its target latency, so all of them should be persisted well within
+  // the timeout
+  for (auto &promise : promises) {
+    auto future = promise.get_future();
+    EXPECT_EQ(future.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+  }
+
+  log_manager_->PersistAndStop();
+}
+
+// Verify that under group commit, a full group is persisted right away instead of waiting for its target latency
+// NOLINTNEXTLINE
+TEST_F(WriteAheadLoggingTests, GroupCommitFullGroupTest) {
+  // Restart the log manager with a target latency far longer than the test may take
+  const uint64_t group_size = 4;
+  log_manager_->PersistAndStop();
+  log_manager_->SetGroupCommit(std::chrono::seconds(100), group_size);
+  log_manager_->Start();
+
+  std::vector<std::promise<bool>> promises(group_size);
+  std::vector<std::future<bool>> futures;
+  for (auto &promise : promises) futures.emplace_back(promise.get_future());
+
+  // One commit short of a full group, nothing is persisted
+  for (uint64_t i = 0; i < group_size - 1; i++) {
+    auto *const txn = txn_manager_->BeginTransaction();
+    txn_manager_->Commit(txn, TestCommitCallback, &promises[i]);
+  }
+  for (auto &future : futures)
+    EXPECT_EQ(future.wait_for(std::chrono::milliseconds(100)), std::future_status::timeout);
+
+  // The last commit fills the group, which is persisted long before the target latency is up
+  auto *const txn = txn_manager_->BeginTransaction();
+  txn_manager_->Commit(txn, TestCommitCallback, &promises[group_size - 1]);
+  for (auto &future : futures) EXPECT_EQ(future.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+
+  log_manager_->PersistAndStop();
+  log_manager_->SetGroupCommit(std::chrono::microseconds(0), storage::LogManager::DEFAULT_GROUP_COMMIT_SIZE);
+}
+
+// With several log streams, a commit may only be acknowledged once every commit before it is persisted, whichever
+// stream it went to. Commit a transaction in one stream and then one in the other, and persist only the stream of the
+// second, as if the system went down before the first stream got to persist. The second commit must not have been
+// acknowledged at that point.
+// NOLINTNEXTLINE
+TEST_F(WriteAheadLoggingTests, MultiStreamCommitCallbackTest) {
+  // Restart the log manager with two streams that only persist when they are told to
+  log_manager_->PersistAndStop();
+  log_manager_->SetNumStreams(2);
+  log_manager_->SetGroupCommit(std::chrono::seconds(100), std::numeric_limits<uint64_t>::max());
+  log_manager_->Start();
+
+  // Find a transaction in each stream, and commit the one in stream 1 first
+  transaction::TransactionContext *txns[2] = {nullptr, nullptr};
+  while (txns[0] == nullptr || txns[1] == nullptr) {
+    auto *const txn = txn_manager_->BeginTransaction();
+    auto *&slot = txns[log_manager_->StreamOf(txn->StartTime())];
+    if (slot == nullptr) {
+      slot = txn;
+    } else {
+      txn_manager_->Abort(txn);
+    }
+  }
+  std::promise<bool> first_promise, second_promise;
+  auto first_future = first_promise.get_future();
+  auto second_future = second_promise.get_future();
+  txn_manager_->Commit(txns[1], TestCommitCallback, &first_promise);
+  txn_manager_->Commit(txns[0], TestCommitCallback, &second_promise);
+
+  // The second commit is persisted, but the first is not yet
+  log_manager_->TestForceFlushStream(0);
+  EXPECT_EQ(second_future.wait_for(std::chrono::milliseconds(100)), std::future_status::timeout);
+  EXPECT_EQ(first_future.wait_for(std::chrono::milliseconds(0)), std::future_status::timeout);
+
+  // Once the first stream catches up, both are acknowledged
+  log_manager_->TestForceFlushStream(1);
+  EXPECT_EQ(first_future.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+  EXPECT_EQ(second_future.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+
+  log_manager_->PersistAndStop();
+  log_manager_->SetNumStreams(1);
+  log_manager_->SetGroupCommit(std::chrono::microseconds(0), storage::LogManager::DEFAULT_GROUP_COMMIT_SIZE);
+  unlink(LogManager::StreamFilePath(LOG_FILE_NAME, 1).c_str());
+}
+
+// This test logs a workload with direct I/O, and then reads the padded log file back in to make sure every committed
+// transaction's commit record made it
+// NOLINTNEXTLINE
+TEST_F(WriteAheadLoggingTests, DirectIOLogTest) {
+  // Restart the log manager with direct I/O on a fresh log file, since it can't append to a log written without
+  log_manager_->PersistAndStop();
+  unlink(LOG_FILE_NAME);
+  log_manager_->SetDirectIO(true);
+  log_manager_->Start();
+
+  auto config = LargeDataTableTestConfiguration::Builder()
+                    .SetNumTxns(100)
+                    .SetNumConcurrentTxns(4)
+                    .SetUpdateSelectRatio({0.5, 0.5})
+                    .SetTxnLength(5)
+                    .SetInitialTableSize(1000)
+                    .SetMaxColumns(5)
+                    .SetVarlenAllowed(true)
+                    .Build();
+  auto *const tested =
+      new LargeDataTableTestObject(config, store_.Get(), txn_manager_.Get(), &generator_, log_manager_.Get());
+  auto result = tested->SimulateOltp(100, 4);
+  log_manager_->PersistAndStop();
+
+  // Every write is padded to the direct I/O alignment
+  struct stat log_file_stat;
+  ASSERT_EQ(stat(LOG_FILE_NAME, &log_file_stat), 0);
+  EXPECT_EQ(log_file_stat.st_size % common::Constants::LOG_DIRECT_IO_ALIGNMENT, 0);
+
+  std::unordered_map<transaction::timestamp_t, RandomDataTableTransaction *> txns_map;
+  for (auto *txn : result.first)
+    if (!txn->Updates()->empty()) txns_map[txn->BeginTimestamp()] = txn;
+  storage::BufferedLogReader in(LOG_FILE_NAME);
+  while (in.HasMore()) {
+    storage::LogRecord *log_record = ReadNextRecord(&in);
+    if (log_record == nullptr) break;
+    if (log_record->RecordType() == storage::LogRecordType::COMMIT) {
+      auto it = txns_map.find(log_record->TxnBegin());
+      if (it != txns_map.end()) {
+        EXPECT_EQ(log_record->GetUnderlyingRecordBodyAs<storage::CommitRecord>()->CommitTime(),
+                  it->second->CommitTimestamp());
+        txns_map.erase(it);
+      }
+    }
+    delete[] reinterpret_cast<byte *>(log_record);
+  }
+  EXPECT_TRUE(txns_map.empty());
+
+  log_manager_->SetDirectIO(false);
+  db_main_->GetTransactionLayer()->GetDeferredActionManager()->RegisterDeferredAction([=]() { delete tested; });
+
+  for (auto *txn : result.first) delete txn;
+  for (auto *txn : result.second) delete txn;
+}
+
+// This test cuts the log into segments, and checks that only the segments no longer needed are discarded
+// NOLINTNEXTLINE
+TEST_F(WriteAheadLoggingTests, DiscardSegmentsTest) {
+  // Restart the log manager with segments, without an unsegmented log file of its own from before
+  log_manager_->PersistAndStop();
+  unlink(LOG_FILE_NAME);
+  log_manager_->SetSegmentSize(1 << 14);
+  log_manager_->Start();
+
+  auto config = LargeDataTableTestConfiguration::Builder()
+                    .SetNumTxns(100)
+                    .SetNumConcurrentTxns(4)
+                    .SetUpdateSelectRatio({0.5, 0.5})
+                    .SetTxnLength(5)
+                    .SetInitialTableSize(1000)
+                    .SetMaxColumns(5)
+                    .SetVarlenAllowed(true)
+                    .Build();
+  auto *const tested =
+      new LargeDataTableTestObject(config, store_.Get(), txn_manager_.Get(), &generator_, log_manager_.Get());
+  auto result = tested->SimulateOltp(100, 4);
+  log_manager_->ForceFlush();
+
+  const auto num_segments = LogManager::ListSegments(LOG_FILE_NAME).size();
+  EXPECT_GT(num_segments, 1);
+  // None of the transactions' changes are durable anywhere but the log yet
+  EXPECT_EQ(log_manager_->DiscardSegments(transaction::INITIAL_TXN_TIMESTAMP), 0);
+  EXPECT_EQ(LogManager::ListSegments(LOG_FILE_NAME).size(), num_segments);
+  // Once all of them are, only the segment still being written to is needed
+  EXPECT_EQ(log_manager_->DiscardSegments(transaction::timestamp_t(INT64_MAX)), num_segments - 1);
+  EXPECT_EQ(LogManager::ListSegments(LOG_FILE_NAME).size(), 1);
+
+  log_manager_->PersistAndStop();
+  for (const auto segment_id : LogManager::ListSegments(LOG_FILE_NAME))
+    unlink(LogManager::SegmentFilePath(LOG_FILE_NAME, segment_id).c_str());
+  log_manager_->SetSegmentSize(0);
+  db_main_->GetTransactionLayer()->GetDeferredActionManager()->RegisterDeferredAction([=]() { delete tested; });
+
+  for (auto *txn : result.first) delete txn;
+  for (auto *txn : result.second) delete txn;
+}
+
+// Once a checkpoint covers them, the log files written before the log manager switched to segments, and those of
+// earlier runs that were rotated out of the way, are discarded along with the segments no longer needed
+// NOLINTNEXTLINE
+TEST_F(WriteAheadLoggingTests, DiscardEarlierRunsTest) {
+  // Restart the log manager with segments, with the log file it wrote so far still there, and an earlier run's log
+  log_manager_->PersistAndStop();
+  const std::string run_file_path = LogManager::RunFilePath(LOG_FILE_NAME, 0);
+  for (uint32_t i = 0; i < 2; i++) std::ofstream(LogManager::StreamFilePath(run_file_path, i)).close();
+  log_manager_->SetSegmentSize(1 << 14);
+  log_manager_->Start();
+  ASSERT_EQ(access(LOG_FILE_NAME, F_OK), 0);
+
+  // None of the transactions' changes are durable anywhere but the log, but everything before the restart is
+  EXPECT_EQ(log_manager_->DiscardSegments(transaction::INITIAL_TXN_TIMESTAMP), 3);
+  EXPECT_NE(access(LOG_FILE_NAME, F_OK), 0);
+  EXPECT_TRUE(LogManager::ListRotatedRuns(LOG_FILE_NAME).empty());
+  EXPECT_NE(access(LogManager::StreamFilePath(run_file_path, 1).c_str(), F_OK), 0);
+  EXPECT_EQ(LogManager::ListSegments(LOG_FILE_NAME).size(), 1);
+  EXPECT_EQ(log_manager_->DiscardSegments(transaction::INITIAL_TXN_TIMESTAMP), 0);
+
+  log_manager_->PersistAndStop();
+  for (const auto segment_id : LogManager::ListSegments(LOG_FILE_NAME))
+    unlink(LogManager::SegmentFilePath(LOG_FILE_NAME, segment_id).c_str());
+  log_manager_->SetSegmentSize(0);
+}
+
+// Streams are merged by commit timestamp, which restarts with the system. Log a workload with two streams, restart on
+// the same log files, and log another. The first run's files must have been rotated out of the way rather than appended
+// to, so that reading the log back yields every commit of the first run before any of the second.
+// NOLINTNEXTLINE
+TEST_F(WriteAheadLoggingTests, RestartRotatesMultiStreamLogTest) {
+  log_manager_->PersistAndStop();
+  log_manager_->SetNumStreams(2);
+  log_manager_->Start();
+
+  auto config = LargeDataTableTestConfiguration::Builder()
+                    .SetNumTxns(50)
+                    .SetNumConcurrentTxns(4)
+                    .SetUpdateSelectRatio({0.5, 0.5})
+                    .SetTxnLength(5)
+                    .SetInitialTableSize(100)
+                    .SetMaxColumns(5)
+                    .SetVarlenAllowed(true)
+                    .Build();
+  auto *const first_tested =
+      new LargeDataTableTestObject(config, store_.Get(), txn_manager_.Get(), &generator_, log_manager_.Get());
+  auto first_result = first_tested->SimulateOltp(50, 4);
+  log_manager_->PersistAndStop();
+
+  // Restart on the same log files
+  auto restarted_db_main =
+      DBMain::Builder().SetWalFilePath(LOG_FILE_NAME).SetUseLogging(true).SetWalNumStreams(2).SetUseGC(true).Build();
+  EXPECT_EQ(LogManager::ListRotatedRuns(LOG_FILE_NAME), std::vector<uint64_t>{0});
+  auto restarted_txn_manager = restarted_db_main->GetTransactionLayer()->GetTransactionManager();
+  auto restarted_log_manager = restarted_db_main->GetLogManager();
+  auto *const second_tested =
+      new LargeDataTableTestObject(config, restarted_db_main->GetStorageLayer()->GetBlockStore().Get(),
+                                   restarted_txn_manager.Get(), &generator_, restarted_log_manager.Get());
+  auto second_result = second_tested->SimulateOltp(50, 4);
+  restarted_log_manager->PersistAndStop();
+
+  // Commits come back in commit order within each run, and the commit timestamps only go back once, where the second
+  // run starts
+  uint64_t num_expected_commits = 0;
+  for (auto *txn : first_result.first)
+    if (!txn->Updates()->empty()) num_expected_commits++;
+  for (auto *txn : second_result.first)
+    if (!txn->Updates()->empty()) num_expected_commits++;
+  uint64_t num_commits = 0, num_restarts = 0;
+  transaction::timestamp_t last_commit_time = transaction::INITIAL_TXN_TIMESTAMP;
+  DiskLogProvider provider(LOG_FILE_NAME, 2);
+  for (auto record = provider.GetNextRecord(); record.first != nullptr; record = provider.GetNextRecord()) {
+    if (record.first->RecordType() == LogRecordType::COMMIT) {
+      const auto commit_time = record.first->GetUnderlyingRecordBodyAs<CommitRecord>()->CommitTime();
+      if (commit_time < last_commit_time) num_restarts++;
+      last_commit_time = commit_time;
+      num_commits++;
+    }
+    for (auto *const varlen : record.second) delete[] varlen;
+    delete[] reinterpret_cast<byte *>(record.first);
+  }
+  EXPECT_EQ(num_commits, num_expected_commits);
+  EXPECT_EQ(num_restarts, 1);
+
+  restarted_log_manager->Start();
+  restarted_db_main->GetTransactionLayer()->GetDeferredActionManager()->RegisterDeferredAction(
+      [=]() { delete second_tested; });
+  restarted_db_main.reset();
+  for (uint32_t i = 0; i < 2; i++) {
+    unlink(LogManager::StreamFilePath(LogManager::RunFilePath(LOG_FILE_NAME, 0), i).c_str());
+    unlink(LogManager::StreamFilePath(LOG_FILE_NAME, i).c_str());
+  }
+  log_manager_->SetNumStreams(1);
+  db_main_->GetTransactionLayer()->GetDeferredActionManager()->RegisterDeferredAction([=]() { delete first_tested; });
+
+  for (auto *txn : first_result.first) delete txn;
+  for (auto *txn : first_result.second) delete txn;
+  for (auto *txn : second_result.first) delete txn;
+  for (auto *txn : second_result.second) delete txn;
+}
 }  // namespace terrier::storage
@@ -8,7 +8,10 @@
 #include "gtest/gtest.h"
 #include "main/db_main.h"
 #include "storage/garbage_collector_thread.h"
+#include "storage/index/index.h"
 #include "storage/index/index_builder.h"
+#include "storage/recovery/checkpoint_log_provider.h"
+#include "storage/recovery/checkpoint_manager.h"
 #include "storage/recovery/disk_log_provider.h"
 #include "storage/recovery/recovery_manager.h"
 #include "storage/sql_table.h"
@@ -24,6 +27,7 @@
 // executions will read old test's data, and the cause of the errors will be hard to identify. Trust me it will drive
 // you nuts...
 #define LOG_FILE_NAME "./test.log"
+#define CHECKPOINT_FILE_NAME "./test.checkpoint"
 
 namespace terrier::storage {
 class RecoveryTests : public TerrierTest {
@@ -46,8 +50,8 @@ class RecoveryTests : public TerrierTest {
   common::ManagedPointer<common::DedicatedThreadRegistry> recovery_thread_registry_;
 
   void SetUp() override {
-    // Unlink log file incase one exists from previous test iteration
-    unlink(LOG_FILE_NAME);
+    // Unlink log files incase they exist from previous test iteration
+    UnlinkLogFiles();
 
     db_main_ = terrier::DBMain::Builder()
                    .SetWalFilePath(LOG_FILE_NAME)
@@ -76,10 +80,26 @@ class RecoveryTests : public TerrierTest {
   }
 
   void TearDown() override {
-    // Delete log file
-    unlink(LOG_FILE_NAME);
+    // Delete log files, including those of any extra log streams, and checkpoints
+    UnlinkLogFiles();
   }
 
+  static void UnlinkLogFiles() {
+    for (uint32_t i = 0; i < MAX_LOG_STREAMS; i++) {
+      const std::string stream_file_path = LogManager::StreamFilePath(LOG_FILE_NAME, i);
+      unlink(stream_file_path.c_str());
+      for (const auto segment_id : LogManager::ListSegments(stream_file_path))
+        unlink(LogManager::SegmentFilePath(stream_file_path, segment_id).c_str());
+      for (const auto run : LogManager::ListRotatedRuns(LOG_FILE_NAME))
+        unlink(LogManager::StreamFilePath(LogManager::RunFilePath(LOG_FILE_NAME, run), i).c_str());
+    }
+    for (const auto checkpoint_id : CheckpointManager::ListCheckpoints(CHECKPOINT_FILE_NAME))
+      unlink(CheckpointManager::CheckpointFilePath(CHECKPOINT_FILE_NAME, checkpoint_id).c_str());
+  }
+
+  // Most tests log to a single stream, but the ones that don't use no more than this many
+  static constexpr uint32_t MAX_LOG_STREAMS = 4;
+
   catalog::IndexSchema DummyIndexSchema() {
     std::vector<catalog::IndexSchema::Column> keycols;
     keycols.emplace_back(
@@ -183,22 +203,47 @@ class RecoveryTests : public TerrierTest {
     recovery_manager.WaitForRecoveryToFinish();
   }
 
-  void RunTest(const LargeSqlTableTestConfiguration &config) {
+  void RunTest(const LargeSqlTableTestConfiguration &config, const uint32_t num_log_streams = 1,
+               const bool take_checkpoint = false, const uint32_t num_replay_threads = 1,
+               const bool defer_index_builds = false) {
+    TERRIER_ASSERT(num_log_streams <= MAX_LOG_STREAMS, "Too many log streams to clean up after");
+    if (num_log_streams != log_manager_->NumStreams()) {
+      // Restart the log manager with the requested streams. What was logged so far stays in the first stream's file.
+      log_manager_->PersistAndStop();
+      log_manager_->SetNumStreams(num_log_streams);
+      log_manager_->Start();
+    }
+
     // Run workload
     auto *tested =
         new LargeSqlTableTestObject(config, txn_manager_.Get(), catalog_.Get(), block_store_.Get(), &generator_);
     tested->SimulateOltp(100, 4);
 
+    if (take_checkpoint) {
+      // Checkpoint half way through, so that recovery needs both the checkpoint and the log written after it
+      CheckpointManager checkpoint_manager(CHECKPOINT_FILE_NAME, catalog_, txn_manager_,
+                                           db_main_->GetTransactionLayer()->GetTimestampManager(), log_manager_);
+      checkpoint_manager.TakeCheckpoint();
+      tested->SimulateOltp(100, 4);
+    }
+
     ShutdownAndRestartSystem();
 
     // Instantiate recovery manager, and recover the tables.
-    DiskLogProvider log_provider{LOG_FILE_NAME};
+    DiskLogProvider log_provider{LOG_FILE_NAME, num_log_streams};
+    std::unique_ptr<CheckpointLogProvider> checkpoint_provider = nullptr;
+    if (take_checkpoint)
+      checkpoint_provider =
+          std::make_unique<CheckpointLogProvider>(CheckpointManager::LatestCheckpointFilePath(CHECKPOINT_FILE_NAME));
     RecoveryManager recovery_manager{common::ManagedPointer<AbstractLogProvider>(&log_provider),
                                      recovery_catalog_,
                                      recovery_txn_manager_,
                                      recovery_deferred_action_manager_,
                                      recovery_thread_registry_,
-                                     recovery_block_store_};
+                                     recovery_block_store_,
+                                     common::ManagedPointer(checkpoint_provider)};
+    recovery_manager.SetNumReplayThreads(num_replay_threads);
+    recovery_manager.SetDeferIndexBuilds(defer_index_builds);
     recovery_manager.StartRecovery();
     recovery_manager.WaitForRecoveryToFinish();
 
@@ -248,6 +293,169 @@ TEST_F(RecoveryTests, SingleTableTest) {
   RecoveryTests::RunTest(config);
 }
 
+// This test runs the same workload as SingleTableTest, but logs it to several log streams that have to be merged back
+// together during recovery
+// NOLINTNEXTLINE
+TEST_F(RecoveryTests, MultiStreamTest) {
+  LargeSqlTableTestConfiguration config = LargeSqlTableTestConfiguration::Builder()
+                                              .SetNumDatabases(1)
+                                              .SetNumTables(1)
+                                              .SetMaxColumns(5)
+                                              .SetInitialTableSize(1000)
+                                              .SetTxnLength(5)
+                                              .SetInsertUpdateSelectDeleteRatio({0.2, 0.5, 0.2, 0.1})
+                                              .SetVarlenAllowed(true)
+                                              .Build();
+  RecoveryTests::RunTest(config, 4);
+}
+
+// This test checks that we recover correctly from a log that is cut into segments. The catalog is bootstrapped before
+// we switch to segments, so this also checks that recovery picks up the unsegmented log file in front of the segments
+// NOLINTNEXTLINE
+TEST_F(RecoveryTests, SegmentedLogTest) {
+  log_manager_->PersistAndStop();
+  log_manager_->SetSegmentSize(1 << 14);
+  log_manager_->Start();
+
+  LargeSqlTableTestConfiguration config = LargeSqlTableTestConfiguration::Builder()
+                                              .SetNumDatabases(1)
+                                              .SetNumTables(1)
+                                              .SetMaxColumns(5)
+                                              .SetInitialTableSize(1000)
+                                              .SetTxnLength(5)
+                                              .SetInsertUpdateSelectDeleteRatio({0.2, 0.5, 0.2, 0.1})
+                                              .SetVarlenAllowed(true)
+                                              .Build();
+  RecoveryTests::RunTest(config);
+  EXPECT_GT(LogManager::ListSegments(LOG_FILE_NAME).size(), 1);
+}
+
+// This test takes a checkpoint half way through the workload, and recovers from the checkpoint and the log written
+// after it. The log is cut into segments, so this also checks that the checkpoint discards the segments that recovery
+// no longer needs, and that recovery skips what is left of the log from before the checkpoint.
+// NOLINTNEXTLINE
+TEST_F(RecoveryTests, CheckpointTest) {
+  log_manager_->PersistAndStop();
+  log_manager_->SetSegmentSize(1 << 14);
+  log_manager_->Start();
+
+  LargeSqlTableTestConfiguration config = LargeSqlTableTestConfiguration::Builder()
+                                              .SetNumDatabases(2)
+                                              .SetNumTables(2)
+                                              .SetMaxColumns(5)
+                                              .SetInitialTableSize(1000)
+                                              .SetTxnLength(5)
+                                              .SetInsertUpdateSelectDeleteRatio({0.2, 0.5, 0.2, 0.1})
+                                              .SetVarlenAllowed(true)
+                                              .Build();
+  RecoveryTests::RunTest(config, 1, true);
+  EXPECT_EQ(CheckpointManager::ListCheckpoints(CHECKPOINT_FILE_NAME).size(), 1);
+  EXPECT_GT(LogManager::ListSegments(LOG_FILE_NAME).front(), 0);
+}
+
+// This test runs the same workload as SingleTableTest over several tables, and replays it on several threads with index
+// builds deferred to the end of recovery
+// NOLINTNEXTLINE
+TEST_F(RecoveryTests, ParallelReplayTest) {
+  LargeSqlTableTestConfiguration config = LargeSqlTableTestConfiguration::Builder()
+                                              .SetNumDatabases(2)
+                                              .SetNumTables(2)
+                                              .SetMaxColumns(5)
+                                              .SetInitialTableSize(1000)
+                                              .SetTxnLength(5)
+                                              .SetInsertUpdateSelectDeleteRatio({0.2, 0.5, 0.2, 0.1})
+                                              .SetVarlenAllowed(true)
+                                              .Build();
+  RecoveryTests::RunTest(config, 1, false, 4, true);
+}
+
+// Tests that indexes on user tables hold exactly the live tuples once their builds are deferred to the end of recovery.
+// NOLINTNEXTLINE
+TEST_F(RecoveryTests, DeferredIndexBuildTest) {
+  std::string database_name = "testdb";
+  auto namespace_oid = catalog::postgres::NAMESPACE_DEFAULT_NAMESPACE_OID;
+  std::string table_name = "testtable";
+  std::string index_name = "testindex";
+  const int32_t num_tuples = 1000;
+
+  // Create database, table and index
+  auto *txn = txn_manager_->BeginTransaction();
+  auto db_oid = CreateDatabase(txn, catalog_, database_name);
+  auto db_catalog = catalog_->GetDatabaseCatalog(common::ManagedPointer(txn), db_oid);
+  auto table_oid = CreateTable(txn, db_catalog, namespace_oid, table_name);
+  auto index_oid = CreateIndex(txn, db_catalog, namespace_oid, table_oid, index_name);
+  txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  // Insert keys [0, num_tuples), then delete every odd one in a later transaction
+  txn = txn_manager_->BeginTransaction();
+  db_catalog = catalog_->GetDatabaseCatalog(common::ManagedPointer(txn), db_oid);
+  auto table_ptr = db_catalog->GetTable(common::ManagedPointer(txn), table_oid);
+  const auto &schema = db_catalog->GetSchema(common::ManagedPointer(txn), table_oid);
+  auto initializer = table_ptr->InitializerForProjectedRow({schema.GetColumn(0).Oid()});
+  std::vector<TupleSlot> slots;
+  for (int32_t key = 0; key < num_tuples; key++) {
+    auto *redo_record = txn->StageWrite(db_oid, table_oid, initializer);
+    *reinterpret_cast<int32_t *>(redo_record->Delta()->AccessForceNotNull(0)) = key;
+    slots.push_back(table_ptr->Insert(common::ManagedPointer(txn), redo_record));
+  }
+  txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  txn = txn_manager_->BeginTransaction();
+  for (int32_t key = 1; key < num_tuples; key += 2) {
+    txn->StageDelete(db_oid, table_oid, slots[key]);
+    EXPECT_TRUE(table_ptr->Delete(common::ManagedPointer(txn), slots[key]));
+  }
+  txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  ShutdownAndRestartSystem();
+
+  // Replay on several threads, leaving the user index to be rebuilt from the recovered table at the end
+  DiskLogProvider log_provider(LOG_FILE_NAME);
+  RecoveryManager recovery_manager{common::ManagedPointer<AbstractLogProvider>(&log_provider),
+                                   recovery_catalog_,
+                                   recovery_txn_manager_,
+                                   recovery_deferred_action_manager_,
+                                   recovery_thread_registry_,
+                                   recovery_block_store_};
+  recovery_manager.SetNumReplayThreads(4);
+  recovery_manager.SetDeferIndexBuilds(true);
+  recovery_manager.StartRecovery();
+  recovery_manager.WaitForRecoveryToFinish();
+
+  // Every surviving key maps to exactly one tuple holding that key, and no deleted key is left in the index
+  txn = recovery_txn_manager_->BeginTransaction();
+  db_catalog = recovery_catalog_->GetDatabaseCatalog(common::ManagedPointer(txn), db_oid);
+  ASSERT_TRUE(db_catalog);
+  auto recovered_table = db_catalog->GetTable(common::ManagedPointer(txn), table_oid);
+  auto recovered_index = db_catalog->GetIndex(common::ManagedPointer(txn), index_oid);
+  ASSERT_TRUE(recovered_table);
+  ASSERT_TRUE(recovered_index);
+
+  const auto &key_initializer = recovered_index->GetProjectedRowInitializer();
+  auto *key_buffer = common::AllocationUtil::AllocateAligned(key_initializer.ProjectedRowSize());
+  auto *key = key_initializer.InitializeRow(key_buffer);
+  auto tuple_initializer = recovered_table->InitializerForProjectedRow(
+      {db_catalog->GetSchema(common::ManagedPointer(txn), table_oid).GetColumn(0).Oid()});
+  auto *tuple_buffer = common::AllocationUtil::AllocateAligned(tuple_initializer.ProjectedRowSize());
+  auto *tuple = tuple_initializer.InitializeRow(tuple_buffer);
+  std::vector<TupleSlot> results;
+  for (int32_t k = 0; k < num_tuples; k++) {
+    *reinterpret_cast<int32_t *>(key->AccessForceNotNull(0)) = k;
+    results.clear();
+    recovered_index->ScanKey(*txn, *key, &results);
+    if (k % 2 == 1) {
+      EXPECT_TRUE(results.empty());
+      continue;
+    }
+    ASSERT_EQ(1, results.size());
+    EXPECT_TRUE(recovered_table->Select(common::ManagedPointer(txn), results[0], tuple));
+    EXPECT_EQ(k, *reinterpret_cast<int32_t *>(tuple->AccessWithNullCheck(0)));
+  }
+  delete[] key_buffer;
+  delete[] tuple_buffer;
+  recovery_txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+}
+
 // This test checks that we recover correctly in a high abort rate workload. We achieve the high abort rate by having
 // large transaction lengths (number of updates). Further, to ensure that more aborted transactions flush logs before
 // aborting, we have transactions make large updates (by having high number columns). This will cause RedoBuffers to
@@ -767,4 +975,115 @@ TEST_F(RecoveryTests, DoubleRecoveryTest) {
       [=]() { unlink(secondary_log_file.c_str()); });
 }
 
+// Time starts over when the system restarts. This test recovers a workload into a system that logs, commits another
+// workload there, and crashes. Recovery must have moved the restarted system's time past everything it recovered, and
+// the second workload must come back from the restarted system's log and a checkpoint it took half way through.
+// NOLINTNEXTLINE
+TEST_F(RecoveryTests, RestartCommitCrashRecoverTest) {
+  std::string secondary_log_file = "test2.log";
+  unlink(secondary_log_file.c_str());
+  LargeSqlTableTestConfiguration config = LargeSqlTableTestConfiguration::Builder()
+                                              .SetNumDatabases(1)
+                                              .SetNumTables(1)
+                                              .SetMaxColumns(5)
+                                              .SetInitialTableSize(1000)
+                                              .SetTxnLength(5)
+                                              .SetInsertUpdateSelectDeleteRatio({0.2, 0.5, 0.2, 0.1})
+                                              .SetVarlenAllowed(true)
+                                              .Build();
+  auto *tested =
+      new LargeSqlTableTestObject(config, txn_manager_.Get(), catalog_.Get(), block_store_.Get(), &generator_);
+  tested->SimulateOltp(100, 4);
+  auto *txn = txn_manager_->BeginTransaction();
+  CreateDatabase(txn, catalog_, "last_database");
+  const transaction::timestamp_t last_commit_time =
+      txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  ShutdownAndRestartSystem();
+
+  // Restart into a system that logs, and recover the first workload
+  recovery_db_main_ = terrier::DBMain::Builder()
+                          .SetWalFilePath(secondary_log_file)
+                          .SetUseLogging(true)
+                          .SetUseGC(true)
+                          .SetUseGCThread(true)
+                          .SetUseCatalog(true)
+                          .SetCreateDefaultDatabase(false)
+                          .Build();
+  recovery_txn_manager_ = recovery_db_main_->GetTransactionLayer()->GetTransactionManager();
+  recovery_deferred_action_manager_ = recovery_db_main_->GetTransactionLayer()->GetDeferredActionManager();
+  recovery_block_store_ = recovery_db_main_->GetStorageLayer()->GetBlockStore();
+  recovery_catalog_ = recovery_db_main_->GetCatalogLayer()->GetCatalog();
+  recovery_thread_registry_ = recovery_db_main_->GetThreadRegistry();
+  SingleRecovery();
+  const auto timestamp_manager = recovery_db_main_->GetTransactionLayer()->GetTimestampManager();
+  EXPECT_GT(timestamp_manager->CurrentTime(), last_commit_time);
+
+  // Commit a second workload in the restarted system, checkpointing half way through, and crash
+  const transaction::timestamp_t first_time_after_recovery = timestamp_manager->CurrentTime();
+  auto *restarted_tested = new LargeSqlTableTestObject(config, recovery_txn_manager_.Get(), recovery_catalog_.Get(),
+                                                       recovery_block_store_.Get(), &generator_);
+  restarted_tested->SimulateOltp(100, 4);
+  CheckpointManager checkpoint_manager(CHECKPOINT_FILE_NAME, recovery_catalog_, recovery_txn_manager_,
+                                       timestamp_manager, recovery_db_main_->GetLogManager());
+  checkpoint_manager.TakeCheckpoint();
+  restarted_tested->SimulateOltp(100, 4);
+  recovery_db_main_->GetGarbageCollectorThread()->StopGC();
+  recovery_deferred_action_manager_->FullyPerformGC(recovery_db_main_->GetStorageLayer()->GetGarbageCollector(),
+                                                    recovery_db_main_->GetLogManager());
+  recovery_db_main_->GetLogManager()->PersistAndStop();
+
+  // Recover the second workload into yet another system
+  auto secondary_recovery_db_main = terrier::DBMain::Builder()
+                                        .SetUseThreadRegistry(true)
+                                        .SetUseGC(true)
+                                        .SetUseGCThread(true)
+                                        .SetUseCatalog(true)
+                                        .SetCreateDefaultDatabase(false)
+                                        .Build();
+  auto secondary_recovery_txn_manager = secondary_recovery_db_main->GetTransactionLayer()->GetTransactionManager();
+  auto secondary_recovery_catalog = secondary_recovery_db_main->GetCatalogLayer()->GetCatalog();
+  DiskLogProvider secondary_log_provider(secondary_log_file);
+  CheckpointLogProvider checkpoint_provider(CheckpointManager::LatestCheckpointFilePath(CHECKPOINT_FILE_NAME));
+  EXPECT_GT(checkpoint_provider.CheckpointTimestamp(), first_time_after_recovery);
+  RecoveryManager secondary_recovery_manager(
+      common::ManagedPointer<AbstractLogProvider>(&secondary_log_provider), secondary_recovery_catalog,
+      secondary_recovery_txn_manager, secondary_recovery_db_main->GetTransactionLayer()->GetDeferredActionManager(),
+      secondary_recovery_db_main->GetThreadRegistry(), secondary_recovery_db_main->GetStorageLayer()->GetBlockStore(),
+      common::ManagedPointer(&checkpoint_provider));
+  secondary_recovery_manager.StartRecovery();
+  secondary_recovery_manager.WaitForRecoveryToFinish();
+
+  for (auto &database : restarted_tested->GetTables()) {
+    auto database_oid = database.first;
+    for (auto &table_oid : database.second) {
+      auto *original_txn = recovery_txn_manager_->BeginTransaction();
+      auto original_sql_table =
+          recovery_catalog_->GetDatabaseCatalog(common::ManagedPointer(original_txn), database_oid)
+              ->GetTable(common::ManagedPointer(original_txn), table_oid);
+      auto *recovery_txn = secondary_recovery_txn_manager->BeginTransaction();
+      auto db_catalog =
+          secondary_recovery_catalog->GetDatabaseCatalog(common::ManagedPointer(recovery_txn), database_oid);
+      EXPECT_TRUE(db_catalog != nullptr);
+      auto recovered_sql_table = db_catalog->GetTable(common::ManagedPointer(recovery_txn), table_oid);
+      EXPECT_TRUE(recovered_sql_table != nullptr);
+
+      EXPECT_TRUE(StorageTestUtil::SqlTableEqualDeep(
+          GetBlockLayout(original_sql_table), original_sql_table, recovered_sql_table,
+          restarted_tested->GetTupleSlotsForTable(database_oid, table_oid),
+          secondary_recovery_manager.tuple_slot_map_, recovery_txn_manager_.Get(),
+          secondary_recovery_txn_manager.Get()));
+      recovery_txn_manager_->Commit(original_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+      secondary_recovery_txn_manager->Commit(recovery_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+    }
+  }
+
+  // DBMain's teardown expects the log manager to still be running
+  recovery_db_main_->GetLogManager()->Start();
+  recovery_db_main_->GetGarbageCollectorThread()->StartGC();
+  recovery_deferred_action_manager_->RegisterDeferredAction([=]() { delete restarted_tested; });
+  recovery_db_main_.reset();
+  db_main_->GetTransactionLayer()->GetDeferredActionManager()->RegisterDeferredAction([=]() { delete tested; });
+  unlink(secondary_log_file.c_str());
+}
+
 }  // namespace terrier::storage
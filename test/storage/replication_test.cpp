@@ -0,0 +1,267 @@
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>  // NOLINT
+#include <csignal>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "gtest/gtest.h"
+#include "main/db_main.h"
+#include "storage/recovery/recovery_manager.h"
+#include "storage/recovery/replication_log_provider.h"
+#include "storage/sql_table.h"
+#include "storage/write_ahead_log/log_manager.h"
+#include "storage/write_ahead_log/log_shipper.h"
+#include "test_util/sql_table_test_util.h"
+#include "test_util/storage_test_util.h"
+#include "test_util/test_harness.h"
+#include "transaction/transaction_manager.h"
+
+#define LOG_FILE_NAME "./test_replication.log"
+#define REPLICATION_PORT 15446
+
+namespace terrier::storage {
+class ReplicationTests : public TerrierTest {
+ protected:
+  std::default_random_engine generator_;
+
+  std::unique_ptr<DBMain> primary_;
+  std::unique_ptr<DBMain> replica_;
+
+  void SetUp() override {
+    unlink(LOG_FILE_NAME);
+
+    // The replica needs to be listening before the primary connects to it
+    replica_ = terrier::DBMain::Builder()
+                   .SetUseGC(true)
+                   .SetUseGCThread(true)
+                   .SetUseCatalog(true)
+                   .SetCreateDefaultDatabase(false)
+                   .SetUseReplica(true)
+                   .SetReplicationPort(REPLICATION_PORT)
+                   .Build();
+
+    primary_ = terrier::DBMain::Builder()
+                   .SetWalFilePath(LOG_FILE_NAME)
+                   .SetUseLogging(true)
+                   .SetUseGC(true)
+                   .SetUseGCThread(true)
+                   .SetUseCatalog(true)
+                   .SetReplicationReplicas("127.0.0.1:" + std::to_string(REPLICATION_PORT))
+                   .Build();
+    ASSERT_EQ(primary_->GetLogShipper()->NumReplicas(), 1);
+  }
+
+  void TearDown() override {
+    primary_.reset();
+    replica_.reset();
+    unlink(LOG_FILE_NAME);
+  }
+
+  LargeSqlTableTestObject *RunWorkload() {
+    LargeSqlTableTestConfiguration config = LargeSqlTableTestConfiguration::Builder()
+                                                .SetNumDatabases(2)
+                                                .SetNumTables(2)
+                                                .SetMaxColumns(5)
+                                                .SetInitialTableSize(1000)
+                                                .SetTxnLength(5)
+                                                .SetInsertUpdateSelectDeleteRatio({0.2, 0.5, 0.2, 0.1})
+                                                .SetVarlenAllowed(true)
+                                                .Build();
+    auto *tested = new LargeSqlTableTestObject(config, primary_->GetTransactionLayer()->GetTransactionManager().Get(),
+                                               primary_->GetCatalogLayer()->GetCatalog().Get(),
+                                               primary_->GetStorageLayer()->GetBlockStore().Get(), &generator_);
+    tested->SimulateOltp(100, 4);
+    return tested;
+  }
+
+  // Ends replication once everything the primary logged so far has been shipped, and waits for the replica to replay it
+  void StopReplication() {
+    const auto log_manager = primary_->GetLogManager();
+    log_manager->PersistAndStop();
+    primary_->GetLogShipper()->StopReplication();
+    log_manager->Start();
+    replica_->GetReplicationLayer()->WaitForReplicationToFinish();
+  }
+
+  // Checks that the replica has the same contents as the primary in all of the workload's tables
+  void CheckTablesMatch(LargeSqlTableTestObject *tested) {
+    const auto txn_manager = primary_->GetTransactionLayer()->GetTransactionManager();
+    const auto catalog = primary_->GetCatalogLayer()->GetCatalog();
+    const auto replica_txn_manager = replica_->GetTransactionLayer()->GetTransactionManager();
+    const auto replica_catalog = replica_->GetCatalogLayer()->GetCatalog();
+    const auto recovery_manager = replica_->GetReplicationLayer()->GetRecoveryManager();
+    for (auto &database : tested->GetTables()) {
+      auto database_oid = database.first;
+      for (auto &table_oid : database.second) {
+        auto *primary_txn = txn_manager->BeginTransaction();
+        auto primary_table = catalog->GetDatabaseCatalog(common::ManagedPointer(primary_txn), database_oid)
+                                 ->GetTable(common::ManagedPointer(primary_txn), table_oid);
+
+        auto *replica_txn = replica_txn_manager->BeginTransaction();
+        auto db_catalog = replica_catalog->GetDatabaseCatalog(common::ManagedPointer(replica_txn), database_oid);
+        EXPECT_TRUE(db_catalog != nullptr);
+        auto replica_table = db_catalog->GetTable(common::ManagedPointer(replica_txn), table_oid);
+        EXPECT_TRUE(replica_table != nullptr);
+
+        EXPECT_TRUE(StorageTestUtil::SqlTableEqualDeep(primary_table->table_.layout_, primary_table, replica_table,
+                                                       tested->GetTupleSlotsForTable(database_oid, table_oid),
+                                                       recovery_manager->tuple_slot_map_, txn_manager.Get(),
+                                                       replica_txn_manager.Get()));
+        txn_manager->Commit(primary_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+        replica_txn_manager->Commit(replica_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+      }
+    }
+  }
+
+  void Cleanup(LargeSqlTableTestObject *tested) {
+    // the table can't be freed until after all GC on it is guaranteed to be done. The easy way to do that is to use a
+    // DeferredAction
+    primary_->GetTransactionLayer()->GetDeferredActionManager()->RegisterDeferredAction([=]() { delete tested; });
+  }
+};
+
+// This test runs a workload on the primary, and checks that the replica ends up with the same tables once replication
+// is stopped
+// NOLINTNEXTLINE
+TEST_F(ReplicationTests, ReplicaMatchesPrimaryTest) {
+  auto *tested = RunWorkload();
+  StopReplication();
+
+  EXPECT_GT(primary_->GetLogShipper()->NextMessageId(), 0);
+  EXPECT_EQ(replica_->GetReplicationLayer()->GetLogProvider()->NextMessageId(),
+            primary_->GetLogShipper()->NextMessageId());
+  CheckTablesMatch(tested);
+  Cleanup(tested);
+}
+
+// This test checks that the replica replays the log while replication is still running, so that reads on the replica
+// see what the primary committed without waiting for replication to stop
+// NOLINTNEXTLINE
+TEST_F(ReplicationTests, ContinuousReplayTest) {
+  auto *tested = RunWorkload();
+  primary_->GetLogManager()->ForceFlush();
+
+  // The tables were created long before the workload ended, so the replica should get to them shortly
+  const auto replica_txn_manager = replica_->GetTransactionLayer()->GetTransactionManager();
+  const auto replica_catalog = replica_->GetCatalogLayer()->GetCatalog();
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+  bool caught_up = false;
+  while (!caught_up && std::chrono::steady_clock::now() < deadline) {
+    auto *replica_txn = replica_txn_manager->BeginTransaction();
+    caught_up = true;
+    for (auto &database : tested->GetTables()) {
+      auto db_catalog = replica_catalog->GetDatabaseCatalog(common::ManagedPointer(replica_txn), database.first);
+      for (auto &table_oid : database.second)
+        caught_up = caught_up && db_catalog != nullptr &&
+                    db_catalog->GetTable(common::ManagedPointer(replica_txn), table_oid) != nullptr;
+    }
+    replica_txn_manager->Commit(replica_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+    if (!caught_up) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_TRUE(caught_up);
+
+  StopReplication();
+  Cleanup(tested);
+}
+
+// This test checks that the primary holds back log from the replicas until it has persisted it
+// NOLINTNEXTLINE
+TEST_F(ReplicationTests, ShipAfterPersistTest) {
+  // Keep the primary from persisting on its own, by having it wait for a group of commits that never fills up
+  const auto log_manager = primary_->GetLogManager();
+  log_manager->PersistAndStop();
+  log_manager->SetGroupCommit(std::chrono::seconds(100), std::numeric_limits<uint64_t>::max());
+  log_manager->Start();
+  const auto shipper = primary_->GetLogShipper();
+  const uint64_t shipped_before = shipper->NextMessageId();
+
+  const auto txn_manager = primary_->GetTransactionLayer()->GetTransactionManager();
+  auto *txn = txn_manager->BeginTransaction();
+  primary_->GetCatalogLayer()->GetCatalog()->CreateDatabase(common::ManagedPointer(txn), "testdb", true);
+  txn_manager->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  // The commit is written to the log file, but nothing goes out until it is persisted
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(shipped_before, shipper->NextMessageId());
+
+  log_manager->ForceFlush();
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+  while (shipper->NextMessageId() == shipped_before && std::chrono::steady_clock::now() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_GT(shipper->NextMessageId(), shipped_before);
+
+  StopReplication();
+  log_manager->PersistAndStop();
+  log_manager->SetGroupCommit(std::chrono::microseconds::zero(), 1);
+  log_manager->Start();
+}
+
+// Replication only works with some configurations. Those that cannot work are rejected when the system is built,
+// rather than failing later on.
+// NOLINTNEXTLINE
+TEST_F(ReplicationTests, InvalidReplicationConfigurationTest) {
+  // A replica gets all of its databases from the primary
+  EXPECT_THROW(DBMain::Builder().SetUseGC(true).SetUseCatalog(true).SetUseReplica(true).Build(), SettingsException);
+  // A replica does not write a log of its own
+  EXPECT_THROW(DBMain::Builder()
+                   .SetWalFilePath(LOG_FILE_NAME)
+                   .SetUseLogging(true)
+                   .SetUseGC(true)
+                   .SetUseCatalog(true)
+                   .SetCreateDefaultDatabase(false)
+                   .SetUseReplica(true)
+                   .Build(),
+               SettingsException);
+  // Only a single log stream can be shipped
+  EXPECT_THROW(DBMain::Builder()
+                   .SetWalFilePath(LOG_FILE_NAME)
+                   .SetUseLogging(true)
+                   .SetWalNumStreams(2)
+                   .SetUseGC(true)
+                   .SetUseCatalog(true)
+                   .SetReplicationReplicas("127.0.0.1:" + std::to_string(REPLICATION_PORT))
+                   .Build(),
+               SettingsException);
+}
+
+// A replica that goes away must show up as a lost replica, rather than as a SIGPIPE that kills the primary. The log
+// shipper must not rely on the process ignoring SIGPIPE for this, so this test ships to a connection that the other
+// end closes, with SIGPIPE at its default action.
+// NOLINTNEXTLINE
+TEST_F(ReplicationTests, LostReplicaRaisesNoSignalTest) {
+  const int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+  ASSERT_GE(listen_fd, 0);
+  const int reuse = 1;
+  setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(REPLICATION_PORT + 1);
+  ASSERT_EQ(bind(listen_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)), 0);
+  ASSERT_EQ(listen(listen_fd, 1), 0);
+
+  const auto previous_handler = signal(SIGPIPE, SIG_DFL);
+  LogShipper shipper({"127.0.0.1:" + std::to_string(REPLICATION_PORT + 1)});
+  ASSERT_EQ(shipper.NumReplicas(), 1);
+  // Hang up on the shipper, and don't take it back when it tries to reconnect
+  close(accept(listen_fd, nullptr, nullptr));
+  close(listen_fd);
+
+  // The first message may still make it out before the shipper learns that the connection is gone
+  for (uint32_t i = 0; i < 3; i++) {
+    shipper.Enqueue(std::vector<char>(1024, 'a'));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  EXPECT_EQ(shipper.NumReplicas(), 0);
+  shipper.StopReplication();
+  signal(SIGPIPE, previous_handler);
+}
+
+}  // namespace terrier::storage
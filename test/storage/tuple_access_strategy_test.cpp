@@ -134,6 +134,44 @@ TEST_F(TupleAccessStrategyTests, SimpleInsert) {
   }
 }
 
+// Tests that a range of slots is allocated consecutively from the insertion head, and that a range larger than the room
+// left in the block is cut short at the end of the block.
+// NOLINTNEXTLINE
+TEST_F(TupleAccessStrategyTests, AllocateRange) {
+  const uint32_t repeat = 50;
+  const uint32_t max_cols = 100;
+  std::default_random_engine generator;
+  for (uint32_t i = 0; i < repeat; i++) {
+    storage::BlockLayout layout = StorageTestUtil::RandomLayoutNoVarlen(max_cols, &generator);
+    storage::TupleAccessStrategy tested(layout);
+    std::memset(reinterpret_cast<void *>(raw_block_), 0, sizeof(storage::RawBlock));
+    tested.InitializeRawBlock(nullptr, raw_block_, storage::layout_version_t(0));
+    std::vector<storage::TupleSlot> slots(layout.NumSlots());
+
+    // A range that fits is allocated in full, starting from the first slot
+    const uint32_t num_first = std::uniform_int_distribution<uint32_t>(1, layout.NumSlots() - 1)(generator);
+    EXPECT_EQ(num_first, tested.AllocateRange(raw_block_, num_first, slots.data()));
+    for (uint32_t j = 0; j < num_first; j++) {
+      EXPECT_EQ(storage::TupleSlot(raw_block_, j), slots[j]);
+      EXPECT_TRUE(tested.Allocated(slots[j]));
+    }
+    EXPECT_FALSE(tested.Allocated(storage::TupleSlot(raw_block_, num_first)));
+
+    // A range that does not fit only gets the rest of the block
+    const uint32_t num_rest = layout.NumSlots() - num_first;
+    EXPECT_EQ(num_rest, tested.AllocateRange(raw_block_, layout.NumSlots(), slots.data()));
+    for (uint32_t j = 0; j < num_rest; j++) {
+      EXPECT_EQ(storage::TupleSlot(raw_block_, num_first + j), slots[j]);
+      EXPECT_TRUE(tested.Allocated(slots[j]));
+    }
+
+    // The block is full now
+    EXPECT_EQ(0, tested.AllocateRange(raw_block_, 1, slots.data()));
+    storage::TupleSlot slot;
+    EXPECT_FALSE(tested.Allocate(raw_block_, &slot));
+  }
+}
+
 // This test generates randomized block layouts, and checks its layout to ensure
 // that the column bitmaps, and the columns don't overlap, and don't
 // go out of page boundary. (In other words, memory safe.)
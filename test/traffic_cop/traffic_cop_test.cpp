@@ -7,11 +7,13 @@
 #include <utility>
 #include <vector>
 
+#include "common/action_context.h"
 #include "common/settings.h"
 #include "gtest/gtest.h"
 #include "main/db_main.h"
 #include "network/connection_handle_factory.h"
 #include "network/terrier_server.h"
+#include "settings/settings_manager.h"
 #include "storage/garbage_collector.h"
 #include "test_util/manual_packet_util.h"
 #include "test_util/test_harness.h"
@@ -47,6 +49,33 @@ class TrafficCopTests : public TerrierTest {
     txn_manager_ = db_main_->GetTransactionLayer()->GetTransactionManager();
   }
 
+  /** Set the number of bytes a spilling operator may buffer before it spills to disk. */
+  void SetOperatorMemoryBudget(int64_t budget) {
+    auto action_context = std::make_unique<common::ActionContext>(common::action_id_t(1));
+    db_main_->GetSettingsManager()->SetInt64(settings::Param::execution_operator_memory_budget, budget,
+                                             common::ManagedPointer(action_context),
+                                             settings::SettingsManager::EmptySetterCallback);
+    ASSERT_EQ(action_context->GetState(), common::ActionState::SUCCESS);
+  }
+
+  /** Set whether hash joins push the bloom filters of their hash tables down into probe-side scans. */
+  void SetBloomFilterPushdown(bool enabled) {
+    auto action_context = std::make_unique<common::ActionContext>(common::action_id_t(1));
+    db_main_->GetSettingsManager()->SetBool(settings::Param::execution_bloom_filter_pushdown, enabled,
+                                            common::ManagedPointer(action_context),
+                                            settings::SettingsManager::EmptySetterCallback);
+    ASSERT_EQ(action_context->GetState(), common::ActionState::SUCCESS);
+  }
+
+  /** @return The VALUES list of `num_rows` rows (i, i * 2), for i from 0 up to `num_rows`. */
+  static std::string MakeValues(uint32_t num_rows) {
+    std::string values;
+    for (uint32_t i = 0; i < num_rows; i++) {
+      values += fmt::format("{}({}, {})", i == 0 ? "" : ", ", i, i * 2);
+    }
+    return values;
+  }
+
   std::unique_ptr<DBMain> db_main_;
   uint16_t port_;
   common::ManagedPointer<catalog::Catalog> catalog_;
@@ -144,6 +173,131 @@ TEST_F(TrafficCopTests, BasicTest) {
   }
 }
 
+/**
+ * Test that a hash join whose build side does not fit the operator memory budget spills and still joins every row.
+ */
+// NOLINTNEXTLINE
+TEST_F(TrafficCopTests, HashJoinSpillTest) {
+  constexpr uint32_t num_rows = 5000;
+  SetOperatorMemoryBudget(4096);
+  try {
+    pqxx::connection connection(fmt::format("host=127.0.0.1 port={0} user={1} sslmode=disable application_name=psql",
+                                            port_, catalog::DEFAULT_DATABASE));
+
+    pqxx::work txn1(connection);
+    txn1.exec("CREATE TABLE TableA (id INT, data INT);");
+    txn1.exec("CREATE TABLE TableB (id INT, data INT);");
+    txn1.exec("INSERT INTO TableA VALUES " + MakeValues(num_rows) + ";");
+    txn1.exec("INSERT INTO TableB VALUES " + MakeValues(num_rows) + ";");
+
+    pqxx::result r = txn1.exec("SELECT a.id, a.data, b.data FROM TableA a, TableB b WHERE a.id = b.id;");
+    EXPECT_EQ(r.size(), num_rows);
+    for (const auto &row : r) {
+      EXPECT_EQ(row[1].as<int64_t>(), row[0].as<int64_t>() * 2);
+      EXPECT_EQ(row[1].as<int64_t>(), row[2].as<int64_t>());
+    }
+    txn1.commit();
+  } catch (const std::exception &e) {
+    EXPECT_TRUE(false) << e.what();
+  }
+}
+
+/**
+ * Test that a selective hash join returns the same rows whether or not its bloom filter is pushed down into the scan.
+ */
+// NOLINTNEXTLINE
+TEST_F(TrafficCopTests, BloomFilterPushdownTest) {
+  constexpr uint32_t num_rows = 5000;
+  constexpr uint32_t num_matches = 100;
+  try {
+    pqxx::connection connection(fmt::format("host=127.0.0.1 port={0} user={1} sslmode=disable application_name=psql",
+                                            port_, catalog::DEFAULT_DATABASE));
+
+    pqxx::work txn1(connection);
+    txn1.exec("CREATE TABLE TableA (id INT, data INT);");
+    txn1.exec("CREATE TABLE TableB (id INT, data INT);");
+    txn1.exec("INSERT INTO TableA VALUES " + MakeValues(num_rows) + ";");
+    txn1.exec("INSERT INTO TableB VALUES " + MakeValues(num_rows) + ";");
+
+    const std::string query = fmt::format(
+        "SELECT a.id, a.data, b.data FROM TableA a, TableB b WHERE a.id = b.id AND a.data < {} ORDER BY a.id;",
+        2 * num_matches);
+    SetBloomFilterPushdown(true);
+    pqxx::result pushed_down = txn1.exec(query);
+    SetBloomFilterPushdown(false);
+    pqxx::result not_pushed_down = txn1.exec(query);
+
+    ASSERT_EQ(pushed_down.size(), num_matches);
+    ASSERT_EQ(not_pushed_down.size(), num_matches);
+    for (uint32_t i = 0; i < num_matches; i++) {
+      EXPECT_EQ(pushed_down[i][0].as<int64_t>(), static_cast<int64_t>(i));
+      EXPECT_EQ(pushed_down[i][1].as<int64_t>(), pushed_down[i][0].as<int64_t>() * 2);
+      EXPECT_EQ(pushed_down[i][1].as<int64_t>(), pushed_down[i][2].as<int64_t>());
+      for (uint32_t col = 0; col < 3; col++) {
+        EXPECT_EQ(pushed_down[i][col].as<int64_t>(), not_pushed_down[i][col].as<int64_t>());
+      }
+    }
+    txn1.commit();
+  } catch (const std::exception &e) {
+    EXPECT_TRUE(false) << e.what();
+  }
+}
+
+/**
+ * Test that a hash aggregation whose groups do not fit the operator memory budget spills and still merges every group.
+ */
+// NOLINTNEXTLINE
+TEST_F(TrafficCopTests, HashAggregationSpillTest) {
+  constexpr uint32_t num_groups = 5000;
+  SetOperatorMemoryBudget(4096);
+  try {
+    pqxx::connection connection(fmt::format("host=127.0.0.1 port={0} user={1} sslmode=disable application_name=psql",
+                                            port_, catalog::DEFAULT_DATABASE));
+
+    pqxx::work txn1(connection);
+    txn1.exec("CREATE TABLE TableA (id INT, data INT);");
+    txn1.exec("INSERT INTO TableA VALUES " + MakeValues(num_groups) + ";");
+    txn1.exec("INSERT INTO TableA VALUES " + MakeValues(num_groups) + ";");
+
+    pqxx::result r = txn1.exec("SELECT id, COUNT(*), SUM(data) FROM TableA GROUP BY id;");
+    EXPECT_EQ(r.size(), num_groups);
+    for (const auto &row : r) {
+      EXPECT_EQ(row[1].as<int64_t>(), 2);
+      EXPECT_EQ(row[2].as<int64_t>(), row[0].as<int64_t>() * 4);
+    }
+    txn1.commit();
+  } catch (const std::exception &e) {
+    EXPECT_TRUE(false) << e.what();
+  }
+}
+
+/**
+ * Test that a sort whose rows do not fit the operator memory budget spills sorted runs and still orders every row.
+ */
+// NOLINTNEXTLINE
+TEST_F(TrafficCopTests, SortSpillTest) {
+  constexpr uint32_t num_rows = 5000;
+  SetOperatorMemoryBudget(4096);
+  try {
+    pqxx::connection connection(fmt::format("host=127.0.0.1 port={0} user={1} sslmode=disable application_name=psql",
+                                            port_, catalog::DEFAULT_DATABASE));
+
+    pqxx::work txn1(connection);
+    txn1.exec("CREATE TABLE TableA (id INT, data INT);");
+    txn1.exec("INSERT INTO TableA VALUES " + MakeValues(num_rows) + ";");
+
+    pqxx::result r = txn1.exec("SELECT id, data FROM TableA ORDER BY data DESC;");
+    EXPECT_EQ(r.size(), num_rows);
+    for (uint32_t i = 0; i < r.size(); i++) {
+      EXPECT_EQ(r[i][0].as<int64_t>(), static_cast<int64_t>(num_rows - 1 - i));
+      EXPECT_EQ(r[i][1].as<int64_t>(), static_cast<int64_t>(num_rows - 1 - i) * 2);
+    }
+    txn1.commit();
+  } catch (const std::exception &e) {
+    EXPECT_TRUE(false) << e.what();
+  }
+}
+
 /**
  * Test whether a temporary namespace is created for a connection to the database
  */
@@ -0,0 +1,73 @@
+#include "transaction/timestamp_manager.h"
+
+#include <vector>
+
+#include "common/worker_pool.h"
+#include "main/db_main.h"
+#include "storage/garbage_collector.h"
+#include "test_util/multithread_test_util.h"
+#include "test_util/test_harness.h"
+#include "transaction/transaction_context.h"
+#include "transaction/transaction_manager.h"
+#include "transaction/transaction_util.h"
+
+namespace terrier {
+
+class TimestampManagerTests : public TerrierTest {};
+
+// Test that the oldest running transaction is correctly tracked by a single thread as transactions come and go out
+// of order
+// NOLINTNEXTLINE
+TEST_F(TimestampManagerTests, OldestTransaction) {
+  auto db_main = DBMain::Builder().SetUseGC(true).Build();
+  auto txn_manager = db_main->GetTransactionLayer()->GetTransactionManager();
+  auto timestamp_manager = db_main->GetTransactionLayer()->GetTimestampManager();
+  auto gc = db_main->GetStorageLayer()->GetGarbageCollector();
+
+  std::vector<transaction::TransactionContext *> txns;
+  for (uint32_t i = 0; i < 200; i++) txns.push_back(txn_manager->BeginTransaction());
+  EXPECT_EQ(timestamp_manager->OldestTransactionStartTime(), txns.front()->StartTime());
+  EXPECT_EQ(timestamp_manager->CachedOldestTransactionStartTime(), txns.front()->StartTime());
+
+  // Finishing anything other than the oldest transaction should not move the oldest timestamp
+  for (uint32_t i = 1; i < 200; i += 2)
+    txn_manager->Commit(txns[i], transaction::TransactionUtil::EmptyCallback, nullptr);
+  EXPECT_EQ(timestamp_manager->OldestTransactionStartTime(), txns.front()->StartTime());
+
+  for (uint32_t i = 0; i < 200; i += 2) {
+    txn_manager->Abort(txns[i]);
+    if (i + 2 < 200) EXPECT_EQ(timestamp_manager->OldestTransactionStartTime(), txns[i + 2]->StartTime());
+  }
+
+  // With nothing running, the oldest timestamp falls back to the current time
+  EXPECT_EQ(timestamp_manager->OldestTransactionStartTime(), timestamp_manager->CurrentTime());
+
+  gc->PerformGarbageCollection();
+  gc->PerformGarbageCollection();
+}
+
+// Test that the oldest running transaction computed while other threads are beginning and committing transactions
+// is never newer than a transaction that is still running
+// NOLINTNEXTLINE
+TEST_F(TimestampManagerTests, ConcurrentOldestTransaction) {
+  auto db_main = DBMain::Builder().SetUseGC(true).Build();
+  auto txn_manager = db_main->GetTransactionLayer()->GetTransactionManager();
+  auto timestamp_manager = db_main->GetTransactionLayer()->GetTimestampManager();
+  auto gc = db_main->GetStorageLayer()->GetGarbageCollector();
+
+  const uint32_t num_threads = MultiThreadTestUtil::HardwareConcurrency();
+  common::WorkerPool thread_pool(num_threads, {});
+  auto workload = [&](uint32_t /*unused*/) {
+    for (uint32_t i = 0; i < 1000; i++) {
+      auto *txn = txn_manager->BeginTransaction();
+      EXPECT_LE(timestamp_manager->OldestTransactionStartTime(), txn->StartTime());
+      txn_manager->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+    }
+  };
+  MultiThreadTestUtil::RunThreadsUntilFinish(&thread_pool, num_threads, workload);
+
+  gc->PerformGarbageCollection();
+  gc->PerformGarbageCollection();
+}
+
+}  // namespace terrier
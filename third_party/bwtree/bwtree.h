@@ -6530,6 +6530,96 @@ class BwTree : public BwTreeBase {
     return ret;
   }
 
+  /*
+   * BulkLoad() - Build the tree bottom-up from key-value pairs sorted by key
+   *
+   * Leaves are filled with the items in order, then each level of inner nodes
+   * is built over the level below it, until a single node is left to become
+   * the root. Compared to inserting the items one by one, this skips the
+   * traversal, the delta records and the splits of every insert. Nodes are
+   * filled to 3/4 of the split threshold, leaving room for later inserts.
+   *
+   * Like a split, this never puts the same key on two leaves, since a lookup
+   * only visits the leaf whose key range holds the key.
+   *
+   * This only works on a tree that has not been modified since it was
+   * constructed, and must not run concurrently with any other operation on
+   * the tree. It returns false without changing anything if the tree is not
+   * empty, true otherwise
+   */
+  bool BulkLoad(const std::vector<KeyValuePair> &items) {
+    const BaseNode *old_root_p = GetNode(root_id.load());
+    const BaseNode *old_leaf_p = GetNode(first_leaf_id);
+    if (old_root_p->GetType() != NodeType::InnerType || old_root_p->GetItemCount() != 1 ||
+        old_leaf_p->GetType() != NodeType::LeafType || old_leaf_p->GetItemCount() != 0) {
+      return false;
+    }
+    if (items.empty()) return true;
+
+    // Both are replaced below, and no one else can be looking at them
+    static_cast<const InnerNode *>(old_root_p)->~InnerNode();
+    static_cast<const InnerNode *>(old_root_p)->Destroy();
+    static_cast<const LeafNode *>(old_leaf_p)->~LeafNode();
+    static_cast<const LeafNode *>(old_leaf_p)->Destroy();
+
+    // Start of the items of each leaf, with the end of the last one appended
+    const size_t leaf_fill = std::max(1, GetLeafNodeSizeUpperThreshold() * 3 / 4);
+    std::vector<size_t> bounds{0};
+    while (bounds.back() < items.size()) {
+      size_t end = std::min(bounds.back() + leaf_fill, items.size());
+      while (end < items.size() && KeyCmpEqual(items[end].first, items[end - 1].first)) end++;
+      bounds.push_back(end);
+    }
+
+    // Separators pointing at the nodes of the level built last. The left most
+    // one has an empty key, same as the first separator of the initial root
+    const size_t num_leaves = bounds.size() - 1;
+    std::vector<KeyNodeIDPair> level(num_leaves);
+    level[0] = std::make_pair(KeyType{}, first_leaf_id);
+    for (size_t i = 1; i < num_leaves; i++) level[i] = std::make_pair(items[bounds[i]].first, GetNextNodeID());
+
+    for (size_t i = 0; i < num_leaves; i++) {
+      const auto size = static_cast<int>(bounds[i + 1] - bounds[i]);
+      // Same low keys as the initial leaf and as split siblings
+      const KeyNodeIDPair low_key =
+          i == 0 ? std::make_pair(KeyType{}, INVALID_NODE_ID) : std::make_pair(level[i].first, ~INVALID_NODE_ID);
+      // The high key of a node is the separator of its right sibling
+      const KeyNodeIDPair high_key = i + 1 == num_leaves ? std::make_pair(KeyType{}, INVALID_NODE_ID) : level[i + 1];
+      auto *leaf_node_p = reinterpret_cast<LeafNode *>(
+          ElasticNode<KeyValuePair>::Get(size, NodeType::LeafType, 0, size, low_key, high_key));
+      leaf_node_p->PushBack(items.data() + bounds[i], items.data() + bounds[i + 1]);
+      TERRIER_ASSERT(level[i].second < MAPPING_TABLE_SIZE, "Node count exceeded maximum.");
+      InstallNewNode(level[i].second, leaf_node_p);
+    }
+
+    const size_t inner_fill = std::max(2, GetInnerNodeSizeUpperThreshold() * 3 / 4);
+    do {
+      // The top level is a single node, which takes over the root's node id
+      const size_t num_nodes = (level.size() + inner_fill - 1) / inner_fill;
+      std::vector<KeyNodeIDPair> parents(num_nodes);
+      for (size_t i = 0; i < num_nodes; i++) {
+        parents[i] = std::make_pair(level[i * inner_fill].first, num_nodes == 1 ? root_id.load() : GetNextNodeID());
+      }
+
+      for (size_t i = 0; i < num_nodes; i++) {
+        const size_t begin = i * inner_fill;
+        const size_t end = std::min(begin + inner_fill, level.size());
+        const auto size = static_cast<int>(end - begin);
+        const KeyNodeIDPair high_key =
+            i + 1 == num_nodes ? std::make_pair(KeyType{}, INVALID_NODE_ID) : parents[i + 1];
+        // Same as a split sibling, the low key of an inner node is its first separator
+        auto *inner_node_p = reinterpret_cast<InnerNode *>(
+            ElasticNode<KeyNodeIDPair>::Get(size, NodeType::InnerType, 0, size, level[begin], high_key));
+        inner_node_p->PushBack(level.data() + begin, level.data() + end);
+        TERRIER_ASSERT(parents[i].second < MAPPING_TABLE_SIZE, "Node count exceeded maximum.");
+        InstallNewNode(parents[i].second, inner_node_p);
+      }
+      level = std::move(parents);
+    } while (level.size() > 1);
+
+    return true;
+  }
+
   /*
    * Insert() - Insert a key-value pair
    *